@@ -35,6 +35,15 @@ real_t Vector2::angle() const {
 	return Math::atan2(y, x);
 }
 
+int Vector2::min_axis() const {
+
+	return x < y ? 0 : 1;
+}
+int Vector2::max_axis() const {
+
+	return x < y ? 1 : 0;
+}
+
 real_t Vector2::length() const {
 
 	return Math::sqrt(x * x + y * y);
@@ -38,6 +38,8 @@ struct Vector2i;
 
 struct Vector2 {
 
+	static const int AXIS_COUNT = 2;
+
 	enum Axis {
 		AXIS_X,
 		AXIS_Y,
@@ -59,6 +61,9 @@ struct Vector2 {
 		return p_idx ? y : x;
 	}
 
+	int min_axis() const;
+	int max_axis() const;
+
 	void normalize();
 	Vector2 normalized() const;
 	bool is_normalized() const;
@@ -38,6 +38,8 @@ class Basis;
 
 struct Vector3 {
 
+	static const int AXIS_COUNT = 3;
+
 	enum Axis {
 		AXIS_X,
 		AXIS_Y,
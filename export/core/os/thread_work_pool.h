@@ -0,0 +1,138 @@
+/*************************************************************************/
+/*  thread_work_pool.h                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef THREAD_WORK_POOL_H
+#define THREAD_WORK_POOL_H
+
+#include "core/os/memory.h"
+#include "core/os/semaphore.h"
+#include "core/os/thread.h"
+#include "core/safe_refcount.h"
+
+// Persistent worker threads for splitting a loop over many elements, for
+// code that runs every frame and can't afford to start threads each time
+// like thread_process_array() does. The calling thread takes part in the
+// work too, so a pool with 0 worker threads simply runs serially.
+class ThreadWorkPool {
+
+	SafeNumeric<uint32_t> index;
+
+	struct BaseWork {
+		SafeNumeric<uint32_t> *index;
+		uint32_t max_elements;
+
+		virtual void work() = 0;
+		virtual ~BaseWork() {}
+	};
+
+	template <class C, class M, class U>
+	struct Work : public BaseWork {
+		C *instance;
+		M method;
+		U userdata;
+
+		virtual void work() {
+
+			while (true) {
+				uint32_t work_index = this->index->postincrement();
+				if (work_index >= this->max_elements) {
+					break;
+				}
+				(instance->*method)(work_index, userdata);
+			}
+		}
+	};
+
+	struct ThreadData {
+		Thread thread;
+		Semaphore start;
+		Semaphore completed;
+		SafeFlag exit;
+		BaseWork *work;
+	};
+
+	ThreadData *threads;
+	uint32_t thread_count;
+
+	static void _thread_function(void *p_user);
+
+public:
+	template <class C, class M, class U>
+	void do_work(uint32_t p_elements, C *p_instance, M p_method, U p_userdata) {
+
+		if (p_elements == 0) {
+			return;
+		}
+
+		if (p_elements == 1 || thread_count == 0) {
+			for (uint32_t i = 0; i < p_elements; i++) {
+				(p_instance->*p_method)(i, p_userdata);
+			}
+			return;
+		}
+
+		index.set(0);
+
+		Work<C, M, U> w;
+		w.instance = p_instance;
+		w.method = p_method;
+		w.userdata = p_userdata;
+		w.index = &index;
+		w.max_elements = p_elements;
+
+		// no point in waking up more threads than there are elements
+		uint32_t threads_working = MIN(p_elements - 1, thread_count);
+
+		for (uint32_t i = 0; i < threads_working; i++) {
+			threads[i].work = &w;
+			threads[i].start.post();
+		}
+
+		w.work();
+
+		for (uint32_t i = 0; i < threads_working; i++) {
+			threads[i].completed.wait();
+			threads[i].work = NULL;
+		}
+	}
+
+	// Threads taking part in do_work(), including the calling one.
+	_FORCE_INLINE_ int get_thread_count() const { return thread_count + 1; }
+	_FORCE_INLINE_ bool is_initialized() const { return threads != NULL; }
+
+	// p_thread_count counts the calling thread, <= 0 means one per logical core.
+	void init(int p_thread_count = -1);
+	void finish();
+
+	ThreadWorkPool();
+	~ThreadWorkPool();
+};
+
+#endif // THREAD_WORK_POOL_H
@@ -183,6 +183,9 @@ void initialize_physics() {
 	ERR_FAIL_COND(!physics_server);
 	physics_server->init();
 
+	// This must be defined BEFORE the 2d physics server is created
+	GLOBAL_DEF("physics/2d/use_bvh", true);
+
 	/// 2D Physics server
 	physics_2d_server = Physics2DServerManager::new_server(ProjectSettings::get_singleton()->get(Physics2DServerManager::setting_property_name));
 	if (!physics_2d_server) {
@@ -281,6 +284,9 @@ void Main::print_help(const char *p_binary) {
 	OS::get_singleton()->print("  -b, --breakpoints                Breakpoint list as source::line comma-separated pairs, no spaces (use %%20 instead).\n");
 	OS::get_singleton()->print("  --profiling                      Enable profiling in the script debugger.\n");
 	OS::get_singleton()->print("  --remote-debug <address>         Remote debug (<host/IP>:<port> address).\n");
+#ifdef DEBUG_ENABLED
+	OS::get_singleton()->print("  --gdscript-sampling-profile <file> Record a GDScript sampling profile to <file> (.json for Chrome trace, collapsed stacks otherwise).\n");
+#endif
 #if defined(DEBUG_ENABLED) && !defined(SERVER_ENABLED)
 	OS::get_singleton()->print("  --debug-collisions               Show collision shapes when running the scene.\n");
 	OS::get_singleton()->print("  --debug-navigation               Show navigation polygons when running the scene.\n");
@@ -2092,6 +2098,7 @@ bool Main::iteration() {
 
 		uint64_t physics_begin = OS::get_singleton()->get_ticks_usec();
 
+		PhysicsServer::get_singleton()->sync();
 		PhysicsServer::get_singleton()->flush_queries();
 
 		Physics2DServer::get_singleton()->sync();
@@ -2104,6 +2111,7 @@ bool Main::iteration() {
 
 		message_queue->flush();
 
+		PhysicsServer::get_singleton()->end_sync();
 		PhysicsServer::get_singleton()->step(frame_slice * time_scale);
 
 		Physics2DServer::get_singleton()->end_sync();
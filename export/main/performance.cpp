@@ -76,6 +76,22 @@ void Performance::_bind_methods() {
 	BIND_ENUM_CONSTANT(PHYSICS_3D_COLLISION_PAIRS);
 	BIND_ENUM_CONSTANT(PHYSICS_3D_ISLAND_COUNT);
 	BIND_ENUM_CONSTANT(AUDIO_OUTPUT_LATENCY);
+	BIND_ENUM_CONSTANT(PHYSICS_2D_BROADPHASE_TIME);
+	BIND_ENUM_CONSTANT(PHYSICS_2D_PAIR_GENERATION_TIME);
+	BIND_ENUM_CONSTANT(PHYSICS_2D_NARROWPHASE_TIME);
+	BIND_ENUM_CONSTANT(PHYSICS_2D_GENERATE_ISLANDS_TIME);
+	BIND_ENUM_CONSTANT(PHYSICS_2D_SETUP_CONSTRAINTS_TIME);
+	BIND_ENUM_CONSTANT(PHYSICS_2D_SOLVE_CONSTRAINTS_TIME);
+	BIND_ENUM_CONSTANT(PHYSICS_2D_INTEGRATE_TIME);
+	BIND_ENUM_CONSTANT(PHYSICS_2D_QUERY_CALLBACKS_TIME);
+	BIND_ENUM_CONSTANT(PHYSICS_3D_BROADPHASE_TIME);
+	BIND_ENUM_CONSTANT(PHYSICS_3D_PAIR_GENERATION_TIME);
+	BIND_ENUM_CONSTANT(PHYSICS_3D_NARROWPHASE_TIME);
+	BIND_ENUM_CONSTANT(PHYSICS_3D_GENERATE_ISLANDS_TIME);
+	BIND_ENUM_CONSTANT(PHYSICS_3D_SETUP_CONSTRAINTS_TIME);
+	BIND_ENUM_CONSTANT(PHYSICS_3D_SOLVE_CONSTRAINTS_TIME);
+	BIND_ENUM_CONSTANT(PHYSICS_3D_INTEGRATE_TIME);
+	BIND_ENUM_CONSTANT(PHYSICS_3D_QUERY_CALLBACKS_TIME);
 
 	BIND_ENUM_CONSTANT(MONITOR_MAX);
 }
@@ -124,6 +140,22 @@ String Performance::get_monitor_name(Monitor p_monitor) const {
 		"physics_3d/collision_pairs",
 		"physics_3d/islands",
 		"audio/output_latency",
+		"physics_2d/broadphase_time",
+		"physics_2d/pair_generation_time",
+		"physics_2d/narrowphase_time",
+		"physics_2d/islands_time",
+		"physics_2d/setup_constraints_time",
+		"physics_2d/solve_constraints_time",
+		"physics_2d/integrate_time",
+		"physics_2d/query_callbacks_time",
+		"physics_3d/broadphase_time",
+		"physics_3d/pair_generation_time",
+		"physics_3d/narrowphase_time",
+		"physics_3d/islands_time",
+		"physics_3d/setup_constraints_time",
+		"physics_3d/solve_constraints_time",
+		"physics_3d/integrate_time",
+		"physics_3d/query_callbacks_time",
 
 	};
 
@@ -164,6 +196,22 @@ float Performance::get_monitor(Monitor p_monitor) const {
 		case PHYSICS_3D_COLLISION_PAIRS: return PhysicsServer::get_singleton()->get_process_info(PhysicsServer::INFO_COLLISION_PAIRS);
 		case PHYSICS_3D_ISLAND_COUNT: return PhysicsServer::get_singleton()->get_process_info(PhysicsServer::INFO_ISLAND_COUNT);
 		case AUDIO_OUTPUT_LATENCY: return AudioServer::get_singleton()->get_output_latency();
+		case PHYSICS_2D_BROADPHASE_TIME: return Physics2DServer::get_singleton()->get_process_info(Physics2DServer::INFO_BROADPHASE_TIME) / 1000000.0;
+		case PHYSICS_2D_PAIR_GENERATION_TIME: return Physics2DServer::get_singleton()->get_process_info(Physics2DServer::INFO_PAIR_GENERATION_TIME) / 1000000.0;
+		case PHYSICS_2D_NARROWPHASE_TIME: return Physics2DServer::get_singleton()->get_process_info(Physics2DServer::INFO_NARROWPHASE_TIME) / 1000000.0;
+		case PHYSICS_2D_GENERATE_ISLANDS_TIME: return Physics2DServer::get_singleton()->get_process_info(Physics2DServer::INFO_GENERATE_ISLANDS_TIME) / 1000000.0;
+		case PHYSICS_2D_SETUP_CONSTRAINTS_TIME: return Physics2DServer::get_singleton()->get_process_info(Physics2DServer::INFO_SETUP_CONSTRAINTS_TIME) / 1000000.0;
+		case PHYSICS_2D_SOLVE_CONSTRAINTS_TIME: return Physics2DServer::get_singleton()->get_process_info(Physics2DServer::INFO_SOLVE_CONSTRAINTS_TIME) / 1000000.0;
+		case PHYSICS_2D_INTEGRATE_TIME: return Physics2DServer::get_singleton()->get_process_info(Physics2DServer::INFO_INTEGRATE_TIME) / 1000000.0;
+		case PHYSICS_2D_QUERY_CALLBACKS_TIME: return Physics2DServer::get_singleton()->get_process_info(Physics2DServer::INFO_QUERY_CALLBACKS_TIME) / 1000000.0;
+		case PHYSICS_3D_BROADPHASE_TIME: return PhysicsServer::get_singleton()->get_process_info(PhysicsServer::INFO_BROADPHASE_TIME) / 1000000.0;
+		case PHYSICS_3D_PAIR_GENERATION_TIME: return PhysicsServer::get_singleton()->get_process_info(PhysicsServer::INFO_PAIR_GENERATION_TIME) / 1000000.0;
+		case PHYSICS_3D_NARROWPHASE_TIME: return PhysicsServer::get_singleton()->get_process_info(PhysicsServer::INFO_NARROWPHASE_TIME) / 1000000.0;
+		case PHYSICS_3D_GENERATE_ISLANDS_TIME: return PhysicsServer::get_singleton()->get_process_info(PhysicsServer::INFO_GENERATE_ISLANDS_TIME) / 1000000.0;
+		case PHYSICS_3D_SETUP_CONSTRAINTS_TIME: return PhysicsServer::get_singleton()->get_process_info(PhysicsServer::INFO_SETUP_CONSTRAINTS_TIME) / 1000000.0;
+		case PHYSICS_3D_SOLVE_CONSTRAINTS_TIME: return PhysicsServer::get_singleton()->get_process_info(PhysicsServer::INFO_SOLVE_CONSTRAINTS_TIME) / 1000000.0;
+		case PHYSICS_3D_INTEGRATE_TIME: return PhysicsServer::get_singleton()->get_process_info(PhysicsServer::INFO_INTEGRATE_TIME) / 1000000.0;
+		case PHYSICS_3D_QUERY_CALLBACKS_TIME: return PhysicsServer::get_singleton()->get_process_info(PhysicsServer::INFO_QUERY_CALLBACKS_TIME) / 1000000.0;
 
 		default: {
 		}
@@ -208,6 +256,22 @@ Performance::MonitorType Performance::get_monitor_type(Monitor p_monitor) const
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_TIME,
 
 	};
 
@@ -83,6 +83,22 @@ public:
 		PHYSICS_3D_ISLAND_COUNT,
 		//physics
 		AUDIO_OUTPUT_LATENCY,
+		PHYSICS_2D_BROADPHASE_TIME,
+		PHYSICS_2D_PAIR_GENERATION_TIME,
+		PHYSICS_2D_NARROWPHASE_TIME,
+		PHYSICS_2D_GENERATE_ISLANDS_TIME,
+		PHYSICS_2D_SETUP_CONSTRAINTS_TIME,
+		PHYSICS_2D_SOLVE_CONSTRAINTS_TIME,
+		PHYSICS_2D_INTEGRATE_TIME,
+		PHYSICS_2D_QUERY_CALLBACKS_TIME,
+		PHYSICS_3D_BROADPHASE_TIME,
+		PHYSICS_3D_PAIR_GENERATION_TIME,
+		PHYSICS_3D_NARROWPHASE_TIME,
+		PHYSICS_3D_GENERATE_ISLANDS_TIME,
+		PHYSICS_3D_SETUP_CONSTRAINTS_TIME,
+		PHYSICS_3D_SOLVE_CONSTRAINTS_TIME,
+		PHYSICS_3D_INTEGRATE_TIME,
+		PHYSICS_3D_QUERY_CALLBACKS_TIME,
 		MONITOR_MAX
 	};
 
@@ -0,0 +1,341 @@
+/*************************************************************************/
+/*  test_gdnative.cpp                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_gdnative.h"
+
+#include "core/os/os.h"
+
+#ifdef MODULE_GDNATIVE_ENABLED
+
+#include "modules/gdnative/nativescript/nativescript.h"
+
+namespace TestGDNative {
+
+#define CHECK(m_cond)                                        \
+	if (!(m_cond)) {                                         \
+		OS::get_singleton()->print("\tFAIL: %s\n", #m_cond); \
+		return false;                                        \
+	}
+
+/* POOL ARRAYS */
+
+static bool test_pool_array_ptr() {
+
+	godot_pool_int_array array;
+	godot_pool_int_array_new(&array);
+
+	// Empty arrays have no storage.
+	CHECK(godot_pool_int_array_ptr(&array) == NULL);
+	CHECK(godot_pool_int_array_ptrw(&array) == NULL);
+
+	godot_pool_int_array_resize(&array, 16);
+	godot_int *w = godot_pool_int_array_ptrw(&array);
+	CHECK(w != NULL);
+	for (int i = 0; i < 16; i++) {
+		w[i] = i * i;
+	}
+
+	const godot_int *r = godot_pool_int_array_ptr(&array);
+	CHECK(r == w);
+	for (int i = 0; i < 16; i++) {
+		CHECK(r[i] == i * i);
+		CHECK(godot_pool_int_array_get(&array, i) == i * i);
+	}
+
+	// ptrw() copies a shared array first, like write().
+	godot_pool_int_array copy;
+	godot_pool_int_array_new_copy(&copy, &array);
+	CHECK(godot_pool_int_array_ptr(&copy) == r);
+
+	godot_int *copy_w = godot_pool_int_array_ptrw(&copy);
+	CHECK(copy_w != r);
+	copy_w[0] = -1;
+	CHECK(godot_pool_int_array_get(&copy, 0) == -1);
+	CHECK(godot_pool_int_array_get(&array, 0) == 0);
+
+	godot_pool_int_array_resize(&array, 0);
+	CHECK(godot_pool_int_array_ptr(&array) == NULL);
+
+	godot_pool_int_array_destroy(&copy);
+	godot_pool_int_array_destroy(&array);
+
+	return true;
+}
+
+static bool test_pool_array_types() {
+
+	// Every element type maps to the engine's own layout.
+	PoolVector<Vector3> vectors;
+	vectors.push_back(Vector3(1, 2, 3));
+	vectors.push_back(Vector3(4, 5, 6));
+	const godot_vector3 *v = godot_pool_vector3_array_ptr((const godot_pool_vector3_array *)&vectors);
+	CHECK(v && ((const Vector3 *)v)[1] == Vector3(4, 5, 6));
+
+	PoolVector<Color> colors;
+	colors.push_back(Color(0.25, 0.5, 0.75, 1.0));
+	godot_color *c = godot_pool_color_array_ptrw((godot_pool_color_array *)&colors);
+	CHECK(c);
+	((Color *)c)[0].a = 0.5;
+	CHECK(colors[0] == Color(0.25, 0.5, 0.75, 0.5));
+
+	PoolVector<uint8_t> bytes;
+	CHECK(godot_pool_byte_array_ptr((const godot_pool_byte_array *)&bytes) == NULL);
+	bytes.push_back(7);
+	CHECK(godot_pool_byte_array_ptr((const godot_pool_byte_array *)&bytes)[0] == 7);
+
+	PoolVector<real_t> reals;
+	reals.push_back(0.5);
+	CHECK(godot_pool_real_array_ptr((const godot_pool_real_array *)&reals)[0] == 0.5);
+
+	PoolVector<Vector2> points;
+	CHECK(godot_pool_vector2_array_ptrw((godot_pool_vector2_array *)&points) == NULL);
+
+	return true;
+}
+
+/* NATIVESCRIPT PTRCALL */
+
+// A NativeScript without a library looks its classes up under an empty
+// library path, so classes registered with this handle can be instanced
+// without loading a shared library.
+static String test_library_path;
+static const char *test_class = "TestPtrcall";
+
+struct TestInstance {
+	godot_object *owner;
+	int ptrcalls;
+};
+
+static int freed_method_data = 0;
+
+static void *_create_instance(godot_object *p_owner, void *p_method_data) {
+
+	TestInstance *instance = memnew(TestInstance);
+	instance->owner = p_owner;
+	instance->ptrcalls = 0;
+	return instance;
+}
+
+static void _destroy_instance(godot_object *p_owner, void *p_method_data, void *p_user_data) {
+
+	memdelete((TestInstance *)p_user_data);
+}
+
+static void _free_method_data(void *p_method_data) {
+
+	freed_method_data++;
+}
+
+static godot_variant _add(godot_object *p_owner, void *p_method_data, void *p_user_data, int p_num_args, godot_variant **p_args) {
+
+	godot_variant ret;
+	Variant *r = (Variant *)&ret;
+	memnew_placement(r, Variant);
+	if (p_num_args == 2 && ((Variant *)p_args[0])->get_type() == Variant::INT && ((Variant *)p_args[1])->get_type() == Variant::INT) {
+		*r = (int64_t)*(Variant *)p_args[0] + (int64_t)*(Variant *)p_args[1];
+	}
+	return ret;
+}
+
+static void _add_ptrcall(godot_object *p_owner, void *p_method_data, void *p_user_data, const void **p_args, void *r_ret) {
+
+	TestInstance *instance = (TestInstance *)p_user_data;
+	if (instance->owner == p_owner) {
+		instance->ptrcalls++;
+	}
+	*(int64_t *)r_ret = *(const int64_t *)p_args[0] + *(const int64_t *)p_args[1];
+}
+
+static godot_variant _sum(godot_object *p_owner, void *p_method_data, void *p_user_data, int p_num_args, godot_variant **p_args) {
+
+	godot_variant ret;
+	memnew_placement((Variant *)&ret, Variant);
+	return ret;
+}
+
+static void _sum_ptrcall(godot_object *p_owner, void *p_method_data, void *p_user_data, const void **p_args, void *r_ret) {
+
+	const godot_pool_int_array *array = (const godot_pool_int_array *)p_args[0];
+	const godot_int *values = godot_pool_int_array_ptr(array);
+	int64_t sum = 0;
+	for (godot_int i = 0; i < godot_pool_int_array_size(array); i++) {
+		sum += values[i];
+	}
+	*(int64_t *)r_ret = sum;
+}
+
+static void _register_test_class() {
+
+	godot_instance_create_func create = { _create_instance, NULL, NULL };
+	godot_instance_destroy_func destroy = { _destroy_instance, NULL, NULL };
+	godot_nativescript_register_class(&test_library_path, test_class, "Reference", create, destroy);
+
+	godot_method_attributes attributes = { GODOT_METHOD_RPC_MODE_DISABLED };
+	godot_instance_method add = { _add, NULL, NULL };
+	godot_instance_method sum = { _sum, NULL, NULL };
+	godot_nativescript_register_method(&test_library_path, test_class, "add", attributes, add);
+	godot_nativescript_register_method(&test_library_path, test_class, "sum", attributes, sum);
+	godot_nativescript_register_method(&test_library_path, test_class, "variant_only", attributes, add);
+
+	// Setting an entry point again frees the previous method data.
+	godot_instance_ptrcall_method first = { _add_ptrcall, &freed_method_data, _free_method_data };
+	godot_instance_ptrcall_method add_ptrcall = { _add_ptrcall, NULL, NULL };
+	godot_instance_ptrcall_method sum_ptrcall = { _sum_ptrcall, NULL, NULL };
+	godot_nativescript_set_method_ptrcall(&test_library_path, test_class, "add", first);
+	godot_nativescript_set_method_ptrcall(&test_library_path, test_class, "add", add_ptrcall);
+	godot_nativescript_set_method_ptrcall(&test_library_path, test_class, "sum", sum_ptrcall);
+}
+
+static bool _test_ptrcall(Object *p_object) {
+
+	StringName add = "add";
+	StringName sum = "sum";
+	StringName variant_only = "variant_only";
+	StringName missing = "missing";
+
+	int64_t a = 3;
+	int64_t b = 4;
+	const void *add_args[2] = { &a, &b };
+	int64_t ret = 0;
+	CHECK(godot_nativescript_method_ptrcall((godot_object *)p_object, (const godot_string_name *)&add, add_args, &ret));
+	CHECK(ret == 7);
+	CHECK(((TestInstance *)((NativeScriptInstance *)p_object->get_script_instance())->userdata)->ptrcalls == 1);
+	CHECK(int(p_object->call(add, 3, 4)) == 7);
+
+	PoolVector<int> values;
+	const void *sum_args[1] = { &values };
+	ret = -1;
+	CHECK(godot_nativescript_method_ptrcall((godot_object *)p_object, (const godot_string_name *)&sum, sum_args, &ret));
+	CHECK(ret == 0);
+
+	for (int i = 1; i <= 100; i++) {
+		values.push_back(i);
+	}
+	CHECK(godot_nativescript_method_ptrcall((godot_object *)p_object, (const godot_string_name *)&sum, sum_args, &ret));
+	CHECK(ret == 5050);
+
+	// Without a typed entry point the caller has to fall back to a Variant call,
+	// which validates the arguments.
+	ret = -1;
+	CHECK(!godot_nativescript_method_ptrcall((godot_object *)p_object, (const godot_string_name *)&variant_only, add_args, &ret));
+	CHECK(!godot_nativescript_method_ptrcall((godot_object *)p_object, (const godot_string_name *)&missing, add_args, &ret));
+	CHECK(ret == -1);
+	CHECK(int(p_object->call(variant_only, 3, 4)) == 7);
+	CHECK(p_object->call(variant_only, "3", 4).get_type() == Variant::NIL);
+
+	return true;
+}
+
+static bool test_nativescript_ptrcall() {
+
+	freed_method_data = 0;
+	_register_test_class();
+	CHECK(freed_method_data == 1);
+
+	// Setting an entry point for an unknown method fails without side effects.
+	godot_instance_ptrcall_method unknown = { _add_ptrcall, &freed_method_data, _free_method_data };
+	godot_nativescript_set_method_ptrcall(&test_library_path, test_class, "missing", unknown);
+	CHECK(freed_method_data == 1);
+
+	Ref<NativeScript> script;
+	script.instance();
+	script->set_class_name(test_class);
+	CHECK(script->can_instance());
+
+	Ref<Reference> object;
+	object.instance();
+	object->set_script(script.get_ref_ptr());
+	CHECK(object->get_script_instance());
+	bool ok = _test_ptrcall(object.ptr());
+	object.unref();
+	script.unref();
+
+	// Objects that aren't NativeScript instances are rejected.
+	StringName add = "add";
+	int64_t a = 3;
+	int64_t b = 4;
+	const void *add_args[2] = { &a, &b };
+	int64_t ret = -1;
+	Ref<Reference> plain;
+	plain.instance();
+	ok = ok && !godot_nativescript_method_ptrcall(NULL, (const godot_string_name *)&add, add_args, &ret);
+	ok = ok && !godot_nativescript_method_ptrcall((godot_object *)plain.ptr(), (const godot_string_name *)&add, add_args, &ret);
+	ok = ok && ret == -1;
+
+	NativeScriptLanguage::get_singleton()->library_classes.erase(test_library_path);
+
+	return ok;
+}
+
+typedef bool (*TestFunc)();
+
+static const char *test_names[] = {
+	"Pool array direct access",
+	"Pool array element types",
+	"NativeScript typed methods",
+	NULL
+};
+
+static const TestFunc test_funcs[] = {
+	test_pool_array_ptr,
+	test_pool_array_types,
+	test_nativescript_ptrcall,
+	NULL
+};
+
+MainLoop *test() {
+
+	int failed = 0;
+	for (int i = 0; test_funcs[i]; i++) {
+		OS::get_singleton()->print("%s\n", test_names[i]);
+		bool pass = test_funcs[i]();
+		OS::get_singleton()->print("\t%s\n", pass ? "PASS" : "FAILED");
+		if (!pass) {
+			failed++;
+		}
+	}
+
+	OS::get_singleton()->set_exit_code(failed ? 1 : 0);
+	return NULL;
+}
+} // namespace TestGDNative
+
+#else
+
+namespace TestGDNative {
+
+MainLoop *test() {
+
+	print_line("GDNative is disabled in this build.");
+	return NULL;
+}
+} // namespace TestGDNative
+
+#endif
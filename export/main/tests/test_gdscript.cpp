@@ -814,6 +814,26 @@ static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String
 
 					incr = 4 + argc;
 
+				} break;
+				case GDScriptFunction::OPCODE_CALL_BUILT_IN_VALIDATED: {
+
+					txt += " call-built-in-validated ";
+
+					int argc = code[ip + 2];
+					txt += DADDR(3 + argc) + "=";
+
+					txt += GDScriptFunctions::get_func_name(GDScriptFunctions::get_validated_builtin(code[ip + 1]).function);
+					txt += "(";
+
+					for (int i = 0; i < argc; i++) {
+						if (i > 0)
+							txt += ", ";
+						txt += DADDR(3 + i);
+					}
+					txt += ")";
+
+					incr = 4 + argc;
+
 				} break;
 				case GDScriptFunction::OPCODE_CALL_SELF_BASE: {
 
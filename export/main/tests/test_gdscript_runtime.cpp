@@ -0,0 +1,751 @@
+/*************************************************************************/
+/*  test_gdscript_runtime.cpp                                            */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_gdscript_runtime.h"
+
+#include "core/io/json.h"
+#include "core/io/resource_loader.h"
+#include "core/os/dir_access.h"
+#include "core/os/file_access.h"
+#include "core/os/os.h"
+#include "core/project_settings.h"
+
+#ifdef GDSCRIPT_ENABLED
+
+#include "modules/gdscript/gdscript.h"
+#include "modules/gdscript/gdscript_functions.h"
+#include "modules/gdscript/gdscript_sampling_profiler.h"
+
+namespace TestGDScriptRuntime {
+
+#define CHECK(m_cond)                                        \
+	if (!(m_cond)) {                                         \
+		OS::get_singleton()->print("\tFAIL: %s\n", #m_cond); \
+		return false;                                        \
+	}
+
+static Ref<GDScript> _compile(const String &p_code) {
+
+	Ref<GDScript> script;
+	script.instance();
+	script->set_source_code(p_code);
+	if (script->reload() != OK) {
+		return Ref<GDScript>();
+	}
+	return script;
+}
+
+#ifdef DEBUG_ENABLED
+
+// spin() keeps calling step() from line 7 for the given time, so samples can
+// only land on lines 3-8 of spin() and lines 10-11 of step().
+static const char *profiler_script =
+		"extends Reference\n"
+		"\n"
+		"static func spin(msec):\n"
+		"\tvar end = OS.get_ticks_msec() + msec\n"
+		"\tvar count = 0\n"
+		"\twhile OS.get_ticks_msec() < end:\n"
+		"\t\tcount = step(count)\n"
+		"\treturn count\n"
+		"\n"
+		"static func step(count):\n"
+		"\treturn count + 1\n";
+
+static bool _is_valid_frame(const String &p_function, int p_line) {
+
+	if (p_function == "spin") {
+		return p_line >= 3 && p_line <= 8;
+	}
+	if (p_function == "step") {
+		return p_line >= 10 && p_line <= 11;
+	}
+	return false;
+}
+
+static bool _check_collapsed(const String &p_path) {
+
+	String text = FileAccess::get_file_as_string(p_path);
+	CHECK(text != "");
+
+	Vector<String> lines = text.split("\n", false);
+	uint64_t nested = 0;
+	for (int i = 0; i < lines.size(); i++) {
+		// Each line is "frame;frame;... count", each frame is "path:function:line".
+		int space = lines[i].find_last(" ");
+		CHECK(space > 0);
+		CHECK(lines[i].substr(space + 1, lines[i].length()).to_int() > 0);
+
+		Vector<String> frames = lines[i].substr(0, space).split(";");
+		for (int j = 0; j < frames.size(); j++) {
+			Vector<String> parts = frames[j].split(":");
+			CHECK(parts.size() == 3);
+			CHECK(parts[0] == "<built-in>");
+			CHECK(_is_valid_frame(parts[1], parts[2].to_int()));
+		}
+		CHECK(frames.size() <= 2);
+		CHECK(frames[0].get_slice(":", 1) == "spin");
+		if (frames.size() == 2) {
+			// The caller keeps its own line while the callee runs.
+			CHECK(frames[0] == "<built-in>:spin:7");
+			nested++;
+		}
+	}
+	CHECK(nested > 0);
+
+	return true;
+}
+
+static bool _check_chrome_trace(const String &p_path) {
+
+	String text = FileAccess::get_file_as_string(p_path);
+	CHECK(text != "");
+
+	Variant result;
+	String err_str;
+	int err_line;
+	CHECK(JSON::parse(text, result, err_str, err_line) == OK);
+	CHECK(result.get_type() == Variant::DICTIONARY);
+
+	Dictionary trace = result;
+	CHECK(trace.has("stackFrames") && trace.has("samples"));
+	Dictionary frames = trace["stackFrames"];
+	Array samples = trace["samples"];
+	CHECK(frames.size() > 0);
+	CHECK(samples.size() > 0);
+
+	List<Variant> keys;
+	frames.get_key_list(&keys);
+	for (List<Variant>::Element *E = keys.front(); E; E = E->next()) {
+		Dictionary frame = frames[E->get()];
+		// "function (path:line)"
+		String name = frame["name"];
+		String function = name.get_slice(" ", 0);
+		int line = name.get_slice(":", 1).to_int();
+		CHECK(_is_valid_frame(function, line));
+		if (frame.has("parent")) {
+			CHECK(frames.has(frame["parent"]));
+		}
+	}
+
+	for (int i = 0; i < samples.size(); i++) {
+		Dictionary sample = samples[i];
+		CHECK(frames.has(sample["sf"]));
+	}
+
+	return true;
+}
+
+static bool _test_profiler() {
+
+	GDScriptSamplingProfiler *profiler = GDScriptSamplingProfiler::get_singleton();
+	CHECK(profiler);
+
+	Ref<GDScript> script = _compile(profiler_script);
+	CHECK(script.is_valid());
+
+	CHECK(profiler->start(2000) == OK);
+	Variant count = script->Object::call("spin", 250);
+	profiler->stop();
+
+	CHECK(int(count) > 0);
+	CHECK(profiler->get_sample_count() > 0);
+
+	String collapsed_path = OS::get_singleton()->get_user_data_dir().plus_file("test_gdscript_profile.txt");
+	String trace_path = OS::get_singleton()->get_user_data_dir().plus_file("test_gdscript_profile.json");
+	CHECK(profiler->save(collapsed_path, GDScriptSamplingProfiler::get_format_for_path(collapsed_path)) == OK);
+	CHECK(profiler->save(trace_path, GDScriptSamplingProfiler::get_format_for_path(trace_path)) == OK);
+	profiler->clear();
+
+	bool ok = _check_collapsed(collapsed_path) && _check_chrome_trace(trace_path);
+
+	DirAccess::remove_file_or_error(collapsed_path);
+	DirAccess::remove_file_or_error(trace_path);
+
+	return ok;
+}
+
+#endif // DEBUG_ENABLED
+
+/* BUILT-IN FUNCTIONS */
+
+// The specialized built-ins must be indistinguishable from the generic call,
+// both when called directly and when selected by the compiler.
+
+struct BuiltinCase {
+	const char *name;
+	int arg_count;
+};
+
+static const BuiltinCase builtin_cases[] = {
+	{ "sin", 1 },
+	{ "cos", 1 },
+	{ "sqrt", 1 },
+	{ "floor", 1 },
+	{ "abs", 1 },
+	{ "sign", 1 },
+	{ "step_decimals", 1 },
+	{ "nearest_po2", 1 },
+	{ "atan2", 2 },
+	{ "fmod", 2 },
+	{ "posmod", 2 },
+	{ "pow", 2 },
+	{ "stepify", 2 },
+	{ "ease", 2 },
+	{ "is_equal_approx", 2 },
+	{ "polar2cartesian", 2 },
+	{ "max", 2 },
+	{ "min", 2 },
+	{ "clamp", 3 },
+	{ "lerp", 3 },
+	{ "wrapi", 3 },
+	{ "wrapf", 3 },
+	{ "move_toward", 3 },
+	{ "range_lerp", 5 },
+	{ NULL, 0 }
+};
+
+enum {
+	SAMPLE_COUNT = 5
+};
+
+static const int64_t int_samples[SAMPLE_COUNT] = { 0, 3, -7, 1, 12 };
+static const double real_samples[SAMPLE_COUNT] = { 0.0, 0.5, -2.25, 3.75, 1000.0 };
+
+static Variant _sample(Variant::Type p_type, int p_idx) {
+
+	int i = p_idx % SAMPLE_COUNT;
+	switch (p_type) {
+		case Variant::INT:
+			return int_samples[i];
+		case Variant::REAL:
+			return real_samples[i];
+		case Variant::VECTOR2:
+			return Vector2(real_samples[i], int_samples[i]);
+		case Variant::VECTOR3:
+			return Vector3(real_samples[i], int_samples[i], -real_samples[i]);
+		case Variant::COLOR:
+			return Color(0.2 * i, 0.5, 1.0 - 0.2 * i, 1.0);
+		default:
+			return Variant();
+	}
+}
+
+static GDScriptFunctions::Function _find_builtin(const String &p_name) {
+
+	for (int i = 0; i < GDScriptFunctions::FUNC_MAX; i++) {
+		if (p_name == GDScriptFunctions::get_func_name(GDScriptFunctions::Function(i))) {
+			return GDScriptFunctions::Function(i);
+		}
+	}
+	return GDScriptFunctions::FUNC_MAX;
+}
+
+// Integer modulo by zero is undefined in both versions.
+static bool _is_undefined(GDScriptFunctions::Function p_func, const Variant **p_args) {
+
+	return p_func == GDScriptFunctions::MATH_POSMOD && (int64_t)*p_args[1] == 0;
+}
+
+static bool _same_result(const Variant &p_a, const Variant &p_b) {
+
+	// hash_compare() treats NaN as equal to itself.
+	return p_a.get_type() == p_b.get_type() && p_a.hash_compare(p_b);
+}
+
+static String _format_call(const String &p_name, const Variant **p_args, int p_arg_count) {
+
+	String text = p_name + "(";
+	for (int i = 0; i < p_arg_count; i++) {
+		if (i > 0) {
+			text += ", ";
+		}
+		text += Variant::get_type_name(p_args[i]->get_type()) + " " + String(*p_args[i]);
+	}
+	return text + ")";
+}
+
+static bool _test_validated_builtins() {
+
+	static const Variant::Type candidate_types[] = { Variant::INT, Variant::REAL, Variant::VECTOR2, Variant::VECTOR3, Variant::COLOR };
+	static const int candidate_count = sizeof(candidate_types) / sizeof(candidate_types[0]);
+
+	for (int i = 0; i < GDScriptFunctions::get_validated_builtin_count(); i++) {
+
+		const GDScriptFunctions::ValidatedBuiltin &builtin = GDScriptFunctions::get_validated_builtin(i);
+		String name = GDScriptFunctions::get_func_name(builtin.function);
+
+		// Call it with every combination of the types each argument accepts.
+		Vector<Variant::Type> accepted[GDScriptFunctions::VALIDATED_MAX_ARGS];
+		int combinations = 1;
+		for (int j = 0; j < builtin.arg_count; j++) {
+			for (int k = 0; k < candidate_count; k++) {
+				if (builtin.arg_masks[j] & (1 << candidate_types[k])) {
+					accepted[j].push_back(candidate_types[k]);
+				}
+			}
+			CHECK(accepted[j].size() > 0);
+			combinations *= accepted[j].size();
+		}
+
+		for (int c = 0; c < combinations; c++) {
+			for (int k = 0; k < SAMPLE_COUNT; k++) {
+
+				Variant args[GDScriptFunctions::VALIDATED_MAX_ARGS];
+				const Variant *argptrs[GDScriptFunctions::VALIDATED_MAX_ARGS];
+				int rest = c;
+				for (int j = 0; j < builtin.arg_count; j++) {
+					args[j] = _sample(accepted[j][rest % accepted[j].size()], k + j);
+					argptrs[j] = &args[j];
+					rest /= accepted[j].size();
+				}
+
+				if (_is_undefined(builtin.function, argptrs)) {
+					continue;
+				}
+
+				// Same seed for the random functions.
+				Variant expected;
+				Variant::CallError ce;
+				Math::seed(k + 1);
+				GDScriptFunctions::call(builtin.function, argptrs, builtin.arg_count, expected, ce);
+
+				Variant result;
+				Math::seed(k + 1);
+				builtin.call(argptrs, result);
+
+				if (ce.error != Variant::CallError::CALL_OK || !_same_result(expected, result)) {
+					print_line("\t" + _format_call(name, argptrs, builtin.arg_count) + ": expected " + String(expected) + ", got " + String(result));
+					return false;
+				}
+			}
+		}
+
+		// Anything else must be rejected, so the VM falls back to the generic call.
+		for (int j = 0; j < builtin.arg_count; j++) {
+			CHECK(!GDScriptFunctions::validated_builtin_accepts(builtin, j, Variant()));
+			CHECK(!GDScriptFunctions::validated_builtin_accepts(builtin, j, "x"));
+			CHECK(!GDScriptFunctions::validated_builtin_accepts(builtin, j, Array()));
+		}
+	}
+
+	return true;
+}
+
+static bool _check_script_call(Object *p_script, const String &p_wrapper, GDScriptFunctions::Function p_func, const Variant **p_args, int p_arg_count) {
+
+	if (_is_undefined(p_func, p_args)) {
+		return true;
+	}
+
+	Variant expected;
+	Variant::CallError ce;
+	GDScriptFunctions::call(p_func, p_args, p_arg_count, expected, ce);
+
+	Variant::CallError call_err;
+	Variant result = p_script->call(p_wrapper, p_args, p_arg_count, call_err);
+
+	// A failed built-in call stops the script function, which then returns null.
+	bool ok = call_err.error == Variant::CallError::CALL_OK;
+	if (ce.error == Variant::CallError::CALL_OK) {
+		ok = ok && _same_result(expected, result);
+	} else {
+		ok = ok && result.get_type() == Variant::NIL;
+	}
+
+	if (!ok) {
+		print_line("\t" + _format_call(p_wrapper, p_args, p_arg_count) + ": expected " + (ce.error == Variant::CallError::CALL_OK ? String(expected) : String("an error")) + ", got " + String(result));
+	}
+	return ok;
+}
+
+static bool _test_builtins_in_script() {
+
+	// u_ wrappers have untyped arguments, f_ and i_ ones are typed, so the
+	// compiler picks the specialized versions where it can.
+	String code = "extends Reference\n";
+	for (int i = 0; builtin_cases[i].name; i++) {
+
+		String name = builtin_cases[i].name;
+		String args;
+		String untyped_params;
+		String float_params;
+		String int_params;
+		for (int j = 0; j < builtin_cases[i].arg_count; j++) {
+			String sep = j > 0 ? ", " : "";
+			String arg = "a" + itos(j);
+			args += sep + arg;
+			untyped_params += sep + arg;
+			float_params += sep + arg + ": float";
+			int_params += sep + arg + ": int";
+		}
+
+		code += "\nstatic func u_" + name + "(" + untyped_params + "):\n\treturn " + name + "(" + args + ")\n";
+		code += "\nstatic func f_" + name + "(" + float_params + "):\n\treturn " + name + "(" + args + ")\n";
+		code += "\nstatic func i_" + name + "(" + int_params + "):\n\treturn " + name + "(" + args + ")\n";
+	}
+
+	Ref<GDScript> script = _compile(code);
+	CHECK(script.is_valid());
+
+	for (int i = 0; builtin_cases[i].name; i++) {
+
+		String name = builtin_cases[i].name;
+		int arg_count = builtin_cases[i].arg_count;
+		GDScriptFunctions::Function func = _find_builtin(name);
+		CHECK(func != GDScriptFunctions::FUNC_MAX);
+
+		Variant args[GDScriptFunctions::VALIDATED_MAX_ARGS];
+		const Variant *argptrs[GDScriptFunctions::VALIDATED_MAX_ARGS];
+		for (int j = 0; j < arg_count; j++) {
+			argptrs[j] = &args[j];
+		}
+
+		// Every mix of int and float arguments.
+		for (int mix = 0; mix < (1 << arg_count); mix++) {
+			for (int k = 0; k < SAMPLE_COUNT; k++) {
+				for (int j = 0; j < arg_count; j++) {
+					args[j] = _sample(mix & (1 << j) ? Variant::REAL : Variant::INT, k + j);
+				}
+				CHECK(_check_script_call(script.ptr(), "u_" + name, func, argptrs, arg_count));
+			}
+		}
+
+		for (int k = 0; k < SAMPLE_COUNT; k++) {
+			for (int j = 0; j < arg_count; j++) {
+				args[j] = _sample(Variant::REAL, k + j);
+			}
+			CHECK(_check_script_call(script.ptr(), "f_" + name, func, argptrs, arg_count));
+
+			for (int j = 0; j < arg_count; j++) {
+				args[j] = _sample(Variant::INT, k + j);
+			}
+			CHECK(_check_script_call(script.ptr(), "i_" + name, func, argptrs, arg_count));
+		}
+
+		// One argument of a wrong type, which the specialized version must not take.
+		for (int j = 0; j < arg_count; j++) {
+			for (int k = 0; k < arg_count; k++) {
+				args[k] = _sample(Variant::INT, k + 1);
+			}
+			args[j] = "x";
+			CHECK(_check_script_call(script.ptr(), "u_" + name, func, argptrs, arg_count));
+			args[j] = Variant();
+			CHECK(_check_script_call(script.ptr(), "u_" + name, func, argptrs, arg_count));
+		}
+	}
+
+	// lerp() also takes vectors and colors.
+	static const Variant::Type lerp_types[] = { Variant::VECTOR2, Variant::VECTOR3, Variant::COLOR };
+	GDScriptFunctions::Function lerp = GDScriptFunctions::MATH_LERP;
+	for (int i = 0; i < 3; i++) {
+		Variant args[3] = { _sample(lerp_types[i], 1), _sample(lerp_types[i], 3), 0.25 };
+		const Variant *argptrs[3] = { &args[0], &args[1], &args[2] };
+		CHECK(_check_script_call(script.ptr(), "u_lerp", lerp, argptrs, 3));
+		args[2] = 1;
+		CHECK(_check_script_call(script.ptr(), "u_lerp", lerp, argptrs, 3));
+		args[1] = "x";
+		CHECK(_check_script_call(script.ptr(), "u_lerp", lerp, argptrs, 3));
+	}
+
+	return true;
+}
+
+/* PARALLEL LOADER */
+
+struct LoaderFile {
+	const char *name;
+	const char *code;
+};
+
+static const LoaderFile loader_files[] = {
+	// Diamond: a preloads b and c, which both preload d.
+	{ "a.gd", "const B = preload(\"b.gd\")\nconst C = preload(\"c.gd\")\n\nstatic func value():\n\treturn B.value() + C.value()\n" },
+	{ "b.gd", "const D = preload(\"d.gd\")\n\nstatic func value():\n\treturn D.value() + 1\n" },
+	{ "c.gd", "const D = preload(\"d.gd\")\n\nstatic func value():\n\treturn D.value() * 2\n" },
+	{ "d.gd", "static func value():\n\treturn 4\n" },
+	// Cycle: e and f preload each other.
+	{ "e.gd", "const F = preload(\"f.gd\")\n" },
+	{ "f.gd", "const E = preload(\"e.gd\")\n" },
+	// A dependency that doesn't parse.
+	{ "g.gd", "const H = preload(\"h.gd\")\n" },
+	{ "h.gd", "static func broken(:\n\treturn 1\n" },
+	// A dependency that doesn't tokenize.
+	{ "i.gd", "const J = preload(\"j.gd\")\n" },
+	{ "j.gd", "var s = \"unterminated\n" },
+	{ NULL, NULL }
+};
+
+static const char *loader_dir = "user://test_gdscript_loader";
+
+static String _loader_path(const String &p_name) {
+
+	return String(loader_dir).plus_file(p_name);
+}
+
+// Lists every script reachable through constants, with its validity.
+static void _describe_script(const Ref<GDScript> &p_script, Set<String> &r_visited, String &r_description) {
+
+	if (p_script.is_null() || r_visited.has(p_script->get_path())) {
+		return;
+	}
+	r_visited.insert(p_script->get_path());
+	r_description += p_script->get_path().get_file() + (p_script->is_valid() ? " valid\n" : " invalid\n");
+
+	// StringName order depends on addresses, sort to compare descriptions.
+	const Map<StringName, Variant> &constants = p_script->get_constants();
+	List<StringName> names;
+	for (const Map<StringName, Variant>::Element *E = constants.front(); E; E = E->next()) {
+		names.push_back(E->key());
+	}
+	names.sort_custom<StringName::AlphCompare>();
+
+	for (List<StringName>::Element *E = names.front(); E; E = E->next()) {
+		_describe_script(constants[E->get()], r_visited, r_description);
+	}
+}
+
+static bool _load_scripts(bool p_parallel, String &r_description) {
+
+	GDScriptParallelLoader &loader = GDScriptLanguage::get_singleton()->get_parallel_loader();
+	ProjectSettings::get_singleton()->set("gdscript/loading/parallel_prefetch", p_parallel);
+	loader.init();
+	CHECK(loader.is_enabled() == p_parallel);
+
+	for (int i = 0; loader_files[i].name; i++) {
+		// Left over from the other mode.
+		CHECK(!ResourceCache::has(_loader_path(loader_files[i].name)));
+	}
+
+	Ref<GDScript> a = ResourceLoader::load(_loader_path("a.gd"));
+	CHECK(a.is_valid() && a->is_valid());
+	CHECK(int(a->Object::call("value")) == 13);
+
+	// Both sides of the diamond share the same d.gd.
+	const Map<StringName, Variant> &a_constants = a->get_constants();
+	CHECK(a_constants.has("B") && a_constants.has("C"));
+	Ref<GDScript> b = a_constants["B"];
+	Ref<GDScript> c = a_constants["C"];
+	CHECK(b.is_valid() && c.is_valid());
+	CHECK(b->get_constants().has("D") && c->get_constants().has("D"));
+	CHECK(b->get_constants()["D"] == c->get_constants()["D"]);
+	CHECK(Ref<GDScript>(b->get_constants()["D"]) == ResourceLoader::load(_loader_path("d.gd")));
+
+	// The cycle must be reported by ResourceLoader and not loop forever.
+	Ref<GDScript> e = ResourceLoader::load(_loader_path("e.gd"));
+	CHECK(e.is_valid());
+
+	Ref<GDScript> g = ResourceLoader::load(_loader_path("g.gd"));
+	Ref<GDScript> h = ResourceLoader::load(_loader_path("h.gd"));
+	CHECK(g.is_valid() && h.is_valid());
+	CHECK(!h->is_valid());
+
+	Ref<GDScript> i = ResourceLoader::load(_loader_path("i.gd"));
+	Ref<GDScript> j = ResourceLoader::load(_loader_path("j.gd"));
+	CHECK(i.is_valid() && j.is_valid());
+	CHECK(!j->is_valid());
+
+	// Nothing prefetched is left behind once the scripts are loaded.
+	for (int k = 0; loader_files[k].name; k++) {
+		String source;
+		Vector<uint8_t> tokens;
+		CHECK(!loader.take(_loader_path(loader_files[k].name), source, tokens));
+	}
+
+	Set<String> visited;
+	_describe_script(a, visited, r_description);
+	_describe_script(e, visited, r_description);
+	_describe_script(g, visited, r_description);
+	_describe_script(h, visited, r_description);
+	_describe_script(i, visited, r_description);
+	_describe_script(j, visited, r_description);
+
+	return true;
+}
+
+static bool _test_prefetch() {
+
+	GDScriptParallelLoader &loader = GDScriptLanguage::get_singleton()->get_parallel_loader();
+	ProjectSettings::get_singleton()->set("gdscript/loading/parallel_prefetch", true);
+	loader.init();
+	loader.clear();
+
+	Vector<String> paths;
+	paths.push_back(_loader_path("a.gd"));
+	paths.push_back(_loader_path("e.gd"));
+	paths.push_back(_loader_path("g.gd"));
+	paths.push_back(_loader_path("i.gd"));
+	loader.prefetch(paths);
+
+	// Every script is read once, following the dependencies of each. Scripts that
+	// don't tokenize are left to the regular load, which reports the error.
+	for (int i = 0; loader_files[i].name; i++) {
+		String path = _loader_path(loader_files[i].name);
+		String source;
+		Vector<uint8_t> tokens;
+		bool taken = loader.take(path, source, tokens);
+		loader.finish(path);
+		if (String(loader_files[i].name) == "j.gd") {
+			CHECK(!taken);
+			continue;
+		}
+		CHECK(taken);
+		CHECK(source == loader_files[i].code);
+		CHECK(!loader.take(path, source, tokens));
+	}
+
+	return true;
+}
+
+static bool _test_loader() {
+
+	DirAccessRef dir = DirAccess::create(DirAccess::ACCESS_USERDATA);
+	CHECK(dir->make_dir_recursive(loader_dir) == OK);
+
+	for (int i = 0; loader_files[i].name; i++) {
+		FileAccessRef f = FileAccess::open(_loader_path(loader_files[i].name), FileAccess::WRITE);
+		CHECK(f);
+		f->store_string(loader_files[i].code);
+		f->close();
+	}
+
+	bool prev_parallel = GLOBAL_GET("gdscript/loading/parallel_prefetch");
+
+	String parallel_description;
+	String serial_description;
+	bool ok = _test_prefetch() && _load_scripts(true, parallel_description) && _load_scripts(false, serial_description);
+	if (ok && parallel_description != serial_description) {
+		print_line("\tParallel load:\n" + parallel_description + "\tSerial load:\n" + serial_description);
+		ok = false;
+	}
+
+	ProjectSettings::get_singleton()->set("gdscript/loading/parallel_prefetch", prev_parallel);
+	GDScriptLanguage::get_singleton()->get_parallel_loader().init();
+	GDScriptLanguage::get_singleton()->get_parallel_loader().clear();
+
+	for (int i = 0; loader_files[i].name; i++) {
+		dir->remove(_loader_path(loader_files[i].name));
+	}
+	dir->remove(loader_dir);
+
+	return ok;
+}
+
+typedef bool (*TestFunc)();
+
+static int _run_tests(const char *const *p_names, const TestFunc *p_funcs) {
+
+	int failed = 0;
+	for (int i = 0; p_funcs[i]; i++) {
+		OS::get_singleton()->print("%s\n", p_names[i]);
+		bool pass = p_funcs[i]();
+		OS::get_singleton()->print("\t%s\n", pass ? "PASS" : "FAILED");
+		if (!pass) {
+			failed++;
+		}
+	}
+
+	OS::get_singleton()->set_exit_code(failed ? 1 : 0);
+	return failed;
+}
+
+MainLoop *test_profiler() {
+
+#ifdef DEBUG_ENABLED
+	static const char *names[] = {
+		"Sampled lines and exports",
+		NULL
+	};
+	static const TestFunc funcs[] = {
+		_test_profiler,
+		NULL
+	};
+	_run_tests(names, funcs);
+#else
+	print_line("The GDScript sampling profiler is only available in debug builds.");
+#endif
+
+	return NULL;
+}
+
+MainLoop *test_builtins() {
+
+	static const char *names[] = {
+		"Specialized built-ins match the generic call",
+		"Built-in calls from scripts",
+		NULL
+	};
+	static const TestFunc funcs[] = {
+		_test_validated_builtins,
+		_test_builtins_in_script,
+		NULL
+	};
+	_run_tests(names, funcs);
+
+	return NULL;
+}
+
+MainLoop *test_loader() {
+
+	static const char *names[] = {
+		"Diamond, cyclic and broken dependencies",
+		NULL
+	};
+	static const TestFunc funcs[] = {
+		_test_loader,
+		NULL
+	};
+	_run_tests(names, funcs);
+
+	return NULL;
+}
+} // namespace TestGDScriptRuntime
+
+#else
+
+namespace TestGDScriptRuntime {
+
+MainLoop *test_profiler() {
+
+	return NULL;
+}
+
+MainLoop *test_builtins() {
+
+	return NULL;
+}
+
+MainLoop *test_loader() {
+
+	return NULL;
+}
+} // namespace TestGDScriptRuntime
+
+#endif
@@ -36,16 +36,21 @@
 
 #include "test_astar.h"
 #include "test_basis.h"
+#include "test_gdnative.h"
 #include "test_gdscript.h"
+#include "test_gdscript_runtime.h"
 #include "test_gui.h"
 #include "test_math.h"
 #include "test_oa_hash_map.h"
 #include "test_ordered_hash_map.h"
 #include "test_physics.h"
 #include "test_physics_2d.h"
+#include "test_physics_server.h"
+#include "test_physics_suite.h"
 #include "test_render.h"
 #include "test_shader_lang.h"
 #include "test_string.h"
+#include "test_visual_script.h"
 
 const char **tests_get_names() {
 
@@ -54,7 +59,12 @@ const char **tests_get_names() {
 		"math",
 		"basis",
 		"physics",
+		"physics_benchmark",
 		"physics_2d",
+		"physics_2d_benchmark",
+		"physics_2d_determinism",
+		"physics_suite",
+		"physics_server",
 		"render",
 		"oa_hash_map",
 		"gui",
@@ -63,6 +73,12 @@ const char **tests_get_names() {
 		"gd_parser",
 		"gd_compiler",
 		"gd_bytecode",
+		"gd_profiler",
+		"gd_builtins",
+		"gd_loader",
+		"gdnative",
+		"visual_script",
+		"visual_script_benchmark",
 		"ordered_hash_map",
 		"astar",
 		NULL
@@ -93,11 +109,36 @@ MainLoop *test_main(String p_test, const List<String> &p_args) {
 		return TestPhysics::test();
 	}
 
+	if (p_test == "physics_benchmark") {
+
+		return TestPhysics::test_benchmark();
+	}
+
 	if (p_test == "physics_2d") {
 
 		return TestPhysics2D::test();
 	}
 
+	if (p_test == "physics_2d_benchmark") {
+
+		return TestPhysics2D::test_benchmark();
+	}
+
+	if (p_test == "physics_2d_determinism") {
+
+		return TestPhysics2D::test_determinism(p_args);
+	}
+
+	if (p_test == "physics_suite") {
+
+		return TestPhysicsSuite::test(p_args);
+	}
+
+	if (p_test == "physics_server") {
+
+		return TestPhysicsServer::test();
+	}
+
 	if (p_test == "render") {
 
 		return TestRender::test();
@@ -140,6 +181,36 @@ MainLoop *test_main(String p_test, const List<String> &p_args) {
 		return TestGDScript::test(TestGDScript::TEST_BYTECODE);
 	}
 
+	if (p_test == "gd_profiler") {
+
+		return TestGDScriptRuntime::test_profiler();
+	}
+
+	if (p_test == "gd_builtins") {
+
+		return TestGDScriptRuntime::test_builtins();
+	}
+
+	if (p_test == "gd_loader") {
+
+		return TestGDScriptRuntime::test_loader();
+	}
+
+	if (p_test == "gdnative") {
+
+		return TestGDNative::test();
+	}
+
+	if (p_test == "visual_script") {
+
+		return TestVisualScript::test();
+	}
+
+	if (p_test == "visual_script_benchmark") {
+
+		return TestVisualScript::test_benchmark();
+	}
+
 	if (p_test == "ordered_hash_map") {
 
 		return TestOrderedHashMap::test();
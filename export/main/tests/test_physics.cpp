@@ -36,6 +36,12 @@
 #include "core/os/main_loop.h"
 #include "core/os/os.h"
 #include "core/print_string.h"
+#include "core/project_settings.h"
+#include "scene/3d/physics_body.h"
+#include "scene/resources/mesh.h"
+#include "servers/physics/collision_solver_sat.h"
+#include "servers/physics/collision_solver_sw.h"
+#include "servers/physics/physics_server_sw.h"
 #include "servers/physics_server.h"
 #include "servers/visual_server.h"
 
@@ -429,10 +435,666 @@ public:
 	}
 };
 
+// Headless benchmark for the island solver: many independent piles of boxes
+// on a shared floor, stepped with an increasing amount of solver threads.
+// Also compares a height map terrain against the equivalent trimesh, with
+// rays, sphere casts and spheres resting on it, and the per body force
+// integration callback against the bulk state sync of RigidBody nodes. With
+// Bullet only the piles and the write-back run.
+class TestPhysicsBenchmarkMainLoop : public MainLoop {
+
+	GDCLASS(TestPhysicsBenchmarkMainLoop, MainLoop);
+
+	enum {
+		PILE_COUNT = 256,
+		PILE_HEIGHT = 5,
+		SETTLE_STEPS = 60,
+		MEASURED_STEPS = 300,
+		TERRAIN_SIZE = 512,
+		TERRAIN_RAYS = 100000,
+		TERRAIN_CASTS = 10000,
+		TERRAIN_BODIES = 256,
+		NARROWPHASE_PAIRS = 100000,
+		REPLAY_BODIES = 64,
+		REPLAY_STEPS = 120,
+		WRITE_BACK_BODIES = 10000,
+		CLOTH_SIZE = 64,
+		CLOTH_STEPS = 120,
+	};
+
+	static void _count_contact(const Vector3 &p_point_A, const Vector3 &p_point_B, void *p_userdata) {
+
+		(*(int *)p_userdata)++;
+	}
+
+	void run_narrowphase() {
+
+		BoxShapeSW box;
+		box.set_data(Vector3(0.5, 0.5, 0.5));
+
+		CapsuleShapeSW capsule;
+		Dictionary capsule_data;
+		capsule_data["radius"] = 0.4;
+		capsule_data["height"] = 1.0;
+		capsule.set_data(capsule_data);
+
+		// a 12 sided prism, closer to the hulls used in scenes than a cube
+		PoolVector<Vector3> points;
+		for (int i = 0; i < 12; i++) {
+			real_t angle = Math_PI * 2.0 * i / 12;
+			points.push_back(Vector3(Math::cos(angle) * 0.5, -0.5, Math::sin(angle) * 0.5));
+			points.push_back(Vector3(Math::cos(angle) * 0.5, 0.5, Math::sin(angle) * 0.5));
+		}
+
+		ConvexPolygonShapeSW convex;
+		convex.set_data(points);
+
+		const ShapeSW *shapes[3] = { &box, &capsule, &convex };
+		const char *names[3] = { "Box", "Capsule", "Convex" };
+
+		// the same random poses for every pair, most of them overlapping
+		Vector<Transform> xforms;
+		xforms.resize(NARROWPHASE_PAIRS * 2);
+		Math::seed(2);
+
+		for (int i = 0; i < NARROWPHASE_PAIRS * 2; i++) {
+
+			Basis basis(Vector3(Math::randf(), Math::randf(), Math::randf()) * Math_PI * 2.0);
+			Vector3 origin;
+			if (i % 2) {
+				origin = Vector3(Math::randf() - 0.5, Math::randf() - 0.5, Math::randf() - 0.5) * 1.6;
+			}
+			xforms.write[i] = Transform(basis, origin);
+		}
+
+		for (int a = 0; a < 3; a++) {
+			for (int b = a; b < 3; b++) {
+
+				String timings;
+
+				// packed axis tests first, then the scalar path they replace
+				for (int packed = 1; packed >= 0; packed--) {
+
+					sat_set_packed_axis_tests(packed);
+
+					int contacts = 0;
+					int collided = 0;
+
+					uint64_t begin = OS::get_singleton()->get_ticks_usec();
+
+					for (int i = 0; i < NARROWPHASE_PAIRS; i++) {
+						if (CollisionSolverSW::solve_static(shapes[a], xforms[i * 2], shapes[b], xforms[i * 2 + 1], _count_contact, &contacts)) {
+							collided++;
+						}
+					}
+
+					uint64_t usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+					timings += String(packed ? " packed " : ", scalar ") + rtos(usec * 1000.0 / NARROWPHASE_PAIRS) + " ns per pair";
+					if (!packed) {
+						timings += " (" + itos(collided) + " colliding, " + itos(contacts) + " contacts)";
+					}
+				}
+
+				print_line(String(names[a]) + "-" + names[b] + ":" + timings);
+			}
+		}
+
+		sat_set_packed_axis_tests(true);
+	}
+
+	void run_terrain(PhysicsServerSW *p_ps, bool p_heightmap) {
+
+		PoolVector<real_t> heights;
+		heights.resize(TERRAIN_SIZE * TERRAIN_SIZE);
+		{
+			PoolVector<real_t>::Write w = heights.write();
+			for (int i = 0; i < TERRAIN_SIZE; i++) {
+				for (int j = 0; j < TERRAIN_SIZE; j++) {
+					w[i * TERRAIN_SIZE + j] = Math::sin(j * 0.1) * Math::cos(i * 0.13) * 4.0;
+				}
+			}
+		}
+
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+
+		RID terrain_shape;
+		if (p_heightmap) {
+
+			Dictionary d;
+			d["width"] = TERRAIN_SIZE;
+			d["depth"] = TERRAIN_SIZE;
+			d["heights"] = heights;
+			d["min_height"] = -4.0;
+			d["max_height"] = 4.0;
+
+			terrain_shape = p_ps->shape_create(PhysicsServer::SHAPE_HEIGHTMAP);
+			p_ps->shape_set_data(terrain_shape, d);
+		} else {
+
+			// same vertices and diagonals as the height map, which is centered on the origin
+			PoolVector<Vector3> faces;
+			faces.resize((TERRAIN_SIZE - 1) * (TERRAIN_SIZE - 1) * 6);
+			PoolVector<Vector3>::Write w = faces.write();
+			PoolVector<real_t>::Read r = heights.read();
+			real_t half = (TERRAIN_SIZE - 1) * 0.5;
+			int idx = 0;
+
+			for (int i = 0; i < TERRAIN_SIZE - 1; i++) {
+				for (int j = 0; j < TERRAIN_SIZE - 1; j++) {
+
+					Vector3 p00(j - half, r[i * TERRAIN_SIZE + j], i - half);
+					Vector3 p10(j + 1 - half, r[i * TERRAIN_SIZE + j + 1], i - half);
+					Vector3 p01(j - half, r[(i + 1) * TERRAIN_SIZE + j], i + 1 - half);
+					Vector3 p11(j + 1 - half, r[(i + 1) * TERRAIN_SIZE + j + 1], i + 1 - half);
+
+					w[idx++] = p00;
+					w[idx++] = p10;
+					w[idx++] = p01;
+					w[idx++] = p10;
+					w[idx++] = p11;
+					w[idx++] = p01;
+				}
+			}
+
+			r.release();
+			w.release();
+
+			terrain_shape = p_ps->shape_create(PhysicsServer::SHAPE_CONCAVE_POLYGON);
+			p_ps->shape_set_data(terrain_shape, faces);
+		}
+
+		uint64_t build_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+		RID space = p_ps->space_create();
+		p_ps->space_set_active(space, true);
+		p_ps->area_set_param(space, PhysicsServer::AREA_PARAM_GRAVITY, 9.8);
+		p_ps->area_set_param(space, PhysicsServer::AREA_PARAM_GRAVITY_VECTOR, Vector3(0, -1, 0));
+
+		RID terrain = p_ps->body_create(PhysicsServer::BODY_MODE_STATIC);
+		p_ps->body_set_space(terrain, space);
+		p_ps->body_add_shape(terrain, terrain_shape);
+
+		real_t delta = 1.0 / 60.0;
+		p_ps->step(delta);
+		p_ps->flush_queries();
+
+		PhysicsDirectSpaceState *state = p_ps->space_get_direct_state(space);
+		real_t extent = (TERRAIN_SIZE - 1) * 0.5;
+		int hits = 0;
+		Math::seed(1);
+
+		begin = OS::get_singleton()->get_ticks_usec();
+
+		for (int i = 0; i < TERRAIN_RAYS; i++) {
+
+			Vector3 from((Math::randf() * 2.0 - 1.0) * extent, 10.0, (Math::randf() * 2.0 - 1.0) * extent);
+			Vector3 to = from + Vector3(Math::randf() * 16.0 - 8.0, -20.0, Math::randf() * 16.0 - 8.0);
+			PhysicsDirectSpaceState::RayResult result;
+			if (state->intersect_ray(from, to, result)) {
+				hits++;
+			}
+		}
+
+		uint64_t ray_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+		RID sphere_shape = p_ps->shape_create(PhysicsServer::SHAPE_SPHERE);
+		p_ps->shape_set_data(sphere_shape, 0.5);
+
+		int casts_hit = 0;
+		Math::seed(1);
+
+		begin = OS::get_singleton()->get_ticks_usec();
+
+		for (int i = 0; i < TERRAIN_CASTS; i++) {
+
+			Vector3 from((Math::randf() * 2.0 - 1.0) * extent, 6.0, (Math::randf() * 2.0 - 1.0) * extent);
+			Vector3 motion(Math::randf() * 16.0 - 8.0, -12.0, Math::randf() * 16.0 - 8.0);
+			float safe = 1.0;
+			float unsafe = 1.0;
+			if (state->cast_motion(sphere_shape, Transform(Basis(), from), motion, 0.0, safe, unsafe) && safe < 1.0) {
+				casts_hit++;
+			}
+		}
+
+		uint64_t cast_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+		List<RID> bodies;
+		int side = Math::ceil(Math::sqrt((float)TERRAIN_BODIES));
+
+		for (int i = 0; i < TERRAIN_BODIES; i++) {
+
+			RID body = p_ps->body_create(PhysicsServer::BODY_MODE_RIGID);
+			p_ps->body_set_space(body, space);
+			p_ps->body_add_shape(body, sphere_shape);
+			p_ps->body_set_state(body, PhysicsServer::BODY_STATE_CAN_SLEEP, false);
+			p_ps->body_set_state(body, PhysicsServer::BODY_STATE_TRANSFORM, Transform(Basis(), Vector3(((i % side) - side * 0.5) * 8.0, 6.0, ((i / side) - side * 0.5) * 8.0)));
+			bodies.push_back(body);
+		}
+
+		begin = OS::get_singleton()->get_ticks_usec();
+
+		for (int i = 0; i < MEASURED_STEPS; i++) {
+			p_ps->step(delta);
+			p_ps->flush_queries();
+		}
+
+		uint64_t step_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+		print_line(String(p_heightmap ? "Height map" : "Trimesh") + ": build " + rtos(build_usec / 1000.0) + " ms, " + itos(TERRAIN_RAYS) + " rays " + rtos(ray_usec / 1000.0) + " ms (" + itos(hits) + " hits), " + itos(TERRAIN_CASTS) + " sphere casts " + rtos(cast_usec / 1000.0) + " ms (" + itos(casts_hit) + " hits), " + itos(TERRAIN_BODIES) + " spheres " + rtos(step_usec / 1000.0 / MEASURED_STEPS) + " ms per step");
+
+		for (List<RID>::Element *E = bodies.front(); E; E = E->next()) {
+			p_ps->free(E->get());
+		}
+		p_ps->free(terrain);
+		p_ps->free(sphere_shape);
+		p_ps->free(terrain_shape);
+		p_ps->free(space);
+	}
+
+	void _record_replay(PhysicsServerSW *p_ps, const Vector<RID> &p_bodies, Vector<Transform> &r_xforms) {
+
+		real_t delta = 1.0 / 60.0;
+		r_xforms.resize(p_bodies.size() * REPLAY_STEPS);
+
+		for (int i = 0; i < REPLAY_STEPS; i++) {
+			p_ps->step(delta);
+			p_ps->flush_queries();
+
+			for (int j = 0; j < p_bodies.size(); j++) {
+				r_xforms.write[i * p_bodies.size() + j] = p_ps->body_get_state(p_bodies[j], PhysicsServer::BODY_STATE_TRANSFORM);
+			}
+		}
+	}
+
+	void run_replay(PhysicsServerSW *p_ps) {
+
+		RID space = p_ps->space_create();
+		p_ps->space_set_active(space, true);
+		p_ps->area_set_param(space, PhysicsServer::AREA_PARAM_GRAVITY, 9.8);
+		p_ps->area_set_param(space, PhysicsServer::AREA_PARAM_GRAVITY_VECTOR, Vector3(0, -1, 0));
+
+		RID plane_shape = p_ps->shape_create(PhysicsServer::SHAPE_PLANE);
+		p_ps->shape_set_data(plane_shape, Plane(Vector3(0, 1, 0), 0));
+		RID floor = p_ps->body_create(PhysicsServer::BODY_MODE_STATIC);
+		p_ps->body_set_space(floor, space);
+		p_ps->body_add_shape(floor, plane_shape);
+
+		RID box_shape = p_ps->shape_create(PhysicsServer::SHAPE_BOX);
+		p_ps->shape_set_data(box_shape, Vector3(0.5, 0.5, 0.5));
+
+		// a single tumbling heap, so contacts keep appearing and disappearing during the replay
+		Vector<RID> bodies;
+		Math::seed(3);
+
+		for (int i = 0; i < REPLAY_BODIES; i++) {
+
+			RID body = p_ps->body_create(PhysicsServer::BODY_MODE_RIGID);
+			p_ps->body_set_space(body, space);
+			p_ps->body_add_shape(body, box_shape);
+			Basis basis(Vector3(Math::randf(), Math::randf(), Math::randf()) * Math_PI * 2.0);
+			p_ps->body_set_state(body, PhysicsServer::BODY_STATE_TRANSFORM, Transform(basis, Vector3(Math::randf() * 3.0, 1.0 + i * 0.6, Math::randf() * 3.0)));
+			bodies.push_back(body);
+		}
+
+		real_t delta = 1.0 / 60.0;
+
+		for (int i = 0; i < SETTLE_STEPS; i++) {
+			p_ps->step(delta);
+			p_ps->flush_queries();
+		}
+
+		PoolVector<uint8_t> snapshot = p_ps->space_get_snapshot(space);
+
+		Vector<Transform> first;
+		_record_replay(p_ps, bodies, first);
+
+		Error err = p_ps->space_restore_snapshot(space, snapshot);
+
+		Vector<Transform> second;
+		_record_replay(p_ps, bodies, second);
+
+		// bitwise, not approximate: a rollback has to land on exactly the same state
+		bool identical = err == OK && memcmp(first.ptr(), second.ptr(), first.size() * sizeof(Transform)) == 0;
+
+		print_line("Replay: " + itos(REPLAY_BODIES) + " bodies, " + itos(REPLAY_STEPS) + " steps, snapshot " + itos(snapshot.size()) + " bytes, " + (identical ? "identical" : "DIVERGED"));
+
+		if (!identical) {
+			OS::get_singleton()->set_exit_code(1);
+		}
+
+		for (int i = 0; i < bodies.size(); i++) {
+			p_ps->free(bodies[i]);
+		}
+		p_ps->free(floor);
+		p_ps->free(box_shape);
+		p_ps->free(plane_shape);
+		p_ps->free(space);
+	}
+
+	uint64_t _run_write_back(PhysicsServer *p_ps, bool p_per_body_callback) {
+
+		RID space = p_ps->space_create();
+		p_ps->space_set_active(space, true);
+		p_ps->area_set_param(space, PhysicsServer::AREA_PARAM_GRAVITY, 9.8);
+		p_ps->area_set_param(space, PhysicsServer::AREA_PARAM_GRAVITY_VECTOR, Vector3(0, -1, 0));
+
+		RID sphere_shape = p_ps->shape_create(PhysicsServer::SHAPE_SPHERE);
+		p_ps->shape_set_data(sphere_shape, 0.5);
+
+		// free falling and far apart, so nearly all the time goes to handing the states back to the nodes
+		Vector<RigidBody *> nodes;
+		int side = Math::ceil(Math::sqrt((float)WRITE_BACK_BODIES));
+
+		for (int i = 0; i < WRITE_BACK_BODIES; i++) {
+
+			RigidBody *node = memnew(RigidBody);
+			RID body = node->get_rid();
+			p_ps->body_set_space(body, space);
+			p_ps->body_add_shape(body, sphere_shape);
+			p_ps->body_set_state(body, PhysicsServer::BODY_STATE_CAN_SLEEP, false);
+			p_ps->body_set_state(body, PhysicsServer::BODY_STATE_TRANSFORM, Transform(Basis(), Vector3((i % side) * 2.0, 0, (i / side) * 2.0)));
+			if (p_per_body_callback) {
+				// what every RigidBody used to register, it takes precedence over the bulk sync
+				p_ps->body_set_force_integration_callback(body, node, "_direct_state_changed");
+			}
+			nodes.push_back(node);
+		}
+
+		real_t delta = 1.0 / 60.0;
+		p_ps->step(delta);
+		p_ps->flush_queries();
+
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+
+		for (int i = 0; i < MEASURED_STEPS; i++) {
+			p_ps->step(delta);
+			p_ps->flush_queries();
+		}
+
+		uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - begin;
+
+		for (int i = 0; i < nodes.size(); i++) {
+			memdelete(nodes[i]);
+		}
+		p_ps->free(sphere_shape);
+		p_ps->free(space);
+
+		return elapsed;
+	}
+
+	void run_write_back(PhysicsServer *p_ps) {
+
+		uint64_t callback_usec = _run_write_back(p_ps, true);
+		uint64_t sync_usec = _run_write_back(p_ps, false);
+
+		print_line("Write-back: " + itos(WRITE_BACK_BODIES) + " rigid bodies, per body callback " + rtos(callback_usec / 1000.0 / MEASURED_STEPS) + " ms per step, bulk sync " + rtos(sync_usec / 1000.0 / MEASURED_STEPS) + " ms per step");
+	}
+
+	static void _set_thread_count(PhysicsServer *p_ps, int p_threads) {
+
+		PhysicsServerSW *ps_sw = Object::cast_to<PhysicsServerSW>(p_ps);
+		if (ps_sw) {
+			ps_sw->set_solver_thread_count(p_threads);
+		} else {
+			// Bullet lives in a module, which may not be built
+			p_ps->call("set_thread_count", p_threads);
+		}
+	}
+
+	uint64_t run(PhysicsServer *p_ps, int p_threads) {
+
+		_set_thread_count(p_ps, p_threads);
+
+		RID space = p_ps->space_create();
+		p_ps->space_set_active(space, true);
+		p_ps->area_set_param(space, PhysicsServer::AREA_PARAM_GRAVITY, 9.8);
+		p_ps->area_set_param(space, PhysicsServer::AREA_PARAM_GRAVITY_VECTOR, Vector3(0, -1, 0));
+
+		RID plane_shape = p_ps->shape_create(PhysicsServer::SHAPE_PLANE);
+		p_ps->shape_set_data(plane_shape, Plane(Vector3(0, 1, 0), 0));
+		RID floor = p_ps->body_create(PhysicsServer::BODY_MODE_STATIC);
+		p_ps->body_set_space(floor, space);
+		p_ps->body_add_shape(floor, plane_shape);
+
+		RID box_shape = p_ps->shape_create(PhysicsServer::SHAPE_BOX);
+		p_ps->shape_set_data(box_shape, Vector3(0.5, 0.5, 0.5));
+
+		List<RID> boxes;
+		int side = Math::ceil(Math::sqrt((float)PILE_COUNT));
+
+		for (int i = 0; i < PILE_COUNT; i++) {
+			for (int j = 0; j < PILE_HEIGHT; j++) {
+
+				RID body = p_ps->body_create(PhysicsServer::BODY_MODE_RIGID);
+				p_ps->body_set_space(body, space);
+				p_ps->body_add_shape(body, box_shape);
+				p_ps->body_set_state(body, PhysicsServer::BODY_STATE_CAN_SLEEP, false); // keep every island busy
+				p_ps->body_set_state(body, PhysicsServer::BODY_STATE_TRANSFORM, Transform(Basis(), Vector3((i % side) * 3.0, 0.5 + j * 1.05, (i / side) * 3.0)));
+				boxes.push_back(body);
+			}
+		}
+
+		real_t delta = 1.0 / 60.0;
+
+		for (int i = 0; i < SETTLE_STEPS; i++) {
+			p_ps->step(delta);
+			p_ps->flush_queries();
+		}
+
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+
+		for (int i = 0; i < MEASURED_STEPS; i++) {
+			p_ps->step(delta);
+			p_ps->flush_queries();
+		}
+
+		uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - begin;
+
+		for (List<RID>::Element *E = boxes.front(); E; E = E->next()) {
+			p_ps->free(E->get());
+		}
+		p_ps->free(floor);
+		p_ps->free(box_shape);
+		p_ps->free(plane_shape);
+		p_ps->free(space);
+
+		return elapsed;
+	}
+
+	// a square of cloth dropped on a sphere
+	uint64_t _run_cloth(PhysicsServerSW *p_ps, const Ref<Mesh> &p_mesh, int p_threads, Vector<Vector3> &r_points) {
+
+		p_ps->set_solver_thread_count(p_threads);
+
+		RID space = p_ps->space_create();
+		p_ps->space_set_active(space, true);
+		p_ps->area_set_param(space, PhysicsServer::AREA_PARAM_GRAVITY, 9.8);
+		p_ps->area_set_param(space, PhysicsServer::AREA_PARAM_GRAVITY_VECTOR, Vector3(0, -1, 0));
+
+		RID sphere_shape = p_ps->shape_create(PhysicsServer::SHAPE_SPHERE);
+		p_ps->shape_set_data(sphere_shape, 1.0);
+		RID sphere = p_ps->body_create(PhysicsServer::BODY_MODE_STATIC);
+		p_ps->body_set_space(sphere, space);
+		p_ps->body_add_shape(sphere, sphere_shape);
+
+		RID cloth = p_ps->soft_body_create();
+		p_ps->soft_body_set_space(cloth, space);
+		p_ps->soft_body_set_mesh(cloth, p_mesh);
+		p_ps->soft_body_set_transform(cloth, Transform(Basis(), Vector3(0, 1.5, 0)));
+
+		real_t delta = 1.0 / 60.0;
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+
+		for (int i = 0; i < CLOTH_STEPS; i++) {
+			p_ps->step(delta);
+			p_ps->flush_queries();
+		}
+
+		uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - begin;
+
+		r_points.resize(CLOTH_SIZE * CLOTH_SIZE);
+		for (int i = 0; i < r_points.size(); i++) {
+			r_points.write[i] = p_ps->soft_body_get_point_global_position(cloth, i);
+		}
+
+		p_ps->free(cloth);
+		p_ps->free(sphere);
+		p_ps->free(sphere_shape);
+		p_ps->free(space);
+
+		return elapsed;
+	}
+
+	void run_cloth(PhysicsServerSW *p_ps) {
+
+		PoolVector<Vector3> vertices;
+		PoolVector<int> indices;
+
+		for (int i = 0; i < CLOTH_SIZE; i++) {
+			for (int j = 0; j < CLOTH_SIZE; j++) {
+				vertices.push_back(Vector3(j * 4.0 / (CLOTH_SIZE - 1) - 2.0, 0, i * 4.0 / (CLOTH_SIZE - 1) - 2.0));
+			}
+		}
+
+		for (int i = 0; i < CLOTH_SIZE - 1; i++) {
+			for (int j = 0; j < CLOTH_SIZE - 1; j++) {
+				int v = i * CLOTH_SIZE + j;
+				indices.push_back(v);
+				indices.push_back(v + 1);
+				indices.push_back(v + CLOTH_SIZE);
+				indices.push_back(v + 1);
+				indices.push_back(v + CLOTH_SIZE + 1);
+				indices.push_back(v + CLOTH_SIZE);
+			}
+		}
+
+		Array arrays;
+		arrays.resize(VS::ARRAY_MAX);
+		arrays[VS::ARRAY_VERTEX] = vertices;
+		arrays[VS::ARRAY_INDEX] = indices;
+
+		Ref<ArrayMesh> mesh;
+		mesh.instance();
+		mesh->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, arrays);
+
+		int max_threads = OS::get_singleton()->get_processor_count();
+		uint64_t single_thread_usec = 0;
+		Vector<Vector3> single_thread_points;
+
+		for (int threads = 1; threads <= max_threads; threads = threads < max_threads ? MIN(threads * 2, max_threads) : threads + 1) {
+
+			Vector<Vector3> points;
+			uint64_t usec = _run_cloth(p_ps, mesh, threads, points);
+			if (threads == 1) {
+				single_thread_usec = usec;
+				single_thread_points = points;
+			}
+
+			// the links are solved in color order, so the thread count must not change the result
+			bool identical = points.size() == single_thread_points.size() && memcmp(points.ptr(), single_thread_points.ptr(), points.size() * sizeof(Vector3)) == 0;
+
+			print_line("Cloth threads: " + itos(threads) + ", " + rtos(usec / 1000.0 / CLOTH_STEPS) + " ms per step, speedup " + rtos((double)single_thread_usec / MAX(usec, (uint64_t)1)) + "x, " + (identical ? "identical" : "DIVERGED"));
+
+			if (!identical) {
+				OS::get_singleton()->set_exit_code(1);
+			}
+		}
+	}
+
+	void run_scaling(PhysicsServer *p_ps) {
+
+		int max_threads = OS::get_singleton()->get_processor_count();
+
+		print_line("Islands: " + itos(PILE_COUNT) + ", bodies per island: " + itos(PILE_HEIGHT) + ", steps: " + itos(MEASURED_STEPS) + ", cores: " + itos(max_threads));
+
+		uint64_t single_thread_usec = 0;
+
+		for (int threads = 1; threads <= max_threads; threads = threads < max_threads ? MIN(threads * 2, max_threads) : threads + 1) {
+
+			uint64_t usec = run(p_ps, threads);
+			if (threads == 1) {
+				single_thread_usec = usec;
+			}
+
+			print_line("Threads: " + itos(threads) + ", " + rtos(usec / 1000.0 / MEASURED_STEPS) + " ms per step, speedup " + rtos((double)single_thread_usec / MAX(usec, (uint64_t)1)) + "x");
+		}
+	}
+
+	// Only the island scaling applies to Bullet, the rest measures GodotPhysics internals.
+	void run_bullet(PhysicsServer *p_ps) {
+
+		// the world with soft body support is always stepped on one thread
+		Variant soft_world = ProjectSettings::get_singleton()->get("physics/3d/active_soft_world");
+		ProjectSettings::get_singleton()->set("physics/3d/active_soft_world", false);
+		int initial_threads = p_ps->call("get_thread_count");
+		p_ps->set_active(true);
+
+		print_line("Bullet, threads above 1 use the multithreaded world.");
+		run_scaling(p_ps);
+		run_write_back(p_ps);
+
+		_set_thread_count(p_ps, initial_threads);
+		ProjectSettings::get_singleton()->set("physics/3d/active_soft_world", soft_world);
+	}
+
+public:
+	virtual void init() {
+
+		PhysicsServer *server = PhysicsServer::get_singleton();
+		if (server->is_class("BulletPhysicsServer")) {
+			run_bullet(server);
+			return;
+		}
+
+		PhysicsServerSW *ps = Object::cast_to<PhysicsServerSW>(server);
+		if (!ps) {
+			print_line("The physics benchmark needs \"GodotPhysics\" or \"Bullet\" as the 3D physics engine, with the \"Single-Unsafe\" thread model.");
+			return;
+		}
+
+		int initial_threads = ps->get_solver_thread_count();
+		ps->set_active(true);
+
+		run_scaling(ps);
+
+		print_line("Terrain: " + itos(TERRAIN_SIZE) + "x" + itos(TERRAIN_SIZE) + " vertices");
+		run_terrain(ps, true);
+		run_terrain(ps, false);
+
+		print_line("Narrow phase: " + itos(NARROWPHASE_PAIRS) + " pairs per shape combination");
+		run_narrowphase();
+
+		print_line("Cloth: " + itos(CLOTH_SIZE * CLOTH_SIZE) + " particles, " + itos(CLOTH_STEPS) + " steps");
+		run_cloth(ps);
+
+		ps->set_solver_thread_count(initial_threads);
+
+		run_replay(ps);
+		run_write_back(ps);
+	}
+
+	virtual bool iteration(float p_time) {
+		return true;
+	}
+
+	virtual bool idle(float p_time) {
+		return true;
+	}
+
+	virtual void finish() {
+	}
+};
+
 namespace TestPhysics {
 
 MainLoop *test() {
 
 	return memnew(TestPhysicsMainLoop);
 }
+
+MainLoop *test_benchmark() {
+
+	return memnew(TestPhysicsBenchmarkMainLoop);
+}
 } // namespace TestPhysics
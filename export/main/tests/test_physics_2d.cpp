@@ -30,11 +30,16 @@
 
 #include "test_physics_2d.h"
 
+#include "core/hashfuncs.h"
 #include "core/map.h"
 #include "core/os/main_loop.h"
 #include "core/os/os.h"
 #include "core/print_string.h"
 #include "scene/resources/texture.h"
+#include "servers/physics_2d/body_2d_sw.h"
+#include "servers/physics_2d/broad_phase_2d_bvh.h"
+#include "servers/physics_2d/broad_phase_2d_hash_grid.h"
+#include "servers/physics_2d/physics_2d_server_sw.h"
 #include "servers/physics_2d_server.h"
 #include "servers/visual_server.h"
 
@@ -42,6 +47,123 @@ static const unsigned char convex_png[] = {
 	0x89, 0x50, 0x4e, 0x47, 0xd, 0xa, 0x1a, 0xa, 0x0, 0x0, 0x0, 0xd, 0x49, 0x48, 0x44, 0x52, 0x0, 0x0, 0x0, 0x40, 0x0, 0x0, 0x0, 0x40, 0x8, 0x6, 0x0, 0x0, 0x0, 0xaa, 0x69, 0x71, 0xde, 0x0, 0x0, 0x0, 0x1, 0x73, 0x52, 0x47, 0x42, 0x0, 0xae, 0xce, 0x1c, 0xe9, 0x0, 0x0, 0x0, 0x6, 0x62, 0x4b, 0x47, 0x44, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0xf9, 0x43, 0xbb, 0x7f, 0x0, 0x0, 0x0, 0x9, 0x70, 0x48, 0x59, 0x73, 0x0, 0x0, 0xb, 0x13, 0x0, 0x0, 0xb, 0x13, 0x1, 0x0, 0x9a, 0x9c, 0x18, 0x0, 0x0, 0x0, 0x7, 0x74, 0x49, 0x4d, 0x45, 0x7, 0xdb, 0x6, 0xa, 0x3, 0x13, 0x31, 0x66, 0xa7, 0xac, 0x79, 0x0, 0x0, 0x4, 0xef, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0xed, 0x9b, 0xdd, 0x4e, 0x2a, 0x57, 0x14, 0xc7, 0xf7, 0x1e, 0xc0, 0x19, 0x38, 0x32, 0x80, 0xa, 0x6a, 0xda, 0x18, 0xa3, 0xc6, 0x47, 0x50, 0x7b, 0xa1, 0xd9, 0x36, 0x27, 0x7e, 0x44, 0xed, 0x45, 0x4d, 0x93, 0x3e, 0x40, 0x1f, 0x64, 0x90, 0xf4, 0x1, 0xbc, 0xf0, 0xc2, 0x9c, 0x57, 0x30, 0x4d, 0xbc, 0xa8, 0x6d, 0xc, 0x69, 0x26, 0xb5, 0x68, 0x8b, 0x35, 0x7e, 0x20, 0xb4, 0xf5, 0x14, 0xbf, 0x51, 0x3c, 0x52, 0xe, 0xc, 0xe, 0xc8, 0xf0, 0xb1, 0x7a, 0x51, 0x3d, 0xb1, 0x9e, 0x19, 0x1c, 0x54, 0x70, 0x1c, 0xdc, 0x9, 0x17, 0x64, 0x8, 0xc9, 0xff, 0xb7, 0xd6, 0x7f, 0xcd, 0x3f, 0x2b, 0xd9, 0x8, 0xbd, 0x9c, 0xda, 0x3e, 0xf8, 0x31, 0xff, 0xc, 0x0, 0x8, 0x42, 0x88, 0x9c, 0x9f, 0x9f, 0xbf, 0xa, 0x87, 0xc3, 0xad, 0x7d, 0x7d, 0x7d, 0x7f, 0x23, 0x84, 0x78, 0x8c, 0x31, 0xaf, 0x55, 0x0, 0xc6, 0xc7, 0x14, 0x1e, 0x8f, 0xc7, 0xbf, 0x38, 0x3c, 0x3c, 0x6c, 0x9b, 0x9f, 0x9f, 0x6f, 0xb8, 0x82, 0x9b, 0xee, 0xe8, 0xe8, 0xf8, 0x12, 0x0, 0xbe, 0xd3, 0x2a, 0x8, 0xfc, 0x50, 0xd1, 0xf9, 0x7c, 0x9e, 0x8a, 0x46, 0xa3, 0x5f, 0x9d, 0x9e, 0x9e, 0x7e, 0xb2, 0xb0, 0xb0, 0x60, 0xe5, 0x79, 0x1e, 0xf1, 0xfc, 0x7f, 0x3a, 0x9, 0x21, 0x88, 0x10, 0x82, 0x26, 0x26, 0x26, 0xde, 0x77, 0x75, 0x75, 0x85, 0x59, 0x96, 0xfd, 0x5e, 0x6b, 0x20, 0xf0, 0x7d, 0x85, 0x4b, 0x92, 0xf4, 0xfa, 0xe0, 0xe0, 0xe0, 0xd3, 0xb9, 0xb9, 0xb9, 0x46, 0x49, 0x92, 0xea, 0x6f, 0xa, 0xbf, 0x7d, 0x8, 0x21, 0x68, 0x70, 0x70, 0xb0, 0x38, 0x39, 0x39, 0x79, 0xd6, 0xd9, 0xd9, 0xb9, 0xcf, 0x30, 0xcc, 0xa2, 0xd6, 0xad, 0x21, 0x2b, 0x1c, 0x0, 0x38, 0x41, 0x10, 0xfc, 0xdb, 0xdb, 0xdb, 0x27, 0x1e, 0x8f, 0x27, 0x4b, 0x8, 0x1, 0x84, 0x90, 0xea, 0xf, 0x21, 0x4, 0x3c, 0x1e, 0x4f, 0x76, 0x67, 0x67, 0x67, 0x3f, 0x9f, 0xcf, 0xff, 0x7c, 0x5, 0xf3, 0xd9, 0x0, 0xe0, 0x2, 0x81, 0xc0, 0xa9, 0xdb, 0xed, 0x2e, 0x94, 0x2b, 0x5c, 0xe, 0xc4, 0xca, 0xca, 0x8a, 0x18, 0x8d, 0x46, 0x3, 0x0, 0xc0, 0x69, 0x1e, 0x4, 0x0, 0x90, 0x48, 0x24, 0x12, 0xe4, 0x38, 0xee, 0x41, 0xc2, 0x6f, 0x43, 0xe0, 0x38, 0xe, 0xfc, 0x7e, 0xbf, 0x10, 0x8b, 0xc5, 0xd6, 0x35, 0xd, 0x22, 0x9b, 0xcd, 0x7a, 0x96, 0x97, 0x97, 0x33, 0xf, 0xad, 0x7c, 0x29, 0x10, 0x9b, 0x9b, 0x9b, 0xef, 0x2e, 0x2e, 0x2e, 0x7e, 0xd5, 0x1c, 0x8, 0x0, 0x20, 0xe1, 0x70, 0x38, 0xfc, 0x98, 0xd5, 0x57, 0x2, 0xe1, 0x76, 0xbb, 0xf3, 0xa1, 0x50, 0xe8, 0x38, 0x9b, 0xcd, 0xfe, 0xa2, 0x9, 0x8, 0x0, 0x40, 0x2e, 0x2f, 0x2f, 0x7d, 0x4b, 0x4b, 0x4b, 0xb9, 0x4a, 0x54, 0x5f, 0x9, 0xc4, 0xd2, 0xd2, 0x92, 0xb4, 0xb7, 0xb7, 0xf7, 0x36, 0x97, 0xcb, 0x4d, 0x3d, 0x29, 0x8, 0x0, 0xe0, 0x42, 0xa1, 0xd0, 0x71, 0xb5, 0xc4, 0xdf, 0xb6, 0xc5, 0x93, 0xe, 0x4a, 0x0, 0x20, 0xa9, 0x54, 0xea, 0x37, 0xb7, 0xdb, 0x5d, 0xa8, 0xa6, 0x78, 0x39, 0x10, 0x6b, 0x6b, 0x6b, 0xf1, 0x64, 0x32, 0xb9, 0x5a, 0x55, 0x10, 0x0, 0xc0, 0x6d, 0x6c, 0x6c, 0x9c, 0x57, 0xbb, 0xfa, 0x25, 0x40, 0x14, 0x3, 0x81, 0x40, 0x34, 0x93, 0xc9, 0x2c, 0x57, 0x1c, 0x4, 0x0, 0x90, 0x58, 0x2c, 0xb6, 0x5e, 0xe9, 0xc1, 0x77, 0x1f, 0x10, 0x53, 0x53, 0x53, 0x52, 0xc5, 0x83, 0x14, 0x0, 0x70, 0x7e, 0xbf, 0x5f, 0xd0, 0x42, 0xf5, 0x95, 0x40, 0xf8, 0x7c, 0xbe, 0xcb, 0xa3, 0xa3, 0xa3, 0x3f, 0x1e, 0xbd, 0x1b, 0x0, 0x80, 0x1c, 0x1f, 0x1f, 0x87, 0xb4, 0x56, 0xfd, 0xaa, 0x5, 0x29, 0x51, 0x14, 0xbf, 0xf5, 0xf9, 0x7c, 0x97, 0x5a, 0xad, 0xbe, 0x12, 0x88, 0xf5, 0xf5, 0xf5, 0xd8, 0x83, 0x83, 0x54, 0xb5, 0x42, 0x8f, 0x66, 0x83, 0x94, 0xd6, 0xbd, 0x5f, 0xce, 0x7c, 0x38, 0x3c, 0x3c, 0xfc, 0xb3, 0x50, 0x28, 0xb8, 0xcb, 0x2, 0x1, 0x0, 0xdc, 0xf4, 0xf4, 0xf4, 0xfe, 0x73, 0x15, 0x2f, 0x17, 0xa4, 0x22, 0x91, 0x48, 0x50, 0xb5, 0x2d, 0x0, 0x80, 0x9b, 0x99, 0x99, 0x79, 0xfb, 0xdc, 0x1, 0xc8, 0x5, 0xa9, 0x44, 0x22, 0xf1, 0xfb, 0x9d, 0x10, 0x0, 0x80, 0x9b, 0x9d, 0x9d, 0xd, 0xea, 0x5, 0xc0, 0xad, 0xfd, 0x43, 0x1a, 0x0, 0xb8, 0xdb, 0x9a, 0xa9, 0x8f, 0xb6, 0xa4, 0x46, 0xa3, 0xa4, 0xb7, 0xd5, 0x37, 0xcf, 0xf3, 0x68, 0x75, 0x75, 0xf5, 0x4c, 0xee, 0x99, 0x1c, 0x80, 0x9c, 0x1e, 0xf7, 0xff, 0x16, 0x8b, 0x45, 0x50, 0x5, 0xa0, 0xb7, 0xb7, 0xb7, 0x85, 0x10, 0xa2, 0x2b, 0xf1, 0x84, 0x10, 0xd4, 0xdf, 0xdf, 0x6f, 0x57, 0x3, 0x80, 0x37, 0x18, 0xc, 0x5, 0x3d, 0x2, 0xa0, 0x69, 0x3a, 0x8b, 0x10, 0xe2, 0x4b, 0x2, 0xc0, 0x18, 0xf3, 0xc1, 0x60, 0x70, 0x47, 0x8f, 0x16, 0x38, 0x3a, 0x3a, 0x5a, 0x93, 0x5b, 0xc3, 0x7f, 0x64, 0x81, 0xba, 0xba, 0x3a, 0x49, 0x8f, 0x0, 0x1a, 0x1a, 0x1a, 0xd4, 0xcd, 0x0, 0x93, 0xc9, 0xa4, 0xcb, 0x21, 0xe8, 0x74, 0x3a, 0xd5, 0x1, 0xa0, 0x69, 0x5a, 0x77, 0x1d, 0x80, 0x31, 0x2e, 0x38, 0x9d, 0x4e, 0xb1, 0x66, 0x1, 0x30, 0xc, 0x23, 0x28, 0x3d, 0x93, 0x9b, 0x1, 0xb9, 0x9a, 0x6, 0x60, 0x36, 0x9b, 0x75, 0xd7, 0x1, 0x4a, 0x21, 0xa8, 0x26, 0x0, 0x94, 0xa, 0x41, 0xb2, 0x0, 0x18, 0x86, 0xc9, 0xe9, 0xd, 0x80, 0x52, 0x8, 0x92, 0x5, 0x60, 0xb1, 0x58, 0x74, 0x67, 0x1, 0xa5, 0x10, 0xa4, 0x4, 0x40, 0x77, 0x43, 0xd0, 0xe1, 0x70, 0xa8, 0x9f, 0x1, 0x14, 0x45, 0x1, 0x45, 0x51, 0x79, 0x3d, 0x1, 0x68, 0x6e, 0x6e, 0x4e, 0xaa, 0x6, 0x80, 0x10, 0x42, 0x6, 0x83, 0x41, 0x37, 0x36, 0x28, 0x15, 0x82, 0x6a, 0x2, 0x0, 0x4d, 0xd3, 0xa9, 0x52, 0xcf, 0x95, 0x0, 0xe8, 0x66, 0xe, 0x98, 0xcd, 0x66, 0xa1, 0x6c, 0x0, 0x7a, 0x5a, 0x8b, 0x59, 0x2c, 0x96, 0x64, 0xcd, 0x2, 0xb8, 0x2b, 0x4, 0xe9, 0xde, 0x2, 0x77, 0x85, 0xa0, 0x9a, 0xb0, 0x40, 0xa9, 0x10, 0xa4, 0x8, 0xc0, 0x64, 0x32, 0xe9, 0x6, 0x40, 0xa9, 0x10, 0x54, 0xaa, 0x3, 0x74, 0xf3, 0x16, 0x70, 0xb9, 0x5c, 0xe5, 0x3, 0xe8, 0xe9, 0xe9, 0x69, 0xd5, 0xc3, 0x66, 0x18, 0x63, 0x5c, 0x68, 0x6a, 0x6a, 0x12, 0xcb, 0x5, 0xa0, 0x9b, 0xd5, 0x38, 0x4d, 0xd3, 0x29, 0x8a, 0xa2, 0xa0, 0x2c, 0x0, 0x18, 0x63, 0x3e, 0x14, 0xa, 0xfd, 0x55, 0xb, 0x21, 0x48, 0xd1, 0x2, 0x7a, 0x59, 0x8d, 0xdf, 0x1b, 0x80, 0x1e, 0x56, 0xe3, 0x84, 0x10, 0x34, 0x30, 0x30, 0x60, 0xbb, 0xeb, 0x77, 0x46, 0x5, 0xef, 0x48, 0xcf, 0x4d, 0xec, 0x8d, 0x99, 0x5, 0xf5, 0xf5, 0xf5, 0xef, 0x46, 0x47, 0x47, 0xb, 0x2e, 0x97, 0xeb, 0xbc, 0x54, 0x8, 0x52, 0x4, 0xc0, 0x30, 0x8c, 0xf4, 0x5c, 0x4, 0x9b, 0x4c, 0xa6, 0xf4, 0xf8, 0xf8, 0xb8, 0xc8, 0xb2, 0x6c, 0x32, 0x9d, 0x4e, 0xff, 0xd4, 0xdd, 0xdd, 0x7d, 0x66, 0x34, 0x1a, 0x8b, 0xd7, 0x3, 0xfd, 0xae, 0x5b, 0x29, 0xb2, 0x57, 0x66, 0xb6, 0xb6, 0xb6, 0xde, 0xc4, 0xe3, 0xf1, 0x6f, 0xae, 0xaf, 0xc1, 0x28, 0x5d, 0x85, 0x79, 0x2, 0xc1, 0x60, 0xb5, 0x5a, 0xa3, 0xa3, 0xa3, 0xa3, 0x45, 0xab, 0xd5, 0x9a, 0x2a, 0x16, 0x8b, 0x8b, 0x6d, 0x6d, 0x6d, 0xef, 0xd5, 0x8a, 0x55, 0xd, 0x20, 0x91, 0x48, 0xbc, 0x3e, 0x38, 0x38, 0xf8, 0xda, 0x6e, 0xb7, 0xf7, 0x5f, 0x5c, 0x5c, 0xd4, 0x7b, 0xbd, 0xde, 0xbc, 0x20, 0x8, 0xcd, 0x85, 0x42, 0x81, 0xfe, 0xf0, 0xae, 0xac, 0x10, 0x98, 0x9b, 0xd5, 0xc5, 0x18, 0x17, 0x59, 0x96, 0x3d, 0x1d, 0x19, 0x19, 0x1, 0x96, 0x65, 0x5, 0x8a, 0xa2, 0x7e, 0x6c, 0x69, 0x69, 0x49, 0x3d, 0x44, 0xb0, 0x2a, 0x0, 0x1f, 0xcc, 0x74, 0x75, 0x41, 0xea, 0xfa, 0x7b, 0x32, 0x99, 0x64, 0x76, 0x77, 0x77, 0x5d, 0xe, 0x87, 0xa3, 0x5f, 0x14, 0xc5, 0x57, 0x57, 0x60, 0x5a, 0x8b, 0xc5, 0xa2, 0xf1, 0xbe, 0x50, 0x6e, 0xa, 0x66, 0x18, 0x26, 0x31, 0x36, 0x36, 0x96, 0x65, 0x59, 0x36, 0x29, 0x49, 0x92, 0xb7, 0xbd, 0xbd, 0xfd, 0x9f, 0x72, 0xda, 0xf9, 0xd1, 0x1, 0xa8, 0x1, 0x93, 0xcf, 0xe7, 0xa9, 0x93, 0x93, 0x13, 0x1b, 0x4d, 0xd3, 0x9f, 0xb, 0x82, 0x60, 0xf5, 0x7a, 0xbd, 0xd9, 0x54, 0x2a, 0xe5, 0xcc, 0x64, 0x32, 0xe, 0xb9, 0x6e, 0xb9, 0x16, 0x8c, 0x31, 0x2e, 0xda, 0x6c, 0xb6, 0xc8, 0xd0, 0xd0, 0x10, 0x65, 0xb3, 0xd9, 0x92, 0x95, 0xa8, 0x6e, 0xc5, 0x0, 0xa8, 0xe9, 0x96, 0x68, 0x34, 0x6a, 0xdd, 0xdf, 0xdf, 0x6f, 0x76, 0xb9, 0x5c, 0x9f, 0x89, 0xa2, 0x58, 0xbf, 0xb8, 0xb8, 0x8, 0x26, 0x93, 0x29, 0x3b, 0x3c, 0x3c, 0x8c, 0xed, 0x76, 0x7b, 0xd2, 0x68, 0x34, 0xfe, 0xd0, 0xd8, 0xd8, 0x98, 0xae, 0xb6, 0xe0, 0x8a, 0x1, 0x50, 0xb, 0xe6, 0xa9, 0x5, 0xbf, 0x9c, 0x97, 0xf3, 0xff, 0xf3, 0x2f, 0x6a, 0x82, 0x7f, 0xf6, 0x4e, 0xca, 0x1b, 0xf5, 0x0, 0x0, 0x0, 0x0, 0x49, 0x45, 0x4e, 0x44, 0xae, 0x42, 0x60, 0x82
 };
 
+class TestBroadPhase2D {
+
+	enum {
+		MOVING_OBJECTS = 4096,
+		STATIC_OBJECTS = 64,
+		MEASURED_STEPS = 100,
+		QUERIES = 10000,
+		QUERY_RESULTS = 256,
+	};
+
+	enum Scene {
+		SCENE_SPARSE,
+		SCENE_DENSE,
+		SCENE_MIXED,
+	};
+
+	static void *_pair(CollisionObject2DSW *A, int p_subindex_A, CollisionObject2DSW *B, int p_subindex_B, void *p_userdata) {
+
+		(*(int *)p_userdata)++;
+		return NULL;
+	}
+
+	static void _unpair(CollisionObject2DSW *A, int p_subindex_A, CollisionObject2DSW *B, int p_subindex_B, void *p_data, void *p_userdata) {
+
+		(*(int *)p_userdata)--;
+	}
+
+	static void _run(BroadPhase2DSW::CreateFunction p_create, const String &p_name, Scene p_scene) {
+
+		// sparse spreads small objects over a large world, dense packs them together,
+		// mixed adds huge static strips like the ones tile maps produce
+		real_t extent = p_scene == SCENE_DENSE ? 2048 : 32768;
+		int static_count = p_scene == SCENE_MIXED ? STATIC_OBJECTS : 0;
+
+		Vector<Body2DSW *> objects;
+		Vector<Rect2> rects;
+		Vector<Vector2> velocities;
+		Math::seed(4);
+
+		for (int i = 0; i < MOVING_OBJECTS + static_count; i++) {
+
+			Rect2 rect;
+			if (i < MOVING_OBJECTS) {
+				rect = Rect2(Math::randf() * extent, Math::randf() * extent, 16 + Math::randf() * 16, 16 + Math::randf() * 16);
+			} else {
+				rect = Rect2(0, (i - MOVING_OBJECTS) * extent / STATIC_OBJECTS, extent, 64);
+			}
+			objects.push_back(memnew(Body2DSW));
+			rects.push_back(rect);
+			velocities.push_back(Vector2(Math::randf() - 0.5, Math::randf() - 0.5) * 8.0);
+		}
+
+		BroadPhase2DSW *bp = p_create();
+		int pairs = 0;
+		bp->set_pair_callback(_pair, &pairs);
+		bp->set_unpair_callback(_unpair, &pairs);
+
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+
+		Vector<BroadPhase2DSW::ID> ids;
+		for (int i = 0; i < objects.size(); i++) {
+
+			BroadPhase2DSW::ID id = bp->create(objects[i], 0, rects[i]);
+			bp->set_static(id, i >= MOVING_OBJECTS);
+			bp->move(id, rects[i]);
+			ids.push_back(id);
+		}
+		bp->update();
+
+		uint64_t insert_usec = OS::get_singleton()->get_ticks_usec() - begin;
+		begin = OS::get_singleton()->get_ticks_usec();
+
+		for (int step = 0; step < MEASURED_STEPS; step++) {
+			for (int i = 0; i < MOVING_OBJECTS; i++) {
+				rects.write[i].position += velocities[i];
+				bp->move(ids[i], rects[i]);
+			}
+			bp->update();
+		}
+
+		uint64_t step_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+		CollisionObject2DSW *results[QUERY_RESULTS];
+		int hits = 0;
+		begin = OS::get_singleton()->get_ticks_usec();
+
+		for (int i = 0; i < QUERIES; i++) {
+			hits += bp->cull_aabb(Rect2(Math::randf() * extent, Math::randf() * extent, 64, 64), results, QUERY_RESULTS);
+		}
+
+		uint64_t query_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+		print_line(p_name + ": insert " + rtos(insert_usec / 1000.0) + " ms, " + rtos(step_usec / 1000.0 / MEASURED_STEPS) + " ms per step (" + itos(pairs) + " pairs), " + itos(QUERIES) + " queries " + rtos(query_usec / 1000.0) + " ms (" + itos(hits) + " hits)");
+
+		for (int i = 0; i < ids.size(); i++) {
+			bp->remove(ids[i]);
+		}
+		memdelete(bp);
+
+		for (int i = 0; i < objects.size(); i++) {
+			memdelete(objects[i]);
+		}
+	}
+
+public:
+	static void run() {
+
+		const char *scenes[3] = { "Sparse", "Dense", "Mixed sizes" };
+
+		for (int i = 0; i < 3; i++) {
+			print_line(String(scenes[i]) + ", " + itos(MOVING_OBJECTS) + " moving objects" + (i == SCENE_MIXED ? ", " + itos(STATIC_OBJECTS) + " large static objects" : String()));
+			_run(BroadPhase2DHashGrid::_create, "Hash grid", Scene(i));
+			_run(BroadPhase2DBVH::_create, "BVH", Scene(i));
+		}
+	}
+};
+
 class TestPhysics2DMainLoop : public MainLoop {
 
 	GDCLASS(TestPhysics2DMainLoop, MainLoop);
@@ -426,10 +548,559 @@ public:
 	TestPhysics2DMainLoop() {}
 };
 
+// Headless benchmark for the island solver: many independent stacks of boxes
+// on a shared floor, stepped with an increasing amount of solver threads.
+// Also compares the broadphases, and kinematic characters sliding through a
+// field of boxes with and without sharing the broadphase query of a slide.
+class TestPhysics2DBenchmarkMainLoop : public MainLoop {
+
+	GDCLASS(TestPhysics2DBenchmarkMainLoop, MainLoop);
+
+	enum {
+		PILE_COUNT = 1024,
+		PILE_HEIGHT = 5,
+		SETTLE_STEPS = 60,
+		MEASURED_STEPS = 300,
+		CHARACTER_COUNT = 2000,
+		CHARACTER_FRAMES = 60,
+		MAX_SLIDES = 4,
+		AREA_COUNT = 256,
+		AREA_BODIES = 4000,
+		AREA_STEPS = 120,
+	};
+
+	int area_events;
+
+	void _area_event(int p_status, const RID &p_body, int p_instance, int p_body_shape, int p_area_shape) {
+
+		area_events++;
+	}
+
+	void _area_event_batch(const PoolIntArray &p_status, const Array &p_bodies, const PoolIntArray &p_instances, const PoolIntArray &p_body_shapes, const PoolIntArray &p_area_shapes) {
+
+		area_events += p_status.size();
+	}
+
+	// what KinematicBody2D::move_and_slide() does, without the node
+	static int _slide(Physics2DServerSW *p_ps, RID p_body, Transform2D &r_xform, Vector2 p_motion, bool p_batch) {
+
+		const real_t margin = 0.08;
+		int collisions = 0;
+
+		if (p_batch) {
+			p_ps->body_begin_motion_batch(p_body, r_xform, p_motion.length(), margin);
+		}
+
+		for (int i = 0; i < MAX_SLIDES; i++) {
+
+			Physics2DServer::MotionResult result;
+			bool collided = p_ps->body_test_motion(p_body, r_xform, p_motion, true, margin, &result);
+			r_xform.elements[2] += result.motion;
+			if (!collided) {
+				break;
+			}
+
+			collisions++;
+			p_motion = result.remainder.slide(result.collision_normal);
+			if (p_motion == Vector2()) {
+				break;
+			}
+		}
+
+		if (p_batch) {
+			p_ps->body_end_motion_batch(p_body);
+		}
+
+		return collisions;
+	}
+
+	uint64_t run_characters(Physics2DServerSW *p_ps, bool p_batch, int &r_collisions) {
+
+		RID space = p_ps->space_create();
+		p_ps->space_set_active(space, true);
+
+		int side = Math::ceil(Math::sqrt((float)CHARACTER_COUNT));
+
+		RID box_shape = p_ps->rectangle_shape_create();
+		p_ps->shape_set_data(box_shape, Vector2(12, 12));
+
+		RID capsule_shape = p_ps->capsule_shape_create();
+		p_ps->shape_set_data(capsule_shape, Vector2(6, 8));
+
+		// a box on every cell corner, a character in every cell
+		List<RID> bodies;
+
+		for (int i = 0; i <= side; i++) {
+			for (int j = 0; j <= side; j++) {
+
+				RID box = p_ps->body_create();
+				p_ps->body_set_mode(box, Physics2DServer::BODY_MODE_STATIC);
+				p_ps->body_set_space(box, space);
+				p_ps->body_add_shape(box, box_shape);
+				p_ps->body_set_state(box, Physics2DServer::BODY_STATE_TRANSFORM, Transform2D(0, Vector2(j * 64, i * 64)));
+				bodies.push_back(box);
+			}
+		}
+
+		Vector<RID> characters;
+		Vector<Transform2D> xforms;
+		Vector<Vector2> velocities;
+		Math::seed(4);
+
+		for (int i = 0; i < CHARACTER_COUNT; i++) {
+
+			Transform2D xform(0, Vector2((i % side) * 64 + 32, (i / side) * 64 + 32));
+			RID character = p_ps->body_create();
+			p_ps->body_set_mode(character, Physics2DServer::BODY_MODE_KINEMATIC);
+			p_ps->body_set_space(character, space);
+			p_ps->body_add_shape(character, capsule_shape);
+			p_ps->body_set_state(character, Physics2DServer::BODY_STATE_TRANSFORM, xform);
+			characters.push_back(character);
+			xforms.push_back(xform);
+			velocities.push_back(Vector2(Math::randf() * 2.0 - 1.0, Math::randf() * 2.0 - 1.0).normalized() * 600);
+		}
+
+		real_t delta = 1.0 / 60.0;
+		p_ps->step(delta);
+		p_ps->flush_queries();
+
+		r_collisions = 0;
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+
+		for (int i = 0; i < CHARACTER_FRAMES; i++) {
+			for (int j = 0; j < characters.size(); j++) {
+				r_collisions += _slide(p_ps, characters[j], xforms.write[j], velocities[j] * delta, p_batch);
+			}
+		}
+
+		uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - begin;
+
+		for (int i = 0; i < characters.size(); i++) {
+			p_ps->free(characters[i]);
+		}
+		for (List<RID>::Element *E = bodies.front(); E; E = E->next()) {
+			p_ps->free(E->get());
+		}
+		p_ps->free(capsule_shape);
+		p_ps->free(box_shape);
+		p_ps->free(space);
+
+		return elapsed;
+	}
+
+	// bodies streaming through a grid of monitoring areas, every area gets enter/exit events each step
+	uint64_t run_areas(Physics2DServerSW *p_ps, bool p_batch, int &r_events) {
+
+		RID space = p_ps->space_create();
+		p_ps->space_set_active(space, true);
+
+		int side = Math::ceil(Math::sqrt((float)AREA_COUNT));
+		real_t size = side * 64;
+
+		RID area_shape = p_ps->rectangle_shape_create();
+		p_ps->shape_set_data(area_shape, Vector2(24, 24));
+
+		RID body_shape = p_ps->circle_shape_create();
+		p_ps->shape_set_data(body_shape, 4);
+
+		List<RID> areas;
+
+		for (int i = 0; i < AREA_COUNT; i++) {
+
+			RID area = p_ps->area_create();
+			p_ps->area_set_space(area, space);
+			p_ps->area_add_shape(area, area_shape);
+			p_ps->area_set_transform(area, Transform2D(0, Vector2((i % side) * 64 + 32, (i / side) * 64 + 32)));
+			p_ps->area_set_monitor_batching(area, p_batch);
+			p_ps->area_set_monitor_callback(area, this, p_batch ? "_area_event_batch" : "_area_event");
+			areas.push_back(area);
+		}
+
+		Vector<RID> bodies;
+		Vector<Vector2> positions;
+		Vector<Vector2> velocities;
+		Math::seed(5);
+
+		for (int i = 0; i < AREA_BODIES; i++) {
+
+			Vector2 pos(Math::randf() * size, Math::randf() * size);
+			RID body = p_ps->body_create();
+			p_ps->body_set_mode(body, Physics2DServer::BODY_MODE_KINEMATIC);
+			p_ps->body_set_space(body, space);
+			p_ps->body_add_shape(body, body_shape);
+			p_ps->body_set_state(body, Physics2DServer::BODY_STATE_TRANSFORM, Transform2D(0, pos));
+			bodies.push_back(body);
+			positions.push_back(pos);
+			velocities.push_back(Vector2(Math::randf() * 2.0 - 1.0, Math::randf() * 2.0 - 1.0).normalized() * 300);
+		}
+
+		real_t delta = 1.0 / 60.0;
+		area_events = 0;
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+
+		for (int i = 0; i < AREA_STEPS; i++) {
+
+			for (int j = 0; j < bodies.size(); j++) {
+				Vector2 pos = positions[j] + velocities[j] * delta;
+				pos = Vector2(Math::fposmod(pos.x, size), Math::fposmod(pos.y, size));
+				positions.write[j] = pos;
+				p_ps->body_set_state(bodies[j], Physics2DServer::BODY_STATE_TRANSFORM, Transform2D(0, pos));
+			}
+
+			p_ps->step(delta);
+			p_ps->flush_queries();
+		}
+
+		uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - begin;
+		r_events = area_events;
+
+		for (int i = 0; i < bodies.size(); i++) {
+			p_ps->free(bodies[i]);
+		}
+		for (List<RID>::Element *E = areas.front(); E; E = E->next()) {
+			p_ps->free(E->get());
+		}
+		p_ps->free(body_shape);
+		p_ps->free(area_shape);
+		p_ps->free(space);
+
+		return elapsed;
+	}
+
+	uint64_t run(Physics2DServerSW *p_ps, int p_threads, Vector<Transform2D> &r_xforms) {
+
+		p_ps->set_solver_thread_count(p_threads);
+
+		RID space = p_ps->space_create();
+		p_ps->space_set_active(space, true);
+		p_ps->area_set_param(space, Physics2DServer::AREA_PARAM_GRAVITY, 98);
+		p_ps->area_set_param(space, Physics2DServer::AREA_PARAM_GRAVITY_VECTOR, Vector2(0, 1));
+
+		int side = Math::ceil(Math::sqrt((float)PILE_COUNT));
+
+		// one long floor shared by every pile in a row
+		RID floor_shape = p_ps->rectangle_shape_create();
+		p_ps->shape_set_data(floor_shape, Vector2(side * 48, 8));
+
+		RID box_shape = p_ps->rectangle_shape_create();
+		p_ps->shape_set_data(box_shape, Vector2(8, 8));
+
+		List<RID> bodies;
+
+		for (int i = 0; i < side; i++) {
+
+			RID floor = p_ps->body_create();
+			p_ps->body_set_mode(floor, Physics2DServer::BODY_MODE_STATIC);
+			p_ps->body_set_space(floor, space);
+			p_ps->body_add_shape(floor, floor_shape);
+			p_ps->body_set_state(floor, Physics2DServer::BODY_STATE_TRANSFORM, Transform2D(0, Vector2(side * 48, i * 200 + 8)));
+			bodies.push_back(floor);
+		}
+
+		Vector<RID> boxes;
+
+		for (int i = 0; i < PILE_COUNT; i++) {
+			for (int j = 0; j < PILE_HEIGHT; j++) {
+
+				RID body = p_ps->body_create();
+				p_ps->body_set_space(body, space);
+				p_ps->body_add_shape(body, box_shape);
+				p_ps->body_set_state(body, Physics2DServer::BODY_STATE_CAN_SLEEP, false); // keep every island busy
+				p_ps->body_set_state(body, Physics2DServer::BODY_STATE_TRANSFORM, Transform2D(0, Vector2((i % side) * 96 + 48, (i / side) * 200 - 8 - j * 16.5)));
+				boxes.push_back(body);
+			}
+		}
+
+		real_t delta = 1.0 / 60.0;
+
+		for (int i = 0; i < SETTLE_STEPS; i++) {
+			p_ps->step(delta);
+			p_ps->flush_queries();
+		}
+
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+
+		for (int i = 0; i < MEASURED_STEPS; i++) {
+			p_ps->step(delta);
+			p_ps->flush_queries();
+		}
+
+		uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - begin;
+
+		r_xforms.resize(boxes.size());
+		for (int i = 0; i < boxes.size(); i++) {
+			r_xforms.write[i] = p_ps->body_get_state(boxes[i], Physics2DServer::BODY_STATE_TRANSFORM);
+			p_ps->free(boxes[i]);
+		}
+		for (List<RID>::Element *E = bodies.front(); E; E = E->next()) {
+			p_ps->free(E->get());
+		}
+		p_ps->free(box_shape);
+		p_ps->free(floor_shape);
+		p_ps->free(space);
+
+		return elapsed;
+	}
+
+public:
+	virtual void init() {
+
+		TestBroadPhase2D::run();
+
+		Physics2DServerSW *ps = Object::cast_to<Physics2DServerSW>(Physics2DServer::get_singleton());
+		if (!ps) {
+			print_line("The 2D physics benchmark needs the \"Single-Unsafe\" 2D thread model.");
+			return;
+		}
+
+		int initial_threads = ps->get_solver_thread_count();
+		int max_threads = OS::get_singleton()->get_processor_count();
+		ps->set_active(true);
+
+		print_line("Islands: " + itos(PILE_COUNT) + ", bodies per island: " + itos(PILE_HEIGHT) + ", steps: " + itos(MEASURED_STEPS) + ", cores: " + itos(max_threads));
+
+		uint64_t single_thread_usec = 0;
+		Vector<Transform2D> single_thread_xforms;
+
+		for (int threads = 1; threads <= max_threads; threads = threads < max_threads ? MIN(threads * 2, max_threads) : threads + 1) {
+
+			Vector<Transform2D> xforms;
+			uint64_t usec = run(ps, threads, xforms);
+			if (threads == 1) {
+				single_thread_usec = usec;
+				single_thread_xforms = xforms;
+			}
+
+			// the thread count must not change the result
+			bool identical = xforms.size() == single_thread_xforms.size() && memcmp(xforms.ptr(), single_thread_xforms.ptr(), xforms.size() * sizeof(Transform2D)) == 0;
+
+			print_line("Threads: " + itos(threads) + ", " + rtos(usec / 1000.0 / MEASURED_STEPS) + " ms per step, speedup " + rtos((double)single_thread_usec / MAX(usec, (uint64_t)1)) + "x, " + (identical ? "identical" : "DIVERGED"));
+		}
+
+		ps->set_solver_thread_count(initial_threads);
+
+		int collisions = 0;
+		int batched_collisions = 0;
+		uint64_t usec = run_characters(ps, false, collisions);
+		uint64_t batched_usec = run_characters(ps, true, batched_collisions);
+
+		print_line("Characters: " + itos(CHARACTER_COUNT) + ", " + rtos(usec / 1000.0 / CHARACTER_FRAMES) + " ms per frame (" + itos(collisions) + " collisions), sharing the slide query " + rtos(batched_usec / 1000.0 / CHARACTER_FRAMES) + " ms per frame (" + itos(batched_collisions) + " collisions)");
+
+		int events = 0;
+		int batched_events = 0;
+		usec = run_areas(ps, false, events);
+		batched_usec = run_areas(ps, true, batched_events);
+
+		print_line("Areas: " + itos(AREA_COUNT) + ", bodies: " + itos(AREA_BODIES) + ", " + rtos(usec / 1000.0 / AREA_STEPS) + " ms per step (" + itos(events) + " events), batched " + rtos(batched_usec / 1000.0 / AREA_STEPS) + " ms per step (" + itos(batched_events) + " events)");
+	}
+
+	virtual bool iteration(float p_time) {
+		return true;
+	}
+
+	virtual bool idle(float p_time) {
+		return true;
+	}
+
+	virtual void finish() {
+	}
+
+protected:
+	static void _bind_methods() {
+
+		ClassDB::bind_method(D_METHOD("_area_event"), &TestPhysics2DBenchmarkMainLoop::_area_event);
+		ClassDB::bind_method(D_METHOD("_area_event_batch"), &TestPhysics2DBenchmarkMainLoop::_area_event_batch);
+	}
+};
+
+// Runs the same scene and prints a hash of its final state. With deterministic_physics_2d=yes,
+// builds for other platforms or optimization levels must print the same hash, pass the one
+// from another build with --expect. misc/scripts/physics_2d_determinism.sh compares the
+// hashes of an unoptimized and an optimized build:
+//     godot_server --test physics_2d_determinism [--expect <hash>]
+class TestPhysics2DDeterminismMainLoop : public MainLoop {
+
+	GDCLASS(TestPhysics2DDeterminismMainLoop, MainLoop);
+
+	enum {
+		PILE_COUNT = 8,
+		PILE_HEIGHT = 12,
+		CHAIN_LINKS = 10,
+		STEPS = 600,
+	};
+
+	String expected_hash;
+
+	RID _create_body(Physics2DServerSW *p_ps, RID p_space, RID p_shape, const Vector2 &p_pos) {
+
+		RID body = p_ps->body_create();
+		p_ps->body_set_mode(body, Physics2DServer::BODY_MODE_RIGID);
+		p_ps->body_set_space(body, p_space);
+		p_ps->body_add_shape(body, p_shape);
+		p_ps->body_set_state(body, Physics2DServer::BODY_STATE_TRANSFORM, Transform2D(0, p_pos));
+		return body;
+	}
+
+	// piles of boxes and circles thrown at each other, a chain and a spring, to go through
+	// the SAT, the solver, joints, CCD, sleeping and the integration
+	uint32_t run(Physics2DServerSW *p_ps, int p_threads) {
+
+		p_ps->set_solver_thread_count(p_threads);
+
+		RID space = p_ps->space_create();
+		p_ps->space_set_active(space, true);
+
+		RID ground_shape = p_ps->rectangle_shape_create();
+		p_ps->shape_set_data(ground_shape, Vector2(2000, 20));
+
+		RID box_shape = p_ps->rectangle_shape_create();
+		p_ps->shape_set_data(box_shape, Vector2(10, 10));
+
+		RID circle_shape = p_ps->circle_shape_create();
+		p_ps->shape_set_data(circle_shape, 9);
+
+		List<RID> rids;
+
+		RID ground = p_ps->body_create();
+		p_ps->body_set_mode(ground, Physics2DServer::BODY_MODE_STATIC);
+		p_ps->body_set_space(ground, space);
+		p_ps->body_add_shape(ground, ground_shape);
+		p_ps->body_set_state(ground, Physics2DServer::BODY_STATE_TRANSFORM, Transform2D(0, Vector2(0, 600)));
+		rids.push_back(ground);
+
+		Vector<RID> bodies;
+		Math::seed(8);
+
+		for (int i = 0; i < PILE_COUNT; i++) {
+			for (int j = 0; j < PILE_HEIGHT; j++) {
+
+				RID body = _create_body(p_ps, space, (i + j) % 3 ? box_shape : circle_shape, Vector2(i * 200 - 700 + Math::randf() * 4, 570 - j * 22));
+				if (j == PILE_HEIGHT - 1) {
+					p_ps->body_set_state(body, Physics2DServer::BODY_STATE_LINEAR_VELOCITY, Vector2(i % 2 ? -800 : 800, -200));
+					p_ps->body_set_state(body, Physics2DServer::BODY_STATE_ANGULAR_VELOCITY, Math::randf() * 20 - 10);
+					p_ps->body_set_continuous_collision_detection_mode(body, Physics2DServer::CCD_MODE_CAST_RAY);
+				}
+				bodies.push_back(body);
+			}
+		}
+
+		RID prev = ground;
+		for (int i = 0; i < CHAIN_LINKS; i++) {
+
+			RID link = _create_body(p_ps, space, box_shape, Vector2(-100 + i * 22, 200));
+			rids.push_back(p_ps->pin_joint_create(Vector2(-111 + i * 22, 200), link, prev));
+			bodies.push_back(link);
+			prev = link;
+		}
+
+		RID weight = _create_body(p_ps, space, circle_shape, Vector2(300, 100));
+		RID spring = p_ps->damped_spring_joint_create(Vector2(300, 0), Vector2(), ground, weight);
+		p_ps->damped_string_joint_set_param(spring, Physics2DServer::DAMPED_STRING_REST_LENGTH, 300);
+		p_ps->damped_string_joint_set_param(spring, Physics2DServer::DAMPED_STRING_STIFFNESS, 40);
+		p_ps->damped_string_joint_set_param(spring, Physics2DServer::DAMPED_STRING_DAMPING, 0.5);
+		rids.push_back(spring);
+		bodies.push_back(weight);
+
+		for (int i = 0; i < STEPS; i++) {
+			p_ps->step(1.0 / 60.0);
+			p_ps->flush_queries();
+		}
+
+		uint32_t hash = 5381;
+		for (int i = 0; i < bodies.size(); i++) {
+
+			Transform2D xform = p_ps->body_get_state(bodies[i], Physics2DServer::BODY_STATE_TRANSFORM);
+			Vector2 linear_velocity = p_ps->body_get_state(bodies[i], Physics2DServer::BODY_STATE_LINEAR_VELOCITY);
+			real_t angular_velocity = p_ps->body_get_state(bodies[i], Physics2DServer::BODY_STATE_ANGULAR_VELOCITY);
+
+			hash = hash_djb2_buffer((const uint8_t *)&xform, sizeof(Transform2D), hash);
+			hash = hash_djb2_buffer((const uint8_t *)&linear_velocity, sizeof(Vector2), hash);
+			hash = hash_djb2_buffer((const uint8_t *)&angular_velocity, sizeof(real_t), hash);
+		}
+
+		for (List<RID>::Element *E = rids.back(); E; E = E->prev()) {
+			p_ps->free(E->get());
+		}
+		for (int i = 0; i < bodies.size(); i++) {
+			p_ps->free(bodies[i]);
+		}
+		p_ps->free(circle_shape);
+		p_ps->free(box_shape);
+		p_ps->free(ground_shape);
+		p_ps->free(space);
+
+		return hash;
+	}
+
+public:
+	virtual void init() {
+
+		Physics2DServerSW *ps = Object::cast_to<Physics2DServerSW>(Physics2DServer::get_singleton());
+		if (!ps) {
+			print_line("The 2D determinism test needs the \"Single-Unsafe\" 2D thread model.");
+			OS::get_singleton()->set_exit_code(1);
+			return;
+		}
+
+#ifndef PHYSICS_2D_DETERMINISTIC
+		print_line("Not built with deterministic_physics_2d=yes, other builds may give other results.");
+#endif
+
+		int initial_threads = ps->get_solver_thread_count();
+		ps->set_active(true);
+
+		// running again, or on more threads, must not change the result either
+		uint32_t hash = run(ps, 1);
+		bool identical = run(ps, 1) == hash && run(ps, OS::get_singleton()->get_processor_count()) == hash;
+
+		ps->set_solver_thread_count(initial_threads);
+
+		String hash_text = String::num_uint64(hash, 16);
+		print_line("Hash: " + hash_text + ", " + (identical ? "repeatable" : "DIVERGED between runs"));
+
+		if (expected_hash != String()) {
+			print_line(expected_hash.to_lower() == hash_text ? "Matches the expected hash." : "DIVERGED from the expected hash " + expected_hash + ".");
+			identical = identical && expected_hash.to_lower() == hash_text;
+		}
+
+		OS::get_singleton()->set_exit_code(identical ? 0 : 1);
+	}
+
+	virtual bool iteration(float p_time) {
+		return true;
+	}
+
+	virtual bool idle(float p_time) {
+		return true;
+	}
+
+	virtual void finish() {
+	}
+
+	TestPhysics2DDeterminismMainLoop(const List<String> &p_args) {
+
+		for (const List<String>::Element *E = p_args.front(); E; E = E->next()) {
+			if (E->get() == "--expect" && E->next()) {
+				expected_hash = E->next()->get();
+			}
+		}
+	}
+};
+
 namespace TestPhysics2D {
 
 MainLoop *test() {
 
 	return memnew(TestPhysics2DMainLoop);
 }
+
+MainLoop *test_benchmark() {
+
+	return memnew(TestPhysics2DBenchmarkMainLoop);
+}
+
+MainLoop *test_determinism(const List<String> &p_args) {
+
+	return memnew(TestPhysics2DDeterminismMainLoop(p_args));
+}
 } // namespace TestPhysics2D
@@ -31,11 +31,15 @@
 #ifndef TEST_PHYSICS_2D_H
 #define TEST_PHYSICS_2D_H
 
+#include "core/list.h"
 #include "core/os/main_loop.h"
+#include "core/ustring.h"
 
 namespace TestPhysics2D {
 
 MainLoop *test();
+MainLoop *test_benchmark();
+MainLoop *test_determinism(const List<String> &p_args);
 }
 
 #endif // TEST_PHYSICS_2D_H
@@ -0,0 +1,1658 @@
+/*************************************************************************/
+/*  test_physics_server.cpp                                              */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_physics_server.h"
+
+#include "core/os/os.h"
+#include "core/project_settings.h"
+#include "scene/resources/mesh.h"
+#include "servers/physics/area_sw.h"
+#include "servers/physics/body_pair_sw.h"
+#include "servers/physics/body_sw.h"
+#include "servers/physics/collision_solver_sat.h"
+#include "servers/physics/collision_solver_sw.h"
+#include "servers/physics/joints/pin_joint_sw.h"
+#include "servers/physics/physics_server_sw.h"
+#include "servers/physics/shape_sw.h"
+#include "servers/physics/space_sw.h"
+#include "servers/physics/step_sw.h"
+#include "servers/physics_2d/area_2d_sw.h"
+#include "servers/physics_2d/body_2d_sw.h"
+#include "servers/physics_2d/body_pair_2d_sw.h"
+#include "servers/physics_2d/joints_2d_sw.h"
+#include "servers/physics_2d/math_2d_sw.h"
+#include "servers/physics_2d/shape_2d_sw.h"
+#include "servers/physics_2d/space_2d_sw.h"
+#include "servers/physics_2d/step_2d_sw.h"
+#include "servers/physics_2d_server.h"
+#include "servers/physics_server.h"
+#include "servers/visual_server.h"
+
+namespace TestPhysicsServer {
+
+#define CHECK(m_cond)                                        \
+	if (!(m_cond)) {                                         \
+		OS::get_singleton()->print("\tFAIL: %s\n", #m_cond); \
+		return false;                                        \
+	}
+
+/* BATCH QUERIES */
+
+enum {
+	GRID_SIZE = 4,
+	GRID_SPACING = 4,
+	QUERY_SIDE = 12,
+	QUERY_COUNT = QUERY_SIDE * QUERY_SIDE,
+};
+
+static real_t _query_coord(int p_index) {
+
+	// spans the grid and a bit around it, so some of the queries miss
+	return -2.0 + p_index * (GRID_SIZE * GRID_SPACING) / real_t(QUERY_SIDE - 1);
+}
+
+static bool _compare_batch_3d(PhysicsDirectSpaceState *p_state, RID p_shape, RID p_excluded, bool p_threaded) {
+
+	Set<RID> exclude_set;
+	exclude_set.insert(p_excluded);
+	RID exclude[1] = { p_excluded };
+
+	Vector<Vector3> from;
+	Vector<Vector3> to;
+	Vector<Transform> xforms;
+	Vector<Vector3> motions;
+	Vector<Transform> rest_xforms;
+	for (int i = 0; i < QUERY_SIDE; i++) {
+		for (int j = 0; j < QUERY_SIDE; j++) {
+			Vector3 pos(_query_coord(i), 0, _query_coord(j));
+			from.push_back(pos + Vector3(0, 5, 0));
+			to.push_back(pos + Vector3((i & 1) ? 3 : 0, -5, 0));
+			xforms.push_back(Transform(Basis(), pos + Vector3(0, 3, 0)));
+			motions.push_back((j & 1) ? Vector3(0, -6, 0) : Vector3(6, -2, 0));
+			rest_xforms.push_back(Transform(Basis(), pos + Vector3(0, (i + j) % 3 * 0.5, 0)));
+		}
+	}
+
+	// fill the outputs with garbage, every slot has to be written
+	Vector<PhysicsDirectSpaceState::RayResult> rays;
+	Vector<bool> collided;
+	rays.resize(QUERY_COUNT);
+	collided.resize(QUERY_COUNT);
+	for (int i = 0; i < QUERY_COUNT; i++) {
+		collided.write[i] = true;
+	}
+
+	int hits = p_state->intersect_ray_batch(from.ptr(), to.ptr(), QUERY_COUNT, rays.ptrw(), collided.ptrw(), exclude, 1, 0xFFFFFFFF, true, false, p_threaded);
+	int expected_hits = 0;
+	for (int i = 0; i < QUERY_COUNT; i++) {
+		PhysicsDirectSpaceState::RayResult ray;
+		bool hit = p_state->intersect_ray(from[i], to[i], ray, exclude_set);
+		CHECK(collided[i] == hit);
+		if (hit) {
+			expected_hits++;
+			CHECK(rays[i].position.is_equal_approx(ray.position));
+			CHECK(rays[i].normal.is_equal_approx(ray.normal));
+			CHECK(rays[i].rid == ray.rid);
+			CHECK(rays[i].collider_id == ray.collider_id);
+			CHECK(rays[i].shape == ray.shape);
+		}
+	}
+	CHECK(hits == expected_hits);
+	CHECK(hits > 0 && hits < QUERY_COUNT);
+
+	Vector<float> safe;
+	Vector<float> unsafe;
+	safe.resize(QUERY_COUNT);
+	unsafe.resize(QUERY_COUNT);
+	for (int i = 0; i < QUERY_COUNT; i++) {
+		safe.write[i] = -1;
+		unsafe.write[i] = -1;
+	}
+
+	hits = p_state->cast_motion_batch(p_shape, xforms.ptr(), motions.ptr(), QUERY_COUNT, 0.04, safe.ptrw(), unsafe.ptrw(), exclude, 1, 0xFFFFFFFF, true, false, p_threaded);
+	expected_hits = 0;
+	for (int i = 0; i < QUERY_COUNT; i++) {
+		float closest_safe = 1;
+		float closest_unsafe = 1;
+		p_state->cast_motion(p_shape, xforms[i], motions[i], 0.04, closest_safe, closest_unsafe, exclude_set);
+		CHECK(Math::is_equal_approx(safe[i], closest_safe));
+		CHECK(Math::is_equal_approx(unsafe[i], closest_unsafe));
+		if (closest_safe < 1) {
+			expected_hits++;
+		}
+	}
+	CHECK(hits == expected_hits);
+	CHECK(hits > 0 && hits < QUERY_COUNT);
+
+	Vector<PhysicsDirectSpaceState::ShapeRestInfo> infos;
+	infos.resize(QUERY_COUNT);
+	for (int i = 0; i < QUERY_COUNT; i++) {
+		collided.write[i] = true;
+	}
+
+	hits = p_state->rest_info_batch(p_shape, rest_xforms.ptr(), QUERY_COUNT, 0.04, infos.ptrw(), collided.ptrw(), exclude, 1, 0xFFFFFFFF, true, false, p_threaded);
+	expected_hits = 0;
+	for (int i = 0; i < QUERY_COUNT; i++) {
+		PhysicsDirectSpaceState::ShapeRestInfo info;
+		bool hit = p_state->rest_info(p_shape, rest_xforms[i], 0.04, &info, exclude_set);
+		CHECK(collided[i] == hit);
+		if (hit) {
+			expected_hits++;
+			CHECK(infos[i].point.is_equal_approx(info.point));
+			CHECK(infos[i].normal.is_equal_approx(info.normal));
+			CHECK(infos[i].rid == info.rid);
+			CHECK(infos[i].collider_id == info.collider_id);
+			CHECK(infos[i].shape == info.shape);
+		}
+	}
+	CHECK(hits == expected_hits);
+	CHECK(hits > 0 && hits < QUERY_COUNT);
+
+	// an invalid shape fails the whole batch, which must still read as "no hit"
+	for (int i = 0; i < QUERY_COUNT; i++) {
+		safe.write[i] = -1;
+		unsafe.write[i] = -1;
+		collided.write[i] = true;
+	}
+	CHECK(p_state->cast_motion_batch(RID(), xforms.ptr(), motions.ptr(), QUERY_COUNT, 0.04, safe.ptrw(), unsafe.ptrw()) == 0);
+	CHECK(p_state->rest_info_batch(RID(), rest_xforms.ptr(), QUERY_COUNT, 0.04, infos.ptrw(), collided.ptrw()) == 0);
+	for (int i = 0; i < QUERY_COUNT; i++) {
+		CHECK(safe[i] == 1 && unsafe[i] == 1);
+		CHECK(!collided[i]);
+	}
+
+	return true;
+}
+
+static bool test_batch_queries_3d() {
+
+	PhysicsServer *ps = PhysicsServer::get_singleton();
+	ps->set_active(true);
+
+	RID space = ps->space_create();
+	ps->space_set_active(space, true);
+	Vector<RID> rids;
+
+	RID box = ps->shape_create(PhysicsServer::SHAPE_BOX);
+	ps->shape_set_data(box, Vector3(1, 1, 1));
+	rids.push_back(box);
+	RID sphere = ps->shape_create(PhysicsServer::SHAPE_SPHERE);
+	ps->shape_set_data(sphere, 1.0);
+	rids.push_back(sphere);
+	RID query = ps->shape_create(PhysicsServer::SHAPE_SPHERE);
+	ps->shape_set_data(query, 0.5);
+	rids.push_back(query);
+
+	for (int i = 0; i < GRID_SIZE; i++) {
+		for (int j = 0; j < GRID_SIZE; j++) {
+			RID body = ps->body_create(PhysicsServer::BODY_MODE_STATIC);
+			ps->body_set_space(body, space);
+			ps->body_add_shape(body, ((i + j) & 1) ? sphere : box);
+			ps->body_set_state(body, PhysicsServer::BODY_STATE_TRANSFORM, Transform(Basis(), Vector3(i * GRID_SPACING, 0, j * GRID_SPACING)));
+			rids.push_back(body);
+		}
+	}
+
+	// the broadphase only knows about the bodies after a step
+	ps->step(1.0 / 60.0);
+	ps->flush_queries();
+
+	PhysicsDirectSpaceState *state = ps->space_get_direct_state(space);
+	bool pass = state && _compare_batch_3d(state, query, rids[3], false) && _compare_batch_3d(state, query, rids[3], true);
+
+	for (int i = rids.size() - 1; i >= 0; i--) {
+		ps->free(rids[i]);
+	}
+	ps->free(space);
+	return pass;
+}
+
+static bool _compare_batch_2d(Physics2DDirectSpaceState *p_state, RID p_shape, RID p_excluded, bool p_threaded) {
+
+	Set<RID> exclude_set;
+	exclude_set.insert(p_excluded);
+	RID exclude[1] = { p_excluded };
+
+	Vector<Vector2> from;
+	Vector<Vector2> to;
+	Vector<Transform2D> xforms;
+	Vector<Vector2> motions;
+	Vector<Transform2D> rest_xforms;
+	for (int i = 0; i < QUERY_SIDE; i++) {
+		for (int j = 0; j < QUERY_SIDE; j++) {
+			Vector2 pos(_query_coord(i), _query_coord(j));
+			from.push_back(pos + Vector2(-3, -5));
+			to.push_back(pos + Vector2((i & 1) ? 3 : -3, 5));
+			xforms.push_back(Transform2D(0, pos + Vector2(0, -3)));
+			motions.push_back((j & 1) ? Vector2(0, 6) : Vector2(6, 2));
+			rest_xforms.push_back(Transform2D(0, pos + Vector2(0, (i + j) % 3 * 0.5)));
+		}
+	}
+
+	Vector<Physics2DDirectSpaceState::RayResult> rays;
+	Vector<bool> collided;
+	rays.resize(QUERY_COUNT);
+	collided.resize(QUERY_COUNT);
+	for (int i = 0; i < QUERY_COUNT; i++) {
+		collided.write[i] = true;
+	}
+
+	int hits = p_state->intersect_ray_batch(from.ptr(), to.ptr(), QUERY_COUNT, rays.ptrw(), collided.ptrw(), exclude, 1, 0xFFFFFFFF, true, false, p_threaded);
+	int expected_hits = 0;
+	for (int i = 0; i < QUERY_COUNT; i++) {
+		Physics2DDirectSpaceState::RayResult ray;
+		bool hit = p_state->intersect_ray(from[i], to[i], ray, exclude_set);
+		CHECK(collided[i] == hit);
+		if (hit) {
+			expected_hits++;
+			CHECK(rays[i].position.is_equal_approx(ray.position));
+			CHECK(rays[i].normal.is_equal_approx(ray.normal));
+			CHECK(rays[i].rid == ray.rid);
+			CHECK(rays[i].collider_id == ray.collider_id);
+			CHECK(rays[i].shape == ray.shape);
+		}
+	}
+	CHECK(hits == expected_hits);
+	CHECK(hits > 0 && hits < QUERY_COUNT);
+
+	Vector<float> safe;
+	Vector<float> unsafe;
+	safe.resize(QUERY_COUNT);
+	unsafe.resize(QUERY_COUNT);
+	for (int i = 0; i < QUERY_COUNT; i++) {
+		safe.write[i] = -1;
+		unsafe.write[i] = -1;
+	}
+
+	hits = p_state->cast_motion_batch(p_shape, xforms.ptr(), motions.ptr(), QUERY_COUNT, 0.08, safe.ptrw(), unsafe.ptrw(), exclude, 1, 0xFFFFFFFF, true, false, p_threaded);
+	expected_hits = 0;
+	for (int i = 0; i < QUERY_COUNT; i++) {
+		float closest_safe = 1;
+		float closest_unsafe = 1;
+		p_state->cast_motion(p_shape, xforms[i], motions[i], 0.08, closest_safe, closest_unsafe, exclude_set);
+		CHECK(Math::is_equal_approx(safe[i], closest_safe));
+		CHECK(Math::is_equal_approx(unsafe[i], closest_unsafe));
+		if (closest_safe < 1) {
+			expected_hits++;
+		}
+	}
+	CHECK(hits == expected_hits);
+	CHECK(hits > 0 && hits < QUERY_COUNT);
+
+	Vector<Physics2DDirectSpaceState::ShapeRestInfo> infos;
+	infos.resize(QUERY_COUNT);
+	for (int i = 0; i < QUERY_COUNT; i++) {
+		collided.write[i] = true;
+	}
+
+	hits = p_state->rest_info_batch(p_shape, rest_xforms.ptr(), Vector2(), QUERY_COUNT, 0.08, infos.ptrw(), collided.ptrw(), exclude, 1, 0xFFFFFFFF, true, false, p_threaded);
+	expected_hits = 0;
+	for (int i = 0; i < QUERY_COUNT; i++) {
+		Physics2DDirectSpaceState::ShapeRestInfo info;
+		bool hit = p_state->rest_info(p_shape, rest_xforms[i], Vector2(), 0.08, &info, exclude_set);
+		CHECK(collided[i] == hit);
+		if (hit) {
+			expected_hits++;
+			CHECK(infos[i].point.is_equal_approx(info.point));
+			CHECK(infos[i].normal.is_equal_approx(info.normal));
+			CHECK(infos[i].rid == info.rid);
+			CHECK(infos[i].collider_id == info.collider_id);
+			CHECK(infos[i].shape == info.shape);
+		}
+	}
+	CHECK(hits == expected_hits);
+	CHECK(hits > 0 && hits < QUERY_COUNT);
+
+	for (int i = 0; i < QUERY_COUNT; i++) {
+		safe.write[i] = -1;
+		unsafe.write[i] = -1;
+		collided.write[i] = true;
+	}
+	CHECK(p_state->cast_motion_batch(RID(), xforms.ptr(), motions.ptr(), QUERY_COUNT, 0.08, safe.ptrw(), unsafe.ptrw()) == 0);
+	CHECK(p_state->rest_info_batch(RID(), rest_xforms.ptr(), Vector2(), QUERY_COUNT, 0.08, infos.ptrw(), collided.ptrw()) == 0);
+	for (int i = 0; i < QUERY_COUNT; i++) {
+		CHECK(safe[i] == 1 && unsafe[i] == 1);
+		CHECK(!collided[i]);
+	}
+
+	return true;
+}
+
+static bool test_batch_queries_2d() {
+
+	Physics2DServer *ps = Physics2DServer::get_singleton();
+	ps->set_active(true);
+
+	RID space = ps->space_create();
+	ps->space_set_active(space, true);
+	Vector<RID> rids;
+
+	RID rect = ps->rectangle_shape_create();
+	ps->shape_set_data(rect, Vector2(1, 1));
+	rids.push_back(rect);
+	RID circle = ps->circle_shape_create();
+	ps->shape_set_data(circle, 1.0);
+	rids.push_back(circle);
+	RID query = ps->circle_shape_create();
+	ps->shape_set_data(query, 0.5);
+	rids.push_back(query);
+
+	for (int i = 0; i < GRID_SIZE; i++) {
+		for (int j = 0; j < GRID_SIZE; j++) {
+			RID body = ps->body_create();
+			ps->body_set_mode(body, Physics2DServer::BODY_MODE_STATIC);
+			ps->body_set_space(body, space);
+			ps->body_add_shape(body, ((i + j) & 1) ? circle : rect);
+			ps->body_set_state(body, Physics2DServer::BODY_STATE_TRANSFORM, Transform2D(0, Vector2(i * GRID_SPACING, j * GRID_SPACING)));
+			rids.push_back(body);
+		}
+	}
+
+	ps->step(1.0 / 60.0);
+	ps->flush_queries();
+
+	Physics2DDirectSpaceState *state = ps->space_get_direct_state(space);
+	bool pass = state && _compare_batch_2d(state, query, rids[3], false) && _compare_batch_2d(state, query, rids[3], true);
+
+	for (int i = rids.size() - 1; i >= 0; i--) {
+		ps->free(rids[i]);
+	}
+	ps->free(space);
+	return pass;
+}
+
+/* PACKED SEPARATING AXIS TESTS */
+
+enum {
+	SAT_POSES = 2000,
+};
+
+struct SATResult {
+
+	bool collided;
+	Vector3 axis;
+	Vector<Vector3> points; // A and B of every contact, interleaved
+};
+
+static void _add_sat_contact(const Vector3 &p_point_A, const Vector3 &p_point_B, void *p_userdata) {
+
+	Vector<Vector3> *points = (Vector<Vector3> *)p_userdata;
+	points->push_back(p_point_A);
+	points->push_back(p_point_B);
+}
+
+static void _solve_sat(const ShapeSW *p_shape_A, const Transform &p_xform_A, const ShapeSW *p_shape_B, const Transform &p_xform_B, real_t p_margin, SATResult &r_result) {
+
+	r_result.axis = Vector3();
+	r_result.points.clear();
+	r_result.collided = CollisionSolverSW::solve_static(p_shape_A, p_xform_A, p_shape_B, p_xform_B, _add_sat_contact, &r_result.points, &r_result.axis, p_margin, p_margin);
+}
+
+static bool _same_sat_result(const SATResult &p_packed, const SATResult &p_scalar) {
+
+	const real_t tolerance = 0.0001;
+
+	if (p_packed.collided != p_scalar.collided || p_packed.points.size() != p_scalar.points.size()) {
+		return false;
+	}
+	if (p_packed.axis.distance_to(p_scalar.axis) > tolerance) {
+		return false;
+	}
+	for (int i = 0; i < p_packed.points.size(); i++) {
+		if (p_packed.points[i].distance_to(p_scalar.points[i]) > tolerance) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// Every shape pair the packed axis tests cover, in both orders, with and
+// without margins, must give the same separation, axis and contacts as
+// projecting the axes one at a time.
+static bool test_packed_sat() {
+
+	BoxShapeSW box;
+	box.set_data(Vector3(0.5, 0.3, 0.7));
+
+	CapsuleShapeSW capsule;
+	Dictionary capsule_data;
+	capsule_data["radius"] = 0.4;
+	capsule_data["height"] = 1.0;
+	capsule.set_data(capsule_data);
+
+	Math::seed(35);
+
+	PoolVector<Vector3> prism_points;
+	PoolVector<Vector3> random_points;
+	for (int i = 0; i < 12; i++) {
+		real_t angle = Math_PI * 2.0 * i / 12;
+		prism_points.push_back(Vector3(Math::cos(angle) * 0.5, -0.5, Math::sin(angle) * 0.5));
+		prism_points.push_back(Vector3(Math::cos(angle) * 0.5, 0.5, Math::sin(angle) * 0.5));
+		random_points.push_back(Vector3(Math::randf() - 0.5, Math::randf() - 0.5, Math::randf() - 0.5));
+	}
+
+	ConvexPolygonShapeSW prism;
+	prism.set_data(prism_points);
+	ConvexPolygonShapeSW hull;
+	hull.set_data(random_points);
+
+	const ShapeSW *shapes[4] = { &box, &capsule, &prism, &hull };
+	const char *names[4] = { "box", "capsule", "prism", "hull" };
+
+	bool was_packed = sat_is_packed_axis_tests_enabled();
+	uint64_t packed_usec = 0;
+	uint64_t scalar_usec = 0;
+	int collided = 0;
+	int separated = 0;
+	bool pass = true;
+
+	for (int i = 0; i < SAT_POSES && pass; i++) {
+
+		Transform xform_A(Basis(Vector3(Math::randf(), Math::randf(), Math::randf()) * Math_PI * 2.0), Vector3());
+		Transform xform_B(Basis(Vector3(Math::randf(), Math::randf(), Math::randf()) * Math_PI * 2.0), Vector3(Math::randf() - 0.5, Math::randf() - 0.5, Math::randf() - 0.5) * 2.0);
+		real_t margin = (i % 4) == 0 ? 0.04 : 0.0;
+
+		for (int a = 0; a < 4 && pass; a++) {
+			for (int b = 0; b < 4; b++) {
+
+				SATResult packed;
+				SATResult scalar;
+
+				sat_set_packed_axis_tests(true);
+				uint64_t begin = OS::get_singleton()->get_ticks_usec();
+				_solve_sat(shapes[a], xform_A, shapes[b], xform_B, margin, packed);
+				packed_usec += OS::get_singleton()->get_ticks_usec() - begin;
+
+				sat_set_packed_axis_tests(false);
+				begin = OS::get_singleton()->get_ticks_usec();
+				_solve_sat(shapes[a], xform_A, shapes[b], xform_B, margin, scalar);
+				scalar_usec += OS::get_singleton()->get_ticks_usec() - begin;
+
+				if (!_same_sat_result(packed, scalar)) {
+					OS::get_singleton()->print("\t%s-%s differs at pose %d\n", names[a], names[b], i);
+					pass = false;
+					break;
+				}
+
+				if (packed.collided) {
+					collided++;
+				} else {
+					separated++;
+				}
+			}
+		}
+	}
+
+	sat_set_packed_axis_tests(was_packed);
+
+	CHECK(pass);
+	// the poses must cover both outcomes to mean anything
+	CHECK(collided > SAT_POSES);
+	CHECK(separated > SAT_POSES);
+
+	OS::get_singleton()->print("\t%d pairs, packed %d usec, scalar %d usec\n", collided + separated, (int)packed_usec, (int)scalar_usec);
+
+	return true;
+}
+
+/* SERVER SCENES */
+
+// What differs between the 3D and the 2D server for the scenes below.
+struct Scene3D {
+
+	typedef PhysicsServer Server;
+	typedef Vector3 Point;
+	typedef Transform Xform;
+
+	// the GodotPhysics internals, for scenes that step a single pair by hand
+	typedef SpaceSW Space;
+	typedef AreaSW Area;
+	typedef BodySW Body;
+	typedef BodyPairSW BodyPair;
+	typedef BoxShapeSW BoxShape;
+	typedef StepSW Step;
+	typedef IslandSW Island;
+	typedef ConstraintSW Constraint;
+	typedef ConstraintOrderSW ConstraintOrder;
+	typedef JointSW Joint;
+
+	static PhysicsServer *get_server() { return PhysicsServer::get_singleton(); }
+
+	static RID create_box_shape(const Vector3 &p_extents) {
+
+		RID shape = get_server()->shape_create(PhysicsServer::SHAPE_BOX);
+		get_server()->shape_set_data(shape, p_extents);
+		return shape;
+	}
+
+	static Transform make_transform(const Vector3 &p_origin) { return Transform(Basis(), p_origin); }
+	static Vector3 get_origin(const Transform &p_xform) { return p_xform.origin; }
+	static Vector3 make_point(real_t p_x, real_t p_y) { return Vector3(p_x, p_y, 0); }
+	static Vector3 make_extents(real_t p_half_size) { return Vector3(p_half_size, p_half_size, p_half_size); }
+
+	// pins the bodies together halfway between them
+	static JointSW *create_pin_joint(BodySW *p_a, BodySW *p_b) {
+
+		Vector3 pin = (p_a->get_transform().origin + p_b->get_transform().origin) * 0.5;
+		return memnew(PinJointSW(p_a, p_a->get_inv_transform().xform(pin), p_b, p_b->get_inv_transform().xform(pin)));
+	}
+
+	// the default area already pulls down at 9.8, as in a 3D world
+	static void setup_space(RID p_space) {}
+};
+
+struct Scene2D {
+
+	typedef Physics2DServer Server;
+	typedef Vector2 Point;
+	typedef Transform2D Xform;
+
+	typedef Space2DSW Space;
+	typedef Area2DSW Area;
+	typedef Body2DSW Body;
+	typedef BodyPair2DSW BodyPair;
+	typedef RectangleShape2DSW BoxShape;
+	typedef Step2DSW Step;
+	typedef Island2DSW Island;
+	typedef Constraint2DSW Constraint;
+	typedef ConstraintOrder2DSW ConstraintOrder;
+	typedef Joint2DSW Joint;
+
+	static Physics2DServer *get_server() { return Physics2DServer::get_singleton(); }
+
+	static RID create_box_shape(const Vector2 &p_extents) {
+
+		RID shape = get_server()->rectangle_shape_create();
+		get_server()->shape_set_data(shape, p_extents);
+		return shape;
+	}
+
+	static Transform2D make_transform(const Vector2 &p_origin) { return Transform2D(0, p_origin); }
+	static Vector2 get_origin(const Transform2D &p_xform) { return p_xform.get_origin(); }
+	static Vector2 make_point(real_t p_x, real_t p_y) { return Vector2(p_x, p_y); }
+	static Vector2 make_extents(real_t p_half_size) { return Vector2(p_half_size, p_half_size); }
+
+	static Joint2DSW *create_pin_joint(Body2DSW *p_a, Body2DSW *p_b) {
+
+		return memnew(PinJoint2DSW((p_a->get_transform().get_origin() + p_b->get_transform().get_origin()) * 0.5, p_a, p_b));
+	}
+
+	// as in a 2D world, y points down
+	static void setup_space(RID p_space) {
+
+		get_server()->area_set_param(p_space, Physics2DServer::AREA_PARAM_GRAVITY, 98);
+		get_server()->area_set_param(p_space, Physics2DServer::AREA_PARAM_GRAVITY_VECTOR, Vector2(0, 1));
+	}
+};
+
+// Boxes made through the 3D or the 2D server, in a space of their own that
+// is stepped by hand. There is no damping, so only the solver slows them down.
+template <class T>
+struct BoxScene {
+
+	typedef typename T::Server Server;
+
+	RID space;
+	Vector<RID> rids;
+
+	RID add_box(typename Server::BodyMode p_mode, const typename T::Point &p_extents, const typename T::Xform &p_xform) {
+
+		Server *ps = T::get_server();
+		RID shape = T::create_box_shape(p_extents);
+		RID body = ps->body_create();
+		ps->body_set_mode(body, p_mode);
+		ps->body_add_shape(body, shape);
+		ps->body_set_state(body, Server::BODY_STATE_TRANSFORM, p_xform);
+		ps->body_set_space(body, space);
+		rids.push_back(shape);
+		rids.push_back(body);
+		return body;
+	}
+
+	void step(int p_steps) {
+
+		Server *ps = T::get_server();
+		for (int i = 0; i < p_steps; i++) {
+			ps->step(1.0 / 60.0);
+			ps->flush_queries();
+		}
+	}
+
+	typename T::Xform get_transform(RID p_body) const {
+
+		return T::get_server()->body_get_state(p_body, Server::BODY_STATE_TRANSFORM);
+	}
+
+	typename T::Point get_origin(RID p_body) const {
+
+		return T::get_origin(get_transform(p_body));
+	}
+
+	BoxScene() {
+
+		Server *ps = T::get_server();
+		ps->set_active(true);
+		space = ps->space_create();
+		ps->space_set_active(space, true);
+		ps->area_set_param(space, Server::AREA_PARAM_LINEAR_DAMP, 0);
+		ps->area_set_param(space, Server::AREA_PARAM_ANGULAR_DAMP, 0);
+		T::setup_space(space);
+	}
+
+	~BoxScene() {
+
+		for (int i = rids.size() - 1; i >= 0; i--) {
+			T::get_server()->free(rids[i]);
+		}
+		T::get_server()->free(space);
+	}
+};
+
+/* CONTACT MANIFOLD */
+
+static bool test_contact_reduction() {
+
+	if (!PhysicsServerSW::singleton) {
+		OS::get_singleton()->print("\tSkipped, needs the GodotPhysics 3D engine.\n");
+		return true;
+	}
+
+	PhysicsServer *ps = PhysicsServer::get_singleton();
+
+	// the same box turned by 45 degrees sinks 0.01 into another one, the
+	// touching faces overlap in an octagon, 8 points for a 4 point manifold
+	BoxScene<Scene3D> scene;
+	scene.add_box(PhysicsServer::BODY_MODE_STATIC, Vector3(1, 0.5, 1), Transform(Basis(), Vector3(0, -0.5, 0)));
+	RID box = scene.add_box(PhysicsServer::BODY_MODE_RIGID, Vector3(1, 0.5, 1), Transform(Basis(Vector3(0, 1, 0), Math_PI / 4), Vector3(0, 0.49, 0)));
+	ps->body_set_max_contacts_reported(box, 8);
+
+	// the pair is found at the end of the first step
+	scene.step(2);
+
+	PhysicsDirectBodyState *state = ps->body_get_direct_state(box);
+	CHECK(state);
+	CHECK(state->get_contact_count() == 4);
+
+	Vector3 p[4];
+	for (int i = 0; i < 4; i++) {
+		p[i] = state->get_contact_local_position(i);
+		p[i].y = 0;
+	}
+
+	// whatever order the points come in, the kept ones must span much more than
+	// four neighbouring corners do (a quarter of the octagon)
+	real_t area = (p[0] - p[1]).cross(p[2] - p[3]).length();
+	area = MAX(area, (p[0] - p[2]).cross(p[1] - p[3]).length());
+	area = MAX(area, (p[0] - p[3]).cross(p[1] - p[2]).length());
+	area *= 0.5;
+
+	real_t corner = 1 - (Math_SQRT2 - 1);
+	real_t octagon_area = 4 - 2 * corner * corner;
+	CHECK(area > octagon_area * 0.4);
+
+	return true;
+}
+
+// How far the top of a stack of boxes sank after settling.
+static real_t _stack_sag(real_t p_warm_start_factor) {
+
+	const int boxes = 8;
+	const String setting = "physics/3d/godot_physics/contact_warm_start_factor";
+
+	// the space reads the factor when it's created
+	Variant factor = ProjectSettings::get_singleton()->get_setting(setting);
+	ProjectSettings::get_singleton()->set_setting(setting, p_warm_start_factor);
+	BoxScene<Scene3D> scene;
+	ProjectSettings::get_singleton()->set_setting(setting, factor);
+
+	scene.add_box(PhysicsServer::BODY_MODE_STATIC, Vector3(10, 1, 10), Transform(Basis(), Vector3(0, -1, 0)));
+
+	RID top;
+	for (int i = 0; i < boxes; i++) {
+		top = scene.add_box(PhysicsServer::BODY_MODE_RIGID, Vector3(0.5, 0.5, 0.5), Transform(Basis(), Vector3(0, 0.5 + i, 0)));
+	}
+
+	scene.step(240);
+
+	return boxes - 0.5 - scene.get_origin(top).y;
+}
+
+static bool test_warm_starting() {
+
+	if (!PhysicsServerSW::singleton) {
+		OS::get_singleton()->print("\tSkipped, needs the GodotPhysics 3D engine.\n");
+		return true;
+	}
+
+	// with the impulses of the previous step as a start, the default iterations
+	// hold the stack up, starting from zero they can't and it sinks further
+	real_t warm = _stack_sag(1.0);
+	real_t cold = _stack_sag(0.0);
+	OS::get_singleton()->print("\tstack of 8 sinks %f warm started, %f cold\n", warm, cold);
+
+	CHECK(warm >= 0 && warm < 0.25);
+	CHECK(warm < cold);
+
+	return true;
+}
+
+/* SNAPSHOTS */
+
+// Records where the bodies are and how fast they move after some steps.
+template <class T>
+static void _record_snapshot_run(BoxScene<T> &p_scene, const Vector<RID> &p_bodies, Vector<typename T::Xform> &r_xforms, Vector<typename T::Point> &r_velocities) {
+
+	p_scene.step(30);
+
+	for (int i = 0; i < p_bodies.size(); i++) {
+		r_xforms.push_back(p_scene.get_transform(p_bodies[i]));
+		r_velocities.push_back(T::get_server()->body_get_state(p_bodies[i], T::Server::BODY_STATE_LINEAR_VELOCITY));
+	}
+}
+
+// Save, step, restore and step again, the second run has to match the first
+// bit for bit. A broken snapshot is refused and leaves the space alone.
+template <class T>
+static bool _check_snapshot(BoxScene<T> &p_scene, const Vector<RID> &p_bodies) {
+
+	typename T::Server *ps = T::get_server();
+
+	// let the pile start tumbling, so the snapshot has contacts to carry
+	p_scene.step(20);
+	PoolVector<uint8_t> snapshot = ps->space_get_snapshot(p_scene.space);
+	CHECK(snapshot.size() > 0);
+
+	Vector<typename T::Xform> first_xforms, second_xforms;
+	Vector<typename T::Point> first_velocities, second_velocities;
+	_record_snapshot_run(p_scene, p_bodies, first_xforms, first_velocities);
+
+	CHECK(ps->space_restore_snapshot(p_scene.space, snapshot) == OK);
+	_record_snapshot_run(p_scene, p_bodies, second_xforms, second_velocities);
+
+	for (int i = 0; i < p_bodies.size(); i++) {
+		CHECK(first_xforms[i] == second_xforms[i]);
+		CHECK(first_velocities[i] == second_velocities[i]);
+	}
+
+	typename T::Xform before = p_scene.get_transform(p_bodies[0]);
+
+	PoolVector<uint8_t> truncated = snapshot;
+	truncated.resize(snapshot.size() - 1);
+	CHECK(ps->space_restore_snapshot(p_scene.space, truncated) == ERR_FILE_CORRUPT);
+
+	PoolVector<uint8_t> garbage = snapshot;
+	garbage.set(0, garbage[0] ^ 0xFF);
+	CHECK(ps->space_restore_snapshot(p_scene.space, garbage) == ERR_FILE_CORRUPT);
+
+	CHECK(p_scene.get_transform(p_bodies[0]) == before);
+
+	return true;
+}
+
+static bool test_snapshot_3d() {
+
+	if (!PhysicsServerSW::singleton) {
+		OS::get_singleton()->print("\tSkipped, needs the GodotPhysics 3D engine.\n");
+		return true;
+	}
+
+	BoxScene<Scene3D> scene;
+	scene.add_box(PhysicsServer::BODY_MODE_STATIC, Vector3(10, 1, 10), Transform(Basis(), Vector3(0, -1, 0)));
+
+	Vector<RID> bodies;
+	for (int i = 0; i < 6; i++) {
+		Basis basis(Vector3(0.3 * i, 0.7 * i, 0.1 * i));
+		bodies.push_back(scene.add_box(PhysicsServer::BODY_MODE_RIGID, Vector3(0.5, 0.5, 0.5), Transform(basis, Vector3(0.3 * (i % 3), 0.6 + i * 1.1, 0.2 * (i % 2)))));
+	}
+
+	return _check_snapshot(scene, bodies);
+}
+
+static bool test_snapshot_2d() {
+
+	BoxScene<Scene2D> scene;
+	scene.add_box(Physics2DServer::BODY_MODE_STATIC, Vector2(100, 10), Transform2D(0, Vector2(0, 10)));
+
+	Vector<RID> bodies;
+	for (int i = 0; i < 6; i++) {
+		bodies.push_back(scene.add_box(Physics2DServer::BODY_MODE_RIGID, Vector2(5, 5), Transform2D(0.4 * i, Vector2(3 * (i % 3), -6 - i * 11))));
+	}
+
+	return _check_snapshot(scene, bodies);
+}
+
+/* CONCAVE POLYGON */
+
+static bool test_concave_faces() {
+
+	// a bumpy grid of triangles given out of spatial order, so the tree has to reorder them
+	const int side = 16;
+	PoolVector<Vector3> faces;
+	for (int k = 0; k < side * side; k++) {
+		int cell = (k * 37) % (side * side);
+		int x = cell % side;
+		int z = cell / side;
+		Vector3 a(x, Math::sin(x * 0.7) * 0.5, z);
+		Vector3 b(x + 1, Math::sin((x + 1) * 0.7) * 0.5, z);
+		Vector3 c(x, Math::sin(x * 0.7) * 0.5, z + 1);
+		Vector3 d(x + 1, Math::sin((x + 1) * 0.7) * 0.5, z + 1);
+		faces.push_back(a);
+		faces.push_back(b);
+		faces.push_back(c);
+		faces.push_back(b);
+		faces.push_back(d);
+		faces.push_back(c);
+	}
+
+	ConcavePolygonShapeSW shape;
+	shape.set_data(faces);
+	PoolVector<Vector3> result = shape.get_faces();
+	CHECK(result.size() == faces.size());
+	for (int i = 0; i < faces.size(); i++) {
+		CHECK(result[i] == faces[i]);
+	}
+	CHECK(PoolVector<Vector3>(shape.get_data()).size() == faces.size());
+
+	// the tree still finds the faces
+	Vector3 point, normal;
+	CHECK(shape.intersect_segment(Vector3(3.25, 5, 7.4), Vector3(3.25, -5, 7.4), point, normal));
+	CHECK(Math::is_equal_approx(point.x, (real_t)3.25) && Math::is_equal_approx(point.z, (real_t)7.4));
+	CHECK(Math::abs(point.y - Math::lerp(Math::sin(3 * 0.7) * 0.5, Math::sin(4 * 0.7) * 0.5, 0.25)) < 0.001);
+
+	// and so does the server
+	PhysicsServer *ps = PhysicsServer::get_singleton();
+	RID rid = ps->shape_create(PhysicsServer::SHAPE_CONCAVE_POLYGON);
+	ps->shape_set_data(rid, faces);
+	result = ps->shape_get_data(rid);
+	ps->free(rid);
+	CHECK(result.size() == faces.size());
+	for (int i = 0; i < faces.size(); i++) {
+		CHECK(result[i] == faces[i]);
+	}
+
+	return true;
+}
+
+/* STATE SYNC */
+
+// What the state sync callback was handed, checked against the direct state
+// of the same body at the time of the call.
+struct StateSyncCheck {
+
+	Map<ObjectID, RID> bodies;
+	int calls;
+	int largest_batch;
+	int mismatches;
+	int asleep;
+};
+
+static StateSyncCheck state_sync_check;
+
+static void _check_synced_states(const PhysicsServer::BodyStateSync *p_states, int p_count) {
+
+	state_sync_check.calls++;
+	state_sync_check.largest_batch = MAX(state_sync_check.largest_batch, p_count);
+
+	for (int i = 0; i < p_count; i++) {
+
+		const PhysicsServer::BodyStateSync &synced = p_states[i];
+		PhysicsDirectBodyState *direct = PhysicsServer::get_singleton()->body_get_direct_state(state_sync_check.bodies[synced.instance_id]);
+
+		if (synced.transform != direct->get_transform() ||
+				synced.linear_velocity != direct->get_linear_velocity() ||
+				synced.angular_velocity != direct->get_angular_velocity() ||
+				synced.inverse_inertia_tensor != direct->get_inverse_inertia_tensor() ||
+				synced.sleeping != direct->is_sleeping()) {
+			state_sync_check.mismatches++;
+		}
+
+		if (synced.sleeping) {
+			state_sync_check.asleep++;
+		}
+	}
+}
+
+static bool test_state_sync() {
+
+	PhysicsServer *ps = PhysicsServer::get_singleton();
+	Object *receivers[2] = { memnew(Object), memnew(Object) };
+
+	state_sync_check.bodies.clear();
+	state_sync_check.calls = 0;
+	state_sync_check.largest_batch = 0;
+	state_sync_check.mismatches = 0;
+	state_sync_check.asleep = 0;
+
+	// long enough for both engines to put the pile to sleep
+	const int steps = 360;
+	bool resting_asleep;
+
+	{
+		// one box settles and falls asleep, the other one lands on it tumbling
+		BoxScene<Scene3D> scene;
+		scene.add_box(PhysicsServer::BODY_MODE_STATIC, Vector3(10, 1, 10), Transform(Basis(), Vector3(0, -1, 0)));
+		RID resting = scene.add_box(PhysicsServer::BODY_MODE_RIGID, Vector3(0.5, 0.5, 0.5), Transform(Basis(), Vector3(0, 0.5, 0)));
+		RID falling = scene.add_box(PhysicsServer::BODY_MODE_RIGID, Vector3(0.5, 0.5, 0.5), Transform(Basis(Vector3(0.3, 0.2, 0.1)), Vector3(0.4, 3, 0)));
+
+		state_sync_check.bodies[receivers[0]->get_instance_id()] = resting;
+		state_sync_check.bodies[receivers[1]->get_instance_id()] = falling;
+		ps->body_set_state_sync_callback(resting, receivers[0], _check_synced_states);
+		ps->body_set_state_sync_callback(falling, receivers[1], _check_synced_states);
+
+		scene.step(steps);
+		resting_asleep = ps->body_get_direct_state(resting)->is_sleeping();
+	}
+
+	memdelete(receivers[0]);
+	memdelete(receivers[1]);
+
+	// all the moved bodies of a step come in one call
+	CHECK(state_sync_check.calls > 0 && state_sync_check.calls <= steps);
+	CHECK(state_sync_check.largest_batch == 2);
+	CHECK(state_sync_check.mismatches == 0);
+	CHECK(state_sync_check.asleep > 0);
+	CHECK(resting_asleep);
+
+	return true;
+}
+
+/* SOFT BODIES */
+
+// A square of cloth in the xz plane, p_size points a side, point i is vertex i.
+static Ref<ArrayMesh> _make_cloth_mesh(int p_size, real_t p_extent) {
+
+	PoolVector<Vector3> vertices;
+	PoolVector<int> indices;
+
+	for (int i = 0; i < p_size; i++) {
+		for (int j = 0; j < p_size; j++) {
+			vertices.push_back(Vector3(j * p_extent / (p_size - 1) - p_extent * 0.5, 0, i * p_extent / (p_size - 1) - p_extent * 0.5));
+		}
+	}
+
+	for (int i = 0; i < p_size - 1; i++) {
+		for (int j = 0; j < p_size - 1; j++) {
+			int v = i * p_size + j;
+			indices.push_back(v);
+			indices.push_back(v + 1);
+			indices.push_back(v + p_size);
+			indices.push_back(v + 1);
+			indices.push_back(v + p_size + 1);
+			indices.push_back(v + p_size);
+		}
+	}
+
+	Array arrays;
+	arrays.resize(VS::ARRAY_MAX);
+	arrays[VS::ARRAY_VERTEX] = vertices;
+	arrays[VS::ARRAY_INDEX] = indices;
+
+	Ref<ArrayMesh> mesh;
+	mesh.instance();
+	mesh->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, arrays);
+	return mesh;
+}
+
+static bool test_soft_body_api() {
+
+	if (!PhysicsServerSW::singleton) {
+		OS::get_singleton()->print("\tSkipped, needs the GodotPhysics 3D engine.\n");
+		return true;
+	}
+
+	PhysicsServer *ps = PhysicsServer::get_singleton();
+	const int size = 5;
+	Ref<ArrayMesh> mesh = _make_cloth_mesh(size, 2.0);
+	PoolVector<Vector3> vertices = mesh->surface_get_arrays(0)[VS::ARRAY_VERTEX];
+
+	RID cloth = ps->soft_body_create();
+	ps->soft_body_set_mesh(cloth, mesh);
+	Transform xform(Basis(Vector3(0, 1, 0), 0.5), Vector3(1, 2, 3));
+	ps->soft_body_set_transform(cloth, xform);
+
+	for (int i = 0; i < size * size; i++) {
+		CHECK(ps->soft_body_get_point_offset(cloth, i) == vertices[i]);
+		CHECK(ps->soft_body_get_point_global_position(cloth, i).is_equal_approx(xform.xform(vertices[i])));
+	}
+
+	ps->soft_body_move_point(cloth, 7, Vector3(4, 5, 6));
+	CHECK(ps->soft_body_get_point_global_position(cloth, 7) == Vector3(4, 5, 6));
+
+	ps->soft_body_pin_point(cloth, 0, true);
+	ps->soft_body_pin_point(cloth, 4, true);
+	ps->soft_body_pin_point(cloth, 4, true);
+	CHECK(ps->soft_body_is_point_pinned(cloth, 0));
+	CHECK(ps->soft_body_is_point_pinned(cloth, 4));
+	CHECK(!ps->soft_body_is_point_pinned(cloth, 1));
+	ps->soft_body_pin_point(cloth, 0, false);
+	CHECK(!ps->soft_body_is_point_pinned(cloth, 0));
+	CHECK(ps->soft_body_is_point_pinned(cloth, 4));
+	ps->soft_body_remove_all_pinned_points(cloth);
+	CHECK(!ps->soft_body_is_point_pinned(cloth, 4));
+
+	ps->soft_body_set_linear_stiffness(cloth, 0.25);
+	CHECK(ps->soft_body_get_linear_stiffness(cloth) == (real_t)0.25);
+	ps->soft_body_set_areaAngular_stiffness(cloth, 0.75);
+	CHECK(ps->soft_body_get_areaAngular_stiffness(cloth) == (real_t)0.75);
+	ps->soft_body_set_volume_stiffness(cloth, 0.125);
+	CHECK(ps->soft_body_get_volume_stiffness(cloth) == (real_t)0.125);
+	ps->soft_body_set_linear_stiffness(cloth, 2);
+	CHECK(ps->soft_body_get_linear_stiffness(cloth) == 1);
+
+	ps->soft_body_set_damping_coefficient(cloth, 0.5);
+	CHECK(ps->soft_body_get_damping_coefficient(cloth) == (real_t)0.5);
+	ps->soft_body_set_drag_coefficient(cloth, 0.25);
+	CHECK(ps->soft_body_get_drag_coefficient(cloth) == (real_t)0.25);
+	ps->soft_body_set_pressure_coefficient(cloth, 3);
+	CHECK(ps->soft_body_get_pressure_coefficient(cloth) == 3);
+	ps->soft_body_set_total_mass(cloth, 4);
+	CHECK(ps->soft_body_get_total_mass(cloth) == 4);
+	ps->soft_body_set_simulation_precision(cloth, 9);
+	CHECK(ps->soft_body_get_simulation_precision(cloth) == 9);
+
+	ps->free(cloth);
+
+	return true;
+}
+
+static bool test_soft_body_pinning() {
+
+	if (!PhysicsServerSW::singleton) {
+		OS::get_singleton()->print("\tSkipped, needs the GodotPhysics 3D engine.\n");
+		return true;
+	}
+
+	PhysicsServer *ps = PhysicsServer::get_singleton();
+	const int size = 9;
+
+	// hung by the two corners of its first row, the far row swings down
+	BoxScene<Scene3D> scene;
+	RID cloth = ps->soft_body_create();
+	ps->soft_body_set_space(cloth, scene.space);
+	ps->soft_body_set_mesh(cloth, _make_cloth_mesh(size, 2.0));
+	ps->soft_body_set_transform(cloth, Transform(Basis(), Vector3(0, 5, 0)));
+	ps->soft_body_pin_point(cloth, 0, true);
+	ps->soft_body_pin_point(cloth, size - 1, true);
+
+	Vector3 pinned_a = ps->soft_body_get_point_global_position(cloth, 0);
+	Vector3 pinned_b = ps->soft_body_get_point_global_position(cloth, size - 1);
+	Vector3 far_corner = ps->soft_body_get_point_global_position(cloth, size * (size - 1));
+
+	scene.step(120);
+
+	bool pinned_stayed = ps->soft_body_get_point_global_position(cloth, 0) == pinned_a && ps->soft_body_get_point_global_position(cloth, size - 1) == pinned_b;
+	real_t far_drop = far_corner.y - ps->soft_body_get_point_global_position(cloth, size * (size - 1)).y;
+
+	// a pinned point only moves when it's moved by hand
+	Vector3 moved = pinned_a + Vector3(0, 0.5, 0);
+	ps->soft_body_move_point(cloth, 0, moved);
+	scene.step(10);
+	bool pinned_moved = ps->soft_body_get_point_global_position(cloth, 0) == moved;
+
+	ps->free(cloth);
+
+	CHECK(pinned_stayed);
+	CHECK(far_drop > 1);
+	CHECK(pinned_moved);
+
+	return true;
+}
+
+static bool test_soft_body_collision() {
+
+	if (!PhysicsServerSW::singleton) {
+		OS::get_singleton()->print("\tSkipped, needs the GodotPhysics 3D engine.\n");
+		return true;
+	}
+
+	PhysicsServer *ps = PhysicsServer::get_singleton();
+	const int size = 17;
+	const int center = (size / 2) * size + size / 2;
+
+	// dropped from half a meter onto a unit sphere, no particle may end up inside it
+	BoxScene<Scene3D> scene;
+	RID sphere_shape = ps->shape_create(PhysicsServer::SHAPE_SPHERE);
+	ps->shape_set_data(sphere_shape, 1.0);
+	RID sphere = ps->body_create(PhysicsServer::BODY_MODE_STATIC);
+	ps->body_add_shape(sphere, sphere_shape);
+	ps->body_set_space(sphere, scene.space);
+	scene.rids.push_back(sphere_shape);
+	scene.rids.push_back(sphere);
+
+	RID cloth = ps->soft_body_create();
+	ps->soft_body_set_space(cloth, scene.space);
+	ps->soft_body_set_mesh(cloth, _make_cloth_mesh(size, 4.0));
+	ps->soft_body_set_transform(cloth, Transform(Basis(), Vector3(0, 1.5, 0)));
+
+	real_t closest = 1e10;
+	for (int i = 0; i < 240; i++) {
+		scene.step(1);
+		for (int j = 0; j < size * size; j++) {
+			closest = MIN(closest, ps->soft_body_get_point_global_position(cloth, j).length());
+		}
+	}
+
+	real_t top = ps->soft_body_get_point_global_position(cloth, center).y;
+
+	ps->free(cloth);
+
+	OS::get_singleton()->print("\tclosest particle %f from the center, the middle of the cloth rests at %f\n", closest, top);
+
+	CHECK(closest >= 1);
+	CHECK(top >= 1 && top < 1.05);
+
+	return true;
+}
+
+/* CONTINUOUS COLLISION DETECTION */
+
+// A box resting on a static floor, made from the GodotPhysics internals so a
+// single body pair can be stepped by hand.
+template <class T>
+struct BoxOnFloor {
+
+	typedef typename T::Server Server;
+
+	typename T::Space *space;
+	typename T::BoxShape floor_shape;
+	typename T::BoxShape box_shape;
+	typename T::Body *floor;
+	typename T::Body *box;
+	typename T::BodyPair *pair;
+
+	BoxOnFloor(const typename T::Point &p_floor_extents, const typename T::Point &p_floor_origin, const typename T::Point &p_box_extents, const typename T::Point &p_box_origin) {
+
+		space = memnew(typename T::Space);
+		floor_shape.set_data(p_floor_extents);
+		box_shape.set_data(p_box_extents);
+
+		floor = memnew(typename T::Body);
+		floor->set_mode(Server::BODY_MODE_STATIC);
+		floor->add_shape(&floor_shape);
+		floor->set_state(Server::BODY_STATE_TRANSFORM, T::make_transform(p_floor_origin));
+		floor->set_space(space);
+
+		box = memnew(typename T::Body);
+		box->add_shape(&box_shape);
+		box->set_state(Server::BODY_STATE_TRANSFORM, T::make_transform(p_box_origin));
+		box->set_space(space);
+		box->update_inertias();
+
+		pair = memnew(typename T::BodyPair(box, 0, floor, 0));
+	}
+
+	~BoxOnFloor() {
+
+		memdelete(pair);
+		box->set_space(NULL);
+		floor->set_space(NULL);
+		box->remove_shape(0);
+		floor->remove_shape(0);
+		memdelete(box);
+		memdelete(floor);
+		memdelete(space);
+	}
+};
+
+// how far a fast box moves in one step from p_origin, with the floor as the only pair
+static Vector3 _ccd_motion_3d(const Vector3 &p_origin, const Vector3 &p_velocity) {
+
+	const real_t step = 1.0 / 60.0;
+
+	BoxOnFloor<Scene3D> scene(Vector3(4, 1, 4), Vector3(0, -1, 0), Vector3(0.5, 0.5, 0.5), p_origin);
+	scene.box->set_continuous_collision_detection(true);
+	scene.box->set_linear_velocity(p_velocity);
+	scene.pair->setup(step);
+	scene.box->integrate_velocities(step);
+
+	return scene.box->get_transform().origin - p_origin;
+}
+
+static bool test_ccd_3d() {
+
+	if (!PhysicsServerSW::singleton) {
+		OS::get_singleton()->print("\tSkipped, needs the GodotPhysics 3D engine.\n");
+		return true;
+	}
+
+	// 0.005 above the floor is closer than the allowed penetration, but not touching
+	Vector3 resting(0, 0.505, 0);
+
+	CHECK(_ccd_motion_3d(resting, Vector3(60, 0, 0)).is_equal_approx(Vector3(1, 0, 0)));
+	CHECK(_ccd_motion_3d(resting, Vector3(0, 0, -60)).is_equal_approx(Vector3(0, 0, -1)));
+	CHECK(_ccd_motion_3d(resting, Vector3(0, 60, 0)).is_equal_approx(Vector3(0, 1, 0)));
+	CHECK(_ccd_motion_3d(resting, Vector3(60, 30, 0)).is_equal_approx(Vector3(1, 0.5, 0)));
+
+	// falling from 2.5 above, 10 in one step, still stops at the floor
+	Vector3 fall = _ccd_motion_3d(Vector3(0, 3, 0), Vector3(0, -600, 0));
+	CHECK(fall.y < -2.45 && fall.y > -2.6);
+
+	return true;
+}
+
+static Vector2 _ccd_motion_2d(const Vector2 &p_origin, const Vector2 &p_velocity) {
+
+	const real_t step = 1.0 / 60.0;
+
+	BoxOnFloor<Scene2D> scene(Vector2(256, 16), Vector2(0, 16), Vector2(16, 16), p_origin);
+	scene.box->set_continuous_collision_detection_mode(Physics2DServer::CCD_MODE_CAST_RAY);
+	scene.box->set_linear_velocity(p_velocity);
+	scene.pair->setup(step);
+	scene.box->integrate_velocities(step);
+
+	return scene.box->get_transform().get_origin() - p_origin;
+}
+
+static bool test_ccd_2d() {
+
+	// 0.1 above the floor is closer than the allowed penetration, but not touching
+	Vector2 resting(0, -16.1);
+
+	CHECK(_ccd_motion_2d(resting, Vector2(3600, 0)).distance_to(Vector2(60, 0)) < 0.01);
+	CHECK(_ccd_motion_2d(resting, Vector2(-3600, 0)).distance_to(Vector2(-60, 0)) < 0.01);
+	CHECK(_ccd_motion_2d(resting, Vector2(0, -3600)).distance_to(Vector2(0, -60)) < 0.01);
+	CHECK(_ccd_motion_2d(resting, Vector2(3600, -1800)).distance_to(Vector2(60, -30)) < 0.01);
+
+	// falling from 184 above, 600 in one step, still stops at the floor
+	Vector2 fall = _ccd_motion_2d(Vector2(0, -200), Vector2(0, 36000));
+	CHECK(fall.y > 183 && fall.y < 186);
+
+	return true;
+}
+
+/* ISLANDS */
+
+// Boxes in a space of their own, stepped through the GodotPhysics internals so
+// the islands kept by the stepper can be looked at. The bodies get RIDs, as the
+// constraint order depends on them.
+template <class T>
+struct IslandScene {
+
+	typedef typename T::Server Server;
+	typedef typename T::Body Body;
+	typedef typename T::Joint Joint;
+
+	typename T::Space *space;
+	typename T::Area *area;
+	typename T::Step *stepper;
+	typename T::BoxShape box_shape;
+	RID_Owner<Body> body_owner;
+	Vector<Body *> bodies;
+	Vector<Joint *> joints;
+
+	IslandScene(const typename T::Point &p_box_extents, real_t p_gravity) {
+
+		space = memnew(typename T::Space);
+		area = memnew(typename T::Area);
+		area->set_param(Server::AREA_PARAM_GRAVITY, p_gravity);
+		area->set_space(space);
+		area->set_priority(-1);
+		space->set_default_area(area);
+		stepper = memnew(typename T::Step);
+		box_shape.set_data(p_box_extents);
+	}
+
+	Body *add_box(typename Server::BodyMode p_mode, const typename T::Point &p_origin) {
+
+		Body *body = memnew(Body);
+		body->set_self(body_owner.make_rid(body));
+		body->set_mode(p_mode);
+		body->add_shape(&box_shape);
+		body->set_state(Server::BODY_STATE_TRANSFORM, T::make_transform(p_origin));
+		body->set_space(space);
+		bodies.push_back(body);
+		return body;
+	}
+
+	Joint *add_joint(Body *p_a, Body *p_b) {
+
+		Joint *joint = T::create_pin_joint(p_a, p_b);
+		joints.push_back(joint);
+		return joint;
+	}
+
+	void remove_joint(Joint *p_joint) {
+
+		for (int i = 0; i < p_joint->get_body_count(); i++) {
+			p_joint->get_body_ptr()[i]->remove_constraint(p_joint);
+		}
+		joints.erase(p_joint);
+		memdelete(p_joint);
+	}
+
+	void step(int p_steps) {
+
+		for (int i = 0; i < p_steps; i++) {
+			stepper->step(space, 1.0 / 60.0, 8);
+		}
+	}
+
+	~IslandScene() {
+
+		while (joints.size()) {
+			remove_joint(joints[joints.size() - 1]);
+		}
+		for (int i = bodies.size() - 1; i >= 0; i--) {
+			bodies[i]->set_space(NULL);
+			bodies[i]->remove_shape(0);
+			body_owner.free(bodies[i]->get_self());
+			memdelete(bodies[i]);
+		}
+		memdelete(stepper);
+		area->set_space(NULL);
+		memdelete(area);
+		memdelete(space);
+	}
+};
+
+// Checks the islands that were populated against the ones a rebuild would find:
+// every body connected to a rigid body through constraints, without going through
+// static or kinematic bodies, and all their constraints in the constraint map order.
+template <class T>
+static bool _check_islands(const IslandScene<T> &p_scene) {
+
+	for (int i = 0; i < p_scene.bodies.size(); i++) {
+
+		typename T::Body *body = p_scene.bodies[i];
+		typename T::Island *island = body->get_island();
+		if (body->get_mode() <= T::Server::BODY_MODE_KINEMATIC) {
+			CHECK(!island);
+			continue;
+		}
+		if (!island || island->dirty) {
+			continue; // not populated yet, or asleep since it changed
+		}
+
+		Vector<typename T::Body *> found;
+		Vector<typename T::Constraint *> constraints;
+		found.push_back(body);
+		for (int j = 0; j < found.size(); j++) {
+			for (const typename T::Body::ConstraintMap::Element *E = found[j]->get_constraint_map().front(); E; E = E->next()) {
+
+				typename T::Constraint *c = E->key();
+				if (constraints.find(c) != -1) {
+					continue;
+				}
+				constraints.push_back(c);
+				for (int k = 0; k < c->get_body_count(); k++) {
+					typename T::Body *b = c->get_body_ptr()[k];
+					if (b->get_mode() > T::Server::BODY_MODE_KINEMATIC && found.find(b) == -1) {
+						found.push_back(b);
+					}
+				}
+			}
+		}
+		constraints.template sort_custom<typename T::ConstraintOrder>();
+
+		CHECK(island->users == (uint32_t)found.size());
+		CHECK(island->bodies.size() == (uint32_t)found.size());
+		for (int j = 0; j < found.size(); j++) {
+			CHECK(found[j]->get_island() == island);
+		}
+		CHECK(island->constraints.size() == (uint32_t)constraints.size());
+		for (int j = 0; j < constraints.size(); j++) {
+			CHECK(island->constraints[j] == constraints[j]);
+		}
+	}
+
+	return true;
+}
+
+// Lengths are in boxes, p_unit is the size of one.
+template <class T>
+static bool _check_island_changes(real_t p_unit) {
+
+	typedef typename T::Server Server;
+	typedef typename T::Body Body;
+
+	IslandScene<T> scene(T::make_extents(0.5 * p_unit), 0);
+
+	// three boxes in a row, too far apart to touch, pinned together
+	Body *a = scene.add_box(Server::BODY_MODE_RIGID, T::make_point(0, 0) * p_unit);
+	Body *b = scene.add_box(Server::BODY_MODE_RIGID, T::make_point(3, 0) * p_unit);
+	Body *c = scene.add_box(Server::BODY_MODE_RIGID, T::make_point(6, 0) * p_unit);
+	Body *d = scene.add_box(Server::BODY_MODE_RIGID, T::make_point(6, 10) * p_unit);
+	scene.add_joint(a, b);
+	typename T::Joint *joint_bc = scene.add_joint(b, c);
+
+	scene.step(1);
+	CHECK(_check_islands(scene));
+	CHECK(a->get_island() && a->get_island() == b->get_island() && b->get_island() == c->get_island());
+	CHECK(a->get_island()->constraints.size() == 2);
+	CHECK(d->get_island() && d->get_island() != a->get_island());
+
+	// removing a joint splits the island, one side keeps the island object
+	typename T::Island *island = a->get_island();
+	scene.remove_joint(joint_bc);
+	CHECK(island->dirty);
+	scene.step(1);
+	CHECK(_check_islands(scene));
+	CHECK(a->get_island() == b->get_island());
+	CHECK(c->get_island() != a->get_island());
+	CHECK(a->get_island() == island || c->get_island() == island);
+
+	// a pair appearing merges the islands, the pair is added at the end of the step
+	d->set_state(Server::BODY_STATE_TRANSFORM, T::make_transform(T::make_point(6, 0.95) * p_unit));
+	scene.step(2);
+	CHECK(_check_islands(scene));
+	CHECK(c->get_island() == d->get_island());
+	CHECK(c->get_island()->constraints.size() == 1);
+
+	// and removing it splits them again
+	d->set_state(Server::BODY_STATE_TRANSFORM, T::make_transform(T::make_point(6, 10) * p_unit));
+	scene.step(2);
+	CHECK(_check_islands(scene));
+	CHECK(c->get_island() != d->get_island());
+	CHECK(c->get_island()->constraints.size() == 0);
+
+	// static bodies stay out of islands, until they become rigid
+	Body *s = scene.add_box(Server::BODY_MODE_STATIC, T::make_point(0, -3) * p_unit);
+	scene.add_joint(a, s);
+	scene.step(1);
+	CHECK(_check_islands(scene));
+	CHECK(!s->get_island());
+	CHECK(a->get_island()->constraints.size() == 2);
+
+	s->set_mode(Server::BODY_MODE_RIGID);
+	scene.step(1);
+	CHECK(_check_islands(scene));
+	CHECK(s->get_island() == a->get_island());
+	CHECK(a->get_island()->bodies.size() == 3);
+
+	// sleeping islands aren't populated, even when they changed
+	a->set_active(false);
+	b->set_active(false);
+	s->set_active(false);
+	a->invalidate_island();
+	uint64_t island_step = a->get_island_step();
+	scene.step(1);
+	CHECK(a->get_island()->dirty);
+	CHECK(a->get_island_step() == island_step);
+	CHECK(c->get_island_step() != island_step);
+
+	a->set_active(true);
+	scene.step(1);
+	CHECK(!a->get_island()->dirty);
+	CHECK(_check_islands(scene));
+
+	return true;
+}
+
+// Steps a pile of boxes twice, the second time throwing the islands away before
+// every step, as they were before they were kept. Both must end up the same.
+template <class T>
+static bool _check_island_rebuild(real_t p_unit) {
+
+	typedef typename T::Server Server;
+	typedef typename T::Body Body;
+
+	IslandScene<T> kept(T::make_extents(0.5 * p_unit), 9.8 * p_unit);
+	IslandScene<T> rebuilt(T::make_extents(0.5 * p_unit), 9.8 * p_unit);
+	IslandScene<T> *scenes[2] = { &kept, &rebuilt };
+
+	for (int i = 0; i < 2; i++) {
+
+		IslandScene<T> &scene = *scenes[i];
+		for (int j = -4; j <= 4; j++) {
+			scene.add_box(Server::BODY_MODE_STATIC, T::make_point(j, -1) * p_unit);
+		}
+
+		// staggered columns that topple onto each other, some of them pinned in pairs
+		for (int j = 0; j < 12; j++) {
+			scene.add_box(Server::BODY_MODE_RIGID, T::make_point((j % 4) * 1.3 - 2 + j * 0.05, 1 + (j / 4) * 1.2) * p_unit);
+		}
+		for (int j = 9; j < scene.bodies.size() - 4; j += 3) {
+			scene.add_joint(scene.bodies[j], scene.bodies[j + 4]);
+		}
+	}
+
+	for (int i = 0; i < 240; i++) {
+
+		for (int j = 0; j < rebuilt.bodies.size(); j++) {
+			rebuilt.bodies[j]->set_island(NULL);
+		}
+		kept.step(1);
+		rebuilt.step(1);
+		CHECK(_check_islands(kept));
+
+		for (int j = 0; j < kept.bodies.size(); j++) {
+			CHECK(kept.bodies[j]->get_transform() == rebuilt.bodies[j]->get_transform());
+		}
+	}
+
+	return true;
+}
+
+static bool test_islands_3d() {
+
+	if (!PhysicsServerSW::singleton) {
+		OS::get_singleton()->print("\tSkipped, needs the GodotPhysics 3D engine.\n");
+		return true;
+	}
+
+	CHECK(_check_island_changes<Scene3D>(1));
+	CHECK(_check_island_rebuild<Scene3D>(1));
+
+	return true;
+}
+
+static bool test_islands_2d() {
+
+	CHECK(_check_island_changes<Scene2D>(16));
+	CHECK(_check_island_rebuild<Scene2D>(16));
+
+	return true;
+}
+
+/* 2D ROTATION */
+
+static bool test_rotation_2d() {
+
+	// deterministic builds have their own atan2(), allow for its rounding
+	for (int i = -8; i <= 8; i++) {
+		real_t angle = i * Math_PI / 8.5;
+		Transform2D xform(angle, Vector2(3, 4));
+		CHECK(Math::abs(Math2DSW::get_rotation(xform) - xform.get_rotation()) < 0.0001);
+		CHECK(Math::abs(Math2DSW::get_rotation(xform) - angle) < 0.0001);
+
+		// flipped and scaled, as a Node2D with a negative scale
+		Transform2D flipped = xform.scaled(Size2(2, -0.5));
+		CHECK(flipped.basis_determinant() < 0);
+		CHECK(Math::abs(Math2DSW::get_rotation(flipped) - flipped.get_rotation()) < 0.0001);
+		flipped = xform;
+		flipped.elements[1] = -flipped.elements[1];
+		CHECK(flipped.get_scale().y < 0);
+		CHECK(Math::abs(Math2DSW::get_rotation(flipped) - flipped.get_rotation()) < 0.0001);
+		CHECK(Math::abs(Math2DSW::get_rotation(flipped) - angle) < 0.0001);
+	}
+
+	return true;
+}
+
+typedef bool (*TestFunc)();
+
+static const char *test_names[] = {
+	"Batch queries 3D",
+	"Batch queries 2D",
+	"Packed separating axis tests match the scalar path",
+	"Contact manifold keeps the widest points",
+	"Warm starting holds up a stack",
+	"Snapshot restore replays 3D",
+	"Snapshot restore replays 2D",
+	"Concave polygon faces round trip",
+	"Synced body states match the direct state",
+	"Soft body points, pinning and stiffness round trip",
+	"Pinned soft body points stay put",
+	"Cloth rests on a sphere without tunneling",
+	"Continuous collision detection 3D",
+	"Continuous collision detection 2D",
+	"Kept islands split, merge and match rebuilt ones 3D",
+	"Kept islands split, merge and match rebuilt ones 2D",
+	"2D rotation of flipped transforms",
+	NULL
+};
+
+static const TestFunc test_funcs[] = {
+	test_batch_queries_3d,
+	test_batch_queries_2d,
+	test_packed_sat,
+	test_contact_reduction,
+	test_warm_starting,
+	test_snapshot_3d,
+	test_snapshot_2d,
+	test_concave_faces,
+	test_state_sync,
+	test_soft_body_api,
+	test_soft_body_pinning,
+	test_soft_body_collision,
+	test_ccd_3d,
+	test_ccd_2d,
+	test_islands_3d,
+	test_islands_2d,
+	test_rotation_2d,
+	NULL
+};
+
+MainLoop *test() {
+
+	int failed = 0;
+	for (int i = 0; test_funcs[i]; i++) {
+		OS::get_singleton()->print("%s\n", test_names[i]);
+		bool pass = test_funcs[i]();
+		OS::get_singleton()->print("\t%s\n", pass ? "PASS" : "FAILED");
+		if (!pass) {
+			failed++;
+		}
+	}
+
+	OS::get_singleton()->set_exit_code(failed ? 1 : 0);
+	return NULL;
+}
+} // namespace TestPhysicsServer
@@ -0,0 +1,752 @@
+/*************************************************************************/
+/*  test_physics_suite.cpp                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_physics_suite.h"
+
+#include "core/io/json.h"
+#include "core/math/math_funcs.h"
+#include "core/math/random_pcg.h"
+#include "core/os/file_access.h"
+#include "core/os/main_loop.h"
+#include "core/os/os.h"
+#include "core/print_string.h"
+#include "servers/physics/physics_server_sw.h"
+#include "servers/physics_2d/broad_phase_2d_bvh.h"
+#include "servers/physics_2d/broad_phase_2d_hash_grid.h"
+#include "servers/physics_2d/physics_2d_server_sw.h"
+#include "servers/physics_2d_server.h"
+#include "servers/physics_server.h"
+
+// Headless benchmark for CI trend tracking, runs on the server platform:
+//
+//     godot_server --test physics_suite [--output results.json]
+//
+// Every scene is built from a fixed seed and stepped a fixed number of times, so
+// the checksum of the final positions only changes when the simulation does.
+// 3D scenes run on the active 3D engine, set physics/3d/physics_engine (e.g. in
+// override.cfg) to compare GodotPhysics and Bullet. 2D scenes run once per
+// broadphase. Phase timings are only available on the Godot servers.
+class TestPhysicsSuiteMainLoop : public MainLoop {
+
+	GDCLASS(TestPhysicsSuiteMainLoop, MainLoop);
+
+	enum {
+		SEED = 20210415,
+		WARMUP_STEPS = 30,
+		MEASURED_STEPS = 240,
+		PYRAMID_BASE = 24,
+		RAGDOLL_COUNT = 64,
+		CHARACTER_COUNT = 256,
+		CHARACTER_STEPS = 120,
+		MAX_SLIDES = 4,
+		TERRAIN_SIZE = 96,
+		RAY_BODIES = 2048,
+		RAY_COUNT = 8192,
+		RAY_STEPS = 30,
+		AREA_COUNT = 128,
+		AREA_BODIES = 2048,
+		TILE_COLUMNS = 1024,
+		TILE_DEPTH = 8,
+		TILE_QUADRANT = 16,
+		TILE_BODIES = 2048,
+		SLEEPING_STACKS = 1024,
+		STACK_HEIGHT = 4,
+		FALLING_BOXES = 32,
+		PHASE_COUNT = SpaceSW::ELAPSED_TIME_MAX,
+	};
+
+	// microseconds summed over the measured steps of a scene
+	struct Timing {
+		uint64_t step;
+		uint64_t callbacks;
+		uint64_t queries;
+		uint64_t phases[PHASE_COUNT];
+		bool has_phases;
+	};
+
+	String output_path;
+	Array results;
+	Timing timing;
+	int area_events;
+
+	void _area_event(int p_status, const RID &p_body, int p_instance, int p_body_shape, int p_area_shape) {
+
+		area_events++;
+	}
+
+	void _reset_timing() {
+
+		timing.step = 0;
+		timing.callbacks = 0;
+		timing.queries = 0;
+		for (int i = 0; i < PHASE_COUNT; i++) {
+			timing.phases[i] = 0;
+		}
+		timing.has_phases = false;
+	}
+
+	void _step(PhysicsServer *p_ps, RID p_space, bool p_measure) {
+
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		p_ps->step(1.0 / 60.0);
+		uint64_t stepped = OS::get_singleton()->get_ticks_usec();
+		p_ps->flush_queries();
+		uint64_t end = OS::get_singleton()->get_ticks_usec();
+
+		if (!p_measure) {
+			return;
+		}
+
+		timing.step += stepped - begin;
+		timing.callbacks += end - stepped;
+
+		PhysicsServerSW *ps_sw = Object::cast_to<PhysicsServerSW>(p_ps);
+		if (ps_sw) {
+			timing.has_phases = true;
+			for (int i = 0; i < PHASE_COUNT; i++) {
+				timing.phases[i] += ps_sw->space_get_elapsed_time(p_space, SpaceSW::ElapsedTime(i));
+			}
+		}
+	}
+
+	void _step_2d(Physics2DServerSW *p_ps, RID p_space, bool p_measure) {
+
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		p_ps->step(1.0 / 60.0);
+		uint64_t stepped = OS::get_singleton()->get_ticks_usec();
+		p_ps->flush_queries();
+		uint64_t end = OS::get_singleton()->get_ticks_usec();
+
+		if (!p_measure) {
+			return;
+		}
+
+		timing.step += stepped - begin;
+		timing.callbacks += end - stepped;
+		timing.has_phases = true;
+
+		// same phases, in the same order, as the 3D server
+		for (int i = 0; i < PHASE_COUNT; i++) {
+			timing.phases[i] += p_ps->space_get_elapsed_time(p_space, Space2DSW::ElapsedTime(i));
+		}
+	}
+
+	void _add_result(const String &p_scene, const String &p_server, const String &p_broadphase, int p_objects, int p_steps, double p_checksum) {
+
+		Dictionary usec;
+		usec["step"] = timing.step;
+		usec["callbacks"] = timing.callbacks;
+		if (timing.queries) {
+			usec["queries"] = timing.queries;
+		}
+		if (timing.has_phases) {
+			usec["broadphase"] = timing.phases[SpaceSW::ELAPSED_TIME_BROADPHASE];
+			usec["pair_generation"] = timing.phases[SpaceSW::ELAPSED_TIME_PAIR_GENERATION];
+			// summed over the solver threads, and part of the constraint setup
+			usec["narrowphase"] = timing.phases[SpaceSW::ELAPSED_TIME_NARROWPHASE];
+			usec["islands"] = timing.phases[SpaceSW::ELAPSED_TIME_GENERATE_ISLANDS];
+			usec["setup_constraints"] = timing.phases[SpaceSW::ELAPSED_TIME_SETUP_CONSTRAINTS];
+			usec["solve"] = timing.phases[SpaceSW::ELAPSED_TIME_SOLVE_CONSTRAINTS];
+			usec["integrate"] = timing.phases[SpaceSW::ELAPSED_TIME_INTEGRATE_FORCES] + timing.phases[SpaceSW::ELAPSED_TIME_INTEGRATE_VELOCITIES];
+		}
+
+		Dictionary result;
+		result["scene"] = p_scene;
+		result["server"] = p_server;
+		if (p_broadphase != String()) {
+			result["broadphase"] = p_broadphase;
+		}
+		result["objects"] = p_objects;
+		result["steps"] = p_steps;
+		result["usec"] = usec;
+		result["checksum"] = p_checksum;
+		results.push_back(result);
+
+		print_line(p_server + " " + p_scene + (p_broadphase != String() ? " (" + p_broadphase + ")" : String()) + ": " + rtos(timing.step / 1000.0 / MAX(p_steps, 1)) + " ms per step");
+	}
+
+	static double _checksum(PhysicsServer *p_ps, const Vector<RID> &p_bodies) {
+
+		double sum = 0;
+		for (int i = 0; i < p_bodies.size(); i++) {
+			Transform xform = p_ps->body_get_state(p_bodies[i], PhysicsServer::BODY_STATE_TRANSFORM);
+			sum += xform.origin.x + xform.origin.y + xform.origin.z;
+		}
+		return sum;
+	}
+
+	static double _checksum_2d(Physics2DServer *p_ps, const Vector<RID> &p_bodies) {
+
+		double sum = 0;
+		for (int i = 0; i < p_bodies.size(); i++) {
+			Transform2D xform = p_ps->body_get_state(p_bodies[i], Physics2DServer::BODY_STATE_TRANSFORM);
+			sum += xform.elements[2].x + xform.elements[2].y;
+		}
+		return sum;
+	}
+
+	static RID _create_space(PhysicsServer *p_ps) {
+
+		RID space = p_ps->space_create();
+		p_ps->space_set_active(space, true);
+		p_ps->area_set_param(space, PhysicsServer::AREA_PARAM_GRAVITY, 9.8);
+		p_ps->area_set_param(space, PhysicsServer::AREA_PARAM_GRAVITY_VECTOR, Vector3(0, -1, 0));
+		return space;
+	}
+
+	static RID _create_body(PhysicsServer *p_ps, RID p_space, PhysicsServer::BodyMode p_mode, RID p_shape, const Transform &p_xform, Vector<RID> &r_rids) {
+
+		RID body = p_ps->body_create(p_mode);
+		p_ps->body_set_space(body, p_space);
+		p_ps->body_add_shape(body, p_shape);
+		p_ps->body_set_state(body, PhysicsServer::BODY_STATE_TRANSFORM, p_xform);
+		r_rids.push_back(body);
+		return body;
+	}
+
+	static RID _create_floor(PhysicsServer *p_ps, RID p_space, Vector<RID> &r_rids) {
+
+		RID shape = p_ps->shape_create(PhysicsServer::SHAPE_BOX);
+		p_ps->shape_set_data(shape, Vector3(200, 1, 200));
+		r_rids.push_back(shape);
+		return _create_body(p_ps, p_space, PhysicsServer::BODY_MODE_STATIC, shape, Transform(Basis(), Vector3(0, -1, 0)), r_rids);
+	}
+
+	// frees in reverse creation order, so joints and bodies go before their shapes and the space
+	static void _free(PhysicsServer *p_ps, RID p_space, const Vector<RID> &p_rids) {
+
+		for (int i = p_rids.size() - 1; i >= 0; i--) {
+			p_ps->free(p_rids[i]);
+		}
+		p_ps->free(p_space);
+	}
+
+	void _run_measured(PhysicsServer *p_ps, RID p_space, int p_steps) {
+
+		for (int i = 0; i < WARMUP_STEPS; i++) {
+			_step(p_ps, p_space, false);
+		}
+
+		_reset_timing();
+		for (int i = 0; i < p_steps; i++) {
+			_step(p_ps, p_space, true);
+		}
+	}
+
+	void scene_box_pyramid(PhysicsServer *p_ps, const String &p_server) {
+
+		RandomPCG rng(SEED);
+		RID space = _create_space(p_ps);
+		Vector<RID> rids;
+		_create_floor(p_ps, space, rids);
+
+		RID box = p_ps->shape_create(PhysicsServer::SHAPE_BOX);
+		p_ps->shape_set_data(box, Vector3(0.5, 0.5, 0.5));
+		rids.push_back(box);
+
+		Vector<RID> bodies;
+		for (int row = 0; row < PYRAMID_BASE; row++) {
+			int count = PYRAMID_BASE - row;
+			for (int i = 0; i < count; i++) {
+				Vector3 pos((i - count * 0.5 + 0.5) * 1.01 + rng.random(-0.01f, 0.01f), row * 1.01 + 0.5, rng.random(-0.01f, 0.01f));
+				bodies.push_back(_create_body(p_ps, space, PhysicsServer::BODY_MODE_RIGID, box, Transform(Basis(), pos), rids));
+			}
+		}
+
+		_run_measured(p_ps, space, MEASURED_STEPS);
+		_add_result("box_pyramid", p_server, String(), bodies.size(), MEASURED_STEPS, _checksum(p_ps, bodies));
+		_free(p_ps, space, rids);
+	}
+
+	void scene_ragdoll_pile(PhysicsServer *p_ps, const String &p_server) {
+
+		RandomPCG rng(SEED);
+		RID space = _create_space(p_ps);
+		Vector<RID> rids;
+		_create_floor(p_ps, space, rids);
+
+		// capsules are aligned with Z, stand them up
+		Basis upright(Vector3(1, 0, 0), Math_PI * 0.5);
+
+		Dictionary torso_data;
+		torso_data["radius"] = 0.2;
+		torso_data["height"] = 0.4;
+		RID torso_shape = p_ps->shape_create(PhysicsServer::SHAPE_CAPSULE);
+		p_ps->shape_set_data(torso_shape, torso_data);
+		rids.push_back(torso_shape);
+
+		Dictionary limb_data;
+		limb_data["radius"] = 0.08;
+		limb_data["height"] = 0.45;
+		RID limb_shape = p_ps->shape_create(PhysicsServer::SHAPE_CAPSULE);
+		p_ps->shape_set_data(limb_shape, limb_data);
+		rids.push_back(limb_shape);
+
+		RID head_shape = p_ps->shape_create(PhysicsServer::SHAPE_SPHERE);
+		p_ps->shape_set_data(head_shape, 0.15);
+		rids.push_back(head_shape);
+
+		// head, arms and legs: offset from the torso, and the joint anchor relative to the torso
+		static const Vector3 part_offset[5] = { Vector3(0, 0.6, 0), Vector3(-0.32, -0.05, 0), Vector3(0.32, -0.05, 0), Vector3(-0.12, -0.85, 0), Vector3(0.12, -0.85, 0) };
+		static const Vector3 part_anchor[5] = { Vector3(0, 0.42, 0), Vector3(-0.3, 0.25, 0), Vector3(0.3, 0.25, 0), Vector3(-0.12, -0.45, 0), Vector3(0.12, -0.45, 0) };
+
+		Vector<RID> bodies;
+		int side = Math::ceil(Math::sqrt((double)RAGDOLL_COUNT));
+		for (int i = 0; i < RAGDOLL_COUNT; i++) {
+
+			Vector3 center((i % side - side * 0.5) * 0.8, 2.0 + rng.random(0.0f, 8.0f), (i / side - side * 0.5) * 0.8);
+			Basis yaw(Vector3(0, 1, 0), rng.random(0.0f, (float)Math_TAU));
+
+			RID torso = _create_body(p_ps, space, PhysicsServer::BODY_MODE_RIGID, torso_shape, Transform(yaw * upright, center), rids);
+			bodies.push_back(torso);
+
+			for (int j = 0; j < 5; j++) {
+
+				RID shape = j == 0 ? head_shape : limb_shape;
+				Vector3 pos = center + yaw.xform(part_offset[j]);
+				RID part = _create_body(p_ps, space, PhysicsServer::BODY_MODE_RIGID, shape, Transform(yaw * upright, pos), rids);
+				bodies.push_back(part);
+
+				Vector3 anchor = center + yaw.xform(part_anchor[j]);
+				Transform torso_xform(yaw * upright, center);
+				Transform part_xform(yaw * upright, pos);
+				RID joint = p_ps->joint_create_cone_twist(torso, torso_xform.affine_inverse() * Transform(Basis(), anchor), part, part_xform.affine_inverse() * Transform(Basis(), anchor));
+				rids.push_back(joint);
+			}
+		}
+
+		_run_measured(p_ps, space, MEASURED_STEPS);
+		_add_result("ragdoll_pile", p_server, String(), bodies.size(), MEASURED_STEPS, _checksum(p_ps, bodies));
+		_free(p_ps, space, rids);
+	}
+
+	void scene_trimesh_characters(PhysicsServer *p_ps, const String &p_server) {
+
+		RandomPCG rng(SEED);
+		RID space = _create_space(p_ps);
+		Vector<RID> rids;
+
+		real_t phase_x = rng.random(0.0f, (float)Math_TAU);
+		real_t phase_z = rng.random(0.0f, (float)Math_TAU);
+		real_t half = (TERRAIN_SIZE - 1) * 0.5;
+
+		PoolVector<Vector3> faces;
+		faces.resize((TERRAIN_SIZE - 1) * (TERRAIN_SIZE - 1) * 6);
+		{
+			PoolVector<Vector3>::Write w = faces.write();
+			int idx = 0;
+			for (int i = 0; i < TERRAIN_SIZE - 1; i++) {
+				for (int j = 0; j < TERRAIN_SIZE - 1; j++) {
+
+					Vector3 p[4];
+					for (int k = 0; k < 4; k++) {
+						real_t x = j + (k & 1) - half;
+						real_t z = i + (k >> 1) - half;
+						p[k] = Vector3(x, Math::sin(x * 0.15 + phase_x) * Math::cos(z * 0.11 + phase_z) * 3.0, z);
+					}
+
+					w[idx++] = p[0];
+					w[idx++] = p[1];
+					w[idx++] = p[2];
+					w[idx++] = p[1];
+					w[idx++] = p[3];
+					w[idx++] = p[2];
+				}
+			}
+		}
+
+		RID terrain_shape = p_ps->shape_create(PhysicsServer::SHAPE_CONCAVE_POLYGON);
+		p_ps->shape_set_data(terrain_shape, faces);
+		rids.push_back(terrain_shape);
+		_create_body(p_ps, space, PhysicsServer::BODY_MODE_STATIC, terrain_shape, Transform(), rids);
+
+		Dictionary capsule_data;
+		capsule_data["radius"] = 0.4;
+		capsule_data["height"] = 1.0;
+		RID capsule = p_ps->shape_create(PhysicsServer::SHAPE_CAPSULE);
+		p_ps->shape_set_data(capsule, capsule_data);
+		rids.push_back(capsule);
+
+		Basis upright(Vector3(1, 0, 0), Math_PI * 0.5);
+		Vector<RID> bodies;
+		Vector<Transform> xforms;
+		Vector<Vector3> velocities;
+
+		for (int i = 0; i < CHARACTER_COUNT; i++) {
+			Transform xform(upright, Vector3(rng.random(-half * 0.8f, half * 0.8f), 5.0, rng.random(-half * 0.8f, half * 0.8f)));
+			bodies.push_back(_create_body(p_ps, space, PhysicsServer::BODY_MODE_KINEMATIC, capsule, xform, rids));
+			xforms.push_back(xform);
+			velocities.push_back(Vector3(rng.random(-1.0f, 1.0f), 0, rng.random(-1.0f, 1.0f)).normalized() * 5.0);
+		}
+
+		_reset_timing();
+		real_t delta = 1.0 / 60.0;
+
+		for (int i = 0; i < CHARACTER_STEPS; i++) {
+
+			// what KinematicBody::move_and_slide() does, without the node
+			uint64_t begin = OS::get_singleton()->get_ticks_usec();
+
+			for (int j = 0; j < bodies.size(); j++) {
+
+				Transform &xform = xforms.write[j];
+				Vector3 motion = (velocities[j] + Vector3(0, -9.8, 0)) * delta;
+
+				for (int k = 0; k < MAX_SLIDES; k++) {
+
+					PhysicsServer::MotionResult result;
+					bool collided = p_ps->body_test_motion(bodies[j], xform, motion, true, &result);
+					xform.origin += result.motion;
+					if (!collided) {
+						break;
+					}
+					motion = result.remainder.slide(result.collision_normal);
+				}
+
+				p_ps->body_set_state(bodies[j], PhysicsServer::BODY_STATE_TRANSFORM, xform);
+			}
+
+			timing.queries += OS::get_singleton()->get_ticks_usec() - begin;
+			_step(p_ps, space, true);
+		}
+
+		_add_result("trimesh_characters", p_server, String(), bodies.size(), CHARACTER_STEPS, _checksum(p_ps, bodies));
+		_free(p_ps, space, rids);
+	}
+
+	void scene_ray_storm(PhysicsServer *p_ps, const String &p_server) {
+
+		RandomPCG rng(SEED);
+		RID space = _create_space(p_ps);
+		Vector<RID> rids;
+
+		RID box = p_ps->shape_create(PhysicsServer::SHAPE_BOX);
+		p_ps->shape_set_data(box, Vector3(0.5, 0.5, 0.5));
+		rids.push_back(box);
+		RID sphere = p_ps->shape_create(PhysicsServer::SHAPE_SPHERE);
+		p_ps->shape_set_data(sphere, 0.5);
+		rids.push_back(sphere);
+
+		for (int i = 0; i < RAY_BODIES; i++) {
+			Vector3 pos(rng.random(-50.0f, 50.0f), rng.random(-50.0f, 50.0f), rng.random(-50.0f, 50.0f));
+			_create_body(p_ps, space, PhysicsServer::BODY_MODE_STATIC, (i & 1) ? box : sphere, Transform(Basis(), pos), rids);
+		}
+
+		// the broadphase only knows about the bodies after a step
+		_step(p_ps, space, false);
+		_reset_timing();
+
+		PhysicsDirectSpaceState *state = p_ps->space_get_direct_state(space);
+		double checksum = 0;
+
+		for (int i = 0; i < RAY_STEPS; i++) {
+
+			uint64_t begin = OS::get_singleton()->get_ticks_usec();
+
+			for (int j = 0; j < RAY_COUNT; j++) {
+
+				Vector3 from(rng.random(-60.0f, 60.0f), rng.random(-60.0f, 60.0f), rng.random(-60.0f, 60.0f));
+				Vector3 to(rng.random(-60.0f, 60.0f), rng.random(-60.0f, 60.0f), rng.random(-60.0f, 60.0f));
+
+				PhysicsDirectSpaceState::RayResult result;
+				if (state->intersect_ray(from, to, result)) {
+					checksum += result.position.x + result.position.y + result.position.z;
+				}
+			}
+
+			timing.queries += OS::get_singleton()->get_ticks_usec() - begin;
+			_step(p_ps, space, true);
+		}
+
+		_add_result("ray_storm", p_server, String(), RAY_BODIES, RAY_STEPS, checksum);
+		_free(p_ps, space, rids);
+	}
+
+	void scene_area_triggers(PhysicsServer *p_ps, const String &p_server) {
+
+		RandomPCG rng(SEED);
+		RID space = _create_space(p_ps);
+		Vector<RID> rids;
+		_create_floor(p_ps, space, rids);
+
+		RID trigger = p_ps->shape_create(PhysicsServer::SHAPE_BOX);
+		p_ps->shape_set_data(trigger, Vector3(2, 2, 2));
+		rids.push_back(trigger);
+
+		int side = Math::ceil(Math::sqrt((double)AREA_COUNT));
+		for (int i = 0; i < AREA_COUNT; i++) {
+			RID area = p_ps->area_create();
+			p_ps->area_set_space(area, space);
+			p_ps->area_add_shape(area, trigger);
+			p_ps->area_set_transform(area, Transform(Basis(), Vector3((i % side - side * 0.5) * 5.0, 2.0, (i / side - side * 0.5) * 5.0)));
+			p_ps->area_set_monitor_callback(area, this, "_area_event");
+			rids.push_back(area);
+		}
+
+		RID sphere = p_ps->shape_create(PhysicsServer::SHAPE_SPHERE);
+		p_ps->shape_set_data(sphere, 0.3);
+		rids.push_back(sphere);
+
+		Vector<RID> bodies;
+		real_t extent = side * 2.5;
+		for (int i = 0; i < AREA_BODIES; i++) {
+			Vector3 pos(rng.random(-extent, extent), rng.random(1.0f, 20.0f), rng.random(-extent, extent));
+			RID body = _create_body(p_ps, space, PhysicsServer::BODY_MODE_RIGID, sphere, Transform(Basis(), pos), rids);
+			p_ps->body_set_state(body, PhysicsServer::BODY_STATE_LINEAR_VELOCITY, Vector3(rng.random(-3.0f, 3.0f), 0, rng.random(-3.0f, 3.0f)));
+			bodies.push_back(body);
+		}
+
+		area_events = 0;
+		_run_measured(p_ps, space, MEASURED_STEPS);
+		_add_result("area_triggers", p_server, String(), AREA_COUNT + AREA_BODIES, MEASURED_STEPS, _checksum(p_ps, bodies) + area_events);
+		_free(p_ps, space, rids);
+	}
+
+	void scene_sleeping_stacks(PhysicsServer *p_ps, const String &p_server) {
+
+		RandomPCG rng(SEED);
+		RID space = _create_space(p_ps);
+		Vector<RID> rids;
+		_create_floor(p_ps, space, rids);
+
+		RID box = p_ps->shape_create(PhysicsServer::SHAPE_BOX);
+		p_ps->shape_set_data(box, Vector3(0.5, 0.5, 0.5));
+		rids.push_back(box);
+
+		// the stacks start asleep, only the few that a falling box hits are woken up
+		Vector<RID> bodies;
+		Vector<Vector3> bases;
+		int side = Math::ceil(Math::sqrt((double)SLEEPING_STACKS));
+		for (int i = 0; i < SLEEPING_STACKS; i++) {
+
+			Vector3 base((i % side - side * 0.5) * 2.5, 0, (i / side - side * 0.5) * 2.5);
+			bases.push_back(base);
+
+			for (int j = 0; j < STACK_HEIGHT; j++) {
+				RID body = _create_body(p_ps, space, PhysicsServer::BODY_MODE_RIGID, box, Transform(Basis(), base + Vector3(0, j + 0.5, 0)), rids);
+				p_ps->body_set_state(body, PhysicsServer::BODY_STATE_SLEEPING, true);
+				bodies.push_back(body);
+			}
+		}
+
+		// from different heights, so they land all through the measured steps
+		for (int i = 0; i < FALLING_BOXES; i++) {
+			Vector3 pos = bases[rng.rand() % SLEEPING_STACKS] + Vector3(rng.random(-0.3f, 0.3f), STACK_HEIGHT + rng.random(2.0f, 60.0f), rng.random(-0.3f, 0.3f));
+			bodies.push_back(_create_body(p_ps, space, PhysicsServer::BODY_MODE_RIGID, box, Transform(Basis(), pos), rids));
+		}
+
+		_run_measured(p_ps, space, MEASURED_STEPS);
+		_add_result("sleeping_stacks", p_server, String(), bodies.size(), MEASURED_STEPS, _checksum(p_ps, bodies));
+		_free(p_ps, space, rids);
+	}
+
+	void scene_tile_world(Physics2DServerSW *p_ps, const String &p_broadphase) {
+
+		RandomPCG rng(SEED);
+		const real_t tile = 16;
+
+		RID space = p_ps->space_create();
+		p_ps->space_set_active(space, true);
+		p_ps->area_set_param(space, Physics2DServer::AREA_PARAM_GRAVITY, 98);
+		p_ps->area_set_param(space, Physics2DServer::AREA_PARAM_GRAVITY_VECTOR, Vector2(0, 1));
+		Vector<RID> rids;
+
+		RID tile_shape = p_ps->rectangle_shape_create();
+		p_ps->shape_set_data(tile_shape, Vector2(tile * 0.5, tile * 0.5));
+		rids.push_back(tile_shape);
+
+		// a random walk of columns, TILE_DEPTH tiles deep, with one static body per quadrant like TileMap
+		Vector<int> surface;
+		int height = 0;
+		for (int i = 0; i < TILE_COLUMNS; i++) {
+			height = CLAMP(height + (int)(rng.rand() % 3) - 1, -8, 8);
+			surface.push_back(height);
+		}
+
+		int tiles = 0;
+		for (int q = 0; q < TILE_COLUMNS; q += TILE_QUADRANT) {
+
+			RID quadrant = p_ps->body_create();
+			p_ps->body_set_mode(quadrant, Physics2DServer::BODY_MODE_STATIC);
+			p_ps->body_set_space(quadrant, space);
+			rids.push_back(quadrant);
+
+			for (int i = q; i < MIN(q + TILE_QUADRANT, (int)TILE_COLUMNS); i++) {
+				for (int j = 0; j < TILE_DEPTH; j++) {
+					Vector2 pos((i - TILE_COLUMNS * 0.5 + 0.5) * tile, (surface[i] + j + 0.5) * tile);
+					p_ps->body_add_shape(quadrant, tile_shape, Transform2D(0, pos));
+					tiles++;
+				}
+			}
+		}
+
+		RID circle = p_ps->circle_shape_create();
+		p_ps->shape_set_data(circle, 6.0);
+		rids.push_back(circle);
+		RID box = p_ps->rectangle_shape_create();
+		p_ps->shape_set_data(box, Vector2(6, 6));
+		rids.push_back(box);
+
+		Vector<RID> bodies;
+		real_t extent = TILE_COLUMNS * 0.5 * tile * 0.95;
+		for (int i = 0; i < TILE_BODIES; i++) {
+			RID body = p_ps->body_create();
+			p_ps->body_set_space(body, space);
+			p_ps->body_add_shape(body, (i & 1) ? box : circle);
+			p_ps->body_set_state(body, Physics2DServer::BODY_STATE_TRANSFORM, Transform2D(0, Vector2(rng.random(-extent, extent), rng.random(-600.0f, -200.0f))));
+			rids.push_back(body);
+			bodies.push_back(body);
+		}
+
+		for (int i = 0; i < WARMUP_STEPS; i++) {
+			_step_2d(p_ps, space, false);
+		}
+
+		_reset_timing();
+		for (int i = 0; i < MEASURED_STEPS; i++) {
+			_step_2d(p_ps, space, true);
+		}
+
+		_add_result("tile_world", "Physics2DServerSW", p_broadphase, tiles + TILE_BODIES, MEASURED_STEPS, _checksum_2d(p_ps, bodies));
+
+		for (int i = rids.size() - 1; i >= 0; i--) {
+			p_ps->free(rids[i]);
+		}
+		p_ps->free(space);
+	}
+
+	void run_3d() {
+
+		PhysicsServer *ps = PhysicsServer::get_singleton();
+		String server = ps->get_class();
+		ps->set_active(true);
+
+		PhysicsServerSW *ps_sw = Object::cast_to<PhysicsServerSW>(ps);
+		if (ps_sw) {
+			// from the first measured step on
+			ps_sw->set_narrowphase_timing_enabled(true);
+		}
+
+		scene_box_pyramid(ps, server);
+		scene_ragdoll_pile(ps, server);
+		scene_trimesh_characters(ps, server);
+		scene_ray_storm(ps, server);
+		scene_area_triggers(ps, server);
+		scene_sleeping_stacks(ps, server);
+
+		if (ps_sw) {
+			ps_sw->set_narrowphase_timing_enabled(false);
+		}
+	}
+
+	void run_2d() {
+
+		Physics2DServerSW *ps = Object::cast_to<Physics2DServerSW>(Physics2DServer::get_singleton());
+		if (!ps) {
+			print_line("The 2D scenes need the \"Single-Unsafe\" or \"Single-Safe\" thread model.");
+			return;
+		}
+
+		ps->set_active(true);
+		ps->set_narrowphase_timing_enabled(true);
+
+		// spaces pick their broadphase when created
+		BroadPhase2DSW::CreateFunction create_func = BroadPhase2DSW::create_func;
+
+		BroadPhase2DSW::create_func = BroadPhase2DBVH::_create;
+		scene_tile_world(ps, "bvh");
+		BroadPhase2DSW::create_func = BroadPhase2DHashGrid::_create;
+		scene_tile_world(ps, "hash_grid");
+
+		BroadPhase2DSW::create_func = create_func;
+		ps->set_narrowphase_timing_enabled(false);
+	}
+
+protected:
+	static void _bind_methods() {
+
+		ClassDB::bind_method(D_METHOD("_area_event"), &TestPhysicsSuiteMainLoop::_area_event);
+	}
+
+public:
+	virtual void init() {
+
+		run_3d();
+		run_2d();
+
+		Dictionary report;
+		report["version"] = 1;
+		report["threads"] = OS::get_singleton()->get_processor_count();
+		report["results"] = results;
+
+		String json = JSON::print(report, "\t");
+		print_line(json);
+
+		if (output_path != String()) {
+			Error err;
+			FileAccess *f = FileAccess::open(output_path, FileAccess::WRITE, &err);
+			ERR_FAIL_COND_MSG(err != OK, "Cannot write the physics benchmark results to '" + output_path + "'.");
+			f->store_string(json);
+			f->close();
+			memdelete(f);
+		}
+	}
+
+	virtual bool iteration(float p_time) {
+		return true;
+	}
+
+	virtual bool idle(float p_time) {
+		return true;
+	}
+
+	virtual void finish() {
+	}
+
+	TestPhysicsSuiteMainLoop(const List<String> &p_args) {
+
+		area_events = 0;
+		_reset_timing();
+
+		for (const List<String>::Element *E = p_args.front(); E; E = E->next()) {
+			if (E->get() == "--output" && E->next()) {
+				output_path = E->next()->get();
+			}
+		}
+	}
+};
+
+namespace TestPhysicsSuite {
+
+MainLoop *test(const List<String> &p_args) {
+
+	return memnew(TestPhysicsSuiteMainLoop(p_args));
+}
+} // namespace TestPhysicsSuite
@@ -0,0 +1,317 @@
+/*************************************************************************/
+/*  test_visual_script.cpp                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_visual_script.h"
+
+#include "core/os/os.h"
+
+#ifdef MODULE_VISUAL_SCRIPT_ENABLED
+
+#include "modules/visual_script/visual_script.h"
+#include "modules/visual_script/visual_script_flow_control.h"
+#include "modules/visual_script/visual_script_nodes.h"
+#include "modules/visual_script/visual_script_yield_nodes.h"
+
+namespace TestVisualScript {
+
+#define CHECK(m_cond)                                        \
+	if (!(m_cond)) {                                         \
+		OS::get_singleton()->print("\tFAIL: %s\n", #m_cond); \
+		return false;                                        \
+	}
+
+static void _add_function(Ref<VisualScript> &p_script, const StringName &p_name, int p_id, int p_argument_count) {
+
+	Ref<VisualScriptFunction> function;
+	function.instance();
+	for (int i = 0; i < p_argument_count; i++) {
+		function->add_argument(Variant::NIL, "arg" + itos(i));
+	}
+	p_script->add_function(p_name);
+	p_script->add_node(p_name, p_id, function);
+}
+
+static void _add_operator(Ref<VisualScript> &p_script, const StringName &p_func, int p_id, Variant::Operator p_op, const Variant &p_default_b = Variant()) {
+
+	Ref<VisualScriptOperator> op;
+	op.instance();
+	op->set_operator(p_op);
+	if (op->get_input_value_port_count() == 2) {
+		op->set_default_input_value(1, p_default_b);
+	}
+	p_script->add_node(p_func, p_id, op);
+}
+
+static void _add_return(Ref<VisualScript> &p_script, const StringName &p_func, int p_id) {
+
+	Ref<VisualScriptReturn> ret;
+	ret.instance();
+	ret->set_enable_return_value(true);
+	p_script->add_node(p_func, p_id, ret);
+}
+
+// f(a, b) = (a + b) * (a - b) + -(a + b), then doubled through a default
+// operand. Both the product and the negation read the shared sum, which
+// must be stepped once and before either of them.
+static Ref<VisualScript> _make_operator_script() {
+
+	Ref<VisualScript> script;
+	script.instance();
+	script->set_instance_base_type("Reference");
+
+	_add_function(script, "f", 1, 2);
+	_add_operator(script, "f", 2, Variant::OP_ADD);
+	_add_operator(script, "f", 3, Variant::OP_SUBTRACT);
+	_add_operator(script, "f", 4, Variant::OP_MULTIPLY);
+	_add_operator(script, "f", 5, Variant::OP_NEGATE);
+	_add_operator(script, "f", 6, Variant::OP_ADD);
+	_add_operator(script, "f", 7, Variant::OP_MULTIPLY, 2);
+	_add_return(script, "f", 8);
+
+	script->sequence_connect("f", 1, 0, 8);
+	script->data_connect("f", 1, 0, 2, 0);
+	script->data_connect("f", 1, 1, 2, 1);
+	script->data_connect("f", 1, 0, 3, 0);
+	script->data_connect("f", 1, 1, 3, 1);
+	script->data_connect("f", 2, 0, 4, 0);
+	script->data_connect("f", 3, 0, 4, 1);
+	script->data_connect("f", 2, 0, 5, 0);
+	script->data_connect("f", 4, 0, 6, 0);
+	script->data_connect("f", 5, 0, 6, 1);
+	script->data_connect("f", 6, 0, 7, 0);
+	script->data_connect("f", 7, 0, 8, 0);
+
+	return script;
+}
+
+static Ref<Reference> _instance(const Ref<VisualScript> &p_script) {
+
+	Ref<Reference> object;
+	object.instance();
+	object->set_script(p_script.get_ref_ptr());
+	return object;
+}
+
+static bool test_operators() {
+
+	Ref<Reference> object = _instance(_make_operator_script());
+	CHECK(object->get_script_instance() != NULL);
+
+	CHECK(object->call("f", 7, 3) == Variant(60));
+	CHECK(object->call("f", 2.5, 0.5) == Variant(6.0));
+	// Repeated calls reuse the compiled steps, results must not leak between calls.
+	CHECK(object->call("f", 7, 3) == Variant(60));
+	CHECK(object->call("f", 0, 0) == Variant(0));
+
+	return true;
+}
+
+static bool test_invalid_operands() {
+
+	Ref<Reference> object = _instance(_make_operator_script());
+
+	Variant a = Vector2(1, 2);
+	Variant b = "text";
+	const Variant *args[2] = { &a, &b };
+	Variant::CallError ce;
+	object->call("f", args, 2, ce);
+	CHECK(ce.error != Variant::CallError::CALL_OK);
+
+	// The instance is still usable after the error.
+	CHECK(object->call("f", 7, 3) == Variant(60));
+
+	return true;
+}
+
+// g() runs a three step sequence, step k sets x = x * 10 + k. All of them read
+// x through the same getter, which has to be stepped again for every step.
+static bool test_sequence() {
+
+	Ref<VisualScript> script;
+	script.instance();
+	script->set_instance_base_type("Reference");
+	script->add_variable("x", 0);
+
+	_add_function(script, "g", 1, 0);
+
+	Ref<VisualScriptSequence> sequence;
+	sequence.instance();
+	sequence->set_steps(3);
+	script->add_node("g", 2, sequence);
+	script->sequence_connect("g", 1, 0, 2);
+
+	Ref<VisualScriptVariableGet> get;
+	get.instance();
+	get->set_variable("x");
+	script->add_node("g", 3, get);
+
+	_add_operator(script, "g", 4, Variant::OP_MULTIPLY, 10);
+	script->data_connect("g", 3, 0, 4, 0);
+
+	for (int i = 0; i < 3; i++) {
+		int add_id = 10 + i;
+		int set_id = 20 + i;
+
+		_add_operator(script, "g", add_id, Variant::OP_ADD, i + 1);
+		script->data_connect("g", 4, 0, add_id, 0);
+
+		Ref<VisualScriptVariableSet> set;
+		set.instance();
+		set->set_variable("x");
+		script->add_node("g", set_id, set);
+		script->data_connect("g", add_id, 0, set_id, 0);
+		script->sequence_connect("g", 2, i, set_id);
+	}
+
+	Ref<Reference> object = _instance(script);
+	object->call("g");
+	CHECK(object->get("x") == Variant(123));
+	object->call("g");
+	CHECK(object->get("x") == Variant(123123));
+
+	return true;
+}
+
+// h(a) yields, then returns a * 2 + 1 once resumed.
+static bool test_yield() {
+
+	Ref<VisualScript> script;
+	script.instance();
+	script->set_instance_base_type("Reference");
+
+	_add_function(script, "h", 1, 1);
+
+	Ref<VisualScriptYield> yield;
+	yield.instance();
+	yield->set_yield_mode(VisualScriptYield::YIELD_RETURN);
+	script->add_node("h", 2, yield);
+
+	_add_operator(script, "h", 3, Variant::OP_MULTIPLY, 2);
+	_add_operator(script, "h", 4, Variant::OP_ADD, 1);
+	_add_return(script, "h", 5);
+
+	script->sequence_connect("h", 1, 0, 2);
+	script->sequence_connect("h", 2, 0, 5);
+	script->data_connect("h", 1, 0, 3, 0);
+	script->data_connect("h", 3, 0, 4, 0);
+	script->data_connect("h", 4, 0, 5, 0);
+
+	Ref<Reference> object = _instance(script);
+
+	Ref<VisualScriptFunctionState> state = object->call("h", 20);
+	CHECK(state.is_valid());
+	CHECK(state->is_valid());
+	CHECK(state->resume(Array()) == Variant(41));
+	CHECK(!state->is_valid());
+
+	// A second call gets its own state.
+	state = object->call("h", 5);
+	CHECK(state.is_valid());
+	CHECK(state->resume(Array()) == Variant(11));
+
+	return true;
+}
+
+typedef bool (*TestFunc)();
+
+TestFunc test_funcs[] = {
+	test_operators,
+	test_invalid_operands,
+	test_sequence,
+	test_yield,
+	NULL
+};
+
+const char *test_names[] = {
+	"Operators and shared dependencies",
+	"Invalid operands report an error",
+	"Sequence steps re-evaluate dependencies",
+	"Yield and resume",
+	NULL
+};
+
+MainLoop *test() {
+
+	int failed = 0;
+	for (int i = 0; test_funcs[i]; i++) {
+		OS::get_singleton()->print("%s\n", test_names[i]);
+		bool pass = test_funcs[i]();
+		OS::get_singleton()->print("\t%s\n", pass ? "PASS" : "FAILED");
+		if (!pass) {
+			failed++;
+		}
+	}
+
+	OS::get_singleton()->set_exit_code(failed ? 1 : 0);
+	return NULL;
+}
+
+// Only uses the public VisualScript API, so it can also be built against older
+// revisions to compare the interpreter before and after a change.
+MainLoop *test_benchmark() {
+
+	const int calls = 200000;
+
+	Ref<Reference> object = _instance(_make_operator_script());
+	Variant a = 7;
+	Variant b = 3;
+	const Variant *args[2] = { &a, &b };
+	Variant::CallError ce;
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < calls; i++) {
+		object->call("f", args, 2, ce);
+	}
+	uint64_t elapsed = OS::get_singleton()->get_ticks_usec() - begin;
+
+	OS::get_singleton()->print("Operator graph: %d calls in %d usec (%.3f usec/call)\n", calls, (int)elapsed, elapsed / (double)calls);
+
+	return NULL;
+}
+} // namespace TestVisualScript
+
+#else
+
+namespace TestVisualScript {
+
+MainLoop *test() {
+
+	print_line("VisualScript is disabled in this build.");
+	return NULL;
+}
+
+MainLoop *test_benchmark() {
+
+	print_line("VisualScript is disabled in this build.");
+	return NULL;
+}
+} // namespace TestVisualScript
+
+#endif
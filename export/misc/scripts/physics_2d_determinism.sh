@@ -0,0 +1,39 @@
+#!/usr/bin/env bash
+
+# Builds the headless server with deterministic_physics_2d=yes twice, unoptimized and
+# optimized for speed, and checks that the 2D determinism test gives the same hash with
+# both. Run it from the repository root, extra arguments are passed to SCons:
+#
+#     misc/scripts/physics_2d_determinism.sh -j4
+
+set -uo pipefail
+
+hashes=()
+
+for optimize in none speed; do
+    scons platform=server tools=yes target=release_debug deterministic_physics_2d=yes \
+          optimize=$optimize extra_suffix=determinism_$optimize "$@" || exit 1
+
+    binary=(bin/godot_server.*.determinism_$optimize)
+    # it fails by itself when repeated runs differ
+    if ! output=$("${binary[0]}" --test physics_2d_determinism); then
+        printf "%s\noptimize=%s: the test failed.\n" "$output" "$optimize"
+        exit 1
+    fi
+
+    hash=$(printf "%s\n" "$output" | sed -n 's/^Hash: \([0-9a-f]*\).*/\1/p')
+    if [ -z "$hash" ]; then
+        printf "optimize=%s: the test didn't print a hash.\n" "$optimize"
+        exit 1
+    fi
+
+    printf "optimize=%s: %s\n" "$optimize" "$hash"
+    hashes+=("$hash")
+done
+
+if [ "${hashes[0]}" != "${hashes[1]}" ]; then
+    printf "2D physics DIVERGED between optimization levels.\n"
+    exit 1
+fi
+
+printf "2D physics gives the same results at both optimization levels.\n"
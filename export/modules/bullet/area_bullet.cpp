@@ -55,7 +55,8 @@ AreaBullet::AreaBullet() :
 		spOv_linearDump(0.1),
 		spOv_angularDump(0.1),
 		spOv_priority(0),
-		isScratched(false) {
+		isScratched(false),
+		monitor_batching(false) {
 
 	btGhost = bulletnew(btGhostObject);
 	reload_shapes();
@@ -99,11 +100,25 @@ void AreaBullet::dispatch_callbacks() {
 				break;
 		}
 	}
+
+	flush_events();
 }
 
 void AreaBullet::call_event(CollisionObjectBullet *p_otherObject, PhysicsServer::AreaBodyStatus p_status) {
 
 	InOutEventCallback &event = eventsCallbacks[static_cast<int>(p_otherObject->getType())];
+
+	if (monitor_batching) {
+		if (event.event_callback_id) {
+			PendingEvent pending;
+			pending.status = p_status;
+			pending.rid = p_otherObject->get_self();
+			pending.instance_id = p_otherObject->get_instance_id();
+			event.pending_events.push_back(pending);
+		}
+		return;
+	}
+
 	Object *areaGodoObject = ObjectDB::get_instance(event.event_callback_id);
 
 	if (!areaGodoObject) {
@@ -121,6 +136,62 @@ void AreaBullet::call_event(CollisionObjectBullet *p_otherObject, PhysicsServer:
 	areaGodoObject->call(event.event_callback_method, (const Variant **)call_event_res_ptr, 5, outResp);
 }
 
+void AreaBullet::flush_events() {
+
+	for (int t = 0; t < 2; ++t) {
+		InOutEventCallback &event = eventsCallbacks[t];
+		const int count = event.pending_events.size();
+		if (!count)
+			continue;
+
+		Object *areaGodoObject = ObjectDB::get_instance(event.event_callback_id);
+		if (!areaGodoObject) {
+			event.event_callback_id = 0;
+			event.pending_events.clear();
+			continue;
+		}
+
+		PoolIntArray status;
+		Array rids;
+		PoolIntArray instances;
+		PoolIntArray shapes;
+		status.resize(count);
+		rids.resize(count);
+		instances.resize(count);
+		shapes.resize(count);
+
+		{
+			PoolIntArray::Write status_w = status.write();
+			PoolIntArray::Write instances_w = instances.write();
+			PoolIntArray::Write shapes_w = shapes.write();
+			for (int i = 0; i < count; ++i) {
+				const PendingEvent &pending = event.pending_events[i];
+				status_w[i] = pending.status;
+				rids[i] = pending.rid;
+				instances_w[i] = pending.instance_id;
+				shapes_w[i] = 0; // Shape IDs are not tracked, like in call_event
+			}
+		}
+		event.pending_events.clear();
+
+		// Both shape arrays hold zeros, so the same array is passed twice
+		Variant res[5] = { status, rids, instances, shapes, shapes };
+		const Variant *res_ptr[5] = { &res[0], &res[1], &res[2], &res[3], &res[4] };
+
+		Variant::CallError outResp;
+		areaGodoObject->call(event.event_callback_method, res_ptr, 5, outResp);
+	}
+}
+
+void AreaBullet::set_monitor_batching(bool p_enable) {
+	if (monitor_batching == p_enable)
+		return;
+
+	// Deliver anything queued so far in the old form before switching
+	flush_events();
+	monitor_batching = p_enable;
+}
+
 void AreaBullet::scratch() {
 	if (isScratched)
 		return;
@@ -134,6 +205,9 @@ void AreaBullet::clear_overlaps(bool p_notify) {
 		overlappingObjects[i].object->on_exit_area(this);
 	}
 	overlappingObjects.clear();
+
+	if (p_notify)
+		flush_events();
 }
 
 void AreaBullet::remove_overlap(CollisionObjectBullet *p_object, bool p_notify) {
@@ -146,6 +220,9 @@ void AreaBullet::remove_overlap(CollisionObjectBullet *p_object, bool p_notify)
 			break;
 		}
 	}
+
+	if (p_notify)
+		flush_events();
 }
 
 int AreaBullet::find_overlapping_object(CollisionObjectBullet *p_colObj) {
@@ -46,9 +46,17 @@ class AreaBullet : public RigidCollisionObjectBullet {
 	friend void SpaceBullet::check_ghost_overlaps();
 
 public:
+	struct PendingEvent {
+		PhysicsServer::AreaBodyStatus status;
+		RID rid;
+		ObjectID instance_id;
+	};
+
 	struct InOutEventCallback {
 		ObjectID event_callback_id;
 		StringName event_callback_method;
+		// Events waiting to be delivered in one call when monitor batching is on
+		LocalVector<PendingEvent> pending_events;
 
 		InOutEventCallback() :
 				event_callback_id(0) {}
@@ -100,6 +108,7 @@ private:
 	int spOv_priority;
 
 	bool isScratched;
+	bool monitor_batching;
 
 	InOutEventCallback eventsCallbacks[2];
 
@@ -148,6 +157,8 @@ public:
 
 	virtual void dispatch_callbacks();
 	void call_event(CollisionObjectBullet *p_otherObject, PhysicsServer::AreaBodyStatus p_status);
+	void flush_events();
+	void set_monitor_batching(bool p_enable);
 	void set_on_state_change(ObjectID p_id, const StringName &p_method, const Variant &p_udata = Variant());
 	void scratch();
 
@@ -34,8 +34,10 @@
 #include "cone_twist_joint_bullet.h"
 #include "core/class_db.h"
 #include "core/error_macros.h"
+#include "core/project_settings.h"
 #include "core/ustring.h"
 #include "generic_6dof_joint_bullet.h"
+#include "godot_task_scheduler.h"
 #include "hinge_joint_bullet.h"
 #include "pin_joint_bullet.h"
 #include "shape_bullet.h"
@@ -76,12 +78,15 @@
 
 void BulletPhysicsServer::_bind_methods() {
 	//ClassDB::bind_method(D_METHOD("DoTest"), &BulletPhysicsServer::DoTest);
+	ClassDB::bind_method(D_METHOD("set_thread_count", "count"), &BulletPhysicsServer::set_thread_count);
+	ClassDB::bind_method(D_METHOD("get_thread_count"), &BulletPhysicsServer::get_thread_count);
 }
 
 BulletPhysicsServer::BulletPhysicsServer() :
 		PhysicsServer(),
 		active(true),
-		active_spaces_count(0) {}
+		active_spaces_count(0),
+		task_scheduler(NULL) {}
 
 BulletPhysicsServer::~BulletPhysicsServer() {}
 
@@ -173,7 +178,7 @@ real_t BulletPhysicsServer::shape_get_custom_solver_bias(RID p_shape) const {
 }
 
 RID BulletPhysicsServer::space_create() {
-	SpaceBullet *space = bulletnew(SpaceBullet);
+	SpaceBullet *space = bulletnew(SpaceBullet(task_scheduler && task_scheduler->getNumThreads() > 1));
 	CreateThenReturnRID(space_owner, space);
 }
 
@@ -242,6 +247,14 @@ int BulletPhysicsServer::space_get_contact_count(RID p_space) const {
 	return space->get_debug_contact_count();
 }
 
+PoolVector<uint8_t> BulletPhysicsServer::space_get_snapshot(RID p_space) const {
+	ERR_FAIL_V_MSG(PoolVector<uint8_t>(), "Space snapshots are not supported by the Bullet backend.");
+}
+
+Error BulletPhysicsServer::space_restore_snapshot(RID p_space, const PoolVector<uint8_t> &p_snapshot) {
+	ERR_FAIL_V_MSG(ERR_UNAVAILABLE, "Space snapshots are not supported by the Bullet backend.");
+}
+
 RID BulletPhysicsServer::area_create() {
 	AreaBullet *area = bulletnew(AreaBullet);
 	area->set_collision_layer(1);
@@ -438,6 +451,13 @@ void BulletPhysicsServer::area_set_area_monitor_callback(RID p_area, Object *p_r
 	area->set_event_callback(CollisionObjectBullet::TYPE_AREA, p_receiver ? p_receiver->get_instance_id() : 0, p_method);
 }
 
+void BulletPhysicsServer::area_set_monitor_batching(RID p_area, bool p_enable) {
+	AreaBullet *area = area_owner.get(p_area);
+	ERR_FAIL_COND(!area);
+
+	area->set_monitor_batching(p_enable);
+}
+
 void BulletPhysicsServer::area_set_ray_pickable(RID p_area, bool p_enable) {
 	AreaBullet *area = area_owner.get(p_area);
 	ERR_FAIL_COND(!area);
@@ -847,6 +867,12 @@ void BulletPhysicsServer::body_set_force_integration_callback(RID p_body, Object
 	body->set_force_integration_callback(p_receiver ? p_receiver->get_instance_id() : ObjectID(0), p_method, p_udata);
 }
 
+void BulletPhysicsServer::body_set_state_sync_callback(RID p_body, Object *p_receiver, BodyStateSyncCallback p_callback) {
+	RigidBodyBullet *body = rigid_body_owner.get(p_body);
+	ERR_FAIL_COND(!body);
+	body->set_state_sync_callback(p_receiver ? p_receiver->get_instance_id() : ObjectID(0), p_callback);
+}
+
 void BulletPhysicsServer::body_set_ray_pickable(RID p_body, bool p_enable) {
 	RigidBodyBullet *body = rigid_body_owner.get(p_body);
 	ERR_FAIL_COND(!body);
@@ -1538,6 +1564,15 @@ void BulletPhysicsServer::free(RID p_rid) {
 
 void BulletPhysicsServer::init() {
 	BulletPhysicsDirectBodyState::initSingleton();
+
+	int thread_count = GLOBAL_GET("physics/3d/bullet/thread_count");
+	if (thread_count != 1) {
+		if (GLOBAL_GET("physics/3d/active_soft_world")) {
+			WARN_PRINT("Bullet can only step the world on multiple threads when \"physics/3d/active_soft_world\" is disabled.");
+		} else {
+			set_thread_count(thread_count);
+		}
+	}
 }
 
 void BulletPhysicsServer::step(float p_deltaTime) {
@@ -1552,17 +1587,47 @@ void BulletPhysicsServer::step(float p_deltaTime) {
 	}
 }
 
+void BulletPhysicsServer::sync() {
+}
+
 void BulletPhysicsServer::flush_queries() {
 }
 
+void BulletPhysicsServer::end_sync() {
+}
+
 void BulletPhysicsServer::finish() {
 	BulletPhysicsDirectBodyState::destroySingleton();
+
+	if (task_scheduler) {
+		btSetTaskScheduler(NULL);
+		memdelete(task_scheduler);
+		task_scheduler = NULL;
+	}
 }
 
 int BulletPhysicsServer::get_process_info(ProcessInfo p_info) {
 	return 0;
 }
 
+void BulletPhysicsServer::set_thread_count(int p_count) {
+#if BT_THREADSAFE
+	if (!task_scheduler) {
+		task_scheduler = memnew(GodotTaskScheduler);
+		task_scheduler->setNumThreads(p_count);
+		btSetTaskScheduler(task_scheduler);
+	} else {
+		task_scheduler->setNumThreads(p_count);
+	}
+#else
+	ERR_FAIL_COND_MSG(p_count != 1, "Bullet was built without BT_THREADSAFE, it can only step the world on one thread.");
+#endif
+}
+
+int BulletPhysicsServer::get_thread_count() const {
+	return task_scheduler ? task_scheduler->getNumThreads() : 1;
+}
+
 CollisionObjectBullet *BulletPhysicsServer::get_collisin_object(RID p_object) const {
 	if (rigid_body_owner.owns(p_object)) {
 		return rigid_body_owner.getornull(p_object);
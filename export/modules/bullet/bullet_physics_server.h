@@ -44,6 +44,8 @@
 	@author AndreaCatania
 */
 
+class GodotTaskScheduler;
+
 class BulletPhysicsServer : public PhysicsServer {
 	GDCLASS(BulletPhysicsServer, PhysicsServer);
 
@@ -53,6 +55,10 @@ class BulletPhysicsServer : public PhysicsServer {
 	char active_spaces_count;
 	Vector<SpaceBullet *> active_spaces;
 
+	// Only set up once more than one thread is asked for, spaces created
+	// while it runs more than one thread use a multithreaded Bullet world.
+	GodotTaskScheduler *task_scheduler;
+
 	mutable RID_Owner<SpaceBullet> space_owner;
 	mutable RID_Owner<ShapeBullet> shape_owner;
 	mutable RID_Owner<AreaBullet> area_owner;
@@ -117,6 +123,9 @@ public:
 	virtual Vector<Vector3> space_get_contacts(RID p_space) const;
 	virtual int space_get_contact_count(RID p_space) const;
 
+	virtual PoolVector<uint8_t> space_get_snapshot(RID p_space) const;
+	virtual Error space_restore_snapshot(RID p_space, const PoolVector<uint8_t> &p_snapshot);
+
 	/* AREA API */
 
 	/// Bullet Physics Engine not support "Area", this must be handled by the game developer in another way.
@@ -161,6 +170,7 @@ public:
 	virtual void area_set_monitorable(RID p_area, bool p_monitorable);
 	virtual void area_set_monitor_callback(RID p_area, Object *p_receiver, const StringName &p_method);
 	virtual void area_set_area_monitor_callback(RID p_area, Object *p_receiver, const StringName &p_method);
+	virtual void area_set_monitor_batching(RID p_area, bool p_enable);
 	virtual void area_set_ray_pickable(RID p_area, bool p_enable);
 	virtual bool area_is_ray_pickable(RID p_area) const;
 
@@ -247,6 +257,7 @@ public:
 	virtual bool body_is_omitting_force_integration(RID p_body) const;
 
 	virtual void body_set_force_integration_callback(RID p_body, Object *p_receiver, const StringName &p_method, const Variant &p_udata = Variant());
+	virtual void body_set_state_sync_callback(RID p_body, Object *p_receiver, BodyStateSyncCallback p_callback);
 
 	virtual void body_set_ray_pickable(RID p_body, bool p_enable);
 	virtual bool body_is_ray_pickable(RID p_body) const;
@@ -256,6 +267,9 @@ public:
 
 	virtual bool body_test_motion(RID p_body, const Transform &p_from, const Vector3 &p_motion, bool p_infinite_inertia, MotionResult *r_result = NULL, bool p_exclude_raycast_shapes = true);
 	virtual int body_test_ray_separation(RID p_body, const Transform &p_transform, bool p_infinite_inertia, Vector3 &r_recover_motion, SeparationResult *r_results, int p_result_max, float p_margin = 0.001);
+	// Bullet keeps querying its own broadphase for every motion test.
+	virtual void body_begin_motion_batch(RID p_body, const Transform &p_from, real_t p_max_distance) {}
+	virtual void body_end_motion_batch(RID p_body) {}
 
 	/* SOFT BODY API */
 
@@ -393,13 +407,19 @@ public:
 
 	virtual void init();
 	virtual void step(float p_deltaTime);
+	virtual void sync();
 	virtual void flush_queries();
+	virtual void end_sync();
 	virtual void finish();
 
 	virtual bool is_flushing_queries() const { return false; }
 
 	virtual int get_process_info(ProcessInfo p_info);
 
+	// Applies to the spaces created afterwards, p_count <= 0 means one thread per logical core.
+	void set_thread_count(int p_count);
+	int get_thread_count() const;
+
 	CollisionObjectBullet *get_collisin_object(RID p_object) const;
 	RigidCollisionObjectBullet *get_rigid_collisin_object(RID p_object) const;
 
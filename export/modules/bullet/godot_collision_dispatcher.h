@@ -33,6 +33,7 @@
 
 #include "core/int_types.h"
 
+#include <BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h>
 #include <btBulletDynamicsCommon.h>
 
 /**
@@ -45,8 +46,19 @@ private:
 	static const int CASTED_TYPE_AREA;
 
 public:
+	/// Areas only need the broadphase pair, never a narrowphase or a response
+	static bool is_area_pair(const btCollisionObject *body0, const btCollisionObject *body1);
+
 	GodotCollisionDispatcher(btCollisionConfiguration *collisionConfiguration);
 	virtual bool needsCollision(const btCollisionObject *body0, const btCollisionObject *body1);
 	virtual bool needsResponse(const btCollisionObject *body0, const btCollisionObject *body1);
 };
+
+/// Same behaviour, for the multithreaded world where the narrowphase runs in parallel
+class GodotCollisionDispatcherMt : public btCollisionDispatcherMt {
+public:
+	GodotCollisionDispatcherMt(btCollisionConfiguration *collisionConfiguration);
+	virtual bool needsCollision(const btCollisionObject *body0, const btCollisionObject *body1);
+	virtual bool needsResponse(const btCollisionObject *body0, const btCollisionObject *body1);
+};
 #endif
@@ -0,0 +1,150 @@
+/*************************************************************************/
+/*  godot_task_scheduler.cpp                                             */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "godot_task_scheduler.h"
+
+#include "core/local_vector.h"
+#include "core/os/os.h"
+
+// Defined by Bullet next to its own schedulers, they let the Mt solvers know
+// that a parallel loop is in progress.
+void btPushThreadsAreRunning();
+void btPopThreadsAreRunning();
+
+void GodotTaskScheduler::_for_chunk(uint32_t p_index, ForLoop *p_loop) {
+
+	int begin = p_loop->begin + p_index * p_loop->grain_size;
+	p_loop->for_body->forLoop(begin, MIN(begin + p_loop->grain_size, p_loop->end));
+}
+
+void GodotTaskScheduler::_sum_chunk(uint32_t p_index, ForLoop *p_loop) {
+
+	int begin = p_loop->begin + p_index * p_loop->grain_size;
+	p_loop->sums[p_index] = p_loop->sum_body->sumLoop(begin, MIN(begin + p_loop->grain_size, p_loop->end));
+}
+
+int GodotTaskScheduler::getMaxNumThreads() const {
+
+	return BT_MAX_THREAD_COUNT;
+}
+
+int GodotTaskScheduler::getNumThreads() const {
+
+	return work_pool.get_thread_count();
+}
+
+void GodotTaskScheduler::setNumThreads(int p_thread_count) {
+
+	if (p_thread_count <= 0) {
+		p_thread_count = OS::get_singleton()->get_processor_count();
+	}
+	p_thread_count = CLAMP(p_thread_count, 1, (int)BT_MAX_THREAD_COUNT);
+
+	if (work_pool.is_initialized() && p_thread_count == work_pool.get_thread_count()) {
+		return;
+	}
+
+	work_pool.finish();
+	// the new workers are numbered again from 1, Bullet keeps per thread data by index
+	btResetThreadIndexCounter();
+	work_pool.init(p_thread_count);
+}
+
+void GodotTaskScheduler::parallelFor(int p_begin, int p_end, int p_grain_size, const btIParallelForBody &p_body) {
+
+	int grain_size = MAX(p_grain_size, 1);
+	int chunks = (p_end - p_begin + grain_size - 1) / grain_size;
+
+	// loops started from inside another loop run on the thread that reached them
+	if (chunks <= 1 || running) {
+		if (p_end > p_begin) {
+			p_body.forLoop(p_begin, p_end);
+		}
+		return;
+	}
+
+	ForLoop loop;
+	loop.begin = p_begin;
+	loop.end = p_end;
+	loop.grain_size = grain_size;
+	loop.for_body = &p_body;
+	loop.sum_body = NULL;
+	loop.sums = NULL;
+
+	running = true;
+	btPushThreadsAreRunning();
+	work_pool.do_work(chunks, this, &GodotTaskScheduler::_for_chunk, &loop);
+	btPopThreadsAreRunning();
+	running = false;
+}
+
+btScalar GodotTaskScheduler::parallelSum(int p_begin, int p_end, int p_grain_size, const btIParallelSumBody &p_body) {
+
+	int grain_size = MAX(p_grain_size, 1);
+	int chunks = (p_end - p_begin + grain_size - 1) / grain_size;
+
+	if (chunks <= 1 || running) {
+		return p_end > p_begin ? p_body.sumLoop(p_begin, p_end) : btScalar(0);
+	}
+
+	LocalVector<btScalar> sums;
+	sums.resize(chunks);
+
+	ForLoop loop;
+	loop.begin = p_begin;
+	loop.end = p_end;
+	loop.grain_size = grain_size;
+	loop.for_body = NULL;
+	loop.sum_body = &p_body;
+	loop.sums = sums.ptr();
+
+	running = true;
+	btPushThreadsAreRunning();
+	work_pool.do_work(chunks, this, &GodotTaskScheduler::_sum_chunk, &loop);
+	btPopThreadsAreRunning();
+	running = false;
+
+	// added up in chunk order, so the result doesn't depend on the threads
+	btScalar sum = 0;
+	for (int i = 0; i < chunks; i++) {
+		sum += sums[i];
+	}
+	return sum;
+}
+
+GodotTaskScheduler::GodotTaskScheduler() :
+		btITaskScheduler("Godot"),
+		running(false) {
+}
+
+GodotTaskScheduler::~GodotTaskScheduler() {
+
+	work_pool.finish();
+}
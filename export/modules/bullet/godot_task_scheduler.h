@@ -0,0 +1,69 @@
+/*************************************************************************/
+/*  godot_task_scheduler.h                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef GODOT_TASK_SCHEDULER_H
+#define GODOT_TASK_SCHEDULER_H
+
+#include "core/os/thread_work_pool.h"
+
+#include <LinearMath/btThreads.h>
+
+/// Runs the parallel loops of the multithreaded Bullet classes on the
+/// engine's worker threads instead of the pthreads/Win32 pool Bullet ships.
+class GodotTaskScheduler : public btITaskScheduler {
+
+	struct ForLoop {
+		int begin;
+		int end;
+		int grain_size;
+		const btIParallelForBody *for_body;
+		const btIParallelSumBody *sum_body;
+		btScalar *sums;
+	};
+
+	ThreadWorkPool work_pool;
+	bool running;
+
+	void _for_chunk(uint32_t p_index, ForLoop *p_loop);
+	void _sum_chunk(uint32_t p_index, ForLoop *p_loop);
+
+public:
+	virtual int getMaxNumThreads() const;
+	virtual int getNumThreads() const;
+	// p_thread_count counts the physics thread, <= 0 means one per logical core.
+	virtual void setNumThreads(int p_thread_count);
+	virtual void parallelFor(int p_begin, int p_end, int p_grain_size, const btIParallelForBody &p_body);
+	virtual btScalar parallelSum(int p_begin, int p_end, int p_grain_size, const btIParallelSumBody &p_body);
+
+	GodotTaskScheduler();
+	~GodotTaskScheduler();
+};
+
+#endif
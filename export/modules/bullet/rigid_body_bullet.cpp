@@ -274,7 +274,9 @@ RigidBodyBullet::RigidBodyBullet() :
 		countGravityPointSpaces(0),
 		isScratchedSpaceOverrideModificator(false),
 		previousActiveState(true),
-		force_integration_callback(NULL) {
+		force_integration_callback(NULL),
+		state_sync_id(0),
+		state_sync_callback(NULL) {
 
 	godotMotionState = bulletnew(GodotMotionState(this));
 
@@ -353,25 +355,36 @@ void RigidBodyBullet::set_space(SpaceBullet *p_space) {
 
 void RigidBodyBullet::dispatch_callbacks() {
 	/// The check isFirstTransformChanged is necessary in order to call integrated forces only when the first transform is sent
-	if ((btBody->isKinematicObject() || btBody->isActive() || previousActiveState != btBody->isActive()) && force_integration_callback && can_integrate_forces) {
+	if ((btBody->isKinematicObject() || btBody->isActive() || previousActiveState != btBody->isActive()) && (force_integration_callback || state_sync_callback) && can_integrate_forces) {
 
 		if (omit_forces_integration)
 			btBody->clearForces();
 
-		BulletPhysicsDirectBodyState *bodyDirect = BulletPhysicsDirectBodyState::get_singleton(this);
+		if (force_integration_callback) {
+			BulletPhysicsDirectBodyState *bodyDirect = BulletPhysicsDirectBodyState::get_singleton(this);
 
-		Variant variantBodyDirect = bodyDirect;
+			Variant variantBodyDirect = bodyDirect;
 
-		Object *obj = ObjectDB::get_instance(force_integration_callback->id);
-		if (!obj) {
-			// Remove integration callback
-			set_force_integration_callback(0, StringName());
-		} else {
-			const Variant *vp[2] = { &variantBodyDirect, &force_integration_callback->udata };
+			Object *obj = ObjectDB::get_instance(force_integration_callback->id);
+			if (!obj) {
+				// Remove integration callback
+				set_force_integration_callback(0, StringName());
+			} else {
+				const Variant *vp[2] = { &variantBodyDirect, &force_integration_callback->udata };
 
-			Variant::CallError responseCallError;
-			int argc = (force_integration_callback->udata.get_type() == Variant::NIL) ? 1 : 2;
-			obj->call(force_integration_callback->method, vp, argc, responseCallError);
+				Variant::CallError responseCallError;
+				int argc = (force_integration_callback->udata.get_type() == Variant::NIL) ? 1 : 2;
+				obj->call(force_integration_callback->method, vp, argc, responseCallError);
+			}
+		} else {
+			// Packed and handed over by the space once every body is dispatched
+			PhysicsServer::BodyStateSync &state = space->get_state_sync_queue().push(state_sync_callback);
+			state.instance_id = state_sync_id;
+			state.transform = get_transform();
+			state.linear_velocity = get_linear_velocity();
+			state.angular_velocity = get_angular_velocity();
+			B_TO_G(btBody->getInvInertiaTensorWorld(), state.inverse_inertia_tensor);
+			state.sleeping = !is_active();
 		}
 	}
 
@@ -402,6 +415,11 @@ void RigidBodyBullet::set_force_integration_callback(ObjectID p_id, const String
 	}
 }
 
+void RigidBodyBullet::set_state_sync_callback(ObjectID p_id, PhysicsServer::BodyStateSyncCallback p_callback) {
+	state_sync_id = p_callback ? p_id : ObjectID(0);
+	state_sync_callback = p_id != 0 ? p_callback : NULL;
+}
+
 void RigidBodyBullet::scratch_space_override_modificator() {
 	isScratchedSpaceOverrideModificator = true;
 }
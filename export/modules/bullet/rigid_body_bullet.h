@@ -227,6 +227,9 @@ private:
 
 	ForceIntegrationCallback *force_integration_callback;
 
+	ObjectID state_sync_id;
+	PhysicsServer::BodyStateSyncCallback state_sync_callback;
+
 public:
 	RigidBodyBullet();
 	~RigidBodyBullet();
@@ -243,6 +246,7 @@ public:
 
 	virtual void dispatch_callbacks();
 	void set_force_integration_callback(ObjectID p_id, const StringName &p_method, const Variant &p_udata = Variant());
+	void set_state_sync_callback(ObjectID p_id, PhysicsServer::BodyStateSyncCallback p_callback);
 	void scratch_space_override_modificator();
 
 	virtual void on_collision_filters_change();
@@ -48,6 +48,8 @@
 #include <BulletCollision/NarrowPhaseCollision/btGjkEpaPenetrationDepthSolver.h>
 #include <BulletCollision/NarrowPhaseCollision/btGjkPairDetector.h>
 #include <BulletCollision/NarrowPhaseCollision/btPointCollector.h>
+#include <BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolverMt.h>
+#include <BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h>
 #include <BulletSoftBody/btSoftBodyRigidBodyCollisionConfiguration.h>
 #include <BulletSoftBody/btSoftRigidDynamicsWorld.h>
 #include <btBulletDynamicsCommon.h>
@@ -346,11 +348,12 @@ Vector3 BulletPhysicsDirectSpaceState::get_closest_point_to_object_volume(RID p_
 	}
 }
 
-SpaceBullet::SpaceBullet() :
+SpaceBullet::SpaceBullet(bool p_multithreaded) :
 		broadphase(NULL),
 		collisionConfiguration(NULL),
 		dispatcher(NULL),
 		solver(NULL),
+		solver_mt(NULL),
 		dynamicsWorld(NULL),
 		soft_body_world_info(NULL),
 		ghostPairCallback(NULL),
@@ -362,7 +365,7 @@ SpaceBullet::SpaceBullet() :
 		contactDebugCount(0),
 		delta_time(0.) {
 
-	create_empty_world(GLOBAL_DEF("physics/3d/active_soft_world", true));
+	create_empty_world(GLOBAL_DEF("physics/3d/active_soft_world", true), p_multithreaded);
 	direct_access = memnew(BulletPhysicsDirectSpaceState(this));
 }
 
@@ -376,6 +379,8 @@ void SpaceBullet::flush_queries() {
 	for (int i = colObjArray.size() - 1; 0 <= i; --i) {
 		static_cast<CollisionObjectBullet *>(colObjArray[i]->getUserPointer())->dispatch_callbacks();
 	}
+
+	state_sync_queue.flush();
 }
 
 void SpaceBullet::step(real_t p_delta_time) {
@@ -614,14 +619,19 @@ btScalar calculateGodotCombinedFriction(const btCollisionObject *body0, const bt
 	return ABS(MIN(body0->getFriction(), body1->getFriction()));
 }
 
-void SpaceBullet::create_empty_world(bool p_create_soft_world) {
+void SpaceBullet::create_empty_world(bool p_create_soft_world, bool p_multithreaded) {
 
 	gjk_epa_pen_solver = bulletnew(btGjkEpaPenetrationDepthSolver);
 	gjk_simplex_solver = bulletnew(btVoronoiSimplexSolver);
 
+	// the soft body world has no multithreaded version
+	p_multithreaded = p_multithreaded && !p_create_soft_world;
+
 	void *world_mem;
 	if (p_create_soft_world) {
 		world_mem = malloc(sizeof(btSoftRigidDynamicsWorld));
+	} else if (p_multithreaded) {
+		world_mem = malloc(sizeof(btDiscreteDynamicsWorldMt));
 	} else {
 		world_mem = malloc(sizeof(btDiscreteDynamicsWorld));
 	}
@@ -634,14 +644,23 @@ void SpaceBullet::create_empty_world(bool p_create_soft_world) {
 		collisionConfiguration = bulletnew(GodotCollisionConfiguration(static_cast<btDiscreteDynamicsWorld *>(world_mem)));
 	}
 
-	dispatcher = bulletnew(GodotCollisionDispatcher(collisionConfiguration));
 	broadphase = bulletnew(btDbvtBroadphase);
-	solver = bulletnew(btSequentialImpulseConstraintSolver);
 
-	if (p_create_soft_world) {
+	if (p_multithreaded) {
+		// narrowphase, islands and integration are split over the task scheduler set by the server
+		dispatcher = bulletnew(GodotCollisionDispatcherMt(collisionConfiguration));
+		btConstraintSolverPoolMt *solver_pool = bulletnew(btConstraintSolverPoolMt(btGetTaskScheduler()->getNumThreads()));
+		solver = solver_pool;
+		solver_mt = bulletnew(btSequentialImpulseConstraintSolverMt);
+		dynamicsWorld = new (world_mem) btDiscreteDynamicsWorldMt(dispatcher, broadphase, solver_pool, solver_mt, collisionConfiguration);
+	} else if (p_create_soft_world) {
+		dispatcher = bulletnew(GodotCollisionDispatcher(collisionConfiguration));
+		solver = bulletnew(btSequentialImpulseConstraintSolver);
 		dynamicsWorld = new (world_mem) btSoftRigidDynamicsWorld(dispatcher, broadphase, solver, collisionConfiguration);
 		soft_body_world_info = bulletnew(btSoftBodyWorldInfo);
 	} else {
+		dispatcher = bulletnew(GodotCollisionDispatcher(collisionConfiguration));
+		solver = bulletnew(btSequentialImpulseConstraintSolver);
 		dynamicsWorld = new (world_mem) btDiscreteDynamicsWorld(dispatcher, broadphase, solver, collisionConfiguration);
 	}
 
@@ -683,6 +702,7 @@ void SpaceBullet::destroy_world() {
 	dynamicsWorld = NULL;
 
 	bulletdelete(solver);
+	bulletdelete(solver_mt);
 	bulletdelete(broadphase);
 	bulletdelete(dispatcher);
 	bulletdelete(collisionConfiguration);
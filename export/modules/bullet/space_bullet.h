@@ -96,6 +96,7 @@ class SpaceBullet : public RIDBullet {
 	btDefaultCollisionConfiguration *collisionConfiguration;
 	btCollisionDispatcher *dispatcher;
 	btConstraintSolver *solver;
+	btConstraintSolver *solver_mt; // large islands of the multithreaded world
 	btDiscreteDynamicsWorld *dynamicsWorld;
 	btSoftBodyWorldInfo *soft_body_world_info;
 	btGhostPairCallback *ghostPairCallback;
@@ -117,11 +118,14 @@ class SpaceBullet : public RIDBullet {
 	int contactDebugCount;
 	real_t delta_time;
 
+	PhysicsServer::BodyStateSyncQueue state_sync_queue;
+
 public:
-	SpaceBullet();
+	SpaceBullet(bool p_multithreaded = false);
 	virtual ~SpaceBullet();
 
 	void flush_queries();
+	_FORCE_INLINE_ PhysicsServer::BodyStateSyncQueue &get_state_sync_queue() { return state_sync_queue; }
 	real_t get_delta_time() { return delta_time; }
 	void step(real_t p_delta_time);
 
@@ -188,7 +192,7 @@ public:
 	int test_ray_separation(RigidBodyBullet *p_body, const Transform &p_transform, bool p_infinite_inertia, Vector3 &r_recover_motion, PhysicsServer::SeparationResult *r_results, int p_result_max, float p_margin);
 
 private:
-	void create_empty_world(bool p_create_soft_world);
+	void create_empty_world(bool p_create_soft_world, bool p_multithreaded);
 	void destroy_world();
 	void check_ghost_overlaps();
 	void check_body_collision();
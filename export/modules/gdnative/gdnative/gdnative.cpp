@@ -187,6 +187,85 @@ godot_object *godot_object_cast_to(const godot_object *p_object, void *p_class_t
 	return o->is_class_ptr(p_class_tag) ? (godot_object *)o : NULL;
 }
 
+static MethodBind *_get_property_accessor(const StringName &p_class, const StringName &p_property, bool p_setter, int64_t &r_index) {
+
+	StringName accessor = p_setter ? ClassDB::get_property_setter(p_class, p_property) : ClassDB::get_property_getter(p_class, p_property);
+	if (accessor == StringName()) {
+		return NULL;
+	}
+
+	r_index = ClassDB::get_property_index(p_class, p_property);
+	MethodBind *mb = ClassDB::get_method(p_class, accessor);
+	if (mb && p_setter && mb->has_return()) {
+		return NULL; // there is nowhere to store the return value
+	}
+	return mb;
+}
+
+godot_bool GDAPI godot_object_get_property_batch(godot_object *const *p_objects, godot_int p_count, const godot_string_name *p_property, void *r_values, godot_int p_stride) {
+
+	const StringName &property = *(const StringName *)p_property;
+	uint8_t *values = (uint8_t *)r_values;
+
+	// objects in a batch usually share a class, so only resolve the getter again when it changes
+	StringName last_class;
+	MethodBind *getter = NULL;
+	int64_t index = -1;
+
+	for (godot_int i = 0; i < p_count; i++) {
+
+		Object *o = (Object *)p_objects[i];
+		ERR_FAIL_NULL_V(o, false);
+
+		if (o->get_class_name() != last_class) {
+			last_class = o->get_class_name();
+			getter = _get_property_accessor(last_class, property, false, index);
+		}
+		ERR_FAIL_COND_V_MSG(!getter, false, "Invalid getter '" + String(last_class) + "::" + String(property) + "' for batched property access.");
+
+		if (index >= 0) {
+			const void *args[1] = { &index };
+			getter->ptrcall(o, args, values + i * p_stride);
+		} else {
+			getter->ptrcall(o, NULL, values + i * p_stride);
+		}
+	}
+
+	return true;
+}
+
+godot_bool GDAPI godot_object_set_property_batch(godot_object *const *p_objects, godot_int p_count, const godot_string_name *p_property, const void *p_values, godot_int p_stride) {
+
+	const StringName &property = *(const StringName *)p_property;
+	const uint8_t *values = (const uint8_t *)p_values;
+
+	StringName last_class;
+	MethodBind *setter = NULL;
+	int64_t index = -1;
+
+	for (godot_int i = 0; i < p_count; i++) {
+
+		Object *o = (Object *)p_objects[i];
+		ERR_FAIL_NULL_V(o, false);
+
+		if (o->get_class_name() != last_class) {
+			last_class = o->get_class_name();
+			setter = _get_property_accessor(last_class, property, true, index);
+		}
+		ERR_FAIL_COND_V_MSG(!setter, false, "Invalid setter '" + String(last_class) + "::" + String(property) + "' for batched property access.");
+
+		if (index >= 0) {
+			const void *args[2] = { &index, values + i * p_stride };
+			setter->ptrcall(o, args, NULL);
+		} else {
+			const void *args[1] = { values + i * p_stride };
+			setter->ptrcall(o, args, NULL);
+		}
+	}
+
+	return true;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -985,6 +985,64 @@ void GDAPI godot_pool_color_array_write_access_destroy(godot_pool_color_array_wr
 	memdelete((PoolVector<Color>::Write *)p_write);
 }
 
+//
+// direct access functions
+//
+
+const uint8_t GDAPI *godot_pool_byte_array_ptr(const godot_pool_byte_array *p_self) {
+	const PoolVector<uint8_t> *self = (const PoolVector<uint8_t> *)p_self;
+	return self->read().ptr();
+}
+uint8_t GDAPI *godot_pool_byte_array_ptrw(godot_pool_byte_array *p_self) {
+	PoolVector<uint8_t> *self = (PoolVector<uint8_t> *)p_self;
+	return self->write().ptr();
+}
+
+const godot_int GDAPI *godot_pool_int_array_ptr(const godot_pool_int_array *p_self) {
+	const PoolVector<godot_int> *self = (const PoolVector<godot_int> *)p_self;
+	return self->read().ptr();
+}
+godot_int GDAPI *godot_pool_int_array_ptrw(godot_pool_int_array *p_self) {
+	PoolVector<godot_int> *self = (PoolVector<godot_int> *)p_self;
+	return self->write().ptr();
+}
+
+const godot_real GDAPI *godot_pool_real_array_ptr(const godot_pool_real_array *p_self) {
+	const PoolVector<godot_real> *self = (const PoolVector<godot_real> *)p_self;
+	return self->read().ptr();
+}
+godot_real GDAPI *godot_pool_real_array_ptrw(godot_pool_real_array *p_self) {
+	PoolVector<godot_real> *self = (PoolVector<godot_real> *)p_self;
+	return self->write().ptr();
+}
+
+const godot_vector2 GDAPI *godot_pool_vector2_array_ptr(const godot_pool_vector2_array *p_self) {
+	const PoolVector<Vector2> *self = (const PoolVector<Vector2> *)p_self;
+	return (const godot_vector2 *)self->read().ptr();
+}
+godot_vector2 GDAPI *godot_pool_vector2_array_ptrw(godot_pool_vector2_array *p_self) {
+	PoolVector<Vector2> *self = (PoolVector<Vector2> *)p_self;
+	return (godot_vector2 *)self->write().ptr();
+}
+
+const godot_vector3 GDAPI *godot_pool_vector3_array_ptr(const godot_pool_vector3_array *p_self) {
+	const PoolVector<Vector3> *self = (const PoolVector<Vector3> *)p_self;
+	return (const godot_vector3 *)self->read().ptr();
+}
+godot_vector3 GDAPI *godot_pool_vector3_array_ptrw(godot_pool_vector3_array *p_self) {
+	PoolVector<Vector3> *self = (PoolVector<Vector3> *)p_self;
+	return (godot_vector3 *)self->write().ptr();
+}
+
+const godot_color GDAPI *godot_pool_color_array_ptr(const godot_pool_color_array *p_self) {
+	const PoolVector<Color> *self = (const PoolVector<Color> *)p_self;
+	return (const godot_color *)self->read().ptr();
+}
+godot_color GDAPI *godot_pool_color_array_ptrw(godot_pool_color_array *p_self) {
+	PoolVector<Color> *self = (PoolVector<Color> *)p_self;
+	return (godot_color *)self->write().ptr();
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -295,6 +295,14 @@ godot_object GDAPI *godot_object_cast_to(const godot_object *p_object, void *p_c
 // equivalent of GDScript's instance_from_id
 godot_object GDAPI *godot_instance_from_id(godot_int p_instance_id);
 
+// GDNATIVE CORE 1.3
+
+// batched access to one engine class property across many objects, without going through godot_variant.
+// values use the same encoding as godot_method_bind_ptrcall (so r_values must hold constructed values for
+// non-POD types), one every p_stride bytes. returns false at the first object that doesn't have the property.
+godot_bool GDAPI godot_object_get_property_batch(godot_object *const *p_objects, godot_int p_count, const godot_string_name *p_property, void *r_values, godot_int p_stride);
+godot_bool GDAPI godot_object_set_property_batch(godot_object *const *p_objects, godot_int p_count, const godot_string_name *p_property, const void *p_values, godot_int p_stride);
+
 #ifdef __cplusplus
 }
 #endif
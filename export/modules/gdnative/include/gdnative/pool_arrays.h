@@ -471,6 +471,31 @@ godot_color GDAPI *godot_pool_color_array_write_access_ptr(const godot_pool_colo
 void GDAPI godot_pool_color_array_write_access_operator_assign(godot_pool_color_array_write_access *p_write, godot_pool_color_array_write_access *p_other);
 void GDAPI godot_pool_color_array_write_access_destroy(godot_pool_color_array_write_access *p_write);
 
+//
+// direct access functions
+//
+// The returned pointers stay valid until the array is resized, destroyed or
+// (for ptrw) copied, and skip creating a read/write access object per call.
+//
+
+const uint8_t GDAPI *godot_pool_byte_array_ptr(const godot_pool_byte_array *p_self);
+uint8_t GDAPI *godot_pool_byte_array_ptrw(godot_pool_byte_array *p_self);
+
+const godot_int GDAPI *godot_pool_int_array_ptr(const godot_pool_int_array *p_self);
+godot_int GDAPI *godot_pool_int_array_ptrw(godot_pool_int_array *p_self);
+
+const godot_real GDAPI *godot_pool_real_array_ptr(const godot_pool_real_array *p_self);
+godot_real GDAPI *godot_pool_real_array_ptrw(godot_pool_real_array *p_self);
+
+const godot_vector2 GDAPI *godot_pool_vector2_array_ptr(const godot_pool_vector2_array *p_self);
+godot_vector2 GDAPI *godot_pool_vector2_array_ptrw(godot_pool_vector2_array *p_self);
+
+const godot_vector3 GDAPI *godot_pool_vector3_array_ptr(const godot_pool_vector3_array *p_self);
+godot_vector3 GDAPI *godot_pool_vector3_array_ptrw(godot_pool_vector3_array *p_self);
+
+const godot_color GDAPI *godot_pool_color_array_ptr(const godot_pool_color_array *p_self);
+godot_color GDAPI *godot_pool_color_array_ptrw(godot_pool_color_array *p_self);
+
 #ifdef __cplusplus
 }
 #endif
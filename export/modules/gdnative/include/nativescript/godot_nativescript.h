@@ -243,6 +243,30 @@ void GDAPI *godot_nativescript_get_instance_binding_data(int p_idx, godot_object
 
 void GDAPI godot_nativescript_profiling_add_data(const char *p_signature, uint64_t p_time);
 
+/*
+ *
+ *
+ * NativeScript 1.2
+ *
+ *
+ */
+
+// typed method entry points, arguments and return value use the same encoding as godot_method_bind_ptrcall
+
+typedef struct {
+	// instance pointer, method data, user data, args, return value
+	GDCALLINGCONV void (*method)(godot_object *, void *, void *, const void **, void *);
+	void *method_data;
+	GDCALLINGCONV void (*free_func)(void *);
+} godot_instance_ptrcall_method;
+
+// adds a typed entry point to a method already registered with godot_nativescript_register_method
+void GDAPI godot_nativescript_set_method_ptrcall(void *p_gdnative_handle, const char *p_name, const char *p_function_name, godot_instance_ptrcall_method p_method);
+
+// calls the typed entry point of a method without boxing into godot_variant,
+// returns false when p_instance is not a NativeScript instance or the method has no typed entry point
+godot_bool GDAPI godot_nativescript_method_ptrcall(godot_object *p_instance, const godot_string_name *p_method, const void **p_args, void *r_ret);
+
 #ifdef __cplusplus
 }
 #endif
@@ -108,6 +108,9 @@ void GDAPI godot_nativescript_register_method(void *p_gdnative_handle, const cha
 
 	NativeScriptDesc::Method method;
 	method.method = p_method;
+	method.ptrcall.method = NULL;
+	method.ptrcall.method_data = NULL;
+	method.ptrcall.free_func = NULL;
 	method.rpc_mode = p_attr.rpc_type;
 	method.info = MethodInfo(p_function_name);
 
@@ -321,6 +324,39 @@ void GDAPI godot_nativescript_profiling_add_data(const char *p_signature, uint64
 	NativeScriptLanguage::get_singleton()->profiling_add_data(StringName(p_signature), p_time);
 }
 
+/*
+ *
+ *
+ * NativeScript 1.2
+ *
+ *
+ */
+
+void GDAPI godot_nativescript_set_method_ptrcall(void *p_gdnative_handle, const char *p_name, const char *p_function_name, godot_instance_ptrcall_method p_method) {
+	String *s = (String *)p_gdnative_handle;
+
+	Map<StringName, NativeScriptDesc>::Element *E = NSL->library_classes[*s].find(p_name);
+	ERR_FAIL_COND_MSG(!E, "Attempted to add a ptrcall entry point for a method on a non-existent class.");
+
+	Map<StringName, NativeScriptDesc::Method>::Element *method = E->get().methods.find(p_function_name);
+	ERR_FAIL_COND_MSG(!method, "Attempted to add a ptrcall entry point to non-existent method.");
+
+	if (method->get().ptrcall.free_func)
+		method->get().ptrcall.free_func(method->get().ptrcall.method_data);
+
+	method->get().ptrcall = p_method;
+}
+
+godot_bool GDAPI godot_nativescript_method_ptrcall(godot_object *p_instance, const godot_string_name *p_method, const void **p_args, void *r_ret) {
+	Object *instance = (Object *)p_instance;
+	if (!instance)
+		return false;
+	if (instance->get_script_instance() && instance->get_script_instance()->get_language() == NativeScriptLanguage::get_singleton()) {
+		return ((NativeScriptInstance *)instance->get_script_instance())->ptrcall(*(const StringName *)p_method, p_args, r_ret);
+	}
+	return false;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -731,6 +731,40 @@ Variant NativeScriptInstance::call(const StringName &p_method, const Variant **p
 	return Variant();
 }
 
+bool NativeScriptInstance::ptrcall(const StringName &p_method, const void **p_args, void *r_ret) {
+
+	NativeScriptDesc *script_data = GET_SCRIPT_DESC();
+
+	while (script_data) {
+		Map<StringName, NativeScriptDesc::Method>::Element *E = script_data->methods.find(p_method);
+		if (E) {
+			if (!E->get().ptrcall.method) {
+				return false;
+			}
+
+#ifdef DEBUG_ENABLED
+			current_method_call = p_method;
+#endif
+
+			E->get().ptrcall.method((godot_object *)owner,
+					E->get().ptrcall.method_data,
+					userdata,
+					p_args,
+					r_ret);
+
+#ifdef DEBUG_ENABLED
+			current_method_call = "";
+#endif
+
+			return true;
+		}
+
+		script_data = script_data->base_data;
+	}
+
+	return false;
+}
+
 void NativeScriptInstance::notification(int p_notification) {
 #ifdef DEBUG_ENABLED
 	if (p_notification == MainLoop::NOTIFICATION_CRASH) {
@@ -962,6 +996,9 @@ void NativeScriptLanguage::_unload_stuff(bool p_reload) {
 			for (Map<StringName, NativeScriptDesc::Method>::Element *M = C->get().methods.front(); M; M = M->next()) {
 				if (M->get().method.free_func)
 					M->get().method.free_func(M->get().method.method_data);
+
+				if (M->get().ptrcall.free_func)
+					M->get().ptrcall.free_func(M->get().ptrcall.method_data);
 			}
 
 			// free constructor/destructor
@@ -53,6 +53,7 @@ struct NativeScriptDesc {
 
 	struct Method {
 		godot_instance_method method;
+		godot_instance_ptrcall_method ptrcall;
 		MethodInfo info;
 		int rpc_mode;
 		String documentation;
@@ -206,6 +207,7 @@ public:
 	virtual void get_method_list(List<MethodInfo> *p_list) const;
 	virtual bool has_method(const StringName &p_method) const;
 	virtual Variant call(const StringName &p_method, const Variant **p_args, int p_argcount, Variant::CallError &r_error);
+	bool ptrcall(const StringName &p_method, const void **p_args, void *r_ret);
 	virtual void notification(int p_notification);
 	String to_string(bool *r_valid);
 	virtual Ref<Script> get_script() const;
@@ -576,7 +576,13 @@ Error GDScript::reload(bool p_keep_state) {
 
 	valid = false;
 	GDScriptParser parser;
-	Error err = parser.parse(source, basedir, false, path);
+	Error err;
+	if (!prefetched_tokens.empty()) {
+		err = parser.parse_bytecode(prefetched_tokens, basedir, path);
+		prefetched_tokens.clear();
+	} else {
+		err = parser.parse(source, basedir, false, path);
+	}
 	if (err) {
 		if (ScriptDebugger::get_singleton()) {
 			GDScriptLanguage::get_singleton()->debug_break_parse(get_path(), parser.get_error_line(), "Parser Error: " + parser.get_error());
@@ -807,6 +813,16 @@ Error GDScript::load_byte_code(const String &p_path) {
 
 Error GDScript::load_source_code(const String &p_path) {
 
+	String prefetched_source;
+	if (GDScriptLanguage::get_singleton()->get_parallel_loader().take(p_path, prefetched_source, prefetched_tokens)) {
+		source = prefetched_source;
+#ifdef TOOLS_ENABLED
+		source_changed_cache = true;
+#endif
+		path = p_path;
+		return OK;
+	}
+
 	PoolVector<uint8_t> sourcef;
 	Error err;
 	FileAccess *f = FileAccess::open(p_path, FileAccess::READ, &err);
@@ -1464,6 +1480,28 @@ void GDScriptLanguage::init() {
 
 		_add_global(E->get().name, E->get().ptr);
 	}
+
+	parallel_loader.init();
+	parallel_loader.prefetch_startup();
+
+#ifdef DEBUG_ENABLED
+	// The sampling profiler can be enabled from the project settings, or from the
+	// command line with `--gdscript-sampling-profile <file>` for headless runs.
+	if (GLOBAL_GET("debug/gdscript/sampling_profiler/enabled")) {
+		sampling_profiler_output = GLOBAL_GET("debug/gdscript/sampling_profiler/output_path");
+	}
+
+	List<String> args = OS::get_singleton()->get_cmdline_args();
+	for (List<String>::Element *E = args.front(); E; E = E->next()) {
+		if (E->get() == "--gdscript-sampling-profile" && E->next()) {
+			sampling_profiler_output = E->next()->get();
+		}
+	}
+
+	if (sampling_profiler_output != "") {
+		sampling_profiler->start(GLOBAL_GET("debug/gdscript/sampling_profiler/sample_rate"));
+	}
+#endif
 }
 
 String GDScriptLanguage::get_type() const {
@@ -1480,6 +1518,20 @@ Error GDScriptLanguage::execute_file(const String &p_path) {
 	return OK;
 }
 void GDScriptLanguage::finish() {
+
+	parallel_loader.clear();
+
+#ifdef DEBUG_ENABLED
+	if (GDScriptSamplingProfiler::is_recording()) {
+		sampling_profiler->stop();
+		if (sampling_profiler_output != "") {
+			Error err = sampling_profiler->save(sampling_profiler_output, GDScriptSamplingProfiler::get_format_for_path(sampling_profiler_output));
+			if (err == OK) {
+				print_line("GDScript sampling profile (" + itos(sampling_profiler->get_sample_count()) + " samples) saved to: " + sampling_profiler_output);
+			}
+		}
+	}
+#endif
 }
 
 void GDScriptLanguage::profiling_start() {
@@ -2140,6 +2192,8 @@ GDScriptLanguage::GDScriptLanguage() {
 	profiling = false;
 	script_frame_time = 0;
 
+	GLOBAL_DEF("gdscript/loading/parallel_prefetch", true);
+
 	_debug_call_stack_pos = 0;
 	int dmcs = GLOBAL_DEF("debug/settings/gdscript/max_call_stack", 1024);
 	ProjectSettings::get_singleton()->set_custom_property_info("debug/settings/gdscript/max_call_stack", PropertyInfo(Variant::INT, "debug/settings/gdscript/max_call_stack", PROPERTY_HINT_RANGE, "1024,4096,1,or_greater")); //minimum is 1024
@@ -2165,6 +2219,14 @@ GDScriptLanguage::GDScriptLanguage() {
 		bool default_enabled = !warning.begins_with("unsafe_") && i != GDScriptWarning::UNUSED_CLASS_VARIABLE;
 		GLOBAL_DEF("debug/gdscript/warnings/" + warning, default_enabled);
 	}
+
+	GLOBAL_DEF("debug/gdscript/sampling_profiler/enabled", false);
+	GLOBAL_DEF("debug/gdscript/sampling_profiler/sample_rate", 1000);
+	ProjectSettings::get_singleton()->set_custom_property_info("debug/gdscript/sampling_profiler/sample_rate", PropertyInfo(Variant::INT, "debug/gdscript/sampling_profiler/sample_rate", PROPERTY_HINT_RANGE, "10,10000,1,or_greater"));
+	GLOBAL_DEF("debug/gdscript/sampling_profiler/output_path", "user://gdscript_profile.folded");
+	GLOBAL_DEF("debug/gdscript/sampling_profiler/max_trace_samples", 1000000);
+
+	sampling_profiler = memnew(GDScriptSamplingProfiler);
 #endif // DEBUG_ENABLED
 }
 
@@ -2199,6 +2261,10 @@ GDScriptLanguage::~GDScriptLanguage() {
 		script->unreference();
 	}
 
+#ifdef DEBUG_ENABLED
+	memdelete(sampling_profiler);
+#endif
+
 	singleton = NULL;
 }
 
@@ -2237,6 +2303,11 @@ RES ResourceFormatLoaderGDScript::load(const String &p_path, const String &p_ori
 		ERR_FAIL_COND_V_MSG(err != OK, RES(), "Cannot load byte code from file '" + p_path + "'.");
 
 	} else {
+		// Read and tokenize the scripts this one depends on in parallel, before they get loaded while parsing it.
+		Vector<String> prefetch_paths;
+		prefetch_paths.push_back(p_path);
+		GDScriptLanguage::get_singleton()->get_parallel_loader().prefetch(prefetch_paths);
+
 		Error err = script->load_source_code(p_path);
 		ERR_FAIL_COND_V_MSG(err != OK, RES(), "Cannot load source code from file '" + p_path + "'.");
 
@@ -2244,6 +2315,7 @@ RES ResourceFormatLoaderGDScript::load(const String &p_path, const String &p_ori
 		script->set_path(p_original_path);
 
 		script->reload();
+		GDScriptLanguage::get_singleton()->get_parallel_loader().finish(p_path);
 	}
 	if (r_error)
 		*r_error = OK;
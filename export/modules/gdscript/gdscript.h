@@ -35,6 +35,8 @@
 #include "core/io/resource_saver.h"
 #include "core/script_language.h"
 #include "gdscript_function.h"
+#include "gdscript_parallel_loader.h"
+#include "gdscript_sampling_profiler.h"
 
 class GDScriptNativeClass : public Reference {
 
@@ -108,6 +110,7 @@ class GDScript : public Script {
 	Set<Object *> instances;
 	//exported members
 	String source;
+	Vector<uint8_t> prefetched_tokens; // Token buffer of `source` from the parallel loader, used by the next reload().
 	String path;
 	String name;
 	String fully_qualified_name;
@@ -362,8 +365,17 @@ class GDScriptLanguage : public ScriptLanguage {
 	bool profiling;
 	uint64_t script_frame_time;
 
+#ifdef DEBUG_ENABLED
+	friend class GDScriptSamplingProfiler;
+
+	GDScriptSamplingProfiler *sampling_profiler;
+	String sampling_profiler_output;
+#endif
+
 	Map<String, ObjectID> orphan_subclasses;
 
+	GDScriptParallelLoader parallel_loader;
+
 public:
 	int calls;
 
@@ -445,6 +457,8 @@ public:
 
 	_FORCE_INLINE_ static GDScriptLanguage *get_singleton() { return singleton; }
 
+	_FORCE_INLINE_ GDScriptParallelLoader &get_parallel_loader() { return parallel_loader; }
+
 	virtual String get_name() const;
 
 	/* LANGUAGE FUNCTIONS */
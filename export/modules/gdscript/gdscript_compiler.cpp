@@ -616,8 +616,32 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 							arguments.push_back(ret);
 						}
 
-						codegen.opcodes.push_back(GDScriptFunction::OPCODE_CALL_BUILT_IN);
-						codegen.opcodes.push_back(static_cast<const GDScriptParser::BuiltInFunctionNode *>(on->arguments[0])->function);
+						GDScriptFunctions::Function func = static_cast<const GDScriptParser::BuiltInFunctionNode *>(on->arguments[0])->function;
+
+						// Use a specialized version of the function if the argument types allow it.
+						Variant::Type arg_types[GDScriptFunctions::VALIDATED_MAX_ARGS];
+						int validated_idx = -1;
+						if (arguments.size() <= GDScriptFunctions::VALIDATED_MAX_ARGS) {
+							for (int i = 0; i < arguments.size(); i++) {
+								GDScriptParser::DataType arg_type = on->arguments[i + 1]->get_datatype();
+								if (!arg_type.has_type) {
+									arg_types[i] = Variant::VARIANT_MAX;
+								} else if (arg_type.kind == GDScriptParser::DataType::BUILTIN) {
+									arg_types[i] = arg_type.builtin_type;
+								} else {
+									arg_types[i] = Variant::OBJECT;
+								}
+							}
+							validated_idx = GDScriptFunctions::find_validated_builtin(func, arguments.size(), arg_types);
+						}
+
+						if (validated_idx >= 0) {
+							codegen.opcodes.push_back(GDScriptFunction::OPCODE_CALL_BUILT_IN_VALIDATED);
+							codegen.opcodes.push_back(validated_idx);
+						} else {
+							codegen.opcodes.push_back(GDScriptFunction::OPCODE_CALL_BUILT_IN);
+							codegen.opcodes.push_back(func);
+						}
 						codegen.opcodes.push_back(on->arguments.size() - 1);
 						codegen.alloc_call(on->arguments.size() - 1);
 						for (int i = 0; i < arguments.size(); i++)
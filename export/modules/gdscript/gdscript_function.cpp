@@ -216,6 +216,7 @@ String GDScriptFunction::_get_call_error(const Variant::CallError &p_err, const
 		&&OPCODE_CALL,                        \
 		&&OPCODE_CALL_RETURN,                 \
 		&&OPCODE_CALL_BUILT_IN,               \
+		&&OPCODE_CALL_BUILT_IN_VALIDATED,     \
 		&&OPCODE_CALL_SELF,                   \
 		&&OPCODE_CALL_SELF_BASE,              \
 		&&OPCODE_YIELD,                       \
@@ -427,6 +428,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 		profile.call_count++;
 		profile.frame_call_count++;
 	}
+	bool sampled = GDScriptSamplingProfiler::is_recording() && GDScriptSamplingProfiler::get_singleton()->push_frame(this, line);
 	bool exit_ok = false;
 	bool yielded = false;
 #endif
@@ -1173,6 +1175,54 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			}
 			DISPATCH_OPCODE;
 
+			OPCODE(OPCODE_CALL_BUILT_IN_VALIDATED) {
+
+				CHECK_SPACE(4);
+
+				int builtin_idx = _code_ptr[ip + 1];
+				GD_ERR_BREAK(builtin_idx < 0 || builtin_idx >= GDScriptFunctions::get_validated_builtin_count());
+				const GDScriptFunctions::ValidatedBuiltin &builtin = GDScriptFunctions::get_validated_builtin(builtin_idx);
+				int argc = _code_ptr[ip + 2];
+				GD_ERR_BREAK(argc != builtin.arg_count);
+
+				ip += 3;
+				CHECK_SPACE(argc + 1);
+				Variant **argptrs = call_args;
+
+				bool types_valid = true;
+				for (int i = 0; i < argc; i++) {
+					GET_VARIANT_PTR(v, i);
+					argptrs[i] = v;
+					types_valid = types_valid && GDScriptFunctions::validated_builtin_accepts(builtin, i, *v);
+				}
+
+				GET_VARIANT_PTR(dst, argc);
+
+				if (likely(types_valid)) {
+					builtin.call((const Variant **)argptrs, *dst);
+				} else {
+					// Types differ from what the compiler expected, use the generic path (and its errors).
+					Variant::CallError err;
+					GDScriptFunctions::call(builtin.function, (const Variant **)argptrs, argc, *dst, err);
+
+#ifdef DEBUG_ENABLED
+					if (err.error != Variant::CallError::CALL_OK) {
+
+						String methodstr = GDScriptFunctions::get_func_name(builtin.function);
+						if (dst->get_type() == Variant::STRING) {
+							//call provided error string
+							err_text = "Error calling built-in function '" + methodstr + "': " + String(*dst);
+						} else {
+							err_text = _get_call_error(err, "built-in function '" + methodstr + "'", (const Variant **)argptrs);
+						}
+						OPCODE_BREAK;
+					}
+#endif
+				}
+				ip += argc + 1;
+			}
+			DISPATCH_OPCODE;
+
 			OPCODE(OPCODE_CALL_SELF) {
 
 				OPCODE_BREAK;
@@ -1539,6 +1589,12 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				line = _code_ptr[ip + 1];
 				ip += 2;
 
+#ifdef DEBUG_ENABLED
+				if (sampled) {
+					GDScriptSamplingProfiler::get_singleton()->set_line(line);
+				}
+#endif
+
 				if (ScriptDebugger::get_singleton()) {
 					// line
 					bool do_break = false;
@@ -1620,6 +1676,10 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 		GDScriptLanguage::get_singleton()->script_frame_time += time_taken - function_call_time;
 	}
 
+	if (sampled) {
+		GDScriptSamplingProfiler::get_singleton()->pop_frame();
+	}
+
 	// Check if this is the last time the function is resuming from yield
 	// Will be true if never yielded as well
 	// When it's the last resume it will postpone the exit from stack,
@@ -1785,6 +1845,8 @@ GDScriptFunction::GDScriptFunction() :
 	profile.last_frame_call_count = 0;
 	profile.last_frame_self_time = 0;
 	profile.last_frame_total_time = 0;
+	sampling.session = 0;
+	sampling.id = 0;
 
 #endif
 }
@@ -181,6 +181,7 @@ public:
 		OPCODE_CALL,
 		OPCODE_CALL_RETURN,
 		OPCODE_CALL_BUILT_IN,
+		OPCODE_CALL_BUILT_IN_VALIDATED,
 		OPCODE_CALL_SELF,
 		OPCODE_CALL_SELF_BASE,
 		OPCODE_YIELD,
@@ -271,6 +272,7 @@ private:
 	_FORCE_INLINE_ String _get_call_error(const Variant::CallError &p_err, const String &p_where, const Variant **argptrs) const;
 
 	friend class GDScriptLanguage;
+	friend class GDScriptSamplingProfiler;
 
 	SelfList<GDScriptFunction> function_list;
 #ifdef DEBUG_ENABLED
@@ -290,6 +292,12 @@ private:
 		uint64_t last_frame_total_time;
 	} profile;
 
+	// Id of this function in the current GDScriptSamplingProfiler recording.
+	struct Sampling {
+		uint32_t session;
+		uint32_t id;
+	} sampling;
+
 #endif
 
 public:
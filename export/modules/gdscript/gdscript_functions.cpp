@@ -2072,3 +2072,281 @@ MethodInfo GDScriptFunctions::get_info(Function p_func) {
 	mi.return_val.usage |= PROPERTY_USAGE_NIL_IS_VARIANT;
 	return mi;
 }
+
+/* VALIDATED BUILT-IN FUNCTIONS */
+
+// These are selected by the compiler from the static argument types and
+// dispatched directly by the VM after a type check of each argument, skipping
+// the generic call() switch and its validation. They must give exactly the same
+// results as call() for the argument types they accept.
+
+#define ARG_NUM ((1 << Variant::INT) | (1 << Variant::REAL))
+#define ARG_INT (1 << Variant::INT)
+#define ARG_TYPE(m_type) (1 << Variant::m_type)
+
+#define VALIDATED_REAL_1(m_name, m_expr)                                          \
+	static void _validated_##m_name(const Variant **p_args, Variant &r_ret) { \
+		const double a = *p_args[0];                                              \
+		r_ret = m_expr;                                                           \
+	}
+
+#define VALIDATED_REAL_2(m_name, m_expr)                                          \
+	static void _validated_##m_name(const Variant **p_args, Variant &r_ret) { \
+		const double a = *p_args[0];                                              \
+		const double b = *p_args[1];                                              \
+		r_ret = m_expr;                                                           \
+	}
+
+#define VALIDATED_REAL_3(m_name, m_expr)                                          \
+	static void _validated_##m_name(const Variant **p_args, Variant &r_ret) { \
+		const double a = *p_args[0];                                              \
+		const double b = *p_args[1];                                              \
+		const double c = *p_args[2];                                              \
+		r_ret = m_expr;                                                           \
+	}
+
+VALIDATED_REAL_1(sin, Math::sin(a))
+VALIDATED_REAL_1(cos, Math::cos(a))
+VALIDATED_REAL_1(tan, Math::tan(a))
+VALIDATED_REAL_1(sinh, Math::sinh(a))
+VALIDATED_REAL_1(cosh, Math::cosh(a))
+VALIDATED_REAL_1(tanh, Math::tanh(a))
+VALIDATED_REAL_1(asin, Math::asin(a))
+VALIDATED_REAL_1(acos, Math::acos(a))
+VALIDATED_REAL_1(atan, Math::atan(a))
+VALIDATED_REAL_1(sqrt, Math::sqrt(a))
+VALIDATED_REAL_1(floor, Math::floor(a))
+VALIDATED_REAL_1(ceil, Math::ceil(a))
+VALIDATED_REAL_1(round, Math::round(a))
+VALIDATED_REAL_1(log, Math::log(a))
+VALIDATED_REAL_1(exp, Math::exp(a))
+VALIDATED_REAL_1(is_nan, Math::is_nan(a))
+VALIDATED_REAL_1(is_inf, Math::is_inf(a))
+VALIDATED_REAL_1(is_zero_approx, Math::is_zero_approx((real_t)a))
+VALIDATED_REAL_1(step_decimals, Math::step_decimals(a))
+VALIDATED_REAL_1(deg2rad, Math::deg2rad(a))
+VALIDATED_REAL_1(rad2deg, Math::rad2deg(a))
+VALIDATED_REAL_1(linear2db, Math::linear2db(a))
+VALIDATED_REAL_1(db2linear, Math::db2linear(a))
+
+VALIDATED_REAL_2(atan2, Math::atan2(a, b))
+VALIDATED_REAL_2(fmod, Math::fmod(a, b))
+VALIDATED_REAL_2(fposmod, Math::fposmod(a, b))
+VALIDATED_REAL_2(pow, Math::pow(a, b))
+VALIDATED_REAL_2(is_equal_approx, Math::is_equal_approx((real_t)a, (real_t)b))
+VALIDATED_REAL_2(ease, Math::ease(a, b))
+VALIDATED_REAL_2(stepify, Math::stepify(a, b))
+VALIDATED_REAL_2(rand_range, Math::random(a, b))
+VALIDATED_REAL_2(polar2cartesian, Vector2(a * Math::cos(b), a * Math::sin(b)))
+VALIDATED_REAL_2(cartesian2polar, Vector2(Math::sqrt(a * a + b * b), Math::atan2(b, a)))
+
+VALIDATED_REAL_3(lerp, Math::lerp(a, b, c))
+VALIDATED_REAL_3(lerp_angle, Math::lerp_angle(a, b, c))
+VALIDATED_REAL_3(inverse_lerp, Math::inverse_lerp(a, b, c))
+VALIDATED_REAL_3(smoothstep, Math::smoothstep(a, b, c))
+VALIDATED_REAL_3(move_toward, Math::move_toward(a, b, c))
+VALIDATED_REAL_3(wrapf, Math::wrapf(a, b, c))
+
+static void _validated_posmod(const Variant **p_args, Variant &r_ret) {
+	r_ret = Math::posmod((int64_t)*p_args[0], (int64_t)*p_args[1]);
+}
+
+static void _validated_wrapi(const Variant **p_args, Variant &r_ret) {
+	r_ret = Math::wrapi((int64_t)*p_args[0], (int64_t)*p_args[1], (int64_t)*p_args[2]);
+}
+
+static void _validated_nearest_po2(const Variant **p_args, Variant &r_ret) {
+	int64_t num = *p_args[0];
+	r_ret = next_power_of_2(num);
+}
+
+static void _validated_range_lerp(const Variant **p_args, Variant &r_ret) {
+	r_ret = Math::range_lerp((double)*p_args[0], (double)*p_args[1], (double)*p_args[2], (double)*p_args[3], (double)*p_args[4]);
+}
+
+static void _validated_randi(const Variant **p_args, Variant &r_ret) {
+	r_ret = Math::rand();
+}
+
+static void _validated_randf(const Variant **p_args, Variant &r_ret) {
+	r_ret = Math::randf();
+}
+
+// The following keep integer results when all the arguments are integers.
+
+static void _validated_abs(const Variant **p_args, Variant &r_ret) {
+	if (p_args[0]->get_type() == Variant::INT) {
+		int64_t i = *p_args[0];
+		r_ret = ABS(i);
+	} else {
+		double r = *p_args[0];
+		r_ret = Math::abs(r);
+	}
+}
+
+static void _validated_sign(const Variant **p_args, Variant &r_ret) {
+	if (p_args[0]->get_type() == Variant::INT) {
+		int64_t i = *p_args[0];
+		r_ret = i < 0 ? -1 : (i > 0 ? +1 : 0);
+	} else {
+		double r = *p_args[0];
+		r_ret = r < 0.0 ? -1.0 : (r > 0.0 ? +1.0 : 0.0);
+	}
+}
+
+static void _validated_max(const Variant **p_args, Variant &r_ret) {
+	if (p_args[0]->get_type() == Variant::INT && p_args[1]->get_type() == Variant::INT) {
+		int64_t a = *p_args[0];
+		int64_t b = *p_args[1];
+		r_ret = MAX(a, b);
+	} else {
+		double a = *p_args[0];
+		double b = *p_args[1];
+		r_ret = MAX(a, b);
+	}
+}
+
+static void _validated_min(const Variant **p_args, Variant &r_ret) {
+	if (p_args[0]->get_type() == Variant::INT && p_args[1]->get_type() == Variant::INT) {
+		int64_t a = *p_args[0];
+		int64_t b = *p_args[1];
+		r_ret = MIN(a, b);
+	} else {
+		double a = *p_args[0];
+		double b = *p_args[1];
+		r_ret = MIN(a, b);
+	}
+}
+
+static void _validated_clamp(const Variant **p_args, Variant &r_ret) {
+	if (p_args[0]->get_type() == Variant::INT && p_args[1]->get_type() == Variant::INT && p_args[2]->get_type() == Variant::INT) {
+		int64_t a = *p_args[0];
+		int64_t b = *p_args[1];
+		int64_t c = *p_args[2];
+		r_ret = CLAMP(a, b, c);
+	} else {
+		double a = *p_args[0];
+		double b = *p_args[1];
+		double c = *p_args[2];
+		r_ret = CLAMP(a, b, c);
+	}
+}
+
+static void _validated_lerp_vector2(const Variant **p_args, Variant &r_ret) {
+	r_ret = ((Vector2)*p_args[0]).linear_interpolate((Vector2)*p_args[1], (double)*p_args[2]);
+}
+
+static void _validated_lerp_vector3(const Variant **p_args, Variant &r_ret) {
+	r_ret = ((Vector3)*p_args[0]).linear_interpolate((Vector3)*p_args[1], (double)*p_args[2]);
+}
+
+static void _validated_lerp_color(const Variant **p_args, Variant &r_ret) {
+	r_ret = ((Color)*p_args[0]).linear_interpolate((Color)*p_args[1], (double)*p_args[2]);
+}
+
+static const GDScriptFunctions::ValidatedBuiltin _validated_builtins[] = {
+	{ GDScriptFunctions::MATH_SIN, 1, { ARG_NUM }, _validated_sin },
+	{ GDScriptFunctions::MATH_COS, 1, { ARG_NUM }, _validated_cos },
+	{ GDScriptFunctions::MATH_TAN, 1, { ARG_NUM }, _validated_tan },
+	{ GDScriptFunctions::MATH_SINH, 1, { ARG_NUM }, _validated_sinh },
+	{ GDScriptFunctions::MATH_COSH, 1, { ARG_NUM }, _validated_cosh },
+	{ GDScriptFunctions::MATH_TANH, 1, { ARG_NUM }, _validated_tanh },
+	{ GDScriptFunctions::MATH_ASIN, 1, { ARG_NUM }, _validated_asin },
+	{ GDScriptFunctions::MATH_ACOS, 1, { ARG_NUM }, _validated_acos },
+	{ GDScriptFunctions::MATH_ATAN, 1, { ARG_NUM }, _validated_atan },
+	{ GDScriptFunctions::MATH_ATAN2, 2, { ARG_NUM, ARG_NUM }, _validated_atan2 },
+	{ GDScriptFunctions::MATH_SQRT, 1, { ARG_NUM }, _validated_sqrt },
+	{ GDScriptFunctions::MATH_FMOD, 2, { ARG_NUM, ARG_NUM }, _validated_fmod },
+	{ GDScriptFunctions::MATH_FPOSMOD, 2, { ARG_NUM, ARG_NUM }, _validated_fposmod },
+	{ GDScriptFunctions::MATH_POSMOD, 2, { ARG_NUM, ARG_NUM }, _validated_posmod },
+	{ GDScriptFunctions::MATH_FLOOR, 1, { ARG_NUM }, _validated_floor },
+	{ GDScriptFunctions::MATH_CEIL, 1, { ARG_NUM }, _validated_ceil },
+	{ GDScriptFunctions::MATH_ROUND, 1, { ARG_NUM }, _validated_round },
+	{ GDScriptFunctions::MATH_ABS, 1, { ARG_NUM }, _validated_abs },
+	{ GDScriptFunctions::MATH_SIGN, 1, { ARG_NUM }, _validated_sign },
+	{ GDScriptFunctions::MATH_POW, 2, { ARG_NUM, ARG_NUM }, _validated_pow },
+	{ GDScriptFunctions::MATH_LOG, 1, { ARG_NUM }, _validated_log },
+	{ GDScriptFunctions::MATH_EXP, 1, { ARG_NUM }, _validated_exp },
+	{ GDScriptFunctions::MATH_ISNAN, 1, { ARG_NUM }, _validated_is_nan },
+	{ GDScriptFunctions::MATH_ISINF, 1, { ARG_NUM }, _validated_is_inf },
+	{ GDScriptFunctions::MATH_ISEQUALAPPROX, 2, { ARG_NUM, ARG_NUM }, _validated_is_equal_approx },
+	{ GDScriptFunctions::MATH_ISZEROAPPROX, 1, { ARG_NUM }, _validated_is_zero_approx },
+	{ GDScriptFunctions::MATH_EASE, 2, { ARG_NUM, ARG_NUM }, _validated_ease },
+	{ GDScriptFunctions::MATH_STEP_DECIMALS, 1, { ARG_NUM }, _validated_step_decimals },
+	{ GDScriptFunctions::MATH_STEPIFY, 2, { ARG_NUM, ARG_NUM }, _validated_stepify },
+	{ GDScriptFunctions::MATH_LERP, 3, { ARG_NUM, ARG_NUM, ARG_NUM }, _validated_lerp },
+	{ GDScriptFunctions::MATH_LERP, 3, { ARG_TYPE(VECTOR2), ARG_TYPE(VECTOR2), ARG_NUM }, _validated_lerp_vector2 },
+	{ GDScriptFunctions::MATH_LERP, 3, { ARG_TYPE(VECTOR3), ARG_TYPE(VECTOR3), ARG_NUM }, _validated_lerp_vector3 },
+	{ GDScriptFunctions::MATH_LERP, 3, { ARG_TYPE(COLOR), ARG_TYPE(COLOR), ARG_NUM }, _validated_lerp_color },
+	{ GDScriptFunctions::MATH_LERP_ANGLE, 3, { ARG_NUM, ARG_NUM, ARG_NUM }, _validated_lerp_angle },
+	{ GDScriptFunctions::MATH_INVERSE_LERP, 3, { ARG_NUM, ARG_NUM, ARG_NUM }, _validated_inverse_lerp },
+	{ GDScriptFunctions::MATH_RANGE_LERP, 5, { ARG_NUM, ARG_NUM, ARG_NUM, ARG_NUM, ARG_NUM }, _validated_range_lerp },
+	{ GDScriptFunctions::MATH_SMOOTHSTEP, 3, { ARG_NUM, ARG_NUM, ARG_NUM }, _validated_smoothstep },
+	{ GDScriptFunctions::MATH_MOVE_TOWARD, 3, { ARG_NUM, ARG_NUM, ARG_NUM }, _validated_move_toward },
+	{ GDScriptFunctions::MATH_RAND, 0, { 0 }, _validated_randi },
+	{ GDScriptFunctions::MATH_RANDF, 0, { 0 }, _validated_randf },
+	{ GDScriptFunctions::MATH_RANDOM, 2, { ARG_NUM, ARG_NUM }, _validated_rand_range },
+	{ GDScriptFunctions::MATH_DEG2RAD, 1, { ARG_NUM }, _validated_deg2rad },
+	{ GDScriptFunctions::MATH_RAD2DEG, 1, { ARG_NUM }, _validated_rad2deg },
+	{ GDScriptFunctions::MATH_LINEAR2DB, 1, { ARG_NUM }, _validated_linear2db },
+	{ GDScriptFunctions::MATH_DB2LINEAR, 1, { ARG_NUM }, _validated_db2linear },
+	{ GDScriptFunctions::MATH_POLAR2CARTESIAN, 2, { ARG_NUM, ARG_NUM }, _validated_polar2cartesian },
+	{ GDScriptFunctions::MATH_CARTESIAN2POLAR, 2, { ARG_NUM, ARG_NUM }, _validated_cartesian2polar },
+	{ GDScriptFunctions::MATH_WRAP, 3, { ARG_NUM, ARG_NUM, ARG_NUM }, _validated_wrapi },
+	{ GDScriptFunctions::MATH_WRAPF, 3, { ARG_NUM, ARG_NUM, ARG_NUM }, _validated_wrapf },
+	{ GDScriptFunctions::LOGIC_MAX, 2, { ARG_NUM, ARG_NUM }, _validated_max },
+	{ GDScriptFunctions::LOGIC_MIN, 2, { ARG_NUM, ARG_NUM }, _validated_min },
+	{ GDScriptFunctions::LOGIC_CLAMP, 3, { ARG_NUM, ARG_NUM, ARG_NUM }, _validated_clamp },
+	{ GDScriptFunctions::LOGIC_NEAREST_PO2, 1, { ARG_NUM }, _validated_nearest_po2 },
+};
+
+int GDScriptFunctions::find_validated_builtin(Function p_func, int p_arg_count, const Variant::Type *p_arg_types) {
+
+	if (p_arg_count > VALIDATED_MAX_ARGS) {
+		return -1;
+	}
+
+	int found = -1;
+	bool all_types_known = true;
+
+	for (int i = 0; i < get_validated_builtin_count(); i++) {
+
+		const ValidatedBuiltin &builtin = _validated_builtins[i];
+		if (builtin.function != p_func || builtin.arg_count != p_arg_count) {
+			continue;
+		}
+
+		bool compatible = true;
+		for (int j = 0; j < p_arg_count; j++) {
+			if (p_arg_types[j] == Variant::VARIANT_MAX) {
+				all_types_known = false;
+			} else if (!(builtin.arg_masks[j] & (1 << p_arg_types[j]))) {
+				compatible = false;
+				break;
+			}
+		}
+
+		if (!compatible) {
+			continue;
+		}
+
+		if (found != -1) {
+			// Ambiguous with unknown argument types, the check in the VM would fail
+			// too often to be worth it, so let the generic call decide at runtime.
+			return all_types_known ? found : -1;
+		}
+		found = i;
+	}
+
+	return found;
+}
+
+int GDScriptFunctions::get_validated_builtin_count() {
+
+	return sizeof(_validated_builtins) / sizeof(_validated_builtins[0]);
+}
+
+const GDScriptFunctions::ValidatedBuiltin &GDScriptFunctions::get_validated_builtin(int p_idx) {
+
+	return _validated_builtins[p_idx];
+}
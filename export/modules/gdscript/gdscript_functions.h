@@ -129,10 +129,36 @@ public:
 		FUNC_MAX
 	};
 
+	enum {
+		VALIDATED_MAX_ARGS = 5
+	};
+
+	// Specialized entry point for a built-in function, called directly by the VM
+	// once the argument types have been checked against `arg_masks` (one bit per
+	// Variant::Type), so it does no validation of its own.
+	typedef void (*ValidatedFunction)(const Variant **p_args, Variant &r_ret);
+
+	struct ValidatedBuiltin {
+		Function function;
+		int arg_count;
+		uint32_t arg_masks[VALIDATED_MAX_ARGS];
+		ValidatedFunction call;
+	};
+
 	static const char *get_func_name(Function p_func);
 	static void call(Function p_func, const Variant **p_args, int p_arg_count, Variant &r_ret, Variant::CallError &r_error);
 	static bool is_deterministic(Function p_func);
 	static MethodInfo get_info(Function p_func);
+
+	// Returns the index of the specialized version of p_func matching the given
+	// argument types (Variant::VARIANT_MAX if unknown), or -1 if there is none.
+	static int find_validated_builtin(Function p_func, int p_arg_count, const Variant::Type *p_arg_types);
+	static int get_validated_builtin_count();
+	static const ValidatedBuiltin &get_validated_builtin(int p_idx);
+
+	_FORCE_INLINE_ static bool validated_builtin_accepts(const ValidatedBuiltin &p_builtin, int p_arg, const Variant &p_value) {
+		return (p_builtin.arg_masks[p_arg] & (1 << p_value.get_type())) != 0;
+	}
 };
 
 #endif // GDSCRIPT_FUNCTIONS_H
@@ -0,0 +1,282 @@
+/*************************************************************************/
+/*  gdscript_parallel_loader.cpp                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "gdscript_parallel_loader.h"
+
+#include "core/engine.h"
+#include "core/io/resource_loader.h"
+#include "core/os/file_access.h"
+#include "core/os/threaded_array_processor.h"
+#include "core/project_settings.h"
+#include "core/script_language.h"
+#include "gdscript_tokenizer.h"
+
+void GDScriptParallelLoader::_scan_dependencies(Job &p_job) {
+
+	// Mirrors what GDScriptParser resolves while parsing: extends "path",
+	// preload("path"), load("path") and global class names.
+	GDScriptTokenizerText tt;
+	tt.set_code(p_job.source);
+
+	Set<String> found;
+
+	while (true) {
+
+		GDScriptTokenizer::Token token = tt.get_token();
+
+		if (token == GDScriptTokenizer::TK_EOF) {
+			break;
+		}
+		if (token == GDScriptTokenizer::TK_ERROR) {
+			// Let the regular load report the error.
+			p_job.loaded = false;
+			return;
+		}
+
+		String dependency;
+
+		if (token == GDScriptTokenizer::TK_PR_EXTENDS && tt.get_token(1) == GDScriptTokenizer::TK_CONSTANT) {
+			dependency = tt.get_token_constant(1);
+		} else if ((token == GDScriptTokenizer::TK_PR_PRELOAD || (token == GDScriptTokenizer::TK_BUILT_IN_FUNC && tt.get_token_built_in_func() == GDScriptFunctions::RESOURCE_LOAD)) &&
+				   tt.get_token(1) == GDScriptTokenizer::TK_PARENTHESIS_OPEN && tt.get_token(2) == GDScriptTokenizer::TK_CONSTANT && tt.get_token(3) == GDScriptTokenizer::TK_PARENTHESIS_CLOSE) {
+			const Variant &constant = tt.get_token_constant(2);
+			if (constant.get_type() == Variant::STRING) {
+				dependency = constant;
+			}
+		} else if (token == GDScriptTokenizer::TK_IDENTIFIER) {
+			StringName identifier = tt.get_token_identifier();
+			if (ScriptServer::is_global_class(identifier)) {
+				dependency = ScriptServer::get_global_class_path(identifier);
+			}
+		}
+
+		if (dependency != "") {
+			if (dependency.is_rel_path()) {
+				dependency = p_job.path.get_base_dir().plus_file(dependency);
+			}
+			dependency = dependency.replace("///", "//").simplify_path();
+			if (dependency != p_job.path && !found.has(dependency)) {
+				found.insert(dependency);
+				p_job.dependencies.push_back(dependency);
+			}
+		}
+
+		tt.advance();
+	}
+}
+
+void GDScriptParallelLoader::_process_job(uint32_t p_index, Job *p_jobs) {
+
+	Job &job = p_jobs[p_index];
+	job.loaded = false;
+
+	Error err;
+	FileAccessRef f = FileAccess::open(job.path, FileAccess::READ, &err);
+	if (!f) {
+		return;
+	}
+
+	Vector<uint8_t> buffer;
+	buffer.resize(f->get_len() + 1);
+	int len = f->get_buffer(buffer.ptrw(), buffer.size() - 1);
+	buffer.write[len] = 0;
+	f->close();
+
+	if (job.source.parse_utf8((const char *)buffer.ptr())) {
+		return; // Invalid UTF-8, the regular load reports it.
+	}
+
+	job.loaded = true;
+	_scan_dependencies(job);
+
+	if (job.loaded && use_tokens) {
+		job.tokens = GDScriptTokenizerBuffer::parse_code_string(job.source);
+	}
+}
+
+void GDScriptParallelLoader::prefetch(const Vector<String> &p_paths) {
+
+	if (!enabled) {
+		return;
+	}
+
+	Set<String> visited;
+	Vector<String> pending = p_paths;
+
+	// Breadth first: each level of scripts is read and tokenized in parallel,
+	// scenes and other resources are expanded through their dependency lists.
+	while (pending.size()) {
+
+		Vector<Job> jobs;
+		Vector<String> next;
+
+		for (int i = 0; i < pending.size(); i++) {
+
+			const String &path = pending[i];
+			if (visited.has(path)) {
+				continue;
+			}
+			visited.insert(path);
+
+			if (ResourceCache::has(path)) {
+				continue; // Already loaded, and so are its dependencies.
+			}
+
+			if (path.get_extension().to_lower() == "gd") {
+
+				if (ResourceLoader::path_remap(path) != path) {
+					continue; // Exported as byte code.
+				}
+
+				mutex.lock();
+				bool cached = cache.has(path) || loading.has(path);
+				mutex.unlock();
+
+				if (!cached) {
+					Job job;
+					job.path = path;
+					job.loaded = false;
+					jobs.push_back(job);
+				}
+			} else {
+				List<String> dependencies;
+				ResourceLoader::get_dependencies(path, &dependencies);
+				for (List<String>::Element *E = dependencies.front(); E; E = E->next()) {
+					next.push_back(E->get().get_slice("::", 0));
+				}
+			}
+		}
+
+		if (jobs.size() == 1) {
+			_process_job(0, jobs.ptrw());
+		} else if (jobs.size() > 1) {
+			thread_process_array(jobs.size(), this, &GDScriptParallelLoader::_process_job, jobs.ptrw());
+		}
+
+		for (int i = 0; i < jobs.size(); i++) {
+
+			const Job &job = jobs[i];
+			if (!job.loaded) {
+				continue;
+			}
+
+			Entry entry;
+			entry.source = job.source;
+			entry.tokens = job.tokens;
+
+			mutex.lock();
+			cache[job.path] = entry;
+			mutex.unlock();
+
+			for (int j = 0; j < job.dependencies.size(); j++) {
+				next.push_back(job.dependencies[j]);
+			}
+		}
+
+		pending = next;
+	}
+}
+
+void GDScriptParallelLoader::prefetch_startup() {
+
+	Vector<String> paths;
+
+	List<PropertyInfo> props;
+	ProjectSettings::get_singleton()->get_property_list(&props);
+	for (List<PropertyInfo>::Element *E = props.front(); E; E = E->next()) {
+
+		String s = E->get().name;
+		if (!s.begins_with("autoload/")) {
+			continue;
+		}
+		String path = ProjectSettings::get_singleton()->get(s);
+		if (path.begins_with("*")) {
+			path = path.substr(1, path.length() - 1);
+		}
+		paths.push_back(path);
+	}
+
+	String main_scene = GLOBAL_GET("application/run/main_scene");
+	if (main_scene != "") {
+		paths.push_back(main_scene);
+	}
+
+	prefetch(paths);
+}
+
+bool GDScriptParallelLoader::take(const String &p_path, String &r_source, Vector<uint8_t> &r_tokens) {
+
+	if (!enabled) {
+		return false;
+	}
+
+	MutexLock lock(mutex);
+
+	Entry *entry = cache.getptr(p_path);
+	if (!entry) {
+		return false;
+	}
+
+	r_source = entry->source;
+	r_tokens = entry->tokens;
+	cache.erase(p_path);
+	loading.insert(p_path);
+	return true;
+}
+
+void GDScriptParallelLoader::finish(const String &p_path) {
+
+	MutexLock lock(mutex);
+	loading.erase(p_path);
+}
+
+void GDScriptParallelLoader::clear() {
+
+	MutexLock lock(mutex);
+	cache.clear();
+	loading.clear();
+}
+
+void GDScriptParallelLoader::init() {
+
+	// The editor needs the text parser (completion, warnings, tool scripts), so
+	// this is only used when running the project.
+	enabled = GLOBAL_GET("gdscript/loading/parallel_prefetch") && !Engine::get_singleton()->is_editor_hint();
+
+	// The token buffer doesn't keep warning-ignore comments, so keep parsing
+	// the text when warnings can be reported to a debugger.
+	use_tokens = !ScriptDebugger::get_singleton();
+}
+
+GDScriptParallelLoader::GDScriptParallelLoader() {
+
+	enabled = false;
+	use_tokens = false;
+}
@@ -0,0 +1,87 @@
+/*************************************************************************/
+/*  gdscript_parallel_loader.h                                           */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef GDSCRIPT_PARALLEL_LOADER_H
+#define GDSCRIPT_PARALLEL_LOADER_H
+
+#include "core/hash_map.h"
+#include "core/os/mutex.h"
+#include "core/set.h"
+#include "core/ustring.h"
+#include "core/vector.h"
+
+// Reads and tokenizes the scripts a set of resources depends on using worker
+// threads, so the (serial, dependency ordered) parse and compile done by the
+// loader can pick up the results instead of doing that work itself.
+//
+// Parsing itself can't be moved to the workers: GDScriptParser loads the
+// resources referenced by preload(), extends and class names while parsing.
+class GDScriptParallelLoader {
+
+	struct Job {
+		String path;
+		String source;
+		Vector<uint8_t> tokens;
+		Vector<String> dependencies;
+		bool loaded;
+	};
+
+	struct Entry {
+		String source;
+		Vector<uint8_t> tokens;
+	};
+
+	Mutex mutex;
+	HashMap<String, Entry> cache;
+	Set<String> loading; // Taken and not loaded yet, nested loads must not read them again.
+	bool enabled;
+	bool use_tokens;
+
+	void _process_job(uint32_t p_index, Job *p_jobs);
+	static void _scan_dependencies(Job &p_job);
+
+public:
+	void prefetch(const Vector<String> &p_paths);
+	void prefetch_startup();
+
+	// Returns the prefetched source (and, when usable, its token buffer) for p_path, removing it from the cache.
+	bool take(const String &p_path, String &r_source, Vector<uint8_t> &r_tokens);
+	// Called once the script returned by take() is loaded.
+	void finish(const String &p_path);
+	void clear();
+
+	bool is_enabled() const { return enabled; }
+
+	void init();
+
+	GDScriptParallelLoader();
+};
+
+#endif // GDSCRIPT_PARALLEL_LOADER_H
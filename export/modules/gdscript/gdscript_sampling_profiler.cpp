@@ -0,0 +1,322 @@
+/*************************************************************************/
+/*  gdscript_sampling_profiler.cpp                                       */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "gdscript_sampling_profiler.h"
+
+#ifdef DEBUG_ENABLED
+
+#include "core/os/file_access.h"
+#include "core/os/os.h"
+#include "core/project_settings.h"
+#include "gdscript.h"
+
+GDScriptSamplingProfiler *GDScriptSamplingProfiler::singleton = NULL;
+SafeFlag GDScriptSamplingProfiler::recording;
+
+uint32_t GDScriptSamplingProfiler::_register_function(GDScriptFunction *p_function) {
+
+	FunctionInfo info;
+	info.name = p_function->get_name();
+	if (p_function->get_script()) {
+		info.path = p_function->get_script()->get_path();
+	}
+	if (info.path == "") {
+		info.path = "<built-in>";
+	}
+
+	uint32_t new_id = functions.size();
+	functions.push_back(info);
+	p_function->sampling.session = session;
+	p_function->sampling.id = new_id;
+	return new_id;
+}
+
+bool GDScriptSamplingProfiler::push_frame(GDScriptFunction *p_function, int p_line) {
+
+	if (Thread::get_caller_id() != Thread::get_main_id()) {
+		return false;
+	}
+
+	uint32_t id = p_function->sampling.session == session ? p_function->sampling.id : _register_function(p_function);
+
+	uint32_t depth = shadow_depth.get();
+	if (depth < MAX_STACK_DEPTH) {
+		shadow_stack[depth].function.set(id + 1);
+		shadow_stack[depth].line.set(p_line);
+	}
+	// Publishes the frame written above to the sampler.
+	shadow_depth.set(depth + 1);
+	return true;
+}
+
+int32_t GDScriptSamplingProfiler::_get_node(int32_t p_parent, uint32_t p_function, int32_t p_line) {
+
+	NodeKey key;
+	key.parent = p_parent;
+	key.function = p_function;
+	key.line = p_line;
+
+	const int32_t *idx = node_map.getptr(key);
+	if (idx) {
+		return *idx;
+	}
+
+	Node node;
+	node.parent = p_parent;
+	node.function = p_function;
+	node.line = p_line;
+	node.self_samples = 0;
+
+	int32_t new_idx = nodes.size();
+	nodes.push_back(node);
+	node_map[key] = new_idx;
+	return new_idx;
+}
+
+void GDScriptSamplingProfiler::_take_sample() {
+
+	uint64_t timestamp = OS::get_singleton()->get_ticks_usec() - start_time;
+	int32_t node = -1;
+
+	uint32_t depth = MIN(shadow_depth.get(), (uint32_t)MAX_STACK_DEPTH);
+	for (uint32_t i = 0; i < depth; i++) {
+		const ShadowFrame &frame = shadow_stack[i];
+		uint32_t function = frame.function.get();
+		if (function == 0) {
+			continue;
+		}
+		node = _get_node(node, function - 1, frame.line.get());
+	}
+
+	total_samples++;
+
+	if (node < 0) {
+		idle_samples++;
+		return;
+	}
+
+	nodes.write[node].self_samples++;
+
+	if (samples.size() < max_trace_samples) {
+		Sample sample;
+		sample.timestamp = timestamp;
+		sample.node = node;
+		samples.push_back(sample);
+	}
+}
+
+void GDScriptSamplingProfiler::_thread_func(void *p_self) {
+
+	GDScriptSamplingProfiler *self = (GDScriptSamplingProfiler *)p_self;
+
+	uint64_t next_sample = OS::get_singleton()->get_ticks_usec();
+
+	while (!self->exit_thread.is_set()) {
+
+		next_sample += self->sample_interval_usec;
+		uint64_t now = OS::get_singleton()->get_ticks_usec();
+		if (next_sample > now) {
+			OS::get_singleton()->delay_usec(next_sample - now);
+		} else {
+			// Fell behind (e.g. the process was suspended), don't try to catch up.
+			next_sample = now;
+		}
+
+		self->_take_sample();
+	}
+}
+
+Error GDScriptSamplingProfiler::start(int p_sample_rate) {
+
+	ERR_FAIL_COND_V_MSG(recording.is_set(), ERR_ALREADY_IN_USE, "GDScript sampling profiler is already running.");
+	ERR_FAIL_COND_V_MSG(p_sample_rate <= 0, ERR_INVALID_PARAMETER, "GDScript sampling profiler rate must be greater than zero.");
+
+	clear();
+
+	sample_interval_usec = MAX(1000000 / p_sample_rate, 1);
+	max_trace_samples = GLOBAL_GET("debug/gdscript/sampling_profiler/max_trace_samples");
+	start_time = OS::get_singleton()->get_ticks_usec();
+
+	// Invalidates the ids cached in every function by a previous recording.
+	session++;
+	shadow_depth.set(0);
+	exit_thread.clear();
+	recording.set();
+	thread.start(_thread_func, this);
+
+	return OK;
+}
+
+void GDScriptSamplingProfiler::stop() {
+
+	if (!recording.is_set()) {
+		return;
+	}
+
+	exit_thread.set();
+	thread.wait_to_finish();
+	recording.clear();
+}
+
+void GDScriptSamplingProfiler::clear() {
+
+	ERR_FAIL_COND_MSG(recording.is_set(), "Can't clear the GDScript sampling profiler while it's running.");
+
+	functions.clear();
+	node_map.clear();
+	nodes.clear();
+	samples.clear();
+	total_samples = 0;
+	idle_samples = 0;
+}
+
+String GDScriptSamplingProfiler::_get_frame_name(const Node &p_node, bool p_collapsed) const {
+
+	const FunctionInfo &info = functions[p_node.function];
+	if (p_collapsed) {
+		// Spaces and semicolons are separators in the collapsed format.
+		return (info.path + ":" + info.name + ":" + itos(p_node.line)).replace(";", "_").replace(" ", "_");
+	}
+	return info.name + " (" + info.path + ":" + itos(p_node.line) + ")";
+}
+
+Error GDScriptSamplingProfiler::save(const String &p_path, Format p_format) const {
+
+	switch (p_format) {
+		case FORMAT_COLLAPSED:
+			return save_collapsed(p_path);
+		case FORMAT_CHROME_TRACE:
+			return save_chrome_trace(p_path);
+	}
+	return ERR_INVALID_PARAMETER;
+}
+
+Error GDScriptSamplingProfiler::save_collapsed(const String &p_path) const {
+
+	ERR_FAIL_COND_V_MSG(recording.is_set(), ERR_BUSY, "Stop the GDScript sampling profiler before saving its results.");
+
+	Error err;
+	FileAccess *f = FileAccess::open(p_path, FileAccess::WRITE, &err);
+	ERR_FAIL_COND_V_MSG(err != OK, err, "Cannot save GDScript profile to file '" + p_path + "'.");
+
+	Vector<String> names;
+	names.resize(nodes.size());
+	for (int i = 0; i < nodes.size(); i++) {
+		// Parents always come before their children.
+		String name = _get_frame_name(nodes[i], true);
+		names.write[i] = nodes[i].parent < 0 ? name : names[nodes[i].parent] + ";" + name;
+	}
+
+	for (int i = 0; i < nodes.size(); i++) {
+		if (nodes[i].self_samples == 0) {
+			continue;
+		}
+		f->store_line(names[i] + " " + itos(nodes[i].self_samples));
+	}
+
+	f->close();
+	memdelete(f);
+
+	return OK;
+}
+
+Error GDScriptSamplingProfiler::save_chrome_trace(const String &p_path) const {
+
+	ERR_FAIL_COND_V_MSG(recording.is_set(), ERR_BUSY, "Stop the GDScript sampling profiler before saving its results.");
+
+	Error err;
+	FileAccess *f = FileAccess::open(p_path, FileAccess::WRITE, &err);
+	ERR_FAIL_COND_V_MSG(err != OK, err, "Cannot save GDScript profile to file '" + p_path + "'.");
+
+	f->store_line("{");
+	f->store_line("\"displayTimeUnit\":\"ms\",");
+	f->store_line("\"traceEvents\":[");
+	f->store_line("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"Main thread (GDScript)\"}}");
+	f->store_line("],");
+
+	f->store_line("\"stackFrames\":{");
+	for (int i = 0; i < nodes.size(); i++) {
+		String frame = "\"" + itos(i) + "\":{\"category\":\"gdscript\",\"name\":\"" + _get_frame_name(nodes[i], false).json_escape() + "\"";
+		if (nodes[i].parent >= 0) {
+			frame += ",\"parent\":\"" + itos(nodes[i].parent) + "\"";
+		}
+		frame += "}";
+		f->store_line(frame + (i + 1 < nodes.size() ? "," : ""));
+	}
+	f->store_line("},");
+
+	f->store_line("\"samples\":[");
+	for (int i = 0; i < samples.size(); i++) {
+		const Sample &s = samples[i];
+		String sample = "{\"cpu\":0,\"pid\":1,\"tid\":1,\"ts\":" + itos(s.timestamp) + ",\"name\":\"sample\",\"sf\":\"" + itos(s.node) + "\",\"weight\":1}";
+		f->store_line(sample + (i + 1 < samples.size() ? "," : ""));
+	}
+	f->store_line("]");
+	f->store_line("}");
+
+	f->close();
+	memdelete(f);
+
+	return OK;
+}
+
+GDScriptSamplingProfiler::Format GDScriptSamplingProfiler::get_format_for_path(const String &p_path) {
+
+	return p_path.get_extension().to_lower() == "json" ? FORMAT_CHROME_TRACE : FORMAT_COLLAPSED;
+}
+
+GDScriptSamplingProfiler::GDScriptSamplingProfiler() {
+
+	ERR_FAIL_COND(singleton);
+	singleton = this;
+
+	for (int i = 0; i < MAX_STACK_DEPTH; i++) {
+		shadow_stack[i].function.set(0);
+		shadow_stack[i].line.set(0);
+	}
+
+	session = 0;
+	total_samples = 0;
+	idle_samples = 0;
+	sample_interval_usec = 1000;
+	max_trace_samples = 0;
+	start_time = 0;
+}
+
+GDScriptSamplingProfiler::~GDScriptSamplingProfiler() {
+
+	stop();
+
+	if (singleton == this) {
+		singleton = NULL;
+	}
+}
+
+#endif // DEBUG_ENABLED
@@ -0,0 +1,174 @@
+/*************************************************************************/
+/*  gdscript_sampling_profiler.h                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef GDSCRIPT_SAMPLING_PROFILER_H
+#define GDSCRIPT_SAMPLING_PROFILER_H
+
+#ifdef DEBUG_ENABLED
+
+#include "core/hash_map.h"
+#include "core/os/thread.h"
+#include "core/safe_refcount.h"
+#include "core/ustring.h"
+#include "core/vector.h"
+
+class GDScriptFunction;
+
+// Statistical profiler for GDScript. The main thread only publishes a shadow
+// call stack (function id and a copy of the current line), a timer thread
+// periodically snapshots it and aggregates the samples into a call tree.
+// Function names are resolved by the main thread the first time a function is
+// pushed, so the sampler never touches GDScriptFunction and takes no locks.
+// Results can be written as collapsed stacks (for flamegraph.pl / speedscope)
+// or as a Chrome trace (chrome://tracing, Perfetto), so no editor is needed.
+class GDScriptSamplingProfiler {
+public:
+	enum {
+		MAX_STACK_DEPTH = 256,
+	};
+
+	enum Format {
+		FORMAT_COLLAPSED,
+		FORMAT_CHROME_TRACE,
+	};
+
+private:
+	struct ShadowFrame {
+		SafeNumeric<uint32_t> function; // function id + 1, 0 when unused
+		SafeNumeric<int32_t> line; // copied by the main thread, the call frame may be gone when sampled
+	};
+
+	struct FunctionInfo {
+		String name;
+		String path;
+	};
+
+	struct NodeKey {
+		int32_t parent;
+		uint32_t function;
+		int32_t line;
+
+		bool operator==(const NodeKey &p_key) const {
+			return parent == p_key.parent && function == p_key.function && line == p_key.line;
+		}
+	};
+
+	struct NodeKeyHasher {
+		static _FORCE_INLINE_ uint32_t hash(const NodeKey &p_key) {
+			uint32_t h = hash_djb2_one_32(p_key.parent);
+			h = hash_djb2_one_32(p_key.function, h);
+			return hash_djb2_one_32(p_key.line, h);
+		}
+	};
+
+	struct Node {
+		int32_t parent;
+		uint32_t function;
+		int32_t line;
+		uint64_t self_samples;
+	};
+
+	struct Sample {
+		uint64_t timestamp;
+		int32_t node;
+	};
+
+	static GDScriptSamplingProfiler *singleton;
+	static SafeFlag recording;
+
+	// Written by the main thread only.
+	ShadowFrame shadow_stack[MAX_STACK_DEPTH];
+	SafeNumeric<uint32_t> shadow_depth;
+
+	// Appended by the main thread while recording, never read by the sampler.
+	Vector<FunctionInfo> functions;
+	uint32_t session;
+
+	// Owned by the sampler thread while recording, by the caller otherwise.
+	HashMap<NodeKey, int32_t, NodeKeyHasher> node_map;
+	Vector<Node> nodes;
+	Vector<Sample> samples;
+	uint64_t total_samples;
+	uint64_t idle_samples;
+
+	Thread thread;
+	SafeFlag exit_thread;
+	uint32_t sample_interval_usec;
+	int max_trace_samples;
+	uint64_t start_time;
+
+	uint32_t _register_function(GDScriptFunction *p_function);
+	int32_t _get_node(int32_t p_parent, uint32_t p_function, int32_t p_line);
+	void _take_sample();
+	static void _thread_func(void *p_self);
+
+	String _get_frame_name(const Node &p_node, bool p_collapsed) const;
+
+public:
+	_FORCE_INLINE_ static GDScriptSamplingProfiler *get_singleton() { return singleton; }
+	_FORCE_INLINE_ static bool is_recording() { return recording.is_set(); }
+
+	// Called from GDScriptFunction::call(); only the main thread is sampled.
+	bool push_frame(GDScriptFunction *p_function, int p_line);
+
+	// Called by the function on top of the stack when it reaches a new line.
+	_FORCE_INLINE_ void set_line(int p_line) {
+		uint32_t depth = shadow_depth.get();
+		if (depth > 0 && depth <= MAX_STACK_DEPTH) {
+			shadow_stack[depth - 1].line.set(p_line);
+		}
+	}
+
+	_FORCE_INLINE_ void pop_frame() {
+		uint32_t depth = shadow_depth.get();
+		if (depth > 0) {
+			shadow_depth.set(depth - 1);
+		}
+	}
+
+	Error start(int p_sample_rate);
+	void stop();
+
+	void clear();
+	uint64_t get_sample_count() const { return total_samples; }
+
+	Error save(const String &p_path, Format p_format) const;
+	Error save_collapsed(const String &p_path) const;
+	Error save_chrome_trace(const String &p_path) const;
+
+	static Format get_format_for_path(const String &p_path);
+
+	GDScriptSamplingProfiler();
+	~GDScriptSamplingProfiler();
+};
+
+#endif // DEBUG_ENABLED
+
+#endif // GDSCRIPT_SAMPLING_PROFILER_H
@@ -1476,27 +1476,35 @@ bool VisualScriptInstance::has_method(const StringName &p_method) const {
 //#define VSDEBUG(m_text) print_line(m_text)
 #define VSDEBUG(m_text)
 
-void VisualScriptInstance::_dependency_step(VisualScriptNodeInstance *node, int p_pass, int *pass_stack, const Variant **input_args, Variant **output_args, Variant *variant_stack, Variant::CallError &r_error, String &error_str, VisualScriptNodeInstance **r_error_node) {
+void VisualScriptInstance::_compile_dependency_steps(VisualScriptNodeInstance *p_node, Set<VisualScriptNodeInstance *> &r_visited, Vector<VisualScriptNodeInstance::DependencyStep> &r_steps) {
 
-	ERR_FAIL_COND(node->pass_idx == -1);
+	//same order as walking the dependency tree at run time, each node is stepped once per pass
+	for (int i = 0; i < p_node->dependencies.size(); i++) {
 
-	if (pass_stack[node->pass_idx] == p_pass)
-		return;
-
-	pass_stack[node->pass_idx] = p_pass;
-
-	if (!node->dependencies.empty()) {
+		VisualScriptNodeInstance *dep = p_node->dependencies[i];
+		if (r_visited.has(dep))
+			continue;
 
-		int dc = node->dependencies.size();
-		VisualScriptNodeInstance **deps = node->dependencies.ptrw();
+		r_visited.insert(dep);
+		_compile_dependency_steps(dep, r_visited, r_steps);
 
-		for (int i = 0; i < dc; i++) {
+		VisualScriptNodeInstance::DependencyStep step;
+		step.node = dep;
+		step.op = Variant::OP_MAX;
 
-			_dependency_step(deps[i], p_pass, pass_stack, input_args, output_args, variant_stack, r_error, error_str, r_error_node);
-			if (r_error.error != Variant::CallError::CALL_OK)
-				return;
+		VisualScriptOperator *op_node = Object::cast_to<VisualScriptOperator>(dep->base);
+		if (op_node && dep->input_port_count >= 1 && dep->input_port_count <= 2 && dep->output_port_count == 1) {
+			step.op = op_node->get_operator();
+			step.operands[0] = dep->input_ports[0];
+			step.operands[1] = dep->input_port_count == 2 ? dep->input_ports[1] : -1;
+			step.output = dep->output_ports[0];
 		}
+
+		r_steps.push_back(step);
 	}
+}
+
+void VisualScriptInstance::_dependency_step(VisualScriptNodeInstance *node, const Variant **input_args, Variant **output_args, Variant *variant_stack, Variant::CallError &r_error, String &error_str) {
 
 	for (int i = 0; i < node->input_port_count; i++) {
 
@@ -1518,9 +1526,6 @@ void VisualScriptInstance::_dependency_step(VisualScriptNodeInstance *node, int
 
 	node->step(input_args, output_args, VisualScriptNodeInstance::START_MODE_BEGIN_SEQUENCE, working_mem, r_error, error_str);
 	//ignore return
-	if (r_error.error != Variant::CallError::CALL_OK) {
-		*r_error_node = node;
-	}
 }
 
 Variant VisualScriptInstance::_call_internal(const StringName &p_method, void *p_stack, int p_stack_size, VisualScriptNodeInstance *p_node, int p_flow_stack_pos, int p_pass, bool p_resuming_yield, Variant::CallError &r_error) {
@@ -1536,7 +1541,7 @@ Variant VisualScriptInstance::_call_internal(const StringName &p_method, void *p
 	Variant **output_args = (Variant **)(input_args + max_input_args);
 	int flow_max = f->flow_stack_size;
 	int *flow_stack = flow_max ? (int *)(output_args + max_output_args) : (int *)NULL;
-	int *pass_stack = flow_stack ? (int *)(flow_stack + flow_max) : (int *)NULL;
+	VisualScriptNodeInstance *const *flow_nodes = f->flow_nodes.ptr();
 
 	String error_str;
 
@@ -1575,18 +1580,29 @@ Variant VisualScriptInstance::_call_internal(const StringName &p_method, void *p
 			}
 		} else {
 
-			//run dependencies first
+			//run dependencies first, already flattened in the order they must be stepped
 
-			if (!node->dependencies.empty()) {
+			if (!node->dependency_steps.empty()) {
 
-				int dc = node->dependencies.size();
-				VisualScriptNodeInstance **deps = node->dependencies.ptrw();
+				int dc = node->dependency_steps.size();
+				const VisualScriptNodeInstance::DependencyStep *deps = node->dependency_steps.ptr();
 
 				for (int i = 0; i < dc; i++) {
 
-					_dependency_step(deps[i], p_pass, pass_stack, input_args, output_args, variant_stack, r_error, error_str, &node);
+					const VisualScriptNodeInstance::DependencyStep &dep = deps[i];
+
+					if (dep.op != Variant::OP_MAX) {
+						bool valid;
+						Variant::evaluate(dep.op, _get_operand(dep.operands[0], variant_stack), _get_operand(dep.operands[1], variant_stack), variant_stack[dep.output], valid);
+						if (valid)
+							continue;
+						//step() reports the error
+					}
+
+					_dependency_step(dep.node, input_args, output_args, variant_stack, r_error, error_str);
 					if (r_error.error != Variant::CallError::CALL_OK) {
 						error = true;
+						node = dep.node;
 						current_node_id = node->id;
 						break;
 					}
@@ -1759,7 +1775,7 @@ Variant VisualScriptInstance::_call_internal(const StringName &p_method, void *p
 		if (flow_stack) {
 
 			//update flow stack pos (may have changed)
-			flow_stack[flow_stack_pos] = current_node_id;
+			flow_stack[flow_stack_pos] = node->sequence_index;
 
 			//add stack push bit if requested
 			if (ret & VisualScriptNodeInstance::STEP_FLAG_PUSH_STACK_BIT) {
@@ -1777,7 +1793,7 @@ Variant VisualScriptInstance::_call_internal(const StringName &p_method, void *p
 
 				if (flow_stack_pos > 0) {
 					flow_stack_pos--;
-					node = instances[flow_stack[flow_stack_pos] & VisualScriptNodeInstance::FLOW_STACK_MASK];
+					node = flow_nodes[flow_stack[flow_stack_pos] & VisualScriptNodeInstance::FLOW_STACK_MASK];
 					VSDEBUG("NEXT IS GO BACK");
 				} else {
 					VSDEBUG("NEXT IS GO BACK, BUT NO NEXT SO EXIT");
@@ -1795,9 +1811,9 @@ Variant VisualScriptInstance::_call_internal(const StringName &p_method, void *p
 
 					for (int i = flow_stack_pos; i >= 0; i--) {
 
-						if ((flow_stack[i] & VisualScriptNodeInstance::FLOW_STACK_MASK) == next->get_id()) {
+						if ((flow_stack[i] & VisualScriptNodeInstance::FLOW_STACK_MASK) == next->sequence_index) {
 							flow_stack_pos = i; //roll back and remove bit
-							flow_stack[i] = next->get_id();
+							flow_stack[i] = next->sequence_index;
 							sequence_bits[next->sequence_index] = false;
 							found = true;
 						}
@@ -1825,7 +1841,7 @@ Variant VisualScriptInstance::_call_internal(const StringName &p_method, void *p
 					node = next;
 
 					flow_stack_pos++;
-					flow_stack[flow_stack_pos] = node->get_id();
+					flow_stack[flow_stack_pos] = node->sequence_index;
 
 					VSDEBUG("INCREASE FLOW STACK");
 				}
@@ -1840,7 +1856,7 @@ Variant VisualScriptInstance::_call_internal(const StringName &p_method, void *p
 					VSDEBUG("FS " + itos(i) + " - " + itos(flow_stack[i]));
 					if (flow_stack[i] & VisualScriptNodeInstance::FLOW_STACK_PUSHED_BIT) {
 
-						node = instances[flow_stack[i] & VisualScriptNodeInstance::FLOW_STACK_MASK];
+						node = flow_nodes[flow_stack[i] & VisualScriptNodeInstance::FLOW_STACK_MASK];
 						flow_stack_pos = i;
 						found = true;
 						break;
@@ -1936,7 +1952,6 @@ Variant VisualScriptInstance::call(const StringName &p_method, const Variant **p
 	total_stack_size += f->node_count * sizeof(bool);
 	total_stack_size += (max_input_args + max_output_args) * sizeof(Variant *); //arguments
 	total_stack_size += f->flow_stack_size * sizeof(int); //flow
-	total_stack_size += f->pass_stack_size * sizeof(int);
 
 	VSDEBUG("STACK SIZE: " + itos(total_stack_size));
 	VSDEBUG("STACK VARIANTS: : " + itos(f->max_stack));
@@ -1944,7 +1959,6 @@ Variant VisualScriptInstance::call(const StringName &p_method, const Variant **p
 	VSDEBUG("MAX INPUT: " + itos(max_input_args));
 	VSDEBUG("MAX OUTPUT: " + itos(max_output_args));
 	VSDEBUG("FLOW STACK SIZE: " + itos(f->flow_stack_size));
-	VSDEBUG("PASS STACK SIZE: " + itos(f->pass_stack_size));
 
 	void *stack = alloca(total_stack_size);
 
@@ -1954,14 +1968,11 @@ Variant VisualScriptInstance::call(const StringName &p_method, const Variant **p
 	Variant **output_args = (Variant **)(input_args + max_input_args);
 	int flow_max = f->flow_stack_size;
 	int *flow_stack = flow_max ? (int *)(output_args + max_output_args) : (int *)NULL;
-	int *pass_stack = flow_stack ? (int *)(flow_stack + flow_max) : (int *)NULL;
 
 	for (int i = 0; i < f->node_count; i++) {
 		sequence_bits[i] = false; //all starts as false
 	}
 
-	zeromem(pass_stack, f->pass_stack_size * sizeof(int));
-
 	Map<int, VisualScriptNodeInstance *>::Element *E = instances.find(f->node);
 	if (!E) {
 		r_error.error = Variant::CallError::CALL_ERROR_INVALID_METHOD;
@@ -1972,7 +1983,7 @@ Variant VisualScriptInstance::call(const StringName &p_method, const Variant **p
 	VisualScriptNodeInstance *node = E->get();
 
 	if (flow_stack) {
-		flow_stack[0] = node->get_id();
+		flow_stack[0] = node->sequence_index;
 	}
 
 	VSDEBUG("ARGUMENTS: " + itos(f->argument_count) = " RECEIVED: " + itos(p_argcount));
@@ -2104,7 +2115,6 @@ void VisualScriptInstance::create(const Ref<VisualScript> &p_script, Object *p_o
 		function.node = E->get().function_id;
 		function.max_stack = 0;
 		function.flow_stack_size = 0;
-		function.pass_stack_size = 0;
 		function.node_count = 0;
 
 		Map<StringName, int> local_var_indices;
@@ -2150,7 +2160,7 @@ void VisualScriptInstance::create(const Ref<VisualScript> &p_script, Object *p_o
 			instance->sequence_output_count = node->get_output_sequence_port_count();
 			instance->sequence_index = function.node_count++;
 			instance->sequence_outputs = NULL;
-			instance->pass_idx = -1;
+			function.flow_nodes.push_back(instance);
 
 			if (instance->input_port_count) {
 				instance->input_ports = memnew_arr(int, instance->input_port_count);
@@ -2227,10 +2237,6 @@ void VisualScriptInstance::create(const Ref<VisualScript> &p_script, Object *p_o
 
 			if (from->get_sequence_output_count() == 0 && to->dependencies.find(from) == -1) {
 				//if the node we are reading from has no output sequence, we must call step() before reading from it.
-				if (from->pass_idx == -1) {
-					from->pass_idx = function.pass_stack_size;
-					function.pass_stack_size++;
-				}
 				to->dependencies.push_back(from);
 			}
 
@@ -2278,6 +2284,18 @@ void VisualScriptInstance::create(const Ref<VisualScript> &p_script, Object *p_o
 					instance->output_ports[i] = function.trash_pos; //trash is same for all
 				}
 			}
+
+		}
+
+		//fifth pass, flatten the dependency trees now that all ports are assigned, so calls don't need to walk them
+
+		for (const Map<int, VisualScript::Function::NodeData>::Element *F = E->get().nodes.front(); F; F = F->next()) {
+
+			VisualScriptNodeInstance *instance = instances[F->key()];
+			if (!instance->dependencies.empty()) {
+				Set<VisualScriptNodeInstance *> visited;
+				_compile_dependency_steps(instance, visited, instance->dependency_steps);
+			}
 		}
 
 		functions[E->key()] = function;
@@ -112,17 +112,25 @@ class VisualScriptNodeInstance {
 		INPUT_DEFAULT_VALUE_BIT = INPUT_SHIFT, // from unassigned input port, using default value (edited by user)
 	};
 
+	//one instruction of the dependency stream, operators are evaluated in place instead of calling step()
+	struct DependencyStep {
+		VisualScriptNodeInstance *node;
+		Variant::Operator op; //OP_MAX if step() must be called
+		int operands[2]; //addressed like input_ports, -1 for the missing operand of unary operators
+		int output; //stack position
+	};
+
 	int id;
 	int sequence_index;
 	VisualScriptNodeInstance **sequence_outputs;
 	int sequence_output_count;
 	Vector<VisualScriptNodeInstance *> dependencies;
+	Vector<DependencyStep> dependency_steps; //dependencies flattened in execution order, compiled once on instance creation
 	int *input_ports;
 	int input_port_count;
 	int *output_ports;
 	int output_port_count;
 	int working_mem_idx;
-	int pass_idx;
 
 	VisualScriptNode *base;
 
@@ -382,9 +390,9 @@ class VisualScriptInstance : public ScriptInstance {
 		int max_stack;
 		int trash_pos;
 		int flow_stack_size;
-		int pass_stack_size;
 		int node_count;
 		int argument_count;
+		Vector<VisualScriptNodeInstance *> flow_nodes; //indexed by sequence_index, which is what the flow stack stores
 	};
 
 	Map<StringName, Function> functions;
@@ -394,7 +402,17 @@ class VisualScriptInstance : public ScriptInstance {
 
 	StringName source;
 
-	void _dependency_step(VisualScriptNodeInstance *node, int p_pass, int *pass_stack, const Variant **input_args, Variant **output_args, Variant *variant_stack, Variant::CallError &r_error, String &error_str, VisualScriptNodeInstance **r_error_node);
+	void _compile_dependency_steps(VisualScriptNodeInstance *p_node, Set<VisualScriptNodeInstance *> &r_visited, Vector<VisualScriptNodeInstance::DependencyStep> &r_steps);
+	_FORCE_INLINE_ const Variant &_get_operand(int p_operand, const Variant *p_variant_stack) const {
+		static const Variant nil;
+		if (p_operand == -1)
+			return nil;
+		if (p_operand & VisualScriptNodeInstance::INPUT_DEFAULT_VALUE_BIT)
+			return default_values[p_operand & VisualScriptNodeInstance::INPUT_MASK];
+		return p_variant_stack[p_operand];
+	}
+
+	void _dependency_step(VisualScriptNodeInstance *node, const Variant **input_args, Variant **output_args, Variant *variant_stack, Variant::CallError &r_error, String &error_str);
 	Variant _call_internal(const StringName &p_method, void *p_stack, int p_stack_size, VisualScriptNodeInstance *p_node, int p_flow_stack_pos, int p_pass, bool p_resuming_yield, Variant::CallError &r_error);
 
 	//Map<StringName,Function> functions;
@@ -30,6 +30,7 @@
 
 #include "visual_script_func_nodes.h"
 
+#include "core/core_string_names.h"
 #include "core/engine.h"
 #include "core/io/resource_loader.h"
 #include "core/os/os.h"
@@ -752,6 +753,7 @@ public:
 	VisualScriptFunctionCall::RPCCallMode rpc_mode;
 	StringName function;
 	StringName singleton;
+	MethodBind *self_method; //resolved once when calling a native method on self
 
 	VisualScriptFunctionCall *node;
 	VisualScriptInstance *instance;
@@ -798,6 +800,12 @@ public:
 
 				if (rpc_mode) {
 					call_rpc(object, p_inputs, input_args);
+				} else if (self_method) {
+					if (returns) {
+						*p_outputs[0] = self_method->call(object, p_inputs, input_args, r_error);
+					} else {
+						self_method->call(object, p_inputs, input_args, r_error);
+					}
 				} else if (returns) {
 					*p_outputs[0] = object->call(function, p_inputs, input_args, r_error);
 				} else {
@@ -905,6 +913,16 @@ VisualScriptNodeInstance *VisualScriptFunctionCall::instance(VisualScriptInstanc
 	instance->input_args = get_input_value_port_count() - ((call_mode == CALL_MODE_BASIC_TYPE || call_mode == CALL_MODE_INSTANCE) ? 1 : 0);
 	instance->rpc_mode = rpc_call_mode;
 	instance->validate = validate;
+	instance->self_method = NULL;
+
+	if (call_mode == CALL_MODE_SELF && !p_instance->has_method(function) && function != CoreStringNames::get_singleton()->_free) {
+		//the owner can't change for this instance and the script does not override the method, so skip the lookup on every call
+		Object *owner = p_instance->get_owner_ptr();
+		if (owner) {
+			instance->self_method = ClassDB::get_method(owner->get_class_name(), function);
+		}
+	}
+
 	return instance;
 }
 
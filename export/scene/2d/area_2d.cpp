@@ -307,6 +307,21 @@ void Area2D::_area_inout(int p_status, const RID &p_area, int p_instance, int p_
 	locked = false;
 }
 
+void Area2D::_body_inout_batch(const PoolIntArray &p_status, const Array &p_bodies, const PoolIntArray &p_instances, const PoolIntArray &p_body_shapes, const PoolIntArray &p_area_shapes) {
+
+	int count = p_status.size();
+	ERR_FAIL_COND(p_bodies.size() != count || p_instances.size() != count || p_body_shapes.size() != count || p_area_shapes.size() != count);
+
+	PoolIntArray::Read status = p_status.read();
+	PoolIntArray::Read instances = p_instances.read();
+	PoolIntArray::Read body_shapes = p_body_shapes.read();
+	PoolIntArray::Read area_shapes = p_area_shapes.read();
+
+	for (int i = 0; i < count; i++) {
+		_body_inout(status[i], p_bodies[i], instances[i], body_shapes[i], area_shapes[i]);
+	}
+}
+
 void Area2D::_clear_monitoring() {
 
 	ERR_FAIL_COND_MSG(locked, "This function can't be used during the in/out signal.");
@@ -392,8 +407,8 @@ void Area2D::set_monitoring(bool p_enable) {
 
 	if (monitoring) {
 
-		Physics2DServer::get_singleton()->area_set_monitor_callback(get_rid(), this, SceneStringNames::get_singleton()->_body_inout);
-		Physics2DServer::get_singleton()->area_set_area_monitor_callback(get_rid(), this, SceneStringNames::get_singleton()->_area_inout);
+		Physics2DServer::get_singleton()->area_set_monitor_callback(get_rid(), this, SceneStringNames::get_singleton()->_body_inout_batch);
+		Physics2DServer::get_singleton()->area_set_area_monitor_callback(get_rid(), this, SceneStringNames::get_singleton()->_area_inout_batch);
 
 	} else {
 		Physics2DServer::get_singleton()->area_set_monitor_callback(get_rid(), NULL, StringName());
@@ -402,6 +417,21 @@ void Area2D::set_monitoring(bool p_enable) {
 	}
 }
 
+void Area2D::_area_inout_batch(const PoolIntArray &p_status, const Array &p_areas, const PoolIntArray &p_instances, const PoolIntArray &p_area_shapes, const PoolIntArray &p_self_shapes) {
+
+	int count = p_status.size();
+	ERR_FAIL_COND(p_areas.size() != count || p_instances.size() != count || p_area_shapes.size() != count || p_self_shapes.size() != count);
+
+	PoolIntArray::Read status = p_status.read();
+	PoolIntArray::Read instances = p_instances.read();
+	PoolIntArray::Read area_shapes = p_area_shapes.read();
+	PoolIntArray::Read self_shapes = p_self_shapes.read();
+
+	for (int i = 0; i < count; i++) {
+		_area_inout(status[i], p_areas[i], instances[i], area_shapes[i], self_shapes[i]);
+	}
+}
+
 bool Area2D::is_monitoring() const {
 
 	return monitoring;
@@ -635,6 +665,8 @@ void Area2D::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("_body_inout"), &Area2D::_body_inout);
 	ClassDB::bind_method(D_METHOD("_area_inout"), &Area2D::_area_inout);
+	ClassDB::bind_method(D_METHOD("_body_inout_batch"), &Area2D::_body_inout_batch);
+	ClassDB::bind_method(D_METHOD("_area_inout_batch"), &Area2D::_area_inout_batch);
 
 	ADD_SIGNAL(MethodInfo("body_shape_entered", PropertyInfo(Variant::INT, "body_id"), PropertyInfo(Variant::OBJECT, "body", PROPERTY_HINT_RESOURCE_TYPE, "Node"), PropertyInfo(Variant::INT, "body_shape"), PropertyInfo(Variant::INT, "local_shape")));
 	ADD_SIGNAL(MethodInfo("body_shape_exited", PropertyInfo(Variant::INT, "body_id"), PropertyInfo(Variant::OBJECT, "body", PROPERTY_HINT_RESOURCE_TYPE, "Node"), PropertyInfo(Variant::INT, "body_shape"), PropertyInfo(Variant::INT, "local_shape")));
@@ -685,6 +717,8 @@ Area2D::Area2D() :
 	priority = 0;
 	monitoring = false;
 	monitorable = false;
+	// Overlap changes arrive once per physics tick as packed arrays
+	Physics2DServer::get_singleton()->area_set_monitor_batching(get_rid(), true);
 	collision_mask = 1;
 	collision_layer = 1;
 	audio_bus_override = false;
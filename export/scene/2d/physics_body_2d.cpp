@@ -1155,8 +1155,10 @@ bool KinematicBody2D::separate_raycast_shapes(bool p_infinite_inertia, Collision
 		}
 	}
 
-	gt.elements[2] += recover;
-	set_global_transform(gt);
+	if (recover != Vector2()) {
+		gt.elements[2] += recover;
+		set_global_transform(gt);
+	}
 
 	if (deepest != -1) {
 		r_collision.collider = sep_res[deepest].collider_id;
@@ -1234,6 +1236,9 @@ Vector2 KinematicBody2D::move_and_slide(const Vector2 &p_linear_velocity, const
 	floor_normal = Vector2();
 	floor_velocity = Vector2();
 
+	// Sliding only shortens the motion left, so every iteration stays within its length.
+	Physics2DServer::get_singleton()->body_begin_motion_batch(get_rid(), get_global_transform(), motion.length(), margin);
+
 	while (p_max_slides) {
 
 		Collision collision;
@@ -1276,6 +1281,7 @@ Vector2 KinematicBody2D::move_and_slide(const Vector2 &p_linear_velocity, const
 								Transform2D gt = get_global_transform();
 								gt.elements[2] -= collision.travel.slide(up_direction);
 								set_global_transform(gt);
+								Physics2DServer::get_singleton()->body_end_motion_batch(get_rid());
 								return Vector2();
 							}
 						}
@@ -1297,6 +1303,8 @@ Vector2 KinematicBody2D::move_and_slide(const Vector2 &p_linear_velocity, const
 		--p_max_slides;
 	}
 
+	Physics2DServer::get_singleton()->body_end_motion_batch(get_rid());
+
 	return body_velocity;
 }
 
@@ -1383,17 +1391,17 @@ float KinematicBody2D::get_safe_margin() const {
 
 int KinematicBody2D::get_slide_count() const {
 
-	return colliders.size();
+	return (int)colliders.size();
 }
 
 KinematicBody2D::Collision KinematicBody2D::get_slide_collision(int p_bounce) const {
-	ERR_FAIL_INDEX_V(p_bounce, colliders.size(), Collision());
+	ERR_FAIL_INDEX_V(p_bounce, (int)colliders.size(), Collision());
 	return colliders[p_bounce];
 }
 
 Ref<KinematicCollision2D> KinematicBody2D::_get_slide_collision(int p_bounce) {
 
-	ERR_FAIL_INDEX_V(p_bounce, colliders.size(), Ref<KinematicCollision2D>());
+	ERR_FAIL_INDEX_V(p_bounce, (int)colliders.size(), Ref<KinematicCollision2D>());
 	if (p_bounce >= slide_colliders.size()) {
 		slide_colliders.resize(p_bounce + 1);
 	}
@@ -31,6 +31,7 @@
 #ifndef PHYSICS_BODY_2D_H
 #define PHYSICS_BODY_2D_H
 
+#include "core/local_vector.h"
 #include "core/vset.h"
 #include "scene/2d/collision_object_2d.h"
 #include "scene/resources/physics_material.h"
@@ -314,7 +315,7 @@ private:
 	bool on_wall;
 	bool sync_to_physics;
 
-	Vector<Collision> colliders;
+	LocalVector<Collision> colliders; // keeps its memory from one slide to the next
 	Vector<Ref<KinematicCollision2D> > slide_colliders;
 	Ref<KinematicCollision2D> motion_cache;
 
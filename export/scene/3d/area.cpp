@@ -210,6 +210,21 @@ void Area::_body_inout(int p_status, const RID &p_body, int p_instance, int p_bo
 	locked = false;
 }
 
+void Area::_body_inout_batch(const PoolIntArray &p_status, const Array &p_bodies, const PoolIntArray &p_instances, const PoolIntArray &p_body_shapes, const PoolIntArray &p_area_shapes) {
+
+	int count = p_status.size();
+	ERR_FAIL_COND(p_bodies.size() != count || p_instances.size() != count || p_body_shapes.size() != count || p_area_shapes.size() != count);
+
+	PoolIntArray::Read status = p_status.read();
+	PoolIntArray::Read instances = p_instances.read();
+	PoolIntArray::Read body_shapes = p_body_shapes.read();
+	PoolIntArray::Read area_shapes = p_area_shapes.read();
+
+	for (int i = 0; i < count; i++) {
+		_body_inout(status[i], p_bodies[i], instances[i], body_shapes[i], area_shapes[i]);
+	}
+}
+
 void Area::_clear_monitoring() {
 
 	ERR_FAIL_COND_MSG(locked, "This function can't be used during the in/out signal.");
@@ -291,8 +306,8 @@ void Area::set_monitoring(bool p_enable) {
 
 	if (monitoring) {
 
-		PhysicsServer::get_singleton()->area_set_monitor_callback(get_rid(), this, SceneStringNames::get_singleton()->_body_inout);
-		PhysicsServer::get_singleton()->area_set_area_monitor_callback(get_rid(), this, SceneStringNames::get_singleton()->_area_inout);
+		PhysicsServer::get_singleton()->area_set_monitor_callback(get_rid(), this, SceneStringNames::get_singleton()->_body_inout_batch);
+		PhysicsServer::get_singleton()->area_set_area_monitor_callback(get_rid(), this, SceneStringNames::get_singleton()->_area_inout_batch);
 	} else {
 		PhysicsServer::get_singleton()->area_set_monitor_callback(get_rid(), NULL, StringName());
 		PhysicsServer::get_singleton()->area_set_area_monitor_callback(get_rid(), NULL, StringName());
@@ -398,6 +413,21 @@ void Area::_area_inout(int p_status, const RID &p_area, int p_instance, int p_ar
 	locked = false;
 }
 
+void Area::_area_inout_batch(const PoolIntArray &p_status, const Array &p_areas, const PoolIntArray &p_instances, const PoolIntArray &p_area_shapes, const PoolIntArray &p_self_shapes) {
+
+	int count = p_status.size();
+	ERR_FAIL_COND(p_areas.size() != count || p_instances.size() != count || p_area_shapes.size() != count || p_self_shapes.size() != count);
+
+	PoolIntArray::Read status = p_status.read();
+	PoolIntArray::Read instances = p_instances.read();
+	PoolIntArray::Read area_shapes = p_area_shapes.read();
+	PoolIntArray::Read self_shapes = p_self_shapes.read();
+
+	for (int i = 0; i < count; i++) {
+		_area_inout(status[i], p_areas[i], instances[i], area_shapes[i], self_shapes[i]);
+	}
+}
+
 bool Area::is_monitoring() const {
 
 	return monitoring;
@@ -663,6 +693,8 @@ void Area::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("_body_inout"), &Area::_body_inout);
 	ClassDB::bind_method(D_METHOD("_area_inout"), &Area::_area_inout);
+	ClassDB::bind_method(D_METHOD("_body_inout_batch"), &Area::_body_inout_batch);
+	ClassDB::bind_method(D_METHOD("_area_inout_batch"), &Area::_area_inout_batch);
 
 	ClassDB::bind_method(D_METHOD("set_audio_bus_override", "enable"), &Area::set_audio_bus_override);
 	ClassDB::bind_method(D_METHOD("is_overriding_audio_bus"), &Area::is_overriding_audio_bus);
@@ -735,6 +767,8 @@ Area::Area() :
 	priority = 0;
 	monitoring = false;
 	monitorable = false;
+	// Overlap changes arrive once per physics tick as packed arrays
+	PhysicsServer::get_singleton()->area_set_monitor_batching(get_rid(), true);
 	collision_mask = 1;
 	collision_layer = 1;
 	set_monitoring(true);
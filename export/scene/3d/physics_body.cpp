@@ -455,7 +455,7 @@ void RigidBody::_direct_state_changed(Object *p_state) {
 		emit_signal(SceneStringNames::get_singleton()->sleeping_state_changed);
 	}
 	if (get_script_instance())
-		get_script_instance()->call("_integrate_forces", state);
+		get_script_instance()->call(SceneStringNames::get_singleton()->_integrate_forces, state);
 	set_ignore_transform_notification(false);
 	_on_transform_changed();
 
@@ -547,8 +547,75 @@ void RigidBody::_direct_state_changed(Object *p_state) {
 	state = NULL;
 }
 
+bool RigidBody::_is_direct_state_required() const {
+
+	// Custom force integration and contact monitoring need more than the synced state.
+	return contact_monitor || (get_script_instance() && get_script_instance()->has_method(SceneStringNames::get_singleton()->_integrate_forces));
+}
+
+void RigidBody::_update_state_callback() {
+
+	// Not while the force integration callback is running, it would be freed under it.
+	// Staying on the direct state a while longer is always correct, just slower.
+	bool required = _is_direct_state_required();
+	if (required == direct_state_callback || state) {
+		return;
+	}
+
+	direct_state_callback = required;
+
+	// Bodies that need the full direct state get it inline, as the server steps
+	// them, the others are synced in bulk after the step.
+	if (direct_state_callback) {
+		PhysicsServer::get_singleton()->body_set_state_sync_callback(get_rid(), NULL, NULL);
+		PhysicsServer::get_singleton()->body_set_force_integration_callback(get_rid(), this, "_direct_state_changed");
+	} else {
+		PhysicsServer::get_singleton()->body_set_force_integration_callback(get_rid(), NULL, StringName());
+		PhysicsServer::get_singleton()->body_set_state_sync_callback(get_rid(), this, _body_state_sync);
+	}
+}
+
+void RigidBody::_state_synced(const PhysicsServer::BodyStateSync &p_state) {
+
+	set_ignore_transform_notification(true);
+	set_global_transform(p_state.transform);
+	linear_velocity = p_state.linear_velocity;
+	angular_velocity = p_state.angular_velocity;
+	inverse_inertia_tensor = p_state.inverse_inertia_tensor;
+	if (sleeping != p_state.sleeping) {
+		sleeping = p_state.sleeping;
+		emit_signal(SceneStringNames::get_singleton()->sleeping_state_changed);
+	}
+	set_ignore_transform_notification(false);
+	_on_transform_changed();
+}
+
+void RigidBody::_body_state_sync(const PhysicsServer::BodyStateSync *p_states, int p_count) {
+
+	for (int i = 0; i < p_count; i++) {
+
+		// Looked up by ID, as a previous body's signal may have freed this one.
+		RigidBody *body = Object::cast_to<RigidBody>(ObjectDB::get_instance(p_states[i].instance_id));
+		if (!body) {
+			continue;
+		}
+
+		if (body->_is_direct_state_required()) {
+			// e.g. a script with _integrate_forces() was set in the tree, switch for the next steps
+			body->_update_state_callback();
+			body->_direct_state_changed(PhysicsServer::get_singleton()->body_get_direct_state(body->get_rid()));
+		} else {
+			body->_state_synced(p_states[i]);
+		}
+	}
+}
+
 void RigidBody::_notification(int p_what) {
 
+	if (p_what == NOTIFICATION_ENTER_TREE) {
+		_update_state_callback();
+	}
+
 #ifdef TOOLS_ENABLED
 	if (p_what == NOTIFICATION_ENTER_TREE) {
 		if (Engine::get_singleton()->is_editor_hint()) {
@@ -878,6 +945,8 @@ void RigidBody::set_contact_monitor(bool p_enabled) {
 		contact_monitor = memnew(ContactMonitor);
 		contact_monitor->locked = false;
 	}
+
+	_update_state_callback();
 }
 
 bool RigidBody::is_contact_monitor_enabled() const {
@@ -1069,8 +1138,9 @@ RigidBody::RigidBody() :
 	custom_integrator = false;
 	contact_monitor = NULL;
 	can_sleep = true;
+	direct_state_callback = false;
 
-	PhysicsServer::get_singleton()->body_set_force_integration_callback(get_rid(), this, "_direct_state_changed");
+	PhysicsServer::get_singleton()->body_set_state_sync_callback(get_rid(), this, _body_state_sync);
 }
 
 RigidBody::~RigidBody() {
@@ -1168,6 +1238,9 @@ Vector3 KinematicBody::move_and_slide(const Vector3 &p_linear_velocity, const Ve
 	floor_normal = Vector3();
 	floor_velocity = Vector3();
 
+	// Sliding only shortens the motion left, so every iteration stays within its length.
+	PhysicsServer::get_singleton()->body_begin_motion_batch(get_rid(), get_global_transform(), motion.length());
+
 	while (p_max_slides) {
 
 		Collision collision;
@@ -1210,6 +1283,7 @@ Vector3 KinematicBody::move_and_slide(const Vector3 &p_linear_velocity, const Ve
 								Transform gt = get_global_transform();
 								gt.origin -= collision.travel.slide(up_direction);
 								set_global_transform(gt);
+								PhysicsServer::get_singleton()->body_end_motion_batch(get_rid());
 								return Vector3();
 							}
 						}
@@ -1237,6 +1311,8 @@ Vector3 KinematicBody::move_and_slide(const Vector3 &p_linear_velocity, const Ve
 		--p_max_slides;
 	}
 
+	PhysicsServer::get_singleton()->body_end_motion_batch(get_rid());
+
 	return body_velocity;
 }
 
@@ -1328,8 +1404,10 @@ bool KinematicBody::separate_raycast_shapes(bool p_infinite_inertia, Collision &
 		}
 	}
 
-	gt.origin += recover;
-	set_global_transform(gt);
+	if (recover != Vector3()) {
+		gt.origin += recover;
+		set_global_transform(gt);
+	}
 
 	if (deepest != -1) {
 		r_collision.collider = sep_res[deepest].collider_id;
@@ -1368,17 +1446,17 @@ float KinematicBody::get_safe_margin() const {
 }
 int KinematicBody::get_slide_count() const {
 
-	return colliders.size();
+	return (int)colliders.size();
 }
 
 KinematicBody::Collision KinematicBody::get_slide_collision(int p_bounce) const {
-	ERR_FAIL_INDEX_V(p_bounce, colliders.size(), Collision());
+	ERR_FAIL_INDEX_V(p_bounce, (int)colliders.size(), Collision());
 	return colliders[p_bounce];
 }
 
 Ref<KinematicCollision> KinematicBody::_get_slide_collision(int p_bounce) {
 
-	ERR_FAIL_INDEX_V(p_bounce, colliders.size(), Ref<KinematicCollision>());
+	ERR_FAIL_INDEX_V(p_bounce, (int)colliders.size(), Ref<KinematicCollision>());
 	if (p_bounce >= slide_colliders.size()) {
 		slide_colliders.resize(p_bounce + 1);
 	}
@@ -31,6 +31,7 @@
 #ifndef PHYSICS_BODY__H
 #define PHYSICS_BODY__H
 
+#include "core/local_vector.h"
 #include "core/vset.h"
 #include "scene/3d/collision_object.h"
 #include "scene/resources/physics_material.h"
@@ -142,6 +143,7 @@ protected:
 
 	bool sleeping;
 	bool ccd;
+	bool direct_state_callback;
 
 	int max_contacts_reported;
 
@@ -191,6 +193,11 @@ protected:
 	void _body_inout(int p_status, ObjectID p_instance, int p_body_shape, int p_local_shape);
 	virtual void _direct_state_changed(Object *p_state);
 
+	virtual bool _is_direct_state_required() const;
+	void _update_state_callback();
+	void _state_synced(const PhysicsServer::BodyStateSync &p_state);
+	static void _body_state_sync(const PhysicsServer::BodyStateSync *p_states, int p_count);
+
 	void _notification(int p_what);
 	static void _bind_methods();
 
@@ -309,7 +316,7 @@ private:
 	bool on_floor;
 	bool on_ceiling;
 	bool on_wall;
-	Vector<Collision> colliders;
+	LocalVector<Collision> colliders; // keeps its memory from one slide to the next
 	Vector<Ref<KinematicCollision> > slide_colliders;
 	Ref<KinematicCollision> motion_cache;
 
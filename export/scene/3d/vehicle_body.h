@@ -195,6 +195,7 @@ class VehicleBody : public RigidBody {
 	static void _bind_methods();
 
 	void _direct_state_changed(Object *p_state);
+	virtual bool _is_direct_state_required() const { return true; }
 
 public:
 	void set_engine_force(float p_engine_force);
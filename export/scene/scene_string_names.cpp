@@ -81,6 +81,8 @@ SceneStringNames::SceneStringNames() {
 
 	_body_inout = StaticCString::create("_body_inout");
 	_area_inout = StaticCString::create("_area_inout");
+	_body_inout_batch = StaticCString::create("_body_inout_batch");
+	_area_inout_batch = StaticCString::create("_area_inout_batch");
 
 	idle = StaticCString::create("idle");
 	iteration = StaticCString::create("iteration");
@@ -91,6 +93,7 @@ SceneStringNames::SceneStringNames() {
 	_can_gizmo_scale = StaticCString::create("_can_gizmo_scale");
 
 	_physics_process = StaticCString::create("_physics_process");
+	_integrate_forces = StaticCString::create("_integrate_forces");
 	_process = StaticCString::create("_process");
 
 	_enter_tree = StaticCString::create("_enter_tree");
@@ -105,11 +105,14 @@ public:
 
 	StringName _body_inout;
 	StringName _area_inout;
+	StringName _body_inout_batch;
+	StringName _area_inout_batch;
 
 	StringName _get_gizmo_geometry;
 	StringName _can_gizmo_scale;
 
 	StringName _physics_process;
+	StringName _integrate_forces;
 	StringName _process;
 	StringName _enter_world;
 	StringName _exit_world;
@@ -42,10 +42,13 @@ class AreaPairSW : public ConstraintSW {
 	int body_shape;
 	int area_shape;
 	bool colliding;
+	uint64_t narrowphase_time;
 
 public:
 	bool setup(real_t p_step);
 	void solve(real_t p_step);
+	virtual bool writes_outside_island() const { return true; } // areas track overlaps with bodies from any island
+	virtual uint64_t get_narrowphase_time() const { return narrowphase_time; }
 
 	AreaPairSW(BodySW *p_body, int p_body_shape, AreaSW *p_area, int p_area_shape);
 	~AreaPairSW();
@@ -58,10 +61,13 @@ class Area2PairSW : public ConstraintSW {
 	int shape_a;
 	int shape_b;
 	bool colliding;
+	uint64_t narrowphase_time;
 
 public:
 	bool setup(real_t p_step);
 	void solve(real_t p_step);
+	virtual bool writes_outside_island() const { return true; } // areas track overlaps with bodies from any island
+	virtual uint64_t get_narrowphase_time() const { return narrowphase_time; }
 
 	Area2PairSW(AreaSW *p_area_a, int p_shape_a, AreaSW *p_area_b, int p_shape_b);
 	~Area2PairSW();
@@ -173,89 +173,110 @@ void AreaSW::set_monitorable(bool p_monitorable) {
 	_set_static(!monitorable);
 }
 
-void AreaSW::call_queries() {
+void AreaSW::_flush_monitor_events(MonitorQueue &p_queue, ObjectID &r_callback_id, const StringName &p_method) {
 
-	if (monitor_callback_id && !monitored_bodies.empty()) {
+	Object *obj = ObjectDB::get_instance(r_callback_id);
+	if (!obj) {
+		p_queue.clear();
+		r_callback_id = 0;
+		return;
+	}
 
-		Variant res[5];
-		Variant *resptr[5];
-		for (int i = 0; i < 5; i++)
-			resptr[i] = &res[i];
+	// Drain the queue before calling out, sorted so events keep being
+	// delivered in shape pair order.
+	monitor_events.clear();
+	for (MonitorQueue::Iterator it = p_queue.iter(); it.valid; it = p_queue.next_iter(it)) {
 
-		Object *obj = ObjectDB::get_instance(monitor_callback_id);
-		if (!obj) {
-			monitored_bodies.clear();
-			monitor_callback_id = 0;
-			return;
+		if (it.value->state == 0) { // Nothing happened
+			continue;
 		}
 
-		for (Map<BodyKey, BodyState>::Element *E = monitored_bodies.front(); E;) {
+		MonitorEvent ev;
+		ev.key = *it.key;
+		ev.state = it.value->state;
+		monitor_events.push_back(ev);
+	}
+	p_queue.clear();
 
-			if (E->get().state == 0) { // Nothing happened
-				Map<BodyKey, BodyState>::Element *next = E->next();
-				monitored_bodies.erase(E);
-				E = next;
-				continue;
+	int count = monitor_events.size();
+	if (count == 0) {
+		return;
+	}
+	monitor_events.sort();
+
+	Variant::CallError ce;
+
+	if (monitor_batching) {
+
+		PoolIntArray status;
+		Array rids;
+		PoolIntArray instances;
+		PoolIntArray body_shapes;
+		PoolIntArray area_shapes;
+		status.resize(count);
+		rids.resize(count);
+		instances.resize(count);
+		body_shapes.resize(count);
+		area_shapes.resize(count);
+
+		{
+			PoolIntArray::Write status_w = status.write();
+			PoolIntArray::Write instances_w = instances.write();
+			PoolIntArray::Write body_shapes_w = body_shapes.write();
+			PoolIntArray::Write area_shapes_w = area_shapes.write();
+
+			for (int i = 0; i < count; i++) {
+
+				const MonitorEvent &ev = monitor_events[i];
+				status_w[i] = ev.state > 0 ? PhysicsServer::AREA_BODY_ADDED : PhysicsServer::AREA_BODY_REMOVED;
+				rids[i] = ev.key.rid;
+				instances_w[i] = ev.key.instance_id;
+				body_shapes_w[i] = ev.key.body_shape;
+				area_shapes_w[i] = ev.key.area_shape;
 			}
-
-			res[0] = E->get().state > 0 ? PhysicsServer::AREA_BODY_ADDED : PhysicsServer::AREA_BODY_REMOVED;
-			res[1] = E->key().rid;
-			res[2] = E->key().instance_id;
-			res[3] = E->key().body_shape;
-			res[4] = E->key().area_shape;
-
-			Map<BodyKey, BodyState>::Element *next = E->next();
-			monitored_bodies.erase(E);
-			E = next;
-
-			Variant::CallError ce;
-			obj->call(monitor_callback_method, (const Variant **)resptr, 5, ce);
 		}
-	}
 
-	if (area_monitor_callback_id && !monitored_areas.empty()) {
+		Variant res[5] = { status, rids, instances, body_shapes, area_shapes };
+		const Variant *resptr[5] = { &res[0], &res[1], &res[2], &res[3], &res[4] };
+		obj->call(p_method, resptr, 5, ce);
+		return;
+	}
 
-		Variant res[5];
-		Variant *resptr[5];
-		for (int i = 0; i < 5; i++)
-			resptr[i] = &res[i];
+	Variant res[5];
+	Variant *resptr[5];
+	for (int i = 0; i < 5; i++)
+		resptr[i] = &res[i];
 
-		Object *obj = ObjectDB::get_instance(area_monitor_callback_id);
-		if (!obj) {
-			monitored_areas.clear();
-			area_monitor_callback_id = 0;
-			return;
-		}
+	for (int i = 0; i < count; i++) {
 
-		for (Map<BodyKey, BodyState>::Element *E = monitored_areas.front(); E;) {
+		const MonitorEvent &ev = monitor_events[i];
+		res[0] = ev.state > 0 ? PhysicsServer::AREA_BODY_ADDED : PhysicsServer::AREA_BODY_REMOVED;
+		res[1] = ev.key.rid;
+		res[2] = ev.key.instance_id;
+		res[3] = ev.key.body_shape;
+		res[4] = ev.key.area_shape;
 
-			if (E->get().state == 0) { // Nothing happened
-				Map<BodyKey, BodyState>::Element *next = E->next();
-				monitored_areas.erase(E);
-				E = next;
-				continue;
-			}
+		obj->call(p_method, (const Variant **)resptr, 5, ce);
+	}
+}
 
-			res[0] = E->get().state > 0 ? PhysicsServer::AREA_BODY_ADDED : PhysicsServer::AREA_BODY_REMOVED;
-			res[1] = E->key().rid;
-			res[2] = E->key().instance_id;
-			res[3] = E->key().body_shape;
-			res[4] = E->key().area_shape;
+void AreaSW::call_queries() {
 
-			Map<BodyKey, BodyState>::Element *next = E->next();
-			monitored_areas.erase(E);
-			E = next;
+	if (monitor_callback_id && !monitored_bodies.empty()) {
+		_flush_monitor_events(monitored_bodies, monitor_callback_id, monitor_callback_method);
+	}
 
-			Variant::CallError ce;
-			obj->call(area_monitor_callback_method, (const Variant **)resptr, 5, ce);
-		}
+	if (area_monitor_callback_id && !monitored_areas.empty()) {
+		_flush_monitor_events(monitored_areas, area_monitor_callback_id, area_monitor_callback_method);
 	}
 }
 
 AreaSW::AreaSW() :
 		CollisionObjectSW(TYPE_AREA),
 		monitor_query_list(this),
-		moved_list(this) {
+		moved_list(this),
+		monitored_bodies(16),
+		monitored_areas(16) {
 
 	_set_static(true); //areas are never active
 	space_override_mode = PhysicsServer::AREA_SPACE_OVERRIDE_DISABLED;
@@ -270,6 +291,7 @@ AreaSW::AreaSW() :
 	set_ray_pickable(false);
 	monitor_callback_id = 0;
 	area_monitor_callback_id = 0;
+	monitor_batching = false;
 	monitorable = false;
 }
 
@@ -32,6 +32,8 @@
 #define AREA_SW_H
 
 #include "collision_object_sw.h"
+#include "core/local_vector.h"
+#include "core/oa_hash_map.h"
 #include "core/self_list.h"
 #include "servers/physics_server.h"
 //#include "servers/physics/query_sw.h"
@@ -62,6 +64,8 @@ class AreaSW : public CollisionObjectSW {
 	SelfList<AreaSW> monitor_query_list;
 	SelfList<AreaSW> moved_list;
 
+	bool monitor_batching;
+
 	struct BodyKey {
 
 		RID rid;
@@ -82,21 +86,47 @@ class AreaSW : public CollisionObjectSW {
 				return rid < p_key.rid;
 		}
 
+		_FORCE_INLINE_ bool operator==(const BodyKey &p_key) const {
+
+			return rid == p_key.rid && body_shape == p_key.body_shape && area_shape == p_key.area_shape;
+		}
+
 		_FORCE_INLINE_ BodyKey() {}
 		BodyKey(BodySW *p_body, uint32_t p_body_shape, uint32_t p_area_shape);
 		BodyKey(AreaSW *p_body, uint32_t p_body_shape, uint32_t p_area_shape);
 	};
 
+	struct BodyKeyHasher {
+
+		static _FORCE_INLINE_ uint32_t hash(const BodyKey &p_key) {
+
+			uint32_t h = hash_djb2_one_32(p_key.rid.get_id());
+			h = hash_djb2_one_32(p_key.body_shape, h);
+			return hash_djb2_one_32(p_key.area_shape, h);
+		}
+	};
+
 	struct BodyState {
 
 		int state;
-		_FORCE_INLINE_ void inc() { state++; }
-		_FORCE_INLINE_ void dec() { state--; }
 		_FORCE_INLINE_ BodyState() { state = 0; }
 	};
 
-	Map<BodyKey, BodyState> monitored_bodies;
-	Map<BodyKey, BodyState> monitored_areas;
+	// Pending enter/exit counts since the last flush, keyed by shape pair.
+	typedef OAHashMap<BodyKey, BodyState, BodyKeyHasher> MonitorQueue;
+
+	MonitorQueue monitored_bodies;
+	MonitorQueue monitored_areas;
+
+	struct MonitorEvent {
+
+		BodyKey key;
+		int state;
+
+		_FORCE_INLINE_ bool operator<(const MonitorEvent &p_event) const { return key < p_event.key; }
+	};
+
+	LocalVector<MonitorEvent> monitor_events;
 
 	//virtual void shape_changed_notify(ShapeSW *p_shape);
 	//virtual void shape_deleted_notify(ShapeSW *p_shape);
@@ -105,6 +135,8 @@ class AreaSW : public CollisionObjectSW {
 
 	virtual void _shapes_changed();
 	void _queue_monitor_update();
+	_FORCE_INLINE_ void _queue_monitor_event(MonitorQueue &p_queue, const BodyKey &p_key, int p_delta);
+	void _flush_monitor_events(MonitorQueue &p_queue, ObjectID &r_callback_id, const StringName &p_method);
 
 public:
 	//_FORCE_INLINE_ const Transform& get_inverse_transform() const { return inverse_transform; }
@@ -116,6 +148,9 @@ public:
 	void set_area_monitor_callback(ObjectID p_id, const StringName &p_method);
 	_FORCE_INLINE_ bool has_area_monitor_callback() const { return area_monitor_callback_id; }
 
+	_FORCE_INLINE_ void set_monitor_batching(bool p_enable) { monitor_batching = p_enable; }
+	_FORCE_INLINE_ bool is_monitor_batching() const { return monitor_batching; }
+
 	_FORCE_INLINE_ void add_body_to_query(BodySW *p_body, uint32_t p_body_shape, uint32_t p_area_shape);
 	_FORCE_INLINE_ void remove_body_from_query(BodySW *p_body, uint32_t p_body_shape, uint32_t p_area_shape);
 
@@ -170,34 +205,36 @@ public:
 	~AreaSW();
 };
 
-void AreaSW::add_body_to_query(BodySW *p_body, uint32_t p_body_shape, uint32_t p_area_shape) {
+void AreaSW::_queue_monitor_event(MonitorQueue &p_queue, const BodyKey &p_key, int p_delta) {
 
-	BodyKey bk(p_body, p_body_shape, p_area_shape);
-	monitored_bodies[bk].inc();
+	BodyState *bs = p_queue.lookup_ptr(p_key);
+	if (bs) {
+		bs->state += p_delta;
+	} else {
+		BodyState new_bs;
+		new_bs.state = p_delta;
+		p_queue.insert(p_key, new_bs);
+	}
 	if (!monitor_query_list.in_list())
 		_queue_monitor_update();
 }
+
+void AreaSW::add_body_to_query(BodySW *p_body, uint32_t p_body_shape, uint32_t p_area_shape) {
+
+	_queue_monitor_event(monitored_bodies, BodyKey(p_body, p_body_shape, p_area_shape), 1);
+}
 void AreaSW::remove_body_from_query(BodySW *p_body, uint32_t p_body_shape, uint32_t p_area_shape) {
 
-	BodyKey bk(p_body, p_body_shape, p_area_shape);
-	monitored_bodies[bk].dec();
-	if (!monitor_query_list.in_list())
-		_queue_monitor_update();
+	_queue_monitor_event(monitored_bodies, BodyKey(p_body, p_body_shape, p_area_shape), -1);
 }
 
 void AreaSW::add_area_to_query(AreaSW *p_area, uint32_t p_area_shape, uint32_t p_self_shape) {
 
-	BodyKey bk(p_area, p_area_shape, p_self_shape);
-	monitored_areas[bk].inc();
-	if (!monitor_query_list.in_list())
-		_queue_monitor_update();
+	_queue_monitor_event(monitored_areas, BodyKey(p_area, p_area_shape, p_self_shape), 1);
 }
 void AreaSW::remove_area_from_query(AreaSW *p_area, uint32_t p_area_shape, uint32_t p_self_shape) {
 
-	BodyKey bk(p_area, p_area_shape, p_self_shape);
-	monitored_areas[bk].dec();
-	if (!monitor_query_list.in_list())
-		_queue_monitor_update();
+	_queue_monitor_event(monitored_areas, BodyKey(p_area, p_area_shape, p_self_shape), -1);
 }
 
 #endif // AREA__SW_H
@@ -32,6 +32,7 @@
 
 #include "collision_solver_sw.h"
 #include "core/os/os.h"
+#include "gjk_epa.h"
 #include "space_sw.h"
 
 /*
@@ -48,6 +49,8 @@
 #define RELAXATION_TIMESTEPS 3
 #define MIN_VELOCITY 0.0001
 #define MAX_BIAS_ROTATION (Math_PI / 8)
+//cached impulses are only reused if the contact normal did not turn more than ~18 degrees
+#define MIN_RECYCLE_NORMAL_DOT 0.95
 
 void BodyPairSW::_contact_added_callback(const Vector3 &p_point_A, const Vector3 &p_point_B, void *p_userdata) {
 
@@ -80,21 +83,44 @@ void BodyPairSW::contact_added_callback(const Vector3 &p_point_A, const Vector3
 	contact.normal = (p_point_A - p_point_B).normalized();
 	contact.mass_normal = 0; // will be computed in setup()
 
-	// attempt to determine if the contact will be reused
+	// attempt to determine if the contact will be reused, the persistent manifold
+	// is keyed by the local contact points, take the closest cached contact that
+	// lies within the recycle radius on both bodies and still pushes the same way
+
 	real_t contact_recycle_radius = space->get_contact_recycle_radius();
+	real_t recycle_radius_sq = contact_recycle_radius * contact_recycle_radius;
+	real_t best_distance = 1e20;
 
 	for (int i = 0; i < contact_count; i++) {
 
 		Contact &c = contacts[i];
-		if (c.local_A.distance_squared_to(local_A) < (contact_recycle_radius * contact_recycle_radius) &&
-				c.local_B.distance_squared_to(local_B) < (contact_recycle_radius * contact_recycle_radius)) {
+		real_t distance_A = c.local_A.distance_squared_to(local_A);
+		real_t distance_B = c.local_B.distance_squared_to(local_B);
+
+		if (distance_A >= recycle_radius_sq || distance_B >= recycle_radius_sq) {
+			continue;
+		}
+
+		real_t distance = distance_A + distance_B;
+		if (distance >= best_distance) {
+			continue;
+		}
+
+		best_distance = distance;
+		new_index = i;
+
+		if (c.normal.dot(contact.normal) >= MIN_RECYCLE_NORMAL_DOT) {
 
 			contact.acc_normal_impulse = c.acc_normal_impulse;
 			contact.acc_bias_impulse = c.acc_bias_impulse;
 			contact.acc_bias_impulse_center_of_mass = c.acc_bias_impulse_center_of_mass;
 			contact.acc_tangent_impulse = c.acc_tangent_impulse;
-			new_index = i;
-			break;
+		} else {
+
+			contact.acc_normal_impulse = 0;
+			contact.acc_bias_impulse = 0;
+			contact.acc_bias_impulse_center_of_mass = 0;
+			contact.acc_tangent_impulse = Vector3();
 		}
 	}
 
@@ -102,42 +128,88 @@ void BodyPairSW::contact_added_callback(const Vector3 &p_point_A, const Vector3
 
 	if (new_index == MAX_CONTACTS) {
 
-		// remove the contact with the minimum depth
+		_reduce_contacts(contact);
+		return;
+	}
+
+	contacts[new_index] = contact;
 
-		int least_deep = -1;
-		real_t min_depth = 1e10;
+	if (new_index == contact_count) {
 
-		for (int i = 0; i <= contact_count; i++) {
+		contact_count++;
+	}
+}
 
-			Contact &c = (i == contact_count) ? contact : contacts[i];
-			Vector3 global_A = A->get_transform().basis.xform(c.local_A);
-			Vector3 global_B = B->get_transform().basis.xform(c.local_B) + offset_B;
+real_t BodyPairSW::_get_contact_depth(const Contact &p_contact) const {
 
-			Vector3 axis = global_A - global_B;
-			real_t depth = axis.dot(c.normal);
+	Vector3 global_A = A->get_transform().basis.xform(p_contact.local_A);
+	Vector3 global_B = B->get_transform().basis.xform(p_contact.local_B) + offset_B;
 
-			if (depth < min_depth) {
+	return (global_A - global_B).dot(p_contact.normal);
+}
 
-				min_depth = depth;
-				least_deep = i;
-			}
+void BodyPairSW::_reduce_contacts(const Contact &p_new_contact) {
+
+	// the manifold is full, keep the deepest point and drop the one whose
+	// removal leaves the largest contact area, so the remaining points stay
+	// spread over the touching surface instead of piling up in one corner
+
+	const Contact *candidates[MAX_CONTACTS + 1];
+	for (int i = 0; i < MAX_CONTACTS; i++) {
+		candidates[i] = &contacts[i];
+	}
+	candidates[MAX_CONTACTS] = &p_new_contact;
+
+	int deepest = -1;
+	real_t max_depth = -1e20;
+
+	for (int i = 0; i <= MAX_CONTACTS; i++) {
+
+		real_t depth = _get_contact_depth(*candidates[i]);
+		if (depth > max_depth) {
+
+			max_depth = depth;
+			deepest = i;
 		}
+	}
+
+	ERR_FAIL_COND(deepest == -1);
 
-		ERR_FAIL_COND(least_deep == -1);
+	int removed = -1;
+	real_t max_area = -1;
 
-		if (least_deep < contact_count) { //replace the last deep contact by the new one
+	for (int i = 0; i <= MAX_CONTACTS; i++) {
 
-			contacts[least_deep] = contact;
+		if (i == deepest) {
+			continue;
 		}
 
-		return;
+		Vector3 p[MAX_CONTACTS];
+		int point_count = 0;
+		for (int j = 0; j <= MAX_CONTACTS; j++) {
+			if (j != i) {
+				p[point_count++] = candidates[j]->local_A;
+			}
+		}
+
+		// the cross product of the diagonals is twice the area of the quad, take the
+		// largest of the three ways to pair the points, and compare it squared
+		real_t area = (p[0] - p[1]).cross(p[2] - p[3]).length_squared();
+		area = MAX(area, (p[0] - p[2]).cross(p[1] - p[3]).length_squared());
+		area = MAX(area, (p[0] - p[3]).cross(p[1] - p[2]).length_squared());
+
+		if (area > max_area) {
+
+			max_area = area;
+			removed = i;
+		}
 	}
 
-	contacts[new_index] = contact;
+	ERR_FAIL_COND(removed == -1);
 
-	if (new_index == contact_count) {
+	if (removed < MAX_CONTACTS) { //replace the removed contact by the new one
 
-		contact_count++;
+		contacts[removed] = p_new_contact;
 	}
 }
 
@@ -169,7 +241,7 @@ void BodyPairSW::validate_contacts() {
 	}
 }
 
-bool BodyPairSW::_test_ccd(real_t p_step, BodySW *p_A, int p_shape_A, const Transform &p_xform_A, BodySW *p_B, int p_shape_B, const Transform &p_xform_B) {
+bool BodyPairSW::_cast_ccd_ray(real_t p_step, BodySW *p_A, int p_shape_A, const Transform &p_xform_A, BodySW *p_B, int p_shape_B, const Transform &p_xform_B) {
 
 	Vector3 motion = p_A->get_linear_velocity() * p_step;
 	real_t mlen = motion.length();
@@ -211,6 +283,89 @@ bool BodyPairSW::_test_ccd(real_t p_step, BodySW *p_A, int p_shape_A, const Tran
 	return true;
 }
 
+// Conservative advancement: A is moved along its motion over the step by its distance to B,
+// divided by the fastest any of its points can approach B, until the shapes touch. The
+// distance needs convex shapes, against concave ones the ray cast above is used instead.
+bool BodyPairSW::_test_ccd(real_t p_step, BodySW *p_A, int p_shape_A, const Transform &p_xform_A, BodySW *p_B, int p_shape_B, const Transform &p_xform_B) {
+
+	const ShapeSW *shape_A_ptr = p_A->get_shape(p_shape_A);
+	const ShapeSW *shape_B_ptr = p_B->get_shape(p_shape_B);
+
+	if (shape_A_ptr->is_concave() || shape_B_ptr->is_concave() || shape_A_ptr->get_type() == PhysicsServer::SHAPE_PLANE || shape_B_ptr->get_type() == PhysicsServer::SHAPE_PLANE || shape_B_ptr->get_type() == PhysicsServer::SHAPE_RAY) {
+		return _cast_ccd_ray(p_step, p_A, p_shape_A, p_xform_A, p_B, p_shape_B, p_xform_B);
+	}
+
+	Vector3 linear_velocity = p_A->get_linear_velocity();
+	Vector3 angular_velocity = p_A->get_angular_velocity();
+	real_t angular_speed = angular_velocity.length();
+	real_t radius = p_A->get_shape_rotation_radius(p_shape_A);
+	real_t max_speed = linear_velocity.length() + angular_speed * radius;
+
+	// only bodies that can pass through something as thin as a third of themselves need it
+	AABB aabb = Transform(p_xform_A.basis, Vector3()).xform(shape_A_ptr->get_aabb());
+	if (max_speed * p_step < aabb.get_shortest_axis_size() * 0.3) {
+		return false;
+	}
+
+	Transform body_xform = p_A->get_transform();
+	Transform shape_xform = p_A->get_shape_transform(p_shape_A);
+	Vector3 center_of_mass = p_A->get_center_of_mass();
+	Transform xform_B = p_B->get_transform() * p_B->get_shape_transform(p_shape_B);
+	Vector3 axis = angular_speed > CMP_EPSILON ? angular_velocity / angular_speed : Vector3();
+
+	// the pairs would find a penetration this deep, stop that far from B
+	real_t tolerance = MAX(space->get_contact_max_allowed_penetration(), (real_t)0.001);
+	real_t fraction = 0;
+	real_t approach_speed = max_speed;
+
+	for (int i = 0; i < CCD_MAX_ITERATIONS; i++) {
+
+		// the same motion as BodySW::integrate_velocities(), for a fraction of the step
+		Transform xform = body_xform;
+		if (axis != Vector3()) {
+			Basis rot(axis, angular_speed * p_step * fraction);
+			xform.basis = rot * xform.basis;
+			xform.origin += center_of_mass - rot.xform(center_of_mass);
+		}
+		xform.origin += linear_velocity * p_step * fraction;
+
+		Vector3 closest_A, closest_B;
+		bool separated = gjk_epa_calculate_distance(shape_A_ptr, xform * shape_xform, shape_B_ptr, xform_B, closest_A, closest_B);
+		Vector3 gap = closest_B - closest_A;
+		real_t distance = gap.length();
+		if (!separated || distance <= CMP_EPSILON) {
+			if (i == 0) {
+				return false; // already touching, the contacts take it from here
+			}
+			break;
+		}
+
+		// only motion towards B closes the gap, sliding along B or moving away never hits it
+		approach_speed = linear_velocity.dot(gap / distance) + angular_speed * radius;
+		if (approach_speed <= CMP_EPSILON) {
+			return false;
+		}
+
+		if (distance < tolerance) {
+			break;
+		}
+
+		fraction += distance / (approach_speed * p_step);
+		if (fraction >= 1.0) {
+			return false;
+		}
+	}
+
+	// go a little further at the speed it closes in, so the next step finds the contact and solves it
+	fraction += 2.0 * tolerance / (approach_speed * p_step);
+	if (fraction >= 1.0) {
+		return false;
+	}
+
+	p_A->clamp_ccd_motion(fraction);
+	return true;
+}
+
 real_t combine_bounce(BodySW *A, BodySW *B) {
 	return CLAMP(A->get_bounce() + B->get_bounce(), 0, 1);
 }
@@ -221,6 +376,8 @@ real_t combine_friction(BodySW *A, BodySW *B) {
 
 bool BodyPairSW::setup(real_t p_step) {
 
+	narrowphase_time = 0;
+
 	//cannot collide
 	if (!A->test_collision_mask(B) || A->has_exception(B->get_self()) || B->has_exception(A->get_self()) || (A->get_mode() <= PhysicsServer::BODY_MODE_KINEMATIC && B->get_mode() <= PhysicsServer::BODY_MODE_KINEMATIC && A->get_max_contacts_reported() == 0 && B->get_max_contacts_reported() == 0)) {
 		collided = false;
@@ -232,6 +389,10 @@ bool BodyPairSW::setup(real_t p_step) {
 		return false;
 	}
 
+	// static and kinematic bodies don't move from impulses, and may be shared by islands being solved in parallel
+	dynamic_A = A->get_mode() > PhysicsServer::BODY_MODE_KINEMATIC;
+	dynamic_B = B->get_mode() > PhysicsServer::BODY_MODE_KINEMATIC;
+
 	offset_B = B->get_transform().get_origin() - A->get_transform().get_origin();
 
 	validate_contacts();
@@ -247,12 +408,17 @@ bool BodyPairSW::setup(real_t p_step) {
 	ShapeSW *shape_A_ptr = A->get_shape(shape_A);
 	ShapeSW *shape_B_ptr = B->get_shape(shape_B);
 
+	bool timed = space->is_narrowphase_timed();
+	uint64_t narrowphase_begin = timed ? OS::get_singleton()->get_ticks_usec() : 0;
 	bool collided = CollisionSolverSW::solve_static(shape_A_ptr, xform_A, shape_B_ptr, xform_B, _contact_added_callback, this, &sep_axis);
+	if (timed) {
+		narrowphase_time = OS::get_singleton()->get_ticks_usec() - narrowphase_begin;
+	}
 	this->collided = collided;
 
 	if (!collided) {
 
-		//test ccd (currently just a raycast)
+		//test ccd
 
 		if (A->is_continuous_collision_detection_enabled() && A->get_mode() > PhysicsServer::BODY_MODE_KINEMATIC && B->get_mode() <= PhysicsServer::BODY_MODE_KINEMATIC) {
 			_test_ccd(p_step, A, shape_A, xform_A, B, shape_B, xform_B);
@@ -280,6 +446,8 @@ bool BodyPairSW::setup(real_t p_step) {
 	}
 
 	real_t inv_dt = 1.0 / p_step;
+	real_t warm_start_factor = space->get_contact_warm_start_factor();
+	real_t friction = combine_friction(A, B);
 
 	for (int i = 0; i < contact_count; i++) {
 
@@ -333,9 +501,23 @@ bool BodyPairSW::setup(real_t p_step) {
 		c.bias = -bias * inv_dt * MIN(0.0f, -depth + max_penetration);
 		c.depth = depth;
 
+		// warm start with the impulses cached in the manifold, the tangent impulse is
+		// projected on the current contact plane and kept inside the friction cone
+		c.acc_normal_impulse *= warm_start_factor;
+		c.acc_tangent_impulse -= c.normal * c.normal.dot(c.acc_tangent_impulse);
+		c.acc_tangent_impulse *= warm_start_factor;
+
+		real_t tangent_len = c.acc_tangent_impulse.length();
+		real_t tangent_max = c.acc_normal_impulse * friction;
+		if (tangent_len > CMP_EPSILON && tangent_len > tangent_max) {
+			c.acc_tangent_impulse *= tangent_max / tangent_len;
+		}
+
 		Vector3 j_vec = c.normal * c.acc_normal_impulse + c.acc_tangent_impulse;
-		A->apply_impulse(c.rA + A->get_center_of_mass(), -j_vec);
-		B->apply_impulse(c.rB + B->get_center_of_mass(), j_vec);
+		if (dynamic_A)
+			A->apply_impulse(c.rA + A->get_center_of_mass(), -j_vec);
+		if (dynamic_B)
+			B->apply_impulse(c.rB + B->get_center_of_mass(), j_vec);
 		c.acc_bias_impulse = 0;
 		c.acc_bias_impulse_center_of_mass = 0;
 
@@ -382,8 +564,10 @@ void BodyPairSW::solve(real_t p_step) {
 
 			Vector3 jb = c.normal * (c.acc_bias_impulse - jbnOld);
 
-			A->apply_bias_impulse(c.rA + A->get_center_of_mass(), -jb, MAX_BIAS_ROTATION / p_step);
-			B->apply_bias_impulse(c.rB + B->get_center_of_mass(), jb, MAX_BIAS_ROTATION / p_step);
+			if (dynamic_A)
+				A->apply_bias_impulse(c.rA + A->get_center_of_mass(), -jb, MAX_BIAS_ROTATION / p_step);
+			if (dynamic_B)
+				B->apply_bias_impulse(c.rB + B->get_center_of_mass(), jb, MAX_BIAS_ROTATION / p_step);
 
 			crbA = A->get_biased_angular_velocity().cross(c.rA);
 			crbB = B->get_biased_angular_velocity().cross(c.rB);
@@ -399,8 +583,10 @@ void BodyPairSW::solve(real_t p_step) {
 
 				Vector3 jb_com = c.normal * (c.acc_bias_impulse_center_of_mass - jbnOld_com);
 
-				A->apply_bias_impulse(A->get_center_of_mass(), -jb_com, 0.0f);
-				B->apply_bias_impulse(B->get_center_of_mass(), jb_com, 0.0f);
+				if (dynamic_A)
+					A->apply_bias_impulse(A->get_center_of_mass(), -jb_com, 0.0f);
+				if (dynamic_B)
+					B->apply_bias_impulse(B->get_center_of_mass(), jb_com, 0.0f);
 			}
 
 			c.active = true;
@@ -421,8 +607,10 @@ void BodyPairSW::solve(real_t p_step) {
 
 			Vector3 j = c.normal * (c.acc_normal_impulse - jnOld);
 
-			A->apply_impulse(c.rA + A->get_center_of_mass(), -j);
-			B->apply_impulse(c.rB + B->get_center_of_mass(), j);
+			if (dynamic_A)
+				A->apply_impulse(c.rA + A->get_center_of_mass(), -j);
+			if (dynamic_B)
+				B->apply_impulse(c.rB + B->get_center_of_mass(), j);
 
 			c.active = true;
 		}
@@ -466,14 +654,67 @@ void BodyPairSW::solve(real_t p_step) {
 
 			jt = c.acc_tangent_impulse - jtOld;
 
-			A->apply_impulse(c.rA + A->get_center_of_mass(), -jt);
-			B->apply_impulse(c.rB + B->get_center_of_mass(), jt);
+			if (dynamic_A)
+				A->apply_impulse(c.rA + A->get_center_of_mass(), -jt);
+			if (dynamic_B)
+				B->apply_impulse(c.rB + B->get_center_of_mass(), jt);
 
 			c.active = true;
 		}
 	}
 }
 
+bool BodyPairSW::writes_outside_island() const {
+
+	// impulses never touch static or kinematic bodies, but contacts may still be reported to them
+	if ((A->get_mode() <= PhysicsServer::BODY_MODE_KINEMATIC && A->can_report_contacts()) || (B->get_mode() <= PhysicsServer::BODY_MODE_KINEMATIC && B->can_report_contacts())) {
+		return true;
+	}
+
+#ifdef DEBUG_ENABLED
+	if (space->is_debugging_contacts()) {
+		return true;
+	}
+#endif
+
+	return false;
+}
+
+bool BodyPairSW::save_state(SnapshotWriterSW &r_writer) const {
+
+	r_writer.put(sep_axis);
+	r_writer.put(collided);
+	r_writer.put(contact_count);
+	for (int i = 0; i < contact_count; i++) {
+		r_writer.put(contacts[i]);
+	}
+
+	return true;
+}
+
+void BodyPairSW::load_state(SnapshotReaderSW &p_reader) {
+
+	int count = 0;
+
+	p_reader.get(sep_axis);
+	p_reader.get(collided);
+	p_reader.get(count);
+	ERR_FAIL_COND(p_reader.has_failed() || count < 0 || count > MAX_CONTACTS);
+
+	for (int i = 0; i < count; i++) {
+		p_reader.get(contacts[i]);
+	}
+
+	contact_count = p_reader.has_failed() ? 0 : count;
+}
+
+void BodyPairSW::clear_state() {
+
+	sep_axis = Vector3();
+	collided = false;
+	contact_count = 0;
+}
+
 BodyPairSW::BodyPairSW(BodySW *p_A, int p_shape_A, BodySW *p_B, int p_shape_B) :
 		ConstraintSW(_arr, 2) {
 
@@ -482,10 +723,14 @@ BodyPairSW::BodyPairSW(BodySW *p_A, int p_shape_A, BodySW *p_B, int p_shape_B) :
 	shape_A = p_shape_A;
 	shape_B = p_shape_B;
 	space = A->get_space();
+	set_sort_key((uint64_t(A->get_self().get_id()) << 32) | B->get_self().get_id(), (uint64_t(uint32_t(shape_A)) << 32) | uint32_t(shape_B));
 	A->add_constraint(this, 0);
 	B->add_constraint(this, 1);
 	contact_count = 0;
 	collided = false;
+	narrowphase_time = 0;
+	dynamic_A = false;
+	dynamic_B = false;
 }
 
 BodyPairSW::~BodyPairSW() {
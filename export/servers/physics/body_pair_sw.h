@@ -37,7 +37,8 @@
 class BodyPairSW : public ConstraintSW {
 	enum {
 
-		MAX_CONTACTS = 4
+		MAX_CONTACTS = 4,
+		CCD_MAX_ITERATIONS = 16
 	};
 
 	union {
@@ -76,12 +77,18 @@ class BodyPairSW : public ConstraintSW {
 	Contact contacts[MAX_CONTACTS];
 	int contact_count;
 	bool collided;
+	uint64_t narrowphase_time;
+	bool dynamic_A;
+	bool dynamic_B;
 
 	static void _contact_added_callback(const Vector3 &p_point_A, const Vector3 &p_point_B, void *p_userdata);
 
 	void contact_added_callback(const Vector3 &p_point_A, const Vector3 &p_point_B);
 
+	real_t _get_contact_depth(const Contact &p_contact) const;
+	void _reduce_contacts(const Contact &p_new_contact);
 	void validate_contacts();
+	bool _cast_ccd_ray(real_t p_step, BodySW *p_A, int p_shape_A, const Transform &p_xform_A, BodySW *p_B, int p_shape_B, const Transform &p_xform_B);
 	bool _test_ccd(real_t p_step, BodySW *p_A, int p_shape_A, const Transform &p_xform_A, BodySW *p_B, int p_shape_B, const Transform &p_xform_B);
 
 	SpaceSW *space;
@@ -89,6 +96,12 @@ class BodyPairSW : public ConstraintSW {
 public:
 	bool setup(real_t p_step);
 	void solve(real_t p_step);
+	virtual bool writes_outside_island() const;
+	virtual uint64_t get_narrowphase_time() const { return narrowphase_time; }
+
+	virtual bool save_state(SnapshotWriterSW &r_writer) const;
+	virtual void load_state(SnapshotReaderSW &p_reader);
+	virtual void clear_state();
 
 	BodyPairSW(BodySW *p_A, int p_shape_A, BodySW *p_B, int p_shape_B);
 	~BodyPairSW();
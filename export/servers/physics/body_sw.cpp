@@ -32,6 +32,17 @@
 #include "area_sw.h"
 #include "space_sw.h"
 
+bool ConstraintOrderSW::operator()(const ConstraintSW *p_a, const ConstraintSW *p_b) const {
+
+	if (p_a->get_sort_key_high() != p_b->get_sort_key_high()) {
+		return p_a->get_sort_key_high() < p_b->get_sort_key_high();
+	}
+	if (p_a->get_sort_key_low() != p_b->get_sort_key_low()) {
+		return p_a->get_sort_key_low() < p_b->get_sort_key_low();
+	}
+	return p_a < p_b;
+}
+
 void BodySW::_update_inertia() {
 
 	if (get_space() && !inertia_update_list.in_list())
@@ -259,6 +270,16 @@ void BodySW::set_mode(PhysicsServer::BodyMode p_mode) {
 	PhysicsServer::BodyMode prev = mode;
 	mode = p_mode;
 
+	if ((prev > PhysicsServer::BODY_MODE_KINEMATIC) != (p_mode > PhysicsServer::BODY_MODE_KINEMATIC)) {
+		// only rigid and character bodies join the islands of the bodies they are constrained to
+		for (ConstraintMap::Element *E = constraint_map.front(); E; E = E->next()) {
+			for (int i = 0; i < E->key()->get_body_count(); i++) {
+				E->key()->get_body_ptr()[i]->invalidate_island();
+			}
+		}
+		set_island(NULL);
+	}
+
 	switch (p_mode) {
 		//CLEAR UP EVERYTHING IN CASE IT NOT WORKS!
 		case PhysicsServer::BODY_MODE_STATIC:
@@ -403,8 +424,32 @@ Variant BodySW::get_state(PhysicsServer::BodyState p_state) const {
 	return Variant();
 }
 
+void BodySW::set_island(IslandSW *p_island) {
+
+	if (island == p_island)
+		return;
+
+	if (island) {
+		// the constraints of the body may still be listed, they are found again when it's populated
+		island->constraints.clear();
+		island->dirty = true;
+		island->users--;
+		if (island->users == 0) {
+			memdelete(island);
+		}
+	}
+
+	island = p_island;
+
+	if (island) {
+		island->users++;
+	}
+}
+
 void BodySW::set_space(SpaceSW *p_space) {
 
+	set_island(NULL);
+
 	if (get_space()) {
 
 		if (inertia_update_list.in_list())
@@ -526,6 +571,7 @@ void BodySW::integrate_forces(real_t p_step) {
 	*/
 
 	Vector3 motion;
+	real_t sweep = 0;
 	bool do_motion = false;
 
 	if (mode == PhysicsServer::BODY_MODE_KINEMATIC) {
@@ -570,6 +616,13 @@ void BodySW::integrate_forces(real_t p_step) {
 		if (continuous_cd) {
 			motion = linear_velocity * p_step;
 			do_motion = true;
+
+			real_t angle = angular_velocity.length() * p_step;
+			if (angle > CMP_EPSILON) {
+				for (int i = 0; i < get_shape_count(); i++) {
+					sweep = MAX(sweep, get_shape_rotation_radius(i) * MIN(angle, (real_t)2.0));
+				}
+			}
 		}
 	}
 
@@ -583,19 +636,31 @@ void BodySW::integrate_forces(real_t p_step) {
 	biased_linear_velocity = Vector3();
 
 	if (do_motion) { //shapes temporarily extend for raycast
-		_update_shapes_with_motion(motion);
+		_update_shapes_with_motion(motion, sweep);
 	}
 
 	def_area = NULL; // clear the area, so it is set in the next frame
 	contact_count = 0;
 }
 
+real_t BodySW::get_shape_rotation_radius(int p_shape) const {
+
+	AABB aabb = (Transform(get_transform().basis, Vector3()) * get_shape_transform(p_shape)).xform(get_shape(p_shape)->get_aabb());
+
+	real_t radius = 0;
+	for (int i = 0; i < 8; i++) {
+		radius = MAX(radius, aabb.get_endpoint(i).distance_to(center_of_mass));
+	}
+
+	return radius;
+}
+
 void BodySW::integrate_velocities(real_t p_step) {
 
 	if (mode == PhysicsServer::BODY_MODE_STATIC)
 		return;
 
-	if (fi_callback)
+	if (fi_callback || state_sync_callback)
 		get_space()->body_add_to_state_query_list(&direct_state_query_list);
 
 	//apply axis lock linear
@@ -624,6 +689,10 @@ void BodySW::integrate_velocities(real_t p_step) {
 		return;
 	}
 
+	// CCD may have found an impact before the end of the step
+	real_t motion_step = p_step * ccd_motion_scale;
+	ccd_motion_scale = 1.0;
+
 	Vector3 total_angular_velocity = angular_velocity + biased_angular_velocity;
 
 	real_t ang_vel = total_angular_velocity.length();
@@ -631,7 +700,7 @@ void BodySW::integrate_velocities(real_t p_step) {
 
 	if (ang_vel != 0.0) {
 		Vector3 ang_vel_axis = total_angular_velocity / ang_vel;
-		Basis rot(ang_vel_axis, ang_vel * p_step);
+		Basis rot(ang_vel_axis, ang_vel * motion_step);
 		Basis identity3(1, 0, 0, 0, 1, 0, 0, 0, 1);
 		transform.origin += ((identity3 - rot) * transform.basis).xform(center_of_mass_local);
 		transform.basis = rot * transform.basis;
@@ -645,7 +714,7 @@ void BodySW::integrate_velocities(real_t p_step) {
 		}
 	}*/
 
-	transform.origin += total_linear_velocity * p_step;
+	transform.origin += total_linear_velocity * motion_step;
 
 	_set_transform(transform);
 	_set_inv_transform(get_transform().inverse());
@@ -692,9 +761,57 @@ void BodySW::simulate_motion(const Transform& p_xform,real_t p_step) {
 }
 */
 
+void BodySW::save_state(SnapshotWriterSW &r_writer) const {
+
+	// the transform dependant values are stored as well instead of being recomputed,
+	// kinematic bodies don't update them every step
+	r_writer.put(get_transform());
+	r_writer.put(get_inv_transform());
+	r_writer.put(new_transform);
+	r_writer.put(center_of_mass);
+	r_writer.put(principal_inertia_axes);
+	r_writer.put(_inv_inertia_tensor);
+	r_writer.put(linear_velocity);
+	r_writer.put(angular_velocity);
+	r_writer.put(applied_force);
+	r_writer.put(applied_torque);
+	r_writer.put(still_time);
+	r_writer.put(first_integration);
+}
+
+bool BodySW::load_state(SnapshotReaderSW &p_reader) {
+
+	Transform transform;
+	Transform inv_transform;
+
+	p_reader.get(transform);
+	p_reader.get(inv_transform);
+	p_reader.get(new_transform);
+	p_reader.get(center_of_mass);
+	p_reader.get(principal_inertia_axes);
+	p_reader.get(_inv_inertia_tensor);
+	p_reader.get(linear_velocity);
+	p_reader.get(angular_velocity);
+	p_reader.get(applied_force);
+	p_reader.get(applied_torque);
+	p_reader.get(still_time);
+	p_reader.get(first_integration);
+
+	ERR_FAIL_COND_V(p_reader.has_failed(), false);
+
+	_set_transform(transform);
+	_set_inv_transform(inv_transform);
+
+	if ((fi_callback || state_sync_callback) && get_space() && !direct_state_query_list.in_list()) {
+		get_space()->body_add_to_state_query_list(&direct_state_query_list);
+	}
+
+	return true;
+}
+
 void BodySW::wakeup_neighbours() {
 
-	for (Map<ConstraintSW *, int>::Element *E = constraint_map.front(); E; E = E->next()) {
+	for (ConstraintMap::Element *E = constraint_map.front(); E; E = E->next()) {
 
 		const ConstraintSW *c = E->key();
 		BodySW **n = c->get_body_ptr();
@@ -734,6 +851,16 @@ void BodySW::call_queries() {
 			int argc = (fi_callback->udata.get_type() == Variant::NIL) ? 1 : 2;
 			obj->call(fi_callback->method, vp, argc, ce);
 		}
+
+	} else if (state_sync_callback) {
+
+		PhysicsServer::BodyStateSync &state = get_space()->get_state_sync_queue().push(state_sync_callback);
+		state.instance_id = state_sync_id;
+		state.transform = get_transform();
+		state.linear_velocity = linear_velocity;
+		state.angular_velocity = angular_velocity;
+		state.inverse_inertia_tensor = _inv_inertia_tensor;
+		state.sleeping = !active;
 	}
 }
 
@@ -775,6 +902,12 @@ void BodySW::set_force_integration_callback(ObjectID p_id, const StringName &p_m
 	}
 }
 
+void BodySW::set_state_sync_callback(ObjectID p_id, PhysicsServer::BodyStateSyncCallback p_callback) {
+
+	state_sync_id = p_callback ? p_id : ObjectID(0);
+	state_sync_callback = p_id != 0 ? p_callback : NULL;
+}
+
 void BodySW::set_kinematic_margin(real_t p_margin) {
 	kinematic_safe_margin = p_margin;
 }
@@ -800,6 +933,7 @@ BodySW::BodySW() :
 	island_step = 0;
 	island_next = NULL;
 	island_list_next = NULL;
+	island = NULL;
 	first_time_kinematic = false;
 	first_integration = false;
 	_set_static(false);
@@ -813,12 +947,17 @@ BodySW::BodySW() :
 
 	still_time = 0;
 	continuous_cd = false;
+	ccd_motion_scale = 1.0;
 	can_sleep = true;
 	fi_callback = NULL;
+	state_sync_id = 0;
+	state_sync_callback = NULL;
 }
 
 BodySW::~BodySW() {
 
+	set_island(NULL);
+
 	if (fi_callback)
 		memdelete(fi_callback);
 }
@@ -34,11 +34,22 @@
 #include "area_sw.h"
 #include "collision_object_sw.h"
 #include "core/vset.h"
+#include "island_sw.h"
+#include "snapshot_sw.h"
 
 class ConstraintSW;
 
+// orders constraints by their sort key instead of their address, so islands are
+// built and solved in the same order after a space snapshot is restored
+struct ConstraintOrderSW {
+	bool operator()(const ConstraintSW *p_a, const ConstraintSW *p_b) const;
+};
+
 class BodySW : public CollisionObjectSW {
+public:
+	typedef Map<ConstraintSW *, int, ConstraintOrderSW> ConstraintMap;
 
+private:
 	PhysicsServer::BodyMode mode;
 
 	Vector3 linear_velocity;
@@ -90,13 +101,14 @@ class BodySW : public CollisionObjectSW {
 	bool first_integration;
 
 	bool continuous_cd;
+	real_t ccd_motion_scale; // fraction of the step the body moves, below 1 when CCD found an impact
 	bool can_sleep;
 	bool first_time_kinematic;
 	void _update_inertia();
 	virtual void _shapes_changed();
 	Transform new_transform;
 
-	Map<ConstraintSW *, int> constraint_map;
+	ConstraintMap constraint_map;
 
 	struct AreaCMP {
 
@@ -138,9 +150,13 @@ class BodySW : public CollisionObjectSW {
 
 	ForceIntegrationCallback *fi_callback;
 
+	ObjectID state_sync_id;
+	PhysicsServer::BodyStateSyncCallback state_sync_callback;
+
 	uint64_t island_step;
 	BodySW *island_next;
 	BodySW *island_list_next;
+	IslandSW *island;
 
 	_FORCE_INLINE_ void _compute_area_gravity_and_dampenings(const AreaSW *p_area);
 
@@ -150,6 +166,7 @@ class BodySW : public CollisionObjectSW {
 
 public:
 	void set_force_integration_callback(ObjectID p_id, const StringName &p_method, const Variant &p_udata = Variant());
+	void set_state_sync_callback(ObjectID p_id, PhysicsServer::BodyStateSyncCallback p_callback);
 
 	void set_kinematic_margin(real_t p_margin);
 	_FORCE_INLINE_ real_t get_kinematic_margin() { return kinematic_safe_margin; }
@@ -196,10 +213,32 @@ public:
 	_FORCE_INLINE_ BodySW *get_island_list_next() const { return island_list_next; }
 	_FORCE_INLINE_ void set_island_list_next(BodySW *p_next) { island_list_next = p_next; }
 
-	_FORCE_INLINE_ void add_constraint(ConstraintSW *p_constraint, int p_pos) { constraint_map[p_constraint] = p_pos; }
-	_FORCE_INLINE_ void remove_constraint(ConstraintSW *p_constraint) { constraint_map.erase(p_constraint); }
-	const Map<ConstraintSW *, int> &get_constraint_map() const { return constraint_map; }
-	_FORCE_INLINE_ void clear_constraint_map() { constraint_map.clear(); }
+	_FORCE_INLINE_ IslandSW *get_island() const { return island; }
+	void set_island(IslandSW *p_island);
+	_FORCE_INLINE_ void invalidate_island() {
+		if (island)
+			island->dirty = true;
+	}
+
+	_FORCE_INLINE_ void add_constraint(ConstraintSW *p_constraint, int p_pos) {
+		constraint_map[p_constraint] = p_pos;
+		invalidate_island();
+	}
+	_FORCE_INLINE_ void remove_constraint(ConstraintSW *p_constraint) {
+		constraint_map.erase(p_constraint);
+		if (island) {
+			island->constraints.erase(p_constraint);
+			island->dirty = true;
+		}
+	}
+	const ConstraintMap &get_constraint_map() const { return constraint_map; }
+	_FORCE_INLINE_ void clear_constraint_map() {
+		constraint_map.clear();
+		if (island) {
+			island->constraints.clear();
+			island->dirty = true;
+		}
+	}
 
 	_FORCE_INLINE_ void set_omit_force_integration(bool p_omit_force_integration) { omit_force_integration = p_omit_force_integration; }
 	_FORCE_INLINE_ bool get_omit_force_integration() const { return omit_force_integration; }
@@ -291,6 +330,11 @@ public:
 	_FORCE_INLINE_ void set_continuous_collision_detection(bool p_enable) { continuous_cd = p_enable; }
 	_FORCE_INLINE_ bool is_continuous_collision_detection_enabled() const { return continuous_cd; }
 
+	// moves the body only until the time of impact found by CCD, the velocity is kept for the next step
+	_FORCE_INLINE_ void clamp_ccd_motion(real_t p_fraction) { ccd_motion_scale = MIN(ccd_motion_scale, p_fraction); }
+	// farthest a point of the shape can be from the center of mass
+	real_t get_shape_rotation_radius(int p_shape) const;
+
 	void set_space(SpaceSW *p_space);
 
 	void update_inertias();
@@ -308,6 +352,9 @@ public:
 	void integrate_forces(real_t p_step);
 	void integrate_velocities(real_t p_step);
 
+	void save_state(SnapshotWriterSW &r_writer) const;
+	bool load_state(SnapshotReaderSW &p_reader);
+
 	_FORCE_INLINE_ Vector3 get_velocity_in_local_point(const Vector3 &rel_pos) const {
 
 		return linear_velocity + angular_velocity.cross(rel_pos - center_of_mass);
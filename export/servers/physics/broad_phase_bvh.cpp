@@ -116,6 +116,11 @@ void BroadPhaseBVH::update() {
 	bvh.update();
 }
 
+void BroadPhaseBVH::recheck_pairs(ID p_id) {
+	// resets the expanded pairing AABB to the current one, then checks all pairs
+	bvh.force_collision_check(p_id - 1);
+}
+
 BroadPhaseSW *BroadPhaseBVH::_create() {
 
 	return memnew(BroadPhaseBVH);
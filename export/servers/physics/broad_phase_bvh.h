@@ -65,6 +65,7 @@ public:
 	virtual void set_unpair_callback(UnpairCallback p_unpair_callback, void *p_userdata);
 
 	virtual void update();
+	virtual void recheck_pairs(ID p_id);
 
 	static BroadPhaseSW *_create();
 	BroadPhaseBVH();
@@ -67,6 +67,10 @@ public:
 
 	virtual void update() = 0;
 
+	// pairs are reported from the current AABBs only by default, broadphases that keep
+	// pairs alive with a margin drop that history here
+	virtual void recheck_pairs(ID p_id) {}
+
 	virtual ~BroadPhaseSW();
 };
 
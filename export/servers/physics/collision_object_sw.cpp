@@ -99,6 +99,8 @@ void CollisionObjectSW::remove_shape(int p_index) {
 
 	//remove anything from shape to be erased to end, so subindices don't change
 	ERR_FAIL_INDEX(p_index, shapes.size());
+	if (space)
+		space->object_broadphase_changed(this);
 	for (int i = p_index; i < shapes.size(); i++) {
 
 		if (shapes[i].bpid == 0)
@@ -134,6 +136,9 @@ void CollisionObjectSW::_set_static(bool p_static) {
 
 void CollisionObjectSW::_unregister_shapes() {
 
+	if (space)
+		space->object_broadphase_changed(this);
+
 	for (int i = 0; i < shapes.size(); i++) {
 
 		Shape &s = shapes.write[i];
@@ -149,6 +154,8 @@ void CollisionObjectSW::_update_shapes() {
 	if (!space)
 		return;
 
+	space->object_broadphase_changed(this);
+
 	for (int i = 0; i < shapes.size(); i++) {
 		Shape &s = shapes.write[i];
 
@@ -170,11 +177,25 @@ void CollisionObjectSW::_update_shapes() {
 	}
 }
 
-void CollisionObjectSW::_update_shapes_with_motion(const Vector3 &p_motion) {
+void CollisionObjectSW::recheck_broadphase_pairs() {
+
+	if (!space)
+		return;
+
+	for (int i = 0; i < shapes.size(); i++) {
+		if (shapes[i].bpid != 0) {
+			space->get_broadphase()->recheck_pairs(shapes[i].bpid);
+		}
+	}
+}
+
+void CollisionObjectSW::_update_shapes_with_motion(const Vector3 &p_motion, real_t p_sweep) {
 
 	if (!space)
 		return;
 
+	space->object_broadphase_changed(this);
+
 	for (int i = 0; i < shapes.size(); i++) {
 		Shape &s = shapes.write[i];
 
@@ -182,6 +203,7 @@ void CollisionObjectSW::_update_shapes_with_motion(const Vector3 &p_motion) {
 		AABB shape_aabb = s.shape->get_aabb();
 		Transform xform = transform * s.xform;
 		shape_aabb = xform.xform(shape_aabb);
+		shape_aabb.grow_by(p_sweep);
 		shape_aabb = shape_aabb.merge(AABB(shape_aabb.position + p_motion, shape_aabb.size)); //use motion
 		s.aabb_cache = shape_aabb;
 
@@ -82,7 +82,8 @@ private:
 	void _update_shapes();
 
 protected:
-	void _update_shapes_with_motion(const Vector3 &p_motion);
+	// p_sweep grows the shapes by how far their points can travel while rotating
+	void _update_shapes_with_motion(const Vector3 &p_motion, real_t p_sweep = 0);
 	void _unregister_shapes();
 
 	_FORCE_INLINE_ void _set_transform(const Transform &p_transform, bool p_update_shapes = true) {
@@ -136,6 +137,7 @@ public:
 	_FORCE_INLINE_ bool is_ray_pickable() const { return ray_pickable; }
 
 	void set_shape_as_disabled(int p_idx, bool p_enable);
+	void recheck_broadphase_pairs();
 	_FORCE_INLINE_ bool is_shape_set_as_disabled(int p_idx) const {
 		CRASH_BAD_INDEX(p_idx, shapes.size());
 		return shapes[p_idx].disabled;
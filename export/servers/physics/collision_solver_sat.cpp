@@ -620,6 +620,135 @@ static void _generate_contacts_from_supports(const Vector3 *p_points_A, int p_po
 	contacts_func(points_A, pointcount_A, points_B, pointcount_B, p_callback);
 }
 
+static bool packed_axis_tests = true;
+
+void sat_set_packed_axis_tests(bool p_enabled) {
+
+	packed_axis_tests = p_enabled;
+}
+
+bool sat_is_packed_axis_tests_enabled() {
+
+	return packed_axis_tests;
+}
+
+// Four separating axes in SoA layout, so projecting a shape on all of them at
+// once is a few 4-wide multiply-adds the compiler can map to SSE/NEON lanes.
+struct _AxisPack {
+
+	real_t x[4];
+	real_t y[4];
+	real_t z[4];
+
+	_FORCE_INLINE_ void dot(const Vector3 &p_vector, real_t *r_dot) const {
+
+		for (int i = 0; i < 4; i++) {
+			r_dot[i] = x[i] * p_vector.x + y[i] * p_vector.y + z[i] * p_vector.z;
+		}
+	}
+
+	// same as Basis::xform_inv() on every axis
+	_FORCE_INLINE_ void xform_inv(const Basis &p_basis, _AxisPack &r_local) const {
+
+		for (int i = 0; i < 4; i++) {
+			r_local.x[i] = p_basis.elements[0][0] * x[i] + p_basis.elements[1][0] * y[i] + p_basis.elements[2][0] * z[i];
+			r_local.y[i] = p_basis.elements[0][1] * x[i] + p_basis.elements[1][1] * y[i] + p_basis.elements[2][1] * z[i];
+			r_local.z[i] = p_basis.elements[0][2] * x[i] + p_basis.elements[1][2] * y[i] + p_basis.elements[2][2] * z[i];
+		}
+	}
+};
+
+// Shapes without a packed version project the axes one by one.
+template <class S>
+struct _ProjectAxisPack {
+
+	static _FORCE_INLINE_ void project(const S *p_shape, const Transform &p_transform, const Vector3 *p_axes, const _AxisPack &p_pack, real_t *r_min, real_t *r_max) {
+
+		for (int i = 0; i < 4; i++) {
+			p_shape->project_range(p_axes[i], p_transform, r_min[i], r_max[i]);
+		}
+	}
+};
+
+template <>
+struct _ProjectAxisPack<BoxShapeSW> {
+
+	static _FORCE_INLINE_ void project(const BoxShapeSW *p_shape, const Transform &p_transform, const Vector3 *p_axes, const _AxisPack &p_pack, real_t *r_min, real_t *r_max) {
+
+		_AxisPack local;
+		p_pack.xform_inv(p_transform.basis, local);
+		real_t distance[4];
+		p_pack.dot(p_transform.origin, distance);
+		const Vector3 &half_extents = p_shape->get_half_extents();
+
+		for (int i = 0; i < 4; i++) {
+			// no matter the angle, the box is mirrored anyway
+			real_t length = Math::abs(local.x[i]) * half_extents.x + Math::abs(local.y[i]) * half_extents.y + Math::abs(local.z[i]) * half_extents.z;
+			r_min[i] = distance[i] - length;
+			r_max[i] = distance[i] + length;
+		}
+	}
+};
+
+template <>
+struct _ProjectAxisPack<CapsuleShapeSW> {
+
+	static _FORCE_INLINE_ void project(const CapsuleShapeSW *p_shape, const Transform &p_transform, const Vector3 *p_axes, const _AxisPack &p_pack, real_t *r_min, real_t *r_max) {
+
+		_AxisPack local;
+		p_pack.xform_inv(p_transform.basis, local);
+		real_t distance[4];
+		p_pack.dot(p_transform.origin, distance);
+		real_t radius = p_shape->get_radius();
+		real_t half_height = p_shape->get_height() * 0.5;
+
+		for (int i = 0; i < 4; i++) {
+			// support of the ball at the end the axis points to, projected
+			real_t length = Math::sqrt(local.x[i] * local.x[i] + local.y[i] * local.y[i] + local.z[i] * local.z[i]) * radius + Math::abs(local.z[i]) * half_height;
+			r_min[i] = distance[i] - length;
+			r_max[i] = distance[i] + length;
+		}
+	}
+};
+
+template <>
+struct _ProjectAxisPack<ConvexPolygonShapeSW> {
+
+	static _FORCE_INLINE_ void project(const ConvexPolygonShapeSW *p_shape, const Transform &p_transform, const Vector3 *p_axes, const _AxisPack &p_pack, real_t *r_min, real_t *r_max) {
+
+		_AxisPack local;
+		p_pack.xform_inv(p_transform.basis, local);
+		real_t distance[4];
+		p_pack.dot(p_transform.origin, distance);
+
+		const Geometry::MeshData &mesh = p_shape->get_mesh();
+		int vertex_count = mesh.vertices.size();
+		const Vector3 *vertices = mesh.vertices.ptr();
+
+		real_t min[4], max[4];
+		for (int i = 0; i < 4; i++) {
+			min[i] = 1e20;
+			max[i] = -1e20;
+		}
+
+		for (int j = 0; j < vertex_count; j++) {
+
+			const Vector3 &v = vertices[j];
+
+			for (int i = 0; i < 4; i++) {
+				real_t d = local.x[i] * v.x + local.y[i] * v.y + local.z[i] * v.z;
+				min[i] = MIN(min[i], d);
+				max[i] = MAX(max[i], d);
+			}
+		}
+
+		for (int i = 0; i < 4; i++) {
+			r_min[i] = vertex_count ? distance[i] + min[i] : distance[i];
+			r_max[i] = vertex_count ? distance[i] + max[i] : distance[i];
+		}
+	}
+};
+
 template <class ShapeA, class ShapeB, bool withMargin = false>
 class SeparatorAxisTest {
 
@@ -634,6 +763,40 @@ class SeparatorAxisTest {
 	real_t margin_B;
 	Vector3 separator_axis;
 
+	Vector3 pending_axes[4];
+	int pending_axis_count;
+
+	_FORCE_INLINE_ bool _test_range(const Vector3 &p_axis, real_t p_min_B, real_t p_max_B) {
+
+		real_t min_B = p_min_B;
+		real_t max_B = p_max_B;
+
+		if (min_B > 0.0 || max_B < 0.0) {
+			separator_axis = p_axis;
+			return false; // doesn't contain 0
+		}
+
+		//use the smallest depth
+
+		if (min_B < 0.0) { // could be +0.0, we don't want it to become -0.0
+			min_B = -min_B;
+		}
+
+		if (max_B < min_B) {
+			if (max_B < best_depth) {
+				best_depth = max_B;
+				best_axis = p_axis;
+			}
+		} else {
+			if (min_B < best_depth) {
+				best_depth = min_B;
+				best_axis = -p_axis; // keep it as A axis
+			}
+		}
+
+		return true;
+	}
+
 public:
 	_FORCE_INLINE_ bool test_previous_axis() {
 
@@ -672,27 +835,80 @@ public:
 		min_B -= (min_A + max_A) * 0.5;
 		max_B -= (min_A + max_A) * 0.5;
 
-		if (min_B > 0.0 || max_B < 0.0) {
-			separator_axis = axis;
-			return false; // doesn't contain 0
-		}
+		return _test_range(axis, min_B, max_B);
+	}
 
-		//use the smallest depth
+	// Axes are queued and tested four at a time, in the order they were given.
+	// Call test_pending_axes() before generating contacts.
+	_FORCE_INLINE_ bool queue_axis(const Vector3 &p_axis) {
 
-		if (min_B < 0.0) { // could be +0.0, we don't want it to become -0.0
-			min_B = -min_B;
+		if (!packed_axis_tests)
+			return test_axis(p_axis);
+
+		pending_axes[pending_axis_count++] = p_axis;
+
+		if (pending_axis_count < 4)
+			return true;
+
+		return test_pending_axes();
+	}
+
+	bool test_pending_axes() {
+
+		int count = pending_axis_count;
+		if (count == 0)
+			return true;
+
+		pending_axis_count = 0;
+
+		// pad the pack with the last axis, testing it twice changes nothing
+		for (int i = count; i < 4; i++) {
+			pending_axes[i] = pending_axes[count - 1];
 		}
 
-		if (max_B < min_B) {
-			if (max_B < best_depth) {
-				best_depth = max_B;
-				best_axis = axis;
+		_AxisPack pack;
+
+		for (int i = 0; i < 4; i++) {
+
+			Vector3 &axis = pending_axes[i];
+
+			if (Math::abs(axis.x) < CMP_EPSILON &&
+					Math::abs(axis.y) < CMP_EPSILON &&
+					Math::abs(axis.z) < CMP_EPSILON) {
+				// strange case, try an upwards separator
+				axis = Vector3(0.0, 1.0, 0.0);
 			}
-		} else {
-			if (min_B < best_depth) {
-				best_depth = min_B;
-				best_axis = -axis; // keep it as A axis
+
+			pack.x[i] = axis.x;
+			pack.y[i] = axis.y;
+			pack.z[i] = axis.z;
+		}
+
+		real_t min_A[4], max_A[4], min_B[4], max_B[4];
+
+		_ProjectAxisPack<ShapeA>::project(shape_A, *transform_A, pending_axes, pack, min_A, max_A);
+		_ProjectAxisPack<ShapeB>::project(shape_B, *transform_B, pending_axes, pack, min_B, max_B);
+
+		for (int i = 0; i < 4; i++) {
+
+			if (withMargin) {
+				min_A[i] -= margin_A;
+				max_A[i] += margin_A;
+				min_B[i] -= margin_B;
+				max_B[i] += margin_B;
 			}
+
+			min_B[i] -= (max_A[i] - min_A[i]) * 0.5;
+			max_B[i] += (max_A[i] - min_A[i]) * 0.5;
+
+			min_B[i] -= (min_A[i] + max_A[i]) * 0.5;
+			max_B[i] -= (min_A[i] + max_A[i]) * 0.5;
+		}
+
+		for (int i = 0; i < count; i++) {
+
+			if (!_test_range(pending_axes[i], min_B[i], max_B[i]))
+				return false;
 		}
 
 		return true;
@@ -772,6 +988,7 @@ public:
 		callback = p_callback;
 		margin_A = p_margin_A;
 		margin_B = p_margin_B;
+		pending_axis_count = 0;
 	}
 };
 
@@ -1060,7 +1277,7 @@ static void _collision_box_box(const ShapeSW *p_a, const Transform &p_transform_
 
 		Vector3 axis = p_transform_a.basis.get_axis(i).normalized();
 
-		if (!separator.test_axis(axis))
+		if (!separator.queue_axis(axis))
 			return;
 	}
 
@@ -1070,7 +1287,7 @@ static void _collision_box_box(const ShapeSW *p_a, const Transform &p_transform_
 
 		Vector3 axis = p_transform_b.basis.get_axis(i).normalized();
 
-		if (!separator.test_axis(axis))
+		if (!separator.queue_axis(axis))
 			return;
 	}
 
@@ -1085,7 +1302,7 @@ static void _collision_box_box(const ShapeSW *p_a, const Transform &p_transform_
 				continue;
 			axis.normalize();
 
-			if (!separator.test_axis(axis)) {
+			if (!separator.queue_axis(axis)) {
 				return;
 			}
 		}
@@ -1116,7 +1333,7 @@ static void _collision_box_box(const ShapeSW *p_a, const Transform &p_transform_
 
 		Vector3 axis_ab = (support_a - support_b);
 
-		if (!separator.test_axis(axis_ab.normalized())) {
+		if (!separator.queue_axis(axis_ab.normalized())) {
 			return;
 		}
 
@@ -1127,17 +1344,20 @@ static void _collision_box_box(const ShapeSW *p_a, const Transform &p_transform_
 			//a ->b
 			Vector3 axis_a = p_transform_a.basis.get_axis(i);
 
-			if (!separator.test_axis(axis_ab.cross(axis_a).cross(axis_a).normalized()))
+			if (!separator.queue_axis(axis_ab.cross(axis_a).cross(axis_a).normalized()))
 				return;
 
 			//b ->a
 			Vector3 axis_b = p_transform_b.basis.get_axis(i);
 
-			if (!separator.test_axis(axis_ab.cross(axis_b).cross(axis_b).normalized()))
+			if (!separator.queue_axis(axis_ab.cross(axis_b).cross(axis_b).normalized()))
 				return;
 		}
 	}
 
+	if (!separator.test_pending_axes())
+		return;
+
 	separator.generate_contacts();
 }
 
@@ -1157,7 +1377,7 @@ static void _collision_box_capsule(const ShapeSW *p_a, const Transform &p_transf
 
 		Vector3 axis = p_transform_a.basis.get_axis(i).normalized();
 
-		if (!separator.test_axis(axis))
+		if (!separator.queue_axis(axis))
 			return;
 	}
 
@@ -1173,7 +1393,7 @@ static void _collision_box_capsule(const ShapeSW *p_a, const Transform &p_transf
 		if (Math::is_zero_approx(axis.length_squared()))
 			continue;
 
-		if (!separator.test_axis(axis.normalized()))
+		if (!separator.queue_axis(axis.normalized()))
 			return;
 	}
 
@@ -1194,7 +1414,7 @@ static void _collision_box_capsule(const ShapeSW *p_a, const Transform &p_transf
 				//Vector3 axis = (point - cyl_axis * cyl_axis.dot(point)).normalized();
 				Vector3 axis = Plane(cyl_axis, 0).project(point).normalized();
 
-				if (!separator.test_axis(axis))
+				if (!separator.queue_axis(axis))
 					return;
 			}
 		}
@@ -1219,7 +1439,7 @@ static void _collision_box_capsule(const ShapeSW *p_a, const Transform &p_transf
 		// use point to test axis
 		Vector3 point_axis = (sphere_pos - cpoint).normalized();
 
-		if (!separator.test_axis(point_axis))
+		if (!separator.queue_axis(point_axis))
 			return;
 
 		// test edges of A
@@ -1228,11 +1448,14 @@ static void _collision_box_capsule(const ShapeSW *p_a, const Transform &p_transf
 
 			Vector3 axis = point_axis.cross(p_transform_a.basis.get_axis(j)).cross(p_transform_a.basis.get_axis(j)).normalized();
 
-			if (!separator.test_axis(axis))
+			if (!separator.queue_axis(axis))
 				return;
 		}
 	}
 
+	if (!separator.test_pending_axes())
+		return;
+
 	separator.generate_contacts();
 }
 
@@ -1374,7 +1597,7 @@ static void _collision_box_convex_polygon(const ShapeSW *p_a, const Transform &p
 
 		Vector3 axis = p_transform_a.basis.get_axis(i).normalized();
 
-		if (!separator.test_axis(axis))
+		if (!separator.queue_axis(axis))
 			return;
 	}
 
@@ -1383,7 +1606,7 @@ static void _collision_box_convex_polygon(const ShapeSW *p_a, const Transform &p
 
 		Vector3 axis = p_transform_b.xform(faces[i].plane).normal;
 
-		if (!separator.test_axis(axis))
+		if (!separator.queue_axis(axis))
 			return;
 	}
 
@@ -1398,7 +1621,7 @@ static void _collision_box_convex_polygon(const ShapeSW *p_a, const Transform &p
 
 			Vector3 axis = e1.cross(e2).normalized();
 
-			if (!separator.test_axis(axis))
+			if (!separator.queue_axis(axis))
 				return;
 		}
 	}
@@ -1421,7 +1644,7 @@ static void _collision_box_convex_polygon(const ShapeSW *p_a, const Transform &p
 
 			Vector3 axis_ab = support_a - vtxb;
 
-			if (!separator.test_axis(axis_ab.normalized())) {
+			if (!separator.queue_axis(axis_ab.normalized())) {
 				return;
 			}
 
@@ -1432,7 +1655,7 @@ static void _collision_box_convex_polygon(const ShapeSW *p_a, const Transform &p
 				//a ->b
 				Vector3 axis_a = p_transform_a.basis.get_axis(i);
 
-				if (!separator.test_axis(axis_ab.cross(axis_a).cross(axis_a).normalized()))
+				if (!separator.queue_axis(axis_ab.cross(axis_a).cross(axis_a).normalized()))
 					return;
 			}
 		}
@@ -1455,7 +1678,7 @@ static void _collision_box_convex_polygon(const ShapeSW *p_a, const Transform &p
 						Vector3 p2 = p_transform_b.xform(vertices[edges[e].b]);
 						Vector3 n = (p2 - p1);
 
-						if (!separator.test_axis((point - p2).cross(n).cross(n).normalized()))
+						if (!separator.queue_axis((point - p2).cross(n).cross(n).normalized()))
 							return;
 					}
 				}
@@ -1463,6 +1686,9 @@ static void _collision_box_convex_polygon(const ShapeSW *p_a, const Transform &p
 		}
 	}
 
+	if (!separator.test_pending_axes())
+		return;
+
 	separator.generate_contacts();
 }
 
@@ -1593,33 +1819,36 @@ static void _collision_capsule_capsule(const ShapeSW *p_a, const Transform &p_tr
 
 	//balls-balls
 
-	if (!separator.test_axis((capsule_A_ball_1 - capsule_B_ball_1).normalized()))
+	if (!separator.queue_axis((capsule_A_ball_1 - capsule_B_ball_1).normalized()))
 		return;
-	if (!separator.test_axis((capsule_A_ball_1 - capsule_B_ball_2).normalized()))
+	if (!separator.queue_axis((capsule_A_ball_1 - capsule_B_ball_2).normalized()))
 		return;
 
-	if (!separator.test_axis((capsule_A_ball_2 - capsule_B_ball_1).normalized()))
+	if (!separator.queue_axis((capsule_A_ball_2 - capsule_B_ball_1).normalized()))
 		return;
-	if (!separator.test_axis((capsule_A_ball_2 - capsule_B_ball_2).normalized()))
+	if (!separator.queue_axis((capsule_A_ball_2 - capsule_B_ball_2).normalized()))
 		return;
 
 	// edges-balls
 
-	if (!separator.test_axis((capsule_A_ball_1 - capsule_B_ball_1).cross(capsule_A_axis).cross(capsule_A_axis).normalized()))
+	if (!separator.queue_axis((capsule_A_ball_1 - capsule_B_ball_1).cross(capsule_A_axis).cross(capsule_A_axis).normalized()))
 		return;
 
-	if (!separator.test_axis((capsule_A_ball_1 - capsule_B_ball_2).cross(capsule_A_axis).cross(capsule_A_axis).normalized()))
+	if (!separator.queue_axis((capsule_A_ball_1 - capsule_B_ball_2).cross(capsule_A_axis).cross(capsule_A_axis).normalized()))
 		return;
 
-	if (!separator.test_axis((capsule_B_ball_1 - capsule_A_ball_1).cross(capsule_B_axis).cross(capsule_B_axis).normalized()))
+	if (!separator.queue_axis((capsule_B_ball_1 - capsule_A_ball_1).cross(capsule_B_axis).cross(capsule_B_axis).normalized()))
 		return;
 
-	if (!separator.test_axis((capsule_B_ball_1 - capsule_A_ball_2).cross(capsule_B_axis).cross(capsule_B_axis).normalized()))
+	if (!separator.queue_axis((capsule_B_ball_1 - capsule_A_ball_2).cross(capsule_B_axis).cross(capsule_B_axis).normalized()))
 		return;
 
 	// edges
 
-	if (!separator.test_axis(capsule_A_axis.cross(capsule_B_axis).normalized()))
+	if (!separator.queue_axis(capsule_A_axis.cross(capsule_B_axis).normalized()))
+		return;
+
+	if (!separator.test_pending_axes())
 		return;
 
 	separator.generate_contacts();
@@ -1711,7 +1940,7 @@ static void _collision_capsule_convex_polygon(const ShapeSW *p_a, const Transfor
 
 		Vector3 axis = p_transform_b.xform(faces[i].plane).normal;
 
-		if (!separator.test_axis(axis))
+		if (!separator.queue_axis(axis))
 			return;
 	}
 
@@ -1723,7 +1952,7 @@ static void _collision_capsule_convex_polygon(const ShapeSW *p_a, const Transfor
 		Vector3 edge_axis = p_transform_b.basis.xform(vertices[edges[i].a]) - p_transform_b.basis.xform(vertices[edges[i].b]);
 		Vector3 axis = edge_axis.cross(p_transform_a.basis.get_axis(2)).normalized();
 
-		if (!separator.test_axis(axis))
+		if (!separator.queue_axis(axis))
 			return;
 	}
 
@@ -1744,11 +1973,14 @@ static void _collision_capsule_convex_polygon(const ShapeSW *p_a, const Transfor
 
 			Vector3 axis = n1.cross(n2).cross(n2).normalized();
 
-			if (!separator.test_axis(axis))
+			if (!separator.queue_axis(axis))
 				return;
 		}
 	}
 
+	if (!separator.test_pending_axes())
+		return;
+
 	separator.generate_contacts();
 }
 
@@ -2005,7 +2237,7 @@ static void _collision_convex_polygon_convex_polygon(const ShapeSW *p_a, const T
 		Vector3 axis = p_transform_a.xform(faces_A[i].plane).normal;
 		//Vector3 axis = p_transform_a.basis.xform( faces_A[i].plane.normal ).normalized();
 
-		if (!separator.test_axis(axis))
+		if (!separator.queue_axis(axis))
 			return;
 	}
 
@@ -2015,7 +2247,7 @@ static void _collision_convex_polygon_convex_polygon(const ShapeSW *p_a, const T
 		Vector3 axis = p_transform_b.xform(faces_B[i].plane).normal;
 		//Vector3 axis = p_transform_b.basis.xform( faces_B[i].plane.normal ).normalized();
 
-		if (!separator.test_axis(axis))
+		if (!separator.queue_axis(axis))
 			return;
 	}
 
@@ -2030,7 +2262,7 @@ static void _collision_convex_polygon_convex_polygon(const ShapeSW *p_a, const T
 
 			Vector3 axis = e1.cross(e2).normalized();
 
-			if (!separator.test_axis(axis))
+			if (!separator.queue_axis(axis))
 				return;
 		}
 	}
@@ -2044,7 +2276,7 @@ static void _collision_convex_polygon_convex_polygon(const ShapeSW *p_a, const T
 
 			for (int j = 0; j < vertex_count_B; j++) {
 
-				if (!separator.test_axis((va - p_transform_b.xform(vertices_B[j])).normalized()))
+				if (!separator.queue_axis((va - p_transform_b.xform(vertices_B[j])).normalized()))
 					return;
 			}
 		}
@@ -2060,7 +2292,7 @@ static void _collision_convex_polygon_convex_polygon(const ShapeSW *p_a, const T
 
 				Vector3 e3 = p_transform_b.xform(vertices_B[j]);
 
-				if (!separator.test_axis((e1 - e3).cross(n).cross(n).normalized()))
+				if (!separator.queue_axis((e1 - e3).cross(n).cross(n).normalized()))
 					return;
 			}
 		}
@@ -2075,12 +2307,15 @@ static void _collision_convex_polygon_convex_polygon(const ShapeSW *p_a, const T
 
 				Vector3 e3 = p_transform_a.xform(vertices_A[j]);
 
-				if (!separator.test_axis((e1 - e3).cross(n).cross(n).normalized()))
+				if (!separator.queue_axis((e1 - e3).cross(n).cross(n).normalized()))
 					return;
 			}
 		}
 	}
 
+	if (!separator.test_pending_axes())
+		return;
+
 	separator.generate_contacts();
 }
 
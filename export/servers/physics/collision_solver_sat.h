@@ -33,6 +33,11 @@
 
 #include "collision_solver_sw.h"
 
+// Queued separating axes are projected four at a time unless disabled here.
+// The scalar path gives the same results, it's kept to check and time against.
+void sat_set_packed_axis_tests(bool p_enabled);
+bool sat_is_packed_axis_tests_enabled();
+
 bool sat_calculate_penetration(const ShapeSW *p_shape_A, const Transform &p_transform_A, const ShapeSW *p_shape_B, const Transform &p_transform_B, CollisionSolverSW::CallbackResult p_result_callback, void *p_userdata, bool p_swap = false, Vector3 *r_prev_axis = NULL, real_t p_margin_a = 0, real_t p_margin_b = 0);
 
 #endif // COLLISION_SOLVER_SAT_H
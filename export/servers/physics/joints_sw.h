@@ -38,6 +38,17 @@ class JointSW : public ConstraintSW {
 
 public:
 	virtual PhysicsServer::JointType get_type() const = 0;
+
+	// impulses are applied to both bodies, even static or kinematic ones shared with other islands
+	virtual bool writes_outside_island() const {
+		for (int i = 0; i < get_body_count(); i++) {
+			if (get_body_ptr()[i]->get_mode() <= PhysicsServer::BODY_MODE_KINEMATIC) {
+				return true;
+			}
+		}
+		return false;
+	}
+
 	_FORCE_INLINE_ JointSW(BodySW **p_body_ptr = NULL, int p_body_count = 0) :
 			ConstraintSW(p_body_ptr, p_body_count) {
 	}
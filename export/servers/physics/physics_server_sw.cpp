@@ -45,6 +45,9 @@
 #define FLUSH_QUERY_CHECK(m_object) \
 	ERR_FAIL_COND_MSG(m_object->get_space() && flushing_queries, "Can't change this state while flushing queries. Use call_deferred() or set_deferred() to change monitoring state instead.");
 
+// about 5 seconds at 60 steps per second, longer than the monitors take between two readings
+#define NARROWPHASE_TIMING_STEPS 300
+
 RID PhysicsServerSW::shape_create(ShapeType p_shape) {
 
 	ShapeSW *shape = NULL;
@@ -198,7 +201,7 @@ PhysicsDirectSpaceState *PhysicsServerSW::space_get_direct_state(RID p_space) {
 
 	SpaceSW *space = space_owner.get(p_space);
 	ERR_FAIL_COND_V(!space, NULL);
-	ERR_FAIL_COND_V_MSG(space->is_locked(), NULL, "Space state is inaccessible right now, wait for iteration or physics process notification.");
+	ERR_FAIL_COND_V_MSG((using_threads && !doing_sync) || space->is_locked(), NULL, "Space state is inaccessible right now, wait for iteration or physics process notification.");
 
 	return space->get_direct_state();
 }
@@ -224,6 +227,20 @@ int PhysicsServerSW::space_get_contact_count(RID p_space) const {
 	return space->get_debug_contact_count();
 }
 
+PoolVector<uint8_t> PhysicsServerSW::space_get_snapshot(RID p_space) const {
+
+	SpaceSW *space = space_owner.get(p_space);
+	ERR_FAIL_COND_V(!space, PoolVector<uint8_t>());
+	return space->get_snapshot();
+}
+
+Error PhysicsServerSW::space_restore_snapshot(RID p_space, const PoolVector<uint8_t> &p_snapshot) {
+
+	SpaceSW *space = space_owner.get(p_space);
+	ERR_FAIL_COND_V(!space, ERR_INVALID_PARAMETER);
+	return space->restore_snapshot(p_snapshot);
+}
+
 RID PhysicsServerSW::area_create() {
 
 	AreaSW *area = memnew(AreaSW);
@@ -475,6 +492,14 @@ void PhysicsServerSW::area_set_area_monitor_callback(RID p_area, Object *p_recei
 	area->set_area_monitor_callback(p_receiver ? p_receiver->get_instance_id() : 0, p_method);
 }
 
+void PhysicsServerSW::area_set_monitor_batching(RID p_area, bool p_enable) {
+
+	AreaSW *area = area_owner.get(p_area);
+	ERR_FAIL_COND(!area);
+
+	area->set_monitor_batching(p_enable);
+}
+
 /* BODY API */
 
 RID PhysicsServerSW::body_create(BodyMode p_mode, bool p_init_sleeping) {
@@ -669,6 +694,13 @@ uint32_t PhysicsServerSW::body_get_collision_mask(RID p_body) const {
 
 void PhysicsServerSW::body_attach_object_instance_id(RID p_body, uint32_t p_id) {
 
+	// the SoftBody node uses this for its soft body too
+	SoftBodySW *soft_body = soft_body_owner.getornull(p_body);
+	if (soft_body) {
+		soft_body->set_instance_id(p_id);
+		return;
+	}
+
 	BodySW *body = body_owner.get(p_body);
 	ERR_FAIL_COND(!body);
 
@@ -677,6 +709,11 @@ void PhysicsServerSW::body_attach_object_instance_id(RID p_body, uint32_t p_id)
 
 uint32_t PhysicsServerSW::body_get_object_instance_id(RID p_body) const {
 
+	SoftBodySW *soft_body = soft_body_owner.getornull(p_body);
+	if (soft_body) {
+		return soft_body->get_instance_id();
+	}
+
 	BodySW *body = body_owner.get(p_body);
 	ERR_FAIL_COND_V(!body, 0);
 
@@ -939,6 +976,13 @@ void PhysicsServerSW::body_set_force_integration_callback(RID p_body, Object *p_
 	body->set_force_integration_callback(p_receiver ? p_receiver->get_instance_id() : ObjectID(0), p_method, p_udata);
 }
 
+void PhysicsServerSW::body_set_state_sync_callback(RID p_body, Object *p_receiver, BodyStateSyncCallback p_callback) {
+
+	BodySW *body = body_owner.get(p_body);
+	ERR_FAIL_COND(!body);
+	body->set_state_sync_callback(p_receiver ? p_receiver->get_instance_id() : ObjectID(0), p_callback);
+}
+
 void PhysicsServerSW::body_set_ray_pickable(RID p_body, bool p_enable) {
 
 	BodySW *body = body_owner.get(p_body);
@@ -977,16 +1021,406 @@ int PhysicsServerSW::body_test_ray_separation(RID p_body, const Transform &p_tra
 	return body->get_space()->test_body_ray_separation(body, p_transform, p_infinite_inertia, r_recover_motion, r_results, p_result_max, p_margin);
 }
 
+void PhysicsServerSW::body_begin_motion_batch(RID p_body, const Transform &p_from, real_t p_max_distance) {
+
+	BodySW *body = body_owner.get(p_body);
+	ERR_FAIL_COND(!body);
+	ERR_FAIL_COND(!body->get_space());
+	ERR_FAIL_COND(body->get_space()->is_locked());
+
+	_update_shapes();
+
+	body->get_space()->begin_motion_batch(body, p_from, p_max_distance, body->get_kinematic_margin());
+}
+
+void PhysicsServerSW::body_end_motion_batch(RID p_body) {
+
+	BodySW *body = body_owner.get(p_body);
+	ERR_FAIL_COND(!body);
+
+	if (body->get_space()) {
+		body->get_space()->end_motion_batch(body);
+	}
+}
+
 PhysicsDirectBodyState *PhysicsServerSW::body_get_direct_state(RID p_body) {
 
 	BodySW *body = body_owner.get(p_body);
 	ERR_FAIL_COND_V(!body, NULL);
-	ERR_FAIL_COND_V_MSG(body->get_space()->is_locked(), NULL, "Body state is inaccessible right now, wait for iteration or physics process notification.");
+	ERR_FAIL_COND_V_MSG((using_threads && !doing_sync) || body->get_space()->is_locked(), NULL, "Body state is inaccessible right now, wait for iteration or physics process notification.");
 
 	direct_state->body = body;
 	return direct_state;
 }
 
+/* SOFT BODY */
+
+RID PhysicsServerSW::soft_body_create(bool p_init_sleeping) {
+
+	SoftBodySW *body = memnew(SoftBodySW);
+	if (p_init_sleeping)
+		body->set_active(false);
+	RID rid = soft_body_owner.make_rid(body);
+	body->set_self(rid);
+	return rid;
+}
+
+void PhysicsServerSW::soft_body_update_visual_server(RID p_body, SoftBodyVisualServerHandler *p_visual_server_handler) {
+
+	SoftBodySW *body = soft_body_owner.get(p_body);
+	ERR_FAIL_COND(!body);
+
+	body->update_visual_server(p_visual_server_handler);
+}
+
+void PhysicsServerSW::soft_body_set_space(RID p_body, RID p_space) {
+
+	SoftBodySW *body = soft_body_owner.get(p_body);
+	ERR_FAIL_COND(!body);
+
+	SpaceSW *space = NULL;
+	if (p_space.is_valid()) {
+		space = space_owner.get(p_space);
+		ERR_FAIL_COND(!space);
+	}
+
+	if (body->get_space() == space)
+		return; //pointless
+
+	body->set_space(space);
+}
+
+RID PhysicsServerSW::soft_body_get_space(RID p_body) const {
+
+	SoftBodySW *body = soft_body_owner.get(p_body);
+	ERR_FAIL_COND_V(!body, RID());
+
+	SpaceSW *space = body->get_space();
+	if (!space)
+		return RID();
+	return space->get_self();
+}
+
+void PhysicsServerSW::soft_body_set_collision_layer(RID p_body, uint32_t p_layer) {
+
+	SoftBodySW *body = soft_body_owner.get(p_body);
+	ERR_FAIL_COND(!body);
+
+	body->set_collision_layer(p_layer);
+}
+
+uint32_t PhysicsServerSW::soft_body_get_collision_layer(RID p_body) const {
+
+	SoftBodySW *body = soft_body_owner.get(p_body);
+	ERR_FAIL_COND_V(!body, 0);
+
+	return body->get_collision_layer();
+}
+
+void PhysicsServerSW::soft_body_set_collision_mask(RID p_body, uint32_t p_mask) {
+
+	SoftBodySW *body = soft_body_owner.get(p_body);
+	ERR_FAIL_COND(!body);
+
+	body->set_collision_mask(p_mask);
+}
+
+uint32_t PhysicsServerSW::soft_body_get_collision_mask(RID p_body) const {
+
+	SoftBodySW *body = soft_body_owner.get(p_body);
+	ERR_FAIL_COND_V(!body, 0);
+
+	return body->get_collision_mask();
+}
+
+void PhysicsServerSW::soft_body_add_collision_exception(RID p_body, RID p_body_b) {
+
+	SoftBodySW *body = soft_body_owner.get(p_body);
+	ERR_FAIL_COND(!body);
+
+	body->add_exception(p_body_b);
+}
+
+void PhysicsServerSW::soft_body_remove_collision_exception(RID p_body, RID p_body_b) {
+
+	SoftBodySW *body = soft_body_owner.get(p_body);
+	ERR_FAIL_COND(!body);
+
+	body->remove_exception(p_body_b);
+}
+
+void PhysicsServerSW::soft_body_get_collision_exceptions(RID p_body, List<RID> *p_exceptions) {
+
+	SoftBodySW *body = soft_body_owner.get(p_body);
+	ERR_FAIL_COND(!body);
+
+	for (int i = 0; i < body->get_exceptions().size(); i++) {
+		p_exceptions->push_back(body->get_exceptions()[i]);
+	}
+}
+
+void PhysicsServerSW::soft_body_set_state(RID p_body, BodyState p_state, const Variant &p_variant) {
+
+	SoftBodySW *body = soft_body_owner.get(p_body);
+	ERR_FAIL_COND(!body);
+
+	switch (p_state) {
+		case BODY_STATE_TRANSFORM: body->set_transform(p_variant); break;
+		case BODY_STATE_LINEAR_VELOCITY: body->set_linear_velocity(p_variant); break;
+		case BODY_STATE_SLEEPING: body->set_active(!p_variant); break;
+		default: {
+		} // the rest have no meaning for a soft body
+	}
+}
+
+Variant PhysicsServerSW::soft_body_get_state(RID p_body, BodyState p_state) const {
+
+	SoftBodySW *body = soft_body_owner.get(p_body);
+	ERR_FAIL_COND_V(!body, Variant());
+
+	switch (p_state) {
+		case BODY_STATE_TRANSFORM: return Transform(Basis(), body->get_aabb().position + body->get_aabb().size * 0.5);
+		case BODY_STATE_LINEAR_VELOCITY: return body->get_linear_velocity();
+		case BODY_STATE_SLEEPING: return !body->is_active();
+		default: {
+		}
+	}
+
+	return Variant();
+}
+
+void PhysicsServerSW::soft_body_set_transform(RID p_body, const Transform &p_transform) {
+
+	SoftBodySW *body = soft_body_owner.get(p_body);
+	ERR_FAIL_COND(!body);
+
+	body->set_transform(p_transform);
+}
+
+Vector3 PhysicsServerSW::soft_body_get_vertex_position(RID p_body, int vertex_index) const {
+
+	SoftBodySW *body = soft_body_owner.get(p_body);
+	ERR_FAIL_COND_V(!body, Vector3());
+
+	return body->get_point_position(vertex_index);
+}
+
+void PhysicsServerSW::soft_body_set_ray_pickable(RID p_body, bool p_enable) {
+
+	SoftBodySW *body = soft_body_owner.get(p_body);
+	ERR_FAIL_COND(!body);
+
+	body->set_ray_pickable(p_enable);
+}
+
+bool PhysicsServerSW::soft_body_is_ray_pickable(RID p_body) const {
+
+	SoftBodySW *body = soft_body_owner.get(p_body);
+	ERR_FAIL_COND_V(!body, false);
+
+	return body->is_ray_pickable();
+}
+
+void PhysicsServerSW::soft_body_set_simulation_precision(RID p_body, int p_simulation_precision) {
+
+	SoftBodySW *body = soft_body_owner.get(p_body);
+	ERR_FAIL_COND(!body);
+
+	body->set_simulation_precision(p_simulation_precision);
+}
+
+int PhysicsServerSW::soft_body_get_simulation_precision(RID p_body) {
+
+	SoftBodySW *body = soft_body_owner.get(p_body);
+	ERR_FAIL_COND_V(!body, 0);
+
+	return body->get_simulation_precision();
+}
+
+void PhysicsServerSW::soft_body_set_total_mass(RID p_body, real_t p_total_mass) {
+
+	SoftBodySW *body = soft_body_owner.get(p_body);
+	ERR_FAIL_COND(!body);
+
+	body->set_total_mass(p_total_mass);
+}
+
+real_t PhysicsServerSW::soft_body_get_total_mass(RID p_body) {
+
+	SoftBodySW *body = soft_body_owner.get(p_body);
+	ERR_FAIL_COND_V(!body, 0);
+
+	return body->get_total_mass();
+}
+
+void PhysicsServerSW::soft_body_set_linear_stiffness(RID p_body, real_t p_stiffness) {
+
+	SoftBodySW *body = soft_body_owner.get(p_body);
+	ERR_FAIL_COND(!body);
+
+	body->set_linear_stiffness(p_stiffness);
+}
+
+real_t PhysicsServerSW::soft_body_get_linear_stiffness(RID p_body) {
+
+	SoftBodySW *body = soft_body_owner.get(p_body);
+	ERR_FAIL_COND_V(!body, 0);
+
+	return body->get_linear_stiffness();
+}
+
+void PhysicsServerSW::soft_body_set_areaAngular_stiffness(RID p_body, real_t p_stiffness) {
+
+	SoftBodySW *body = soft_body_owner.get(p_body);
+	ERR_FAIL_COND(!body);
+
+	body->set_areaAngular_stiffness(p_stiffness);
+}
+
+real_t PhysicsServerSW::soft_body_get_areaAngular_stiffness(RID p_body) {
+
+	SoftBodySW *body = soft_body_owner.get(p_body);
+	ERR_FAIL_COND_V(!body, 0);
+
+	return body->get_areaAngular_stiffness();
+}
+
+void PhysicsServerSW::soft_body_set_volume_stiffness(RID p_body, real_t p_stiffness) {
+
+	SoftBodySW *body = soft_body_owner.get(p_body);
+	ERR_FAIL_COND(!body);
+
+	body->set_volume_stiffness(p_stiffness);
+}
+
+real_t PhysicsServerSW::soft_body_get_volume_stiffness(RID p_body) {
+
+	SoftBodySW *body = soft_body_owner.get(p_body);
+	ERR_FAIL_COND_V(!body, 0);
+
+	return body->get_volume_stiffness();
+}
+
+void PhysicsServerSW::soft_body_set_pressure_coefficient(RID p_body, real_t p_pressure_coefficient) {
+
+	SoftBodySW *body = soft_body_owner.get(p_body);
+	ERR_FAIL_COND(!body);
+
+	body->set_pressure_coefficient(p_pressure_coefficient);
+}
+
+real_t PhysicsServerSW::soft_body_get_pressure_coefficient(RID p_body) {
+
+	SoftBodySW *body = soft_body_owner.get(p_body);
+	ERR_FAIL_COND_V(!body, 0);
+
+	return body->get_pressure_coefficient();
+}
+
+void PhysicsServerSW::soft_body_set_pose_matching_coefficient(RID p_body, real_t p_pose_matching_coefficient) {
+
+	SoftBodySW *body = soft_body_owner.get(p_body);
+	ERR_FAIL_COND(!body);
+
+	body->set_pose_matching_coefficient(p_pose_matching_coefficient);
+}
+
+real_t PhysicsServerSW::soft_body_get_pose_matching_coefficient(RID p_body) {
+
+	SoftBodySW *body = soft_body_owner.get(p_body);
+	ERR_FAIL_COND_V(!body, 0);
+
+	return body->get_pose_matching_coefficient();
+}
+
+void PhysicsServerSW::soft_body_set_damping_coefficient(RID p_body, real_t p_damping_coefficient) {
+
+	SoftBodySW *body = soft_body_owner.get(p_body);
+	ERR_FAIL_COND(!body);
+
+	body->set_damping_coefficient(p_damping_coefficient);
+}
+
+real_t PhysicsServerSW::soft_body_get_damping_coefficient(RID p_body) {
+
+	SoftBodySW *body = soft_body_owner.get(p_body);
+	ERR_FAIL_COND_V(!body, 0);
+
+	return body->get_damping_coefficient();
+}
+
+void PhysicsServerSW::soft_body_set_drag_coefficient(RID p_body, real_t p_drag_coefficient) {
+
+	SoftBodySW *body = soft_body_owner.get(p_body);
+	ERR_FAIL_COND(!body);
+
+	body->set_drag_coefficient(p_drag_coefficient);
+}
+
+real_t PhysicsServerSW::soft_body_get_drag_coefficient(RID p_body) {
+
+	SoftBodySW *body = soft_body_owner.get(p_body);
+	ERR_FAIL_COND_V(!body, 0);
+
+	return body->get_drag_coefficient();
+}
+
+void PhysicsServerSW::soft_body_set_mesh(RID p_body, const REF &p_mesh) {
+
+	SoftBodySW *body = soft_body_owner.get(p_body);
+	ERR_FAIL_COND(!body);
+
+	body->set_mesh(p_mesh);
+}
+
+void PhysicsServerSW::soft_body_move_point(RID p_body, int p_point_index, const Vector3 &p_global_position) {
+
+	SoftBodySW *body = soft_body_owner.get(p_body);
+	ERR_FAIL_COND(!body);
+
+	body->set_point_position(p_point_index, p_global_position);
+}
+
+Vector3 PhysicsServerSW::soft_body_get_point_global_position(RID p_body, int p_point_index) {
+
+	SoftBodySW *body = soft_body_owner.get(p_body);
+	ERR_FAIL_COND_V(!body, Vector3());
+
+	return body->get_point_position(p_point_index);
+}
+
+Vector3 PhysicsServerSW::soft_body_get_point_offset(RID p_body, int p_point_index) const {
+
+	SoftBodySW *body = soft_body_owner.get(p_body);
+	ERR_FAIL_COND_V(!body, Vector3());
+
+	return body->get_point_offset(p_point_index);
+}
+
+void PhysicsServerSW::soft_body_remove_all_pinned_points(RID p_body) {
+
+	SoftBodySW *body = soft_body_owner.get(p_body);
+	ERR_FAIL_COND(!body);
+
+	body->remove_all_pinned_points();
+}
+
+void PhysicsServerSW::soft_body_pin_point(RID p_body, int p_point_index, bool p_pin) {
+
+	SoftBodySW *body = soft_body_owner.get(p_body);
+	ERR_FAIL_COND(!body);
+
+	body->pin_point(p_point_index, p_pin);
+}
+
+bool PhysicsServerSW::soft_body_is_point_pinned(RID p_body, int p_point_index) {
+
+	SoftBodySW *body = soft_body_owner.get(p_body);
+	ERR_FAIL_COND_V(!body, false);
+
+	return body->is_point_pinned(p_point_index);
+}
+
 /* JOINT API */
 
 RID PhysicsServerSW::joint_create_pin(RID p_body_A, const Vector3 &p_local_A, RID p_body_B, const Vector3 &p_local_B) {
@@ -1353,6 +1787,15 @@ void PhysicsServerSW::free(RID p_rid) {
 		body_owner.free(p_rid);
 		memdelete(body);
 
+	} else if (soft_body_owner.owns(p_rid)) {
+
+		SoftBodySW *soft_body = soft_body_owner.get(p_rid);
+
+		soft_body->set_space(NULL);
+
+		soft_body_owner.free(p_rid);
+		memdelete(soft_body);
+
 	} else if (area_owner.owns(p_rid)) {
 
 		AreaSW *area = area_owner.get(p_rid);
@@ -1380,6 +1823,10 @@ void PhysicsServerSW::free(RID p_rid) {
 			co->set_space(NULL);
 		}
 
+		while (space->get_soft_body_list().first()) {
+			space->get_soft_body_list().first()->self()->set_space(NULL);
+		}
+
 		active_spaces.erase(space);
 		free(space->get_default_area()->get_self());
 		free(space->get_static_global_body());
@@ -1411,7 +1858,8 @@ void PhysicsServerSW::set_active(bool p_active) {
 void PhysicsServerSW::init() {
 
 	last_step = 0.001;
-	iterations = 8; // 8?
+	iterations = GLOBAL_DEF("physics/3d/godot_physics/solver_iterations", 8);
+	ProjectSettings::get_singleton()->set_custom_property_info("physics/3d/godot_physics/solver_iterations", PropertyInfo(Variant::INT, "physics/3d/godot_physics/solver_iterations", PROPERTY_HINT_RANGE, "1,32,1,or_greater"));
 	stepper = memnew(StepSW);
 	direct_state = memnew(PhysicsDirectBodyStateSW);
 };
@@ -1431,16 +1879,34 @@ void PhysicsServerSW::step(real_t p_step) {
 	island_count = 0;
 	active_objects = 0;
 	collision_pairs = 0;
+	for (int i = 0; i < SpaceSW::ELAPSED_TIME_MAX; i++) {
+		phase_time[i] = 0;
+	}
+
+	bool time_narrowphase = narrowphase_timing || narrowphase_timing_steps > 0 || (ScriptDebugger::get_singleton() && ScriptDebugger::get_singleton()->is_profiling());
+	if (narrowphase_timing_steps > 0) {
+		narrowphase_timing_steps--;
+	}
+
 	for (Set<const SpaceSW *>::Element *E = active_spaces.front(); E; E = E->next()) {
 
+		((SpaceSW *)E->get())->set_narrowphase_timed(time_narrowphase);
 		stepper->step((SpaceSW *)E->get(), p_step, iterations);
 		island_count += E->get()->get_island_count();
 		active_objects += E->get()->get_active_objects();
 		collision_pairs += E->get()->get_collision_pairs();
+		for (int i = 0; i < SpaceSW::ELAPSED_TIME_MAX; i++) {
+			phase_time[i] += E->get()->get_elapsed_time(SpaceSW::ElapsedTime(i));
+		}
 	}
 #endif
 }
 
+void PhysicsServerSW::sync() {
+
+	doing_sync = true;
+};
+
 void PhysicsServerSW::flush_queries() {
 
 #ifndef _3D_DISABLED
@@ -1459,6 +1925,7 @@ void PhysicsServerSW::flush_queries() {
 	}
 
 	flushing_queries = false;
+	query_callbacks_time = OS::get_singleton()->get_ticks_usec() - time_beg;
 
 	if (ScriptDebugger::get_singleton() && ScriptDebugger::get_singleton()->is_profiling()) {
 
@@ -1468,7 +1935,10 @@ void PhysicsServerSW::flush_queries() {
 			"generate_islands",
 			"setup_constraints",
 			"solve_constraints",
-			"integrate_velocities"
+			"integrate_velocities",
+			"broadphase",
+			"pair_generation",
+			"narrowphase"
 		};
 
 		for (int i = 0; i < SpaceSW::ELAPSED_TIME_MAX; i++) {
@@ -1496,12 +1966,64 @@ void PhysicsServerSW::flush_queries() {
 #endif
 };
 
+void PhysicsServerSW::end_sync() {
+
+	doing_sync = false;
+};
+
 void PhysicsServerSW::finish() {
 
 	memdelete(stepper);
 	memdelete(direct_state);
+	query_work_pool.finish();
 };
 
+uint64_t PhysicsServerSW::space_get_elapsed_time(RID p_space, SpaceSW::ElapsedTime p_time) const {
+
+	const SpaceSW *space = space_owner.get(p_space);
+	ERR_FAIL_COND_V(!space, 0);
+	ERR_FAIL_INDEX_V(p_time, SpaceSW::ELAPSED_TIME_MAX, 0);
+	if (p_time == SpaceSW::ELAPSED_TIME_NARROWPHASE) {
+		narrowphase_timing_steps = NARROWPHASE_TIMING_STEPS;
+	}
+	return space->get_elapsed_time(p_time);
+}
+
+void PhysicsServerSW::set_narrowphase_timing_enabled(bool p_enabled) {
+
+	narrowphase_timing = p_enabled;
+}
+
+void PhysicsServerSW::set_solver_thread_count(int p_count) {
+
+	ERR_FAIL_COND(!stepper);
+	stepper->set_thread_count(p_count);
+}
+
+int PhysicsServerSW::get_solver_thread_count() const {
+
+	ERR_FAIL_COND_V(!stepper, 1);
+	return stepper->get_thread_count();
+}
+
+ThreadWorkPool *PhysicsServerSW::lock_query_work_pool() {
+
+	if (query_work_pool_mutex.try_lock() != OK) {
+		return NULL;
+	}
+
+	if (!query_work_pool.is_initialized()) {
+		query_work_pool.init();
+	}
+
+	return &query_work_pool;
+}
+
+void PhysicsServerSW::unlock_query_work_pool() {
+
+	query_work_pool_mutex.unlock();
+}
+
 int PhysicsServerSW::get_process_info(ProcessInfo p_info) {
 
 	switch (p_info) {
@@ -1517,6 +2039,31 @@ int PhysicsServerSW::get_process_info(ProcessInfo p_info) {
 
 			return island_count;
 		} break;
+		case INFO_BROADPHASE_TIME: {
+			return phase_time[SpaceSW::ELAPSED_TIME_BROADPHASE];
+		} break;
+		case INFO_PAIR_GENERATION_TIME: {
+			return phase_time[SpaceSW::ELAPSED_TIME_PAIR_GENERATION];
+		} break;
+		case INFO_NARROWPHASE_TIME: {
+			narrowphase_timing_steps = NARROWPHASE_TIMING_STEPS;
+			return phase_time[SpaceSW::ELAPSED_TIME_NARROWPHASE];
+		} break;
+		case INFO_GENERATE_ISLANDS_TIME: {
+			return phase_time[SpaceSW::ELAPSED_TIME_GENERATE_ISLANDS];
+		} break;
+		case INFO_SETUP_CONSTRAINTS_TIME: {
+			return phase_time[SpaceSW::ELAPSED_TIME_SETUP_CONSTRAINTS];
+		} break;
+		case INFO_SOLVE_CONSTRAINTS_TIME: {
+			return phase_time[SpaceSW::ELAPSED_TIME_SOLVE_CONSTRAINTS];
+		} break;
+		case INFO_INTEGRATE_TIME: {
+			return phase_time[SpaceSW::ELAPSED_TIME_INTEGRATE_FORCES] + phase_time[SpaceSW::ELAPSED_TIME_INTEGRATE_VELOCITIES];
+		} break;
+		case INFO_QUERY_CALLBACKS_TIME: {
+			return query_callbacks_time;
+		} break;
 	}
 
 	return 0;
@@ -1579,8 +2126,21 @@ PhysicsServerSW::PhysicsServerSW() {
 	island_count = 0;
 	active_objects = 0;
 	collision_pairs = 0;
+	query_callbacks_time = 0;
+	narrowphase_timing = false;
+	narrowphase_timing_steps = 0;
+	for (int i = 0; i < SpaceSW::ELAPSED_TIME_MAX; i++) {
+		phase_time[i] = 0;
+	}
+	stepper = NULL;
 
 	active = true;
+	doing_sync = false;
+#ifdef NO_THREADS
+	using_threads = false;
+#else
+	using_threads = int(ProjectSettings::get_singleton()->get("physics/3d/thread_model")) == 2;
+#endif
 	flushing_queries = false;
 };
 
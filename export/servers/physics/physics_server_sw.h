@@ -31,6 +31,8 @@
 #ifndef PHYSICS_SERVER_SW
 #define PHYSICS_SERVER_SW
 
+#include "core/os/mutex.h"
+#include "core/os/thread_work_pool.h"
 #include "joints_sw.h"
 #include "servers/physics_server.h"
 #include "shape_sw.h"
@@ -49,18 +51,28 @@ class PhysicsServerSW : public PhysicsServer {
 	int island_count;
 	int active_objects;
 	int collision_pairs;
+	uint64_t phase_time[SpaceSW::ELAPSED_TIME_MAX]; // summed over the active spaces
+	uint64_t query_callbacks_time;
+	bool narrowphase_timing;
+	mutable int narrowphase_timing_steps; // left before the narrow phase stops being timed, renewed when its time is read
 
+	bool doing_sync;
+	bool using_threads;
 	bool flushing_queries;
 
 	StepSW *stepper;
 	Set<const SpaceSW *> active_spaces;
 
+	ThreadWorkPool query_work_pool;
+	Mutex query_work_pool_mutex;
+
 	PhysicsDirectBodyStateSW *direct_state;
 
 	mutable RID_Owner<ShapeSW> shape_owner;
 	mutable RID_Owner<SpaceSW> space_owner;
 	mutable RID_Owner<AreaSW> area_owner;
 	mutable RID_Owner<BodySW> body_owner;
+	mutable RID_Owner<SoftBodySW> soft_body_owner;
 	mutable RID_Owner<JointSW> joint_owner;
 
 	//void _clear_query(QuerySW *p_query);
@@ -108,6 +120,9 @@ public:
 	virtual Vector<Vector3> space_get_contacts(RID p_space) const;
 	virtual int space_get_contact_count(RID p_space) const;
 
+	virtual PoolVector<uint8_t> space_get_snapshot(RID p_space) const;
+	virtual Error space_restore_snapshot(RID p_space, const PoolVector<uint8_t> &p_snapshot);
+
 	/* AREA API */
 
 	virtual RID area_create();
@@ -150,6 +165,7 @@ public:
 
 	virtual void area_set_monitor_callback(RID p_area, Object *p_receiver, const StringName &p_method);
 	virtual void area_set_area_monitor_callback(RID p_area, Object *p_receiver, const StringName &p_method);
+	virtual void area_set_monitor_batching(RID p_area, bool p_enable);
 
 	/* BODY API */
 
@@ -231,11 +247,14 @@ public:
 	virtual int body_get_max_contacts_reported(RID p_body) const;
 
 	virtual void body_set_force_integration_callback(RID p_body, Object *p_receiver, const StringName &p_method, const Variant &p_udata = Variant());
+	virtual void body_set_state_sync_callback(RID p_body, Object *p_receiver, BodyStateSyncCallback p_callback);
 
 	virtual void body_set_ray_pickable(RID p_body, bool p_enable);
 	virtual bool body_is_ray_pickable(RID p_body) const;
 
 	virtual bool body_test_motion(RID p_body, const Transform &p_from, const Vector3 &p_motion, bool p_infinite_inertia, MotionResult *r_result = NULL, bool p_exclude_raycast_shapes = true);
+	virtual void body_begin_motion_batch(RID p_body, const Transform &p_from, real_t p_max_distance);
+	virtual void body_end_motion_batch(RID p_body);
 	virtual int body_test_ray_separation(RID p_body, const Transform &p_transform, bool p_infinite_inertia, Vector3 &r_recover_motion, SeparationResult *r_results, int p_result_max, float p_margin = 0.001);
 
 	// this function only works on physics process, errors and returns null otherwise
@@ -243,69 +262,69 @@ public:
 
 	/* SOFT BODY */
 
-	virtual RID soft_body_create(bool p_init_sleeping = false) { return RID(); }
+	virtual RID soft_body_create(bool p_init_sleeping = false);
 
-	virtual void soft_body_update_visual_server(RID p_body, class SoftBodyVisualServerHandler *p_visual_server_handler) {}
+	virtual void soft_body_update_visual_server(RID p_body, class SoftBodyVisualServerHandler *p_visual_server_handler);
 
-	virtual void soft_body_set_space(RID p_body, RID p_space) {}
-	virtual RID soft_body_get_space(RID p_body) const { return RID(); }
+	virtual void soft_body_set_space(RID p_body, RID p_space);
+	virtual RID soft_body_get_space(RID p_body) const;
 
-	virtual void soft_body_set_collision_layer(RID p_body, uint32_t p_layer) {}
-	virtual uint32_t soft_body_get_collision_layer(RID p_body) const { return 0; }
+	virtual void soft_body_set_collision_layer(RID p_body, uint32_t p_layer);
+	virtual uint32_t soft_body_get_collision_layer(RID p_body) const;
 
-	virtual void soft_body_set_collision_mask(RID p_body, uint32_t p_mask) {}
-	virtual uint32_t soft_body_get_collision_mask(RID p_body) const { return 0; }
+	virtual void soft_body_set_collision_mask(RID p_body, uint32_t p_mask);
+	virtual uint32_t soft_body_get_collision_mask(RID p_body) const;
 
-	virtual void soft_body_add_collision_exception(RID p_body, RID p_body_b) {}
-	virtual void soft_body_remove_collision_exception(RID p_body, RID p_body_b) {}
-	virtual void soft_body_get_collision_exceptions(RID p_body, List<RID> *p_exceptions) {}
+	virtual void soft_body_add_collision_exception(RID p_body, RID p_body_b);
+	virtual void soft_body_remove_collision_exception(RID p_body, RID p_body_b);
+	virtual void soft_body_get_collision_exceptions(RID p_body, List<RID> *p_exceptions);
 
-	virtual void soft_body_set_state(RID p_body, BodyState p_state, const Variant &p_variant) {}
-	virtual Variant soft_body_get_state(RID p_body, BodyState p_state) const { return Variant(); }
+	virtual void soft_body_set_state(RID p_body, BodyState p_state, const Variant &p_variant);
+	virtual Variant soft_body_get_state(RID p_body, BodyState p_state) const;
 
-	virtual void soft_body_set_transform(RID p_body, const Transform &p_transform) {}
-	virtual Vector3 soft_body_get_vertex_position(RID p_body, int vertex_index) const { return Vector3(); }
+	virtual void soft_body_set_transform(RID p_body, const Transform &p_transform);
+	virtual Vector3 soft_body_get_vertex_position(RID p_body, int vertex_index) const;
 
-	virtual void soft_body_set_ray_pickable(RID p_body, bool p_enable) {}
-	virtual bool soft_body_is_ray_pickable(RID p_body) const { return false; }
+	virtual void soft_body_set_ray_pickable(RID p_body, bool p_enable);
+	virtual bool soft_body_is_ray_pickable(RID p_body) const;
 
-	virtual void soft_body_set_simulation_precision(RID p_body, int p_simulation_precision) {}
-	virtual int soft_body_get_simulation_precision(RID p_body) { return 0; }
+	virtual void soft_body_set_simulation_precision(RID p_body, int p_simulation_precision);
+	virtual int soft_body_get_simulation_precision(RID p_body);
 
-	virtual void soft_body_set_total_mass(RID p_body, real_t p_total_mass) {}
-	virtual real_t soft_body_get_total_mass(RID p_body) { return 0.; }
+	virtual void soft_body_set_total_mass(RID p_body, real_t p_total_mass);
+	virtual real_t soft_body_get_total_mass(RID p_body);
 
-	virtual void soft_body_set_linear_stiffness(RID p_body, real_t p_stiffness) {}
-	virtual real_t soft_body_get_linear_stiffness(RID p_body) { return 0.; }
+	virtual void soft_body_set_linear_stiffness(RID p_body, real_t p_stiffness);
+	virtual real_t soft_body_get_linear_stiffness(RID p_body);
 
-	virtual void soft_body_set_areaAngular_stiffness(RID p_body, real_t p_stiffness) {}
-	virtual real_t soft_body_get_areaAngular_stiffness(RID p_body) { return 0.; }
+	virtual void soft_body_set_areaAngular_stiffness(RID p_body, real_t p_stiffness);
+	virtual real_t soft_body_get_areaAngular_stiffness(RID p_body);
 
-	virtual void soft_body_set_volume_stiffness(RID p_body, real_t p_stiffness) {}
-	virtual real_t soft_body_get_volume_stiffness(RID p_body) { return 0.; }
+	virtual void soft_body_set_volume_stiffness(RID p_body, real_t p_stiffness);
+	virtual real_t soft_body_get_volume_stiffness(RID p_body);
 
-	virtual void soft_body_set_pressure_coefficient(RID p_body, real_t p_pressure_coefficient) {}
-	virtual real_t soft_body_get_pressure_coefficient(RID p_body) { return 0.; }
+	virtual void soft_body_set_pressure_coefficient(RID p_body, real_t p_pressure_coefficient);
+	virtual real_t soft_body_get_pressure_coefficient(RID p_body);
 
-	virtual void soft_body_set_pose_matching_coefficient(RID p_body, real_t p_pose_matching_coefficient) {}
-	virtual real_t soft_body_get_pose_matching_coefficient(RID p_body) { return 0.; }
+	virtual void soft_body_set_pose_matching_coefficient(RID p_body, real_t p_pose_matching_coefficient);
+	virtual real_t soft_body_get_pose_matching_coefficient(RID p_body);
 
-	virtual void soft_body_set_damping_coefficient(RID p_body, real_t p_damping_coefficient) {}
-	virtual real_t soft_body_get_damping_coefficient(RID p_body) { return 0.; }
+	virtual void soft_body_set_damping_coefficient(RID p_body, real_t p_damping_coefficient);
+	virtual real_t soft_body_get_damping_coefficient(RID p_body);
 
-	virtual void soft_body_set_drag_coefficient(RID p_body, real_t p_drag_coefficient) {}
-	virtual real_t soft_body_get_drag_coefficient(RID p_body) { return 0.; }
+	virtual void soft_body_set_drag_coefficient(RID p_body, real_t p_drag_coefficient);
+	virtual real_t soft_body_get_drag_coefficient(RID p_body);
 
-	virtual void soft_body_set_mesh(RID p_body, const REF &p_mesh) {}
+	virtual void soft_body_set_mesh(RID p_body, const REF &p_mesh);
 
-	virtual void soft_body_move_point(RID p_body, int p_point_index, const Vector3 &p_global_position) {}
-	virtual Vector3 soft_body_get_point_global_position(RID p_body, int p_point_index) { return Vector3(); }
+	virtual void soft_body_move_point(RID p_body, int p_point_index, const Vector3 &p_global_position);
+	virtual Vector3 soft_body_get_point_global_position(RID p_body, int p_point_index);
 
-	virtual Vector3 soft_body_get_point_offset(RID p_body, int p_point_index) const { return Vector3(); }
+	virtual Vector3 soft_body_get_point_offset(RID p_body, int p_point_index) const;
 
-	virtual void soft_body_remove_all_pinned_points(RID p_body) {}
-	virtual void soft_body_pin_point(RID p_body, int p_point_index, bool p_pin) {}
-	virtual bool soft_body_is_point_pinned(RID p_body, int p_point_index) { return 0; }
+	virtual void soft_body_remove_all_pinned_points(RID p_body);
+	virtual void soft_body_pin_point(RID p_body, int p_point_index, bool p_pin);
+	virtual bool soft_body_is_point_pinned(RID p_body, int p_point_index);
 
 	/* JOINT API */
 
@@ -362,13 +381,30 @@ public:
 	virtual void set_active(bool p_active);
 	virtual void init();
 	virtual void step(real_t p_step);
+	virtual void sync();
 	virtual void flush_queries();
+	virtual void end_sync();
 	virtual void finish();
 
 	virtual bool is_flushing_queries() const { return flushing_queries; }
 
 	int get_process_info(ProcessInfo p_info);
 
+	// microseconds spent in each phase of the last step of the space
+	uint64_t space_get_elapsed_time(RID p_space, SpaceSW::ElapsedTime p_time) const;
+
+	// the narrow phase is only timed while the profiler runs, for a few seconds after its time
+	// was last read, or always once enabled here, so the first reading may be 0
+	void set_narrowphase_timing_enabled(bool p_enabled);
+
+	// threads used to set up and solve independent islands, 0 uses one per logical core
+	void set_solver_thread_count(int p_count);
+	int get_solver_thread_count() const;
+
+	// pool shared by threaded batch queries, NULL while another batch uses it
+	ThreadWorkPool *lock_query_work_pool();
+	void unlock_query_work_pool();
+
 	PhysicsServerSW();
 	~PhysicsServerSW();
 };
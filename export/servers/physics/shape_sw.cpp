@@ -30,9 +30,9 @@
 
 #include "shape_sw.h"
 
+#include "core/local_vector.h"
 #include "core/math/geometry.h"
 #include "core/math/quick_hull.h"
-#include "core/sort_array.h"
 
 #define _EDGE_IS_VALID_SUPPORT_THRESHOLD 0.0002
 #define _FACE_IS_VALID_SUPPORT_THRESHOLD 0.9998
@@ -1309,20 +1309,7 @@ FaceShapeSW::FaceShapeSW() {
 
 PoolVector<Vector3> ConcavePolygonShapeSW::get_faces() const {
 
-	PoolVector<Vector3> rfaces;
-	rfaces.resize(faces.size() * 3);
-
-	for (int i = 0; i < faces.size(); i++) {
-
-		Face f = faces.get(i);
-
-		for (int j = 0; j < 3; j++) {
-
-			rfaces.set(i * 3 + j, vertices.get(f.indices[j]));
-		}
-	}
-
-	return rfaces;
+	return vertices;
 }
 
 void ConcavePolygonShapeSW::project_range(const Vector3 &p_normal, const Transform &p_transform, real_t &r_min, real_t &r_max) const {
@@ -1374,55 +1361,120 @@ Vector3 ConcavePolygonShapeSW::get_support(const Vector3 &p_normal) const {
 	return vptr[vert_support_idx];
 }
 
-void ConcavePolygonShapeSW::_cull_segment(int p_idx, _SegmentCullParams *p_params) const {
+// Quantized bounds leave a step of room on both ends, so rounding outwards
+// never clamps away part of a face.
+#define BVH_QUANTIZED_EXTENT 65532.0
 
-	const BVH *bvh = &p_params->bvh[p_idx];
+static _FORCE_INLINE_ int _bvh_quantize(real_t p_value, real_t p_origin, real_t p_inv_scale, bool p_round_up) {
 
-	/*
-	if (p_params->dir.dot(bvh->aabb.get_support(-p_params->dir))>p_params->min_d)
-		return; //test against whole AABB, which isn't very costly
-	*/
+	real_t q = CLAMP((p_value - p_origin) * p_inv_scale, -2.0, 65537.0);
+	int i = p_round_up ? int(Math::ceil(q)) + 1 : int(Math::floor(q)) - 1;
+	return CLAMP(i, 0, 65535);
+}
 
-	//printf("addr: %p\n",bvh);
-	if (!bvh->aabb.intersects_segment(p_params->from, p_params->to)) {
+static _FORCE_INLINE_ void _bvh_slab(real_t p_min, real_t p_max, real_t p_from, real_t p_inv_delta, real_t &r_near, real_t &r_far) {
 
-		return;
-	}
+	real_t t0 = (p_min - p_from) * p_inv_delta;
+	real_t t1 = (p_max - p_from) * p_inv_delta;
+	r_near = MAX(r_near, MIN(t0, t1));
+	r_far = MIN(r_far, MAX(t0, t1));
+}
 
-	if (bvh->face_index >= 0) {
+void ConcavePolygonShapeSW::_cull_segment(_SegmentCullParams *p_params) const {
 
-		Vector3 res;
-		Vector3 vertices[3] = {
-			p_params->vertices[p_params->faces[bvh->face_index].indices[0]],
-			p_params->vertices[p_params->faces[bvh->face_index].indices[1]],
-			p_params->vertices[p_params->faces[bvh->face_index].indices[2]]
-		};
+	int *stack = (int *)alloca(sizeof(int) * (bvh_depth * (BVH_WIDTH - 1) + 1));
+	int stack_size = 0;
+	stack[stack_size++] = 0;
+
+	// segment fraction of the closest hit so far, further children are skipped
+	real_t max_t = 1.0;
+
+	while (stack_size > 0) {
+
+		const BVH &node = p_params->bvh[stack[--stack_size]];
+
+		real_t near_t[BVH_WIDTH];
+		bool hit[BVH_WIDTH];
+
+		for (int i = 0; i < BVH_WIDTH; i++) {
+
+			real_t t_near = 0;
+			real_t t_far = max_t;
+			_bvh_slab(bvh_origin.x + node.min_x[i] * bvh_scale.x, bvh_origin.x + node.max_x[i] * bvh_scale.x, p_params->from.x, p_params->inv_delta.x, t_near, t_far);
+			_bvh_slab(bvh_origin.y + node.min_y[i] * bvh_scale.y, bvh_origin.y + node.max_y[i] * bvh_scale.y, p_params->from.y, p_params->inv_delta.y, t_near, t_far);
+			_bvh_slab(bvh_origin.z + node.min_z[i] * bvh_scale.z, bvh_origin.z + node.max_z[i] * bvh_scale.z, p_params->from.z, p_params->inv_delta.z, t_near, t_far);
+			near_t[i] = t_near;
+			hit[i] = t_near <= t_far && node.child[i] >= 0;
+		}
 
-		if (Geometry::segment_intersects_triangle(
-					p_params->from,
-					p_params->to,
-					vertices[0],
-					vertices[1],
-					vertices[2],
-					&res)) {
-
-			real_t d = p_params->dir.dot(res) - p_params->dir.dot(p_params->from);
-			//TODO, seems segmen/triangle intersection is broken :(
-			if (d > 0 && d < p_params->min_d) {
-
-				p_params->min_d = d;
-				p_params->result = res;
-				p_params->normal = Plane(vertices[0], vertices[1], vertices[2]).normal;
-				p_params->collisions++;
+		// visit children front to back, so hits found early cull the rest
+		int order[BVH_WIDTH];
+		int order_count = 0;
+
+		for (int i = 0; i < BVH_WIDTH; i++) {
+
+			if (!hit[i])
+				continue;
+
+			int j = order_count++;
+			while (j > 0 && near_t[order[j - 1]] > near_t[i]) {
+				order[j] = order[j - 1];
+				j--;
 			}
+			order[j] = i;
 		}
 
-	} else {
+		int push_from = stack_size;
+
+		for (int i = 0; i < order_count; i++) {
+
+			int c = order[i];
+
+			if (node.face_count[c] == 0) {
+				stack[stack_size++] = node.child[c];
+				continue;
+			}
 
-		if (bvh->left >= 0)
-			_cull_segment(bvh->left, p_params);
-		if (bvh->right >= 0)
-			_cull_segment(bvh->right, p_params);
+			if (near_t[c] > max_t)
+				continue;
+
+			for (int j = 0; j < node.face_count[c]; j++) {
+
+				const Face &f = p_params->faces[node.child[c] + j];
+
+				Vector3 res;
+				Vector3 vertices[3] = {
+					p_params->vertices[f.indices[0]],
+					p_params->vertices[f.indices[1]],
+					p_params->vertices[f.indices[2]]
+				};
+
+				if (Geometry::segment_intersects_triangle(
+							p_params->from,
+							p_params->to,
+							vertices[0],
+							vertices[1],
+							vertices[2],
+							&res)) {
+
+					real_t d = p_params->dir.dot(res) - p_params->dir.dot(p_params->from);
+					//TODO, seems segmen/triangle intersection is broken :(
+					if (d > 0 && d < p_params->min_d) {
+
+						p_params->min_d = d;
+						p_params->result = res;
+						p_params->normal = Plane(vertices[0], vertices[1], vertices[2]).normal;
+						p_params->collisions++;
+						max_t = d / p_params->length;
+					}
+				}
+			}
+		}
+
+		// nearest child goes last, so it is popped first
+		for (int i = push_from, j = stack_size - 1; i < j; i++, j--) {
+			SWAP(stack[i], stack[j]);
+		}
 	}
 }
 
@@ -1436,11 +1488,19 @@ bool ConcavePolygonShapeSW::intersect_segment(const Vector3 &p_begin, const Vect
 	PoolVector<Vector3>::Read vr = vertices.read();
 	PoolVector<BVH>::Read br = bvh.read();
 
+	Vector3 delta = p_end - p_begin;
+
 	_SegmentCullParams params;
 	params.from = p_begin;
 	params.to = p_end;
 	params.collisions = 0;
-	params.dir = (p_end - p_begin).normalized();
+	params.dir = delta.normalized();
+	params.length = delta.length();
+
+	for (int i = 0; i < 3; i++) {
+		// axes the segment is parallel to only reject by the starting point
+		params.inv_delta[i] = Math::abs(delta[i]) > 1e-20 ? 1.0 / delta[i] : 1e20;
+	}
 
 	params.faces = fr.ptr();
 	params.vertices = vr.ptr();
@@ -1448,7 +1508,7 @@ bool ConcavePolygonShapeSW::intersect_segment(const Vector3 &p_begin, const Vect
 
 	params.min_d = 1e20;
 	// cull
-	_cull_segment(0, &params);
+	_cull_segment(&params);
 
 	if (params.collisions > 0) {
 
@@ -1471,33 +1531,56 @@ Vector3 ConcavePolygonShapeSW::get_closest_point_to(const Vector3 &p_point) cons
 	return Vector3();
 }
 
-void ConcavePolygonShapeSW::_cull(int p_idx, _CullParams *p_params) const {
+void ConcavePolygonShapeSW::_cull(_CullParams *p_params) const {
 
-	const BVH *bvh = &p_params->bvh[p_idx];
+	int *stack = (int *)alloca(sizeof(int) * (bvh_depth * (BVH_WIDTH - 1) + 1));
+	int stack_size = 0;
+	stack[stack_size++] = 0;
 
-	if (!p_params->aabb.intersects(bvh->aabb))
-		return;
+	while (stack_size > 0) {
 
-	if (bvh->face_index >= 0) {
+		const BVH &node = p_params->bvh[stack[--stack_size]];
 
-		const Face *f = &p_params->faces[bvh->face_index];
-		FaceShapeSW *face = p_params->face;
-		face->normal = f->normal;
-		face->vertex[0] = p_params->vertices[f->indices[0]];
-		face->vertex[1] = p_params->vertices[f->indices[1]];
-		face->vertex[2] = p_params->vertices[f->indices[2]];
-		p_params->callback(p_params->userdata, face);
-
-	} else {
+		bool overlap[BVH_WIDTH];
 
-		if (bvh->left >= 0) {
+		for (int i = 0; i < BVH_WIDTH; i++) {
 
-			_cull(bvh->left, p_params);
+			overlap[i] = (node.min_x[i] <= p_params->max[0]) & (node.max_x[i] >= p_params->min[0]) &
+						 (node.min_y[i] <= p_params->max[1]) & (node.max_y[i] >= p_params->min[1]) &
+						 (node.min_z[i] <= p_params->max[2]) & (node.max_z[i] >= p_params->min[2]);
 		}
 
-		if (bvh->right >= 0) {
+		for (int i = BVH_WIDTH - 1; i >= 0; i--) {
+
+			if (!overlap[i] || node.child[i] < 0)
+				continue;
+
+			if (node.face_count[i] == 0) {
+				stack[stack_size++] = node.child[i];
+				continue;
+			}
 
-			_cull(bvh->right, p_params);
+			for (int j = 0; j < node.face_count[i]; j++) {
+
+				// leaves are coarse, so check the faces too before reporting them
+				const Face *f = &p_params->faces[node.child[i] + j];
+				const Vector3 &v0 = p_params->vertices[f->indices[0]];
+				const Vector3 &v1 = p_params->vertices[f->indices[1]];
+				const Vector3 &v2 = p_params->vertices[f->indices[2]];
+
+				AABB face_aabb(v0, Vector3());
+				face_aabb.expand_to(v1);
+				face_aabb.expand_to(v2);
+				if (!p_params->aabb.intersects(face_aabb))
+					continue;
+
+				FaceShapeSW *face = p_params->face;
+				face->normal = f->normal;
+				face->vertex[0] = v0;
+				face->vertex[1] = v1;
+				face->vertex[2] = v2;
+				p_params->callback(p_params->userdata, face);
+			}
 		}
 	}
 }
@@ -1510,6 +1593,9 @@ void ConcavePolygonShapeSW::cull(const AABB &p_local_aabb, Callback p_callback,
 
 	AABB local_aabb = p_local_aabb;
 
+	if (!local_aabb.intersects(get_aabb()))
+		return;
+
 	// unlock data
 	PoolVector<Face>::Read fr = faces.read();
 	PoolVector<Vector3>::Read vr = vertices.read();
@@ -1519,6 +1605,10 @@ void ConcavePolygonShapeSW::cull(const AABB &p_local_aabb, Callback p_callback,
 
 	_CullParams params;
 	params.aabb = local_aabb;
+	for (int i = 0; i < 3; i++) {
+		params.min[i] = _bvh_quantize(local_aabb.position[i], bvh_origin[i], bvh_inv_scale[i], false);
+		params.max[i] = _bvh_quantize(local_aabb.position[i] + local_aabb.size[i], bvh_origin[i], bvh_inv_scale[i], true);
+	}
 	params.face = &face;
 	params.faces = fr.ptr();
 	params.vertices = vr.ptr();
@@ -1527,7 +1617,7 @@ void ConcavePolygonShapeSW::cull(const AABB &p_local_aabb, Callback p_callback,
 	params.userdata = p_userdata;
 
 	// cull
-	_cull(0, &params);
+	_cull(&params);
 }
 
 Vector3 ConcavePolygonShapeSW::get_moment_of_inertia(real_t p_mass) const {
@@ -1548,121 +1638,228 @@ struct _VolumeSW_BVH_Element {
 	int face_index;
 };
 
-struct _VolumeSW_BVH_CompareX {
+struct _VolumeSW_BVH {
 
-	_FORCE_INLINE_ bool operator()(const _VolumeSW_BVH_Element &a, const _VolumeSW_BVH_Element &b) const {
+	AABB aabb;
+	int left; // -1 for leaves
+	int right;
 
-		return a.center.x < b.center.x;
-	}
+	int begin; // range of elements in a leaf
+	int count;
 };
 
-struct _VolumeSW_BVH_CompareY {
+static _FORCE_INLINE_ real_t _volume_sw_surface(const AABB &p_aabb) {
 
-	_FORCE_INLINE_ bool operator()(const _VolumeSW_BVH_Element &a, const _VolumeSW_BVH_Element &b) const {
+	return p_aabb.size.x * p_aabb.size.y + p_aabb.size.y * p_aabb.size.z + p_aabb.size.z * p_aabb.size.x;
+}
 
-		return a.center.y < b.center.y;
-	}
-};
+static _FORCE_INLINE_ int _volume_sw_bin(const _VolumeSW_BVH_Element &p_element, int p_axis, real_t p_min, real_t p_bin_scale, int p_bin_count) {
+
+	return MIN(int((p_element.center[p_axis] - p_min) * p_bin_scale), p_bin_count - 1);
+}
 
-struct _VolumeSW_BVH_CompareZ {
+// Binary tree split with the binned surface area heuristic, it is later
+// collapsed into the four wide nodes used for queries.
+static int _volume_sw_build_bvh(LocalVector<_VolumeSW_BVH> &r_nodes, _VolumeSW_BVH_Element *p_elements, int p_begin, int p_count) {
+
+	enum {
+		BIN_COUNT = 16
+	};
 
-	_FORCE_INLINE_ bool operator()(const _VolumeSW_BVH_Element &a, const _VolumeSW_BVH_Element &b) const {
+	_VolumeSW_BVH_Element *elements = &p_elements[p_begin];
 
-		return a.center.z < b.center.z;
+	AABB aabb = elements[0].aabb;
+	AABB centers(elements[0].center, Vector3());
+	for (int i = 1; i < p_count; i++) {
+		aabb.merge_with(elements[i].aabb);
+		centers.expand_to(elements[i].center);
 	}
-};
 
-struct _VolumeSW_BVH {
+	int idx = r_nodes.size();
+	r_nodes.push_back(_VolumeSW_BVH());
+	r_nodes[idx].aabb = aabb;
+	r_nodes[idx].left = -1;
+	r_nodes[idx].right = -1;
+	r_nodes[idx].begin = p_begin;
+	r_nodes[idx].count = p_count;
 
-	AABB aabb;
-	_VolumeSW_BVH *left;
-	_VolumeSW_BVH *right;
+	if (p_count <= ConcavePolygonShapeSW::BVH_LEAF_SIZE) {
+		return idx;
+	}
 
-	int face_index;
-};
+	int best_axis = -1;
+	int best_bin = 0;
+	real_t best_cost = 1e20;
 
-_VolumeSW_BVH *_volume_sw_build_bvh(_VolumeSW_BVH_Element *p_elements, int p_size, int &count) {
+	for (int axis = 0; axis < 3; axis++) {
 
-	_VolumeSW_BVH *bvh = memnew(_VolumeSW_BVH);
+		if (centers.size[axis] <= 0)
+			continue;
 
-	if (p_size == 1) {
-		//leaf
-		bvh->aabb = p_elements[0].aabb;
-		bvh->left = NULL;
-		bvh->right = NULL;
-		bvh->face_index = p_elements->face_index;
-		count++;
-		return bvh;
-	} else {
+		real_t bin_scale = BIN_COUNT / centers.size[axis];
 
-		bvh->face_index = -1;
-	}
+		AABB bin_aabb[BIN_COUNT];
+		int bin_count[BIN_COUNT] = {};
 
-	AABB aabb;
-	for (int i = 0; i < p_size; i++) {
+		for (int i = 0; i < p_count; i++) {
 
-		if (i == 0)
-			aabb = p_elements[i].aabb;
-		else
-			aabb.merge_with(p_elements[i].aabb);
+			int bin = _volume_sw_bin(elements[i], axis, centers.position[axis], bin_scale, BIN_COUNT);
+			if (bin_count[bin] == 0)
+				bin_aabb[bin] = elements[i].aabb;
+			else
+				bin_aabb[bin].merge_with(elements[i].aabb);
+			bin_count[bin]++;
+		}
+
+		real_t right_area[BIN_COUNT];
+		int right_count[BIN_COUNT];
+		AABB accum;
+		int accum_count = 0;
+
+		for (int i = BIN_COUNT - 1; i > 0; i--) {
+
+			if (bin_count[i]) {
+				if (accum_count == 0)
+					accum = bin_aabb[i];
+				else
+					accum.merge_with(bin_aabb[i]);
+				accum_count += bin_count[i];
+			}
+			right_area[i] = accum_count ? _volume_sw_surface(accum) : 0;
+			right_count[i] = accum_count;
+		}
+
+		accum_count = 0;
+
+		for (int i = 0; i < BIN_COUNT - 1; i++) {
+
+			if (bin_count[i]) {
+				if (accum_count == 0)
+					accum = bin_aabb[i];
+				else
+					accum.merge_with(bin_aabb[i]);
+				accum_count += bin_count[i];
+			}
+
+			// split between this bin and the next one
+			if (accum_count == 0 || right_count[i + 1] == 0)
+				continue;
+
+			real_t cost = accum_count * _volume_sw_surface(accum) + right_count[i + 1] * right_area[i + 1];
+			if (cost < best_cost) {
+				best_cost = cost;
+				best_axis = axis;
+				best_bin = i;
+			}
+		}
 	}
-	bvh->aabb = aabb;
-	switch (aabb.get_longest_axis_index()) {
 
-		case 0: {
+	int split = 0;
 
-			SortArray<_VolumeSW_BVH_Element, _VolumeSW_BVH_CompareX> sort_x;
-			sort_x.sort(p_elements, p_size);
+	if (best_axis != -1) {
 
-		} break;
-		case 1: {
+		real_t bin_scale = BIN_COUNT / centers.size[best_axis];
 
-			SortArray<_VolumeSW_BVH_Element, _VolumeSW_BVH_CompareY> sort_y;
-			sort_y.sort(p_elements, p_size);
-		} break;
-		case 2: {
+		for (int i = 0; i < p_count; i++) {
+			if (_volume_sw_bin(elements[i], best_axis, centers.position[best_axis], bin_scale, BIN_COUNT) <= best_bin) {
+				SWAP(elements[i], elements[split]);
+				split++;
+			}
+		}
+	}
 
-			SortArray<_VolumeSW_BVH_Element, _VolumeSW_BVH_CompareZ> sort_z;
-			sort_z.sort(p_elements, p_size);
-		} break;
+	if (split == 0 || split == p_count) {
+		// all centers are in the same place, any split will do
+		split = p_count / 2;
 	}
 
-	int split = p_size / 2;
-	bvh->left = _volume_sw_build_bvh(p_elements, split, count);
-	bvh->right = _volume_sw_build_bvh(&p_elements[split], p_size - split, count);
+	int left = _volume_sw_build_bvh(r_nodes, p_elements, p_begin, split);
+	int right = _volume_sw_build_bvh(r_nodes, p_elements, p_begin + split, p_count - split);
+	r_nodes[idx].left = left;
+	r_nodes[idx].right = right;
 
-	//printf("branch at %p - %i: %i\n",bvh,count,bvh->face_index);
-	count++;
-	return bvh;
+	return idx;
 }
 
-void ConcavePolygonShapeSW::_fill_bvh(_VolumeSW_BVH *p_bvh_tree, BVH *p_bvh_array, int &p_idx) {
+static int _volume_sw_collapse_bvh(LocalVector<ConcavePolygonShapeSW::BVH> &r_bvh, const LocalVector<_VolumeSW_BVH> &p_nodes, int p_node, const Vector3 &p_origin, const Vector3 &p_inv_scale, int p_depth, int &r_max_depth) {
+
+	typedef ConcavePolygonShapeSW::BVH BVH;
 
-	int idx = p_idx;
+	enum {
+		WIDTH = ConcavePolygonShapeSW::BVH_WIDTH
+	};
 
-	p_bvh_array[idx].aabb = p_bvh_tree->aabb;
-	p_bvh_array[idx].face_index = p_bvh_tree->face_index;
-	//printf("%p - %i: %i(%p)  -- %p:%p\n",%p_bvh_array[idx],p_idx,p_bvh_array[i]->face_index,&p_bvh_tree->face_index,p_bvh_tree->left,p_bvh_tree->right);
+	r_max_depth = MAX(r_max_depth, p_depth + 1);
 
-	if (p_bvh_tree->left) {
-		p_bvh_array[idx].left = ++p_idx;
-		_fill_bvh(p_bvh_tree->left, p_bvh_array, p_idx);
+	int children[WIDTH];
+	int child_count = 0;
 
+	if (p_nodes[p_node].left < 0) {
+		// the whole shape fits in a single leaf
+		children[child_count++] = p_node;
 	} else {
+		children[child_count++] = p_nodes[p_node].left;
+		children[child_count++] = p_nodes[p_node].right;
+	}
+
+	// pull up the grandchildren of the largest inner children until the node is full
+	while (child_count < WIDTH) {
 
-		p_bvh_array[p_idx].left = -1;
+		int best = -1;
+		real_t best_area = -1;
+
+		for (int i = 0; i < child_count; i++) {
+
+			const _VolumeSW_BVH &child = p_nodes[children[i]];
+			if (child.left >= 0 && _volume_sw_surface(child.aabb) > best_area) {
+				best_area = _volume_sw_surface(child.aabb);
+				best = i;
+			}
+		}
+
+		if (best == -1)
+			break;
+
+		int opened = children[best];
+		children[best] = p_nodes[opened].left;
+		children[child_count++] = p_nodes[opened].right;
 	}
 
-	if (p_bvh_tree->right) {
-		p_bvh_array[idx].right = ++p_idx;
-		_fill_bvh(p_bvh_tree->right, p_bvh_array, p_idx);
+	int idx = r_bvh.size();
+	r_bvh.push_back(BVH());
 
-	} else {
+	for (int i = 0; i < WIDTH; i++) {
+
+		if (i >= child_count) {
+			// empty bounds, never overlapped
+			r_bvh[idx].min_x[i] = r_bvh[idx].min_y[i] = r_bvh[idx].min_z[i] = 65535;
+			r_bvh[idx].max_x[i] = r_bvh[idx].max_y[i] = r_bvh[idx].max_z[i] = 0;
+			r_bvh[idx].child[i] = -1;
+			r_bvh[idx].face_count[i] = 0;
+			continue;
+		}
 
-		p_bvh_array[p_idx].right = -1;
+		const _VolumeSW_BVH &child = p_nodes[children[i]];
+		Vector3 end = child.aabb.position + child.aabb.size;
+
+		r_bvh[idx].min_x[i] = _bvh_quantize(child.aabb.position.x, p_origin.x, p_inv_scale.x, false);
+		r_bvh[idx].min_y[i] = _bvh_quantize(child.aabb.position.y, p_origin.y, p_inv_scale.y, false);
+		r_bvh[idx].min_z[i] = _bvh_quantize(child.aabb.position.z, p_origin.z, p_inv_scale.z, false);
+		r_bvh[idx].max_x[i] = _bvh_quantize(end.x, p_origin.x, p_inv_scale.x, true);
+		r_bvh[idx].max_y[i] = _bvh_quantize(end.y, p_origin.y, p_inv_scale.y, true);
+		r_bvh[idx].max_z[i] = _bvh_quantize(end.z, p_origin.z, p_inv_scale.z, true);
+
+		if (child.left < 0) {
+			r_bvh[idx].child[i] = child.begin;
+			r_bvh[idx].face_count[i] = child.count;
+		} else {
+			int node = _volume_sw_collapse_bvh(r_bvh, p_nodes, children[i], p_origin, p_inv_scale, p_depth + 1, r_max_depth);
+			r_bvh[idx].child[i] = node;
+			r_bvh[idx].face_count[i] = 0;
+		}
 	}
 
-	memdelete(p_bvh_tree);
+	return idx;
 }
 
 void ConcavePolygonShapeSW::_setup(PoolVector<Vector3> p_faces) {
@@ -1678,56 +1875,70 @@ void ConcavePolygonShapeSW::_setup(PoolVector<Vector3> p_faces) {
 	PoolVector<Vector3>::Read r = p_faces.read();
 	const Vector3 *facesr = r.ptr();
 
-	PoolVector<_VolumeSW_BVH_Element> bvh_array;
-	bvh_array.resize(src_face_count);
+	LocalVector<_VolumeSW_BVH_Element> elements;
+	elements.resize(src_face_count);
 
-	PoolVector<_VolumeSW_BVH_Element>::Write bvhw = bvh_array.write();
-	_VolumeSW_BVH_Element *bvh_arrayw = bvhw.ptr();
+	AABB _aabb;
 
-	faces.resize(src_face_count);
-	PoolVector<Face>::Write w = faces.write();
-	Face *facesw = w.ptr();
+	for (int i = 0; i < src_face_count; i++) {
 
-	vertices.resize(src_face_count * 3);
+		Face3 face(facesr[i * 3 + 0], facesr[i * 3 + 1], facesr[i * 3 + 2]);
 
-	PoolVector<Vector3>::Write vw = vertices.write();
-	Vector3 *verticesw = vw.ptr();
+		elements[i].aabb = face.get_aabb();
+		elements[i].center = elements[i].aabb.position + elements[i].aabb.size * 0.5;
+		elements[i].face_index = i;
+		if (i == 0)
+			_aabb = elements[i].aabb;
+		else
+			_aabb.merge_with(elements[i].aabb);
+	}
 
-	AABB _aabb;
+	LocalVector<_VolumeSW_BVH> nodes;
+	nodes.reserve(src_face_count / 2 + 1);
+	int root = _volume_sw_build_bvh(nodes, elements.ptr(), 0, src_face_count);
+
+	// faces are stored in tree order, so each leaf refers to consecutive ones,
+	// the vertices stay in the order they were given to keep get_faces() intact
+	faces.resize(src_face_count);
+	PoolVector<Face>::Write w = faces.write();
+	Face *facesw = w.ptr();
 
 	for (int i = 0; i < src_face_count; i++) {
 
-		Face3 face(facesr[i * 3 + 0], facesr[i * 3 + 1], facesr[i * 3 + 2]);
+		int src = elements[i].face_index;
+		Face3 face(facesr[src * 3 + 0], facesr[src * 3 + 1], facesr[src * 3 + 2]);
 
-		bvh_arrayw[i].aabb = face.get_aabb();
-		bvh_arrayw[i].center = bvh_arrayw[i].aabb.position + bvh_arrayw[i].aabb.size * 0.5;
-		bvh_arrayw[i].face_index = i;
-		facesw[i].indices[0] = i * 3 + 0;
-		facesw[i].indices[1] = i * 3 + 1;
-		facesw[i].indices[2] = i * 3 + 2;
+		facesw[i].indices[0] = src * 3 + 0;
+		facesw[i].indices[1] = src * 3 + 1;
+		facesw[i].indices[2] = src * 3 + 2;
 		facesw[i].normal = face.get_plane().normal;
-		verticesw[i * 3 + 0] = face.vertex[0];
-		verticesw[i * 3 + 1] = face.vertex[1];
-		verticesw[i * 3 + 2] = face.vertex[2];
-		if (i == 0)
-			_aabb = bvh_arrayw[i].aabb;
-		else
-			_aabb.merge_with(bvh_arrayw[i].aabb);
 	}
 
 	w.release();
-	vw.release();
-
-	int count = 0;
-	_VolumeSW_BVH *bvh_tree = _volume_sw_build_bvh(bvh_arrayw, src_face_count, count);
+	vertices = p_faces;
 
-	bvh.resize(count + 1);
+	bvh_origin = _aabb.position;
+	for (int i = 0; i < 3; i++) {
+		if (_aabb.size[i] > CMP_EPSILON) {
+			bvh_scale[i] = _aabb.size[i] / BVH_QUANTIZED_EXTENT;
+			bvh_inv_scale[i] = BVH_QUANTIZED_EXTENT / _aabb.size[i];
+		} else {
+			// flat along this axis, every bound covers the whole thickness
+			bvh_scale[i] = CMP_EPSILON;
+			bvh_inv_scale[i] = 0;
+		}
+	}
 
-	PoolVector<BVH>::Write bvhw2 = bvh.write();
-	BVH *bvh_arrayw2 = bvhw2.ptr();
+	LocalVector<BVH> wide;
+	wide.reserve(nodes.size() / (BVH_WIDTH - 1) + 1);
+	bvh_depth = 0;
+	_volume_sw_collapse_bvh(wide, nodes, root, bvh_origin, bvh_inv_scale, 0, bvh_depth);
 
-	int idx = 0;
-	_fill_bvh(bvh_tree, bvh_arrayw2, idx);
+	bvh.resize(wide.size());
+	PoolVector<BVH>::Write bw = bvh.write();
+	for (uint32_t i = 0; i < wide.size(); i++) {
+		bw[i] = wide[i];
+	}
 
 	configure(_aabb); // this type of shape has no margin
 }
@@ -1743,6 +1954,8 @@ Variant ConcavePolygonShapeSW::get_data() const {
 }
 
 ConcavePolygonShapeSW::ConcavePolygonShapeSW() {
+
+	bvh_depth = 0;
 }
 
 /* HEIGHT MAP SHAPE */
@@ -1763,6 +1976,14 @@ real_t HeightMapShapeSW::get_cell_size() const {
 
 	return cell_size;
 }
+real_t HeightMapShapeSW::get_min_height() const {
+
+	return min_height;
+}
+real_t HeightMapShapeSW::get_max_height() const {
+
+	return max_height;
+}
 
 void HeightMapShapeSW::project_range(const Vector3 &p_normal, const Transform &p_transform, real_t &r_min, real_t &r_max) const {
 
@@ -1776,21 +1997,364 @@ Vector3 HeightMapShapeSW::get_support(const Vector3 &p_normal) const {
 	return get_aabb().get_support(p_normal);
 }
 
+void HeightMapShapeSW::_get_cell_faces(const real_t *p_heights, int p_x, int p_z, Vector3 r_faces[2][3]) const {
+
+	Vector3 p00, p10, p01, p11;
+	_get_point(p_heights, p_x, p_z, p00);
+	_get_point(p_heights, p_x + 1, p_z, p10);
+	_get_point(p_heights, p_x, p_z + 1, p01);
+	_get_point(p_heights, p_x + 1, p_z + 1, p11);
+
+	// same diagonal as the Bullet heightfield, both faces point up
+	r_faces[0][0] = p00;
+	r_faces[0][1] = p10;
+	r_faces[0][2] = p01;
+
+	r_faces[1][0] = p10;
+	r_faces[1][1] = p11;
+	r_faces[1][2] = p01;
+}
+
+AABB HeightMapShapeSW::_get_bounds_aabb(const Bounds *p_bounds, int p_level, int p_x, int p_z) const {
+
+	const BoundsLevel &level = bounds_levels[p_level];
+	const Bounds &b = p_bounds[level.offset + p_z * level.width + p_x];
+
+	int from_x = p_x << p_level;
+	int from_z = p_z << p_level;
+	int to_x = MIN((p_x + 1) << p_level, width - 1);
+	int to_z = MIN((p_z + 1) << p_level, depth - 1);
+
+	AABB aabb;
+	aabb.position = local_origin + Vector3(from_x * cell_size, b.min, from_z * cell_size);
+	aabb.size = Vector3((to_x - from_x) * cell_size, b.max - b.min, (to_z - from_z) * cell_size);
+	return aabb;
+}
+
+bool HeightMapShapeSW::_intersect_cell(const real_t *p_heights, int p_x, int p_z, const Vector3 &p_begin, const Vector3 &p_end, Vector3 &r_point, Vector3 &r_normal) const {
+
+	Vector3 faces[2][3];
+	_get_cell_faces(p_heights, p_x, p_z, faces);
+
+	Vector3 dir = p_end - p_begin;
+	real_t min_d = 1e20;
+	bool collided = false;
+
+	for (int i = 0; i < 2; i++) {
+
+		Vector3 res;
+		if (!Geometry::segment_intersects_triangle(p_begin, p_end, faces[i][0], faces[i][1], faces[i][2], &res))
+			continue;
+
+		real_t d = dir.dot(res - p_begin);
+		if (d < min_d) {
+
+			min_d = d;
+			r_point = res;
+			r_normal = Plane(faces[i][0], faces[i][1], faces[i][2]).normal;
+			collided = true;
+		}
+	}
+
+	return collided;
+}
+
+static _FORCE_INLINE_ bool _heightmap_clip_axis(real_t p_begin, real_t p_rel, real_t p_size, real_t &r_from, real_t &r_to) {
+
+	if (Math::is_zero_approx(p_rel))
+		return p_begin >= 0.0 && p_begin <= p_size;
+
+	real_t a = -p_begin / p_rel;
+	real_t b = (p_size - p_begin) / p_rel;
+	if (a > b)
+		SWAP(a, b);
+
+	r_from = MAX(r_from, a);
+	r_to = MIN(r_to, b);
+	return r_from <= r_to;
+}
+
 bool HeightMapShapeSW::intersect_segment(const Vector3 &p_begin, const Vector3 &p_end, Vector3 &r_point, Vector3 &r_normal) const {
 
+	if (heights.size() == 0)
+		return false;
+
+	// Walk the cells crossed by the segment projected on the map (in cell units),
+	// nearest first, so the first cell with a hit contains the closest one.
+	real_t inv_cell_size = 1.0 / cell_size;
+	Vector3 begin = p_begin - local_origin;
+	Vector3 rel = p_end - p_begin;
+
+	real_t begin_x = begin.x * inv_cell_size;
+	real_t begin_z = begin.z * inv_cell_size;
+	real_t rel_x = rel.x * inv_cell_size;
+	real_t rel_z = rel.z * inv_cell_size;
+
+	real_t t_from = 0.0;
+	real_t t_to = 1.0;
+
+	if (!_heightmap_clip_axis(begin_x, rel_x, width - 1, t_from, t_to))
+		return false;
+	if (!_heightmap_clip_axis(begin_z, rel_z, depth - 1, t_from, t_to))
+		return false;
+
+	int cell_x = CLAMP((int)Math::floor(begin_x + rel_x * t_from), 0, width - 2);
+	int cell_z = CLAMP((int)Math::floor(begin_z + rel_z * t_from), 0, depth - 2);
+
+	int step_x = 0;
+	int step_z = 0;
+	real_t delta_x = 1e20;
+	real_t delta_z = 1e20;
+	real_t next_x = 1e20;
+	real_t next_z = 1e20;
+
+	if (!Math::is_zero_approx(rel_x)) {
+
+		step_x = rel_x > 0 ? 1 : -1;
+		delta_x = 1.0 / Math::abs(rel_x);
+		next_x = ((rel_x > 0 ? cell_x + 1 : cell_x) - begin_x) / rel_x;
+	}
+
+	if (!Math::is_zero_approx(rel_z)) {
+
+		step_z = rel_z > 0 ? 1 : -1;
+		delta_z = 1.0 / Math::abs(rel_z);
+		next_z = ((rel_z > 0 ? cell_z + 1 : cell_z) - begin_z) / rel_z;
+	}
+
+	PoolVector<real_t>::Read r = heights.read();
+	const Bounds *cell_bounds = bounds.ptr(); // level 0
+
+	real_t t_cell = t_from;
+
+	while (true) {
+
+		real_t t_exit = MIN(MIN(next_x, next_z), t_to);
+
+		// skip the cell if the segment passes above or below all of it
+		real_t y_a = begin.y + rel.y * t_cell;
+		real_t y_b = begin.y + rel.y * t_exit;
+		const Bounds &b = cell_bounds[cell_z * (width - 1) + cell_x];
+
+		if (MAX(y_a, y_b) >= b.min - CMP_EPSILON && MIN(y_a, y_b) <= b.max + CMP_EPSILON) {
+
+			if (_intersect_cell(r.ptr(), cell_x, cell_z, p_begin, p_end, r_point, r_normal))
+				return true;
+		}
+
+		if (t_exit >= t_to)
+			break;
+
+		if (next_x < next_z) {
+
+			cell_x += step_x;
+			t_cell = next_x;
+			next_x += delta_x;
+		} else {
+
+			cell_z += step_z;
+			t_cell = next_z;
+			next_z += delta_z;
+		}
+
+		if (cell_x < 0 || cell_x >= width - 1 || cell_z < 0 || cell_z >= depth - 1)
+			break;
+	}
+
 	return false;
 }
 
 bool HeightMapShapeSW::intersect_point(const Vector3 &p_point) const {
-	return false;
+
+	if (heights.size() == 0 || !get_aabb().has_point(p_point))
+		return false;
+
+	// inside when under the surface
+	Vector3 local = p_point - local_origin;
+	real_t x = local.x / cell_size;
+	real_t z = local.z / cell_size;
+
+	int cell_x = CLAMP((int)x, 0, width - 2);
+	int cell_z = CLAMP((int)z, 0, depth - 2);
+	real_t fx = x - cell_x;
+	real_t fz = z - cell_z;
+
+	PoolVector<real_t>::Read r = heights.read();
+	real_t h00 = r[cell_z * width + cell_x];
+	real_t h10 = r[cell_z * width + cell_x + 1];
+	real_t h01 = r[(cell_z + 1) * width + cell_x];
+	real_t h11 = r[(cell_z + 1) * width + cell_x + 1];
+
+	real_t h;
+	if (fx + fz <= 1.0) {
+		h = h00 + (h10 - h00) * fx + (h01 - h00) * fz;
+	} else {
+		h = h11 + (h01 - h11) * (1.0 - fx) + (h10 - h11) * (1.0 - fz);
+	}
+
+	return local.y <= h;
+}
+
+void HeightMapShapeSW::_cull_closest_point(int p_level, int p_x, int p_z, _ClosestPointParams *p_params) const {
+
+	if (p_level == 0) {
+
+		Vector3 faces[2][3];
+		_get_cell_faces(p_params->heights, p_x, p_z, faces);
+
+		for (int i = 0; i < 2; i++) {
+
+			Vector3 closest = Face3(faces[i][0], faces[i][1], faces[i][2]).get_closest_point_to(p_params->point);
+			real_t d = closest.distance_squared_to(p_params->point);
+			if (d < p_params->min_distance_squared) {
+
+				p_params->min_distance_squared = d;
+				p_params->closest = closest;
+			}
+		}
+
+		return;
+	}
+
+	// visit the children nearest first, skipping the ones farther than the best point so far
+	int child_level = p_level - 1;
+	const BoundsLevel &level = bounds_levels[child_level];
+
+	int children[4][2];
+	real_t distances[4];
+	int child_count = 0;
+
+	for (int z = p_z * 2; z < MIN(p_z * 2 + 2, level.depth); z++) {
+		for (int x = p_x * 2; x < MIN(p_x * 2 + 2, level.width); x++) {
+
+			AABB aabb = _get_bounds_aabb(p_params->bounds, child_level, x, z);
+			Vector3 nearest = p_params->point;
+			nearest.x = CLAMP(nearest.x, aabb.position.x, aabb.position.x + aabb.size.x);
+			nearest.y = CLAMP(nearest.y, aabb.position.y, aabb.position.y + aabb.size.y);
+			nearest.z = CLAMP(nearest.z, aabb.position.z, aabb.position.z + aabb.size.z);
+			real_t d = nearest.distance_squared_to(p_params->point);
+
+			int i = child_count++;
+			while (i > 0 && distances[i - 1] > d) {
+				distances[i] = distances[i - 1];
+				children[i][0] = children[i - 1][0];
+				children[i][1] = children[i - 1][1];
+				i--;
+			}
+			distances[i] = d;
+			children[i][0] = x;
+			children[i][1] = z;
+		}
+	}
+
+	for (int i = 0; i < child_count; i++) {
+
+		if (distances[i] >= p_params->min_distance_squared)
+			break;
+		_cull_closest_point(child_level, children[i][0], children[i][1], p_params);
+	}
 }
 
 Vector3 HeightMapShapeSW::get_closest_point_to(const Vector3 &p_point) const {
 
-	return Vector3();
+	if (heights.size() == 0)
+		return Vector3();
+
+	PoolVector<real_t>::Read r = heights.read();
+
+	_ClosestPointParams params;
+	params.point = p_point;
+	params.heights = r.ptr();
+	params.bounds = bounds.ptr();
+	params.closest = Vector3();
+	params.min_distance_squared = 1e20;
+
+	_cull_closest_point(bounds_levels.size() - 1, 0, 0, &params);
+
+	return params.closest;
+}
+
+void HeightMapShapeSW::_cull(int p_level, int p_x, int p_z, _CullParams *p_params) const {
+
+	const BoundsLevel &level = bounds_levels[p_level];
+	const Bounds &b = p_params->bounds[level.offset + p_z * level.width + p_x];
+
+	if (b.max < p_params->min_y || b.min > p_params->max_y)
+		return;
+
+	if (p_level == 0) {
+
+		Vector3 faces[2][3];
+		_get_cell_faces(p_params->heights, p_x, p_z, faces);
+
+		FaceShapeSW *face = p_params->face;
+		for (int i = 0; i < 2; i++) {
+
+			face->vertex[0] = faces[i][0];
+			face->vertex[1] = faces[i][1];
+			face->vertex[2] = faces[i][2];
+			face->normal = Plane(faces[i][0], faces[i][1], faces[i][2]).normal;
+			p_params->callback(p_params->userdata, face);
+		}
+
+		return;
+	}
+
+	// only the children overlapping the queried cells
+	int child_level = p_level - 1;
+	const BoundsLevel &child = bounds_levels[child_level];
+
+	int from_x = MAX(p_x * 2, p_params->from_x >> child_level);
+	int from_z = MAX(p_z * 2, p_params->from_z >> child_level);
+	int to_x = MIN(MIN(p_x * 2 + 1, child.width - 1), p_params->to_x >> child_level);
+	int to_z = MIN(MIN(p_z * 2 + 1, child.depth - 1), p_params->to_z >> child_level);
+
+	for (int z = from_z; z <= to_z; z++) {
+		for (int x = from_x; x <= to_x; x++) {
+
+			_cull(child_level, x, z, p_params);
+		}
+	}
 }
 
 void HeightMapShapeSW::cull(const AABB &p_local_aabb, Callback p_callback, void *p_userdata) const {
+
+	if (heights.size() == 0)
+		return;
+
+	// query in cell units, heights are compared unscaled
+	Vector3 begin = p_local_aabb.position - local_origin;
+	Vector3 end = begin + p_local_aabb.size;
+
+	real_t inv_cell_size = 1.0 / cell_size;
+	int from_x = Math::floor(CLAMP(begin.x * inv_cell_size, -1.0, (real_t)width));
+	int from_z = Math::floor(CLAMP(begin.z * inv_cell_size, -1.0, (real_t)depth));
+	int to_x = Math::floor(CLAMP(end.x * inv_cell_size, -1.0, (real_t)width));
+	int to_z = Math::floor(CLAMP(end.z * inv_cell_size, -1.0, (real_t)depth));
+
+	if (to_x < 0 || to_z < 0 || from_x >= width - 1 || from_z >= depth - 1)
+		return;
+
+	// unlock data
+	PoolVector<real_t>::Read r = heights.read();
+
+	FaceShapeSW face; // use this to send in the callback
+
+	_CullParams params;
+	params.from_x = MAX(from_x, 0);
+	params.from_z = MAX(from_z, 0);
+	params.to_x = MIN(to_x, width - 2);
+	params.to_z = MIN(to_z, depth - 2);
+	params.min_y = begin.y;
+	params.max_y = end.y;
+	params.callback = p_callback;
+	params.userdata = p_userdata;
+	params.heights = r.ptr();
+	params.bounds = bounds.ptr();
+	params.face = &face;
+
+	// cull
+	_cull(bounds_levels.size() - 1, 0, 0, &params);
 }
 
 Vector3 HeightMapShapeSW::get_moment_of_inertia(real_t p_mass) const {
@@ -1804,31 +2368,94 @@ Vector3 HeightMapShapeSW::get_moment_of_inertia(real_t p_mass) const {
 			(p_mass / 3.0) * (extents.x * extents.x + extents.y * extents.y));
 }
 
-void HeightMapShapeSW::_setup(PoolVector<real_t> p_heights, int p_width, int p_depth, real_t p_cell_size) {
+void HeightMapShapeSW::_build_bounds() {
 
-	heights = p_heights;
-	width = p_width;
-	depth = p_depth;
-	cell_size = p_cell_size;
+	bounds.clear();
+	bounds_levels.clear();
 
 	PoolVector<real_t>::Read r = heights.read();
 
-	AABB aabb;
+	BoundsLevel level;
+	level.width = width - 1;
+	level.depth = depth - 1;
+	level.offset = 0;
 
-	for (int i = 0; i < depth; i++) {
+	bounds.resize(level.width * level.depth);
+	Bounds *w = bounds.ptrw();
 
-		for (int j = 0; j < width; j++) {
+	for (int z = 0; z < level.depth; z++) {
+		for (int x = 0; x < level.width; x++) {
 
-			real_t h = r[i * width + j];
+			real_t h00 = r[z * width + x];
+			real_t h10 = r[z * width + x + 1];
+			real_t h01 = r[(z + 1) * width + x];
+			real_t h11 = r[(z + 1) * width + x + 1];
 
-			Vector3 pos(j * cell_size, h, i * cell_size);
-			if (i == 0 || j == 0)
-				aabb.position = pos;
-			else
-				aabb.expand_to(pos);
+			Bounds &b = w[z * level.width + x];
+			b.min = MIN(MIN(h00, h10), MIN(h01, h11));
+			b.max = MAX(MAX(h00, h10), MAX(h01, h11));
 		}
 	}
 
+	bounds_levels.push_back(level);
+
+	while (level.width > 1 || level.depth > 1) {
+
+		BoundsLevel next;
+		next.width = (level.width + 1) / 2;
+		next.depth = (level.depth + 1) / 2;
+		next.offset = bounds.size();
+
+		bounds.resize(next.offset + next.width * next.depth);
+		w = bounds.ptrw();
+
+		for (int z = 0; z < next.depth; z++) {
+			for (int x = 0; x < next.width; x++) {
+
+				Bounds b = w[level.offset + z * 2 * level.width + x * 2];
+
+				for (int i = 1; i < 4; i++) {
+
+					int cx = x * 2 + (i & 1);
+					int cz = z * 2 + (i >> 1);
+					if (cx >= level.width || cz >= level.depth)
+						continue;
+
+					const Bounds &c = w[level.offset + cz * level.width + cx];
+					b.min = MIN(b.min, c.min);
+					b.max = MAX(b.max, c.max);
+				}
+
+				w[next.offset + z * next.width + x] = b;
+			}
+		}
+
+		bounds_levels.push_back(next);
+		level = next;
+	}
+}
+
+void HeightMapShapeSW::_setup(PoolVector<real_t> p_heights, int p_width, int p_depth, real_t p_cell_size, real_t p_min_height, real_t p_max_height) {
+
+	heights = p_heights;
+	width = p_width;
+	depth = p_depth;
+	cell_size = p_cell_size;
+	min_height = p_min_height;
+	max_height = p_max_height;
+
+	// Centered like the Bullet heightfield: horizontally on the map, vertically
+	// on the middle of the given height range.
+	local_origin = Vector3(-0.5 * (width - 1) * cell_size, -0.5 * (min_height + max_height), -0.5 * (depth - 1) * cell_size);
+
+	_build_bounds();
+
+	const Bounds &root = bounds[bounds.size() - 1];
+
+	AABB aabb;
+	aabb.position = local_origin + Vector3(0, root.min, 0);
+	aabb.size = Vector3((width - 1) * cell_size, root.max - root.min, (depth - 1) * cell_size);
+
 	configure(aabb);
 }
 
@@ -1838,24 +2465,35 @@ void HeightMapShapeSW::set_data(const Variant &p_data) {
 	Dictionary d = p_data;
 	ERR_FAIL_COND(!d.has("width"));
 	ERR_FAIL_COND(!d.has("depth"));
-	ERR_FAIL_COND(!d.has("cell_size"));
 	ERR_FAIL_COND(!d.has("heights"));
 
 	int width = d["width"];
 	int depth = d["depth"];
-	real_t cell_size = d["cell_size"];
 	PoolVector<real_t> heights = d["heights"];
 
-	ERR_FAIL_COND(width <= 0);
-	ERR_FAIL_COND(depth <= 0);
+	// optional, same defaults as the Bullet heightfield
+	real_t cell_size = d.has("cell_size") ? (real_t)d["cell_size"] : 1.0;
+	real_t min_height = d.has("min_height") ? (real_t)d["min_height"] : 0.0;
+	real_t max_height = d.has("max_height") ? (real_t)d["max_height"] : 0.0;
+
+	ERR_FAIL_COND_MSG(width < 2, "Map width must be at least 2.");
+	ERR_FAIL_COND_MSG(depth < 2, "Map depth must be at least 2.");
 	ERR_FAIL_COND(cell_size <= CMP_EPSILON);
+	ERR_FAIL_COND(min_height > max_height);
 	ERR_FAIL_COND(heights.size() != (width * depth));
-	_setup(heights, width, depth, cell_size);
+	_setup(heights, width, depth, cell_size, min_height, max_height);
 }
 
 Variant HeightMapShapeSW::get_data() const {
 
-	ERR_FAIL_V(Variant());
+	Dictionary d;
+	d["width"] = width;
+	d["depth"] = depth;
+	d["cell_size"] = cell_size;
+	d["heights"] = heights;
+	d["min_height"] = min_height;
+	d["max_height"] = max_height;
+	return d;
 }
 
 HeightMapShapeSW::HeightMapShapeSW() {
@@ -1863,4 +2501,6 @@ HeightMapShapeSW::HeightMapShapeSW() {
 	width = 0;
 	depth = 0;
 	cell_size = 0;
+	min_height = 0;
+	max_height = 0;
 }
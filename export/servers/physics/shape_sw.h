@@ -317,7 +317,6 @@ public:
 	ConvexPolygonShapeSW();
 };
 
-struct _VolumeSW_BVH;
 struct FaceShapeSW;
 
 struct ConcavePolygonShapeSW : public ConcaveShapeSW {
@@ -332,20 +331,39 @@ struct ConcavePolygonShapeSW : public ConcaveShapeSW {
 	PoolVector<Face> faces;
 	PoolVector<Vector3> vertices;
 
+	enum {
+		BVH_WIDTH = 4,
+		BVH_LEAF_SIZE = 4,
+	};
+
+	// Each node holds the bounds of its four children one axis after the
+	// other, so all of them are tested at once. Bounds are quantized to
+	// 16 bits inside the shape AABB and rounded outwards. Leaves refer to
+	// a range of faces, which are stored in tree order.
 	struct BVH {
 
-		AABB aabb;
-		int left;
-		int right;
+		uint16_t min_x[BVH_WIDTH];
+		uint16_t min_y[BVH_WIDTH];
+		uint16_t min_z[BVH_WIDTH];
+		uint16_t max_x[BVH_WIDTH];
+		uint16_t max_y[BVH_WIDTH];
+		uint16_t max_z[BVH_WIDTH];
 
-		int face_index;
+		int child[BVH_WIDTH]; // node index, first face of a leaf or -1 if unused
+		uint8_t face_count[BVH_WIDTH]; // zero unless the child is a leaf
 	};
 
 	PoolVector<BVH> bvh;
+	int bvh_depth;
+	Vector3 bvh_origin;
+	Vector3 bvh_scale;
+	Vector3 bvh_inv_scale;
 
 	struct _CullParams {
 
 		AABB aabb;
+		int min[3];
+		int max[3];
 		Callback callback;
 		void *userdata;
 		const Face *faces;
@@ -362,6 +380,8 @@ struct ConcavePolygonShapeSW : public ConcaveShapeSW {
 		const Vector3 *vertices;
 		const BVH *bvh;
 		Vector3 dir;
+		Vector3 inv_delta;
+		real_t length;
 
 		Vector3 result;
 		Vector3 normal;
@@ -369,10 +389,8 @@ struct ConcavePolygonShapeSW : public ConcaveShapeSW {
 		int collisions;
 	};
 
-	void _cull_segment(int p_idx, _SegmentCullParams *p_params) const;
-	void _cull(int p_idx, _CullParams *p_params) const;
-
-	void _fill_bvh(_VolumeSW_BVH *p_bvh_tree, BVH *p_bvh_array, int &p_idx);
+	void _cull_segment(_SegmentCullParams *p_params) const;
+	void _cull(_CullParams *p_params) const;
 
 	void _setup(PoolVector<Vector3> p_faces);
 
@@ -404,17 +422,74 @@ struct HeightMapShapeSW : public ConcaveShapeSW {
 	int width;
 	int depth;
 	real_t cell_size;
+	real_t min_height;
+	real_t max_height;
+	Vector3 local_origin; // local position of vertex (0,0) at height 0
+
+	// Height range of the cells; level 0 holds one entry per cell and every
+	// following level merges 2x2 blocks of the previous one, up to a single root.
+	struct Bounds {
+
+		real_t min;
+		real_t max;
+	};
+
+	struct BoundsLevel {
+
+		int width;
+		int depth;
+		int offset;
+	};
+
+	Vector<Bounds> bounds;
+	Vector<BoundsLevel> bounds_levels;
+
+	struct _CullParams {
+
+		int from_x;
+		int to_x;
+		int from_z;
+		int to_z;
+		real_t min_y;
+		real_t max_y;
+		Callback callback;
+		void *userdata;
+		const real_t *heights;
+		const Bounds *bounds;
+		FaceShapeSW *face;
+	};
+
+	struct _ClosestPointParams {
+
+		Vector3 point;
+		const real_t *heights;
+		const Bounds *bounds;
+		Vector3 closest;
+		real_t min_distance_squared;
+	};
+
+	_FORCE_INLINE_ void _get_point(const real_t *p_heights, int p_x, int p_z, Vector3 &r_point) const {
+
+		r_point = local_origin + Vector3(p_x * cell_size, p_heights[p_z * width + p_x], p_z * cell_size);
+	}
+
+	void _get_cell_faces(const real_t *p_heights, int p_x, int p_z, Vector3 r_faces[2][3]) const;
+	AABB _get_bounds_aabb(const Bounds *p_bounds, int p_level, int p_x, int p_z) const;
 
-	//void _cull_segment(int p_idx,_SegmentCullParams *p_params) const;
-	//void _cull(int p_idx,_CullParams *p_params) const;
+	void _cull(int p_level, int p_x, int p_z, _CullParams *p_params) const;
+	void _cull_closest_point(int p_level, int p_x, int p_z, _ClosestPointParams *p_params) const;
+	bool _intersect_cell(const real_t *p_heights, int p_x, int p_z, const Vector3 &p_begin, const Vector3 &p_end, Vector3 &r_point, Vector3 &r_normal) const;
 
-	void _setup(PoolVector<real_t> p_heights, int p_width, int p_depth, real_t p_cell_size);
+	void _build_bounds();
+	void _setup(PoolVector<real_t> p_heights, int p_width, int p_depth, real_t p_cell_size, real_t p_min_height, real_t p_max_height);
 
 public:
 	PoolVector<real_t> get_heights() const;
 	int get_width() const;
 	int get_depth() const;
 	real_t get_cell_size() const;
+	real_t get_min_height() const;
+	real_t get_max_height() const;
 
 	virtual PhysicsServer::ShapeType get_type() const { return PhysicsServer::SHAPE_HEIGHTMAP; }
 
@@ -0,0 +1,135 @@
+/*************************************************************************/
+/*  snapshot_sw.h                                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef SNAPSHOT_SW_H
+#define SNAPSHOT_SW_H
+
+#include "core/local_vector.h"
+#include "core/pool_vector.h"
+
+// Binary encoding used by space snapshots. Values are copied the way they are laid
+// out in memory, so a snapshot can only be restored by the build that created it.
+
+class SnapshotWriterSW {
+
+	LocalVector<uint8_t> data;
+
+public:
+	template <class T>
+	_FORCE_INLINE_ void put(const T &p_value) {
+
+		uint32_t ofs = data.size();
+		data.resize(ofs + sizeof(T));
+		memcpy(data.ptr() + ofs, &p_value, sizeof(T));
+	}
+
+	template <class T>
+	_FORCE_INLINE_ void put_at(uint32_t p_ofs, const T &p_value) {
+
+		ERR_FAIL_COND(p_ofs + sizeof(T) > data.size());
+		memcpy(data.ptr() + p_ofs, &p_value, sizeof(T));
+	}
+
+	_FORCE_INLINE_ uint32_t get_position() const { return data.size(); }
+
+	_FORCE_INLINE_ void rewind(uint32_t p_position) {
+
+		ERR_FAIL_COND(p_position > data.size());
+		data.resize(p_position);
+	}
+
+	void clear() { data.clear(); } // keeps the allocation, snapshots are usually taken every step
+
+	PoolVector<uint8_t> get_data() const {
+
+		PoolVector<uint8_t> ret;
+		ret.resize(data.size());
+		if (data.size()) {
+			PoolVector<uint8_t>::Write w = ret.write();
+			memcpy(w.ptr(), data.ptr(), data.size());
+		}
+		return ret;
+	}
+};
+
+class SnapshotReaderSW {
+
+	const uint8_t *data;
+	uint32_t size;
+	uint32_t pos;
+	bool failed;
+
+public:
+	template <class T>
+	_FORCE_INLINE_ bool get(T &r_value) {
+
+		if (failed || size - pos < sizeof(T)) {
+			failed = true;
+			return false;
+		}
+
+		memcpy(&r_value, data + pos, sizeof(T));
+		pos += sizeof(T);
+		return true;
+	}
+
+	_FORCE_INLINE_ bool skip(uint32_t p_bytes) {
+
+		if (failed || size - pos < p_bytes) {
+			failed = true;
+			return false;
+		}
+
+		pos += p_bytes;
+		return true;
+	}
+
+	// returns a reader for the next p_size bytes and skips them
+	SnapshotReaderSW read_block(uint32_t p_size) {
+
+		if (!skip(p_size)) {
+			return SnapshotReaderSW(NULL, 0);
+		}
+		return SnapshotReaderSW(data + pos - p_size, p_size);
+	}
+
+	_FORCE_INLINE_ uint32_t get_position() const { return pos; }
+	_FORCE_INLINE_ bool has_failed() const { return failed; }
+
+	SnapshotReaderSW(const uint8_t *p_data, uint32_t p_size) {
+
+		data = p_data;
+		size = p_size;
+		pos = 0;
+		failed = false;
+	}
+};
+
+#endif // SNAPSHOT_SW_H
@@ -0,0 +1,811 @@
+/*************************************************************************/
+/*  soft_body_sw.cpp                                                     */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "soft_body_sw.h"
+
+#include "collision_solver_sw.h"
+#include "scene/3d/soft_body.h"
+#include "scene/resources/mesh.h"
+#include "space_sw.h"
+
+// particles or links handed to a worker thread at a time
+#define SOFT_BODY_BATCH_SIZE 256
+// links that could not be given one of the 64 colors, solved on the calling thread
+#define SOFT_BODY_SERIAL_COLOR 64
+// like Bullet's default dynamic friction for soft bodies
+#define SOFT_BODY_MAX_FRICTION 0.2
+#define SOFT_BODY_MAX_COLLIDERS 256
+
+static _FORCE_INLINE_ uint64_t _pack_pair(uint32_t p_a, uint32_t p_b) {
+
+	return p_a < p_b ? (uint64_t(p_a) << 32) | p_b : (uint64_t(p_b) << 32) | p_a;
+}
+
+void SoftBodySW::set_space(SpaceSW *p_space) {
+
+	if (space) {
+		space->soft_body_remove_from_list(&soft_body_list);
+	}
+
+	space = p_space;
+
+	if (space) {
+		space->soft_body_add_to_list(&soft_body_list);
+	}
+}
+
+void SoftBodySW::set_mesh(const REF &p_mesh) {
+
+	rest_positions.clear();
+	positions.clear();
+	predicted.clear();
+	velocities.clear();
+	forces.clear();
+	normals.clear();
+	inv_masses.clear();
+	contact_normals.clear();
+	contact_friction.clear();
+	volume_gradients.clear();
+	triangles.clear();
+	visual_indices.clear();
+	links.clear();
+	color_offsets.clear();
+	rest_volume = 0;
+	closed = false;
+	aabb = AABB();
+
+	Ref<Mesh> mesh = p_mesh;
+	if (mesh.is_null() || mesh->get_surface_count() == 0) {
+		return;
+	}
+
+	ERR_FAIL_COND(!(mesh->surface_get_format(0) & VS::ARRAY_FORMAT_INDEX));
+
+	Array arrays = mesh->surface_get_arrays(0);
+	PoolVector<Vector3> vertices = arrays[VS::ARRAY_VERTEX];
+	PoolVector<int> indices = arrays[VS::ARRAY_INDEX];
+
+	// The visual mesh splits vertices along UV and normal seams, the
+	// simulation needs them merged so the surface stays connected.
+	LocalVector<int> vs_to_physics;
+	{
+		Map<Vector3, int> unique_vertices;
+		PoolVector<Vector3>::Read r = vertices.read();
+
+		vs_to_physics.resize(vertices.size());
+		for (int i = 0; i < vertices.size(); i++) {
+
+			Map<Vector3, int>::Element *E = unique_vertices.find(r[i]);
+			int point;
+			if (E) {
+				point = E->get();
+			} else {
+				point = rest_positions.size();
+				unique_vertices.insert(r[i], point);
+				rest_positions.push_back(r[i]);
+				visual_indices.push_back(LocalVector<int>());
+			}
+
+			visual_indices[point].push_back(i);
+			vs_to_physics[i] = point;
+		}
+	}
+
+	{
+		PoolVector<int>::Read r = indices.read();
+		int triangle_count = indices.size() / 3;
+
+		triangles.resize(triangle_count * 3);
+		for (int i = 0; i < triangle_count * 3; i++) {
+			ERR_FAIL_INDEX(r[i], (int)vs_to_physics.size());
+			triangles[i] = vs_to_physics[r[i]];
+		}
+	}
+
+	uint32_t count = rest_positions.size();
+	positions.resize(count);
+	predicted.resize(count);
+	velocities.resize(count);
+	forces.resize(count);
+	normals.resize(count);
+	inv_masses.resize(count);
+	contact_normals.resize(count);
+	contact_friction.resize(count);
+	volume_gradients.resize(count);
+
+	for (uint32_t i = 0; i < count; i++) {
+		positions[i] = transform.xform(rest_positions[i]);
+		predicted[i] = positions[i];
+		velocities[i] = Vector3();
+		forces[i] = Vector3();
+		contact_friction[i] = -1;
+	}
+
+	_build_links();
+	_update_masses();
+	rest_volume = _compute_volume(positions);
+	_update_normals();
+	_update_aabb();
+}
+
+void SoftBodySW::_build_links() {
+
+	uint32_t count = rest_positions.size();
+
+	LocalVector<uint64_t> edges;
+	for (uint32_t i = 0; i < triangles.size(); i += 3) {
+		for (int j = 0; j < 3; j++) {
+			uint32_t a = triangles[i + j];
+			uint32_t b = triangles[i + (j + 1) % 3];
+			if (a != b) {
+				edges.push_back(_pack_pair(a, b));
+			}
+		}
+	}
+	edges.sort();
+
+	// closed when every edge is shared by exactly two triangles
+	closed = edges.size() > 0;
+
+	LocalVector<uint64_t> pairs;
+	for (uint32_t i = 0; i < edges.size();) {
+		uint32_t j = i + 1;
+		while (j < edges.size() && edges[j] == edges[i]) {
+			j++;
+		}
+		if (j - i != 2) {
+			closed = false;
+		}
+		pairs.push_back(edges[i]);
+		i = j;
+	}
+	uint32_t edge_count = pairs.size();
+
+	// adjacency lists, packed
+	LocalVector<uint32_t> adjacency_offsets;
+	LocalVector<uint32_t> adjacency;
+	adjacency_offsets.resize(count + 1);
+	for (uint32_t i = 0; i <= count; i++) {
+		adjacency_offsets[i] = 0;
+	}
+	for (uint32_t i = 0; i < edge_count; i++) {
+		adjacency_offsets[(pairs[i] >> 32) + 1]++;
+		adjacency_offsets[(pairs[i] & 0xFFFFFFFF) + 1]++;
+	}
+	for (uint32_t i = 0; i < count; i++) {
+		adjacency_offsets[i + 1] += adjacency_offsets[i];
+	}
+	{
+		LocalVector<uint32_t> fill;
+		fill.resize(count);
+		for (uint32_t i = 0; i < count; i++) {
+			fill[i] = adjacency_offsets[i];
+		}
+		adjacency.resize(edge_count * 2);
+		for (uint32_t i = 0; i < edge_count; i++) {
+			uint32_t a = pairs[i] >> 32;
+			uint32_t b = pairs[i] & 0xFFFFFFFF;
+			adjacency[fill[a]++] = b;
+			adjacency[fill[b]++] = a;
+		}
+	}
+
+	// bending links join the particles two edges apart, like Bullet's generateBendingConstraints(2)
+	LocalVector<uint64_t> bends;
+	for (uint32_t a = 0; a < count; a++) {
+		for (uint32_t i = adjacency_offsets[a]; i < adjacency_offsets[a + 1]; i++) {
+			uint32_t b = adjacency[i];
+			for (uint32_t j = adjacency_offsets[b]; j < adjacency_offsets[b + 1]; j++) {
+				uint32_t c = adjacency[j];
+				if (c <= a) {
+					continue;
+				}
+				bool adjacent = false;
+				for (uint32_t k = adjacency_offsets[a]; k < adjacency_offsets[a + 1]; k++) {
+					if (adjacency[k] == c) {
+						adjacent = true;
+						break;
+					}
+				}
+				if (!adjacent) {
+					bends.push_back(_pack_pair(a, c));
+				}
+			}
+		}
+	}
+	bends.sort();
+
+	LocalVector<Link> unsorted;
+	for (uint32_t i = 0; i < edge_count; i++) {
+		Link l;
+		l.a = pairs[i] >> 32;
+		l.b = pairs[i] & 0xFFFFFFFF;
+		l.bending = false;
+		unsorted.push_back(l);
+	}
+	for (uint32_t i = 0; i < bends.size(); i++) {
+		if (i > 0 && bends[i] == bends[i - 1]) {
+			continue;
+		}
+		Link l;
+		l.a = bends[i] >> 32;
+		l.b = bends[i] & 0xFFFFFFFF;
+		l.bending = true;
+		unsorted.push_back(l);
+	}
+
+	// greedy coloring, a link takes the first color neither of its particles uses yet
+	LocalVector<uint64_t> used_colors;
+	LocalVector<uint32_t> link_colors;
+	used_colors.resize(count);
+	link_colors.resize(unsorted.size());
+	for (uint32_t i = 0; i < count; i++) {
+		used_colors[i] = 0;
+	}
+
+	color_offsets.resize(SOFT_BODY_SERIAL_COLOR + 2);
+	for (uint32_t i = 0; i < color_offsets.size(); i++) {
+		color_offsets[i] = 0;
+	}
+
+	for (uint32_t i = 0; i < unsorted.size(); i++) {
+
+		Link &l = unsorted[i];
+		l.rest_length = rest_positions[l.a].distance_to(rest_positions[l.b]);
+
+		uint64_t taken = used_colors[l.a] | used_colors[l.b];
+		uint32_t color = 0;
+		while (color < SOFT_BODY_SERIAL_COLOR && (taken & (uint64_t(1) << color))) {
+			color++;
+		}
+		if (color < SOFT_BODY_SERIAL_COLOR) {
+			used_colors[l.a] |= uint64_t(1) << color;
+			used_colors[l.b] |= uint64_t(1) << color;
+		}
+		link_colors[i] = color;
+		color_offsets[color + 1]++;
+	}
+
+	for (uint32_t i = 0; i <= SOFT_BODY_SERIAL_COLOR; i++) {
+		color_offsets[i + 1] += color_offsets[i];
+	}
+
+	links.resize(unsorted.size());
+	{
+		LocalVector<uint32_t> fill;
+		fill.resize(SOFT_BODY_SERIAL_COLOR + 1);
+		for (uint32_t i = 0; i <= SOFT_BODY_SERIAL_COLOR; i++) {
+			fill[i] = color_offsets[i];
+		}
+		for (uint32_t i = 0; i < unsorted.size(); i++) {
+			links[fill[link_colors[i]]++] = unsorted[i];
+		}
+	}
+}
+
+void SoftBodySW::_update_masses() {
+
+	uint32_t count = inv_masses.size();
+	if (!count) {
+		return;
+	}
+
+	real_t inv_mass = total_mass > 0 ? count / total_mass : 1.0;
+	for (uint32_t i = 0; i < count; i++) {
+		inv_masses[i] = inv_mass;
+	}
+	for (uint32_t i = 0; i < pinned_points.size(); i++) {
+		if (pinned_points[i] >= 0 && pinned_points[i] < (int)count) {
+			inv_masses[pinned_points[i]] = 0;
+		}
+	}
+}
+
+void SoftBodySW::_update_normals() {
+
+	uint32_t count = positions.size();
+	for (uint32_t i = 0; i < count; i++) {
+		normals[i] = Vector3();
+	}
+
+	// area weighted, with the clockwise front faces Godot meshes use
+	for (uint32_t i = 0; i < triangles.size(); i += 3) {
+		const Vector3 &a = positions[triangles[i + 0]];
+		const Vector3 &b = positions[triangles[i + 1]];
+		const Vector3 &c = positions[triangles[i + 2]];
+		Vector3 n = (a - c).cross(a - b);
+		normals[triangles[i + 0]] += n;
+		normals[triangles[i + 1]] += n;
+		normals[triangles[i + 2]] += n;
+	}
+
+	for (uint32_t i = 0; i < count; i++) {
+		real_t l = normals[i].length();
+		normals[i] = l > CMP_EPSILON ? normals[i] / l : Vector3();
+	}
+}
+
+void SoftBodySW::_update_aabb() {
+
+	uint32_t count = positions.size();
+	if (!count) {
+		aabb = AABB();
+		return;
+	}
+
+	aabb = AABB(positions[0], Vector3());
+	for (uint32_t i = 1; i < count; i++) {
+		aabb.expand_to(positions[i]);
+	}
+}
+
+real_t SoftBodySW::_compute_volume(const LocalVector<Vector3> &p_positions) const {
+
+	real_t volume = 0;
+	for (uint32_t i = 0; i < triangles.size(); i += 3) {
+		const Vector3 &a = p_positions[triangles[i + 0]];
+		const Vector3 &b = p_positions[triangles[i + 1]];
+		const Vector3 &c = p_positions[triangles[i + 2]];
+		volume += a.dot(c.cross(b));
+	}
+	return volume / 6.0;
+}
+
+void SoftBodySW::_apply_pressure() {
+
+	uint32_t count = forces.size();
+	for (uint32_t i = 0; i < count; i++) {
+		forces[i] = Vector3();
+	}
+
+	real_t volume = Math::abs(_compute_volume(positions));
+	if (volume < CMP_EPSILON) {
+		return;
+	}
+
+	// the same pressure on every face, pushing along the face normal
+	real_t scale = pressure_coefficient / (volume * 6.0);
+	for (uint32_t i = 0; i < triangles.size(); i += 3) {
+		const Vector3 &a = positions[triangles[i + 0]];
+		const Vector3 &b = positions[triangles[i + 1]];
+		const Vector3 &c = positions[triangles[i + 2]];
+		Vector3 f = (a - c).cross(a - b) * scale;
+		forces[triangles[i + 0]] += f;
+		forces[triangles[i + 1]] += f;
+		forces[triangles[i + 2]] += f;
+	}
+}
+
+void SoftBodySW::_solve_volume(real_t p_stiffness) {
+
+	uint32_t count = predicted.size();
+	for (uint32_t i = 0; i < count; i++) {
+		volume_gradients[i] = Vector3();
+	}
+
+	for (uint32_t i = 0; i < triangles.size(); i += 3) {
+		const Vector3 &a = predicted[triangles[i + 0]];
+		const Vector3 &b = predicted[triangles[i + 1]];
+		const Vector3 &c = predicted[triangles[i + 2]];
+		volume_gradients[triangles[i + 0]] += c.cross(b);
+		volume_gradients[triangles[i + 1]] += a.cross(c);
+		volume_gradients[triangles[i + 2]] += b.cross(a);
+	}
+
+	real_t denominator = 0;
+	for (uint32_t i = 0; i < count; i++) {
+		volume_gradients[i] /= 6.0;
+		denominator += inv_masses[i] * volume_gradients[i].length_squared();
+	}
+
+	if (denominator < CMP_EPSILON) {
+		return;
+	}
+
+	real_t lambda = p_stiffness * (rest_volume - _compute_volume(predicted)) / denominator;
+	for (uint32_t i = 0; i < count; i++) {
+		predicted[i] += volume_gradients[i] * (lambda * inv_masses[i]);
+	}
+}
+
+void SoftBodySW::_gather_colliders(const AABB &p_aabb) {
+
+	colliders.clear();
+
+	int count = space->get_broadphase()->cull_aabb(p_aabb.grow(collision_margin), cull_results.ptr(), cull_results.size(), cull_shapes.ptr());
+
+	for (int i = 0; i < count; i++) {
+
+		CollisionObjectSW *co = cull_results[i];
+		if (co->get_type() != CollisionObjectSW::TYPE_BODY) {
+			continue;
+		}
+		if (!(co->get_collision_layer() & collision_mask) && !(collision_layer & co->get_collision_mask())) {
+			continue;
+		}
+		if (exceptions.has(co->get_self())) {
+			continue;
+		}
+
+		int shape_idx = cull_shapes[i];
+		if (co->is_shape_set_as_disabled(shape_idx)) {
+			continue;
+		}
+
+		Collider c;
+		c.shape = co->get_shape(shape_idx);
+		c.xform = co->get_transform() * co->get_shape_transform(shape_idx);
+		c.aabb = co->get_shape_aabb(shape_idx).grow(collision_margin);
+		c.friction = MIN(static_cast<BodySW *>(co)->get_friction(), SOFT_BODY_MAX_FRICTION);
+		colliders.push_back(c);
+	}
+}
+
+void SoftBodySW::_integrate_batch(uint32_t p_batch, void *p_userdata) {
+
+	uint32_t from = p_batch * SOFT_BODY_BATCH_SIZE;
+	uint32_t to = MIN(from + SOFT_BODY_BATCH_SIZE, positions.size());
+	bool use_forces = pressure_coefficient != 0 && closed;
+
+	for (uint32_t i = from; i < to; i++) {
+
+		if (inv_masses[i] == 0) {
+			velocities[i] = Vector3();
+			predicted[i] = positions[i];
+			continue;
+		}
+
+		Vector3 v = velocities[i] + step_gravity * step_delta;
+		if (use_forces) {
+			v += forces[i] * (inv_masses[i] * step_delta);
+		}
+
+		// drag only resists moving against the air, along the surface normal
+		if (drag_coefficient > 0) {
+			v -= normals[i] * (v.dot(normals[i]) * drag_coefficient);
+		}
+
+		v *= 1.0 - damping_coefficient;
+
+		velocities[i] = v;
+		predicted[i] = positions[i] + v * step_delta;
+	}
+}
+
+void SoftBodySW::_solve_link(const Link &p_link) {
+
+	real_t wa = inv_masses[p_link.a];
+	real_t wb = inv_masses[p_link.b];
+	real_t w = wa + wb;
+	if (w == 0) {
+		return;
+	}
+
+	Vector3 &pa = predicted[p_link.a];
+	Vector3 &pb = predicted[p_link.b];
+	Vector3 d = pb - pa;
+	real_t len = d.length();
+	if (len < CMP_EPSILON) {
+		return;
+	}
+
+	real_t k = p_link.bending ? step_bending_stiffness : step_linear_stiffness;
+	Vector3 correction = d * (k * (len - p_link.rest_length) / (len * w));
+	pa += correction * wa;
+	pb -= correction * wb;
+}
+
+void SoftBodySW::_solve_links_batch(uint32_t p_batch, void *p_userdata) {
+
+	uint32_t from = color_offsets[step_color] + p_batch * SOFT_BODY_BATCH_SIZE;
+	uint32_t to = MIN(from + SOFT_BODY_BATCH_SIZE, color_offsets[step_color + 1]);
+
+	for (uint32_t i = from; i < to; i++) {
+		_solve_link(links[i]);
+	}
+}
+
+struct _SoftBodyContactSW {
+
+	Vector3 recover;
+	int amount;
+};
+
+static void _soft_body_contact_callback(const Vector3 &p_point_A, const Vector3 &p_point_B, void *p_userdata) {
+
+	_SoftBodyContactSW *contact = (_SoftBodyContactSW *)p_userdata;
+	contact->recover += p_point_B - p_point_A;
+	contact->amount++;
+}
+
+void SoftBodySW::_collide_batch(uint32_t p_batch, void *p_userdata) {
+
+	uint32_t from = p_batch * SOFT_BODY_BATCH_SIZE;
+	uint32_t to = MIN(from + SOFT_BODY_BATCH_SIZE, positions.size());
+
+	for (uint32_t i = from; i < to; i++) {
+
+		contact_friction[i] = -1;
+
+		if (inv_masses[i] == 0) {
+			continue;
+		}
+
+		for (uint32_t j = 0; j < colliders.size(); j++) {
+
+			const Collider &c = colliders[j];
+			if (!c.aabb.has_point(predicted[i])) {
+				continue;
+			}
+
+			_SoftBodyContactSW contact;
+			contact.amount = 0;
+
+			// each particle is a small sphere, pushed out of the shape it sinks into
+			if (!CollisionSolverSW::solve_static(particle_shape, Transform(Basis(), predicted[i]), c.shape, c.xform, _soft_body_contact_callback, &contact) || contact.amount == 0) {
+				continue;
+			}
+
+			Vector3 recover = contact.recover / contact.amount;
+			predicted[i] += recover;
+			contact_normals[i] = recover.normalized();
+			contact_friction[i] = MAX(contact_friction[i], c.friction);
+		}
+	}
+}
+
+void SoftBodySW::_update_velocities_batch(uint32_t p_batch, void *p_userdata) {
+
+	uint32_t from = p_batch * SOFT_BODY_BATCH_SIZE;
+	uint32_t to = MIN(from + SOFT_BODY_BATCH_SIZE, positions.size());
+	real_t inv_delta = 1.0 / step_delta;
+
+	for (uint32_t i = from; i < to; i++) {
+
+		if (inv_masses[i] == 0) {
+			positions[i] = predicted[i];
+			continue;
+		}
+
+		Vector3 v = (predicted[i] - positions[i]) * inv_delta;
+
+		if (contact_friction[i] >= 0) {
+			const Vector3 &n = contact_normals[i];
+			real_t vn = v.dot(n);
+			Vector3 tangent = v - n * vn;
+			v = tangent * (1.0 - contact_friction[i]) + n * MAX(vn, 0);
+		}
+
+		velocities[i] = v;
+		positions[i] = predicted[i];
+	}
+}
+
+void SoftBodySW::step(real_t p_delta, ThreadWorkPool *p_work_pool) {
+
+	uint32_t count = positions.size();
+	if (!active || !count || !space || p_delta <= 0) {
+		return;
+	}
+
+	AreaSW *default_area = space->get_default_area();
+	step_gravity = default_area->get_gravity_vector() * default_area->get_gravity();
+	step_delta = p_delta;
+
+	// stiffness per iteration, so the precision does not change how stiff the body is
+	int iterations = MAX(simulation_precision, 1);
+	step_linear_stiffness = 1.0 - Math::pow(1.0 - linear_stiffness, (real_t)1.0 / iterations);
+	step_bending_stiffness = 1.0 - Math::pow(1.0 - areaAngular_stiffness, (real_t)1.0 / iterations);
+	real_t step_volume_stiffness = 1.0 - Math::pow(1.0 - volume_stiffness, (real_t)1.0 / iterations);
+
+	if (pressure_coefficient != 0 && closed) {
+		_apply_pressure();
+	}
+
+	uint32_t particle_batches = (count + SOFT_BODY_BATCH_SIZE - 1) / SOFT_BODY_BATCH_SIZE;
+	p_work_pool->do_work(particle_batches, this, &SoftBodySW::_integrate_batch, (void *)NULL);
+
+	AABB motion_aabb = aabb;
+	for (uint32_t i = 0; i < count; i++) {
+		motion_aabb.expand_to(predicted[i]);
+	}
+	_gather_colliders(motion_aabb);
+
+	for (int i = 0; i < iterations; i++) {
+
+		for (uint32_t color = 0; color < SOFT_BODY_SERIAL_COLOR; color++) {
+
+			uint32_t link_count = color_offsets[color + 1] - color_offsets[color];
+			if (!link_count) {
+				continue;
+			}
+
+			step_color = color;
+			p_work_pool->do_work((link_count + SOFT_BODY_BATCH_SIZE - 1) / SOFT_BODY_BATCH_SIZE, this, &SoftBodySW::_solve_links_batch, (void *)NULL);
+		}
+
+		for (uint32_t j = color_offsets[SOFT_BODY_SERIAL_COLOR]; j < color_offsets[SOFT_BODY_SERIAL_COLOR + 1]; j++) {
+			_solve_link(links[j]);
+		}
+
+		if (closed && volume_stiffness > 0) {
+			_solve_volume(step_volume_stiffness);
+		}
+	}
+
+	p_work_pool->do_work(particle_batches, this, &SoftBodySW::_collide_batch, (void *)NULL);
+	p_work_pool->do_work(particle_batches, this, &SoftBodySW::_update_velocities_batch, (void *)NULL);
+
+	_update_normals();
+	_update_aabb();
+}
+
+void SoftBodySW::set_transform(const Transform &p_transform) {
+
+	transform = p_transform;
+
+	for (uint32_t i = 0; i < positions.size(); i++) {
+		positions[i] = transform.xform(rest_positions[i]);
+		predicted[i] = positions[i];
+		velocities[i] = Vector3();
+	}
+
+	_update_normals();
+	_update_aabb();
+}
+
+void SoftBodySW::set_linear_velocity(const Vector3 &p_velocity) {
+
+	for (uint32_t i = 0; i < velocities.size(); i++) {
+		velocities[i] = inv_masses[i] == 0 ? Vector3() : p_velocity;
+	}
+}
+
+Vector3 SoftBodySW::get_linear_velocity() const {
+
+	if (!velocities.size()) {
+		return Vector3();
+	}
+
+	Vector3 velocity;
+	for (uint32_t i = 0; i < velocities.size(); i++) {
+		velocity += velocities[i];
+	}
+	return velocity / velocities.size();
+}
+
+void SoftBodySW::set_simulation_precision(int p_precision) {
+
+	simulation_precision = MAX(p_precision, 1);
+}
+
+void SoftBodySW::set_total_mass(real_t p_mass) {
+
+	ERR_FAIL_COND(p_mass <= 0);
+	total_mass = p_mass;
+	_update_masses();
+}
+
+void SoftBodySW::set_point_position(int p_index, const Vector3 &p_position) {
+
+	ERR_FAIL_INDEX(p_index, (int)positions.size());
+	positions[p_index] = p_position;
+	predicted[p_index] = p_position;
+}
+
+Vector3 SoftBodySW::get_point_position(int p_index) const {
+
+	ERR_FAIL_INDEX_V(p_index, (int)positions.size(), Vector3());
+	return positions[p_index];
+}
+
+Vector3 SoftBodySW::get_point_offset(int p_index) const {
+
+	ERR_FAIL_INDEX_V(p_index, (int)rest_positions.size(), Vector3());
+	return rest_positions[p_index];
+}
+
+void SoftBodySW::pin_point(int p_index, bool p_pin) {
+
+	int found = pinned_points.find(p_index);
+	if (p_pin && found == -1) {
+		pinned_points.push_back(p_index);
+	} else if (!p_pin && found != -1) {
+		pinned_points.remove_unordered(found);
+	}
+	_update_masses();
+}
+
+bool SoftBodySW::is_point_pinned(int p_index) const {
+
+	return pinned_points.find(p_index) != -1;
+}
+
+void SoftBodySW::remove_all_pinned_points() {
+
+	pinned_points.clear();
+	_update_masses();
+}
+
+void SoftBodySW::update_visual_server(SoftBodyVisualServerHandler *p_visual_server_handler) {
+
+	for (uint32_t i = 0; i < positions.size(); i++) {
+
+		const LocalVector<int> &vs_indices = visual_indices[i];
+		for (uint32_t j = 0; j < vs_indices.size(); j++) {
+			p_visual_server_handler->set_vertex(vs_indices[j], &positions[i]);
+			p_visual_server_handler->set_normal(vs_indices[j], &normals[i]);
+		}
+	}
+
+	p_visual_server_handler->set_aabb(aabb);
+}
+
+SoftBodySW::SoftBodySW() :
+		soft_body_list(this) {
+
+	instance_id = 0;
+	space = NULL;
+	collision_layer = 1;
+	collision_mask = 1;
+	ray_pickable = true;
+	active = true;
+
+	simulation_precision = 5;
+	total_mass = 1;
+	linear_stiffness = 0.5;
+	areaAngular_stiffness = 0.5;
+	volume_stiffness = 0.5;
+	pressure_coefficient = 0;
+	pose_matching_coefficient = 0;
+	damping_coefficient = 0.01;
+	drag_coefficient = 0;
+	collision_margin = 0.01;
+
+	rest_volume = 0;
+	closed = false;
+
+	step_delta = 0;
+	step_linear_stiffness = 0;
+	step_bending_stiffness = 0;
+	step_color = 0;
+
+	cull_results.resize(SOFT_BODY_MAX_COLLIDERS);
+	cull_shapes.resize(SOFT_BODY_MAX_COLLIDERS);
+
+	SphereShapeSW *sphere = memnew(SphereShapeSW);
+	sphere->set_data(collision_margin);
+	particle_shape = sphere;
+}
+
+SoftBodySW::~SoftBodySW() {
+
+	memdelete(particle_shape);
+}
@@ -0,0 +1,217 @@
+/*************************************************************************/
+/*  soft_body_sw.h                                                       */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef SOFT_BODY_SW_H
+#define SOFT_BODY_SW_H
+
+#include "core/local_vector.h"
+#include "core/os/thread_work_pool.h"
+#include "core/rid.h"
+#include "core/self_list.h"
+#include "core/vset.h"
+#include "servers/physics_server.h"
+
+class SpaceSW;
+class ShapeSW;
+
+// Position based soft body. Particles are kept in separate arrays and the
+// link constraints are grouped by graph color, so that links of the same
+// color never share a particle and can be solved on any thread without
+// changing the result.
+class SoftBodySW : public RID_Data {
+
+	RID self;
+	ObjectID instance_id;
+	SpaceSW *space;
+	SelfList<SoftBodySW> soft_body_list;
+
+	uint32_t collision_layer;
+	uint32_t collision_mask;
+	VSet<RID> exceptions;
+	bool ray_pickable;
+	bool active;
+
+	int simulation_precision;
+	real_t total_mass;
+	real_t linear_stiffness;
+	real_t areaAngular_stiffness;
+	real_t volume_stiffness;
+	real_t pressure_coefficient;
+	real_t pose_matching_coefficient;
+	real_t damping_coefficient;
+	real_t drag_coefficient;
+	real_t collision_margin;
+
+	// particles
+	LocalVector<Vector3> rest_positions;
+	LocalVector<Vector3> positions;
+	LocalVector<Vector3> predicted;
+	LocalVector<Vector3> velocities;
+	LocalVector<Vector3> forces;
+	LocalVector<Vector3> normals;
+	LocalVector<real_t> inv_masses;
+	LocalVector<Vector3> contact_normals;
+	LocalVector<real_t> contact_friction; // < 0 when the particle is not touching anything
+	LocalVector<Vector3> volume_gradients;
+
+	// mesh
+	Transform transform;
+	LocalVector<uint32_t> triangles;
+	LocalVector<LocalVector<int> > visual_indices;
+	LocalVector<int> pinned_points;
+	real_t rest_volume;
+	bool closed;
+
+	struct Link {
+		uint32_t a;
+		uint32_t b;
+		real_t rest_length;
+		bool bending;
+	};
+
+	// sorted by color, color i uses links [color_offsets[i], color_offsets[i + 1])
+	LocalVector<Link> links;
+	LocalVector<uint32_t> color_offsets;
+
+	struct Collider {
+		const ShapeSW *shape;
+		Transform xform;
+		AABB aabb;
+		real_t friction;
+	};
+
+	LocalVector<Collider> colliders;
+	LocalVector<class CollisionObjectSW *> cull_results;
+	LocalVector<int> cull_shapes;
+
+	ShapeSW *particle_shape;
+	AABB aabb;
+
+	// read by the worker threads during step()
+	real_t step_delta;
+	Vector3 step_gravity;
+	real_t step_linear_stiffness;
+	real_t step_bending_stiffness;
+	uint32_t step_color;
+
+	void _build_links();
+	void _update_masses();
+	void _update_normals();
+	void _update_aabb();
+	real_t _compute_volume(const LocalVector<Vector3> &p_positions) const;
+	void _apply_pressure();
+	void _solve_volume(real_t p_stiffness);
+	void _gather_colliders(const AABB &p_aabb);
+
+	void _integrate_batch(uint32_t p_batch, void *p_userdata);
+	void _solve_links_batch(uint32_t p_batch, void *p_userdata);
+	void _collide_batch(uint32_t p_batch, void *p_userdata);
+	void _update_velocities_batch(uint32_t p_batch, void *p_userdata);
+
+	_FORCE_INLINE_ void _solve_link(const Link &p_link);
+
+public:
+	_FORCE_INLINE_ void set_self(const RID &p_self) { self = p_self; }
+	_FORCE_INLINE_ RID get_self() const { return self; }
+
+	_FORCE_INLINE_ void set_instance_id(const ObjectID &p_instance_id) { instance_id = p_instance_id; }
+	_FORCE_INLINE_ ObjectID get_instance_id() const { return instance_id; }
+
+	void set_space(SpaceSW *p_space);
+	_FORCE_INLINE_ SpaceSW *get_space() const { return space; }
+
+	_FORCE_INLINE_ void set_collision_layer(uint32_t p_layer) { collision_layer = p_layer; }
+	_FORCE_INLINE_ uint32_t get_collision_layer() const { return collision_layer; }
+
+	_FORCE_INLINE_ void set_collision_mask(uint32_t p_mask) { collision_mask = p_mask; }
+	_FORCE_INLINE_ uint32_t get_collision_mask() const { return collision_mask; }
+
+	_FORCE_INLINE_ void add_exception(const RID &p_exception) { exceptions.insert(p_exception); }
+	_FORCE_INLINE_ void remove_exception(const RID &p_exception) { exceptions.erase(p_exception); }
+	_FORCE_INLINE_ const VSet<RID> &get_exceptions() const { return exceptions; }
+
+	_FORCE_INLINE_ void set_ray_pickable(bool p_enable) { ray_pickable = p_enable; }
+	_FORCE_INLINE_ bool is_ray_pickable() const { return ray_pickable; }
+
+	_FORCE_INLINE_ void set_active(bool p_active) { active = p_active; }
+	_FORCE_INLINE_ bool is_active() const { return active; }
+
+	void set_mesh(const REF &p_mesh);
+	void set_transform(const Transform &p_transform);
+	void set_linear_velocity(const Vector3 &p_velocity);
+	Vector3 get_linear_velocity() const;
+
+	void set_simulation_precision(int p_precision);
+	_FORCE_INLINE_ int get_simulation_precision() const { return simulation_precision; }
+
+	void set_total_mass(real_t p_mass);
+	_FORCE_INLINE_ real_t get_total_mass() const { return total_mass; }
+
+	_FORCE_INLINE_ void set_linear_stiffness(real_t p_stiffness) { linear_stiffness = CLAMP(p_stiffness, 0, 1); }
+	_FORCE_INLINE_ real_t get_linear_stiffness() const { return linear_stiffness; }
+
+	_FORCE_INLINE_ void set_areaAngular_stiffness(real_t p_stiffness) { areaAngular_stiffness = CLAMP(p_stiffness, 0, 1); }
+	_FORCE_INLINE_ real_t get_areaAngular_stiffness() const { return areaAngular_stiffness; }
+
+	_FORCE_INLINE_ void set_volume_stiffness(real_t p_stiffness) { volume_stiffness = CLAMP(p_stiffness, 0, 1); }
+	_FORCE_INLINE_ real_t get_volume_stiffness() const { return volume_stiffness; }
+
+	_FORCE_INLINE_ void set_pressure_coefficient(real_t p_coefficient) { pressure_coefficient = p_coefficient; }
+	_FORCE_INLINE_ real_t get_pressure_coefficient() const { return pressure_coefficient; }
+
+	_FORCE_INLINE_ void set_pose_matching_coefficient(real_t p_coefficient) { pose_matching_coefficient = p_coefficient; }
+	_FORCE_INLINE_ real_t get_pose_matching_coefficient() const { return pose_matching_coefficient; }
+
+	_FORCE_INLINE_ void set_damping_coefficient(real_t p_coefficient) { damping_coefficient = CLAMP(p_coefficient, 0, 1); }
+	_FORCE_INLINE_ real_t get_damping_coefficient() const { return damping_coefficient; }
+
+	_FORCE_INLINE_ void set_drag_coefficient(real_t p_coefficient) { drag_coefficient = CLAMP(p_coefficient, 0, 1); }
+	_FORCE_INLINE_ real_t get_drag_coefficient() const { return drag_coefficient; }
+
+	_FORCE_INLINE_ int get_point_count() const { return positions.size(); }
+	_FORCE_INLINE_ const AABB &get_aabb() const { return aabb; }
+
+	void set_point_position(int p_index, const Vector3 &p_position);
+	Vector3 get_point_position(int p_index) const;
+	Vector3 get_point_offset(int p_index) const;
+
+	void pin_point(int p_index, bool p_pin);
+	bool is_point_pinned(int p_index) const;
+	void remove_all_pinned_points();
+
+	void update_visual_server(class SoftBodyVisualServerHandler *p_visual_server_handler);
+
+	void step(real_t p_delta, ThreadWorkPool *p_work_pool);
+
+	SoftBodySW();
+	~SoftBodySW();
+};
+
+#endif // SOFT_BODY_SW_H
@@ -31,6 +31,8 @@
 #include "space_sw.h"
 
 #include "collision_solver_sw.h"
+#include "core/local_vector.h"
+#include "core/os/os.h"
 #include "core/project_settings.h"
 #include "physics_server_sw.h"
 
@@ -93,6 +95,28 @@ int PhysicsDirectSpaceStateSW::intersect_point(const Vector3 &p_point, ShapeResu
 	return cc;
 }
 
+// Segment against a single shape of an object, point and normal are returned in world space.
+_FORCE_INLINE_ static bool _intersect_ray_shape(const CollisionObjectSW *p_object, int p_shape_idx, const Vector3 &p_from, const Vector3 &p_to, Vector3 &r_point, Vector3 &r_normal) {
+
+	Transform inv_xform = p_object->get_shape_inv_transform(p_shape_idx) * p_object->get_inv_transform();
+
+	Vector3 local_from = inv_xform.xform(p_from);
+	Vector3 local_to = inv_xform.xform(p_to);
+
+	const ShapeSW *shape = p_object->get_shape(p_shape_idx);
+
+	Vector3 shape_point, shape_normal;
+
+	if (!shape->intersect_segment(local_from, local_to, shape_point, shape_normal))
+		return false;
+
+	Transform xform = p_object->get_transform() * p_object->get_shape_transform(p_shape_idx);
+	r_point = xform.xform(shape_point);
+	r_normal = inv_xform.basis.xform_inv(shape_normal).normalized();
+
+	return true;
+}
+
 bool PhysicsDirectSpaceStateSW::intersect_ray(const Vector3 &p_from, const Vector3 &p_to, RayResult &r_result, const Set<RID> &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas, bool p_pick_ray) {
 
 	ERR_FAIL_COND_V(space->locked, false);
@@ -127,19 +151,10 @@ bool PhysicsDirectSpaceStateSW::intersect_ray(const Vector3 &p_from, const Vecto
 		const CollisionObjectSW *col_obj = space->intersection_query_results[i];
 
 		int shape_idx = space->intersection_query_subindex_results[i];
-		Transform inv_xform = col_obj->get_shape_inv_transform(shape_idx) * col_obj->get_inv_transform();
-
-		Vector3 local_from = inv_xform.xform(begin);
-		Vector3 local_to = inv_xform.xform(end);
-
-		const ShapeSW *shape = col_obj->get_shape(shape_idx);
 
 		Vector3 shape_point, shape_normal;
 
-		if (shape->intersect_segment(local_from, local_to, shape_point, shape_normal)) {
-
-			Transform xform = col_obj->get_transform() * col_obj->get_shape_transform(shape_idx);
-			shape_point = xform.xform(shape_point);
+		if (_intersect_ray_shape(col_obj, shape_idx, begin, end, shape_point, shape_normal)) {
 
 			real_t ld = normal.dot(shape_point);
 
@@ -147,7 +162,7 @@ bool PhysicsDirectSpaceStateSW::intersect_ray(const Vector3 &p_from, const Vecto
 
 				min_d = ld;
 				res_point = shape_point;
-				res_normal = inv_xform.basis.xform_inv(shape_normal).normalized();
+				res_normal = shape_normal;
 				res_shape = shape_idx;
 				res_obj = col_obj;
 				collided = true;
@@ -176,7 +191,7 @@ int PhysicsDirectSpaceStateSW::intersect_shape(const RID &p_shape, const Transfo
 	if (p_result_max <= 0)
 		return 0;
 
-	ShapeSW *shape = static_cast<PhysicsServerSW *>(PhysicsServer::get_singleton())->shape_owner.get(p_shape);
+	ShapeSW *shape = PhysicsServerSW::singleton->shape_owner.get(p_shape);
 	ERR_FAIL_COND_V(!shape, 0);
 
 	AABB aabb = p_xform.xform(shape->get_aabb());
@@ -222,9 +237,67 @@ int PhysicsDirectSpaceStateSW::intersect_shape(const RID &p_shape, const Transfo
 	return cc;
 }
 
+// Finds how far along p_motion the shape can travel before touching a single
+// shape of an object. Returns false if it never touches it or starts inside it.
+static bool _cast_motion_shape(ShapeSW *p_shape, const Transform &p_xform, const Transform &p_xform_inv, const Vector3 &p_motion, const AABB &p_aabb, const CollisionObjectSW *p_object, int p_shape_idx, real_t &r_low, real_t &r_hi, Vector3 &r_point_A, Vector3 &r_point_B) {
+
+	MotionShapeSW mshape;
+	mshape.shape = p_shape;
+	mshape.motion = p_xform_inv.basis.xform(p_motion);
+
+	Vector3 sep_axis = p_motion.normalized();
+
+	const ShapeSW *col_shape = p_object->get_shape(p_shape_idx);
+	Transform col_obj_xform = p_object->get_transform() * p_object->get_shape_transform(p_shape_idx);
+	//test initial overlap, does it collide if going all the way?
+	if (CollisionSolverSW::solve_distance(&mshape, p_xform, col_shape, col_obj_xform, r_point_A, r_point_B, p_aabb, &sep_axis)) {
+		return false;
+	}
+
+	//test initial overlap, ignore objects it's inside of.
+	sep_axis = p_motion.normalized();
+
+	if (!CollisionSolverSW::solve_distance(p_shape, p_xform, col_shape, col_obj_xform, r_point_A, r_point_B, p_aabb, &sep_axis)) {
+		return false;
+	}
+
+	//just do kinematic solving
+	real_t low = 0;
+	real_t hi = 1;
+	Vector3 mnormal = p_motion.normalized();
+
+	for (int j = 0; j < 8; j++) { //steps should be customizable..
+
+		real_t ofs = (low + hi) * 0.5;
+
+		Vector3 sep = mnormal; //important optimization for this to work fast enough
+
+		mshape.motion = p_xform_inv.basis.xform(p_motion * ofs);
+
+		Vector3 lA, lB;
+
+		bool collided = !CollisionSolverSW::solve_distance(&mshape, p_xform, col_shape, col_obj_xform, lA, lB, p_aabb, &sep);
+
+		if (collided) {
+
+			hi = ofs;
+		} else {
+
+			r_point_A = lA;
+			r_point_B = lB;
+			low = ofs;
+		}
+	}
+
+	r_low = low;
+	r_hi = hi;
+
+	return true;
+}
+
 bool PhysicsDirectSpaceStateSW::cast_motion(const RID &p_shape, const Transform &p_xform, const Vector3 &p_motion, real_t p_margin, real_t &p_closest_safe, real_t &p_closest_unsafe, const Set<RID> &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas, ShapeRestInfo *r_info) {
 
-	ShapeSW *shape = static_cast<PhysicsServerSW *>(PhysicsServer::get_singleton())->shape_owner.get(p_shape);
+	ShapeSW *shape = PhysicsServerSW::singleton->shape_owner.get(p_shape);
 	ERR_FAIL_COND_V(!shape, false);
 
 	AABB aabb = p_xform.xform(shape->get_aabb());
@@ -237,9 +310,6 @@ bool PhysicsDirectSpaceStateSW::cast_motion(const RID &p_shape, const Transform
 	real_t best_unsafe = 1;
 
 	Transform xform_inv = p_xform.affine_inverse();
-	MotionShapeSW mshape;
-	mshape.shape = shape;
-	mshape.motion = xform_inv.basis.xform(p_motion);
 
 	bool best_first = true;
 
@@ -257,48 +327,10 @@ bool PhysicsDirectSpaceStateSW::cast_motion(const RID &p_shape, const Transform
 		int shape_idx = space->intersection_query_subindex_results[i];
 
 		Vector3 point_A, point_B;
-		Vector3 sep_axis = p_motion.normalized();
+		real_t low, hi;
 
-		Transform col_obj_xform = col_obj->get_transform() * col_obj->get_shape_transform(shape_idx);
-		//test initial overlap, does it collide if going all the way?
-		if (CollisionSolverSW::solve_distance(&mshape, p_xform, col_obj->get_shape(shape_idx), col_obj_xform, point_A, point_B, aabb, &sep_axis)) {
+		if (!_cast_motion_shape(shape, p_xform, xform_inv, p_motion, aabb, col_obj, shape_idx, low, hi, point_A, point_B))
 			continue;
-		}
-
-		//test initial overlap, ignore objects it's inside of.
-		sep_axis = p_motion.normalized();
-
-		if (!CollisionSolverSW::solve_distance(shape, p_xform, col_obj->get_shape(shape_idx), col_obj_xform, point_A, point_B, aabb, &sep_axis)) {
-			continue;
-		}
-
-		//just do kinematic solving
-		real_t low = 0;
-		real_t hi = 1;
-		Vector3 mnormal = p_motion.normalized();
-
-		for (int j = 0; j < 8; j++) { //steps should be customizable..
-
-			real_t ofs = (low + hi) * 0.5;
-
-			Vector3 sep = mnormal; //important optimization for this to work fast enough
-
-			mshape.motion = xform_inv.basis.xform(p_motion * ofs);
-
-			Vector3 lA, lB;
-
-			bool collided = !CollisionSolverSW::solve_distance(&mshape, p_xform, col_obj->get_shape(shape_idx), col_obj_xform, lA, lB, aabb, &sep);
-
-			if (collided) {
-
-				hi = ofs;
-			} else {
-
-				point_A = lA;
-				point_B = lB;
-				low = ofs;
-			}
-		}
 
 		if (low < best_safe) {
 			best_first = true; //force reset
@@ -334,7 +366,7 @@ bool PhysicsDirectSpaceStateSW::collide_shape(RID p_shape, const Transform &p_sh
 	if (p_result_max <= 0)
 		return 0;
 
-	ShapeSW *shape = static_cast<PhysicsServerSW *>(PhysicsServer::get_singleton())->shape_owner.get(p_shape);
+	ShapeSW *shape = PhysicsServerSW::singleton->shape_owner.get(p_shape);
 	ERR_FAIL_COND_V(!shape, 0);
 
 	AABB aabb = p_shape_xform.xform(shape->get_aabb());
@@ -407,9 +439,33 @@ static void _rest_cbk_result(const Vector3 &p_point_A, const Vector3 &p_point_B,
 	rd->best_shape = rd->shape;
 	rd->best_local_shape = rd->local_shape;
 }
+
+static bool _rest_info_result(const _RestCallbackData &p_rcd, PhysicsDirectSpaceState::ShapeRestInfo *r_info) {
+
+	if (p_rcd.best_len == 0 || !p_rcd.best_object)
+		return false;
+
+	r_info->collider_id = p_rcd.best_object->get_instance_id();
+	r_info->shape = p_rcd.best_shape;
+	r_info->normal = p_rcd.best_normal;
+	r_info->point = p_rcd.best_contact;
+	r_info->rid = p_rcd.best_object->get_self();
+	if (p_rcd.best_object->get_type() == CollisionObjectSW::TYPE_BODY) {
+
+		const BodySW *body = static_cast<const BodySW *>(p_rcd.best_object);
+		Vector3 rel_vec = p_rcd.best_contact - (body->get_transform().origin + body->get_center_of_mass());
+		r_info->linear_velocity = body->get_linear_velocity() + (body->get_angular_velocity()).cross(rel_vec);
+
+	} else {
+		r_info->linear_velocity = Vector3();
+	}
+
+	return true;
+}
+
 bool PhysicsDirectSpaceStateSW::rest_info(RID p_shape, const Transform &p_shape_xform, real_t p_margin, ShapeRestInfo *r_info, const Set<RID> &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas) {
 
-	ShapeSW *shape = static_cast<PhysicsServerSW *>(PhysicsServer::get_singleton())->shape_owner.get(p_shape);
+	ShapeSW *shape = PhysicsServerSW::singleton->shape_owner.get(p_shape);
 	ERR_FAIL_COND_V(!shape, 0);
 
 	AABB aabb = p_shape_xform.xform(shape->get_aabb());
@@ -441,25 +497,7 @@ bool PhysicsDirectSpaceStateSW::rest_info(RID p_shape, const Transform &p_shape_
 			continue;
 	}
 
-	if (rcd.best_len == 0 || !rcd.best_object)
-		return false;
-
-	r_info->collider_id = rcd.best_object->get_instance_id();
-	r_info->shape = rcd.best_shape;
-	r_info->normal = rcd.best_normal;
-	r_info->point = rcd.best_contact;
-	r_info->rid = rcd.best_object->get_self();
-	if (rcd.best_object->get_type() == CollisionObjectSW::TYPE_BODY) {
-
-		const BodySW *body = static_cast<const BodySW *>(rcd.best_object);
-		Vector3 rel_vec = rcd.best_contact - (body->get_transform().origin + body->get_center_of_mass());
-		r_info->linear_velocity = body->get_linear_velocity() + (body->get_angular_velocity()).cross(rel_vec);
-
-	} else {
-		r_info->linear_velocity = Vector3();
-	}
-
-	return true;
+	return _rest_info_result(rcd, r_info);
 }
 
 Vector3 PhysicsDirectSpaceStateSW::get_closest_point_to_object_volume(RID p_object, const Vector3 p_point) const {
@@ -503,6 +541,441 @@ Vector3 PhysicsDirectSpaceStateSW::get_closest_point_to_object_volume(RID p_obje
 	}
 }
 
+/* Batched queries */
+
+// Queries are sorted along a Morton curve so neighbouring ones end up in the
+// same chunk. The broadphase is culled once per chunk, and each query of the
+// chunk only runs the narrow phase against the candidates overlapping it.
+
+#define BATCH_CHUNK_MAX 32
+
+struct _BatchQuerySW {
+
+	AABB aabb;
+	uint32_t code;
+	int index;
+
+	_FORCE_INLINE_ bool operator<(const _BatchQuerySW &p_query) const { return code < p_query.code; }
+};
+
+struct _BatchCandidateSW {
+
+	const CollisionObjectSW *object;
+	int shape;
+	AABB aabb;
+};
+
+struct _BatchChunkSW {
+
+	int query_from;
+	int query_to;
+	int candidate_from;
+	int candidate_to;
+};
+
+struct _BatchSW {
+
+	LocalVector<_BatchQuerySW> queries;
+	LocalVector<_BatchChunkSW> chunks;
+	LocalVector<_BatchCandidateSW> candidates;
+};
+
+_FORCE_INLINE_ static uint32_t _batch_morton_spread(uint32_t p_value) {
+
+	p_value &= 0x3FF;
+	p_value = (p_value | (p_value << 16)) & 0x030000FF;
+	p_value = (p_value | (p_value << 8)) & 0x0300F00F;
+	p_value = (p_value | (p_value << 4)) & 0x030C30C3;
+	p_value = (p_value | (p_value << 2)) & 0x09249249;
+	return p_value;
+}
+
+_FORCE_INLINE_ static bool _batch_is_excluded(const RID *p_exclude, int p_exclude_count, const RID &p_rid) {
+
+	int low = 0;
+	int high = p_exclude_count - 1;
+
+	while (low <= high) {
+
+		int middle = (low + high) / 2;
+		if (p_exclude[middle] == p_rid)
+			return true;
+		if (p_exclude[middle] < p_rid)
+			low = middle + 1;
+		else
+			high = middle - 1;
+	}
+
+	return false;
+}
+
+void PhysicsDirectSpaceStateSW::_batch_cull(_BatchSW &r_batch, const RID *p_exclude, int p_exclude_count, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas) {
+
+	int query_count = r_batch.queries.size();
+	if (query_count == 0)
+		return;
+
+	AABB bounds(r_batch.queries[0].aabb.position + r_batch.queries[0].aabb.size * 0.5, Vector3());
+	for (int i = 1; i < query_count; i++) {
+		bounds.expand_to(r_batch.queries[i].aabb.position + r_batch.queries[i].aabb.size * 0.5);
+	}
+
+	Vector3 scale;
+	for (int i = 0; i < 3; i++) {
+		scale[i] = bounds.size[i] > CMP_EPSILON ? 1023.0 / bounds.size[i] : 0.0;
+	}
+
+	for (int i = 0; i < query_count; i++) {
+
+		_BatchQuerySW &query = r_batch.queries[i];
+		Vector3 cell = (query.aabb.position + query.aabb.size * 0.5 - bounds.position) * scale;
+		query.code = _batch_morton_spread(cell.x) | (_batch_morton_spread(cell.y) << 1) | (_batch_morton_spread(cell.z) << 2);
+	}
+
+	r_batch.queries.sort();
+
+	int from = 0;
+
+	while (from < query_count) {
+
+		int to = MIN(from + BATCH_CHUNK_MAX, query_count);
+		int amount;
+
+		while (true) {
+
+			AABB chunk_aabb = r_batch.queries[from].aabb;
+			for (int i = from + 1; i < to; i++) {
+				chunk_aabb.merge_with(r_batch.queries[i].aabb);
+			}
+
+			amount = space->broadphase->cull_aabb(chunk_aabb, space->intersection_query_results, SpaceSW::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+
+			// too spread out to share a cull, split the chunk
+			if (amount < SpaceSW::INTERSECTION_QUERY_MAX || to - from == 1)
+				break;
+
+			to = from + (to - from) / 2;
+		}
+
+		_BatchChunkSW chunk;
+		chunk.query_from = from;
+		chunk.query_to = to;
+		chunk.candidate_from = r_batch.candidates.size();
+
+		for (int i = 0; i < amount; i++) {
+
+			const CollisionObjectSW *col_obj = space->intersection_query_results[i];
+
+			if (!_can_collide_with(space->intersection_query_results[i], p_collision_mask, p_collide_with_bodies, p_collide_with_areas))
+				continue;
+
+			if (_batch_is_excluded(p_exclude, p_exclude_count, col_obj->get_self()))
+				continue;
+
+			_BatchCandidateSW candidate;
+			candidate.object = col_obj;
+			candidate.shape = space->intersection_query_subindex_results[i];
+			candidate.aabb = col_obj->get_shape_aabb(candidate.shape);
+			r_batch.candidates.push_back(candidate);
+		}
+
+		chunk.candidate_to = r_batch.candidates.size();
+		r_batch.chunks.push_back(chunk);
+
+		from = to;
+	}
+}
+
+// p_server is only given when the batch may run threaded.
+template <class T, class S>
+static void _batch_solve(T *p_solver, const _BatchSW &p_batch, S *p_server) {
+
+	uint32_t chunk_count = p_batch.chunks.size();
+
+	ThreadWorkPool *work_pool = NULL;
+	if (p_server && chunk_count > 1) {
+		// NULL if another batch is already using the pool, run on this thread then
+		work_pool = p_server->lock_query_work_pool();
+	}
+
+	if (work_pool) {
+		work_pool->do_work(chunk_count, p_solver, &T::solve_chunk, &p_batch);
+		p_server->unlock_query_work_pool();
+	} else {
+		for (uint32_t i = 0; i < chunk_count; i++) {
+			p_solver->solve_chunk(i, &p_batch);
+		}
+	}
+}
+
+struct _RayBatchSolverSW {
+
+	const Vector3 *from;
+	const Vector3 *to;
+	PhysicsDirectSpaceState::RayResult *results;
+	bool *collided;
+
+	void solve_chunk(uint32_t p_chunk, const _BatchSW *p_batch) {
+
+		const _BatchChunkSW &chunk = p_batch->chunks[p_chunk];
+
+		for (int i = chunk.query_from; i < chunk.query_to; i++) {
+
+			int index = p_batch->queries[i].index;
+			const Vector3 &begin = from[index];
+			const Vector3 &end = to[index];
+			Vector3 normal = (end - begin).normalized();
+
+			real_t min_d = 1e10;
+			PhysicsDirectSpaceState::RayResult &result = results[index];
+			collided[index] = false;
+
+			for (int j = chunk.candidate_from; j < chunk.candidate_to; j++) {
+
+				const _BatchCandidateSW &candidate = p_batch->candidates[j];
+
+				if (!candidate.aabb.intersects_segment(begin, end))
+					continue;
+
+				Vector3 shape_point, shape_normal;
+
+				if (!_intersect_ray_shape(candidate.object, candidate.shape, begin, end, shape_point, shape_normal))
+					continue;
+
+				real_t ld = normal.dot(shape_point);
+
+				if (ld < min_d) {
+
+					min_d = ld;
+					result.position = shape_point;
+					result.normal = shape_normal;
+					result.rid = candidate.object->get_self();
+					result.collider_id = candidate.object->get_instance_id();
+					result.shape = candidate.shape;
+					collided[index] = true;
+				}
+			}
+		}
+	}
+};
+
+int PhysicsDirectSpaceStateSW::intersect_ray_batch(const Vector3 *p_from, const Vector3 *p_to, int p_count, RayResult *r_results, bool *r_collided, const RID *p_exclude, int p_exclude_count, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas, bool p_threaded) {
+
+	// report "no hit" for every query, including when failing below
+	for (int i = 0; i < p_count; i++) {
+		r_collided[i] = false;
+	}
+
+	ERR_FAIL_COND_V(space->locked, 0);
+
+	_BatchSW batch;
+	batch.queries.resize(p_count);
+
+	for (int i = 0; i < p_count; i++) {
+
+		AABB aabb(p_from[i], Vector3());
+		aabb.expand_to(p_to[i]);
+		batch.queries[i].aabb = aabb;
+		batch.queries[i].index = i;
+	}
+
+	_batch_cull(batch, p_exclude, p_exclude_count, p_collision_mask, p_collide_with_bodies, p_collide_with_areas);
+
+	_RayBatchSolverSW solver;
+	solver.from = p_from;
+	solver.to = p_to;
+	solver.results = r_results;
+	solver.collided = r_collided;
+
+	_batch_solve(&solver, batch, p_threaded ? PhysicsServerSW::singleton : NULL);
+
+	int collided = 0;
+	for (int i = 0; i < p_count; i++) {
+
+		if (!r_collided[i])
+			continue;
+
+		// ObjectDB is looked up here rather than from the worker threads
+		r_results[i].collider = r_results[i].collider_id != 0 ? ObjectDB::get_instance(r_results[i].collider_id) : NULL;
+		collided++;
+	}
+
+	return collided;
+}
+
+struct _CastMotionBatchSolverSW {
+
+	ShapeSW *shape;
+	const Transform *xforms;
+	const Vector3 *motions;
+	float *closest_safe;
+	float *closest_unsafe;
+
+	void solve_chunk(uint32_t p_chunk, const _BatchSW *p_batch) {
+
+		const _BatchChunkSW &chunk = p_batch->chunks[p_chunk];
+
+		for (int i = chunk.query_from; i < chunk.query_to; i++) {
+
+			const _BatchQuerySW &query = p_batch->queries[i];
+			int index = query.index;
+
+			Transform xform_inv = xforms[index].affine_inverse();
+			real_t best_safe = 1;
+			real_t best_unsafe = 1;
+
+			for (int j = chunk.candidate_from; j < chunk.candidate_to; j++) {
+
+				const _BatchCandidateSW &candidate = p_batch->candidates[j];
+
+				if (!candidate.aabb.intersects(query.aabb))
+					continue;
+
+				Vector3 point_A, point_B;
+				real_t low, hi;
+
+				if (!_cast_motion_shape(shape, xforms[index], xform_inv, motions[index], query.aabb, candidate.object, candidate.shape, low, hi, point_A, point_B))
+					continue;
+
+				if (low < best_safe) {
+					best_safe = low;
+					best_unsafe = hi;
+				}
+			}
+
+			closest_safe[index] = best_safe;
+			closest_unsafe[index] = best_unsafe;
+		}
+	}
+};
+
+int PhysicsDirectSpaceStateSW::cast_motion_batch(const RID &p_shape, const Transform *p_xforms, const Vector3 *p_motions, int p_count, float p_margin, float *r_closest_safe, float *r_closest_unsafe, const RID *p_exclude, int p_exclude_count, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas, bool p_threaded) {
+
+	for (int i = 0; i < p_count; i++) {
+		r_closest_safe[i] = 1.0;
+		r_closest_unsafe[i] = 1.0;
+	}
+
+	ShapeSW *shape = PhysicsServerSW::singleton->shape_owner.get(p_shape);
+	ERR_FAIL_COND_V(!shape, 0);
+	ERR_FAIL_COND_V(space->locked, 0);
+
+	_BatchSW batch;
+	batch.queries.resize(p_count);
+
+	AABB shape_aabb = shape->get_aabb();
+
+	for (int i = 0; i < p_count; i++) {
+
+		AABB aabb = p_xforms[i].xform(shape_aabb);
+		aabb = aabb.merge(AABB(aabb.position + p_motions[i], aabb.size)); //motion
+		batch.queries[i].aabb = aabb.grow(p_margin);
+		batch.queries[i].index = i;
+	}
+
+	_batch_cull(batch, p_exclude, p_exclude_count, p_collision_mask, p_collide_with_bodies, p_collide_with_areas);
+
+	_CastMotionBatchSolverSW solver;
+	solver.shape = shape;
+	solver.xforms = p_xforms;
+	solver.motions = p_motions;
+	solver.closest_safe = r_closest_safe;
+	solver.closest_unsafe = r_closest_unsafe;
+
+	_batch_solve(&solver, batch, p_threaded ? PhysicsServerSW::singleton : NULL);
+
+	int collided = 0;
+	for (int i = 0; i < p_count; i++) {
+		if (r_closest_safe[i] < 1.0)
+			collided++;
+	}
+
+	return collided;
+}
+
+struct _RestInfoBatchSolverSW {
+
+	ShapeSW *shape;
+	const Transform *xforms;
+	real_t margin;
+	real_t min_allowed_depth;
+	PhysicsDirectSpaceState::ShapeRestInfo *infos;
+	bool *collided;
+
+	void solve_chunk(uint32_t p_chunk, const _BatchSW *p_batch) {
+
+		const _BatchChunkSW &chunk = p_batch->chunks[p_chunk];
+
+		for (int i = chunk.query_from; i < chunk.query_to; i++) {
+
+			const _BatchQuerySW &query = p_batch->queries[i];
+			int index = query.index;
+
+			_RestCallbackData rcd;
+			rcd.best_len = 0;
+			rcd.best_object = NULL;
+			rcd.best_shape = 0;
+			rcd.min_allowed_depth = min_allowed_depth;
+
+			for (int j = chunk.candidate_from; j < chunk.candidate_to; j++) {
+
+				const _BatchCandidateSW &candidate = p_batch->candidates[j];
+
+				if (!candidate.aabb.intersects(query.aabb))
+					continue;
+
+				rcd.object = candidate.object;
+				rcd.shape = candidate.shape;
+				CollisionSolverSW::solve_static(shape, xforms[index], candidate.object->get_shape(candidate.shape), candidate.object->get_transform() * candidate.object->get_shape_transform(candidate.shape), _rest_cbk_result, &rcd, NULL, margin);
+			}
+
+			collided[index] = _rest_info_result(rcd, &infos[index]);
+		}
+	}
+};
+
+int PhysicsDirectSpaceStateSW::rest_info_batch(RID p_shape, const Transform *p_shape_xforms, int p_count, float p_margin, ShapeRestInfo *r_infos, bool *r_collided, const RID *p_exclude, int p_exclude_count, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas, bool p_threaded) {
+
+	for (int i = 0; i < p_count; i++) {
+		r_collided[i] = false;
+	}
+
+	ShapeSW *shape = PhysicsServerSW::singleton->shape_owner.get(p_shape);
+	ERR_FAIL_COND_V(!shape, 0);
+	ERR_FAIL_COND_V(space->locked, 0);
+
+	_BatchSW batch;
+	batch.queries.resize(p_count);
+
+	AABB shape_aabb = shape->get_aabb();
+
+	for (int i = 0; i < p_count; i++) {
+
+		batch.queries[i].aabb = p_shape_xforms[i].xform(shape_aabb).grow(p_margin);
+		batch.queries[i].index = i;
+	}
+
+	_batch_cull(batch, p_exclude, p_exclude_count, p_collision_mask, p_collide_with_bodies, p_collide_with_areas);
+
+	_RestInfoBatchSolverSW solver;
+	solver.shape = shape;
+	solver.xforms = p_shape_xforms;
+	solver.margin = p_margin;
+	solver.min_allowed_depth = space->test_motion_min_contact_depth;
+	solver.infos = r_infos;
+	solver.collided = r_collided;
+
+	_batch_solve(&solver, batch, p_threaded ? PhysicsServerSW::singleton : NULL);
+
+	int collided = 0;
+	for (int i = 0; i < p_count; i++) {
+		if (r_collided[i])
+			collided++;
+	}
+
+	return collided;
+}
+
 PhysicsDirectSpaceStateSW::PhysicsDirectSpaceStateSW() {
 
 	space = NULL;
@@ -512,6 +985,22 @@ PhysicsDirectSpaceStateSW::PhysicsDirectSpaceStateSW() {
 
 int SpaceSW::_cull_aabb_for_body(BodySW *p_body, const AABB &p_aabb) {
 
+	if (p_body == motion_batch_body && motion_batch_aabb.encloses(p_aabb)) {
+
+		// The candidates are already filtered, only the ones touching the smaller box are left to pick.
+		int amount = 0;
+		for (uint32_t i = 0; i < motion_batch_objects.size(); i++) {
+
+			if (motion_batch_objects[i]->get_shape_aabb(motion_batch_subindices[i]).intersects(p_aabb)) {
+				intersection_query_results[amount] = motion_batch_objects[i];
+				intersection_query_subindex_results[amount] = motion_batch_subindices[i];
+				amount++;
+			}
+		}
+
+		return amount;
+	}
+
 	int amount = broadphase->cull_aabb(p_aabb, intersection_query_results, INTERSECTION_QUERY_MAX, intersection_query_subindex_results);
 
 	for (int i = 0; i < amount; i++) {
@@ -544,6 +1033,57 @@ int SpaceSW::_cull_aabb_for_body(BodySW *p_body, const AABB &p_aabb) {
 	return amount;
 }
 
+void SpaceSW::begin_motion_batch(BodySW *p_body, const Transform &p_from, real_t p_max_distance, real_t p_margin) {
+
+	motion_batch_body = NULL;
+
+	AABB body_aabb;
+	bool shapes_found = false;
+
+	for (int i = 0; i < p_body->get_shape_count(); i++) {
+
+		if (p_body->is_shape_set_as_disabled(i))
+			continue;
+
+		if (!shapes_found) {
+			body_aabb = p_body->get_shape_aabb(i);
+			shapes_found = true;
+		} else {
+			body_aabb = body_aabb.merge(p_body->get_shape_aabb(i));
+		}
+	}
+
+	if (!shapes_found) {
+		return;
+	}
+
+	// Every position the body can slide to lies within the distance, as sliding only shortens the motion left.
+	body_aabb = p_from.xform(p_body->get_inv_transform().xform(body_aabb));
+	body_aabb = body_aabb.grow(p_max_distance + p_margin * 2.0);
+
+	int amount = _cull_aabb_for_body(p_body, body_aabb);
+	if (amount == INTERSECTION_QUERY_MAX) {
+		return; // some may be missing, don't share them
+	}
+
+	motion_batch_objects.resize(amount);
+	motion_batch_subindices.resize(amount);
+	for (int i = 0; i < amount; i++) {
+		motion_batch_objects[i] = intersection_query_results[i];
+		motion_batch_subindices[i] = intersection_query_subindex_results[i];
+	}
+
+	motion_batch_aabb = body_aabb;
+	motion_batch_body = p_body;
+}
+
+void SpaceSW::end_motion_batch(BodySW *p_body) {
+
+	if (motion_batch_body == p_body) {
+		motion_batch_body = NULL;
+	}
+}
+
 int SpaceSW::test_body_ray_separation(BodySW *p_body, const Transform &p_transform, bool p_infinite_inertia, Vector3 &r_recover_motion, PhysicsServer::SeparationResult *r_results, int p_result_max, real_t p_margin) {
 
 	AABB body_aabb;
@@ -1022,7 +1562,7 @@ bool SpaceSW::test_body_motion(BodySW *p_body, const Transform &p_from, const Ve
 	return collided;
 }
 
-void *SpaceSW::_broadphase_pair(CollisionObjectSW *A, int p_subindex_A, CollisionObjectSW *B, int p_subindex_B, void *p_self) {
+void *SpaceSW::_create_pair(CollisionObjectSW *A, int p_subindex_A, CollisionObjectSW *B, int p_subindex_B) {
 	if (!A->test_collision_mask(B)) {
 		return nullptr;
 	}
@@ -1036,9 +1576,7 @@ void *SpaceSW::_broadphase_pair(CollisionObjectSW *A, int p_subindex_A, Collisio
 		SWAP(type_A, type_B);
 	}
 
-	SpaceSW *self = (SpaceSW *)p_self;
-
-	self->collision_pairs++;
+	collision_pairs++;
 
 	if (type_A == CollisionObjectSW::TYPE_AREA) {
 
@@ -1056,6 +1594,13 @@ void *SpaceSW::_broadphase_pair(CollisionObjectSW *A, int p_subindex_A, Collisio
 		}
 	} else {
 
+		// the order of the bodies must not depend on the broadphase, a pair that is
+		// created again after restoring a snapshot has to solve exactly the same way
+		if (A->get_self().get_id() > B->get_self().get_id()) {
+			SWAP(A, B);
+			SWAP(p_subindex_A, p_subindex_B);
+		}
+
 		BodyPairSW *b = memnew(BodyPairSW((BodySW *)A, p_subindex_A, (BodySW *)B, p_subindex_B));
 		return b;
 	}
@@ -1063,15 +1608,26 @@ void *SpaceSW::_broadphase_pair(CollisionObjectSW *A, int p_subindex_A, Collisio
 	return NULL;
 }
 
+void *SpaceSW::_broadphase_pair(CollisionObjectSW *A, int p_subindex_A, CollisionObjectSW *B, int p_subindex_B, void *p_self) {
+
+	SpaceSW *self = (SpaceSW *)p_self;
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	void *pair = self->_create_pair(A, p_subindex_A, B, p_subindex_B);
+	self->pair_generation_time += OS::get_singleton()->get_ticks_usec() - begin;
+	return pair;
+}
+
 void SpaceSW::_broadphase_unpair(CollisionObjectSW *A, int p_subindex_A, CollisionObjectSW *B, int p_subindex_B, void *p_data, void *p_self) {
 	if (!p_data) {
 		return;
 	}
 
 	SpaceSW *self = (SpaceSW *)p_self;
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
 	self->collision_pairs--;
 	ConstraintSW *c = (ConstraintSW *)p_data;
 	memdelete(c);
+	self->pair_generation_time += OS::get_singleton()->get_ticks_usec() - begin;
 }
 
 const SelfList<BodySW>::List &SpaceSW::get_active_body_list() const {
@@ -1106,12 +1662,14 @@ void SpaceSW::add_object(CollisionObjectSW *p_object) {
 
 	ERR_FAIL_COND(objects.has(p_object));
 	objects.insert(p_object);
+	object_broadphase_changed(p_object);
 }
 
 void SpaceSW::remove_object(CollisionObjectSW *p_object) {
 
 	ERR_FAIL_COND(!objects.has(p_object));
 	objects.erase(p_object);
+	motion_batch_body = NULL;
 }
 
 const Set<CollisionObjectSW *> &SpaceSW::get_objects() const {
@@ -1152,6 +1710,21 @@ const SelfList<AreaSW>::List &SpaceSW::get_moved_area_list() const {
 	return area_moved_list;
 }
 
+void SpaceSW::soft_body_add_to_list(SelfList<SoftBodySW> *p_soft_body) {
+
+	soft_body_list.add(p_soft_body);
+}
+
+void SpaceSW::soft_body_remove_from_list(SelfList<SoftBodySW> *p_soft_body) {
+
+	soft_body_list.remove(p_soft_body);
+}
+
+const SelfList<SoftBodySW>::List &SpaceSW::get_soft_body_list() const {
+
+	return soft_body_list;
+}
+
 void SpaceSW::call_queries() {
 
 	while (state_query_list.first()) {
@@ -1161,6 +1734,8 @@ void SpaceSW::call_queries() {
 		b->call_queries();
 	}
 
+	state_sync_queue.flush();
+
 	while (monitor_query_list.first()) {
 
 		AreaSW *a = monitor_query_list.first()->self();
@@ -1172,6 +1747,7 @@ void SpaceSW::call_queries() {
 void SpaceSW::setup() {
 
 	contact_debug_count = 0;
+	pair_generation_time = 0;
 	while (inertia_update_list.first()) {
 		inertia_update_list.first()->self()->update_inertias();
 		inertia_update_list.remove(inertia_update_list.first());
@@ -1231,6 +1807,234 @@ bool SpaceSW::is_locked() const {
 	return locked;
 }
 
+// Snapshot layout: a header, then one record per body (active bodies first, in the
+// order they are simulated) and one record per constraint with state to carry over,
+// identified by its first body and its sort key. Records are prefixed with their size
+// so bodies and constraints that no longer exist when restoring are skipped.
+
+#define SNAPSHOT_MAGIC 0x50534447 // "GDSP"
+#define SNAPSHOT_VERSION 1
+
+PoolVector<uint8_t> SpaceSW::get_snapshot() {
+
+	ERR_FAIL_COND_V_MSG(locked, PoolVector<uint8_t>(), "Space snapshots can't be taken while the space is being stepped.");
+
+	LocalVector<BodySW *> bodies;
+
+	for (const SelfList<BodySW> *b = active_list.first(); b; b = b->next()) {
+		bodies.push_back(b->self());
+	}
+
+	for (const Set<CollisionObjectSW *>::Element *E = objects.front(); E; E = E->next()) {
+		if (E->get()->get_type() == CollisionObjectSW::TYPE_BODY) {
+			BodySW *body = static_cast<BodySW *>(E->get());
+			if (!body->is_active()) {
+				bodies.push_back(body);
+			}
+		}
+	}
+
+	snapshot_writer.clear();
+	snapshot_writer.put(uint32_t(SNAPSHOT_MAGIC));
+	snapshot_writer.put(uint32_t(SNAPSHOT_VERSION));
+	snapshot_writer.put(uint32_t(sizeof(real_t)));
+	snapshot_writer.put(uint32_t(bodies.size()));
+
+	for (uint32_t i = 0; i < bodies.size(); i++) {
+
+		snapshot_writer.put(bodies[i]->get_self().get_id());
+		snapshot_writer.put(bodies[i]->is_active());
+
+		uint32_t size_ofs = snapshot_writer.get_position();
+		snapshot_writer.put(uint32_t(0));
+		bodies[i]->save_state(snapshot_writer);
+		snapshot_writer.put_at(size_ofs, snapshot_writer.get_position() - size_ofs - uint32_t(sizeof(uint32_t)));
+	}
+
+	uint32_t constraint_count_ofs = snapshot_writer.get_position();
+	uint32_t constraint_count = 0;
+	snapshot_writer.put(constraint_count);
+
+	for (uint32_t i = 0; i < bodies.size(); i++) {
+
+		for (const BodySW::ConstraintMap::Element *E = bodies[i]->get_constraint_map().front(); E; E = E->next()) {
+
+			if (E->get() != 0) {
+				continue; // stored once, with its first body
+			}
+
+			const ConstraintSW *c = E->key();
+			uint32_t record_ofs = snapshot_writer.get_position();
+			snapshot_writer.put(bodies[i]->get_self().get_id());
+			snapshot_writer.put(c->get_sort_key_high());
+			snapshot_writer.put(c->get_sort_key_low());
+
+			uint32_t size_ofs = snapshot_writer.get_position();
+			snapshot_writer.put(uint32_t(0));
+
+			if (!c->save_state(snapshot_writer)) {
+				snapshot_writer.rewind(record_ofs);
+				continue;
+			}
+
+			snapshot_writer.put_at(size_ofs, snapshot_writer.get_position() - size_ofs - uint32_t(sizeof(uint32_t)));
+			constraint_count++;
+		}
+	}
+
+	snapshot_writer.put_at(constraint_count_ofs, constraint_count);
+
+	return snapshot_writer.get_data();
+}
+
+Error SpaceSW::restore_snapshot(const PoolVector<uint8_t> &p_snapshot) {
+
+	ERR_FAIL_COND_V_MSG(locked, ERR_LOCKED, "Space snapshots can't be restored while the space is being stepped.");
+
+	PoolVector<uint8_t>::Read r = p_snapshot.read();
+	SnapshotReaderSW reader(r.ptr(), p_snapshot.size());
+
+	uint32_t magic = 0;
+	uint32_t version = 0;
+	uint32_t real_size = 0;
+	uint32_t body_count = 0;
+
+	reader.get(magic);
+	reader.get(version);
+	reader.get(real_size);
+	reader.get(body_count);
+
+	ERR_FAIL_COND_V_MSG(reader.has_failed() || magic != SNAPSHOT_MAGIC, ERR_FILE_CORRUPT, "Invalid space snapshot.");
+	ERR_FAIL_COND_V_MSG(version != SNAPSHOT_VERSION || real_size != sizeof(real_t), ERR_FILE_UNRECOGNIZED, "The space snapshot was created by a different build.");
+
+	HashMap<uint32_t, BodySW *> body_map;
+
+	for (const Set<CollisionObjectSW *>::Element *E = objects.front(); E; E = E->next()) {
+		if (E->get()->get_type() == CollisionObjectSW::TYPE_BODY) {
+			body_map[E->get()->get_self().get_id()] = static_cast<BodySW *>(E->get());
+		}
+	}
+
+	// validate the whole snapshot first, so a truncated one changes nothing
+
+	{
+		SnapshotReaderSW validate = reader;
+
+		for (uint32_t i = 0; i < body_count; i++) {
+
+			uint32_t id;
+			bool active;
+			uint32_t size = 0;
+			validate.get(id);
+			validate.get(active);
+			validate.get(size);
+			validate.skip(size);
+		}
+
+		uint32_t constraint_count = 0;
+		validate.get(constraint_count);
+
+		for (uint32_t i = 0; i < constraint_count; i++) {
+
+			uint32_t id;
+			uint64_t key;
+			uint32_t size = 0;
+			validate.get(id);
+			validate.get(key);
+			validate.get(key);
+			validate.get(size);
+			validate.skip(size);
+		}
+
+		ERR_FAIL_COND_V_MSG(validate.has_failed() || validate.get_position() != uint32_t(p_snapshot.size()), ERR_FILE_CORRUPT, "Invalid space snapshot.");
+	}
+
+	LocalVector<BodySW *> bodies;
+	LocalVector<bool> active;
+
+	for (uint32_t i = 0; i < body_count; i++) {
+
+		uint32_t id;
+		bool body_active;
+		uint32_t size;
+		reader.get(id);
+		reader.get(body_active);
+		reader.get(size);
+
+		SnapshotReaderSW body_reader = reader.read_block(size);
+
+		BodySW **body = body_map.getptr(id);
+		if (!body) {
+			continue; // removed from the space after the snapshot was taken
+		}
+
+		if ((*body)->load_state(body_reader)) {
+			bodies.push_back(*body);
+			active.push_back(body_active);
+		}
+	}
+
+	// the pairs the broadphase reports may depend on how objects moved before, check all of
+	// them again from the restored transforms so replays always start from the same pairs
+
+	for (Set<CollisionObjectSW *>::Element *E = objects.front(); E; E = E->next()) {
+		E->get()->recheck_broadphase_pairs();
+	}
+	broadphase->update();
+
+	// rebuild the active list in the order it had, as it decides the order in which islands are solved,
+	// new area pairs may have woken up kinematic bodies
+
+	for (uint32_t i = 0; i < bodies.size(); i++) {
+		bodies[i]->set_active(false);
+	}
+
+	for (int i = int(bodies.size()) - 1; i >= 0; i--) {
+		if (active[i]) {
+			bodies[i]->set_active(true);
+		}
+	}
+
+	for (uint32_t i = 0; i < bodies.size(); i++) {
+		for (BodySW::ConstraintMap::Element *E = bodies[i]->get_constraint_map().front(); E; E = E->next()) {
+			E->key()->clear_state();
+		}
+	}
+
+	uint32_t constraint_count;
+	reader.get(constraint_count);
+
+	for (uint32_t i = 0; i < constraint_count; i++) {
+
+		uint32_t id;
+		uint64_t key_high;
+		uint64_t key_low;
+		uint32_t size;
+		reader.get(id);
+		reader.get(key_high);
+		reader.get(key_low);
+		reader.get(size);
+
+		SnapshotReaderSW constraint_reader = reader.read_block(size);
+
+		BodySW **body = body_map.getptr(id);
+		if (!body) {
+			continue;
+		}
+
+		for (BodySW::ConstraintMap::Element *E = (*body)->get_constraint_map().front(); E; E = E->next()) {
+
+			ConstraintSW *c = E->key();
+			if (c->get_sort_key_high() == key_high && c->get_sort_key_low() == key_low) {
+				c->load_state(constraint_reader);
+				break;
+			}
+		}
+	}
+
+	return OK;
+}
+
 PhysicsDirectSpaceStateSW *SpaceSW::get_direct_state() {
 
 	return direct_access;
@@ -1238,6 +2042,7 @@ PhysicsDirectSpaceStateSW *SpaceSW::get_direct_state() {
 
 SpaceSW::SpaceSW() {
 
+	motion_batch_body = NULL;
 	collision_pairs = 0;
 	active_objects = 0;
 	island_count = 0;
@@ -1248,6 +2053,8 @@ SpaceSW::SpaceSW() {
 	contact_max_separation = 0.05;
 	contact_max_allowed_penetration = 0.01;
 	test_motion_min_contact_depth = 0.00001;
+	contact_warm_start_factor = GLOBAL_DEF("physics/3d/godot_physics/contact_warm_start_factor", 1.0);
+	ProjectSettings::get_singleton()->set_custom_property_info("physics/3d/godot_physics/contact_warm_start_factor", PropertyInfo(Variant::REAL, "physics/3d/godot_physics/contact_warm_start_factor", PROPERTY_HINT_RANGE, "0,1,0.01"));
 
 	constraint_bias = 0.01;
 	body_linear_velocity_sleep_threshold = GLOBAL_DEF("physics/3d/sleep_threshold_linear", 0.1);
@@ -1266,6 +2073,8 @@ SpaceSW::SpaceSW() {
 
 	for (int i = 0; i < ELAPSED_TIME_MAX; i++)
 		elapsed_time[i] = 0;
+	pair_generation_time = 0;
+	narrowphase_timed = false;
 }
 
 SpaceSW::~SpaceSW() {
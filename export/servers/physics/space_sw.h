@@ -38,13 +38,20 @@
 #include "broad_phase_sw.h"
 #include "collision_object_sw.h"
 #include "core/hash_map.h"
+#include "core/local_vector.h"
 #include "core/project_settings.h"
+#include "core/safe_refcount.h"
 #include "core/typedefs.h"
+#include "soft_body_sw.h"
+
+struct _BatchSW;
 
 class PhysicsDirectSpaceStateSW : public PhysicsDirectSpaceState {
 
 	GDCLASS(PhysicsDirectSpaceStateSW, PhysicsDirectSpaceState);
 
+	void _batch_cull(_BatchSW &r_batch, const RID *p_exclude, int p_exclude_count, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas);
+
 public:
 	SpaceSW *space;
 
@@ -56,6 +63,10 @@ public:
 	virtual bool rest_info(RID p_shape, const Transform &p_shape_xform, real_t p_margin, ShapeRestInfo *r_info, const Set<RID> &p_exclude = Set<RID>(), uint32_t p_collision_mask = 0xFFFFFFFF, bool p_collide_with_bodies = true, bool p_collide_with_areas = false);
 	virtual Vector3 get_closest_point_to_object_volume(RID p_object, const Vector3 p_point) const;
 
+	virtual int intersect_ray_batch(const Vector3 *p_from, const Vector3 *p_to, int p_count, RayResult *r_results, bool *r_collided, const RID *p_exclude = NULL, int p_exclude_count = 0, uint32_t p_collision_mask = 0xFFFFFFFF, bool p_collide_with_bodies = true, bool p_collide_with_areas = false, bool p_threaded = false);
+	virtual int cast_motion_batch(const RID &p_shape, const Transform *p_xforms, const Vector3 *p_motions, int p_count, float p_margin, float *r_closest_safe, float *r_closest_unsafe, const RID *p_exclude = NULL, int p_exclude_count = 0, uint32_t p_collision_mask = 0xFFFFFFFF, bool p_collide_with_bodies = true, bool p_collide_with_areas = false, bool p_threaded = false);
+	virtual int rest_info_batch(RID p_shape, const Transform *p_shape_xforms, int p_count, float p_margin, ShapeRestInfo *r_infos, bool *r_collided, const RID *p_exclude = NULL, int p_exclude_count = 0, uint32_t p_collision_mask = 0xFFFFFFFF, bool p_collide_with_bodies = true, bool p_collide_with_areas = false, bool p_threaded = false);
+
 	PhysicsDirectSpaceStateSW();
 };
 
@@ -68,12 +79,17 @@ public:
 		ELAPSED_TIME_SETUP_CONSTRAINTS,
 		ELAPSED_TIME_SOLVE_CONSTRAINTS,
 		ELAPSED_TIME_INTEGRATE_VELOCITIES,
+		ELAPSED_TIME_BROADPHASE,
+		ELAPSED_TIME_PAIR_GENERATION,
+		ELAPSED_TIME_NARROWPHASE,
 		ELAPSED_TIME_MAX
 
 	};
 
 private:
 	uint64_t elapsed_time[ELAPSED_TIME_MAX];
+	uint64_t pair_generation_time;
+	bool narrowphase_timed;
 
 	PhysicsDirectSpaceStateSW *direct_access;
 	RID self;
@@ -84,7 +100,11 @@ private:
 	SelfList<BodySW>::List state_query_list;
 	SelfList<AreaSW>::List monitor_query_list;
 	SelfList<AreaSW>::List area_moved_list;
+	SelfList<SoftBodySW>::List soft_body_list;
 
+	PhysicsServer::BodyStateSyncQueue state_sync_queue;
+
+	void *_create_pair(CollisionObjectSW *A, int p_subindex_A, CollisionObjectSW *B, int p_subindex_B);
 	static void *_broadphase_pair(CollisionObjectSW *A, int p_subindex_A, CollisionObjectSW *B, int p_subindex_B, void *p_self);
 	static void _broadphase_unpair(CollisionObjectSW *A, int p_subindex_A, CollisionObjectSW *B, int p_subindex_B, void *p_data, void *p_self);
 
@@ -95,6 +115,7 @@ private:
 	real_t contact_recycle_radius;
 	real_t contact_max_separation;
 	real_t contact_max_allowed_penetration;
+	real_t contact_warm_start_factor;
 	real_t constraint_bias;
 	real_t test_motion_min_contact_depth;
 
@@ -122,6 +143,14 @@ private:
 	Vector<Vector3> contact_debug;
 	int contact_debug_count;
 
+	SnapshotWriterSW snapshot_writer;
+
+	// broadphase candidates shared by the motion tests of one body, see begin_motion_batch()
+	BodySW *motion_batch_body;
+	AABB motion_batch_aabb;
+	LocalVector<CollisionObjectSW *> motion_batch_objects;
+	LocalVector<int> motion_batch_subindices;
+
 	friend class PhysicsDirectSpaceStateSW;
 
 	int _cull_aabb_for_body(BodySW *p_body, const AABB &p_aabb);
@@ -148,6 +177,10 @@ public:
 	void area_remove_from_moved_list(SelfList<AreaSW> *p_area);
 	const SelfList<AreaSW>::List &get_moved_area_list() const;
 
+	void soft_body_add_to_list(SelfList<SoftBodySW> *p_soft_body);
+	void soft_body_remove_from_list(SelfList<SoftBodySW> *p_soft_body);
+	const SelfList<SoftBodySW>::List &get_soft_body_list() const;
+
 	BroadPhaseSW *get_broadphase();
 
 	void add_object(CollisionObjectSW *p_object);
@@ -157,6 +190,7 @@ public:
 	_FORCE_INLINE_ real_t get_contact_recycle_radius() const { return contact_recycle_radius; }
 	_FORCE_INLINE_ real_t get_contact_max_separation() const { return contact_max_separation; }
 	_FORCE_INLINE_ real_t get_contact_max_allowed_penetration() const { return contact_max_allowed_penetration; }
+	_FORCE_INLINE_ real_t get_contact_warm_start_factor() const { return contact_warm_start_factor; }
 	_FORCE_INLINE_ real_t get_constraint_bias() const { return constraint_bias; }
 	_FORCE_INLINE_ real_t get_body_linear_velocity_sleep_threshold() const { return body_linear_velocity_sleep_threshold; }
 	_FORCE_INLINE_ real_t get_body_angular_velocity_sleep_threshold() const { return body_angular_velocity_sleep_threshold; }
@@ -166,6 +200,7 @@ public:
 	void update();
 	void setup();
 	void call_queries();
+	_FORCE_INLINE_ PhysicsServer::BodyStateSyncQueue &get_state_sync_queue() { return state_sync_queue; }
 
 	bool is_locked() const;
 	void lock();
@@ -198,9 +233,26 @@ public:
 	void set_elapsed_time(ElapsedTime p_time, uint64_t p_msec) { elapsed_time[p_time] = p_msec; }
 	uint64_t get_elapsed_time(ElapsedTime p_time) const { return elapsed_time[p_time]; }
 
+	// reset when a step begins, pairs can be created by any phase that moves objects
+	uint64_t get_pair_generation_time() const { return pair_generation_time; }
+
+	// timing each pair costs two clock reads in the narrow phase, so it's only done when asked for
+	void set_narrowphase_timed(bool p_timed) { narrowphase_timed = p_timed; }
+	_FORCE_INLINE_ bool is_narrowphase_timed() const { return narrowphase_timed; }
+
+	PoolVector<uint8_t> get_snapshot();
+	Error restore_snapshot(const PoolVector<uint8_t> &p_snapshot);
+
 	int test_body_ray_separation(BodySW *p_body, const Transform &p_transform, bool p_infinite_inertia, Vector3 &r_recover_motion, PhysicsServer::SeparationResult *r_results, int p_result_max, real_t p_margin);
 	bool test_body_motion(BodySW *p_body, const Transform &p_from, const Vector3 &p_motion, bool p_infinite_inertia, real_t p_margin, PhysicsServer::MotionResult *r_result, bool p_exclude_raycast_shapes);
 
+	void begin_motion_batch(BodySW *p_body, const Transform &p_from, real_t p_max_distance, real_t p_margin);
+	void end_motion_batch(BodySW *p_body);
+	// Any other object entering, leaving or moving in the broadphase makes the shared candidates stale.
+	_FORCE_INLINE_ void object_broadphase_changed(const CollisionObjectSW *p_object) {
+		if (motion_batch_body && motion_batch_body != p_object) motion_batch_body = NULL;
+	}
+
 	SpaceSW();
 	~SpaceSW();
 };
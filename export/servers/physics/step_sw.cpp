@@ -32,41 +32,218 @@
 #include "joints_sw.h"
 
 #include "core/os/os.h"
+#include "core/project_settings.h"
 
-void StepSW::_populate_island(BodySW *p_body, BodySW **p_island, ConstraintSW **p_constraint_island) {
+// A dirty island that nothing was split off from is populated again in place, so
+// it keeps its memory and its constraints, which are already sorted. Only the
+// constraints it didn't have yet are sorted and merged in.
+IslandSW *StepSW::_populate_island(BodySW *p_body) {
+
+	IslandSW *island = p_body->get_island();
+	uint32_t island_users = 0; // bodies found that already belong to the island
+
+	populate_bodies.clear();
+	populate_constraints.clear();
 
 	p_body->set_island_step(_step);
-	p_body->set_island_next(*p_island);
-	*p_island = p_body;
+	populate_stack.push_back(p_body);
+
+	while (populate_stack.size()) {
+
+		BodySW *body = populate_stack[populate_stack.size() - 1];
+		populate_stack.resize(populate_stack.size() - 1);
+		populate_bodies.push_back(body);
+		if (island && body->get_island() == island) {
+			island_users++;
+		}
+
+		for (const BodySW::ConstraintMap::Element *E = body->get_constraint_map().front(); E; E = E->next()) {
+
+			ConstraintSW *c = (ConstraintSW *)E->key();
+			if (c->get_island_step() == _step)
+				continue; //already processed
+			c->set_island_step(_step);
+			populate_constraints.push_back(c);
+
+			for (int i = 0; i < c->get_body_count(); i++) {
+				if (i == E->get())
+					continue;
+				BodySW *b = c->get_body_ptr()[i];
+				if (b->get_island_step() == _step || b->get_mode() == PhysicsServer::BODY_MODE_STATIC || b->get_mode() == PhysicsServer::BODY_MODE_KINEMATIC)
+					continue; //no go
+				b->set_island_step(_step);
+				populate_stack.push_back(b);
+			}
+		}
+	}
 
-	for (Map<ConstraintSW *, int>::Element *E = p_body->get_constraint_map().front(); E; E = E->next()) {
+	if (island && island_users == island->users) {
+
+		// the island only holds constraints that still exist, keep the ones found again.
+		// they are marked with the previous step to tell them from the new ones,
+		// _add_island() marks all of them with this step again
+		uint32_t kept = 0;
+		for (uint32_t i = 0; i < island->constraints.size(); i++) {
+			ConstraintSW *c = island->constraints[i];
+			if (c->get_island_step() == _step) {
+				c->set_island_step(_step - 1);
+				island->constraints[kept++] = c;
+			}
+		}
+
+		populate_added.clear();
+		for (uint32_t i = 0; i < populate_constraints.size(); i++) {
+			if (populate_constraints[i]->get_island_step() == _step) {
+				populate_added.push_back(populate_constraints[i]);
+			}
+		}
+		populate_added.sort_custom<ConstraintOrderSW>();
+
+		// merge from the back, so no constraint is moved before it's read
+		island->constraints.resize(kept + populate_added.size());
+		ConstraintOrderSW order;
+		int64_t from_kept = int64_t(kept) - 1;
+		int64_t from_added = int64_t(populate_added.size()) - 1;
+		int64_t to = int64_t(island->constraints.size()) - 1;
+		while (from_added >= 0) {
+			if (from_kept >= 0 && order(populate_added[from_added], island->constraints[from_kept])) {
+				island->constraints[to--] = island->constraints[from_kept--];
+			} else {
+				island->constraints[to--] = populate_added[from_added--];
+			}
+		}
+
+		island->bodies.clear();
+
+	} else {
+
+		// a new island, or one split off. the bodies left behind populate the old one again when reached
+		island = memnew(IslandSW);
+		// solve in the same order no matter which body the island was found from
+		populate_constraints.sort_custom<ConstraintOrderSW>();
+		for (uint32_t i = 0; i < populate_constraints.size(); i++) {
+			island->constraints.push_back(populate_constraints[i]);
+		}
+	}
+
+	for (uint32_t i = 0; i < populate_bodies.size(); i++) {
+		populate_bodies[i]->set_island(island);
+		island->bodies.push_back(populate_bodies[i]);
+	}
+	island->dirty = false;
+
+	return island;
+}
+
+IslandSW *StepSW::_get_island(BodySW *p_body) {
+
+	IslandSW *island = p_body->get_island();
+	if (!island || island->dirty) {
+		island = _populate_island(p_body);
+	}
+
+	return island;
+}
+
+void StepSW::_add_island(IslandSW *p_island, BodySW **r_island_list, ConstraintSW **r_constraint_island_list, int &r_island_count) {
+
+	BodySW *island = NULL;
+	for (uint32_t i = 0; i < p_island->bodies.size(); i++) {
+		BodySW *b = p_island->bodies[i];
+		b->set_island_step(_step);
+		b->set_island_next(island);
+		island = b;
+	}
+
+	island->set_island_list_next(*r_island_list);
+	*r_island_list = island;
+
+	ConstraintSW *constraint_island = NULL;
+	for (int i = int(p_island->constraints.size()) - 1; i >= 0; i--) {
+		ConstraintSW *c = p_island->constraints[i];
+		c->set_island_step(_step);
+		c->set_island_next(constraint_island);
+		constraint_island = c;
+	}
+
+	if (constraint_island) {
+		constraint_island->set_island_list_next(*r_constraint_island_list);
+		*r_constraint_island_list = constraint_island;
+		r_island_count++;
+	}
+}
+
+// kinematic bodies don't join islands, they bring in the islands of the bodies they touch,
+// and get one of their own for constraints with other kinematic or static bodies
+void StepSW::_add_kinematic_island(BodySW *p_body, BodySW **r_island_list, ConstraintSW **r_constraint_island_list, int &r_island_count) {
+
+	p_body->set_island_step(_step);
+	p_body->set_island_next(NULL);
+	p_body->set_island_list_next(*r_island_list);
+	*r_island_list = p_body;
+
+	ConstraintSW *constraint_island = NULL;
+
+	for (const BodySW::ConstraintMap::Element *E = p_body->get_constraint_map().front(); E; E = E->next()) {
 
 		ConstraintSW *c = (ConstraintSW *)E->key();
 		if (c->get_island_step() == _step)
 			continue; //already processed
-		c->set_island_step(_step);
-		c->set_island_next(*p_constraint_island);
-		*p_constraint_island = c;
 
+		BodySW *dynamic = NULL;
 		for (int i = 0; i < c->get_body_count(); i++) {
-			if (i == E->get())
-				continue;
 			BodySW *b = c->get_body_ptr()[i];
-			if (b->get_island_step() == _step || b->get_mode() == PhysicsServer::BODY_MODE_STATIC || b->get_mode() == PhysicsServer::BODY_MODE_KINEMATIC)
-				continue; //no go
-			_populate_island(c->get_body_ptr()[i], p_island, p_constraint_island);
+			if (i != E->get() && b->get_mode() != PhysicsServer::BODY_MODE_STATIC && b->get_mode() != PhysicsServer::BODY_MODE_KINEMATIC) {
+				dynamic = b;
+				break;
+			}
+		}
+
+		if (dynamic) {
+			if (dynamic->get_island_step() != _step) {
+				_add_island(_get_island(dynamic), r_island_list, r_constraint_island_list, r_island_count);
+			}
+		} else {
+			c->set_island_step(_step);
+			c->set_island_next(constraint_island);
+			constraint_island = c;
 		}
 	}
+
+	if (constraint_island) {
+		constraint_island->set_island_list_next(*r_constraint_island_list);
+		*r_constraint_island_list = constraint_island;
+		r_island_count++;
+	}
+}
+
+bool StepSW::_is_island_parallel(ConstraintSW *p_island) const {
+
+	ConstraintSW *ci = p_island;
+	while (ci) {
+		if (ci->writes_outside_island())
+			return false;
+		ci = ci->get_island_next();
+	}
+
+	return true;
 }
 
-void StepSW::_setup_island(ConstraintSW *p_island, real_t p_delta) {
+uint64_t StepSW::_setup_island(ConstraintSW *p_island, real_t p_delta) {
+
+	uint64_t narrowphase_time = 0;
 
 	ConstraintSW *ci = p_island;
 	while (ci) {
 		ci->setup(p_delta);
 		//todo remove from island if process fails
+		if (narrowphase_timed) {
+			narrowphase_time += ci->get_narrowphase_time();
+		}
 		ci = ci->get_island_next();
 	}
+
+	return narrowphase_time;
 }
 
 void StepSW::_solve_island(ConstraintSW *p_island, int p_iterations, real_t p_delta) {
@@ -107,6 +284,16 @@ void StepSW::_solve_island(ConstraintSW *p_island, int p_iterations, real_t p_de
 	}
 }
 
+void StepSW::_setup_parallel_island(uint32_t p_index, void *p_userdata) {
+
+	parallel_narrowphase_time[p_index] = _setup_island(parallel_islands[p_index], parallel_delta);
+}
+
+void StepSW::_solve_parallel_island(uint32_t p_index, void *p_userdata) {
+
+	_solve_island(parallel_islands[p_index], parallel_iterations, parallel_delta);
+}
+
 void StepSW::_check_suspend(BodySW *p_island, real_t p_delta) {
 
 	bool can_sleep = true;
@@ -188,17 +375,11 @@ void StepSW::step(SpaceSW *p_space, real_t p_delta, int p_iterations) {
 
 		if (body->get_island_step() != _step) {
 
-			BodySW *island = NULL;
-			ConstraintSW *constraint_island = NULL;
-			_populate_island(body, &island, &constraint_island);
-
-			island->set_island_list_next(island_list);
-			island_list = island;
-
-			if (constraint_island) {
-				constraint_island->set_island_list_next(constraint_island_list);
-				constraint_island_list = constraint_island;
-				island_count++;
+			if (body->get_mode() == PhysicsServer::BODY_MODE_STATIC || body->get_mode() == PhysicsServer::BODY_MODE_KINEMATIC) {
+				_add_kinematic_island(body, &island_list, &constraint_island_list, island_count);
+			} else {
+				// islands of sleeping bodies are left alone until something wakes them up
+				_add_island(_get_island(body), &island_list, &constraint_island_list, island_count);
 			}
 		}
 		b = b->next();
@@ -230,13 +411,37 @@ void StepSW::step(SpaceSW *p_space, real_t p_delta, int p_iterations) {
 
 	/* SETUP CONSTRAINT ISLANDS */
 
+	// islands don't share dynamic bodies, so the ones that don't write to shared
+	// objects (areas, contact reports on static bodies) can be set up and solved
+	// on any thread without changing the result. the rest stay on this thread.
+
+	parallel_islands.clear();
+	parallel_delta = p_delta;
+	parallel_iterations = p_iterations;
+	narrowphase_timed = p_space->is_narrowphase_timed();
+
+	uint64_t narrowphase_time = 0;
+
 	{
+		bool use_threads = work_pool.get_thread_count() > 1;
+
 		ConstraintSW *ci = constraint_island_list;
 		while (ci) {
 
-			_setup_island(ci, p_delta);
+			if (use_threads && _is_island_parallel(ci)) {
+				parallel_islands.push_back(ci);
+			} else {
+				narrowphase_time += _setup_island(ci, p_delta);
+			}
 			ci = ci->get_island_list_next();
 		}
+
+		parallel_narrowphase_time.resize(parallel_islands.size());
+		work_pool.do_work(parallel_islands.size(), this, &StepSW::_setup_parallel_island, (void *)NULL);
+
+		for (uint32_t i = 0; i < parallel_narrowphase_time.size(); i++) {
+			narrowphase_time += parallel_narrowphase_time[i];
+		}
 	}
 
 	{ //profile
@@ -248,12 +453,20 @@ void StepSW::step(SpaceSW *p_space, real_t p_delta, int p_iterations) {
 	/* SOLVE CONSTRAINT ISLANDS */
 
 	{
+		uint32_t parallel_index = 0;
+
 		ConstraintSW *ci = constraint_island_list;
 		while (ci) {
-			//iterating each island separatedly improves cache efficiency
-			_solve_island(ci, p_iterations, p_delta);
+			if (parallel_index < parallel_islands.size() && parallel_islands[parallel_index] == ci) {
+				parallel_index++; // solved below
+			} else {
+				//iterating each island separatedly improves cache efficiency
+				_solve_island(ci, p_iterations, p_delta);
+			}
 			ci = ci->get_island_list_next();
 		}
+
+		work_pool.do_work(parallel_islands.size(), this, &StepSW::_solve_parallel_island, (void *)NULL);
 	}
 
 	{ //profile
@@ -288,12 +501,57 @@ void StepSW::step(SpaceSW *p_space, real_t p_delta, int p_iterations) {
 		profile_begtime = profile_endtime;
 	}
 
+	/* STEP SOFT BODIES */
+
+	// after the rigid bodies moved, so the particles collide with where they are now
+	const SelfList<SoftBodySW> *sb = p_space->get_soft_body_list().first();
+	while (sb) {
+		sb->self()->step(p_delta, &work_pool);
+		sb = sb->next();
+	}
+
+	profile_begtime = OS::get_singleton()->get_ticks_usec();
+	uint64_t pair_generation_begin = p_space->get_pair_generation_time();
+
 	p_space->update();
+
+	{ //profile
+		profile_endtime = OS::get_singleton()->get_ticks_usec();
+		// the pairs found by the update are accounted separately
+		uint64_t pair_generation = p_space->get_pair_generation_time() - pair_generation_begin;
+		p_space->set_elapsed_time(SpaceSW::ELAPSED_TIME_BROADPHASE, profile_endtime - profile_begtime - pair_generation);
+		p_space->set_elapsed_time(SpaceSW::ELAPSED_TIME_PAIR_GENERATION, p_space->get_pair_generation_time());
+		p_space->set_elapsed_time(SpaceSW::ELAPSED_TIME_NARROWPHASE, narrowphase_time);
+	}
+
 	p_space->unlock();
 	_step++;
 }
 
+void StepSW::set_thread_count(int p_count) {
+
+	work_pool.finish();
+	work_pool.init(p_count);
+}
+
+int StepSW::get_thread_count() const {
+
+	return work_pool.get_thread_count();
+}
+
 StepSW::StepSW() {
 
 	_step = 1;
+	parallel_delta = 0;
+	parallel_iterations = 0;
+	narrowphase_timed = false;
+
+	int thread_count = GLOBAL_DEF("physics/3d/godot_physics/solver_thread_count", 0);
+	ProjectSettings::get_singleton()->set_custom_property_info("physics/3d/godot_physics/solver_thread_count", PropertyInfo(Variant::INT, "physics/3d/godot_physics/solver_thread_count", PROPERTY_HINT_RANGE, "0,64,1,or_greater"));
+	work_pool.init(thread_count);
+}
+
+StepSW::~StepSW() {
+
+	work_pool.finish();
 }
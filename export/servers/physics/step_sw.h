@@ -31,20 +31,45 @@
 #ifndef STEP_SW_H
 #define STEP_SW_H
 
+#include "core/local_vector.h"
+#include "core/os/thread_work_pool.h"
 #include "space_sw.h"
 
 class StepSW {
 
 	uint64_t _step;
 
-	void _populate_island(BodySW *p_body, BodySW **p_island, ConstraintSW **p_constraint_island);
-	void _setup_island(ConstraintSW *p_island, real_t p_delta);
+	ThreadWorkPool work_pool;
+	LocalVector<ConstraintSW *> parallel_islands;
+	LocalVector<uint64_t> parallel_narrowphase_time; // one per parallel island, summed once they're all set up
+	real_t parallel_delta;
+	int parallel_iterations;
+	bool narrowphase_timed;
+
+	LocalVector<BodySW *> populate_stack;
+	LocalVector<BodySW *> populate_bodies;
+	LocalVector<ConstraintSW *> populate_constraints;
+	LocalVector<ConstraintSW *> populate_added;
+
+	IslandSW *_populate_island(BodySW *p_body);
+	IslandSW *_get_island(BodySW *p_body);
+	void _add_island(IslandSW *p_island, BodySW **r_island_list, ConstraintSW **r_constraint_island_list, int &r_island_count);
+	void _add_kinematic_island(BodySW *p_body, BodySW **r_island_list, ConstraintSW **r_constraint_island_list, int &r_island_count);
+	bool _is_island_parallel(ConstraintSW *p_island) const;
+	uint64_t _setup_island(ConstraintSW *p_island, real_t p_delta);
 	void _solve_island(ConstraintSW *p_island, int p_iterations, real_t p_delta);
+	void _setup_parallel_island(uint32_t p_index, void *p_userdata);
+	void _solve_parallel_island(uint32_t p_index, void *p_userdata);
 	void _check_suspend(BodySW *p_island, real_t p_delta);
 
 public:
 	void step(SpaceSW *p_space, real_t p_delta, int p_iterations);
+
+	void set_thread_count(int p_count);
+	int get_thread_count() const;
+
 	StepSW();
+	~StepSW();
 };
 
 #endif // STEP__SW_H
@@ -30,15 +30,23 @@
 
 #include "area_pair_2d_sw.h"
 #include "collision_solver_2d_sw.h"
+#include "core/os/os.h"
+#include "space_2d_sw.h"
 
 bool AreaPair2DSW::setup(real_t p_step) {
 
 	bool result = false;
+	narrowphase_time = 0;
 
 	if (area->is_shape_set_as_disabled(area_shape) || body->is_shape_set_as_disabled(body_shape)) {
 		result = false;
-	} else if (area->test_collision_mask(body) && CollisionSolver2DSW::solve(body->get_shape(body_shape), body->get_transform() * body->get_shape_transform(body_shape), Vector2(), area->get_shape(area_shape), area->get_transform() * area->get_shape_transform(area_shape), Vector2(), NULL, this)) {
-		result = true;
+	} else if (area->test_collision_mask(body)) {
+		bool timed = area->get_space()->is_narrowphase_timed();
+		uint64_t narrowphase_begin = timed ? OS::get_singleton()->get_ticks_usec() : 0;
+		result = CollisionSolver2DSW::solve(body->get_shape(body_shape), body->get_transform() * body->get_shape_transform(body_shape), Vector2(), area->get_shape(area_shape), area->get_transform() * area->get_shape_transform(area_shape), Vector2(), NULL, this);
+		if (timed) {
+			narrowphase_time = OS::get_singleton()->get_ticks_usec() - narrowphase_begin;
+		}
 	}
 
 	if (result != colliding) {
@@ -74,6 +82,8 @@ AreaPair2DSW::AreaPair2DSW(Body2DSW *p_body, int p_body_shape, Area2DSW *p_area,
 	body_shape = p_body_shape;
 	area_shape = p_area_shape;
 	colliding = false;
+	narrowphase_time = 0;
+	set_sort_key((uint64_t(body->get_self().get_id()) << 32) | area->get_self().get_id(), (uint64_t(uint32_t(body_shape)) << 32) | uint32_t(area_shape));
 	body->add_constraint(this, 0);
 	area->add_constraint(this);
 	if (p_body->get_mode() == Physics2DServer::BODY_MODE_KINEMATIC) //need to be active to process pair
@@ -98,10 +108,16 @@ AreaPair2DSW::~AreaPair2DSW() {
 bool Area2Pair2DSW::setup(real_t p_step) {
 
 	bool result = false;
+	narrowphase_time = 0;
 	if (area_a->is_shape_set_as_disabled(shape_a) || area_b->is_shape_set_as_disabled(shape_b)) {
 		result = false;
-	} else if (area_a->test_collision_mask(area_b) && CollisionSolver2DSW::solve(area_a->get_shape(shape_a), area_a->get_transform() * area_a->get_shape_transform(shape_a), Vector2(), area_b->get_shape(shape_b), area_b->get_transform() * area_b->get_shape_transform(shape_b), Vector2(), NULL, this)) {
-		result = true;
+	} else if (area_a->test_collision_mask(area_b)) {
+		bool timed = area_a->get_space()->is_narrowphase_timed();
+		uint64_t narrowphase_begin = timed ? OS::get_singleton()->get_ticks_usec() : 0;
+		result = CollisionSolver2DSW::solve(area_a->get_shape(shape_a), area_a->get_transform() * area_a->get_shape_transform(shape_a), Vector2(), area_b->get_shape(shape_b), area_b->get_transform() * area_b->get_shape_transform(shape_b), Vector2(), NULL, this);
+		if (timed) {
+			narrowphase_time = OS::get_singleton()->get_ticks_usec() - narrowphase_begin;
+		}
 	}
 
 	if (result != colliding) {
@@ -139,6 +155,7 @@ Area2Pair2DSW::Area2Pair2DSW(Area2DSW *p_area_a, int p_shape_a, Area2DSW *p_area
 	shape_a = p_shape_a;
 	shape_b = p_shape_b;
 	colliding = false;
+	narrowphase_time = 0;
 	area_a->add_constraint(this);
 	area_b->add_constraint(this);
 }
@@ -42,10 +42,13 @@ class AreaPair2DSW : public Constraint2DSW {
 	int body_shape;
 	int area_shape;
 	bool colliding;
+	uint64_t narrowphase_time;
 
 public:
 	bool setup(real_t p_step);
 	void solve(real_t p_step);
+	virtual bool writes_outside_island() const { return true; } // areas track overlaps with bodies from any island
+	virtual uint64_t get_narrowphase_time() const { return narrowphase_time; }
 
 	AreaPair2DSW(Body2DSW *p_body, int p_body_shape, Area2DSW *p_area, int p_area_shape);
 	~AreaPair2DSW();
@@ -58,10 +61,13 @@ class Area2Pair2DSW : public Constraint2DSW {
 	int shape_a;
 	int shape_b;
 	bool colliding;
+	uint64_t narrowphase_time;
 
 public:
 	bool setup(real_t p_step);
 	void solve(real_t p_step);
+	virtual bool writes_outside_island() const { return true; } // areas track overlaps with bodies from any island
+	virtual uint64_t get_narrowphase_time() const { return narrowphase_time; }
 
 	Area2Pair2DSW(Area2DSW *p_area_a, int p_shape_a, Area2DSW *p_area_b, int p_shape_b);
 	~Area2Pair2DSW();
@@ -30,9 +30,21 @@
 
 #include "body_2d_sw.h"
 #include "area_2d_sw.h"
+#include "math_2d_sw.h"
 #include "physics_2d_server_sw.h"
 #include "space_2d_sw.h"
 
+bool ConstraintOrder2DSW::operator()(const Constraint2DSW *p_a, const Constraint2DSW *p_b) const {
+
+	if (p_a->get_sort_key_high() != p_b->get_sort_key_high()) {
+		return p_a->get_sort_key_high() < p_b->get_sort_key_high();
+	}
+	if (p_a->get_sort_key_low() != p_b->get_sort_key_low()) {
+		return p_a->get_sort_key_low() < p_b->get_sort_key_low();
+	}
+	return p_a < p_b;
+}
+
 void Body2DSW::_update_inertia() {
 
 	if (!user_inertia && get_space() && !inertia_update_list.in_list())
@@ -220,6 +232,16 @@ void Body2DSW::set_mode(Physics2DServer::BodyMode p_mode) {
 	Physics2DServer::BodyMode prev = mode;
 	mode = p_mode;
 
+	if ((prev > Physics2DServer::BODY_MODE_KINEMATIC) != (p_mode > Physics2DServer::BODY_MODE_KINEMATIC)) {
+		// only rigid and character bodies join the islands of the bodies they are constrained to
+		for (ConstraintMap::Element *E = constraint_map.front(); E; E = E->next()) {
+			for (int i = 0; i < E->key()->get_body_count(); i++) {
+				E->key()->get_body_ptr()[i]->invalidate_island();
+			}
+		}
+		set_island(NULL);
+	}
+
 	switch (p_mode) {
 		//CLEAR UP EVERYTHING IN CASE IT NOT WORKS!
 		case Physics2DServer::BODY_MODE_STATIC:
@@ -369,8 +391,32 @@ Variant Body2DSW::get_state(Physics2DServer::BodyState p_state) const {
 	return Variant();
 }
 
+void Body2DSW::set_island(Island2DSW *p_island) {
+
+	if (island == p_island)
+		return;
+
+	if (island) {
+		// the constraints of the body may still be listed, they are found again when it's populated
+		island->constraints.clear();
+		island->dirty = true;
+		island->users--;
+		if (island->users == 0) {
+			memdelete(island);
+		}
+	}
+
+	island = p_island;
+
+	if (island) {
+		island->users++;
+	}
+}
+
 void Body2DSW::set_space(Space2DSW *p_space) {
 
+	set_island(NULL);
+
 	if (get_space()) {
 
 		wakeup_neighbours();
@@ -407,7 +453,8 @@ void Body2DSW::_compute_area_gravity_and_dampenings(const Area2DSW *p_area) {
 	if (p_area->is_gravity_point()) {
 		if (p_area->get_gravity_distance_scale() > 0) {
 			Vector2 v = p_area->get_transform().xform(p_area->get_gravity_vector()) - get_transform().get_origin();
-			gravity += v.normalized() * (p_area->get_gravity() / Math::pow(v.length() * p_area->get_gravity_distance_scale() + 1, 2));
+			real_t falloff = v.length() * p_area->get_gravity_distance_scale() + 1;
+			gravity += v.normalized() * (p_area->get_gravity() / (falloff * falloff));
 		} else {
 			gravity += (p_area->get_transform().xform(p_area->get_gravity_vector()) - get_transform().get_origin()).normalized() * p_area->get_gravity();
 		}
@@ -479,6 +526,7 @@ void Body2DSW::integrate_forces(real_t p_step) {
 	*/
 
 	Vector2 motion;
+	real_t sweep = 0;
 	bool do_motion = false;
 
 	if (mode == Physics2DServer::BODY_MODE_KINEMATIC) {
@@ -487,7 +535,7 @@ void Body2DSW::integrate_forces(real_t p_step) {
 		motion = new_transform.get_origin() - get_transform().get_origin();
 		linear_velocity = motion / p_step;
 
-		real_t rot = new_transform.get_rotation() - get_transform().get_rotation();
+		real_t rot = Math2DSW::get_rotation(new_transform) - Math2DSW::get_rotation(get_transform());
 		angular_velocity = remainder(rot, 2.0 * Math_PI) / p_step;
 
 		do_motion = true;
@@ -528,6 +576,13 @@ void Body2DSW::integrate_forces(real_t p_step) {
 
 			motion = linear_velocity * p_step;
 			do_motion = true;
+
+			real_t angle = Math::abs(angular_velocity) * p_step;
+			if (angle > CMP_EPSILON) {
+				for (int i = 0; i < get_shape_count(); i++) {
+					sweep = MAX(sweep, get_shape_rotation_radius(i) * MIN(angle, (real_t)2.0));
+				}
+			}
 		}
 	}
 
@@ -538,7 +593,7 @@ void Body2DSW::integrate_forces(real_t p_step) {
 	biased_linear_velocity = Vector2();
 
 	if (do_motion) { //shapes temporarily extend for raycast
-		_update_shapes_with_motion(motion);
+		_update_shapes_with_motion(motion, sweep);
 	}
 
 	// damp_area=NULL; // clear the area, so it is set in the next frame
@@ -546,6 +601,19 @@ void Body2DSW::integrate_forces(real_t p_step) {
 	contact_count = 0;
 }
 
+real_t Body2DSW::get_shape_rotation_radius(int p_shape) const {
+
+	Rect2 aabb = Math2DSW::transform(Math2DSW::get_rotation(get_transform()), Vector2()).xform(get_shape_transform(p_shape).xform(get_shape(p_shape)->get_aabb()));
+
+	real_t radius = 0;
+	radius = MAX(radius, aabb.position.length());
+	radius = MAX(radius, (aabb.position + Vector2(aabb.size.x, 0)).length());
+	radius = MAX(radius, (aabb.position + Vector2(0, aabb.size.y)).length());
+	radius = MAX(radius, (aabb.position + aabb.size).length());
+
+	return radius;
+}
+
 void Body2DSW::integrate_velocities(real_t p_step) {
 
 	if (mode == Physics2DServer::BODY_MODE_STATIC)
@@ -566,10 +634,14 @@ void Body2DSW::integrate_velocities(real_t p_step) {
 	real_t total_angular_velocity = angular_velocity + biased_angular_velocity;
 	Vector2 total_linear_velocity = linear_velocity + biased_linear_velocity;
 
-	real_t angle = get_transform().get_rotation() + total_angular_velocity * p_step;
-	Vector2 pos = get_transform().get_origin() + total_linear_velocity * p_step;
+	// CCD may have found an impact before the end of the step
+	real_t motion_step = p_step * ccd_motion_scale;
+	ccd_motion_scale = 1.0;
+
+	real_t angle = Math2DSW::get_rotation(get_transform()) + total_angular_velocity * motion_step;
+	Vector2 pos = get_transform().get_origin() + total_linear_velocity * motion_step;
 
-	_set_transform(Transform2D(angle, pos), continuous_cd_mode == Physics2DServer::CCD_MODE_DISABLED);
+	_set_transform(Math2DSW::transform(angle, pos), continuous_cd_mode == Physics2DServer::CCD_MODE_DISABLED);
 	_set_inv_transform(get_transform().inverse());
 
 	if (continuous_cd_mode != Physics2DServer::CCD_MODE_DISABLED)
@@ -578,9 +650,49 @@ void Body2DSW::integrate_velocities(real_t p_step) {
 	//_update_inertia_tensor();
 }
 
+void Body2DSW::save_state(SnapshotWriter2DSW &r_writer) const {
+
+	r_writer.put(get_transform());
+	r_writer.put(get_inv_transform());
+	r_writer.put(new_transform);
+	r_writer.put(linear_velocity);
+	r_writer.put(angular_velocity);
+	r_writer.put(applied_force);
+	r_writer.put(applied_torque);
+	r_writer.put(still_time);
+	r_writer.put(first_integration);
+}
+
+bool Body2DSW::load_state(SnapshotReader2DSW &p_reader) {
+
+	Transform2D transform;
+	Transform2D inv_transform;
+
+	p_reader.get(transform);
+	p_reader.get(inv_transform);
+	p_reader.get(new_transform);
+	p_reader.get(linear_velocity);
+	p_reader.get(angular_velocity);
+	p_reader.get(applied_force);
+	p_reader.get(applied_torque);
+	p_reader.get(still_time);
+	p_reader.get(first_integration);
+
+	ERR_FAIL_COND_V(p_reader.has_failed(), false);
+
+	_set_transform(transform);
+	_set_inv_transform(inv_transform);
+
+	if (fi_callback && get_space() && !direct_state_query_list.in_list()) {
+		get_space()->body_add_to_state_query_list(&direct_state_query_list);
+	}
+
+	return true;
+}
+
 void Body2DSW::wakeup_neighbours() {
 
-	for (Map<Constraint2DSW *, int>::Element *E = constraint_map.front(); E; E = E->next()) {
+	for (ConstraintMap::Element *E = constraint_map.front(); E; E = E->next()) {
 
 		const Constraint2DSW *c = E->key();
 		Body2DSW **n = c->get_body_ptr();
@@ -687,6 +799,7 @@ Body2DSW::Body2DSW() :
 	island_step = 0;
 	island_next = NULL;
 	island_list_next = NULL;
+	island = NULL;
 	_set_static(false);
 	first_time_kinematic = false;
 	linear_damp = -1;
@@ -699,12 +812,15 @@ Body2DSW::Body2DSW() :
 
 	still_time = 0;
 	continuous_cd_mode = Physics2DServer::CCD_MODE_DISABLED;
+	ccd_motion_scale = 1.0;
 	can_sleep = true;
 	fi_callback = NULL;
 }
 
 Body2DSW::~Body2DSW() {
 
+	set_island(NULL);
+
 	if (fi_callback)
 		memdelete(fi_callback);
 }
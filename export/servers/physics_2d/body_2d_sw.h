@@ -34,11 +34,22 @@
 #include "area_2d_sw.h"
 #include "collision_object_2d_sw.h"
 #include "core/vset.h"
+#include "island_2d_sw.h"
+#include "snapshot_2d_sw.h"
 
 class Constraint2DSW;
 
+// orders constraints by their sort key instead of their address, so islands are
+// built and solved in the same order after a space snapshot is restored
+struct ConstraintOrder2DSW {
+	bool operator()(const Constraint2DSW *p_a, const Constraint2DSW *p_b) const;
+};
+
 class Body2DSW : public CollisionObject2DSW {
+public:
+	typedef Map<Constraint2DSW *, int, ConstraintOrder2DSW> ConstraintMap;
 
+private:
 	Physics2DServer::BodyMode mode;
 
 	Vector2 biased_linear_velocity;
@@ -75,6 +86,7 @@ class Body2DSW : public CollisionObject2DSW {
 
 	VSet<RID> exceptions;
 	Physics2DServer::CCDMode continuous_cd_mode;
+	real_t ccd_motion_scale; // fraction of the step the body moves, below 1 when CCD found an impact
 	bool omit_force_integration;
 	bool active;
 	bool can_sleep;
@@ -84,7 +96,7 @@ class Body2DSW : public CollisionObject2DSW {
 	virtual void _shapes_changed();
 	Transform2D new_transform;
 
-	Map<Constraint2DSW *, int> constraint_map;
+	ConstraintMap constraint_map;
 
 	struct AreaCMP {
 
@@ -129,6 +141,7 @@ class Body2DSW : public CollisionObject2DSW {
 	uint64_t island_step;
 	Body2DSW *island_next;
 	Body2DSW *island_list_next;
+	Island2DSW *island;
 
 	_FORCE_INLINE_ void _compute_area_gravity_and_dampenings(const Area2DSW *p_area);
 
@@ -180,10 +193,32 @@ public:
 	_FORCE_INLINE_ Body2DSW *get_island_list_next() const { return island_list_next; }
 	_FORCE_INLINE_ void set_island_list_next(Body2DSW *p_next) { island_list_next = p_next; }
 
-	_FORCE_INLINE_ void add_constraint(Constraint2DSW *p_constraint, int p_pos) { constraint_map[p_constraint] = p_pos; }
-	_FORCE_INLINE_ void remove_constraint(Constraint2DSW *p_constraint) { constraint_map.erase(p_constraint); }
-	const Map<Constraint2DSW *, int> &get_constraint_map() const { return constraint_map; }
-	_FORCE_INLINE_ void clear_constraint_map() { constraint_map.clear(); }
+	_FORCE_INLINE_ Island2DSW *get_island() const { return island; }
+	void set_island(Island2DSW *p_island);
+	_FORCE_INLINE_ void invalidate_island() {
+		if (island)
+			island->dirty = true;
+	}
+
+	_FORCE_INLINE_ void add_constraint(Constraint2DSW *p_constraint, int p_pos) {
+		constraint_map[p_constraint] = p_pos;
+		invalidate_island();
+	}
+	_FORCE_INLINE_ void remove_constraint(Constraint2DSW *p_constraint) {
+		constraint_map.erase(p_constraint);
+		if (island) {
+			island->constraints.erase(p_constraint);
+			island->dirty = true;
+		}
+	}
+	const ConstraintMap &get_constraint_map() const { return constraint_map; }
+	_FORCE_INLINE_ void clear_constraint_map() {
+		constraint_map.clear();
+		if (island) {
+			island->constraints.clear();
+			island->dirty = true;
+		}
+	}
 
 	_FORCE_INLINE_ void set_omit_force_integration(bool p_omit_force_integration) { omit_force_integration = p_omit_force_integration; }
 	_FORCE_INLINE_ bool get_omit_force_integration() const { return omit_force_integration; }
@@ -261,6 +296,10 @@ public:
 	_FORCE_INLINE_ void set_continuous_collision_detection_mode(Physics2DServer::CCDMode p_mode) { continuous_cd_mode = p_mode; }
 	_FORCE_INLINE_ Physics2DServer::CCDMode get_continuous_collision_detection_mode() const { return continuous_cd_mode; }
 
+	_FORCE_INLINE_ void clamp_ccd_motion(real_t p_fraction) { ccd_motion_scale = MIN(ccd_motion_scale, p_fraction); }
+	// farthest a point of the shape can be from the origin the body rotates around
+	real_t get_shape_rotation_radius(int p_shape) const;
+
 	void set_space(Space2DSW *p_space);
 
 	void update_inertias();
@@ -276,6 +315,9 @@ public:
 	void integrate_forces(real_t p_step);
 	void integrate_velocities(real_t p_step);
 
+	void save_state(SnapshotWriter2DSW &r_writer) const;
+	bool load_state(SnapshotReader2DSW &p_reader);
+
 	_FORCE_INLINE_ Vector2 get_motion() const {
 
 		if (mode > Physics2DServer::BODY_MODE_KINEMATIC) {
@@ -30,6 +30,9 @@
 
 #include "body_pair_2d_sw.h"
 #include "collision_solver_2d_sw.h"
+#include "core/os/os.h"
+#include "gjk_2d_sw.h"
+#include "math_2d_sw.h"
 #include "space_2d_sw.h"
 
 #define POSITION_CORRECTION
@@ -168,7 +171,7 @@ void BodyPair2DSW::_validate_contacts() {
 	}
 }
 
-bool BodyPair2DSW::_test_ccd(real_t p_step, Body2DSW *p_A, int p_shape_A, const Transform2D &p_xform_A, Body2DSW *p_B, int p_shape_B, const Transform2D &p_xform_B, bool p_swap_result) {
+bool BodyPair2DSW::_cast_ccd_ray(real_t p_step, Body2DSW *p_A, int p_shape_A, const Transform2D &p_xform_A, Body2DSW *p_B, int p_shape_B, const Transform2D &p_xform_B, bool p_swap_result) {
 
 	Vector2 motion = p_A->get_linear_velocity() * p_step;
 	real_t mlen = motion.length();
@@ -219,6 +222,82 @@ bool BodyPair2DSW::_test_ccd(real_t p_step, Body2DSW *p_A, int p_shape_A, const
 	return true;
 }
 
+// Conservative advancement: A is moved along its motion over the step by its distance to B,
+// divided by the fastest any of its points can approach B, until the shapes touch. Only the
+// motion of A is clamped, so it is used against bodies that are not simulated, and needs
+// convex shapes; otherwise the ray cast above creates a contact instead.
+bool BodyPair2DSW::_test_ccd(real_t p_step, Body2DSW *p_A, int p_shape_A, const Transform2D &p_xform_A, Body2DSW *p_B, int p_shape_B, const Transform2D &p_xform_B, bool p_swap_result) {
+
+	const Shape2DSW *shape_A_ptr = p_A->get_shape(p_shape_A);
+	const Shape2DSW *shape_B_ptr = p_B->get_shape(p_shape_B);
+
+	if (p_B->get_mode() > Physics2DServer::BODY_MODE_KINEMATIC || shape_A_ptr->is_concave() || shape_B_ptr->is_concave() || shape_A_ptr->get_type() == Physics2DServer::SHAPE_LINE || shape_B_ptr->get_type() == Physics2DServer::SHAPE_LINE || shape_B_ptr->get_type() == Physics2DServer::SHAPE_RAY) {
+		return _cast_ccd_ray(p_step, p_A, p_shape_A, p_xform_A, p_B, p_shape_B, p_xform_B, p_swap_result);
+	}
+
+	Vector2 linear_velocity = p_A->get_linear_velocity();
+	real_t angular_speed = Math::abs(p_A->get_angular_velocity());
+	real_t radius = p_A->get_shape_rotation_radius(p_shape_A);
+	real_t max_speed = linear_velocity.length() + angular_speed * radius;
+
+	// only bodies that can pass through something as thin as a third of themselves need it
+	Rect2 aabb = Math2DSW::transform(Math2DSW::get_rotation(p_xform_A), Vector2()).xform(shape_A_ptr->get_aabb());
+	if (max_speed * p_step < MIN(aabb.size.x, aabb.size.y) * 0.3) {
+		return false;
+	}
+
+	Transform2D body_xform = p_A->get_transform();
+	Transform2D shape_xform = p_A->get_shape_transform(p_shape_A);
+	Transform2D xform_B = p_B->get_transform() * p_B->get_shape_transform(p_shape_B);
+
+	// the pairs would find a penetration this deep, stop that far from B
+	real_t tolerance = MAX(space->get_contact_max_allowed_penetration(), (real_t)0.001);
+	real_t fraction = 0;
+	real_t approach_speed = max_speed;
+
+	for (int i = 0; i < CCD_MAX_ITERATIONS; i++) {
+
+		// the same motion as Body2DSW::integrate_velocities(), for a fraction of the step
+		Transform2D xform = Math2DSW::transform(Math2DSW::get_rotation(body_xform) + p_A->get_angular_velocity() * p_step * fraction, body_xform.get_origin() + linear_velocity * p_step * fraction);
+
+		Vector2 closest_A, closest_B;
+		bool separated = gjk_2d_calculate_distance(shape_A_ptr, xform * shape_xform, shape_B_ptr, xform_B, closest_A, closest_B);
+		Vector2 gap = closest_B - closest_A;
+		real_t distance = gap.length();
+		if (!separated || distance <= CMP_EPSILON) {
+			if (i == 0) {
+				return false; // already touching, the contacts take it from here
+			}
+			break;
+		}
+
+		// only motion towards B closes the gap, sliding along B or moving away never hits it
+		approach_speed = linear_velocity.dot(gap / distance) + angular_speed * radius;
+		if (approach_speed <= CMP_EPSILON) {
+			return false;
+		}
+
+		if (distance < tolerance) {
+			break;
+		}
+
+		fraction += distance / (approach_speed * p_step);
+		if (fraction >= 1.0) {
+			return false;
+		}
+	}
+
+	// go a little further at the speed it closes in, so the next step finds the contact and solves it
+	fraction += 2.0 * tolerance / (approach_speed * p_step);
+	if (fraction >= 1.0) {
+		return false;
+	}
+
+	// no contact is added, the pair is solved next step once they touch
+	p_A->clamp_ccd_motion(fraction);
+	return false;
+}
+
 real_t combine_bounce(Body2DSW *A, Body2DSW *B) {
 	return CLAMP(A->get_bounce() + B->get_bounce(), 0, 1);
 }
@@ -229,6 +308,8 @@ real_t combine_friction(Body2DSW *A, Body2DSW *B) {
 
 bool BodyPair2DSW::setup(real_t p_step) {
 
+	narrowphase_time = 0;
+
 	//cannot collide
 	if (!A->test_collision_mask(B) || A->has_exception(B->get_self()) || B->has_exception(A->get_self()) || (A->get_mode() <= Physics2DServer::BODY_MODE_KINEMATIC && B->get_mode() <= Physics2DServer::BODY_MODE_KINEMATIC && A->get_max_contacts_reported() == 0 && B->get_max_contacts_reported() == 0)) {
 		collided = false;
@@ -240,6 +321,10 @@ bool BodyPair2DSW::setup(real_t p_step) {
 		return false;
 	}
 
+	// static and kinematic bodies don't move from impulses, and may be shared by islands being solved in parallel
+	dynamic_A = A->get_mode() > Physics2DServer::BODY_MODE_KINEMATIC;
+	dynamic_B = B->get_mode() > Physics2DServer::BODY_MODE_KINEMATIC;
+
 	//use local A coordinates to avoid numerical issues on collision detection
 	offset_B = B->get_transform().get_origin() - A->get_transform().get_origin();
 
@@ -267,10 +352,15 @@ bool BodyPair2DSW::setup(real_t p_step) {
 
 	bool prev_collided = collided;
 
+	bool timed = space->is_narrowphase_timed();
+	uint64_t narrowphase_begin = timed ? OS::get_singleton()->get_ticks_usec() : 0;
 	collided = CollisionSolver2DSW::solve(shape_A_ptr, xform_A, motion_A, shape_B_ptr, xform_B, motion_B, _add_contact, this, &sep_axis);
+	if (timed) {
+		narrowphase_time = OS::get_singleton()->get_ticks_usec() - narrowphase_begin;
+	}
 	if (!collided) {
 
-		//test ccd (currently just a raycast)
+		//test ccd
 
 		if (A->get_continuous_collision_detection_mode() == Physics2DServer::CCD_MODE_CAST_RAY && A->get_mode() > Physics2DServer::BODY_MODE_KINEMATIC) {
 			if (_test_ccd(p_step, A, shape_A, xform_A, B, shape_B, xform_B))
@@ -424,8 +514,10 @@ bool BodyPair2DSW::setup(real_t p_step) {
 			// Apply normal + friction impulse
 			Vector2 P = c.acc_normal_impulse * c.normal + c.acc_tangent_impulse * tangent;
 
-			A->apply_impulse(c.rA, -P);
-			B->apply_impulse(c.rB, P);
+			if (dynamic_A)
+				A->apply_impulse(c.rA, -P);
+			if (dynamic_B)
+				B->apply_impulse(c.rB, P);
 		}
 
 #endif
@@ -479,8 +571,10 @@ void BodyPair2DSW::solve(real_t p_step) {
 
 		Vector2 jb = c.normal * (c.acc_bias_impulse - jbnOld);
 
-		A->apply_bias_impulse(c.rA, -jb);
-		B->apply_bias_impulse(c.rB, jb);
+		if (dynamic_A)
+			A->apply_bias_impulse(c.rA, -jb);
+		if (dynamic_B)
+			B->apply_bias_impulse(c.rB, jb);
 
 		real_t jn = -(c.bounce + vn) * c.mass_normal;
 		real_t jnOld = c.acc_normal_impulse;
@@ -495,9 +589,65 @@ void BodyPair2DSW::solve(real_t p_step) {
 
 		Vector2 j = c.normal * (c.acc_normal_impulse - jnOld) + tangent * (c.acc_tangent_impulse - jtOld);
 
-		A->apply_impulse(c.rA, -j);
-		B->apply_impulse(c.rB, j);
+		if (dynamic_A)
+			A->apply_impulse(c.rA, -j);
+		if (dynamic_B)
+			B->apply_impulse(c.rB, j);
+	}
+}
+
+bool BodyPair2DSW::writes_outside_island() const {
+
+	// impulses never touch static or kinematic bodies, but contacts may still be reported to them
+	if ((A->get_mode() <= Physics2DServer::BODY_MODE_KINEMATIC && A->can_report_contacts()) || (B->get_mode() <= Physics2DServer::BODY_MODE_KINEMATIC && B->can_report_contacts())) {
+		return true;
+	}
+
+#ifdef DEBUG_ENABLED
+	if (space->is_debugging_contacts()) {
+		return true;
+	}
+#endif
+
+	return false;
+}
+
+bool BodyPair2DSW::save_state(SnapshotWriter2DSW &r_writer) const {
+
+	r_writer.put(sep_axis);
+	r_writer.put(collided);
+	r_writer.put(oneway_disabled);
+	r_writer.put(contact_count);
+	for (int i = 0; i < contact_count; i++) {
+		r_writer.put(contacts[i]);
+	}
+
+	return true;
+}
+
+void BodyPair2DSW::load_state(SnapshotReader2DSW &p_reader) {
+
+	int count = 0;
+
+	p_reader.get(sep_axis);
+	p_reader.get(collided);
+	p_reader.get(oneway_disabled);
+	p_reader.get(count);
+	ERR_FAIL_COND(p_reader.has_failed() || count < 0 || count > MAX_CONTACTS);
+
+	for (int i = 0; i < count; i++) {
+		p_reader.get(contacts[i]);
 	}
+
+	contact_count = p_reader.has_failed() ? 0 : count;
+}
+
+void BodyPair2DSW::clear_state() {
+
+	sep_axis = Vector2();
+	collided = false;
+	oneway_disabled = false;
+	contact_count = 0;
 }
 
 BodyPair2DSW::BodyPair2DSW(Body2DSW *p_A, int p_shape_A, Body2DSW *p_B, int p_shape_B) :
@@ -508,11 +658,15 @@ BodyPair2DSW::BodyPair2DSW(Body2DSW *p_A, int p_shape_A, Body2DSW *p_B, int p_sh
 	shape_A = p_shape_A;
 	shape_B = p_shape_B;
 	space = A->get_space();
+	set_sort_key((uint64_t(A->get_self().get_id()) << 32) | B->get_self().get_id(), (uint64_t(uint32_t(shape_A)) << 32) | uint32_t(shape_B));
 	A->add_constraint(this, 0);
 	B->add_constraint(this, 1);
 	contact_count = 0;
 	collided = false;
+	narrowphase_time = 0;
 	oneway_disabled = false;
+	dynamic_A = false;
+	dynamic_B = false;
 }
 
 BodyPair2DSW::~BodyPair2DSW() {
@@ -37,7 +37,8 @@
 class BodyPair2DSW : public Constraint2DSW {
 
 	enum {
-		MAX_CONTACTS = 2
+		MAX_CONTACTS = 2,
+		CCD_MAX_ITERATIONS = 16
 	};
 	union {
 		struct {
@@ -77,9 +78,13 @@ class BodyPair2DSW : public Constraint2DSW {
 	Contact contacts[MAX_CONTACTS];
 	int contact_count;
 	bool collided;
+	uint64_t narrowphase_time;
 	bool oneway_disabled;
+	bool dynamic_A;
+	bool dynamic_B;
 	int cc;
 
+	bool _cast_ccd_ray(real_t p_step, Body2DSW *p_A, int p_shape_A, const Transform2D &p_xform_A, Body2DSW *p_B, int p_shape_B, const Transform2D &p_xform_B, bool p_swap_result = false);
 	bool _test_ccd(real_t p_step, Body2DSW *p_A, int p_shape_A, const Transform2D &p_xform_A, Body2DSW *p_B, int p_shape_B, const Transform2D &p_xform_B, bool p_swap_result = false);
 	void _validate_contacts();
 	static void _add_contact(const Vector2 &p_point_A, const Vector2 &p_point_B, void *p_self);
@@ -88,6 +93,12 @@ class BodyPair2DSW : public Constraint2DSW {
 public:
 	bool setup(real_t p_step);
 	void solve(real_t p_step);
+	virtual bool writes_outside_island() const;
+	virtual uint64_t get_narrowphase_time() const { return narrowphase_time; }
+
+	virtual bool save_state(SnapshotWriter2DSW &r_writer) const;
+	virtual void load_state(SnapshotReader2DSW &p_reader);
+	virtual void clear_state();
 
 	BodyPair2DSW(Body2DSW *p_A, int p_shape_A, Body2DSW *p_B, int p_shape_B);
 	~BodyPair2DSW();
@@ -49,7 +49,7 @@ public:
 	typedef void (*UnpairCallback)(CollisionObject2DSW *A, int p_subindex_A, CollisionObject2DSW *B, int p_subindex_B, void *p_data, void *p_userdata);
 
 	// 0 is an invalid ID
-	virtual ID create(CollisionObject2DSW *p_object_, int p_subindex = 0) = 0;
+	virtual ID create(CollisionObject2DSW *p_object_, int p_subindex = 0, const Rect2 &p_aabb = Rect2()) = 0;
 	virtual void move(ID p_id, const Rect2 &p_aabb) = 0;
 	virtual void set_static(ID p_id, bool p_static) = 0;
 	virtual void remove(ID p_id) = 0;
@@ -66,6 +66,10 @@ public:
 
 	virtual void update() = 0;
 
+	// pairs are reported from the current AABBs only by default, broadphases that keep
+	// pairs alive with a margin drop that history here
+	virtual void recheck_pairs(ID p_id) {}
+
 	virtual ~BroadPhase2DSW();
 };
 
@@ -99,6 +99,8 @@ void CollisionObject2DSW::set_shape_as_disabled(int p_idx, bool p_disabled) {
 	if (!space)
 		return;
 
+	space->object_broadphase_changed(this);
+
 	if (p_disabled && shape.bpid != 0) {
 		space->get_broadphase()->remove(shape.bpid);
 		shape.bpid = 0;
@@ -130,6 +132,8 @@ void CollisionObject2DSW::remove_shape(int p_index) {
 
 	//remove anything from shape to be erased to end, so subindices don't change
 	ERR_FAIL_INDEX(p_index, shapes.size());
+	if (space)
+		space->object_broadphase_changed(this);
 	for (int i = p_index; i < shapes.size(); i++) {
 
 		if (shapes[i].bpid == 0)
@@ -165,6 +169,9 @@ void CollisionObject2DSW::_set_static(bool p_static) {
 
 void CollisionObject2DSW::_unregister_shapes() {
 
+	if (space)
+		space->object_broadphase_changed(this);
+
 	for (int i = 0; i < shapes.size(); i++) {
 
 		Shape &s = shapes.write[i];
@@ -180,6 +187,8 @@ void CollisionObject2DSW::_update_shapes() {
 	if (!space)
 		return;
 
+	space->object_broadphase_changed(this);
+
 	for (int i = 0; i < shapes.size(); i++) {
 
 		Shape &s = shapes.write[i];
@@ -187,11 +196,6 @@ void CollisionObject2DSW::_update_shapes() {
 		if (s.disabled)
 			continue;
 
-		if (s.bpid == 0) {
-			s.bpid = space->get_broadphase()->create(this, i);
-			space->get_broadphase()->set_static(s.bpid, _static);
-		}
-
 		//not quite correct, should compute the next matrix..
 		Rect2 shape_aabb = s.shape->get_aabb();
 		Transform2D xform = transform * s.xform;
@@ -199,33 +203,52 @@ void CollisionObject2DSW::_update_shapes() {
 		s.aabb_cache = shape_aabb;
 		s.aabb_cache = s.aabb_cache.grow((s.aabb_cache.size.x + s.aabb_cache.size.y) * 0.5 * 0.05);
 
+		if (s.bpid == 0) {
+			s.bpid = space->get_broadphase()->create(this, i, s.aabb_cache);
+			space->get_broadphase()->set_static(s.bpid, _static);
+		}
+
 		space->get_broadphase()->move(s.bpid, s.aabb_cache);
 	}
 }
 
-void CollisionObject2DSW::_update_shapes_with_motion(const Vector2 &p_motion) {
+void CollisionObject2DSW::recheck_broadphase_pairs() {
+
+	if (!space)
+		return;
+
+	for (int i = 0; i < shapes.size(); i++) {
+		if (shapes[i].bpid != 0) {
+			space->get_broadphase()->recheck_pairs(shapes[i].bpid);
+		}
+	}
+}
+
+void CollisionObject2DSW::_update_shapes_with_motion(const Vector2 &p_motion, real_t p_sweep) {
 
 	if (!space)
 		return;
 
+	space->object_broadphase_changed(this);
+
 	for (int i = 0; i < shapes.size(); i++) {
 
 		Shape &s = shapes.write[i];
 		if (s.disabled)
 			continue;
 
-		if (s.bpid == 0) {
-			s.bpid = space->get_broadphase()->create(this, i);
-			space->get_broadphase()->set_static(s.bpid, _static);
-		}
-
 		//not quite correct, should compute the next matrix..
 		Rect2 shape_aabb = s.shape->get_aabb();
 		Transform2D xform = transform * s.xform;
-		shape_aabb = xform.xform(shape_aabb);
+		shape_aabb = xform.xform(shape_aabb).grow(p_sweep);
 		shape_aabb = shape_aabb.merge(Rect2(shape_aabb.position + p_motion, shape_aabb.size)); //use motion
 		s.aabb_cache = shape_aabb;
 
+		if (s.bpid == 0) {
+			s.bpid = space->get_broadphase()->create(this, i, s.aabb_cache);
+			space->get_broadphase()->set_static(s.bpid, _static);
+		}
+
 		space->get_broadphase()->move(s.bpid, shape_aabb);
 	}
 }
@@ -83,7 +83,7 @@ private:
 	void _update_shapes();
 
 protected:
-	void _update_shapes_with_motion(const Vector2 &p_motion);
+	void _update_shapes_with_motion(const Vector2 &p_motion, real_t p_sweep = 0);
 	void _unregister_shapes();
 
 	_FORCE_INLINE_ void _set_transform(const Transform2D &p_transform, bool p_update_shapes = true) {
@@ -149,6 +149,7 @@ public:
 	_FORCE_INLINE_ Space2DSW *get_space() const { return space; }
 
 	void set_shape_as_disabled(int p_idx, bool p_disabled);
+	void recheck_broadphase_pairs();
 	_FORCE_INLINE_ bool is_shape_set_as_disabled(int p_idx) const {
 		CRASH_BAD_INDEX(p_idx, shapes.size());
 		return shapes[p_idx].disabled;
@@ -32,6 +32,8 @@
 #define CONSTRAINT_2D_SW_H
 
 #include "body_2d_sw.h"
+#include "core/safe_refcount.h"
+#include "snapshot_2d_sw.h"
 
 class Constraint2DSW : public RID_Data {
 
@@ -41,15 +43,30 @@ class Constraint2DSW : public RID_Data {
 	Constraint2DSW *island_next;
 	Constraint2DSW *island_list_next;
 	bool disabled_collisions_between_bodies;
+	uint64_t sort_key[2];
 
 	RID self;
 
+	static uint64_t _get_next_serial() {
+		static SafeNumeric<uint64_t> serial;
+		return serial.increment();
+	}
+
 protected:
 	Constraint2DSW(Body2DSW **p_body_ptr = NULL, int p_body_count = 0) {
 		_body_ptr = p_body_ptr;
 		_body_count = p_body_count;
 		island_step = 0;
 		disabled_collisions_between_bodies = true;
+		sort_key[0] = 0;
+		sort_key[1] = _get_next_serial();
+	}
+
+	// constraints that are re-created by the broadphase must sort the same way every time,
+	// so they set a key made of their bodies and shapes before adding themselves to them
+	_FORCE_INLINE_ void set_sort_key(uint64_t p_high, uint64_t p_low) {
+		sort_key[0] = p_high;
+		sort_key[1] = p_low;
 	}
 
 public:
@@ -71,9 +88,23 @@ public:
 	_FORCE_INLINE_ void disable_collisions_between_bodies(const bool p_disabled) { disabled_collisions_between_bodies = p_disabled; }
 	_FORCE_INLINE_ bool is_disabled_collisions_between_bodies() const { return disabled_collisions_between_bodies; }
 
+	_FORCE_INLINE_ uint64_t get_sort_key_high() const { return sort_key[0]; }
+	_FORCE_INLINE_ uint64_t get_sort_key_low() const { return sort_key[1]; }
+
 	virtual bool setup(real_t p_step) = 0;
 	virtual void solve(real_t p_step) = 0;
 
+	// true when setup() or solve() modify objects that other islands may access too, so the island can't be processed in parallel
+	virtual bool writes_outside_island() const { return false; }
+
+	// time the last setup() spent in the collision solver, only measured while the space times the narrow phase
+	virtual uint64_t get_narrowphase_time() const { return 0; }
+
+	// solver state carried over between steps (such as cached contacts), stored in space snapshots
+	virtual bool save_state(SnapshotWriter2DSW &r_writer) const { return false; }
+	virtual void load_state(SnapshotReader2DSW &p_reader) {}
+	virtual void clear_state() {}
+
 	virtual ~Constraint2DSW() {}
 };
 
@@ -0,0 +1,200 @@
+/*************************************************************************/
+/*  gjk_2d_sw.cpp                                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "gjk_2d_sw.h"
+
+namespace {
+
+enum {
+	GJK_MAX_ITERATIONS = 32
+};
+
+// a point of the Minkowski difference, and the points of each shape it comes from
+struct SimplexVertex {
+	Vector2 a;
+	Vector2 b;
+	Vector2 w;
+};
+
+struct Simplex {
+	SimplexVertex vertices[3];
+	real_t weights[3];
+	int count;
+
+	Vector2 closest() const {
+		Vector2 p;
+		for (int i = 0; i < count; i++) {
+			p += vertices[i].w * weights[i];
+		}
+		return p;
+	}
+};
+
+bool _support(const Shape2DSW *p_shape, const Transform2D &p_transform, const Vector2 &p_dir, Vector2 &r_point) {
+
+	Vector2 supports[2];
+	int amount = 0;
+	p_shape->get_supports(p_transform.basis_xform_inv(p_dir).normalized(), supports, amount);
+	if (amount == 0) {
+		return false;
+	}
+
+	r_point = p_transform.xform(supports[0]);
+	return true;
+}
+
+// keeps the part of the segment closest to the origin
+void _solve_segment(Simplex &r_simplex, int p_a, int p_b) {
+
+	const Vector2 &a = r_simplex.vertices[p_a].w;
+	Vector2 ab = r_simplex.vertices[p_b].w - a;
+	real_t len2 = ab.length_squared();
+	real_t t = len2 > CMP_EPSILON2 ? CLAMP(-a.dot(ab) / len2, 0, 1) : 0;
+
+	SimplexVertex va = r_simplex.vertices[p_a];
+	SimplexVertex vb = r_simplex.vertices[p_b];
+
+	if (t <= 0) {
+		r_simplex.vertices[0] = va;
+		r_simplex.weights[0] = 1;
+		r_simplex.count = 1;
+	} else if (t >= 1) {
+		r_simplex.vertices[0] = vb;
+		r_simplex.weights[0] = 1;
+		r_simplex.count = 1;
+	} else {
+		r_simplex.vertices[0] = va;
+		r_simplex.vertices[1] = vb;
+		r_simplex.weights[0] = 1 - t;
+		r_simplex.weights[1] = t;
+		r_simplex.count = 2;
+	}
+}
+
+// false when the triangle contains the origin
+bool _solve_triangle(Simplex &r_simplex) {
+
+	const Vector2 &a = r_simplex.vertices[0].w;
+	const Vector2 &b = r_simplex.vertices[1].w;
+	const Vector2 &c = r_simplex.vertices[2].w;
+
+	real_t area = (b - a).cross(c - a);
+	real_t u = b.cross(c);
+	real_t v = c.cross(a);
+	real_t w = a.cross(b);
+
+	if (Math::abs(area) > CMP_EPSILON2 && u * area >= 0 && v * area >= 0 && w * area >= 0) {
+		return false;
+	}
+
+	// the closest point is on one of the edges
+	static const int edges[3][2] = { { 0, 1 }, { 1, 2 }, { 2, 0 } };
+	Simplex best;
+	real_t best_dist = 1e20;
+
+	for (int i = 0; i < 3; i++) {
+		Simplex s = r_simplex;
+		_solve_segment(s, edges[i][0], edges[i][1]);
+		real_t dist = s.closest().length_squared();
+		if (dist < best_dist) {
+			best_dist = dist;
+			best = s;
+		}
+	}
+
+	r_simplex = best;
+	return true;
+}
+
+} // namespace
+
+bool gjk_2d_calculate_distance(const Shape2DSW *p_shape_A, const Transform2D &p_transform_A, const Shape2DSW *p_shape_B, const Transform2D &p_transform_B, Vector2 &r_result_A, Vector2 &r_result_B) {
+
+	Vector2 dir = p_transform_B.get_origin() - p_transform_A.get_origin();
+	if (dir.length_squared() < CMP_EPSILON2) {
+		dir = Vector2(1, 0);
+	}
+
+	Simplex simplex;
+	SimplexVertex &first = simplex.vertices[0];
+	if (!_support(p_shape_A, p_transform_A, dir, first.a) || !_support(p_shape_B, p_transform_B, -dir, first.b)) {
+		return false;
+	}
+	first.w = first.a - first.b;
+	simplex.weights[0] = 1;
+	simplex.count = 1;
+
+	for (int i = 0; i < GJK_MAX_ITERATIONS; i++) {
+
+		Vector2 v = simplex.closest();
+		real_t v_len2 = v.length_squared();
+		if (v_len2 < CMP_EPSILON2) {
+			return false; // touching
+		}
+
+		SimplexVertex vertex;
+		if (!_support(p_shape_A, p_transform_A, -v, vertex.a) || !_support(p_shape_B, p_transform_B, v, vertex.b)) {
+			return false;
+		}
+		vertex.w = vertex.a - vertex.b;
+
+		// no point of the difference is closer to the origin along v
+		if (v_len2 - v.dot(vertex.w) <= v_len2 * CMP_EPSILON) {
+			break;
+		}
+
+		bool repeated = false;
+		for (int j = 0; j < simplex.count; j++) {
+			if (simplex.vertices[j].w.is_equal_approx(vertex.w)) {
+				repeated = true;
+			}
+		}
+		if (repeated) {
+			break;
+		}
+
+		simplex.vertices[simplex.count++] = vertex;
+
+		if (simplex.count == 2) {
+			_solve_segment(simplex, 0, 1);
+		} else if (!_solve_triangle(simplex)) {
+			return false; // the origin is inside, they overlap
+		}
+	}
+
+	r_result_A = Vector2();
+	r_result_B = Vector2();
+	for (int i = 0; i < simplex.count; i++) {
+		r_result_A += simplex.vertices[i].a * simplex.weights[i];
+		r_result_B += simplex.vertices[i].b * simplex.weights[i];
+	}
+
+	return true;
+}
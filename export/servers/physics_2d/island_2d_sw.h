@@ -0,0 +1,56 @@
+/*************************************************************************/
+/*  island_2d_sw.h                                                       */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef ISLAND_2D_SW_H
+#define ISLAND_2D_SW_H
+
+#include "core/local_vector.h"
+
+class Body2DSW;
+class Constraint2DSW;
+
+// Bodies connected by constraints, kept between steps so Step2DSW only walks the
+// constraints again when one is added or removed. Each body points to its island,
+// which is freed when the last one leaves it. Removed constraints are erased from
+// it right away, so it never points to a freed one.
+class Island2DSW {
+public:
+	LocalVector<Body2DSW *> bodies;
+	LocalVector<Constraint2DSW *> constraints; // sorted like the constraint maps of the bodies, emptied when a body leaves
+	uint32_t users;
+	bool dirty; // bodies or constraints were added or removed, it must be populated again
+
+	Island2DSW() {
+		users = 0;
+		dirty = false;
+	}
+};
+
+#endif // ISLAND_2D_SW_H
@@ -29,6 +29,7 @@
 /*************************************************************************/
 
 #include "joints_2d_sw.h"
+#include "math_2d_sw.h"
 
 #include "space_2d_sw.h"
 
@@ -171,6 +172,17 @@ void PinJoint2DSW::solve(real_t p_step) {
 	P += impulse;
 }
 
+bool PinJoint2DSW::save_state(SnapshotWriter2DSW &r_writer) const {
+
+	r_writer.put(P);
+	return true;
+}
+
+void PinJoint2DSW::load_state(SnapshotReader2DSW &p_reader) {
+
+	p_reader.get(P);
+}
+
 void PinJoint2DSW::set_param(Physics2DServer::PinJointParam p_param, real_t p_value) {
 
 	if (p_param == Physics2DServer::PIN_JOINT_SOFTNESS)
@@ -327,6 +339,17 @@ void GrooveJoint2DSW::solve(real_t p_step) {
 	B->apply_impulse(rB, j);
 }
 
+bool GrooveJoint2DSW::save_state(SnapshotWriter2DSW &r_writer) const {
+
+	r_writer.put(jn_acc);
+	return true;
+}
+
+void GrooveJoint2DSW::load_state(SnapshotReader2DSW &p_reader) {
+
+	p_reader.get(jn_acc);
+}
+
 GrooveJoint2DSW::GrooveJoint2DSW(const Vector2 &p_a_groove1, const Vector2 &p_a_groove2, const Vector2 &p_b_anchor, Body2DSW *p_body_a, Body2DSW *p_body_b) :
 		Joint2DSW(_arr, 2) {
 
@@ -369,7 +392,7 @@ bool DampedSpringJoint2DSW::setup(real_t p_step) {
 	n_mass = 1.0f / k;
 
 	target_vrn = 0.0f;
-	v_coef = 1.0f - Math::exp(-damping * (p_step)*k);
+	v_coef = 1.0f - Math2DSW::exp(-damping * (p_step)*k);
 
 	// apply spring force
 	real_t f_spring = (rest_length - dist) * stiffness;
@@ -51,6 +51,17 @@ public:
 	_FORCE_INLINE_ real_t get_max_bias() const { return max_bias; }
 
 	virtual Physics2DServer::JointType get_type() const = 0;
+
+	// impulses are applied to both bodies, even static or kinematic ones shared with other islands
+	virtual bool writes_outside_island() const {
+		for (int i = 0; i < get_body_count(); i++) {
+			if (get_body_ptr()[i]->get_mode() <= Physics2DServer::BODY_MODE_KINEMATIC) {
+				return true;
+			}
+		}
+		return false;
+	}
+
 	Joint2DSW(Body2DSW **p_body_ptr = NULL, int p_body_count = 0) :
 			Constraint2DSW(p_body_ptr, p_body_count) {
 		bias = 0;
@@ -83,6 +94,10 @@ public:
 	virtual bool setup(real_t p_step);
 	virtual void solve(real_t p_step);
 
+	virtual bool save_state(SnapshotWriter2DSW &r_writer) const;
+	virtual void load_state(SnapshotReader2DSW &p_reader);
+	virtual void clear_state() { P = Vector2(); }
+
 	void set_param(Physics2DServer::PinJointParam p_param, real_t p_value);
 	real_t get_param(Physics2DServer::PinJointParam p_param) const;
 
@@ -121,6 +136,10 @@ public:
 	virtual bool setup(real_t p_step);
 	virtual void solve(real_t p_step);
 
+	virtual bool save_state(SnapshotWriter2DSW &r_writer) const;
+	virtual void load_state(SnapshotReader2DSW &p_reader);
+	virtual void clear_state() { jn_acc = Vector2(); }
+
 	GrooveJoint2DSW(const Vector2 &p_a_groove1, const Vector2 &p_a_groove2, const Vector2 &p_b_anchor, Body2DSW *p_body_a, Body2DSW *p_body_b);
 	~GrooveJoint2DSW();
 };
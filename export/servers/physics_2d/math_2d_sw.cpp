@@ -0,0 +1,173 @@
+/*************************************************************************/
+/*  math_2d_sw.cpp                                                       */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "math_2d_sw.h"
+
+#ifdef PHYSICS_2D_DETERMINISTIC
+
+// Only additions, multiplications, divisions, floor() and ldexp() are used below, so the
+// results are the same on every platform. The reductions split their constants in a high
+// part with trailing zero bits and a low part, so k * high is exact (as in fdlibm).
+
+static const double PI_2_HIGH = 1.57079632673412561417e+00;
+static const double PI_2_LOW = 6.07710050650619224932e-11;
+static const double LN2_HIGH = 6.93147180369123816490e-01;
+static const double LN2_LOW = 1.90821492927058770002e-10;
+
+// beyond this the reduction loses all precision, and the quadrant doesn't fit an int64
+static const double MAX_REDUCED = 1e15;
+
+// Taylor series, accurate to double precision for |p_x| <= pi / 4
+static double _sin_kernel(double p_x) {
+
+	double x2 = p_x * p_x;
+	return p_x * (1.0 - x2 / 6.0 * (1.0 - x2 / 20.0 * (1.0 - x2 / 42.0 * (1.0 - x2 / 72.0 * (1.0 - x2 / 110.0 * (1.0 - x2 / 156.0 * (1.0 - x2 / 210.0)))))));
+}
+
+static double _cos_kernel(double p_x) {
+
+	double x2 = p_x * p_x;
+	return 1.0 - x2 / 2.0 * (1.0 - x2 / 12.0 * (1.0 - x2 / 30.0 * (1.0 - x2 / 56.0 * (1.0 - x2 / 90.0 * (1.0 - x2 / 132.0 * (1.0 - x2 / 182.0 * (1.0 - x2 / 240.0)))))));
+}
+
+// p_x = quadrant * pi / 2 + result, with |result| <= pi / 4
+static double _reduce_quadrant(double p_x, int &r_quadrant) {
+
+	double k = Math::floor(p_x / Math_PI * 2.0 + 0.5);
+	r_quadrant = int(int64_t(k) & 3);
+	return (p_x - k * PI_2_HIGH) - k * PI_2_LOW;
+}
+
+double Math2DSW::sin(double p_x) {
+
+	if (!(Math::abs(p_x) < MAX_REDUCED)) {
+		return p_x - p_x; // NaN
+	}
+
+	int quadrant;
+	double x = _reduce_quadrant(p_x, quadrant);
+
+	switch (quadrant) {
+		case 0:
+			return _sin_kernel(x);
+		case 1:
+			return _cos_kernel(x);
+		case 2:
+			return -_sin_kernel(x);
+		default:
+			return -_cos_kernel(x);
+	}
+}
+
+double Math2DSW::cos(double p_x) {
+
+	if (!(Math::abs(p_x) < MAX_REDUCED)) {
+		return p_x - p_x; // NaN
+	}
+
+	int quadrant;
+	double x = _reduce_quadrant(p_x, quadrant);
+
+	switch (quadrant) {
+		case 0:
+			return _cos_kernel(x);
+		case 1:
+			return -_sin_kernel(x);
+		case 2:
+			return -_cos_kernel(x);
+		default:
+			return _sin_kernel(x);
+	}
+}
+
+// atan() of 0 <= p_x <= inf
+static double _atan(double p_x) {
+
+	bool inverted = p_x > 1.0;
+	double x = inverted ? 1.0 / p_x : p_x;
+
+	// atan(x) = pi / 4 + atan((x - 1) / (x + 1)), which leaves |x| <= tan(pi / 8)
+	bool shifted = x > 0.41421356237309503;
+	if (shifted) {
+		x = (x - 1.0) / (x + 1.0);
+	}
+
+	// enough terms of the series for double precision at tan(pi / 8)
+	const int terms = 20;
+	double x2 = x * x;
+	double sum = 1.0 / (2 * terms + 1);
+	for (int i = terms - 1; i >= 0; i--) {
+		sum = 1.0 / (2 * i + 1) - x2 * sum;
+	}
+
+	double result = x * sum;
+	if (shifted) {
+		result += Math_PI / 4.0;
+	}
+
+	return inverted ? Math_PI / 2.0 - result : result;
+}
+
+double Math2DSW::atan2(double p_y, double p_x) {
+
+	if (p_x == 0.0 && p_y == 0.0) {
+		return 0.0;
+	}
+
+	double angle = _atan(Math::abs(p_y) / Math::abs(p_x));
+	if (p_x < 0.0) {
+		angle = Math_PI - angle;
+	}
+
+	return p_y < 0.0 ? -angle : angle;
+}
+
+double Math2DSW::exp(double p_x) {
+
+	if (p_x > 709.0) {
+		return Math_INF;
+	}
+	if (p_x < -745.0) {
+		return 0.0;
+	}
+
+	// p_x = k * ln(2) + x, with |x| <= ln(2) / 2
+	double k = Math::floor(p_x / Math_LN2 + 0.5);
+	double x = (p_x - k * LN2_HIGH) - k * LN2_LOW;
+
+	double sum = 1.0;
+	for (int i = 13; i >= 1; i--) {
+		sum = 1.0 + x / i * sum;
+	}
+
+	return ::ldexp(sum, int(k));
+}
+
+#endif
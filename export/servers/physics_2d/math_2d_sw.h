@@ -0,0 +1,68 @@
+/*************************************************************************/
+/*  math_2d_sw.h                                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef MATH_2D_SW_H
+#define MATH_2D_SW_H
+
+#include "core/math/transform_2d.h"
+
+// Math the 2D server needs besides arithmetic and square roots, which IEEE 754 rounds
+// the same everywhere. Builds with PHYSICS_2D_DETERMINISTIC (deterministic_physics_2d=yes)
+// compute it here instead of with the C library, whose results differ between platforms.
+// Otherwise these just call Math.
+class Math2DSW {
+public:
+#ifdef PHYSICS_2D_DETERMINISTIC
+	static double sin(double p_x);
+	static double cos(double p_x);
+	static double atan2(double p_y, double p_x);
+	static double exp(double p_x);
+
+	// Transform2D::get_rotation() with the atan2() above, the angle is read off the x axis, a
+	// flipped basis (negative determinant) keeps the flip in its y axis, as in get_scale()
+	static _FORCE_INLINE_ real_t get_rotation(const Transform2D &p_transform) { return atan2(p_transform.elements[0].y, p_transform.elements[0].x); }
+#else
+	static _FORCE_INLINE_ real_t sin(real_t p_x) { return Math::sin(p_x); }
+	static _FORCE_INLINE_ real_t cos(real_t p_x) { return Math::cos(p_x); }
+	static _FORCE_INLINE_ real_t atan2(real_t p_y, real_t p_x) { return Math::atan2(p_y, p_x); }
+	static _FORCE_INLINE_ real_t exp(real_t p_x) { return Math::exp(p_x); }
+
+	static _FORCE_INLINE_ real_t get_rotation(const Transform2D &p_transform) { return p_transform.get_rotation(); }
+#endif
+
+	// same as Transform2D(p_rotation, p_origin)
+	static _FORCE_INLINE_ Transform2D transform(real_t p_rotation, const Vector2 &p_origin) {
+		real_t cr = cos(p_rotation);
+		real_t sr = sin(p_rotation);
+		return Transform2D(cr, sr, -sr, cr, p_origin.x, p_origin.y);
+	}
+};
+
+#endif // MATH_2D_SW_H
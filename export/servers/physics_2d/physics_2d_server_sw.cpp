@@ -30,6 +30,7 @@
 
 #include "physics_2d_server_sw.h"
 #include "broad_phase_2d_basic.h"
+#include "broad_phase_2d_bvh.h"
 #include "broad_phase_2d_hash_grid.h"
 #include "collision_solver_2d_sw.h"
 #include "core/os/os.h"
@@ -39,6 +40,9 @@
 #define FLUSH_QUERY_CHECK(m_object) \
 	ERR_FAIL_COND_MSG(m_object->get_space() && flushing_queries, "Can't change this state while flushing queries. Use call_deferred() or set_deferred() to change monitoring state instead.");
 
+// about 5 seconds at 60 steps per second, longer than the monitors take between two readings
+#define NARROWPHASE_TIMING_STEPS 300
+
 RID Physics2DServerSW::_shape_create(ShapeType p_shape) {
 
 	Shape2DSW *shape = NULL;
@@ -303,6 +307,20 @@ int Physics2DServerSW::space_get_contact_count(RID p_space) const {
 	return space->get_debug_contact_count();
 }
 
+PoolVector<uint8_t> Physics2DServerSW::space_get_snapshot(RID p_space) const {
+
+	Space2DSW *space = space_owner.get(p_space);
+	ERR_FAIL_COND_V(!space, PoolVector<uint8_t>());
+	return space->get_snapshot();
+}
+
+Error Physics2DServerSW::space_restore_snapshot(RID p_space, const PoolVector<uint8_t> &p_snapshot) {
+
+	Space2DSW *space = space_owner.get(p_space);
+	ERR_FAIL_COND_V(!space, ERR_INVALID_PARAMETER);
+	return space->restore_snapshot(p_snapshot);
+}
+
 Physics2DDirectSpaceState *Physics2DServerSW::space_get_direct_state(RID p_space) {
 
 	Space2DSW *space = space_owner.get(p_space);
@@ -575,6 +593,14 @@ void Physics2DServerSW::area_set_area_monitor_callback(RID p_area, Object *p_rec
 	area->set_area_monitor_callback(p_receiver ? p_receiver->get_instance_id() : 0, p_method);
 }
 
+void Physics2DServerSW::area_set_monitor_batching(RID p_area, bool p_enable) {
+
+	Area2DSW *area = area_owner.get(p_area);
+	ERR_FAIL_COND(!area);
+
+	area->set_monitor_batching(p_enable);
+}
+
 /* BODY API */
 
 RID Physics2DServerSW::body_create() {
@@ -1061,6 +1087,28 @@ int Physics2DServerSW::body_test_ray_separation(RID p_body, const Transform2D &p
 	return body->get_space()->test_body_ray_separation(body, p_transform, p_infinite_inertia, r_recover_motion, r_results, p_result_max, p_margin);
 }
 
+void Physics2DServerSW::body_begin_motion_batch(RID p_body, const Transform2D &p_from, real_t p_max_distance, real_t p_margin) {
+
+	Body2DSW *body = body_owner.get(p_body);
+	ERR_FAIL_COND(!body);
+	ERR_FAIL_COND(!body->get_space());
+	ERR_FAIL_COND(body->get_space()->is_locked());
+
+	_update_shapes();
+
+	body->get_space()->begin_motion_batch(body, p_from, p_max_distance, p_margin);
+}
+
+void Physics2DServerSW::body_end_motion_batch(RID p_body) {
+
+	Body2DSW *body = body_owner.get(p_body);
+	ERR_FAIL_COND(!body);
+
+	if (body->get_space()) {
+		body->get_space()->end_motion_batch(body);
+	}
+}
+
 Physics2DDirectBodyState *Physics2DServerSW::body_get_direct_state(RID p_body) {
 
 	ERR_FAIL_COND_V_MSG((using_threads && !doing_sync), NULL, "Body state is inaccessible right now, wait for iteration or physics process notification.");
@@ -1331,12 +1379,25 @@ void Physics2DServerSW::step(real_t p_step) {
 	island_count = 0;
 	active_objects = 0;
 	collision_pairs = 0;
+	for (int i = 0; i < Space2DSW::ELAPSED_TIME_MAX; i++) {
+		phase_time[i] = 0;
+	}
+
+	bool time_narrowphase = narrowphase_timing || narrowphase_timing_steps > 0 || (ScriptDebugger::get_singleton() && ScriptDebugger::get_singleton()->is_profiling());
+	if (narrowphase_timing_steps > 0) {
+		narrowphase_timing_steps--;
+	}
+
 	for (Set<const Space2DSW *>::Element *E = active_spaces.front(); E; E = E->next()) {
 
+		((Space2DSW *)E->get())->set_narrowphase_timed(time_narrowphase);
 		stepper->step((Space2DSW *)E->get(), p_step, iterations);
 		island_count += E->get()->get_island_count();
 		active_objects += E->get()->get_active_objects();
 		collision_pairs += E->get()->get_collision_pairs();
+		for (int i = 0; i < Space2DSW::ELAPSED_TIME_MAX; i++) {
+			phase_time[i] += E->get()->get_elapsed_time(Space2DSW::ElapsedTime(i));
+		}
 	}
 };
 
@@ -1361,6 +1422,7 @@ void Physics2DServerSW::flush_queries() {
 	}
 
 	flushing_queries = false;
+	query_callbacks_time = OS::get_singleton()->get_ticks_usec() - time_beg;
 
 	if (ScriptDebugger::get_singleton() && ScriptDebugger::get_singleton()->is_profiling()) {
 
@@ -1370,7 +1432,10 @@ void Physics2DServerSW::flush_queries() {
 			"generate_islands",
 			"setup_constraints",
 			"solve_constraints",
-			"integrate_velocities"
+			"integrate_velocities",
+			"broadphase",
+			"pair_generation",
+			"narrowphase"
 		};
 
 		for (int i = 0; i < Space2DSW::ELAPSED_TIME_MAX; i++) {
@@ -1405,6 +1470,7 @@ void Physics2DServerSW::finish() {
 
 	memdelete(stepper);
 	memdelete(direct_state);
+	query_work_pool.finish();
 };
 
 void Physics2DServerSW::_update_shapes() {
@@ -1415,6 +1481,52 @@ void Physics2DServerSW::_update_shapes() {
 	}
 }
 
+ThreadWorkPool *Physics2DServerSW::lock_query_work_pool() {
+
+	if (query_work_pool_mutex.try_lock() != OK) {
+		return NULL;
+	}
+
+	if (!query_work_pool.is_initialized()) {
+		query_work_pool.init();
+	}
+
+	return &query_work_pool;
+}
+
+void Physics2DServerSW::unlock_query_work_pool() {
+
+	query_work_pool_mutex.unlock();
+}
+
+uint64_t Physics2DServerSW::space_get_elapsed_time(RID p_space, Space2DSW::ElapsedTime p_time) const {
+
+	const Space2DSW *space = space_owner.get(p_space);
+	ERR_FAIL_COND_V(!space, 0);
+	ERR_FAIL_INDEX_V(p_time, Space2DSW::ELAPSED_TIME_MAX, 0);
+	if (p_time == Space2DSW::ELAPSED_TIME_NARROWPHASE) {
+		narrowphase_timing_steps = NARROWPHASE_TIMING_STEPS;
+	}
+	return space->get_elapsed_time(p_time);
+}
+
+void Physics2DServerSW::set_narrowphase_timing_enabled(bool p_enabled) {
+
+	narrowphase_timing = p_enabled;
+}
+
+void Physics2DServerSW::set_solver_thread_count(int p_count) {
+
+	ERR_FAIL_COND(!stepper);
+	stepper->set_thread_count(p_count);
+}
+
+int Physics2DServerSW::get_solver_thread_count() const {
+
+	ERR_FAIL_COND_V(!stepper, 1);
+	return stepper->get_thread_count();
+}
+
 int Physics2DServerSW::get_process_info(ProcessInfo p_info) {
 
 	switch (p_info) {
@@ -1430,6 +1542,31 @@ int Physics2DServerSW::get_process_info(ProcessInfo p_info) {
 
 			return island_count;
 		} break;
+		case INFO_BROADPHASE_TIME: {
+			return phase_time[Space2DSW::ELAPSED_TIME_BROADPHASE];
+		} break;
+		case INFO_PAIR_GENERATION_TIME: {
+			return phase_time[Space2DSW::ELAPSED_TIME_PAIR_GENERATION];
+		} break;
+		case INFO_NARROWPHASE_TIME: {
+			narrowphase_timing_steps = NARROWPHASE_TIMING_STEPS;
+			return phase_time[Space2DSW::ELAPSED_TIME_NARROWPHASE];
+		} break;
+		case INFO_GENERATE_ISLANDS_TIME: {
+			return phase_time[Space2DSW::ELAPSED_TIME_GENERATE_ISLANDS];
+		} break;
+		case INFO_SETUP_CONSTRAINTS_TIME: {
+			return phase_time[Space2DSW::ELAPSED_TIME_SETUP_CONSTRAINTS];
+		} break;
+		case INFO_SOLVE_CONSTRAINTS_TIME: {
+			return phase_time[Space2DSW::ELAPSED_TIME_SOLVE_CONSTRAINTS];
+		} break;
+		case INFO_INTEGRATE_TIME: {
+			return phase_time[Space2DSW::ELAPSED_TIME_INTEGRATE_FORCES] + phase_time[Space2DSW::ELAPSED_TIME_INTEGRATE_VELOCITIES];
+		} break;
+		case INFO_QUERY_CALLBACKS_TIME: {
+			return query_callbacks_time;
+		} break;
 	}
 
 	return 0;
@@ -1440,13 +1577,27 @@ Physics2DServerSW *Physics2DServerSW::singletonsw = NULL;
 Physics2DServerSW::Physics2DServerSW() {
 
 	singletonsw = this;
-	BroadPhase2DSW::create_func = BroadPhase2DHashGrid::_create;
+
+	bool use_bvh_or_hash_grid = GLOBAL_GET("physics/2d/use_bvh");
+
+	if (use_bvh_or_hash_grid) {
+		BroadPhase2DSW::create_func = BroadPhase2DBVH::_create;
+	} else {
+		BroadPhase2DSW::create_func = BroadPhase2DHashGrid::_create;
+	}
 	//BroadPhase2DSW::create_func=BroadPhase2DBasic::_create;
 
 	active = true;
 	island_count = 0;
 	active_objects = 0;
 	collision_pairs = 0;
+	query_callbacks_time = 0;
+	narrowphase_timing = false;
+	narrowphase_timing_steps = 0;
+	for (int i = 0; i < Space2DSW::ELAPSED_TIME_MAX; i++) {
+		phase_time[i] = 0;
+	}
+	stepper = NULL;
 #ifdef NO_THREADS
 	using_threads = false;
 #else
@@ -31,6 +31,8 @@
 #ifndef PHYSICS_2D_SERVER_SW
 #define PHYSICS_2D_SERVER_SW
 
+#include "core/os/mutex.h"
+#include "core/os/thread_work_pool.h"
 #include "joints_2d_sw.h"
 #include "servers/physics_2d_server.h"
 #include "shape_2d_sw.h"
@@ -51,6 +53,10 @@ class Physics2DServerSW : public Physics2DServer {
 	int island_count;
 	int active_objects;
 	int collision_pairs;
+	uint64_t phase_time[Space2DSW::ELAPSED_TIME_MAX]; // summed over the active spaces
+	uint64_t query_callbacks_time;
+	bool narrowphase_timing;
+	mutable int narrowphase_timing_steps; // left before the narrow phase stops being timed, renewed when its time is read
 
 	bool using_threads;
 
@@ -59,6 +65,9 @@ class Physics2DServerSW : public Physics2DServer {
 	Step2DSW *stepper;
 	Set<const Space2DSW *> active_spaces;
 
+	ThreadWorkPool query_work_pool;
+	Mutex query_work_pool_mutex;
+
 	Physics2DDirectBodyStateSW *direct_state;
 
 	mutable RID_Owner<Shape2DSW> shape_owner;
@@ -121,6 +130,9 @@ public:
 	virtual Vector<Vector2> space_get_contacts(RID p_space) const;
 	virtual int space_get_contact_count(RID p_space) const;
 
+	virtual PoolVector<uint8_t> space_get_snapshot(RID p_space) const;
+	virtual Error space_restore_snapshot(RID p_space, const PoolVector<uint8_t> &p_snapshot);
+
 	// this function only works on physics process, errors and returns null otherwise
 	virtual Physics2DDirectSpaceState *space_get_direct_state(RID p_space);
 
@@ -164,6 +176,7 @@ public:
 
 	virtual void area_set_monitor_callback(RID p_area, Object *p_receiver, const StringName &p_method);
 	virtual void area_set_area_monitor_callback(RID p_area, Object *p_receiver, const StringName &p_method);
+	virtual void area_set_monitor_batching(RID p_area, bool p_enable);
 
 	virtual void area_set_pickable(RID p_area, bool p_pickable);
 
@@ -250,6 +263,8 @@ public:
 
 	virtual bool body_test_motion(RID p_body, const Transform2D &p_from, const Vector2 &p_motion, bool p_infinite_inertia, real_t p_margin = 0.001, MotionResult *r_result = NULL, bool p_exclude_raycast_shapes = true);
 	virtual int body_test_ray_separation(RID p_body, const Transform2D &p_transform, bool p_infinite_inertia, Vector2 &r_recover_motion, SeparationResult *r_results, int p_result_max, float p_margin = 0.001);
+	virtual void body_begin_motion_batch(RID p_body, const Transform2D &p_from, real_t p_max_distance, real_t p_margin = 0.001);
+	virtual void body_end_motion_batch(RID p_body);
 
 	// this function only works on physics process, errors and returns null otherwise
 	virtual Physics2DDirectBodyState *body_get_direct_state(RID p_body);
@@ -288,6 +303,21 @@ public:
 
 	int get_process_info(ProcessInfo p_info);
 
+	// microseconds spent in each phase of the last step of the space
+	uint64_t space_get_elapsed_time(RID p_space, Space2DSW::ElapsedTime p_time) const;
+
+	// the narrow phase is only timed while the profiler runs, for a few seconds after its time
+	// was last read, or always once enabled here, so the first reading may be 0
+	void set_narrowphase_timing_enabled(bool p_enabled);
+
+	// threads used to set up and solve independent islands, 0 uses one per logical core
+	void set_solver_thread_count(int p_count);
+	int get_solver_thread_count() const;
+
+	// pool shared by threaded batch queries, NULL while another batch uses it
+	ThreadWorkPool *lock_query_work_pool();
+	void unlock_query_work_pool();
+
 	Physics2DServerSW();
 	~Physics2DServerSW();
 };
@@ -130,6 +130,9 @@ public:
 		return physics_2d_server->space_get_contact_count(p_space);
 	}
 
+	FUNC1RC(PoolVector<uint8_t>, space_get_snapshot, RID);
+	FUNC2R(Error, space_restore_snapshot, RID, const PoolVector<uint8_t> &);
+
 	/* AREA API */
 
 	//FUNC0RID(area);
@@ -172,6 +175,7 @@ public:
 
 	FUNC3(area_set_monitor_callback, RID, Object *, const StringName &);
 	FUNC3(area_set_area_monitor_callback, RID, Object *, const StringName &);
+	FUNC2(area_set_monitor_batching, RID, bool);
 
 	/* BODY API */
 
@@ -268,6 +272,18 @@ public:
 		return physics_2d_server->body_test_ray_separation(p_body, p_transform, p_infinite_inertia, r_recover_motion, r_results, p_result_max, p_margin);
 	}
 
+	void body_begin_motion_batch(RID p_body, const Transform2D &p_from, real_t p_max_distance, real_t p_margin = 0.001) {
+
+		ERR_FAIL_COND(main_thread != Thread::get_caller_id());
+		physics_2d_server->body_begin_motion_batch(p_body, p_from, p_max_distance, p_margin);
+	}
+
+	void body_end_motion_batch(RID p_body) {
+
+		ERR_FAIL_COND(main_thread != Thread::get_caller_id());
+		physics_2d_server->body_end_motion_batch(p_body);
+	}
+
 	// this function only works on physics process, errors and returns null otherwise
 	Physics2DDirectBodyState *body_get_direct_state(RID p_body) {
 
@@ -31,6 +31,7 @@
 #include "space_2d_sw.h"
 
 #include "collision_solver_2d_sw.h"
+#include "core/local_vector.h"
 #include "core/os/os.h"
 #include "core/pair.h"
 #include "physics_2d_server_sw.h"
@@ -113,6 +114,28 @@ int Physics2DDirectSpaceStateSW::intersect_point_on_canvas(const Vector2 &p_poin
 	return _intersect_point_impl(p_point, r_results, p_result_max, p_exclude, p_collision_mask, p_collide_with_bodies, p_collide_with_areas, p_pick_point, true, p_canvas_instance_id);
 }
 
+// Segment against a single shape of an object, point and normal are returned in world space.
+_FORCE_INLINE_ static bool _intersect_ray_shape(const CollisionObject2DSW *p_object, int p_shape_idx, const Vector2 &p_from, const Vector2 &p_to, Vector2 &r_point, Vector2 &r_normal) {
+
+	Transform2D inv_xform = p_object->get_shape_inv_transform(p_shape_idx) * p_object->get_inv_transform();
+
+	Vector2 local_from = inv_xform.xform(p_from);
+	Vector2 local_to = inv_xform.xform(p_to);
+
+	const Shape2DSW *shape = p_object->get_shape(p_shape_idx);
+
+	Vector2 shape_point, shape_normal;
+
+	if (!shape->intersect_segment(local_from, local_to, shape_point, shape_normal))
+		return false;
+
+	Transform2D xform = p_object->get_transform() * p_object->get_shape_transform(p_shape_idx);
+	r_point = xform.xform(shape_point);
+	r_normal = inv_xform.basis_xform_inv(shape_normal).normalized();
+
+	return true;
+}
+
 bool Physics2DDirectSpaceStateSW::intersect_ray(const Vector2 &p_from, const Vector2 &p_to, RayResult &r_result, const Set<RID> &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas) {
 
 	ERR_FAIL_COND_V(space->locked, false);
@@ -144,25 +167,10 @@ bool Physics2DDirectSpaceStateSW::intersect_ray(const Vector2 &p_from, const Vec
 		const CollisionObject2DSW *col_obj = space->intersection_query_results[i];
 
 		int shape_idx = space->intersection_query_subindex_results[i];
-		Transform2D inv_xform = col_obj->get_shape_inv_transform(shape_idx) * col_obj->get_inv_transform();
-
-		Vector2 local_from = inv_xform.xform(begin);
-		Vector2 local_to = inv_xform.xform(end);
-
-		/*local_from = col_obj->get_inv_transform().xform(begin);
-		local_from = col_obj->get_shape_inv_transform(shape_idx).xform(local_from);
-
-		local_to = col_obj->get_inv_transform().xform(end);
-		local_to = col_obj->get_shape_inv_transform(shape_idx).xform(local_to);*/
-
-		const Shape2DSW *shape = col_obj->get_shape(shape_idx);
 
 		Vector2 shape_point, shape_normal;
 
-		if (shape->intersect_segment(local_from, local_to, shape_point, shape_normal)) {
-
-			Transform2D xform = col_obj->get_transform() * col_obj->get_shape_transform(shape_idx);
-			shape_point = xform.xform(shape_point);
+		if (_intersect_ray_shape(col_obj, shape_idx, begin, end, shape_point, shape_normal)) {
 
 			real_t ld = normal.dot(shape_point);
 
@@ -170,7 +178,7 @@ bool Physics2DDirectSpaceStateSW::intersect_ray(const Vector2 &p_from, const Vec
 
 				min_d = ld;
 				res_point = shape_point;
-				res_normal = inv_xform.basis_xform_inv(shape_normal).normalized();
+				res_normal = shape_normal;
 				res_shape = shape_idx;
 				res_obj = col_obj;
 				collided = true;
@@ -238,6 +246,50 @@ int Physics2DDirectSpaceStateSW::intersect_shape(const RID &p_shape, const Trans
 	return cc;
 }
 
+// Finds how far along p_motion the shape can travel before touching a single
+// shape of an object. Returns false if it never touches it or starts inside it.
+static bool _cast_motion_shape(const Shape2DSW *p_shape, const Transform2D &p_xform, const Vector2 &p_motion, real_t p_margin, const CollisionObject2DSW *p_object, int p_shape_idx, real_t &r_low, real_t &r_hi) {
+
+	const Shape2DSW *col_shape = p_object->get_shape(p_shape_idx);
+	Transform2D col_obj_xform = p_object->get_transform() * p_object->get_shape_transform(p_shape_idx);
+	//test initial overlap, does it collide if going all the way?
+	if (!CollisionSolver2DSW::solve(p_shape, p_xform, p_motion, col_shape, col_obj_xform, Vector2(), NULL, NULL, NULL, p_margin)) {
+		return false;
+	}
+
+	//test initial overlap, ignore objects it's inside of.
+	if (CollisionSolver2DSW::solve(p_shape, p_xform, Vector2(), col_shape, col_obj_xform, Vector2(), NULL, NULL, NULL, p_margin)) {
+
+		return false;
+	}
+
+	//just do kinematic solving
+	real_t low = 0;
+	real_t hi = 1;
+	Vector2 mnormal = p_motion.normalized();
+
+	for (int j = 0; j < 8; j++) { //steps should be customizable..
+
+		real_t ofs = (low + hi) * 0.5;
+
+		Vector2 sep = mnormal; //important optimization for this to work fast enough
+		bool collided = CollisionSolver2DSW::solve(p_shape, p_xform, p_motion * ofs, col_shape, col_obj_xform, Vector2(), NULL, NULL, &sep, p_margin);
+
+		if (collided) {
+
+			hi = ofs;
+		} else {
+
+			low = ofs;
+		}
+	}
+
+	r_low = low;
+	r_hi = hi;
+
+	return true;
+}
+
 bool Physics2DDirectSpaceStateSW::cast_motion(const RID &p_shape, const Transform2D &p_xform, const Vector2 &p_motion, real_t p_margin, real_t &p_closest_safe, real_t &p_closest_unsafe, const Set<RID> &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas) {
 
 	Shape2DSW *shape = Physics2DServerSW::singletonsw->shape_owner.get(p_shape);
@@ -263,38 +315,10 @@ bool Physics2DDirectSpaceStateSW::cast_motion(const RID &p_shape, const Transfor
 		const CollisionObject2DSW *col_obj = space->intersection_query_results[i];
 		int shape_idx = space->intersection_query_subindex_results[i];
 
-		Transform2D col_obj_xform = col_obj->get_transform() * col_obj->get_shape_transform(shape_idx);
-		//test initial overlap, does it collide if going all the way?
-		if (!CollisionSolver2DSW::solve(shape, p_xform, p_motion, col_obj->get_shape(shape_idx), col_obj_xform, Vector2(), NULL, NULL, NULL, p_margin)) {
-			continue;
-		}
-
-		//test initial overlap, ignore objects it's inside of.
-		if (CollisionSolver2DSW::solve(shape, p_xform, Vector2(), col_obj->get_shape(shape_idx), col_obj_xform, Vector2(), NULL, NULL, NULL, p_margin)) {
+		real_t low, hi;
 
+		if (!_cast_motion_shape(shape, p_xform, p_motion, p_margin, col_obj, shape_idx, low, hi))
 			continue;
-		}
-
-		//just do kinematic solving
-		real_t low = 0;
-		real_t hi = 1;
-		Vector2 mnormal = p_motion.normalized();
-
-		for (int j = 0; j < 8; j++) { //steps should be customizable..
-
-			real_t ofs = (low + hi) * 0.5;
-
-			Vector2 sep = mnormal; //important optimization for this to work fast enough
-			bool collided = CollisionSolver2DSW::solve(shape, p_xform, p_motion * ofs, col_obj->get_shape(shape_idx), col_obj_xform, Vector2(), NULL, NULL, &sep, p_margin);
-
-			if (collided) {
-
-				hi = ofs;
-			} else {
-
-				low = ofs;
-			}
-		}
 
 		if (low < best_safe) {
 			best_safe = low;
@@ -409,6 +433,29 @@ static void _rest_cbk_result(const Vector2 &p_point_A, const Vector2 &p_point_B,
 	rd->best_local_shape = rd->local_shape;
 }
 
+static bool _rest_info_result(const _RestCallbackData2D &p_rcd, Physics2DDirectSpaceState::ShapeRestInfo *r_info) {
+
+	if (p_rcd.best_len == 0 || !p_rcd.best_object)
+		return false;
+
+	r_info->collider_id = p_rcd.best_object->get_instance_id();
+	r_info->shape = p_rcd.best_shape;
+	r_info->normal = p_rcd.best_normal;
+	r_info->point = p_rcd.best_contact;
+	r_info->rid = p_rcd.best_object->get_self();
+	if (p_rcd.best_object->get_type() == CollisionObject2DSW::TYPE_BODY) {
+
+		const Body2DSW *body = static_cast<const Body2DSW *>(p_rcd.best_object);
+		Vector2 rel_vec = r_info->point - body->get_transform().get_origin();
+		r_info->linear_velocity = Vector2(-body->get_angular_velocity() * rel_vec.y, body->get_angular_velocity() * rel_vec.x) + body->get_linear_velocity();
+
+	} else {
+		r_info->linear_velocity = Vector2();
+	}
+
+	return true;
+}
+
 bool Physics2DDirectSpaceStateSW::rest_info(RID p_shape, const Transform2D &p_shape_xform, const Vector2 &p_motion, real_t p_margin, ShapeRestInfo *r_info, const Set<RID> &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas) {
 
 	Shape2DSW *shape = Physics2DServerSW::singletonsw->shape_owner.get(p_shape);
@@ -446,26 +493,470 @@ bool Physics2DDirectSpaceStateSW::rest_info(RID p_shape, const Transform2D &p_sh
 			continue;
 	}
 
-	if (rcd.best_len == 0 || !rcd.best_object)
+	if (!_rest_info_result(rcd, r_info))
 		return false;
 
-	r_info->collider_id = rcd.best_object->get_instance_id();
-	r_info->shape = rcd.best_shape;
-	r_info->normal = rcd.best_normal;
-	r_info->point = rcd.best_contact;
-	r_info->rid = rcd.best_object->get_self();
 	r_info->metadata = rcd.best_object->get_shape_metadata(rcd.best_shape);
-	if (rcd.best_object->get_type() == CollisionObject2DSW::TYPE_BODY) {
 
-		const Body2DSW *body = static_cast<const Body2DSW *>(rcd.best_object);
-		Vector2 rel_vec = r_info->point - body->get_transform().get_origin();
-		r_info->linear_velocity = Vector2(-body->get_angular_velocity() * rel_vec.y, body->get_angular_velocity() * rel_vec.x) + body->get_linear_velocity();
+	return true;
+}
+
+/* Batched queries */
+
+// Queries are sorted along a Morton curve so neighbouring ones end up in the
+// same chunk. The broadphase is culled once per chunk, and each query of the
+// chunk only runs the narrow phase against the candidates overlapping it.
+
+#define BATCH_CHUNK_MAX 32
+
+struct _BatchQuery2DSW {
+
+	Rect2 aabb;
+	uint32_t code;
+	int index;
+
+	_FORCE_INLINE_ bool operator<(const _BatchQuery2DSW &p_query) const { return code < p_query.code; }
+};
+
+struct _BatchCandidate2DSW {
 
+	const CollisionObject2DSW *object;
+	int shape;
+	Rect2 aabb;
+};
+
+struct _BatchChunk2DSW {
+
+	int query_from;
+	int query_to;
+	int candidate_from;
+	int candidate_to;
+};
+
+struct _Batch2DSW {
+
+	LocalVector<_BatchQuery2DSW> queries;
+	LocalVector<_BatchChunk2DSW> chunks;
+	LocalVector<_BatchCandidate2DSW> candidates;
+};
+
+_FORCE_INLINE_ static uint32_t _batch_morton_spread(uint32_t p_value) {
+
+	p_value &= 0xFFFF;
+	p_value = (p_value | (p_value << 8)) & 0x00FF00FF;
+	p_value = (p_value | (p_value << 4)) & 0x0F0F0F0F;
+	p_value = (p_value | (p_value << 2)) & 0x33333333;
+	p_value = (p_value | (p_value << 1)) & 0x55555555;
+	return p_value;
+}
+
+_FORCE_INLINE_ static bool _batch_is_excluded(const RID *p_exclude, int p_exclude_count, const RID &p_rid) {
+
+	int low = 0;
+	int high = p_exclude_count - 1;
+
+	while (low <= high) {
+
+		int middle = (low + high) / 2;
+		if (p_exclude[middle] == p_rid)
+			return true;
+		if (p_exclude[middle] < p_rid)
+			low = middle + 1;
+		else
+			high = middle - 1;
+	}
+
+	return false;
+}
+
+void Physics2DDirectSpaceStateSW::_batch_cull(_Batch2DSW &r_batch, const RID *p_exclude, int p_exclude_count, uint32_t p_collision_layer, bool p_collide_with_bodies, bool p_collide_with_areas) {
+
+	int query_count = r_batch.queries.size();
+	if (query_count == 0)
+		return;
+
+	Rect2 bounds(r_batch.queries[0].aabb.position + r_batch.queries[0].aabb.size * 0.5, Vector2());
+	for (int i = 1; i < query_count; i++) {
+		bounds.expand_to(r_batch.queries[i].aabb.position + r_batch.queries[i].aabb.size * 0.5);
+	}
+
+	Vector2 scale;
+	for (int i = 0; i < 2; i++) {
+		scale[i] = bounds.size[i] > CMP_EPSILON ? 65535.0 / bounds.size[i] : 0.0;
+	}
+
+	for (int i = 0; i < query_count; i++) {
+
+		_BatchQuery2DSW &query = r_batch.queries[i];
+		Vector2 cell = (query.aabb.position + query.aabb.size * 0.5 - bounds.position) * scale;
+		query.code = _batch_morton_spread(cell.x) | (_batch_morton_spread(cell.y) << 1);
+	}
+
+	r_batch.queries.sort();
+
+	int from = 0;
+
+	while (from < query_count) {
+
+		int to = MIN(from + BATCH_CHUNK_MAX, query_count);
+		int amount;
+
+		while (true) {
+
+			Rect2 chunk_aabb = r_batch.queries[from].aabb;
+			for (int i = from + 1; i < to; i++) {
+				chunk_aabb = chunk_aabb.merge(r_batch.queries[i].aabb);
+			}
+
+			amount = space->broadphase->cull_aabb(chunk_aabb, space->intersection_query_results, Space2DSW::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+
+			// too spread out to share a cull, split the chunk
+			if (amount < Space2DSW::INTERSECTION_QUERY_MAX || to - from == 1)
+				break;
+
+			to = from + (to - from) / 2;
+		}
+
+		_BatchChunk2DSW chunk;
+		chunk.query_from = from;
+		chunk.query_to = to;
+		chunk.candidate_from = r_batch.candidates.size();
+
+		for (int i = 0; i < amount; i++) {
+
+			const CollisionObject2DSW *col_obj = space->intersection_query_results[i];
+
+			if (!_can_collide_with(space->intersection_query_results[i], p_collision_layer, p_collide_with_bodies, p_collide_with_areas))
+				continue;
+
+			if (_batch_is_excluded(p_exclude, p_exclude_count, col_obj->get_self()))
+				continue;
+
+			_BatchCandidate2DSW candidate;
+			candidate.object = col_obj;
+			candidate.shape = space->intersection_query_subindex_results[i];
+			candidate.aabb = col_obj->get_shape_aabb(candidate.shape);
+			r_batch.candidates.push_back(candidate);
+		}
+
+		chunk.candidate_to = r_batch.candidates.size();
+		r_batch.chunks.push_back(chunk);
+
+		from = to;
+	}
+}
+
+// p_server is only given when the batch may run threaded.
+template <class T, class S>
+static void _batch_solve(T *p_solver, const _Batch2DSW &p_batch, S *p_server) {
+
+	uint32_t chunk_count = p_batch.chunks.size();
+
+	ThreadWorkPool *work_pool = NULL;
+	if (p_server && chunk_count > 1) {
+		// NULL if another batch is already using the pool, run on this thread then
+		work_pool = p_server->lock_query_work_pool();
+	}
+
+	if (work_pool) {
+		work_pool->do_work(chunk_count, p_solver, &T::solve_chunk, &p_batch);
+		p_server->unlock_query_work_pool();
 	} else {
-		r_info->linear_velocity = Vector2();
+		for (uint32_t i = 0; i < chunk_count; i++) {
+			p_solver->solve_chunk(i, &p_batch);
+		}
 	}
+}
 
-	return true;
+struct _RayBatchSolver2DSW {
+
+	const Vector2 *from;
+	const Vector2 *to;
+	Physics2DDirectSpaceState::RayResult *results;
+	const CollisionObject2DSW **objects;
+	bool *collided;
+
+	void solve_chunk(uint32_t p_chunk, const _Batch2DSW *p_batch) {
+
+		const _BatchChunk2DSW &chunk = p_batch->chunks[p_chunk];
+
+		for (int i = chunk.query_from; i < chunk.query_to; i++) {
+
+			int index = p_batch->queries[i].index;
+			const Vector2 &begin = from[index];
+			const Vector2 &end = to[index];
+			Vector2 normal = (end - begin).normalized();
+
+			real_t min_d = 1e10;
+			Physics2DDirectSpaceState::RayResult &result = results[index];
+			collided[index] = false;
+
+			for (int j = chunk.candidate_from; j < chunk.candidate_to; j++) {
+
+				const _BatchCandidate2DSW &candidate = p_batch->candidates[j];
+
+				if (!candidate.aabb.intersects_segment(begin, end))
+					continue;
+
+				Vector2 shape_point, shape_normal;
+
+				if (!_intersect_ray_shape(candidate.object, candidate.shape, begin, end, shape_point, shape_normal))
+					continue;
+
+				real_t ld = normal.dot(shape_point);
+
+				if (ld < min_d) {
+
+					min_d = ld;
+					result.position = shape_point;
+					result.normal = shape_normal;
+					result.rid = candidate.object->get_self();
+					result.collider_id = candidate.object->get_instance_id();
+					result.shape = candidate.shape;
+					objects[index] = candidate.object;
+					collided[index] = true;
+				}
+			}
+		}
+	}
+};
+
+int Physics2DDirectSpaceStateSW::intersect_ray_batch(const Vector2 *p_from, const Vector2 *p_to, int p_count, RayResult *r_results, bool *r_collided, const RID *p_exclude, int p_exclude_count, uint32_t p_collision_layer, bool p_collide_with_bodies, bool p_collide_with_areas, bool p_threaded) {
+
+	// report "no hit" for every query, including when failing below
+	for (int i = 0; i < p_count; i++) {
+		r_collided[i] = false;
+	}
+
+	ERR_FAIL_COND_V(space->locked, 0);
+
+	_Batch2DSW batch;
+	batch.queries.resize(p_count);
+
+	for (int i = 0; i < p_count; i++) {
+
+		Rect2 aabb(p_from[i], Vector2());
+		aabb.expand_to(p_to[i]);
+		batch.queries[i].aabb = aabb;
+		batch.queries[i].index = i;
+	}
+
+	_batch_cull(batch, p_exclude, p_exclude_count, p_collision_layer, p_collide_with_bodies, p_collide_with_areas);
+
+	LocalVector<const CollisionObject2DSW *> objects;
+	objects.resize(p_count);
+
+	_RayBatchSolver2DSW solver;
+	solver.from = p_from;
+	solver.to = p_to;
+	solver.results = r_results;
+	solver.objects = objects.ptr();
+	solver.collided = r_collided;
+
+	_batch_solve(&solver, batch, p_threaded ? Physics2DServerSW::singletonsw : NULL);
+
+	int collided = 0;
+	for (int i = 0; i < p_count; i++) {
+
+		if (!r_collided[i])
+			continue;
+
+		// ObjectDB and metadata are looked up here rather than from the worker threads
+		r_results[i].collider = r_results[i].collider_id != 0 ? ObjectDB::get_instance(r_results[i].collider_id) : NULL;
+		r_results[i].metadata = objects[i]->get_shape_metadata(r_results[i].shape);
+		collided++;
+	}
+
+	return collided;
+}
+
+struct _CastMotionBatchSolver2DSW {
+
+	Shape2DSW *shape;
+	const Transform2D *xforms;
+	const Vector2 *motions;
+	real_t margin;
+	float *closest_safe;
+	float *closest_unsafe;
+
+	void solve_chunk(uint32_t p_chunk, const _Batch2DSW *p_batch) {
+
+		const _BatchChunk2DSW &chunk = p_batch->chunks[p_chunk];
+
+		for (int i = chunk.query_from; i < chunk.query_to; i++) {
+
+			const _BatchQuery2DSW &query = p_batch->queries[i];
+			int index = query.index;
+
+			real_t best_safe = 1;
+			real_t best_unsafe = 1;
+
+			for (int j = chunk.candidate_from; j < chunk.candidate_to; j++) {
+
+				const _BatchCandidate2DSW &candidate = p_batch->candidates[j];
+
+				if (!candidate.aabb.intersects(query.aabb))
+					continue;
+
+				real_t low, hi;
+
+				if (!_cast_motion_shape(shape, xforms[index], motions[index], margin, candidate.object, candidate.shape, low, hi))
+					continue;
+
+				if (low < best_safe) {
+					best_safe = low;
+					best_unsafe = hi;
+				}
+			}
+
+			closest_safe[index] = best_safe;
+			closest_unsafe[index] = best_unsafe;
+		}
+	}
+};
+
+int Physics2DDirectSpaceStateSW::cast_motion_batch(const RID &p_shape, const Transform2D *p_xforms, const Vector2 *p_motions, int p_count, float p_margin, float *r_closest_safe, float *r_closest_unsafe, const RID *p_exclude, int p_exclude_count, uint32_t p_collision_layer, bool p_collide_with_bodies, bool p_collide_with_areas, bool p_threaded) {
+
+	for (int i = 0; i < p_count; i++) {
+		r_closest_safe[i] = 1.0;
+		r_closest_unsafe[i] = 1.0;
+	}
+
+	Shape2DSW *shape = Physics2DServerSW::singletonsw->shape_owner.get(p_shape);
+	ERR_FAIL_COND_V(!shape, 0);
+	ERR_FAIL_COND_V(space->locked, 0);
+
+	_Batch2DSW batch;
+	batch.queries.resize(p_count);
+
+	Rect2 shape_aabb = shape->get_aabb();
+
+	for (int i = 0; i < p_count; i++) {
+
+		Rect2 aabb = p_xforms[i].xform(shape_aabb);
+		aabb = aabb.merge(Rect2(aabb.position + p_motions[i], aabb.size)); //motion
+		batch.queries[i].aabb = aabb.grow(p_margin);
+		batch.queries[i].index = i;
+	}
+
+	_batch_cull(batch, p_exclude, p_exclude_count, p_collision_layer, p_collide_with_bodies, p_collide_with_areas);
+
+	_CastMotionBatchSolver2DSW solver;
+	solver.shape = shape;
+	solver.xforms = p_xforms;
+	solver.motions = p_motions;
+	solver.margin = p_margin;
+	solver.closest_safe = r_closest_safe;
+	solver.closest_unsafe = r_closest_unsafe;
+
+	_batch_solve(&solver, batch, p_threaded ? Physics2DServerSW::singletonsw : NULL);
+
+	int collided = 0;
+	for (int i = 0; i < p_count; i++) {
+		if (r_closest_safe[i] < 1.0)
+			collided++;
+	}
+
+	return collided;
+}
+
+struct _RestInfoBatchSolver2DSW {
+
+	Shape2DSW *shape;
+	const Transform2D *xforms;
+	Vector2 motion;
+	real_t margin;
+	real_t min_allowed_depth;
+	Physics2DDirectSpaceState::ShapeRestInfo *infos;
+	const CollisionObject2DSW **objects;
+	bool *collided;
+
+	void solve_chunk(uint32_t p_chunk, const _Batch2DSW *p_batch) {
+
+		const _BatchChunk2DSW &chunk = p_batch->chunks[p_chunk];
+
+		for (int i = chunk.query_from; i < chunk.query_to; i++) {
+
+			const _BatchQuery2DSW &query = p_batch->queries[i];
+			int index = query.index;
+
+			_RestCallbackData2D rcd;
+			rcd.best_len = 0;
+			rcd.best_object = NULL;
+			rcd.best_shape = 0;
+			rcd.min_allowed_depth = min_allowed_depth;
+
+			for (int j = chunk.candidate_from; j < chunk.candidate_to; j++) {
+
+				const _BatchCandidate2DSW &candidate = p_batch->candidates[j];
+
+				if (!candidate.aabb.intersects(query.aabb))
+					continue;
+
+				rcd.valid_dir = Vector2();
+				rcd.object = candidate.object;
+				rcd.shape = candidate.shape;
+				rcd.local_shape = 0;
+				CollisionSolver2DSW::solve(shape, xforms[index], motion, candidate.object->get_shape(candidate.shape), candidate.object->get_transform() * candidate.object->get_shape_transform(candidate.shape), Vector2(), _rest_cbk_result, &rcd, NULL, margin);
+			}
+
+			collided[index] = _rest_info_result(rcd, &infos[index]);
+			objects[index] = rcd.best_object;
+		}
+	}
+};
+
+int Physics2DDirectSpaceStateSW::rest_info_batch(RID p_shape, const Transform2D *p_shape_xforms, const Vector2 &p_motion, int p_count, float p_margin, ShapeRestInfo *r_infos, bool *r_collided, const RID *p_exclude, int p_exclude_count, uint32_t p_collision_layer, bool p_collide_with_bodies, bool p_collide_with_areas, bool p_threaded) {
+
+	for (int i = 0; i < p_count; i++) {
+		r_collided[i] = false;
+	}
+
+	Shape2DSW *shape = Physics2DServerSW::singletonsw->shape_owner.get(p_shape);
+	ERR_FAIL_COND_V(!shape, 0);
+	ERR_FAIL_COND_V(space->locked, 0);
+
+	_Batch2DSW batch;
+	batch.queries.resize(p_count);
+
+	Rect2 shape_aabb = shape->get_aabb();
+
+	for (int i = 0; i < p_count; i++) {
+
+		Rect2 aabb = p_shape_xforms[i].xform(shape_aabb);
+		aabb = aabb.merge(Rect2(aabb.position + p_motion, aabb.size)); //motion
+		batch.queries[i].aabb = aabb.grow(p_margin);
+		batch.queries[i].index = i;
+	}
+
+	_batch_cull(batch, p_exclude, p_exclude_count, p_collision_layer, p_collide_with_bodies, p_collide_with_areas);
+
+	LocalVector<const CollisionObject2DSW *> objects;
+	objects.resize(p_count);
+
+	_RestInfoBatchSolver2DSW solver;
+	solver.shape = shape;
+	solver.xforms = p_shape_xforms;
+	solver.motion = p_motion;
+	solver.margin = p_margin;
+	solver.min_allowed_depth = space->test_motion_min_contact_depth;
+	solver.infos = r_infos;
+	solver.objects = objects.ptr();
+	solver.collided = r_collided;
+
+	_batch_solve(&solver, batch, p_threaded ? Physics2DServerSW::singletonsw : NULL);
+
+	int collided = 0;
+	for (int i = 0; i < p_count; i++) {
+
+		if (!r_collided[i])
+			continue;
+
+		r_infos[i].metadata = objects[i]->get_shape_metadata(r_infos[i].shape);
+		collided++;
+	}
+
+	return collided;
 }
 
 Physics2DDirectSpaceStateSW::Physics2DDirectSpaceStateSW() {
@@ -477,6 +968,22 @@ Physics2DDirectSpaceStateSW::Physics2DDirectSpaceStateSW() {
 
 int Space2DSW::_cull_aabb_for_body(Body2DSW *p_body, const Rect2 &p_aabb) {
 
+	if (p_body == motion_batch_body && motion_batch_aabb.encloses(p_aabb)) {
+
+		// The candidates are already filtered, only the ones touching the smaller box are left to pick.
+		int amount = 0;
+		for (uint32_t i = 0; i < motion_batch_objects.size(); i++) {
+
+			if (motion_batch_objects[i]->get_shape_aabb(motion_batch_subindices[i]).intersects(p_aabb)) {
+				intersection_query_results[amount] = motion_batch_objects[i];
+				intersection_query_subindex_results[amount] = motion_batch_subindices[i];
+				amount++;
+			}
+		}
+
+		return amount;
+	}
+
 	int amount = broadphase->cull_aabb(p_aabb, intersection_query_results, INTERSECTION_QUERY_MAX, intersection_query_subindex_results);
 
 	for (int i = 0; i < amount; i++) {
@@ -509,6 +1016,57 @@ int Space2DSW::_cull_aabb_for_body(Body2DSW *p_body, const Rect2 &p_aabb) {
 	return amount;
 }
 
+void Space2DSW::begin_motion_batch(Body2DSW *p_body, const Transform2D &p_from, real_t p_max_distance, real_t p_margin) {
+
+	motion_batch_body = NULL;
+
+	Rect2 body_aabb;
+	bool shapes_found = false;
+
+	for (int i = 0; i < p_body->get_shape_count(); i++) {
+
+		if (p_body->is_shape_set_as_disabled(i))
+			continue;
+
+		if (!shapes_found) {
+			body_aabb = p_body->get_shape_aabb(i);
+			shapes_found = true;
+		} else {
+			body_aabb = body_aabb.merge(p_body->get_shape_aabb(i));
+		}
+	}
+
+	if (!shapes_found) {
+		return;
+	}
+
+	// Every position the body can slide to lies within the distance, as sliding only shortens the motion left.
+	body_aabb = p_from.xform(p_body->get_inv_transform().xform(body_aabb));
+	body_aabb = body_aabb.grow(p_max_distance + p_margin * 2.0);
+
+	int amount = _cull_aabb_for_body(p_body, body_aabb);
+	if (amount == INTERSECTION_QUERY_MAX) {
+		return; // some may be missing, don't share them
+	}
+
+	motion_batch_objects.resize(amount);
+	motion_batch_subindices.resize(amount);
+	for (int i = 0; i < amount; i++) {
+		motion_batch_objects[i] = intersection_query_results[i];
+		motion_batch_subindices[i] = intersection_query_subindex_results[i];
+	}
+
+	motion_batch_aabb = body_aabb;
+	motion_batch_body = p_body;
+}
+
+void Space2DSW::end_motion_batch(Body2DSW *p_body) {
+
+	if (motion_batch_body == p_body) {
+		motion_batch_body = NULL;
+	}
+}
+
 int Space2DSW::test_body_ray_separation(Body2DSW *p_body, const Transform2D &p_transform, bool p_infinite_inertia, Vector2 &r_recover_motion, Physics2DServer::SeparationResult *r_results, int p_result_max, real_t p_margin) {
 
 	Rect2 body_aabb;
@@ -1157,7 +1715,7 @@ bool Space2DSW::test_body_motion(Body2DSW *p_body, const Transform2D &p_from, co
 	return collided;
 }
 
-void *Space2DSW::_broadphase_pair(CollisionObject2DSW *A, int p_subindex_A, CollisionObject2DSW *B, int p_subindex_B, void *p_self) {
+void *Space2DSW::_create_pair(CollisionObject2DSW *A, int p_subindex_A, CollisionObject2DSW *B, int p_subindex_B) {
 	if (!A->test_collision_mask(B)) {
 		return nullptr;
 	}
@@ -1171,8 +1729,7 @@ void *Space2DSW::_broadphase_pair(CollisionObject2DSW *A, int p_subindex_A, Coll
 		SWAP(type_A, type_B);
 	}
 
-	Space2DSW *self = (Space2DSW *)p_self;
-	self->collision_pairs++;
+	collision_pairs++;
 
 	if (type_A == CollisionObject2DSW::TYPE_AREA) {
 
@@ -1191,6 +1748,13 @@ void *Space2DSW::_broadphase_pair(CollisionObject2DSW *A, int p_subindex_A, Coll
 
 	} else {
 
+		// the order of the bodies must not depend on the broadphase, a pair that is
+		// created again after restoring a snapshot has to solve exactly the same way
+		if (A->get_self().get_id() > B->get_self().get_id()) {
+			SWAP(A, B);
+			SWAP(p_subindex_A, p_subindex_B);
+		}
+
 		BodyPair2DSW *b = memnew(BodyPair2DSW((Body2DSW *)A, p_subindex_A, (Body2DSW *)B, p_subindex_B));
 		return b;
 	}
@@ -1198,15 +1762,26 @@ void *Space2DSW::_broadphase_pair(CollisionObject2DSW *A, int p_subindex_A, Coll
 	return NULL;
 }
 
+void *Space2DSW::_broadphase_pair(CollisionObject2DSW *A, int p_subindex_A, CollisionObject2DSW *B, int p_subindex_B, void *p_self) {
+
+	Space2DSW *self = (Space2DSW *)p_self;
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	void *pair = self->_create_pair(A, p_subindex_A, B, p_subindex_B);
+	self->pair_generation_time += OS::get_singleton()->get_ticks_usec() - begin;
+	return pair;
+}
+
 void Space2DSW::_broadphase_unpair(CollisionObject2DSW *A, int p_subindex_A, CollisionObject2DSW *B, int p_subindex_B, void *p_data, void *p_self) {
 	if (!p_data) {
 		return;
 	}
 
 	Space2DSW *self = (Space2DSW *)p_self;
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
 	self->collision_pairs--;
 	Constraint2DSW *c = (Constraint2DSW *)p_data;
 	memdelete(c);
+	self->pair_generation_time += OS::get_singleton()->get_ticks_usec() - begin;
 }
 
 const SelfList<Body2DSW>::List &Space2DSW::get_active_body_list() const {
@@ -1241,12 +1816,14 @@ void Space2DSW::add_object(CollisionObject2DSW *p_object) {
 
 	ERR_FAIL_COND(objects.has(p_object));
 	objects.insert(p_object);
+	object_broadphase_changed(p_object);
 }
 
 void Space2DSW::remove_object(CollisionObject2DSW *p_object) {
 
 	ERR_FAIL_COND(!objects.has(p_object));
 	objects.erase(p_object);
+	motion_batch_body = NULL;
 }
 
 const Set<CollisionObject2DSW *> &Space2DSW::get_objects() const {
@@ -1307,6 +1884,7 @@ void Space2DSW::call_queries() {
 void Space2DSW::setup() {
 
 	contact_debug_count = 0;
+	pair_generation_time = 0;
 
 	while (inertia_update_list.first()) {
 		inertia_update_list.first()->self()->update_inertias();
@@ -1365,6 +1943,234 @@ bool Space2DSW::is_locked() const {
 	return locked;
 }
 
+// Snapshot layout: a header, then one record per body (active bodies first, in the
+// order they are simulated) and one record per constraint with state to carry over,
+// identified by its first body and its sort key. Records are prefixed with their size
+// so bodies and constraints that no longer exist when restoring are skipped.
+
+#define SNAPSHOT_MAGIC 0x50534447 // "GDSP"
+#define SNAPSHOT_VERSION 1
+
+PoolVector<uint8_t> Space2DSW::get_snapshot() {
+
+	ERR_FAIL_COND_V_MSG(locked, PoolVector<uint8_t>(), "Space snapshots can't be taken while the space is being stepped.");
+
+	LocalVector<Body2DSW *> bodies;
+
+	for (const SelfList<Body2DSW> *b = active_list.first(); b; b = b->next()) {
+		bodies.push_back(b->self());
+	}
+
+	for (const Set<CollisionObject2DSW *>::Element *E = objects.front(); E; E = E->next()) {
+		if (E->get()->get_type() == CollisionObject2DSW::TYPE_BODY) {
+			Body2DSW *body = static_cast<Body2DSW *>(E->get());
+			if (!body->is_active()) {
+				bodies.push_back(body);
+			}
+		}
+	}
+
+	snapshot_writer.clear();
+	snapshot_writer.put(uint32_t(SNAPSHOT_MAGIC));
+	snapshot_writer.put(uint32_t(SNAPSHOT_VERSION));
+	snapshot_writer.put(uint32_t(sizeof(real_t)));
+	snapshot_writer.put(uint32_t(bodies.size()));
+
+	for (uint32_t i = 0; i < bodies.size(); i++) {
+
+		snapshot_writer.put(bodies[i]->get_self().get_id());
+		snapshot_writer.put(bodies[i]->is_active());
+
+		uint32_t size_ofs = snapshot_writer.get_position();
+		snapshot_writer.put(uint32_t(0));
+		bodies[i]->save_state(snapshot_writer);
+		snapshot_writer.put_at(size_ofs, snapshot_writer.get_position() - size_ofs - uint32_t(sizeof(uint32_t)));
+	}
+
+	uint32_t constraint_count_ofs = snapshot_writer.get_position();
+	uint32_t constraint_count = 0;
+	snapshot_writer.put(constraint_count);
+
+	for (uint32_t i = 0; i < bodies.size(); i++) {
+
+		for (const Body2DSW::ConstraintMap::Element *E = bodies[i]->get_constraint_map().front(); E; E = E->next()) {
+
+			if (E->get() != 0) {
+				continue; // stored once, with its first body
+			}
+
+			const Constraint2DSW *c = E->key();
+			uint32_t record_ofs = snapshot_writer.get_position();
+			snapshot_writer.put(bodies[i]->get_self().get_id());
+			snapshot_writer.put(c->get_sort_key_high());
+			snapshot_writer.put(c->get_sort_key_low());
+
+			uint32_t size_ofs = snapshot_writer.get_position();
+			snapshot_writer.put(uint32_t(0));
+
+			if (!c->save_state(snapshot_writer)) {
+				snapshot_writer.rewind(record_ofs);
+				continue;
+			}
+
+			snapshot_writer.put_at(size_ofs, snapshot_writer.get_position() - size_ofs - uint32_t(sizeof(uint32_t)));
+			constraint_count++;
+		}
+	}
+
+	snapshot_writer.put_at(constraint_count_ofs, constraint_count);
+
+	return snapshot_writer.get_data();
+}
+
+Error Space2DSW::restore_snapshot(const PoolVector<uint8_t> &p_snapshot) {
+
+	ERR_FAIL_COND_V_MSG(locked, ERR_LOCKED, "Space snapshots can't be restored while the space is being stepped.");
+
+	PoolVector<uint8_t>::Read r = p_snapshot.read();
+	SnapshotReader2DSW reader(r.ptr(), p_snapshot.size());
+
+	uint32_t magic = 0;
+	uint32_t version = 0;
+	uint32_t real_size = 0;
+	uint32_t body_count = 0;
+
+	reader.get(magic);
+	reader.get(version);
+	reader.get(real_size);
+	reader.get(body_count);
+
+	ERR_FAIL_COND_V_MSG(reader.has_failed() || magic != SNAPSHOT_MAGIC, ERR_FILE_CORRUPT, "Invalid space snapshot.");
+	ERR_FAIL_COND_V_MSG(version != SNAPSHOT_VERSION || real_size != sizeof(real_t), ERR_FILE_UNRECOGNIZED, "The space snapshot was created by a different build.");
+
+	HashMap<uint32_t, Body2DSW *> body_map;
+
+	for (const Set<CollisionObject2DSW *>::Element *E = objects.front(); E; E = E->next()) {
+		if (E->get()->get_type() == CollisionObject2DSW::TYPE_BODY) {
+			body_map[E->get()->get_self().get_id()] = static_cast<Body2DSW *>(E->get());
+		}
+	}
+
+	// validate the whole snapshot first, so a truncated one changes nothing
+
+	{
+		SnapshotReader2DSW validate = reader;
+
+		for (uint32_t i = 0; i < body_count; i++) {
+
+			uint32_t id;
+			bool active;
+			uint32_t size = 0;
+			validate.get(id);
+			validate.get(active);
+			validate.get(size);
+			validate.skip(size);
+		}
+
+		uint32_t constraint_count = 0;
+		validate.get(constraint_count);
+
+		for (uint32_t i = 0; i < constraint_count; i++) {
+
+			uint32_t id;
+			uint64_t key;
+			uint32_t size = 0;
+			validate.get(id);
+			validate.get(key);
+			validate.get(key);
+			validate.get(size);
+			validate.skip(size);
+		}
+
+		ERR_FAIL_COND_V_MSG(validate.has_failed() || validate.get_position() != uint32_t(p_snapshot.size()), ERR_FILE_CORRUPT, "Invalid space snapshot.");
+	}
+
+	LocalVector<Body2DSW *> bodies;
+	LocalVector<bool> active;
+
+	for (uint32_t i = 0; i < body_count; i++) {
+
+		uint32_t id;
+		bool body_active;
+		uint32_t size;
+		reader.get(id);
+		reader.get(body_active);
+		reader.get(size);
+
+		SnapshotReader2DSW body_reader = reader.read_block(size);
+
+		Body2DSW **body = body_map.getptr(id);
+		if (!body) {
+			continue; // removed from the space after the snapshot was taken
+		}
+
+		if ((*body)->load_state(body_reader)) {
+			bodies.push_back(*body);
+			active.push_back(body_active);
+		}
+	}
+
+	// the pairs the broadphase reports may depend on how objects moved before, check all of
+	// them again from the restored transforms so replays always start from the same pairs
+
+	for (Set<CollisionObject2DSW *>::Element *E = objects.front(); E; E = E->next()) {
+		E->get()->recheck_broadphase_pairs();
+	}
+	broadphase->update();
+
+	// rebuild the active list in the order it had, as it decides the order in which islands are solved,
+	// new area pairs may have woken up kinematic bodies
+
+	for (uint32_t i = 0; i < bodies.size(); i++) {
+		bodies[i]->set_active(false);
+	}
+
+	for (int i = int(bodies.size()) - 1; i >= 0; i--) {
+		if (active[i]) {
+			bodies[i]->set_active(true);
+		}
+	}
+
+	for (uint32_t i = 0; i < bodies.size(); i++) {
+		for (Body2DSW::ConstraintMap::Element *E = bodies[i]->get_constraint_map().front(); E; E = E->next()) {
+			E->key()->clear_state();
+		}
+	}
+
+	uint32_t constraint_count;
+	reader.get(constraint_count);
+
+	for (uint32_t i = 0; i < constraint_count; i++) {
+
+		uint32_t id;
+		uint64_t key_high;
+		uint64_t key_low;
+		uint32_t size;
+		reader.get(id);
+		reader.get(key_high);
+		reader.get(key_low);
+		reader.get(size);
+
+		SnapshotReader2DSW constraint_reader = reader.read_block(size);
+
+		Body2DSW **body = body_map.getptr(id);
+		if (!body) {
+			continue;
+		}
+
+		for (Body2DSW::ConstraintMap::Element *E = (*body)->get_constraint_map().front(); E; E = E->next()) {
+
+			Constraint2DSW *c = E->key();
+			if (c->get_sort_key_high() == key_high && c->get_sort_key_low() == key_low) {
+				c->load_state(constraint_reader);
+				break;
+			}
+		}
+	}
+
+	return OK;
+}
+
 Physics2DDirectSpaceStateSW *Space2DSW::get_direct_state() {
 
 	return direct_access;
@@ -1372,6 +2178,7 @@ Physics2DDirectSpaceStateSW *Space2DSW::get_direct_state() {
 
 Space2DSW::Space2DSW() {
 
+	motion_batch_body = NULL;
 	collision_pairs = 0;
 	active_objects = 0;
 	island_count = 0;
@@ -1400,6 +2207,8 @@ Space2DSW::Space2DSW() {
 
 	for (int i = 0; i < ELAPSED_TIME_MAX; i++)
 		elapsed_time[i] = 0;
+	pair_generation_time = 0;
+	narrowphase_timed = false;
 }
 
 Space2DSW::~Space2DSW() {
@@ -38,14 +38,19 @@
 #include "broad_phase_2d_sw.h"
 #include "collision_object_2d_sw.h"
 #include "core/hash_map.h"
+#include "core/local_vector.h"
 #include "core/project_settings.h"
+#include "core/safe_refcount.h"
 #include "core/typedefs.h"
 
+struct _Batch2DSW;
+
 class Physics2DDirectSpaceStateSW : public Physics2DDirectSpaceState {
 
 	GDCLASS(Physics2DDirectSpaceStateSW, Physics2DDirectSpaceState);
 
 	int _intersect_point_impl(const Vector2 &p_point, ShapeResult *r_results, int p_result_max, const Set<RID> &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas, bool p_pick_point, bool p_filter_by_canvas = false, ObjectID p_canvas_instance_id = 0);
+	void _batch_cull(_Batch2DSW &r_batch, const RID *p_exclude, int p_exclude_count, uint32_t p_collision_layer, bool p_collide_with_bodies, bool p_collide_with_areas);
 
 public:
 	Space2DSW *space;
@@ -58,6 +63,10 @@ public:
 	virtual bool collide_shape(RID p_shape, const Transform2D &p_shape_xform, const Vector2 &p_motion, real_t p_margin, Vector2 *r_results, int p_result_max, int &r_result_count, const Set<RID> &p_exclude = Set<RID>(), uint32_t p_collision_mask = 0xFFFFFFFF, bool p_collide_with_bodies = true, bool p_collide_with_areas = false);
 	virtual bool rest_info(RID p_shape, const Transform2D &p_shape_xform, const Vector2 &p_motion, real_t p_margin, ShapeRestInfo *r_info, const Set<RID> &p_exclude = Set<RID>(), uint32_t p_collision_mask = 0xFFFFFFFF, bool p_collide_with_bodies = true, bool p_collide_with_areas = false);
 
+	virtual int intersect_ray_batch(const Vector2 *p_from, const Vector2 *p_to, int p_count, RayResult *r_results, bool *r_collided, const RID *p_exclude = NULL, int p_exclude_count = 0, uint32_t p_collision_layer = 0xFFFFFFFF, bool p_collide_with_bodies = true, bool p_collide_with_areas = false, bool p_threaded = false);
+	virtual int cast_motion_batch(const RID &p_shape, const Transform2D *p_xforms, const Vector2 *p_motions, int p_count, float p_margin, float *r_closest_safe, float *r_closest_unsafe, const RID *p_exclude = NULL, int p_exclude_count = 0, uint32_t p_collision_layer = 0xFFFFFFFF, bool p_collide_with_bodies = true, bool p_collide_with_areas = false, bool p_threaded = false);
+	virtual int rest_info_batch(RID p_shape, const Transform2D *p_shape_xforms, const Vector2 &p_motion, int p_count, float p_margin, ShapeRestInfo *r_infos, bool *r_collided, const RID *p_exclude = NULL, int p_exclude_count = 0, uint32_t p_collision_layer = 0xFFFFFFFF, bool p_collide_with_bodies = true, bool p_collide_with_areas = false, bool p_threaded = false);
+
 	Physics2DDirectSpaceStateSW();
 };
 
@@ -70,6 +79,9 @@ public:
 		ELAPSED_TIME_SETUP_CONSTRAINTS,
 		ELAPSED_TIME_SOLVE_CONSTRAINTS,
 		ELAPSED_TIME_INTEGRATE_VELOCITIES,
+		ELAPSED_TIME_BROADPHASE,
+		ELAPSED_TIME_PAIR_GENERATION,
+		ELAPSED_TIME_NARROWPHASE,
 		ELAPSED_TIME_MAX
 
 	};
@@ -82,6 +94,8 @@ private:
 	};
 
 	uint64_t elapsed_time[ELAPSED_TIME_MAX];
+	uint64_t pair_generation_time;
+	bool narrowphase_timed;
 
 	Physics2DDirectSpaceStateSW *direct_access;
 	RID self;
@@ -93,6 +107,7 @@ private:
 	SelfList<Area2DSW>::List monitor_query_list;
 	SelfList<Area2DSW>::List area_moved_list;
 
+	void *_create_pair(CollisionObject2DSW *A, int p_subindex_A, CollisionObject2DSW *B, int p_subindex_B);
 	static void *_broadphase_pair(CollisionObject2DSW *A, int p_subindex_A, CollisionObject2DSW *B, int p_subindex_B, void *p_self);
 	static void _broadphase_unpair(CollisionObject2DSW *A, int p_subindex_A, CollisionObject2DSW *B, int p_subindex_B, void *p_data, void *p_self);
 
@@ -129,6 +144,14 @@ private:
 	Vector<Vector2> contact_debug;
 	int contact_debug_count;
 
+	SnapshotWriter2DSW snapshot_writer;
+
+	// broadphase candidates shared by the motion tests of one body, see begin_motion_batch()
+	Body2DSW *motion_batch_body;
+	Rect2 motion_batch_aabb;
+	LocalVector<CollisionObject2DSW *> motion_batch_objects;
+	LocalVector<int> motion_batch_subindices;
+
 	friend class Physics2DDirectSpaceStateSW;
 
 public:
@@ -187,6 +210,16 @@ public:
 	int get_collision_pairs() const { return collision_pairs; }
 
 	bool test_body_motion(Body2DSW *p_body, const Transform2D &p_from, const Vector2 &p_motion, bool p_infinite_inertia, real_t p_margin, Physics2DServer::MotionResult *r_result, bool p_exclude_raycast_shapes = true);
+
+	void begin_motion_batch(Body2DSW *p_body, const Transform2D &p_from, real_t p_max_distance, real_t p_margin);
+	void end_motion_batch(Body2DSW *p_body);
+	// Any other object entering, leaving or moving in the broadphase makes the shared candidates stale.
+	_FORCE_INLINE_ void object_broadphase_changed(const CollisionObject2DSW *p_object) {
+		if (motion_batch_body && motion_batch_body != p_object) motion_batch_body = NULL;
+	}
+	PoolVector<uint8_t> get_snapshot();
+	Error restore_snapshot(const PoolVector<uint8_t> &p_snapshot);
+
 	int test_body_ray_separation(Body2DSW *p_body, const Transform2D &p_transform, bool p_infinite_inertia, Vector2 &r_recover_motion, Physics2DServer::SeparationResult *r_results, int p_result_max, real_t p_margin);
 
 	void set_debug_contacts(int p_amount) { contact_debug.resize(p_amount); }
@@ -202,6 +235,13 @@ public:
 	void set_elapsed_time(ElapsedTime p_time, uint64_t p_msec) { elapsed_time[p_time] = p_msec; }
 	uint64_t get_elapsed_time(ElapsedTime p_time) const { return elapsed_time[p_time]; }
 
+	// reset when a step begins, pairs can be created by any phase that moves objects
+	uint64_t get_pair_generation_time() const { return pair_generation_time; }
+
+	// timing each pair costs two clock reads in the narrow phase, so it's only done when asked for
+	void set_narrowphase_timed(bool p_timed) { narrowphase_timed = p_timed; }
+	_FORCE_INLINE_ bool is_narrowphase_timed() const { return narrowphase_timed; }
+
 	Space2DSW();
 	~Space2DSW();
 };
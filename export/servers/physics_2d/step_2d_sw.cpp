@@ -30,40 +30,214 @@
 
 #include "step_2d_sw.h"
 #include "core/os/os.h"
+#include "core/project_settings.h"
 
-void Step2DSW::_populate_island(Body2DSW *p_body, Body2DSW **p_island, Constraint2DSW **p_constraint_island) {
+// A dirty island that nothing was split off from is populated again in place, so
+// it keeps its memory and its constraints, which are already sorted. Only the
+// constraints it didn't have yet are sorted and merged in.
+Island2DSW *Step2DSW::_populate_island(Body2DSW *p_body) {
+
+	Island2DSW *island = p_body->get_island();
+	uint32_t island_users = 0; // bodies found that already belong to the island
+
+	populate_bodies.clear();
+	populate_constraints.clear();
 
 	p_body->set_island_step(_step);
-	p_body->set_island_next(*p_island);
-	*p_island = p_body;
+	populate_stack.push_back(p_body);
+
+	while (populate_stack.size()) {
+
+		Body2DSW *body = populate_stack[populate_stack.size() - 1];
+		populate_stack.resize(populate_stack.size() - 1);
+		populate_bodies.push_back(body);
+		if (island && body->get_island() == island) {
+			island_users++;
+		}
+
+		for (const Body2DSW::ConstraintMap::Element *E = body->get_constraint_map().front(); E; E = E->next()) {
+
+			Constraint2DSW *c = (Constraint2DSW *)E->key();
+			if (c->get_island_step() == _step)
+				continue; //already processed
+			c->set_island_step(_step);
+			populate_constraints.push_back(c);
+
+			for (int i = 0; i < c->get_body_count(); i++) {
+				if (i == E->get())
+					continue;
+				Body2DSW *b = c->get_body_ptr()[i];
+				if (b->get_island_step() == _step || b->get_mode() == Physics2DServer::BODY_MODE_STATIC || b->get_mode() == Physics2DServer::BODY_MODE_KINEMATIC)
+					continue; //no go
+				b->set_island_step(_step);
+				populate_stack.push_back(b);
+			}
+		}
+	}
+
+	if (island && island_users == island->users) {
+
+		// the island only holds constraints that still exist, keep the ones found again.
+		// they are marked with the previous step to tell them from the new ones,
+		// _add_island() marks all of them with this step again
+		uint32_t kept = 0;
+		for (uint32_t i = 0; i < island->constraints.size(); i++) {
+			Constraint2DSW *c = island->constraints[i];
+			if (c->get_island_step() == _step) {
+				c->set_island_step(_step - 1);
+				island->constraints[kept++] = c;
+			}
+		}
+
+		populate_added.clear();
+		for (uint32_t i = 0; i < populate_constraints.size(); i++) {
+			if (populate_constraints[i]->get_island_step() == _step) {
+				populate_added.push_back(populate_constraints[i]);
+			}
+		}
+		populate_added.sort_custom<ConstraintOrder2DSW>();
+
+		// merge from the back, so no constraint is moved before it's read
+		island->constraints.resize(kept + populate_added.size());
+		ConstraintOrder2DSW order;
+		int64_t from_kept = int64_t(kept) - 1;
+		int64_t from_added = int64_t(populate_added.size()) - 1;
+		int64_t to = int64_t(island->constraints.size()) - 1;
+		while (from_added >= 0) {
+			if (from_kept >= 0 && order(populate_added[from_added], island->constraints[from_kept])) {
+				island->constraints[to--] = island->constraints[from_kept--];
+			} else {
+				island->constraints[to--] = populate_added[from_added--];
+			}
+		}
+
+		island->bodies.clear();
+
+	} else {
+
+		// a new island, or one split off. the bodies left behind populate the old one again when reached
+		island = memnew(Island2DSW);
+		// solve in the same order no matter which body the island was found from
+		populate_constraints.sort_custom<ConstraintOrder2DSW>();
+		for (uint32_t i = 0; i < populate_constraints.size(); i++) {
+			island->constraints.push_back(populate_constraints[i]);
+		}
+	}
+
+	for (uint32_t i = 0; i < populate_bodies.size(); i++) {
+		populate_bodies[i]->set_island(island);
+		island->bodies.push_back(populate_bodies[i]);
+	}
+	island->dirty = false;
+
+	return island;
+}
 
-	for (Map<Constraint2DSW *, int>::Element *E = p_body->get_constraint_map().front(); E; E = E->next()) {
+Island2DSW *Step2DSW::_get_island(Body2DSW *p_body) {
+
+	Island2DSW *island = p_body->get_island();
+	if (!island || island->dirty) {
+		island = _populate_island(p_body);
+	}
+
+	return island;
+}
+
+void Step2DSW::_add_island(Island2DSW *p_island, Body2DSW **r_island_list, Constraint2DSW **r_constraint_island_list, int &r_island_count) {
+
+	Body2DSW *island = NULL;
+	for (uint32_t i = 0; i < p_island->bodies.size(); i++) {
+		Body2DSW *b = p_island->bodies[i];
+		b->set_island_step(_step);
+		b->set_island_next(island);
+		island = b;
+	}
+
+	island->set_island_list_next(*r_island_list);
+	*r_island_list = island;
+
+	Constraint2DSW *constraint_island = NULL;
+	for (int i = int(p_island->constraints.size()) - 1; i >= 0; i--) {
+		Constraint2DSW *c = p_island->constraints[i];
+		c->set_island_step(_step);
+		c->set_island_next(constraint_island);
+		constraint_island = c;
+	}
+
+	if (constraint_island) {
+		constraint_island->set_island_list_next(*r_constraint_island_list);
+		*r_constraint_island_list = constraint_island;
+		r_island_count++;
+	}
+}
+
+// kinematic bodies don't join islands, they bring in the islands of the bodies they touch,
+// and get one of their own for constraints with other kinematic or static bodies
+void Step2DSW::_add_kinematic_island(Body2DSW *p_body, Body2DSW **r_island_list, Constraint2DSW **r_constraint_island_list, int &r_island_count) {
+
+	p_body->set_island_step(_step);
+	p_body->set_island_next(NULL);
+	p_body->set_island_list_next(*r_island_list);
+	*r_island_list = p_body;
+
+	Constraint2DSW *constraint_island = NULL;
+
+	for (const Body2DSW::ConstraintMap::Element *E = p_body->get_constraint_map().front(); E; E = E->next()) {
 
 		Constraint2DSW *c = (Constraint2DSW *)E->key();
 		if (c->get_island_step() == _step)
 			continue; //already processed
-		c->set_island_step(_step);
-		c->set_island_next(*p_constraint_island);
-		*p_constraint_island = c;
 
+		Body2DSW *dynamic = NULL;
 		for (int i = 0; i < c->get_body_count(); i++) {
-			if (i == E->get())
-				continue;
 			Body2DSW *b = c->get_body_ptr()[i];
-			if (b->get_island_step() == _step || b->get_mode() == Physics2DServer::BODY_MODE_STATIC || b->get_mode() == Physics2DServer::BODY_MODE_KINEMATIC)
-				continue; //no go
-			_populate_island(c->get_body_ptr()[i], p_island, p_constraint_island);
+			if (i != E->get() && b->get_mode() != Physics2DServer::BODY_MODE_STATIC && b->get_mode() != Physics2DServer::BODY_MODE_KINEMATIC) {
+				dynamic = b;
+				break;
+			}
 		}
+
+		if (dynamic) {
+			if (dynamic->get_island_step() != _step) {
+				_add_island(_get_island(dynamic), r_island_list, r_constraint_island_list, r_island_count);
+			}
+		} else {
+			c->set_island_step(_step);
+			c->set_island_next(constraint_island);
+			constraint_island = c;
+		}
+	}
+
+	if (constraint_island) {
+		constraint_island->set_island_list_next(*r_constraint_island_list);
+		*r_constraint_island_list = constraint_island;
+		r_island_count++;
 	}
 }
 
-bool Step2DSW::_setup_island(Constraint2DSW *p_island, real_t p_delta) {
+bool Step2DSW::_is_island_parallel(Constraint2DSW *p_island) const {
+
+	Constraint2DSW *ci = p_island;
+	while (ci) {
+		if (ci->writes_outside_island())
+			return false;
+		ci = ci->get_island_next();
+	}
+
+	return true;
+}
+
+bool Step2DSW::_setup_island(Constraint2DSW *p_island, real_t p_delta, uint64_t &r_narrowphase_time) {
 
 	Constraint2DSW *ci = p_island;
 	Constraint2DSW *prev_ci = NULL;
 	bool removed_root = false;
+	r_narrowphase_time = 0;
 	while (ci) {
 		bool process = ci->setup(p_delta);
+		if (narrowphase_timed) {
+			r_narrowphase_time += ci->get_narrowphase_time();
+		}
 
 		if (!process) {
 			//remove from island if process fails
@@ -94,6 +268,20 @@ void Step2DSW::_solve_island(Constraint2DSW *p_island, int p_iterations, real_t
 	}
 }
 
+void Step2DSW::_setup_parallel_island(uint32_t p_index, void *p_userdata) {
+
+	Island &island = islands[parallel_islands[p_index]];
+	island.removed_root = _setup_island(island.constraints, parallel_delta, island.narrowphase_time);
+}
+
+void Step2DSW::_solve_parallel_island(uint32_t p_index, void *p_userdata) {
+
+	const Island &island = islands[parallel_islands[p_index]];
+	if (island.constraints) {
+		_solve_island(island.constraints, parallel_iterations, parallel_delta);
+	}
+}
+
 void Step2DSW::_check_suspend(Body2DSW *p_island, real_t p_delta) {
 
 	bool can_sleep = true;
@@ -175,17 +363,11 @@ void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 
 		if (body->get_island_step() != _step) {
 
-			Body2DSW *island = NULL;
-			Constraint2DSW *constraint_island = NULL;
-			_populate_island(body, &island, &constraint_island);
-
-			island->set_island_list_next(island_list);
-			island_list = island;
-
-			if (constraint_island) {
-				constraint_island->set_island_list_next(constraint_island_list);
-				constraint_island_list = constraint_island;
-				island_count++;
+			if (body->get_mode() == Physics2DServer::BODY_MODE_STATIC || body->get_mode() == Physics2DServer::BODY_MODE_KINEMATIC) {
+				_add_kinematic_island(body, &island_list, &constraint_island_list, island_count);
+			} else {
+				// islands of sleeping bodies are left alone until something wakes them up
+				_add_island(_get_island(body), &island_list, &constraint_island_list, island_count);
 			}
 		}
 		b = b->next();
@@ -217,16 +399,60 @@ void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 
 	/* SETUP CONSTRAINT ISLANDS */
 
+	// islands don't share dynamic bodies, so the ones that don't write to shared
+	// objects (areas, contact reports on static bodies) can be set up and solved
+	// on any thread without changing the result. the rest stay on this thread.
+	// setup is where body pairs run the narrow phase, so it is spread out as well.
+
+	islands.clear();
+	parallel_islands.clear();
+	parallel_delta = p_delta;
+	parallel_iterations = p_iterations;
+	narrowphase_timed = p_space->is_narrowphase_timed();
+
 	{
+		bool use_threads = work_pool.get_thread_count() > 1;
+
+		Constraint2DSW *ci = constraint_island_list;
+		while (ci) {
+
+			Island island;
+			island.constraints = ci;
+			island.parallel = use_threads && _is_island_parallel(ci);
+			island.removed_root = false;
+			island.narrowphase_time = 0;
+
+			if (island.parallel) {
+				parallel_islands.push_back(islands.size());
+			} else {
+				island.removed_root = _setup_island(ci, p_delta, island.narrowphase_time);
+			}
+
+			islands.push_back(island);
+			ci = ci->get_island_list_next();
+		}
+
+		work_pool.do_work(parallel_islands.size(), this, &Step2DSW::_setup_parallel_island, (void *)NULL);
+	}
+
+	uint64_t narrowphase_time = 0;
+
+	{
+		// unlink the roots that failed setup, in list order so the result doesn't depend on the threads
 		Constraint2DSW *ci = constraint_island_list;
 		Constraint2DSW *prev_ci = NULL;
+		uint32_t island_index = 0;
 		while (ci) {
 
-			if (_setup_island(ci, p_delta)) {
+			Island &island = islands[island_index++];
+			narrowphase_time += island.narrowphase_time;
+
+			if (island.removed_root) {
 
 				//removed the root from the island graph because it is not to be processed
 
 				Constraint2DSW *next = ci->get_island_next();
+				island.constraints = next;
 
 				if (next) {
 					//root from list being deleted no longer exists, replace by next
@@ -264,12 +490,14 @@ void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 	/* SOLVE CONSTRAINT ISLANDS */
 
 	{
-		Constraint2DSW *ci = constraint_island_list;
-		while (ci) {
-			//iterating each island separatedly improves cache efficiency
-			_solve_island(ci, p_iterations, p_delta);
-			ci = ci->get_island_list_next();
+		for (uint32_t i = 0; i < islands.size(); i++) {
+			if (!islands[i].parallel && islands[i].constraints) {
+				//iterating each island separatedly improves cache efficiency
+				_solve_island(islands[i].constraints, p_iterations, p_delta);
+			}
 		}
+
+		work_pool.do_work(parallel_islands.size(), this, &Step2DSW::_solve_parallel_island, (void *)NULL);
 	}
 
 	{ //profile
@@ -302,15 +530,50 @@ void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 	{ //profile
 		profile_endtime = OS::get_singleton()->get_ticks_usec();
 		p_space->set_elapsed_time(Space2DSW::ELAPSED_TIME_INTEGRATE_VELOCITIES, profile_endtime - profile_begtime);
-		//profile_begtime=profile_endtime;
+		profile_begtime = profile_endtime;
 	}
 
+	uint64_t pair_generation_begin = p_space->get_pair_generation_time();
+
 	p_space->update();
+
+	{ //profile
+		profile_endtime = OS::get_singleton()->get_ticks_usec();
+		// the pairs found by the update are accounted separately
+		uint64_t pair_generation = p_space->get_pair_generation_time() - pair_generation_begin;
+		p_space->set_elapsed_time(Space2DSW::ELAPSED_TIME_BROADPHASE, profile_endtime - profile_begtime - pair_generation);
+		p_space->set_elapsed_time(Space2DSW::ELAPSED_TIME_PAIR_GENERATION, p_space->get_pair_generation_time());
+		p_space->set_elapsed_time(Space2DSW::ELAPSED_TIME_NARROWPHASE, narrowphase_time);
+	}
+
 	p_space->unlock();
 	_step++;
 }
 
+void Step2DSW::set_thread_count(int p_count) {
+
+	work_pool.finish();
+	work_pool.init(p_count);
+}
+
+int Step2DSW::get_thread_count() const {
+
+	return work_pool.get_thread_count();
+}
+
 Step2DSW::Step2DSW() {
 
 	_step = 1;
+	parallel_delta = 0;
+	parallel_iterations = 0;
+	narrowphase_timed = false;
+
+	int thread_count = GLOBAL_DEF("physics/2d/solver_thread_count", 0);
+	ProjectSettings::get_singleton()->set_custom_property_info("physics/2d/solver_thread_count", PropertyInfo(Variant::INT, "physics/2d/solver_thread_count", PROPERTY_HINT_RANGE, "0,64,1,or_greater"));
+	work_pool.init(thread_count);
+}
+
+Step2DSW::~Step2DSW() {
+
+	work_pool.finish();
 }
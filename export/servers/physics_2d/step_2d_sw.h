@@ -31,20 +31,52 @@
 #ifndef STEP_2D_SW_H
 #define STEP_2D_SW_H
 
+#include "core/local_vector.h"
+#include "core/os/thread_work_pool.h"
 #include "space_2d_sw.h"
 
 class Step2DSW {
 
 	uint64_t _step;
 
-	void _populate_island(Body2DSW *p_body, Body2DSW **p_island, Constraint2DSW **p_constraint_island);
-	bool _setup_island(Constraint2DSW *p_island, real_t p_delta);
+	struct Island {
+		Constraint2DSW *constraints;
+		bool parallel;
+		bool removed_root;
+		uint64_t narrowphase_time; // summed once all the islands are set up
+	};
+
+	ThreadWorkPool work_pool;
+	LocalVector<Island> islands;
+	LocalVector<uint32_t> parallel_islands;
+	real_t parallel_delta;
+	int parallel_iterations;
+	bool narrowphase_timed;
+
+	LocalVector<Body2DSW *> populate_stack;
+	LocalVector<Body2DSW *> populate_bodies;
+	LocalVector<Constraint2DSW *> populate_constraints;
+	LocalVector<Constraint2DSW *> populate_added;
+
+	Island2DSW *_populate_island(Body2DSW *p_body);
+	Island2DSW *_get_island(Body2DSW *p_body);
+	void _add_island(Island2DSW *p_island, Body2DSW **r_island_list, Constraint2DSW **r_constraint_island_list, int &r_island_count);
+	void _add_kinematic_island(Body2DSW *p_body, Body2DSW **r_island_list, Constraint2DSW **r_constraint_island_list, int &r_island_count);
+	bool _is_island_parallel(Constraint2DSW *p_island) const;
+	bool _setup_island(Constraint2DSW *p_island, real_t p_delta, uint64_t &r_narrowphase_time);
 	void _solve_island(Constraint2DSW *p_island, int p_iterations, real_t p_delta);
+	void _setup_parallel_island(uint32_t p_index, void *p_userdata);
+	void _solve_parallel_island(uint32_t p_index, void *p_userdata);
 	void _check_suspend(Body2DSW *p_island, real_t p_delta);
 
 public:
 	void step(Space2DSW *p_space, real_t p_delta, int p_iterations);
+
+	void set_thread_count(int p_count);
+	int get_thread_count() const;
+
 	Step2DSW();
+	~Step2DSW();
 };
 
 #endif // STEP_2D_SW_H
@@ -409,6 +409,242 @@ Dictionary Physics2DDirectSpaceState::_get_rest_info(const Ref<Physics2DShapeQue
 	return r;
 }
 
+Dictionary Physics2DDirectSpaceState::_intersect_ray_batch(const PoolVector<Vector2> &p_from, const PoolVector<Vector2> &p_to, const Vector<RID> &p_exclude, uint32_t p_layers, bool p_collide_with_bodies, bool p_collide_with_areas, bool p_threaded) {
+
+	ERR_FAIL_COND_V(p_from.size() != p_to.size(), Dictionary());
+
+	int count = p_from.size();
+
+	Vector<RID> exclude = p_exclude;
+	exclude.sort();
+
+	Vector<RayResult> results;
+	results.resize(count);
+	Vector<bool> collided;
+	collided.resize(count);
+
+	{
+		PoolVector<Vector2>::Read from = p_from.read();
+		PoolVector<Vector2>::Read to = p_to.read();
+		intersect_ray_batch(from.ptr(), to.ptr(), count, results.ptrw(), collided.ptrw(), exclude.ptr(), exclude.size(), p_layers, p_collide_with_bodies, p_collide_with_areas, p_threaded);
+	}
+
+	PoolVector<uint8_t> ret_collided;
+	PoolVector<Vector2> ret_position;
+	PoolVector<Vector2> ret_normal;
+	PoolVector<int> ret_collider_id;
+	PoolVector<int> ret_shape;
+	ret_collided.resize(count);
+	ret_position.resize(count);
+	ret_normal.resize(count);
+	ret_collider_id.resize(count);
+	ret_shape.resize(count);
+
+	{
+		PoolVector<uint8_t>::Write w_collided = ret_collided.write();
+		PoolVector<Vector2>::Write w_position = ret_position.write();
+		PoolVector<Vector2>::Write w_normal = ret_normal.write();
+		PoolVector<int>::Write w_collider_id = ret_collider_id.write();
+		PoolVector<int>::Write w_shape = ret_shape.write();
+
+		for (int i = 0; i < count; i++) {
+
+			w_collided[i] = collided[i];
+			w_position[i] = collided[i] ? results[i].position : Vector2();
+			w_normal[i] = collided[i] ? results[i].normal : Vector2();
+			w_collider_id[i] = collided[i] ? results[i].collider_id : 0;
+			w_shape[i] = collided[i] ? results[i].shape : 0;
+		}
+	}
+
+	Dictionary d;
+	d["collided"] = ret_collided;
+	d["position"] = ret_position;
+	d["normal"] = ret_normal;
+	d["collider_id"] = ret_collider_id;
+	d["shape"] = ret_shape;
+
+	return d;
+}
+
+Dictionary Physics2DDirectSpaceState::_cast_motion_batch(const Ref<Physics2DShapeQueryParameters> &p_shape_query, const PoolVector<Vector2> &p_origins, const PoolVector<Vector2> &p_motions, bool p_threaded) {
+
+	ERR_FAIL_COND_V(!p_shape_query.is_valid(), Dictionary());
+	ERR_FAIL_COND_V(p_origins.size() != p_motions.size(), Dictionary());
+
+	int count = p_origins.size();
+
+	Vector<RID> exclude; // Set iteration is already sorted
+	for (Set<RID>::Element *E = p_shape_query->exclude.front(); E; E = E->next()) {
+		exclude.push_back(E->get());
+	}
+
+	Vector<Transform2D> xforms;
+	xforms.resize(count);
+	{
+		PoolVector<Vector2>::Read r = p_origins.read();
+		for (int i = 0; i < count; i++) {
+			xforms.write[i] = p_shape_query->transform;
+			xforms.write[i].set_origin(r[i]);
+		}
+	}
+
+	PoolVector<real_t> ret_safe;
+	PoolVector<real_t> ret_unsafe;
+	ret_safe.resize(count);
+	ret_unsafe.resize(count);
+
+	Vector<float> safe;
+	Vector<float> unsafe;
+	safe.resize(count);
+	unsafe.resize(count);
+
+	{
+		PoolVector<Vector2>::Read motions = p_motions.read();
+		cast_motion_batch(p_shape_query->shape, xforms.ptr(), motions.ptr(), count, p_shape_query->margin, safe.ptrw(), unsafe.ptrw(), exclude.ptr(), exclude.size(), p_shape_query->collision_mask, p_shape_query->collide_with_bodies, p_shape_query->collide_with_areas, p_threaded);
+	}
+
+	{
+		PoolVector<real_t>::Write w_safe = ret_safe.write();
+		PoolVector<real_t>::Write w_unsafe = ret_unsafe.write();
+		for (int i = 0; i < count; i++) {
+			w_safe[i] = safe[i];
+			w_unsafe[i] = unsafe[i];
+		}
+	}
+
+	Dictionary d;
+	d["safe"] = ret_safe;
+	d["unsafe"] = ret_unsafe;
+
+	return d;
+}
+
+Dictionary Physics2DDirectSpaceState::_get_rest_info_batch(const Ref<Physics2DShapeQueryParameters> &p_shape_query, const PoolVector<Vector2> &p_origins, bool p_threaded) {
+
+	ERR_FAIL_COND_V(!p_shape_query.is_valid(), Dictionary());
+
+	int count = p_origins.size();
+
+	Vector<RID> exclude; // Set iteration is already sorted
+	for (Set<RID>::Element *E = p_shape_query->exclude.front(); E; E = E->next()) {
+		exclude.push_back(E->get());
+	}
+
+	Vector<Transform2D> xforms;
+	xforms.resize(count);
+	{
+		PoolVector<Vector2>::Read r = p_origins.read();
+		for (int i = 0; i < count; i++) {
+			xforms.write[i] = p_shape_query->transform;
+			xforms.write[i].set_origin(r[i]);
+		}
+	}
+
+	Vector<ShapeRestInfo> infos;
+	infos.resize(count);
+	Vector<bool> collided;
+	collided.resize(count);
+
+	rest_info_batch(p_shape_query->shape, xforms.ptr(), p_shape_query->motion, count, p_shape_query->margin, infos.ptrw(), collided.ptrw(), exclude.ptr(), exclude.size(), p_shape_query->collision_mask, p_shape_query->collide_with_bodies, p_shape_query->collide_with_areas, p_threaded);
+
+	PoolVector<uint8_t> ret_collided;
+	PoolVector<Vector2> ret_point;
+	PoolVector<Vector2> ret_normal;
+	PoolVector<int> ret_collider_id;
+	PoolVector<int> ret_shape;
+	PoolVector<Vector2> ret_linear_velocity;
+	ret_collided.resize(count);
+	ret_point.resize(count);
+	ret_normal.resize(count);
+	ret_collider_id.resize(count);
+	ret_shape.resize(count);
+	ret_linear_velocity.resize(count);
+
+	{
+		PoolVector<uint8_t>::Write w_collided = ret_collided.write();
+		PoolVector<Vector2>::Write w_point = ret_point.write();
+		PoolVector<Vector2>::Write w_normal = ret_normal.write();
+		PoolVector<int>::Write w_collider_id = ret_collider_id.write();
+		PoolVector<int>::Write w_shape = ret_shape.write();
+		PoolVector<Vector2>::Write w_linear_velocity = ret_linear_velocity.write();
+
+		for (int i = 0; i < count; i++) {
+
+			w_collided[i] = collided[i];
+			w_point[i] = collided[i] ? infos[i].point : Vector2();
+			w_normal[i] = collided[i] ? infos[i].normal : Vector2();
+			w_collider_id[i] = collided[i] ? infos[i].collider_id : 0;
+			w_shape[i] = collided[i] ? infos[i].shape : 0;
+			w_linear_velocity[i] = collided[i] ? infos[i].linear_velocity : Vector2();
+		}
+	}
+
+	Dictionary d;
+	d["collided"] = ret_collided;
+	d["point"] = ret_point;
+	d["normal"] = ret_normal;
+	d["collider_id"] = ret_collider_id;
+	d["shape"] = ret_shape;
+	d["linear_velocity"] = ret_linear_velocity;
+
+	return d;
+}
+
+int Physics2DDirectSpaceState::intersect_ray_batch(const Vector2 *p_from, const Vector2 *p_to, int p_count, RayResult *r_results, bool *r_collided, const RID *p_exclude, int p_exclude_count, uint32_t p_collision_layer, bool p_collide_with_bodies, bool p_collide_with_areas, bool p_threaded) {
+
+	// one query at a time, servers override this with something faster
+	Set<RID> exclude;
+	for (int i = 0; i < p_exclude_count; i++)
+		exclude.insert(p_exclude[i]);
+
+	int collided = 0;
+	for (int i = 0; i < p_count; i++) {
+
+		r_collided[i] = intersect_ray(p_from[i], p_to[i], r_results[i], exclude, p_collision_layer, p_collide_with_bodies, p_collide_with_areas);
+		if (r_collided[i])
+			collided++;
+	}
+
+	return collided;
+}
+
+int Physics2DDirectSpaceState::cast_motion_batch(const RID &p_shape, const Transform2D *p_xforms, const Vector2 *p_motions, int p_count, float p_margin, float *r_closest_safe, float *r_closest_unsafe, const RID *p_exclude, int p_exclude_count, uint32_t p_collision_layer, bool p_collide_with_bodies, bool p_collide_with_areas, bool p_threaded) {
+
+	Set<RID> exclude;
+	for (int i = 0; i < p_exclude_count; i++)
+		exclude.insert(p_exclude[i]);
+
+	int collided = 0;
+	for (int i = 0; i < p_count; i++) {
+
+		r_closest_safe[i] = 1.0;
+		r_closest_unsafe[i] = 1.0;
+		cast_motion(p_shape, p_xforms[i], p_motions[i], p_margin, r_closest_safe[i], r_closest_unsafe[i], exclude, p_collision_layer, p_collide_with_bodies, p_collide_with_areas);
+		if (r_closest_safe[i] < 1.0)
+			collided++;
+	}
+
+	return collided;
+}
+
+int Physics2DDirectSpaceState::rest_info_batch(RID p_shape, const Transform2D *p_shape_xforms, const Vector2 &p_motion, int p_count, float p_margin, ShapeRestInfo *r_infos, bool *r_collided, const RID *p_exclude, int p_exclude_count, uint32_t p_collision_layer, bool p_collide_with_bodies, bool p_collide_with_areas, bool p_threaded) {
+
+	Set<RID> exclude;
+	for (int i = 0; i < p_exclude_count; i++)
+		exclude.insert(p_exclude[i]);
+
+	int collided = 0;
+	for (int i = 0; i < p_count; i++) {
+
+		r_collided[i] = rest_info(p_shape, p_shape_xforms[i], p_motion, p_margin, &r_infos[i], exclude, p_collision_layer, p_collide_with_bodies, p_collide_with_areas);
+		if (r_collided[i])
+			collided++;
+	}
+
+	return collided;
+}
+
 Physics2DDirectSpaceState::Physics2DDirectSpaceState() {
 }
 
@@ -421,6 +657,10 @@ void Physics2DDirectSpaceState::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("cast_motion", "shape"), &Physics2DDirectSpaceState::_cast_motion);
 	ClassDB::bind_method(D_METHOD("collide_shape", "shape", "max_results"), &Physics2DDirectSpaceState::_collide_shape, DEFVAL(32));
 	ClassDB::bind_method(D_METHOD("get_rest_info", "shape"), &Physics2DDirectSpaceState::_get_rest_info);
+
+	ClassDB::bind_method(D_METHOD("intersect_ray_batch", "from", "to", "exclude", "collision_layer", "collide_with_bodies", "collide_with_areas", "threaded"), &Physics2DDirectSpaceState::_intersect_ray_batch, DEFVAL(Array()), DEFVAL(0x7FFFFFFF), DEFVAL(true), DEFVAL(false), DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("cast_motion_batch", "shape", "origins", "motions", "threaded"), &Physics2DDirectSpaceState::_cast_motion_batch, DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("get_rest_info_batch", "shape", "origins", "threaded"), &Physics2DDirectSpaceState::_get_rest_info_batch, DEFVAL(false));
 }
 
 int Physics2DShapeQueryResult::get_result_count() const {
@@ -559,6 +799,8 @@ void Physics2DServer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("space_set_param", "space", "param", "value"), &Physics2DServer::space_set_param);
 	ClassDB::bind_method(D_METHOD("space_get_param", "space", "param"), &Physics2DServer::space_get_param);
 	ClassDB::bind_method(D_METHOD("space_get_direct_state", "space"), &Physics2DServer::space_get_direct_state);
+	ClassDB::bind_method(D_METHOD("space_get_snapshot", "space"), &Physics2DServer::space_get_snapshot);
+	ClassDB::bind_method(D_METHOD("space_restore_snapshot", "space", "snapshot"), &Physics2DServer::space_restore_snapshot);
 
 	ClassDB::bind_method(D_METHOD("area_create"), &Physics2DServer::area_create);
 	ClassDB::bind_method(D_METHOD("area_set_space", "area", "space"), &Physics2DServer::area_set_space);
@@ -596,6 +838,7 @@ void Physics2DServer::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("area_set_monitor_callback", "area", "receiver", "method"), &Physics2DServer::area_set_monitor_callback);
 	ClassDB::bind_method(D_METHOD("area_set_area_monitor_callback", "area", "receiver", "method"), &Physics2DServer::area_set_area_monitor_callback);
+	ClassDB::bind_method(D_METHOD("area_set_monitor_batching", "area", "enable"), &Physics2DServer::area_set_monitor_batching);
 	ClassDB::bind_method(D_METHOD("area_set_monitorable", "area", "monitorable"), &Physics2DServer::area_set_monitorable);
 
 	ClassDB::bind_method(D_METHOD("body_create"), &Physics2DServer::body_create);
@@ -762,6 +1005,14 @@ void Physics2DServer::_bind_methods() {
 	BIND_ENUM_CONSTANT(INFO_ACTIVE_OBJECTS);
 	BIND_ENUM_CONSTANT(INFO_COLLISION_PAIRS);
 	BIND_ENUM_CONSTANT(INFO_ISLAND_COUNT);
+	BIND_ENUM_CONSTANT(INFO_BROADPHASE_TIME);
+	BIND_ENUM_CONSTANT(INFO_PAIR_GENERATION_TIME);
+	BIND_ENUM_CONSTANT(INFO_NARROWPHASE_TIME);
+	BIND_ENUM_CONSTANT(INFO_GENERATE_ISLANDS_TIME);
+	BIND_ENUM_CONSTANT(INFO_SETUP_CONSTRAINTS_TIME);
+	BIND_ENUM_CONSTANT(INFO_SOLVE_CONSTRAINTS_TIME);
+	BIND_ENUM_CONSTANT(INFO_INTEGRATE_TIME);
+	BIND_ENUM_CONSTANT(INFO_QUERY_CALLBACKS_TIME);
 }
 
 Physics2DServer::Physics2DServer() {
@@ -155,6 +155,10 @@ class Physics2DDirectSpaceState : public Object {
 	Array _collide_shape(const Ref<Physics2DShapeQueryParameters> &p_shape_query, int p_max_results = 32);
 	Dictionary _get_rest_info(const Ref<Physics2DShapeQueryParameters> &p_shape_query);
 
+	Dictionary _intersect_ray_batch(const PoolVector<Vector2> &p_from, const PoolVector<Vector2> &p_to, const Vector<RID> &p_exclude = Vector<RID>(), uint32_t p_layers = 0, bool p_collide_with_bodies = true, bool p_collide_with_areas = false, bool p_threaded = false);
+	Dictionary _cast_motion_batch(const Ref<Physics2DShapeQueryParameters> &p_shape_query, const PoolVector<Vector2> &p_origins, const PoolVector<Vector2> &p_motions, bool p_threaded = false);
+	Dictionary _get_rest_info_batch(const Ref<Physics2DShapeQueryParameters> &p_shape_query, const PoolVector<Vector2> &p_origins, bool p_threaded = false);
+
 protected:
 	static void _bind_methods();
 
@@ -203,6 +207,13 @@ public:
 
 	virtual bool rest_info(RID p_shape, const Transform2D &p_shape_xform, const Vector2 &p_motion, float p_margin, ShapeRestInfo *r_info, const Set<RID> &p_exclude = Set<RID>(), uint32_t p_collision_layer = 0xFFFFFFFF, bool p_collide_with_bodies = true, bool p_collide_with_areas = false) = 0;
 
+	// Batched versions of the queries above, every query writes its own slot of
+	// the result arrays. The exclude list must be sorted. They return the amount
+	// of queries that collided, p_threaded allows splitting them across threads.
+	virtual int intersect_ray_batch(const Vector2 *p_from, const Vector2 *p_to, int p_count, RayResult *r_results, bool *r_collided, const RID *p_exclude = NULL, int p_exclude_count = 0, uint32_t p_collision_layer = 0xFFFFFFFF, bool p_collide_with_bodies = true, bool p_collide_with_areas = false, bool p_threaded = false);
+	virtual int cast_motion_batch(const RID &p_shape, const Transform2D *p_xforms, const Vector2 *p_motions, int p_count, float p_margin, float *r_closest_safe, float *r_closest_unsafe, const RID *p_exclude = NULL, int p_exclude_count = 0, uint32_t p_collision_layer = 0xFFFFFFFF, bool p_collide_with_bodies = true, bool p_collide_with_areas = false, bool p_threaded = false);
+	virtual int rest_info_batch(RID p_shape, const Transform2D *p_shape_xforms, const Vector2 &p_motion, int p_count, float p_margin, ShapeRestInfo *r_infos, bool *r_collided, const RID *p_exclude = NULL, int p_exclude_count = 0, uint32_t p_collision_layer = 0xFFFFFFFF, bool p_collide_with_bodies = true, bool p_collide_with_areas = false, bool p_threaded = false);
+
 	Physics2DDirectSpaceState();
 };
 
@@ -302,6 +313,10 @@ public:
 	virtual Vector<Vector2> space_get_contacts(RID p_space) const = 0;
 	virtual int space_get_contact_count(RID p_space) const = 0;
 
+	// binary copy of the simulation state, only valid for the same space on the same build
+	virtual PoolVector<uint8_t> space_get_snapshot(RID p_space) const = 0;
+	virtual Error space_restore_snapshot(RID p_space, const PoolVector<uint8_t> &p_snapshot) = 0;
+
 	//missing space parameters
 
 	/* AREA API */
@@ -368,6 +383,7 @@ public:
 
 	virtual void area_set_monitor_callback(RID p_area, Object *p_receiver, const StringName &p_method) = 0;
 	virtual void area_set_area_monitor_callback(RID p_area, Object *p_receiver, const StringName &p_method) = 0;
+	virtual void area_set_monitor_batching(RID p_area, bool p_enable) = 0;
 
 	/* BODY API */
 
@@ -530,6 +546,12 @@ public:
 
 	virtual int body_test_ray_separation(RID p_body, const Transform2D &p_transform, bool p_infinite_inertia, Vector2 &r_recover_motion, SeparationResult *r_results, int p_result_max, float p_margin = 0.001) = 0;
 
+	// Lets the motion tests that follow, until the batch ends, share one broadphase
+	// query made for the body anywhere within p_max_distance of p_from, as the
+	// iterations of a slide do. Any other object changing drops the shared query.
+	virtual void body_begin_motion_batch(RID p_body, const Transform2D &p_from, real_t p_max_distance, real_t p_margin = 0.001) = 0;
+	virtual void body_end_motion_batch(RID p_body) = 0;
+
 	/* JOINT API */
 
 	enum JointType {
@@ -597,7 +619,15 @@ public:
 
 		INFO_ACTIVE_OBJECTS,
 		INFO_COLLISION_PAIRS,
-		INFO_ISLAND_COUNT
+		INFO_ISLAND_COUNT,
+		INFO_BROADPHASE_TIME,
+		INFO_PAIR_GENERATION_TIME,
+		INFO_NARROWPHASE_TIME,
+		INFO_GENERATE_ISLANDS_TIME,
+		INFO_SETUP_CONSTRAINTS_TIME,
+		INFO_SOLVE_CONSTRAINTS_TIME,
+		INFO_INTEGRATE_TIME,
+		INFO_QUERY_CALLBACKS_TIME
 	};
 
 	virtual int get_process_info(ProcessInfo p_info) = 0;
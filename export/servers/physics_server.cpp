@@ -356,6 +356,240 @@ Dictionary PhysicsDirectSpaceState::_get_rest_info(const Ref<PhysicsShapeQueryPa
 	return r;
 }
 
+Dictionary PhysicsDirectSpaceState::_intersect_ray_batch(const PoolVector<Vector3> &p_from, const PoolVector<Vector3> &p_to, const Vector<RID> &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas, bool p_threaded) {
+
+	ERR_FAIL_COND_V(p_from.size() != p_to.size(), Dictionary());
+
+	int count = p_from.size();
+
+	Vector<RID> exclude = p_exclude;
+	exclude.sort();
+
+	Vector<RayResult> results;
+	results.resize(count);
+	Vector<bool> collided;
+	collided.resize(count);
+
+	{
+		PoolVector<Vector3>::Read from = p_from.read();
+		PoolVector<Vector3>::Read to = p_to.read();
+		intersect_ray_batch(from.ptr(), to.ptr(), count, results.ptrw(), collided.ptrw(), exclude.ptr(), exclude.size(), p_collision_mask, p_collide_with_bodies, p_collide_with_areas, p_threaded);
+	}
+
+	PoolVector<uint8_t> ret_collided;
+	PoolVector<Vector3> ret_position;
+	PoolVector<Vector3> ret_normal;
+	PoolVector<int> ret_collider_id;
+	PoolVector<int> ret_shape;
+	ret_collided.resize(count);
+	ret_position.resize(count);
+	ret_normal.resize(count);
+	ret_collider_id.resize(count);
+	ret_shape.resize(count);
+
+	{
+		PoolVector<uint8_t>::Write w_collided = ret_collided.write();
+		PoolVector<Vector3>::Write w_position = ret_position.write();
+		PoolVector<Vector3>::Write w_normal = ret_normal.write();
+		PoolVector<int>::Write w_collider_id = ret_collider_id.write();
+		PoolVector<int>::Write w_shape = ret_shape.write();
+
+		for (int i = 0; i < count; i++) {
+
+			w_collided[i] = collided[i];
+			w_position[i] = collided[i] ? results[i].position : Vector3();
+			w_normal[i] = collided[i] ? results[i].normal : Vector3();
+			w_collider_id[i] = collided[i] ? results[i].collider_id : 0;
+			w_shape[i] = collided[i] ? results[i].shape : 0;
+		}
+	}
+
+	Dictionary d;
+	d["collided"] = ret_collided;
+	d["position"] = ret_position;
+	d["normal"] = ret_normal;
+	d["collider_id"] = ret_collider_id;
+	d["shape"] = ret_shape;
+
+	return d;
+}
+
+Dictionary PhysicsDirectSpaceState::_cast_motion_batch(const Ref<PhysicsShapeQueryParameters> &p_shape_query, const PoolVector<Vector3> &p_origins, const PoolVector<Vector3> &p_motions, bool p_threaded) {
+
+	ERR_FAIL_COND_V(!p_shape_query.is_valid(), Dictionary());
+	ERR_FAIL_COND_V(p_origins.size() != p_motions.size(), Dictionary());
+
+	int count = p_origins.size();
+
+	Vector<RID> exclude; // Set iteration is already sorted
+	for (Set<RID>::Element *E = p_shape_query->exclude.front(); E; E = E->next()) {
+		exclude.push_back(E->get());
+	}
+
+	Vector<Transform> xforms;
+	xforms.resize(count);
+	{
+		PoolVector<Vector3>::Read r = p_origins.read();
+		for (int i = 0; i < count; i++) {
+			xforms.write[i] = Transform(p_shape_query->transform.basis, r[i]);
+		}
+	}
+
+	PoolVector<real_t> ret_safe;
+	PoolVector<real_t> ret_unsafe;
+	ret_safe.resize(count);
+	ret_unsafe.resize(count);
+
+	Vector<float> safe;
+	Vector<float> unsafe;
+	safe.resize(count);
+	unsafe.resize(count);
+
+	{
+		PoolVector<Vector3>::Read motions = p_motions.read();
+		cast_motion_batch(p_shape_query->shape, xforms.ptr(), motions.ptr(), count, p_shape_query->margin, safe.ptrw(), unsafe.ptrw(), exclude.ptr(), exclude.size(), p_shape_query->collision_mask, p_shape_query->collide_with_bodies, p_shape_query->collide_with_areas, p_threaded);
+	}
+
+	{
+		PoolVector<real_t>::Write w_safe = ret_safe.write();
+		PoolVector<real_t>::Write w_unsafe = ret_unsafe.write();
+		for (int i = 0; i < count; i++) {
+			w_safe[i] = safe[i];
+			w_unsafe[i] = unsafe[i];
+		}
+	}
+
+	Dictionary d;
+	d["safe"] = ret_safe;
+	d["unsafe"] = ret_unsafe;
+
+	return d;
+}
+
+Dictionary PhysicsDirectSpaceState::_get_rest_info_batch(const Ref<PhysicsShapeQueryParameters> &p_shape_query, const PoolVector<Vector3> &p_origins, bool p_threaded) {
+
+	ERR_FAIL_COND_V(!p_shape_query.is_valid(), Dictionary());
+
+	int count = p_origins.size();
+
+	Vector<RID> exclude; // Set iteration is already sorted
+	for (Set<RID>::Element *E = p_shape_query->exclude.front(); E; E = E->next()) {
+		exclude.push_back(E->get());
+	}
+
+	Vector<Transform> xforms;
+	xforms.resize(count);
+	{
+		PoolVector<Vector3>::Read r = p_origins.read();
+		for (int i = 0; i < count; i++) {
+			xforms.write[i] = Transform(p_shape_query->transform.basis, r[i]);
+		}
+	}
+
+	Vector<ShapeRestInfo> infos;
+	infos.resize(count);
+	Vector<bool> collided;
+	collided.resize(count);
+
+	rest_info_batch(p_shape_query->shape, xforms.ptr(), count, p_shape_query->margin, infos.ptrw(), collided.ptrw(), exclude.ptr(), exclude.size(), p_shape_query->collision_mask, p_shape_query->collide_with_bodies, p_shape_query->collide_with_areas, p_threaded);
+
+	PoolVector<uint8_t> ret_collided;
+	PoolVector<Vector3> ret_point;
+	PoolVector<Vector3> ret_normal;
+	PoolVector<int> ret_collider_id;
+	PoolVector<int> ret_shape;
+	PoolVector<Vector3> ret_linear_velocity;
+	ret_collided.resize(count);
+	ret_point.resize(count);
+	ret_normal.resize(count);
+	ret_collider_id.resize(count);
+	ret_shape.resize(count);
+	ret_linear_velocity.resize(count);
+
+	{
+		PoolVector<uint8_t>::Write w_collided = ret_collided.write();
+		PoolVector<Vector3>::Write w_point = ret_point.write();
+		PoolVector<Vector3>::Write w_normal = ret_normal.write();
+		PoolVector<int>::Write w_collider_id = ret_collider_id.write();
+		PoolVector<int>::Write w_shape = ret_shape.write();
+		PoolVector<Vector3>::Write w_linear_velocity = ret_linear_velocity.write();
+
+		for (int i = 0; i < count; i++) {
+
+			w_collided[i] = collided[i];
+			w_point[i] = collided[i] ? infos[i].point : Vector3();
+			w_normal[i] = collided[i] ? infos[i].normal : Vector3();
+			w_collider_id[i] = collided[i] ? infos[i].collider_id : 0;
+			w_shape[i] = collided[i] ? infos[i].shape : 0;
+			w_linear_velocity[i] = collided[i] ? infos[i].linear_velocity : Vector3();
+		}
+	}
+
+	Dictionary d;
+	d["collided"] = ret_collided;
+	d["point"] = ret_point;
+	d["normal"] = ret_normal;
+	d["collider_id"] = ret_collider_id;
+	d["shape"] = ret_shape;
+	d["linear_velocity"] = ret_linear_velocity;
+
+	return d;
+}
+
+int PhysicsDirectSpaceState::intersect_ray_batch(const Vector3 *p_from, const Vector3 *p_to, int p_count, RayResult *r_results, bool *r_collided, const RID *p_exclude, int p_exclude_count, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas, bool p_threaded) {
+
+	// one query at a time, servers override this with something faster
+	Set<RID> exclude;
+	for (int i = 0; i < p_exclude_count; i++)
+		exclude.insert(p_exclude[i]);
+
+	int collided = 0;
+	for (int i = 0; i < p_count; i++) {
+
+		r_collided[i] = intersect_ray(p_from[i], p_to[i], r_results[i], exclude, p_collision_mask, p_collide_with_bodies, p_collide_with_areas);
+		if (r_collided[i])
+			collided++;
+	}
+
+	return collided;
+}
+
+int PhysicsDirectSpaceState::cast_motion_batch(const RID &p_shape, const Transform *p_xforms, const Vector3 *p_motions, int p_count, float p_margin, float *r_closest_safe, float *r_closest_unsafe, const RID *p_exclude, int p_exclude_count, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas, bool p_threaded) {
+
+	Set<RID> exclude;
+	for (int i = 0; i < p_exclude_count; i++)
+		exclude.insert(p_exclude[i]);
+
+	int collided = 0;
+	for (int i = 0; i < p_count; i++) {
+
+		r_closest_safe[i] = 1.0;
+		r_closest_unsafe[i] = 1.0;
+		cast_motion(p_shape, p_xforms[i], p_motions[i], p_margin, r_closest_safe[i], r_closest_unsafe[i], exclude, p_collision_mask, p_collide_with_bodies, p_collide_with_areas);
+		if (r_closest_safe[i] < 1.0)
+			collided++;
+	}
+
+	return collided;
+}
+
+int PhysicsDirectSpaceState::rest_info_batch(RID p_shape, const Transform *p_shape_xforms, int p_count, float p_margin, ShapeRestInfo *r_infos, bool *r_collided, const RID *p_exclude, int p_exclude_count, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas, bool p_threaded) {
+
+	Set<RID> exclude;
+	for (int i = 0; i < p_exclude_count; i++)
+		exclude.insert(p_exclude[i]);
+
+	int collided = 0;
+	for (int i = 0; i < p_count; i++) {
+
+		r_collided[i] = rest_info(p_shape, p_shape_xforms[i], p_margin, &r_infos[i], exclude, p_collision_mask, p_collide_with_bodies, p_collide_with_areas);
+		if (r_collided[i])
+			collided++;
+	}
+
+	return collided;
+}
+
 PhysicsDirectSpaceState::PhysicsDirectSpaceState() {
 }
 
@@ -366,6 +600,10 @@ void PhysicsDirectSpaceState::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("cast_motion", "shape", "motion"), &PhysicsDirectSpaceState::_cast_motion);
 	ClassDB::bind_method(D_METHOD("collide_shape", "shape", "max_results"), &PhysicsDirectSpaceState::_collide_shape, DEFVAL(32));
 	ClassDB::bind_method(D_METHOD("get_rest_info", "shape"), &PhysicsDirectSpaceState::_get_rest_info);
+
+	ClassDB::bind_method(D_METHOD("intersect_ray_batch", "from", "to", "exclude", "collision_mask", "collide_with_bodies", "collide_with_areas", "threaded"), &PhysicsDirectSpaceState::_intersect_ray_batch, DEFVAL(Array()), DEFVAL(0x7FFFFFFF), DEFVAL(true), DEFVAL(false), DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("cast_motion_batch", "shape", "origins", "motions", "threaded"), &PhysicsDirectSpaceState::_cast_motion_batch, DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("get_rest_info_batch", "shape", "origins", "threaded"), &PhysicsDirectSpaceState::_get_rest_info_batch, DEFVAL(false));
 }
 
 int PhysicsShapeQueryResult::get_result_count() const {
@@ -403,6 +641,44 @@ void PhysicsShapeQueryResult::_bind_methods() {
 
 ///////////////////////////////////////
 
+PhysicsServer::BodyStateSync &PhysicsServer::BodyStateSyncQueue::push(BodyStateSyncCallback p_callback) {
+
+	// Nearly always a single callback is in use, so the last batch is checked first.
+	if (last_batch >= batches.size() || batches[last_batch].callback != p_callback) {
+
+		last_batch = 0;
+		while (last_batch < batches.size() && batches[last_batch].callback != p_callback) {
+			last_batch++;
+		}
+
+		if (last_batch == batches.size()) {
+			Batch batch;
+			batch.callback = p_callback;
+			batches.push_back(batch);
+		}
+	}
+
+	LocalVector<BodyStateSync> &states = batches[last_batch].states;
+	states.resize(states.size() + 1);
+	return states[states.size() - 1];
+}
+
+void PhysicsServer::BodyStateSyncQueue::flush() {
+
+	for (uint32_t i = 0; i < batches.size(); i++) {
+
+		LocalVector<BodyStateSync> &states = batches[i].states;
+		if (states.size() == 0) {
+			continue;
+		}
+
+		batches[i].callback(states.ptr(), states.size());
+		states.clear(); // Keeps the memory for the next step.
+	}
+}
+
+///////////////////////////////////////
+
 void PhysicsServer::_bind_methods() {
 
 #ifndef _3D_DISABLED
@@ -419,6 +695,8 @@ void PhysicsServer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("space_set_param", "space", "param", "value"), &PhysicsServer::space_set_param);
 	ClassDB::bind_method(D_METHOD("space_get_param", "space", "param"), &PhysicsServer::space_get_param);
 	ClassDB::bind_method(D_METHOD("space_get_direct_state", "space"), &PhysicsServer::space_get_direct_state);
+	ClassDB::bind_method(D_METHOD("space_get_snapshot", "space"), &PhysicsServer::space_get_snapshot);
+	ClassDB::bind_method(D_METHOD("space_restore_snapshot", "space", "snapshot"), &PhysicsServer::space_restore_snapshot);
 
 	ClassDB::bind_method(D_METHOD("area_create"), &PhysicsServer::area_create);
 	ClassDB::bind_method(D_METHOD("area_set_space", "area", "space"), &PhysicsServer::area_set_space);
@@ -453,6 +731,7 @@ void PhysicsServer::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("area_set_monitor_callback", "area", "receiver", "method"), &PhysicsServer::area_set_monitor_callback);
 	ClassDB::bind_method(D_METHOD("area_set_area_monitor_callback", "area", "receiver", "method"), &PhysicsServer::area_set_area_monitor_callback);
+	ClassDB::bind_method(D_METHOD("area_set_monitor_batching", "area", "enable"), &PhysicsServer::area_set_monitor_batching);
 	ClassDB::bind_method(D_METHOD("area_set_monitorable", "area", "monitorable"), &PhysicsServer::area_set_monitorable);
 
 	ClassDB::bind_method(D_METHOD("area_set_ray_pickable", "area", "enable"), &PhysicsServer::area_set_ray_pickable);
@@ -702,6 +981,14 @@ void PhysicsServer::_bind_methods() {
 	BIND_ENUM_CONSTANT(INFO_ACTIVE_OBJECTS);
 	BIND_ENUM_CONSTANT(INFO_COLLISION_PAIRS);
 	BIND_ENUM_CONSTANT(INFO_ISLAND_COUNT);
+	BIND_ENUM_CONSTANT(INFO_BROADPHASE_TIME);
+	BIND_ENUM_CONSTANT(INFO_PAIR_GENERATION_TIME);
+	BIND_ENUM_CONSTANT(INFO_NARROWPHASE_TIME);
+	BIND_ENUM_CONSTANT(INFO_GENERATE_ISLANDS_TIME);
+	BIND_ENUM_CONSTANT(INFO_SETUP_CONSTRAINTS_TIME);
+	BIND_ENUM_CONSTANT(INFO_SOLVE_CONSTRAINTS_TIME);
+	BIND_ENUM_CONSTANT(INFO_INTEGRATE_TIME);
+	BIND_ENUM_CONSTANT(INFO_QUERY_CALLBACKS_TIME);
 
 	BIND_ENUM_CONSTANT(SPACE_PARAM_CONTACT_RECYCLE_RADIUS);
 	BIND_ENUM_CONSTANT(SPACE_PARAM_CONTACT_MAX_SEPARATION);
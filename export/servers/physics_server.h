@@ -31,6 +31,7 @@
 #ifndef PHYSICS_SERVER_H
 #define PHYSICS_SERVER_H
 
+#include "core/local_vector.h"
 #include "core/object.h"
 #include "core/resource.h"
 
@@ -151,6 +152,10 @@ private:
 	Array _collide_shape(const Ref<PhysicsShapeQueryParameters> &p_shape_query, int p_max_results = 32);
 	Dictionary _get_rest_info(const Ref<PhysicsShapeQueryParameters> &p_shape_query);
 
+	Dictionary _intersect_ray_batch(const PoolVector<Vector3> &p_from, const PoolVector<Vector3> &p_to, const Vector<RID> &p_exclude = Vector<RID>(), uint32_t p_collision_mask = 0, bool p_collide_with_bodies = true, bool p_collide_with_areas = false, bool p_threaded = false);
+	Dictionary _cast_motion_batch(const Ref<PhysicsShapeQueryParameters> &p_shape_query, const PoolVector<Vector3> &p_origins, const PoolVector<Vector3> &p_motions, bool p_threaded = false);
+	Dictionary _get_rest_info_batch(const Ref<PhysicsShapeQueryParameters> &p_shape_query, const PoolVector<Vector3> &p_origins, bool p_threaded = false);
+
 protected:
 	static void _bind_methods();
 
@@ -197,6 +202,13 @@ public:
 
 	virtual Vector3 get_closest_point_to_object_volume(RID p_object, const Vector3 p_point) const = 0;
 
+	// Batched versions of the queries above, every query writes its own slot of
+	// the result arrays. The exclude list must be sorted. They return the amount
+	// of queries that collided, p_threaded allows splitting them across threads.
+	virtual int intersect_ray_batch(const Vector3 *p_from, const Vector3 *p_to, int p_count, RayResult *r_results, bool *r_collided, const RID *p_exclude = NULL, int p_exclude_count = 0, uint32_t p_collision_mask = 0xFFFFFFFF, bool p_collide_with_bodies = true, bool p_collide_with_areas = false, bool p_threaded = false);
+	virtual int cast_motion_batch(const RID &p_shape, const Transform *p_xforms, const Vector3 *p_motions, int p_count, float p_margin, float *r_closest_safe, float *r_closest_unsafe, const RID *p_exclude = NULL, int p_exclude_count = 0, uint32_t p_collision_mask = 0xFFFFFFFF, bool p_collide_with_bodies = true, bool p_collide_with_areas = false, bool p_threaded = false);
+	virtual int rest_info_batch(RID p_shape, const Transform *p_shape_xforms, int p_count, float p_margin, ShapeRestInfo *r_infos, bool *r_collided, const RID *p_exclude = NULL, int p_exclude_count = 0, uint32_t p_collision_mask = 0xFFFFFFFF, bool p_collide_with_bodies = true, bool p_collide_with_areas = false, bool p_threaded = false);
+
 	PhysicsDirectSpaceState();
 };
 
@@ -287,6 +299,10 @@ public:
 	virtual Vector<Vector3> space_get_contacts(RID p_space) const = 0;
 	virtual int space_get_contact_count(RID p_space) const = 0;
 
+	// binary copy of the simulation state, only valid for the same space on the same build
+	virtual PoolVector<uint8_t> space_get_snapshot(RID p_space) const = 0;
+	virtual Error space_restore_snapshot(RID p_space, const PoolVector<uint8_t> &p_snapshot) = 0;
+
 	//missing space parameters
 
 	/* AREA API */
@@ -349,6 +365,7 @@ public:
 
 	virtual void area_set_monitor_callback(RID p_area, Object *p_receiver, const StringName &p_method) = 0;
 	virtual void area_set_area_monitor_callback(RID p_area, Object *p_receiver, const StringName &p_method) = 0;
+	virtual void area_set_monitor_batching(RID p_area, bool p_enable) = 0;
 
 	virtual void area_set_ray_pickable(RID p_area, bool p_enable) = 0;
 	virtual bool area_is_ray_pickable(RID p_area) const = 0;
@@ -474,6 +491,43 @@ public:
 
 	virtual void body_set_force_integration_callback(RID p_body, Object *p_receiver, const StringName &p_method, const Variant &p_udata = Variant()) = 0;
 
+	// Bulk state write-back. Instead of a force integration callback, a body can
+	// have a sync callback: after each step, the states of all the bodies that moved
+	// are packed and handed over to their callback in a single call. The force
+	// integration callback takes precedence when both are set.
+	struct BodyStateSync {
+
+		ObjectID instance_id;
+		Transform transform;
+		Vector3 linear_velocity;
+		Vector3 angular_velocity;
+		Basis inverse_inertia_tensor;
+		bool sleeping;
+	};
+
+	typedef void (*BodyStateSyncCallback)(const BodyStateSync *p_states, int p_count);
+
+	class BodyStateSyncQueue {
+
+		struct Batch {
+
+			BodyStateSyncCallback callback;
+			LocalVector<BodyStateSync> states;
+		};
+
+		LocalVector<Batch> batches;
+		uint32_t last_batch;
+
+	public:
+		BodyStateSync &push(BodyStateSyncCallback p_callback);
+		void flush();
+
+		BodyStateSyncQueue() :
+				last_batch(0) {}
+	};
+
+	virtual void body_set_state_sync_callback(RID p_body, Object *p_receiver, BodyStateSyncCallback p_callback) = 0;
+
 	virtual void body_set_ray_pickable(RID p_body, bool p_enable) = 0;
 	virtual bool body_is_ray_pickable(RID p_body) const = 0;
 
@@ -517,6 +571,12 @@ public:
 
 	virtual int body_test_ray_separation(RID p_body, const Transform &p_transform, bool p_infinite_inertia, Vector3 &r_recover_motion, SeparationResult *r_results, int p_result_max, float p_margin = 0.001) = 0;
 
+	// Lets the motion tests that follow, until the batch ends, share one broadphase
+	// query made for the body anywhere within p_max_distance of p_from, as the
+	// iterations of a slide do. Any other object changing drops the shared query.
+	virtual void body_begin_motion_batch(RID p_body, const Transform &p_from, real_t p_max_distance) = 0;
+	virtual void body_end_motion_batch(RID p_body) = 0;
+
 	/* SOFT BODY */
 
 	virtual RID soft_body_create(bool p_init_sleeping = false) = 0;
@@ -754,7 +814,9 @@ public:
 	virtual void set_active(bool p_active) = 0;
 	virtual void init() = 0;
 	virtual void step(float p_step) = 0;
+	virtual void sync() = 0;
 	virtual void flush_queries() = 0;
+	virtual void end_sync() = 0;
 	virtual void finish() = 0;
 
 	virtual bool is_flushing_queries() const = 0;
@@ -763,7 +825,15 @@ public:
 
 		INFO_ACTIVE_OBJECTS,
 		INFO_COLLISION_PAIRS,
-		INFO_ISLAND_COUNT
+		INFO_ISLAND_COUNT,
+		INFO_BROADPHASE_TIME,
+		INFO_PAIR_GENERATION_TIME,
+		INFO_NARROWPHASE_TIME,
+		INFO_GENERATE_ISLANDS_TIME,
+		INFO_SETUP_CONSTRAINTS_TIME,
+		INFO_SOLVE_CONSTRAINTS_TIME,
+		INFO_INTEGRATE_TIME,
+		INFO_QUERY_CALLBACKS_TIME
 	};
 
 	virtual int get_process_info(ProcessInfo p_info) = 0;